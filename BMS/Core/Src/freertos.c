@@ -97,6 +97,13 @@ const osThreadAttr_t SMTask_attributes = {
   .stack_size = 1024 * 4,
   .priority = (osPriority_t) osPriorityNormal,
 };
+/* Definitions for logTask */
+osThreadId_t logTaskHandle;
+const osThreadAttr_t logTask_attributes = {
+  .name = "logTask",
+  .stack_size = 1024 * 4,
+  .priority = (osPriority_t) osPriorityLow,
+};
 /* Definitions for canTxQueue */
 osMessageQueueId_t canTxQueueHandle;
 const osMessageQueueAttr_t canTxQueue_attributes = {
@@ -169,6 +176,7 @@ void StartTPSTask(void *argument);
 void StartBMSTaskRx(void *argument);
 void StartBMSTaskTx(void *argument);
 void StartSMTask(void *argument);
+void StartLogTask(void *argument);
 
 void MX_FREERTOS_Init(void); /* (MISRA C 2004 rule 8.1) */
 
@@ -262,6 +270,9 @@ void MX_FREERTOS_Init(void) {
   /* creation of SMTask */
   SMTaskHandle = osThreadNew(StartSMTask, NULL, &SMTask_attributes);
 
+  /* creation of logTask */
+  logTaskHandle = osThreadNew(StartLogTask, NULL, &logTask_attributes);
+
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
   /* USER CODE END RTOS_THREADS */
@@ -381,6 +392,24 @@ __weak void StartSMTask(void *argument)
   /* USER CODE END StartSMTask */
 }
 
+/* USER CODE BEGIN Header_StartLogTask */
+/**
+* @brief Function implementing the logTask thread.
+* @param argument: Not used
+* @retval None
+*/
+/* USER CODE END Header_StartLogTask */
+__weak void StartLogTask(void *argument)
+{
+  /* USER CODE BEGIN StartLogTask */
+  /* Infinite loop */
+  for(;;)
+  {
+    osDelay(1);
+  }
+  /* USER CODE END StartLogTask */
+}
+
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
 
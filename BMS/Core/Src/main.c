@@ -35,6 +35,7 @@
 #include "FEB_HW.h"
 #include "FEB_Main.h"
 #include "FEB_SM.h"
+#include "feb_log.h"
 #include "task.h"
 /* USER CODE END Includes */
 
@@ -226,6 +227,8 @@ void Error_Handler(void)
 {
   /* USER CODE BEGIN Error_Handler_Debug */
   /* User can add his own implementation to report the HAL error return state */
+  /* Print any deferred log records before halting (no-op from an ISR) */
+  FEB_Log_SetDeferred(false);
   __disable_irq();
   while (1)
   {
@@ -245,6 +248,8 @@ void assert_failed(uint8_t *file, uint32_t line)
   /* USER CODE BEGIN 6 */
   /* User can add his own implementation to report the file name and line number,
      ex: printf("Wrong parameters value: file %s on line %d\r\n", file, line) */
+  FEB_Log_SetDeferred(false);
+  LOG_E(TAG_MAIN, "assert_param failed: %s:%lu", (const char *)file, (unsigned long)line);
   /* USER CODE END 6 */
 }
 #endif /* USE_FULL_ASSERT */
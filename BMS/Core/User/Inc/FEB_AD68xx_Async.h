@@ -0,0 +1,100 @@
+#ifndef INC_FEB_AD68XX_ASYNC_H_
+#define INC_FEB_AD68XX_ASYNC_H_
+
+// ********************************** Includes ***********************************
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FEB_Const.h"
+
+// ********************************** Asynchronous isoSPI Transport **************
+// Queues ADBMS68xx frames and runs them back to back with
+// HAL_SPI_TransmitReceive_DMA. Every frame is chain-length: CMD + PEC15, then
+// 8 bytes per IC. The SPI completion interrupt raises CS and sets
+// ADBMS_ASYNC_DONE_FLAG on the submitting thread; the thread starts the next
+// queued frame and checks the per-IC reply PEC10 in ADBMS_Async_Wait, outside
+// the ISR. The streams and their interrupts are generated from BMS.ioc
+// (spi.c, dma.c, stm32f4xx_it.c).
+//
+// The chain is woken once when a batch starts on an idle bus (or when the
+// active channel changed since the last frame), not once per frame, so a
+// six-group voltage read pays one wake-up instead of twelve.
+//
+// Redundant isoSPI: the SPI handle and CS pin are latched from FEB_ACTIVE_*
+// when a frame is queued, under the same critical section perform_failover()
+// swaps them in, so a failover never tears a frame in flight. Frames queued
+// after a failover go out on the new channel.
+//
+// With ISOSPI_USE_DMA == 0 the same API runs each frame with a blocking
+// HAL_SPI_TransmitReceive at submit time.
+//
+// One waiter at a time: callers serialise on ADBMSMutexHandle exactly as for
+// the blocking transmitCMD* path, and must drain every ticket before
+// releasing it. A submit from a thread that does not own the mutex is refused,
+// and the blocking transmitCMD* path drops its frame while ADBMS_Async_Busy(),
+// so neither can put a second frame on the chain under a DMA transfer.
+
+#ifndef ADBMS_ASYNC_QUEUE_DEPTH
+#define ADBMS_ASYNC_QUEUE_DEPTH 8
+#endif
+
+// Thread flag set on the submitting thread when a frame completes.
+#ifndef ADBMS_ASYNC_DONE_FLAG
+#define ADBMS_ASYNC_DONE_FLAG 0x0100U
+#endif
+
+#define ADBMS_ASYNC_FRAME_BYTES (4U + 8U * FEB_NUM_IC)
+
+typedef enum
+{
+  ADBMS_XFER_OK = 0,
+  ADBMS_XFER_TIMEOUT,   // No completion in time; the queue was aborted
+  ADBMS_XFER_SPI_ERROR, // HAL refused the transfer or reported a DMA/SPI error
+  ADBMS_XFER_INVALID,   // Bad ticket (queue was full at submit)
+} ADBMS_Xfer_Status_t;
+
+typedef struct
+{
+  uint32_t frames;           // Frames completed on the wire
+  uint32_t bytes;            // Bytes clocked
+  uint32_t wakeups;          // Chain wake-ups issued
+  uint32_t pec_errors;       // Per-IC reply PEC10 mismatches
+  uint32_t spi_errors;       // Frames failed by the HAL
+  uint32_t timeouts;         // ADBMS_Async_Wait timeouts (each aborts the queue)
+  uint32_t queue_full;       // Submits refused: queue full
+  uint32_t not_owner;        // Submits refused: caller did not hold ADBMSMutexHandle
+  uint32_t blocking_refused; // Blocking transmitCMD* frames dropped while busy
+  uint8_t queue_peak;        // Deepest queue seen
+} ADBMS_Async_Stats_t;
+
+// Check that spi.c linked the DMA streams to the active isoSPI handle. Call
+// once before the first transfer (no-op for the blocking build).
+void ADBMS_Async_Init(void);
+
+// True while a frame is queued or on the wire.
+bool ADBMS_Async_Busy(void);
+
+// Record a blocking transmitCMD* frame dropped because the queue was busy.
+void ADBMS_Async_CountBlockingRefused(void);
+
+// Queue a register-group read of total_ic ICs. Returns a ticket, or -1 if the
+// queue is full or the caller does not hold ADBMSMutexHandle.
+int8_t ADBMS_Async_Read(uint16_t cmdcode, uint8_t total_ic);
+
+// Queue an action command (no data phase). Advances the CC mirror.
+int8_t ADBMS_Async_Command(uint16_t cmdcode);
+
+// Queue a register-group write: data holds 6 bytes per IC, IC 0 first, as for
+// write_68. Advances the CC mirror.
+int8_t ADBMS_Async_Write(uint16_t cmdcode, uint8_t total_ic, const uint8_t *data);
+
+// Block until the ticket's frame completes and release the ticket.
+// rx (may be NULL) receives 8 * total_ic reply bytes, IC 0 first. pec_fail
+// (may be NULL) gets bit n set when IC n's reply PEC10 does not match; it is
+// 0 for commands and writes.
+ADBMS_Xfer_Status_t ADBMS_Async_Wait(int8_t ticket, uint8_t *rx, uint32_t *pec_fail, uint32_t timeout_ms);
+
+void ADBMS_Async_GetStats(ADBMS_Async_Stats_t *stats);
+void ADBMS_Async_ResetStats(void);
+
+#endif /* INC_FEB_AD68XX_ASYNC_H_ */
@@ -84,6 +84,13 @@ typedef enum
 bool FEB_ADBMS_Init(void);
 
 void FEB_ADBMS_Voltage_Process(void);
+
+/**
+ * @brief Run one pipelined sweep of all thermistor MUX channels
+ *
+ * Takes ADBMSMutexHandle itself, once per phase, and sleeps through the aux
+ * conversions with it released. The caller must NOT hold the mutex.
+ */
 void FEB_ADBMS_Temperature_Process(void);
 
 void FEB_Cell_Balance_Start(void);
@@ -143,7 +150,7 @@ uint32_t FEB_ADBMS_Get_Last_Update_Tick(void);
 // Pack-level values published by the ADBMS task at the end of each scan and
 // readable WITHOUT the ADBMS mutex (atomic 32-bit reads). Use these — not the
 // FEB_ADBMS_GET_ACC_* getters — from the 1ms state-machine task: the mutex is
-// held for tens of ms during a temperature scan and would stall the SM.
+// held for milliseconds at a time during a voltage scan and would stall the SM.
 
 /** @brief Pack total voltage [V] from the last scan (0 until first scan). */
 float FEB_ADBMS_Snapshot_Total_Voltage(void);
@@ -154,4 +161,73 @@ float FEB_ADBMS_Snapshot_Max_Cell_Voltage(void);
 /** @brief Highest pack temperature [C] from the last scan (NaN until first scan). */
 float FEB_ADBMS_Snapshot_Max_Temp(void);
 
+// ********************************** Temperature Scan Timing ********************
+// Per-phase cost of FEB_ADBMS_Temperature_Process(), summed over the 7 MUX
+// channels of a sweep. WAIT is the part of each ADAX conversion that decoding
+// the previous channel did not cover. Exposed via BMS|tempscan.
+
+typedef enum
+{
+  FEB_TEMP_PHASE_SELECT = 0, // WRCFGA MUX select + ADAX start
+  FEB_TEMP_PHASE_WAIT,       // conversion time left after the overlapped decode
+  FEB_TEMP_PHASE_READ,       // RDAUX + PEC check + latch
+  FEB_TEMP_PHASE_DECODE,     // code -> mV -> degC into FEB_ACC
+  FEB_TEMP_PHASE_FINALIZE,   // pack stats, validation, snapshot publish
+  FEB_TEMP_PHASE_COUNT
+} FEB_Temp_Phase_t;
+
+typedef struct
+{
+  uint32_t last_us[FEB_TEMP_PHASE_COUNT]; // phase totals of the most recent sweep
+  uint32_t max_us[FEB_TEMP_PHASE_COUNT];  // worst sweep seen per phase
+  uint32_t scan_last_us;                  // sweep wall time
+  uint32_t scan_max_us;
+  uint32_t locked_last_us; // ADBMSMutexHandle hold time summed over the sweep
+  uint32_t locked_max_us;
+  uint32_t hold_max_us; // longest single mutex hold (worst stall for a getter)
+  uint32_t scans;
+} FEB_ADBMS_Temp_Scan_Stats_t;
+
+/** @brief Copy the temperature scan timing counters (takes ADBMSMutexHandle). */
+void FEB_ADBMS_Get_Temp_Scan_Stats(FEB_ADBMS_Temp_Scan_Stats_t *out);
+
+/** @brief Zero the temperature scan timing counters. */
+void FEB_ADBMS_Reset_Temp_Scan_Stats(void);
+
+// ********************************** Cell History *******************************
+// Every voltage and temperature scan is recorded into the FEB_Cell_History ring,
+// which freezes on the first scan that sees a latched ADBMS fault flag or a
+// fault state. Exposed via BMS|hist and streamed over CAN by FEB_CAN_History.
+
+/** @brief Freeze the history ring now (takes ADBMSMutexHandle). */
+void FEB_ADBMS_History_Freeze(void);
+
+/** @brief Clear the history ring and resume recording (takes ADBMSMutexHandle). */
+void FEB_ADBMS_History_Rearm(void);
+
+// ********************************** SOC / Pack Resistance **********************
+// FEB_SOC estimator stepped after every voltage scan with the IVT current, and
+// broadcast on FEB_CAN_EXT_BMS_SOC_FRAME_ID by FEB_CAN_State. Exposed via BMS|soc.
+
+typedef struct
+{
+  float soc;             // 0..1
+  float r_ohm;           // Pack resistance estimate
+  float pack_ocv_V;      // OCV at soc times the series cell count
+  float ah_out;          // Net charge out since the estimator was (re)seeded
+  uint32_t rls_updates;  // Resistance updates so far
+  uint8_t flags;         // FEB_SOC_FLAG_*
+  uint32_t step_last_us; // FEB_SOC_Step() cost, most recent and worst
+  uint32_t step_max_us;
+} FEB_ADBMS_SOC_t;
+
+/**
+ * @brief Copy the latest estimate. Lock-free (safe from the SM task); each
+ *        field is atomic, but fields may come from two consecutive scans.
+ */
+void FEB_ADBMS_Get_SOC(FEB_ADBMS_SOC_t *out);
+
+/** @brief Reseed SOC from the OCV curve at the next scan and restart R_pack (takes ADBMSMutexHandle). */
+void FEB_ADBMS_Reset_SOC(void);
+
 #endif /* INC_FEB_ADBMS6830B_H_ */
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_CAN_History.h
+ * @brief          : Bulk dump of the frozen cell history ring over CAN
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Streams the FEB_Cell_History ring, oldest byte first, on
+ * FEB_CAN_EXT_BMS_HIST_FRAME_ID (feb_can_ext_frames.h). Every frame starts
+ * with a 16-bit LE sequence number:
+ *
+ *   seq 0     [2..5] total bytes (LE), [6..7] record count (LE)
+ *   seq 1..N  [2..7] next 6 ring bytes (DLC shorter on the last frame)
+ *
+ * A receiver reassembles the bytes in sequence order and decodes them with
+ * FEB_Cell_History_Cursor_Init(buf, len) / FEB_Cell_History_Next().
+ ******************************************************************************
+ */
+
+#ifndef FEB_CAN_HISTORY_H
+#define FEB_CAN_HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ============================================================================
+ * API Functions
+ * ============================================================================ */
+
+/**
+ * @brief Start streaming the ring from the top
+ * @return false if the ring is not frozen (freeze it first) or is empty
+ */
+bool FEB_CAN_History_Start(void);
+
+/**
+ * @brief Abandon a stream in progress
+ */
+void FEB_CAN_History_Stop(void);
+
+/**
+ * @brief Send the next frame of a stream in progress
+ * @note Call every SM tick (1 ms); a frame the TX queue refuses is retried
+ *       on the next call. Stops by itself if the ring is rearmed.
+ */
+void FEB_CAN_History_Tick(void);
+
+/**
+ * @brief Stream progress
+ * @param sent_bytes Ring bytes sent so far (may be NULL)
+ * @param total_bytes Ring bytes in this stream (may be NULL)
+ * @return true while a stream is in progress
+ */
+bool FEB_CAN_History_Get_Progress(uint32_t *sent_bytes, uint32_t *total_bytes);
+
+#endif /* FEB_CAN_HISTORY_H */
@@ -0,0 +1,155 @@
+#ifndef INC_FEB_CELL_HISTORY_H_
+#define INC_FEB_CELL_HISTORY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FEB_Const.h"
+
+// ********************************** Cell History Ring **************************
+// Byte ring of cell-voltage and thermistor scans, written a channel at a time
+// straight from FEB_ACC and frozen on fault so the lead-up survives. Holds raw
+// ADC codes (C-ADC cell codes, aux thermistor codes with 0xFFFF = PEC failure),
+// so a dump converts exactly as the scan did.
+//
+// Record: 10-byte header, then one nibble-coded value per channel.
+//   [0]    FEB_HIST_TYPE_MARK | FEB_HIST_TYPE_KEY? | kind
+//   [1]    ADBMS_FAULT_FLAG_* latched when the scan was recorded
+//   [2..3] channel count (LE)
+//   [4..5] payload bytes (LE)
+//   [6..9] HAL_GetTick() at the scan (LE)
+//
+// Each value is coded as the zigzagged 16-bit difference from the same
+// channel in the previous record of its kind; a keyframe instead codes it
+// against the previous channel of the same record (0 before the first), so
+// it decodes on its own. Nibble tokens, high nibble first:
+//   0..B        difference 0..11
+//   C n         12..27
+//   D n n       28..283
+//   E n n n n   any 16-bit difference
+//   F n         run of n+2 zero differences
+// A quiet cell costs half a byte per scan.
+//
+// Single writer (the ADBMS task, holding ADBMSMutexHandle). Readers take the
+// same mutex, or read a frozen ring without it: nothing writes while frozen.
+
+#define FEB_HIST_HEADER_BYTES 10U
+#define FEB_HIST_TYPE_MARK 0x50U // Sanity pattern in bits 4..6
+#define FEB_HIST_TYPE_KEY 0x80U
+#define FEB_HIST_TYPE_KIND_MASK 0x0FU
+
+#define FEB_HIST_VOLTAGE_CHANNELS FEB_NUM_CELLS
+#define FEB_HIST_TEMP_CHANNELS (FEB_NUM_TEMP_SENSORS * FEB_NBANKS)
+
+typedef enum
+{
+  FEB_HIST_KIND_VOLTAGE = 0, /**< FEB_ACC.cell_c_codes, pack order */
+  FEB_HIST_KIND_TEMP,        /**< banks[].therm_raw_codes, bank-major */
+  FEB_HIST_KIND_COUNT
+} FEB_Hist_Kind_t;
+
+typedef struct
+{
+  uint32_t capacity_bytes;
+  uint32_t used_bytes;
+  uint32_t records;         /**< Records currently held */
+  uint32_t evicted;         /**< Records dropped to make room since the last rearm */
+  uint32_t oldest_tick;     /**< Tick of the oldest held record (0 when empty) */
+  uint32_t newest_tick;     /**< Tick of the newest held record (0 when empty) */
+  bool frozen;
+  uint32_t freeze_tick;     /**< HAL_GetTick() at freeze */
+  uint8_t freeze_flags;     /**< ADBMS_FAULT_FLAG_* at freeze (0 = manual) */
+} FEB_Cell_History_Stats_t;
+
+/** One decoded record. values points into the cursor and is valid until the next call. */
+typedef struct
+{
+  FEB_Hist_Kind_t kind;
+  bool key;
+  uint8_t flags;
+  uint16_t count;
+  uint32_t tick;
+  const uint16_t *values;
+} FEB_Cell_History_Record_t;
+
+/** Decoder state: position plus the last decoded frame of each kind. */
+typedef struct
+{
+  const uint8_t *buf; /**< Linear dump, or NULL to read the ring itself */
+  uint32_t pos;
+  uint32_t end;
+  bool synced[FEB_HIST_KIND_COUNT];
+  uint16_t voltage[FEB_HIST_VOLTAGE_CHANNELS];
+  uint16_t temp[FEB_HIST_TEMP_CHANNELS];
+} FEB_Cell_History_Cursor_t;
+
+// ********************************** Writer *************************************
+
+/**
+ * @brief Empty the ring and start recording.
+ */
+void FEB_Cell_History_Init(void);
+
+/**
+ * @brief Open a record. Evicts the oldest records until a worst-case record fits.
+ *
+ * @param kind   Record kind; FEB_Cell_History_Push() must follow once per channel
+ * @param tick   Scan time (HAL_GetTick())
+ * @param flags  ADBMS_FAULT_FLAG_* latched at this scan
+ * @return bool  false if frozen (skip the pushes and End)
+ */
+bool FEB_Cell_History_Begin(FEB_Hist_Kind_t kind, uint32_t tick, uint8_t flags);
+
+/**
+ * @brief Append the next channel's raw code to the open record.
+ */
+void FEB_Cell_History_Push(uint16_t code);
+
+/**
+ * @brief Close the open record and publish it.
+ */
+void FEB_Cell_History_End(void);
+
+/**
+ * @brief Stop recording and keep the current contents.
+ *
+ * @param tick   Freeze time (HAL_GetTick())
+ * @param flags  ADBMS_FAULT_FLAG_* that triggered it (0 = manual)
+ */
+void FEB_Cell_History_Freeze(uint32_t tick, uint8_t flags);
+
+/**
+ * @brief Discard the contents and resume recording.
+ */
+void FEB_Cell_History_Rearm(void);
+
+bool FEB_Cell_History_Is_Frozen(void);
+
+void FEB_Cell_History_Get_Stats(FEB_Cell_History_Stats_t *out);
+
+// ********************************** Reader *************************************
+
+/**
+ * @brief Copy ring bytes in record order, oldest first.
+ *
+ * @param offset    Byte offset from the oldest record
+ * @param dst       Destination
+ * @param len       Bytes wanted
+ * @return uint32_t Bytes copied (short at the end of the used range)
+ */
+uint32_t FEB_Cell_History_Read(uint32_t offset, uint8_t *dst, uint32_t len);
+
+/**
+ * @brief Start decoding the ring (buf == NULL) or a linear dump of it.
+ */
+void FEB_Cell_History_Cursor_Init(FEB_Cell_History_Cursor_t *cur, const uint8_t *buf, uint32_t len);
+
+/**
+ * @brief Decode the next record. Delta records before the first keyframe of
+ *        their kind are skipped.
+ *
+ * @return bool  false at the end of the data, or at a record that fails the
+ *               header check or overruns its payload
+ */
+bool FEB_Cell_History_Next(FEB_Cell_History_Cursor_t *cur, FEB_Cell_History_Record_t *rec);
+
+#endif /* INC_FEB_CELL_HISTORY_H_ */
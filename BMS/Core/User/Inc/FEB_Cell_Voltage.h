@@ -0,0 +1,36 @@
+#ifndef INC_FEB_CELL_VOLTAGE_H_
+#define INC_FEB_CELL_VOLTAGE_H_
+
+#include <stdint.h>
+#include "FEB_Const.h"
+#include "FEB_ADBMS6830B_Driver.h"
+
+// ********************************** Cell Voltage Pass **************************
+// One integer pass over a fresh rdcv/rdsv read: latch good C/S codes into the
+// pack-order arrays of accumulator_t, build total / min / max / argmin /
+// argmax in uV over the cells read, and run the per-cell limit check with its
+// saturating violation counters. No HAL, RTOS or float, so the host bench
+// runs the same code as the ADBMS task.
+
+// Called for a cell on the scan its violation counter reaches
+// FEB_VOLTAGE_ERROR_THRESH (once per excursion). bank_cell is the cell index
+// within the bank; uV_C / uV_S are the codes the check judged.
+typedef void (*FEB_Cell_Voltage_Latch_t)(uint8_t bank, uint8_t bank_cell, int32_t uV_C, int32_t uV_S);
+
+/**
+ * @brief Latch, aggregate and limit-check every cell of the pack
+ *
+ * A cell whose register group failed PEC keeps its last good codes: it is
+ * limit-checked on them but left out of the aggregates and counted in its
+ * bank's badReadV.
+ *
+ * @param acc       Accumulator to update (codes, aggregates, counters)
+ * @param ics       FEB_NUM_IC register images, chain order
+ * @param vMin_uV   Cell under-voltage limit
+ * @param vMax_uV   Cell over-voltage limit
+ * @param on_latch  Fault hook (may be NULL)
+ */
+void FEB_Cell_Voltage_Process(accumulator_t *acc, const cell_asic *ics, int32_t vMin_uV, int32_t vMax_uV,
+                              FEB_Cell_Voltage_Latch_t on_latch);
+
+#endif /* INC_FEB_CELL_VOLTAGE_H_ */
@@ -18,6 +18,9 @@
 // Total number of cells per bank
 #define FEB_NUM_CELLS_PER_BANK (FEB_NUM_CELLS_PER_IC * FEB_NUM_ICPBANK)
 
+// Total number of cells in the pack
+#define FEB_NUM_CELLS (FEB_NUM_CELLS_PER_BANK * FEB_NBANKS)
+
 // Number of temperature sensors per IC: 6 MUXes × 7 channels = 42
 #define FEB_NUM_TEMP_SENSE_PER_IC 42
 
@@ -27,9 +30,13 @@
 // ********************************** ADBMS6830B ADC Conversion Constants ********
 // From ADBMS6830B datasheet - Cell voltage measurement
 
-#define ADBMS_ADC_LSB_UV 150      // ADC resolution: 150 µV/LSB
-#define ADBMS_ADC_LSB_V 0.000150f // ADC resolution in volts
-#define ADBMS_ADC_OFFSET_V 1.5f   // ADC bipolar offset voltage
+#define ADBMS_ADC_LSB_UV 150        // ADC resolution: 150 µV/LSB
+#define ADBMS_ADC_LSB_V 0.000150f   // ADC resolution in volts
+#define ADBMS_ADC_OFFSET_V 1.5f     // ADC bipolar offset voltage
+#define ADBMS_ADC_OFFSET_UV 1500000 // ADC bipolar offset voltage in µV
+
+// Raw ADC code -> µV (int32_t); a 140-cell pack sum stays far below INT32_MAX
+#define ADBMS_CODE_TO_UV(code) ((int32_t)(code) * ADBMS_ADC_LSB_UV + ADBMS_ADC_OFFSET_UV)
 
 // ********************************** ADBMS6830B Open Wire Detection **************
 // Open Wire (OW) detection configuration for cell voltage measurements
@@ -103,6 +110,13 @@
 _Static_assert((FEB_TEMP_ERROR_THRESH + 1) * FEB_TEMP_SCAN_PERIOD_MS <= FEB_TEMP_FAULT_BUDGET_MS,
                "Over/under-temp fault must latch within the FSAE temperature window");
 
+// Pipelined temperature sweep (see FEB_ADBMS_Temperature_Process). Each MUX
+// channel waits FEB_TEMP_AUX_CONV_MS after ADAX before RDAUX; the previous
+// channel is decoded inside that window. BMS|tempscan reports the per-phase
+// split and the sweep wall time to size FEB_TEMP_SCAN_PERIOD_MS against.
+#define FEB_TEMP_MUX_CHANNELS 7 // SEL1..SEL3 positions used per MUX (0..6)
+#define FEB_TEMP_AUX_CONV_MS 5  // ADAX all-GPIO conversion wait per channel
+
 // Temperature-telemetry-loss fail-safe (FSAE: a disconnected temperature sense
 // wire must open the shutdown circuit within 1 s). If fewer than
 // FEB_TEMP_MIN_VALID_FRACTION of the POPULATED sensors read in-range for longer
@@ -177,6 +191,20 @@ _Static_assert((FEB_TEMP_ERROR_THRESH + 1) * FEB_TEMP_SCAN_PERIOD_MS <= FEB_TEMP
 #define ISOSPI_FAILOVER_LOCKOUT_MS 1000 // Milliseconds to wait before allowing failover again
 #define ISOSPI_PRIMARY_CHANNEL 1        // Primary channel: 1=SPI1, 2=SPI2
 
+// Register reads go through the queued transport in FEB_AD68xx_Async.c.
+// 1 = SPI DMA with completion interrupts; 0 = blocking HAL transfers.
+#ifndef ISOSPI_USE_DMA
+#define ISOSPI_USE_DMA 1
+#endif
+
+// PEC15/PEC10 implementation (FEB_AD68xx_PEC.c): slice-by-4 tables, or the
+// original byte-table/bit-serial code kept as a reference.
+#define ADBMS_PEC_ENGINE_REFERENCE 0
+#define ADBMS_PEC_ENGINE_SLICE4 1
+#ifndef ADBMS_PEC_ENGINE
+#define ADBMS_PEC_ENGINE ADBMS_PEC_ENGINE_SLICE4
+#endif
+
 // ********************************** IVT-S Sensor Configuration *****************
 
 // IVT-S voltage channel carrying the HV pack sense line (which IVT input the
@@ -206,11 +234,12 @@ _Static_assert((FEB_TEMP_ERROR_THRESH + 1) * FEB_TEMP_SCAN_PERIOD_MS <= FEB_TEMP
 // Bench bring-up of modules with desoldered cells: floating taps read garbage
 // on both ADBMS6830B voltage ADCs and latch spurious under/over-voltage faults.
 // Each macro removes one ADC's readings from the voltage-fault judgment in
-// validate_voltages():
-//   PRIMARY   -> C-ADC readings (cells[].voltage_V). Also compiles out the
-//                charging pack/cell over-voltage limits in
+// validate_cell_voltage() (its uV_C / uV_S arguments):
+//   PRIMARY   -> C-ADC readings (FEB_ACC.cell_c_codes, judged in uV). Also
+//                compiles out the charging pack/cell over-voltage limits in
 //                FEB_CAN_Charging_Status() (computed from primary readings).
-//   SECONDARY -> S-ADC readings (cells[].voltage_S, the redundancy confirmation).
+//   SECONDARY -> S-ADC readings (FEB_ACC.cell_s_codes, judged in uV; the
+//                redundancy confirmation).
 // With one side disabled, the other alone judges violations. With BOTH set to
 // 1, voltage faults never latch — would-be violations print a one-shot warning
 // instead (set both for a module with desoldered cells). Readings stay visible.
@@ -255,12 +284,75 @@ _Static_assert((FEB_TEMP_ERROR_THRESH + 1) * FEB_TEMP_SCAN_PERIOD_MS <= FEB_TEMP
 #define FEB_BMS_BENCH_PACK_VOLTAGE_V 60.0f
 #endif
 
+// ********************************** Cell History Ring **************************
+
+// Rolling history of raw cell-voltage and thermistor codes (FEB_Cell_History.c),
+// frozen when a fault latches so the lead-up can be dumped afterwards. A quiet
+// pack costs ~3.6 KB/s at the 10 Hz voltage and temperature scans, so the
+// default 16 KB holds the last ~4 s (bms_cell_history_test measures both).
+#ifndef FEB_HIST_BUF_BYTES
+#define FEB_HIST_BUF_BYTES 16384
+#endif
+
+// A record of each kind is coded against the previous record of that kind,
+// except every FEB_HIST_KEYFRAME_INTERVAL-th, which stands alone. After the
+// ring wraps, decoding resumes at the oldest surviving keyframe.
+#ifndef FEB_HIST_KEYFRAME_INTERVAL
+#define FEB_HIST_KEYFRAME_INTERVAL 10
+#endif
+
+// Bulk dump over CAN (BMS|hist|can): at most one frame per SM tick (1 ms).
+// ID and layout live in feb_can_ext_frames.h (0x0E4).
+
+// ********************************** SOC / Pack Resistance Estimator ************
+
+// FEB_SOC.c, stepped after every voltage scan (10 Hz) with the IVT current.
+// Pack capacity for coulomb counting, in amp-hours.
+#ifndef FEB_SOC_PACK_CAPACITY_AH
+#define FEB_SOC_PACK_CAPACITY_AH 13.0f // VERIFY: cell capacity x parallel count
+#endif
+
+// Rest detection for the open-circuit-voltage correction: |I| below this for
+// FEB_SOC_REST_TIME_MS means the cell-sum voltage is close enough to OCV.
+#ifndef FEB_SOC_REST_CURRENT_A
+#define FEB_SOC_REST_CURRENT_A 1.0f
+#endif
+#ifndef FEB_SOC_REST_TIME_MS
+#define FEB_SOC_REST_TIME_MS 30000
+#endif
+
+// Time constant of the pull toward the OCV-derived SOC once at rest (TUNE).
+#ifndef FEB_SOC_OCV_TAU_S
+#define FEB_SOC_OCV_TAU_S 60.0f
+#endif
+
+// Pack resistance by recursive least squares on scan-to-scan steps
+// (dV = -R * dI). Only steps of at least FEB_SOC_RLS_MIN_DI_A update it;
+// the forgetting factor lets it track temperature and ageing.
+#ifndef FEB_SOC_RLS_MIN_DI_A
+#define FEB_SOC_RLS_MIN_DI_A 5.0f
+#endif
+#ifndef FEB_SOC_RLS_LAMBDA
+#define FEB_SOC_RLS_LAMBDA 0.995f
+#endif
+#ifndef FEB_SOC_R_INIT_OHM
+#define FEB_SOC_R_INIT_OHM 1.0f // matches the PCU's fixed assumption
+#endif
+#ifndef FEB_SOC_R_MIN_OHM
+#define FEB_SOC_R_MIN_OHM 0.05f
+#endif
+#ifndef FEB_SOC_R_MAX_OHM
+#define FEB_SOC_R_MAX_OHM 3.0f
+#endif
+
+// Broadcast every 100 ms for the PCU (regen SOC filter, current derating).
+// Not in the generated CAN library: ID and layout are shared with the PCU
+// through feb_can_ext_frames.h (0x0E5).
+
 // ********************************** Accumulator Structure **********************
 
 typedef struct
 {
-  float voltage_V; // C-code voltage measurement
-  float voltage_S; // S-code voltage measurement (redundant)
   float temperature_C;
   uint8_t violations;  // Consecutive violation counter for this cell
   uint8_t discharging; // Cell is being discharged for balancing
@@ -281,17 +373,23 @@ typedef struct
   float temp_sensor_readings_V[FEB_NUM_TEMP_SENSORS]; // Temperature sensor readings
   uint8_t temp_violations[FEB_NUM_TEMP_SENSORS];      // Per-sensor violation counters
   uint16_t therm_raw_codes[FEB_NUM_TEMP_SENSORS];     // Raw ADC codes (0xFFFF = PEC failure)
-  float therm_raw_voltages_mV[FEB_NUM_TEMP_SENSORS];  // Converted mV (NaN = PEC failure)
 } bank_data_t;
 
 typedef struct
 {
   bank_data_t banks[FEB_NBANKS];
-  float total_voltage_V;
-  float min_voltage_V;
-  float max_voltage_V;
-  float pack_min_voltage_V; // Minimum cell voltage across entire pack
-  float pack_max_voltage_V; // Maximum cell voltage across entire pack
+  // Cell voltages as raw ADC codes in pack order (bank * FEB_NUM_CELLS_PER_BANK
+  // + cell). A cell whose register group failed PEC keeps its last good code.
+  int16_t cell_c_codes[FEB_NUM_CELLS]; // C-ADC (primary)
+  int16_t cell_s_codes[FEB_NUM_CELLS]; // S-ADC (redundant)
+  // Pack aggregates over the cells read this scan, in µV
+  int32_t total_voltage_uV;
+  int32_t pack_min_voltage_uV; // Minimum cell voltage across entire pack
+  int32_t pack_max_voltage_uV; // Maximum cell voltage across entire pack
+  uint16_t pack_min_cell;      // Pack index of the minimum cell
+  uint16_t pack_max_cell;      // Pack index of the maximum cell
+  uint16_t cells_read;         // Cells with a good PEC this scan
+  uint16_t cells_violating;    // Cells out of range this scan
   float avg_temp_C;
   float pack_min_temp;     // Minimum temperature across entire pack
   float pack_max_temp;     // Maximum temperature across entire pack
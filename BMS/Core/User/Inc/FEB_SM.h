@@ -98,4 +98,87 @@ bool FEB_SM_Is_Drive_Ready(void);
  */
 bool FEB_SM_IMD_Armed(void);
 
+/**
+ * @brief Overcurrent limit for the current state
+ * @return FEB_CHARGE_OVERCURRENT_A on the charger path, else FEB_DISCHARGE_OVERCURRENT_A
+ */
+float FEB_SM_Get_Overcurrent_Limit_A(void);
+
+/* ============================================================================
+ * Fault Events
+ *
+ * Producers that see a limit crossed wake the SM task at once instead of
+ * waiting for its next 1 ms poll. The event only shortens the wait: the task
+ * re-runs the same fault evaluation, so the snapshot checks stay the single
+ * source of truth and a lost event costs at most one tick.
+ * ============================================================================ */
+
+typedef enum
+{
+  FEB_SM_EVENT_ADBMS = 0, /**< ADBMS task latched a new cell V/T/sensor fault flag */
+  FEB_SM_EVENT_IVT,       /**< IVT current frame above FEB_SM_Get_Overcurrent_Limit_A() */
+  FEB_SM_EVENT_COUNT
+} FEB_SM_Event_t;
+
+/**
+ * @brief Wake the SM task to evaluate faults now
+ * @param event     Event source
+ * @param sample_us FEB_Time_Us() when the offending data was sampled
+ * @note Task or ISR context
+ */
+void FEB_SM_Notify_Event(FEB_SM_Event_t event, uint64_t sample_us);
+
+/**
+ * @brief Evaluate faults if an event is pending
+ * @note Call from the SM task on every wake, before the periodic FEB_SM_Process()
+ */
+void FEB_SM_Process_Events(void);
+
+/**
+ * @brief Number of events raised by a source since boot
+ */
+uint32_t FEB_SM_Get_Event_Count(FEB_SM_Event_t event);
+
+/* ============================================================================
+ * Fault Latency Instrumentation
+ *
+ * Every fault entry records two latencies, in FEB_Time_Us() microseconds:
+ *   DETECT  sample time of the offending data -> fault_begin()
+ *   OPEN    fault_begin() -> BMS shutdown relay commanded open
+ * into a log2 histogram per fault type. Bucket 0 holds 0 us, bucket b holds
+ * [2^(b-1), 2^b) us, and the last bucket is open-ended.
+ * ============================================================================ */
+
+#define FEB_SM_LAT_BUCKETS 20
+
+typedef enum
+{
+  FEB_SM_LAT_DETECT = 0,
+  FEB_SM_LAT_OPEN,
+  FEB_SM_LAT_STAGE_COUNT
+} FEB_SM_Lat_Stage_t;
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint64_t sum_us;
+  uint32_t bucket[FEB_SM_LAT_BUCKETS];
+} FEB_SM_Lat_Hist_t;
+
+/**
+ * @brief Copy one fault latency histogram
+ * @param fault_type One of the BMS_STATE_FAULT_* states
+ * @param stage      Latency stage
+ * @param out        Destination
+ * @return false if fault_type is not a fault state
+ */
+bool FEB_SM_Get_Fault_Latency(BMS_State_t fault_type, FEB_SM_Lat_Stage_t stage, FEB_SM_Lat_Hist_t *out);
+
+/**
+ * @brief Clear all fault latency histograms
+ */
+void FEB_SM_Reset_Fault_Latency(void);
+
 #endif /* INC_FEB_SM_H_ */
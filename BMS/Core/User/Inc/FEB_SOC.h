@@ -0,0 +1,68 @@
+#ifndef INC_FEB_SOC_H_
+#define INC_FEB_SOC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FEB_Const.h"
+
+// ********************************** SOC / Pack Resistance Estimator ************
+// Fixed-step estimator run once per voltage scan. No HAL or RTOS dependencies,
+// so the same code runs in BMS/Host/bms_soc_sim.
+//
+// SOC: coulomb counting on the IVT current (positive = discharge), pulled
+// toward the SOC read off the cell OCV curve once the pack has rested
+// FEB_SOC_REST_TIME_MS. The first step initialises from the OCV curve (the
+// AIRs are open at boot, so the cell-sum voltage is OCV).
+//
+// R_pack: scalar recursive least squares on scan-to-scan steps,
+//   V[k-1] - V[k] = R * (I[k] - I[k-1])
+// which cancels the slowly moving OCV. Only steps with |dI| >=
+// FEB_SOC_RLS_MIN_DI_A update it, so the covariance does not wind up while
+// cruising or parked.
+
+#define FEB_SOC_FLAG_VALID 0x01U       // SOC initialised from a voltage scan
+#define FEB_SOC_FLAG_R_CONVERGED 0x02U // R_pack covariance has settled
+#define FEB_SOC_FLAG_AT_REST 0x04U     // OCV correction active this step
+#define FEB_SOC_FLAG_NO_CURRENT 0x08U  // IVT current stale: SOC held
+
+typedef struct
+{
+  float soc;            // 0..1
+  float r_ohm;          // Pack resistance estimate
+  float r_var;          // RLS covariance (ohm^2 / A^2)
+  float ah_out;         // Net charge out since init (A*h)
+  float rest_s;         // Time at |I| < FEB_SOC_REST_CURRENT_A
+  float prev_pack_V;    // Previous step, for the RLS difference
+  float prev_current_A;
+  bool prev_valid;
+  uint32_t rls_updates;
+  uint8_t flags;        // FEB_SOC_FLAG_*
+} FEB_SOC_t;
+
+/**
+ * @brief Reset to uninitialised; the next step seeds SOC from the OCV curve.
+ */
+void FEB_SOC_Init(FEB_SOC_t *est);
+
+/**
+ * @brief Advance by one scan.
+ *
+ * @param dt_s           Time since the previous step (clamped to 1 s)
+ * @param current_A      IVT pack current, positive = discharge
+ * @param current_valid  false if the IVT is stale (SOC is held, R not updated)
+ * @param pack_V         Cell-sum pack voltage from this scan
+ * @param cells          Cells in that sum (> 0)
+ */
+void FEB_SOC_Step(FEB_SOC_t *est, float dt_s, float current_A, bool current_valid, float pack_V, uint16_t cells);
+
+/**
+ * @brief Cell open-circuit voltage at a SOC (0..1), from the OCV table.
+ */
+float FEB_SOC_Cell_OCV(float soc);
+
+/**
+ * @brief SOC (0..1) at a cell open-circuit voltage, from the OCV table.
+ */
+float FEB_SOC_From_Cell_OCV(float cell_V);
+
+#endif /* INC_FEB_SOC_H_ */
@@ -0,0 +1,23 @@
+#ifndef INC_FEB_TEMP_MEDIAN_H_
+#define INC_FEB_TEMP_MEDIAN_H_
+
+// ********************************** Bank Temperature Median ********************
+// Robust per-bank plausibility reference for validate_temps(): a minority of
+// bad-connection spikes cannot shift the median, so genuine cell readings still
+// define it while outliers stand out. No HAL or RTOS, so the host bench runs the
+// same code as the ADBMS task.
+
+/**
+ * @brief Median of n readings (dC), by in-place quickselect
+ *
+ * Reorders a[0..n). Expected O(n); median-of-three pivots keep already-ordered
+ * banks (a slow thermal gradient along the MUX order) on the linear path. An
+ * even count returns 0.5f * (lower + upper), the same value a full sort gives.
+ *
+ * @param a      Readings, at least n (reordered)
+ * @param n      Reading count; caller guarantees n >= 1
+ * @return float Median in dC
+ */
+float FEB_Temp_Median_dC(float *a, int n);
+
+#endif /* INC_FEB_TEMP_MEDIAN_H_ */
@@ -6,7 +6,8 @@
 #include "FEB_Const.h"
 
 // ********************************** Thermistor Beta Parameter Conversion *********
-// Converts thermistor voltage to temperature using the Beta parameter equation
+// Converts thermistor voltage to temperature using the Beta parameter equation.
+// This float path is the reference; the scan loop uses the lookup table below.
 //
 // Equation:
 //   R_therm = V_meas * R_pullup / (Vs - V_meas)
@@ -63,4 +64,31 @@ static inline float FEB_Thermistor_Voltage_To_Temp_C(float voltage_mV)
   return T_kelvin - THERM_KELVIN_OFFSET;
 }
 
+// ********************************** Lookup Table Conversion *******************
+// ADC code -> temperature via a table of Beta-equation nodes, one every
+// 2^THERM_LUT_SHIFT codes across the signed 16-bit code space, linearly
+// interpolated. Nodes are stored in centi-degC and filled once by
+// FEB_Thermistor_Init() from the THERM_* and ADBMS_ADC_* constants, so the
+// table cannot drift from FEB_Const.h. With 32-code (4.8 mV) spacing the
+// result is within 0.07 degC of the float path across the whole
+// THERM_*_VOLTAGE_MV window (the hot end, where the curve bends hardest, sets
+// the bound). The table costs 4 KB of RAM.
+
+#define THERM_LUT_SHIFT 5
+#define THERM_LUT_SIZE ((65536U >> THERM_LUT_SHIFT) + 1U)
+#define THERM_TEMP_INVALID_DC INT16_MIN // Outside THERM_MIN/MAX_VOLTAGE_MV
+
+/**
+ * @brief Build the code -> temperature table. Call once before the first scan.
+ */
+void FEB_Thermistor_Init(void);
+
+/**
+ * @brief Convert a raw ADBMS aux ADC code to temperature using the lookup table
+ *
+ * @param code      Signed aux ADC code (ADBMS_ADC_LSB_V per LSB, ADBMS_ADC_OFFSET_V offset)
+ * @return int16_t  Temperature in deci-Celsius, or THERM_TEMP_INVALID_DC for invalid readings
+ */
+int16_t FEB_Thermistor_Code_To_Temp_dC(int16_t code);
+
 #endif /* INC_FEB_THERMISTOR_H_ */
@@ -0,0 +1,398 @@
+// ********************************** Includes & Externs *************************
+
+#include "FEB_AD68xx_Async.h"
+#include "FEB_AD68xx_Interface.h"
+#include "FEB_HW.h"
+#include "FEB_Const.h"
+#include "cmsis_os.h"
+#include "feb_log.h"
+#include <string.h>
+
+#define TAG_ADBMS "[ADBMS]"
+
+extern osMutexId_t ADBMSMutexHandle;
+
+// ********************************** Queue State ********************************
+// Single producer (the thread holding ADBMSMutexHandle), single consumer (the
+// SPI completion ISR). Slots between s_head and s_tail are QUEUED in submit
+// order; s_active is the one on the wire. The producer owns FREE slots and
+// the ISR never frees one, so only the hand-over needs a critical section.
+// async_submit refuses callers that do not own the mutex, and the blocking
+// cmd_68/write_68 path refuses to touch the bus while ADBMS_Async_Busy().
+
+typedef enum
+{
+  SLOT_FREE = 0,
+  SLOT_QUEUED,
+  SLOT_ACTIVE,
+  SLOT_DONE,
+  SLOT_FAILED,
+} adbms_slot_state_t;
+
+typedef struct
+{
+  uint8_t tx[ADBMS_ASYNC_FRAME_BYTES];
+  uint8_t rx[ADBMS_ASYNC_FRAME_BYTES];
+  SPI_HandleTypeDef *spi; // Latched from FEB_ACTIVE_* at submit
+  GPIO_TypeDef *cs_port;
+  uint16_t cs_pin;
+  uint16_t len;
+  uint8_t reply_ics; // ICs whose reply PEC10 to check; 0 for commands/writes
+  volatile uint8_t state;
+  volatile uint8_t status; // ADBMS_Xfer_Status_t once FAILED
+} adbms_slot_t;
+
+_Static_assert(FEB_NUM_IC <= 32, "ADBMS_Async_Wait reports PEC failures as a 32-bit IC mask");
+
+static adbms_slot_t s_slots[ADBMS_ASYNC_QUEUE_DEPTH];
+static volatile uint8_t s_head;
+static uint8_t s_tail;
+static volatile int8_t s_active = -1;
+static osThreadId_t s_waiter;
+static SPI_HandleTypeDef *s_last_spi;
+static ADBMS_Async_Stats_t s_stats;
+
+static inline uint8_t slot_next(uint8_t i)
+{
+  return (uint8_t)((i + 1U) % ADBMS_ASYNC_QUEUE_DEPTH);
+}
+
+static inline uint32_t async_lock(void)
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+}
+
+static inline void async_unlock(uint32_t primask)
+{
+  __set_PRIMASK(primask);
+}
+
+// ********************************** Engine *************************************
+
+// Retire the active frame. ISR context (DMA) or task context (blocking).
+static void async_finish(adbms_slot_t *slot, bool ok)
+{
+  HAL_GPIO_WritePin(slot->cs_port, slot->cs_pin, GPIO_PIN_SET);
+  if (ok)
+  {
+    s_stats.frames++;
+    s_stats.bytes += slot->len;
+    slot->state = SLOT_DONE;
+  }
+  else
+  {
+    s_stats.spi_errors++;
+    slot->status = ADBMS_XFER_SPI_ERROR;
+    slot->state = SLOT_FAILED;
+  }
+  s_active = -1;
+  s_head = slot_next(s_head);
+}
+
+// Start queued frames until one is on the wire (DMA) or the queue is empty
+// (blocking). DMA build: call with interrupts masked.
+static void async_start_next(void)
+{
+  while (s_active < 0 && s_slots[s_head].state == SLOT_QUEUED)
+  {
+    adbms_slot_t *slot = &s_slots[s_head];
+    slot->state = SLOT_ACTIVE;
+    s_active = (int8_t)s_head;
+    HAL_GPIO_WritePin(slot->cs_port, slot->cs_pin, GPIO_PIN_RESET);
+#if ISOSPI_USE_DMA
+    if (HAL_SPI_TransmitReceive_DMA(slot->spi, slot->tx, slot->rx, slot->len) != HAL_OK)
+    {
+      async_finish(slot, false);
+    }
+#else
+    bool ok = (HAL_SPI_TransmitReceive(slot->spi, slot->tx, slot->rx, slot->len, FEB_SPI_TIMEOUT_MS) == HAL_OK);
+    async_finish(slot, ok);
+#endif
+  }
+}
+
+#if ISOSPI_USE_DMA
+// The ISR only retires the frame and wakes the waiter; the waiter starts the
+// next one (async_kick). The isoSPI CS-high gap between chained frames is the
+// interrupt exit plus the thread wake-up, never a spin at interrupt level.
+static void async_isr_complete(SPI_HandleTypeDef *hspi, bool ok)
+{
+  if (s_active < 0 || s_slots[s_active].spi != hspi)
+  {
+    return;
+  }
+  async_finish(&s_slots[s_active], ok);
+
+  if (s_waiter != NULL)
+  {
+    osThreadFlagsSet(s_waiter, ADBMS_ASYNC_DONE_FLAG);
+  }
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  async_isr_complete(hspi, true);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  async_isr_complete(hspi, false);
+}
+#endif
+
+// Put the next queued frame on the wire if the bus is idle. Task context.
+static void async_kick(void)
+{
+#if ISOSPI_USE_DMA
+  uint32_t primask = async_lock();
+  async_start_next();
+  async_unlock(primask);
+#endif
+}
+
+// Drop everything in flight or queued after a timeout.
+static void async_abort(void)
+{
+  uint32_t primask = async_lock();
+  if (s_active >= 0)
+  {
+    adbms_slot_t *slot = &s_slots[s_active];
+    HAL_SPI_Abort(slot->spi);
+    HAL_GPIO_WritePin(slot->cs_port, slot->cs_pin, GPIO_PIN_SET);
+  }
+  for (uint8_t i = 0; i < ADBMS_ASYNC_QUEUE_DEPTH; i++)
+  {
+    if (s_slots[i].state == SLOT_QUEUED || s_slots[i].state == SLOT_ACTIVE)
+    {
+      s_slots[i].status = ADBMS_XFER_TIMEOUT;
+      s_slots[i].state = SLOT_FAILED;
+    }
+  }
+  s_active = -1;
+  s_head = s_tail;
+  s_stats.timeouts++;
+  async_unlock(primask);
+}
+
+static int8_t async_submit(uint16_t cmdcode, uint8_t total_ic, const uint8_t *wr_data, bool read)
+{
+  if (osMutexGetOwner(ADBMSMutexHandle) != osThreadGetId())
+  {
+    s_stats.not_owner++;
+    return -1;
+  }
+  if (total_ic > FEB_NUM_IC)
+  {
+    total_ic = FEB_NUM_IC;
+  }
+
+  adbms_slot_t *slot = &s_slots[s_tail];
+  if (slot->state != SLOT_FREE)
+  {
+    s_stats.queue_full++;
+    return -1;
+  }
+
+  slot->tx[0] = (uint8_t)(cmdcode >> 8);
+  slot->tx[1] = (uint8_t)cmdcode;
+  uint16_t cmd_pec = pec15_calc(2, slot->tx);
+  slot->tx[2] = (uint8_t)(cmd_pec >> 8);
+  slot->tx[3] = (uint8_t)cmd_pec;
+  slot->len = 4;
+  slot->reply_ics = 0;
+
+  if (read)
+  {
+    slot->len = (uint16_t)(4U + 8U * total_ic);
+    slot->reply_ics = total_ic;
+    memset(&slot->tx[4], 0xFF, 8U * total_ic);
+  }
+  else if (wr_data != NULL)
+  {
+    // Same layout as write_68: the first payload out lands on the last IC.
+    uint8_t *p = &slot->tx[4];
+    for (uint8_t ic = total_ic; ic > 0; ic--)
+    {
+      const uint8_t *src = &wr_data[(ic - 1U) * 6U];
+      memcpy(p, src, 6);
+      uint16_t data_pec = Pec10_calc(false, 6, (uint8_t *)src);
+      p[6] = (uint8_t)(data_pec >> 8);
+      p[7] = (uint8_t)data_pec;
+      p += 8;
+    }
+    slot->len = (uint16_t)(4U + 8U * total_ic);
+  }
+
+  uint8_t outstanding = 0;
+  for (uint8_t i = 0; i < ADBMS_ASYNC_QUEUE_DEPTH; i++)
+  {
+    if (s_slots[i].state != SLOT_FREE)
+    {
+      outstanding++;
+    }
+  }
+
+  // First frame of a batch, or the redundancy layer moved us to the other
+  // channel: wake the chain on the channel this frame will use.
+  if (outstanding == 0U || s_last_spi != FEB_ACTIVE_SPI)
+  {
+    wakeup_sleep(total_ic);
+    s_stats.wakeups++;
+  }
+
+  s_waiter = osThreadGetId();
+
+  uint32_t primask = async_lock();
+  slot->spi = FEB_ACTIVE_SPI;
+  slot->cs_port = FEB_ACTIVE_CS_PORT;
+  slot->cs_pin = FEB_ACTIVE_CS_PIN;
+  slot->state = SLOT_QUEUED;
+  s_last_spi = slot->spi;
+  int8_t ticket = (int8_t)s_tail;
+  s_tail = slot_next(s_tail);
+  if (outstanding + 1U > s_stats.queue_peak)
+  {
+    s_stats.queue_peak = (uint8_t)(outstanding + 1U);
+  }
+#if ISOSPI_USE_DMA
+  async_start_next();
+  async_unlock(primask);
+#else
+  async_unlock(primask);
+  async_start_next();
+#endif
+  return ticket;
+}
+
+// ********************************** Public API *********************************
+
+void ADBMS_Async_Init(void)
+{
+#if ISOSPI_USE_DMA && !defined(FEB_HOST_BUILD)
+  // Streams are linked in spi.c (BMS.ioc); a handle without them would fault
+  // in HAL_SPI_TransmitReceive_DMA.
+  SPI_HandleTypeDef *spi = FEB_ACTIVE_SPI;
+  if (spi->hdmarx == NULL || spi->hdmatx == NULL)
+  {
+    LOG_E(TAG_ADBMS, "isoSPI DMA streams not linked; regenerate spi.c from BMS.ioc");
+  }
+#endif
+}
+
+bool ADBMS_Async_Busy(void)
+{
+  for (uint8_t i = 0; i < ADBMS_ASYNC_QUEUE_DEPTH; i++)
+  {
+    uint8_t state = s_slots[i].state;
+    if (state == SLOT_QUEUED || state == SLOT_ACTIVE)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ADBMS_Async_CountBlockingRefused(void)
+{
+  s_stats.blocking_refused++;
+}
+
+int8_t ADBMS_Async_Read(uint16_t cmdcode, uint8_t total_ic)
+{
+  return async_submit(cmdcode, total_ic, NULL, true);
+}
+
+int8_t ADBMS_Async_Command(uint16_t cmdcode)
+{
+  int8_t ticket = async_submit(cmdcode, 0, NULL, false);
+  if (ticket >= 0)
+  {
+    ADBMS_CC_Advance();
+  }
+  return ticket;
+}
+
+int8_t ADBMS_Async_Write(uint16_t cmdcode, uint8_t total_ic, const uint8_t *data)
+{
+  int8_t ticket = async_submit(cmdcode, total_ic, data, false);
+  if (ticket >= 0)
+  {
+    ADBMS_CC_Advance();
+  }
+  return ticket;
+}
+
+ADBMS_Xfer_Status_t ADBMS_Async_Wait(int8_t ticket, uint8_t *rx, uint32_t *pec_fail, uint32_t timeout_ms)
+{
+  if (pec_fail != NULL)
+  {
+    *pec_fail = 0;
+  }
+  if (ticket < 0 || ticket >= ADBMS_ASYNC_QUEUE_DEPTH || s_slots[ticket].state == SLOT_FREE)
+  {
+    return ADBMS_XFER_INVALID;
+  }
+
+  adbms_slot_t *slot = &s_slots[ticket];
+  const uint32_t start = osKernelGetTickCount();
+  const uint32_t limit = pdMS_TO_TICKS(timeout_ms);
+  async_kick();
+  while (slot->state == SLOT_QUEUED || slot->state == SLOT_ACTIVE)
+  {
+    uint32_t elapsed = osKernelGetTickCount() - start;
+    if (elapsed >= limit)
+    {
+      async_abort();
+      break;
+    }
+    (void)osThreadFlagsWait(ADBMS_ASYNC_DONE_FLAG, osFlagsWaitAny, limit - elapsed);
+    async_kick();
+  }
+
+  if (slot->state == SLOT_FAILED)
+  {
+    ADBMS_Xfer_Status_t status = (ADBMS_Xfer_Status_t)slot->status;
+    slot->state = SLOT_FREE;
+    return status;
+  }
+
+  // PEC10 per IC: byte 6 = {CC[5:0], PEC[9:8]}, byte 7 = PEC[7:0].
+  uint32_t mask = 0;
+  for (uint8_t icn = 0; icn < slot->reply_ics; icn++)
+  {
+    uint8_t *ic_data = &slot->rx[4U + 8U * icn];
+    uint16_t calc_pec = Pec10_calc(true, 6, ic_data);
+    uint16_t rx_pec = (uint16_t)(((uint16_t)(ic_data[6] & 0x03U) << 8) | ic_data[7]);
+    if (calc_pec != rx_pec)
+    {
+      mask |= (1UL << icn);
+      s_stats.pec_errors++;
+    }
+  }
+  if (rx != NULL && slot->reply_ics != 0U)
+  {
+    memcpy(rx, &slot->rx[4], 8U * slot->reply_ics);
+  }
+  if (pec_fail != NULL)
+  {
+    *pec_fail = mask;
+  }
+  slot->state = SLOT_FREE;
+  return ADBMS_XFER_OK;
+}
+
+void ADBMS_Async_GetStats(ADBMS_Async_Stats_t *stats)
+{
+  uint32_t primask = async_lock();
+  *stats = s_stats;
+  async_unlock(primask);
+}
+
+void ADBMS_Async_ResetStats(void)
+{
+  uint32_t primask = async_lock();
+  memset(&s_stats, 0, sizeof(s_stats));
+  async_unlock(primask);
+}
@@ -0,0 +1,384 @@
+// ********************************** Includes ***********************************
+
+#include "FEB_AD68xx_Interface.h"
+#include "FEB_Const.h"
+
+// ********************************** PEC Engine *********************************
+// PEC15 guards every command; PEC10 guards every 6-byte register group in both
+// directions (RX folds in the 6-bit command counter). ADBMS_PEC_ENGINE in
+// FEB_Const.h picks the implementation at compile time:
+//
+//   ADBMS_PEC_ENGINE_SLICE4     Both CRCs run on a left-aligned 16-bit register
+//                               with four 256-entry tables each, consuming up to
+//                               4 bytes per step (2 for a command, 4 + 2 for a
+//                               register group). ~4 KB of flash.
+//   ADBMS_PEC_ENGINE_REFERENCE  The original byte-table PEC15 and bit-serial
+//                               PEC10, kept for cross-checking.
+//
+// There is no hardware path: the STM32F4 CRC unit is fixed to CRC-32
+// (0x04C11DB7) and cannot be configured for either polynomial.
+
+#if (ADBMS_PEC_ENGINE == ADBMS_PEC_ENGINE_SLICE4)
+
+// ********************************** CRC Tables *********************************
+
+// PEC15 on a left-aligned 16-bit register (poly 0x4599 << 1). pec15_slice[k][v]
+// is byte v followed by k zero bytes.
+static const uint16_t pec15_slice[4][256] = {
+    {
+        0x0000, 0x8B32, 0x9D56, 0x1664, 0xB19E, 0x3AAC, 0x2CC8, 0xA7FA, 0xE80E, 0x633C, 0x7558, 0xFE6A,
+        0x5990, 0xD2A2, 0xC4C6, 0x4FF4, 0x5B2E, 0xD01C, 0xC678, 0x4D4A, 0xEAB0, 0x6182, 0x77E6, 0xFCD4,
+        0xB320, 0x3812, 0x2E76, 0xA544, 0x02BE, 0x898C, 0x9FE8, 0x14DA, 0xB65C, 0x3D6E, 0x2B0A, 0xA038,
+        0x07C2, 0x8CF0, 0x9A94, 0x11A6, 0x5E52, 0xD560, 0xC304, 0x4836, 0xEFCC, 0x64FE, 0x729A, 0xF9A8,
+        0xED72, 0x6640, 0x7024, 0xFB16, 0x5CEC, 0xD7DE, 0xC1BA, 0x4A88, 0x057C, 0x8E4E, 0x982A, 0x1318,
+        0xB4E2, 0x3FD0, 0x29B4, 0xA286, 0xE78A, 0x6CB8, 0x7ADC, 0xF1EE, 0x5614, 0xDD26, 0xCB42, 0x4070,
+        0x0F84, 0x84B6, 0x92D2, 0x19E0, 0xBE1A, 0x3528, 0x234C, 0xA87E, 0xBCA4, 0x3796, 0x21F2, 0xAAC0,
+        0x0D3A, 0x8608, 0x906C, 0x1B5E, 0x54AA, 0xDF98, 0xC9FC, 0x42CE, 0xE534, 0x6E06, 0x7862, 0xF350,
+        0x51D6, 0xDAE4, 0xCC80, 0x47B2, 0xE048, 0x6B7A, 0x7D1E, 0xF62C, 0xB9D8, 0x32EA, 0x248E, 0xAFBC,
+        0x0846, 0x8374, 0x9510, 0x1E22, 0x0AF8, 0x81CA, 0x97AE, 0x1C9C, 0xBB66, 0x3054, 0x2630, 0xAD02,
+        0xE2F6, 0x69C4, 0x7FA0, 0xF492, 0x5368, 0xD85A, 0xCE3E, 0x450C, 0x4426, 0xCF14, 0xD970, 0x5242,
+        0xF5B8, 0x7E8A, 0x68EE, 0xE3DC, 0xAC28, 0x271A, 0x317E, 0xBA4C, 0x1DB6, 0x9684, 0x80E0, 0x0BD2,
+        0x1F08, 0x943A, 0x825E, 0x096C, 0xAE96, 0x25A4, 0x33C0, 0xB8F2, 0xF706, 0x7C34, 0x6A50, 0xE162,
+        0x4698, 0xCDAA, 0xDBCE, 0x50FC, 0xF27A, 0x7948, 0x6F2C, 0xE41E, 0x43E4, 0xC8D6, 0xDEB2, 0x5580,
+        0x1A74, 0x9146, 0x8722, 0x0C10, 0xABEA, 0x20D8, 0x36BC, 0xBD8E, 0xA954, 0x2266, 0x3402, 0xBF30,
+        0x18CA, 0x93F8, 0x859C, 0x0EAE, 0x415A, 0xCA68, 0xDC0C, 0x573E, 0xF0C4, 0x7BF6, 0x6D92, 0xE6A0,
+        0xA3AC, 0x289E, 0x3EFA, 0xB5C8, 0x1232, 0x9900, 0x8F64, 0x0456, 0x4BA2, 0xC090, 0xD6F4, 0x5DC6,
+        0xFA3C, 0x710E, 0x676A, 0xEC58, 0xF882, 0x73B0, 0x65D4, 0xEEE6, 0x491C, 0xC22E, 0xD44A, 0x5F78,
+        0x108C, 0x9BBE, 0x8DDA, 0x06E8, 0xA112, 0x2A20, 0x3C44, 0xB776, 0x15F0, 0x9EC2, 0x88A6, 0x0394,
+        0xA46E, 0x2F5C, 0x3938, 0xB20A, 0xFDFE, 0x76CC, 0x60A8, 0xEB9A, 0x4C60, 0xC752, 0xD136, 0x5A04,
+        0x4EDE, 0xC5EC, 0xD388, 0x58BA, 0xFF40, 0x7472, 0x6216, 0xE924, 0xA6D0, 0x2DE2, 0x3B86, 0xB0B4,
+        0x174E, 0x9C7C, 0x8A18, 0x012A
+    },
+    {
+        0x0000, 0x884C, 0x9BAA, 0x13E6, 0xBC66, 0x342A, 0x27CC, 0xAF80, 0xF3FE, 0x7BB2, 0x6854, 0xE018,
+        0x4F98, 0xC7D4, 0xD432, 0x5C7E, 0x6CCE, 0xE482, 0xF764, 0x7F28, 0xD0A8, 0x58E4, 0x4B02, 0xC34E,
+        0x9F30, 0x177C, 0x049A, 0x8CD6, 0x2356, 0xAB1A, 0xB8FC, 0x30B0, 0xD99C, 0x51D0, 0x4236, 0xCA7A,
+        0x65FA, 0xEDB6, 0xFE50, 0x761C, 0x2A62, 0xA22E, 0xB1C8, 0x3984, 0x9604, 0x1E48, 0x0DAE, 0x85E2,
+        0xB552, 0x3D1E, 0x2EF8, 0xA6B4, 0x0934, 0x8178, 0x929E, 0x1AD2, 0x46AC, 0xCEE0, 0xDD06, 0x554A,
+        0xFACA, 0x7286, 0x6160, 0xE92C, 0x380A, 0xB046, 0xA3A0, 0x2BEC, 0x846C, 0x0C20, 0x1FC6, 0x978A,
+        0xCBF4, 0x43B8, 0x505E, 0xD812, 0x7792, 0xFFDE, 0xEC38, 0x6474, 0x54C4, 0xDC88, 0xCF6E, 0x4722,
+        0xE8A2, 0x60EE, 0x7308, 0xFB44, 0xA73A, 0x2F76, 0x3C90, 0xB4DC, 0x1B5C, 0x9310, 0x80F6, 0x08BA,
+        0xE196, 0x69DA, 0x7A3C, 0xF270, 0x5DF0, 0xD5BC, 0xC65A, 0x4E16, 0x1268, 0x9A24, 0x89C2, 0x018E,
+        0xAE0E, 0x2642, 0x35A4, 0xBDE8, 0x8D58, 0x0514, 0x16F2, 0x9EBE, 0x313E, 0xB972, 0xAA94, 0x22D8,
+        0x7EA6, 0xF6EA, 0xE50C, 0x6D40, 0xC2C0, 0x4A8C, 0x596A, 0xD126, 0x7014, 0xF858, 0xEBBE, 0x63F2,
+        0xCC72, 0x443E, 0x57D8, 0xDF94, 0x83EA, 0x0BA6, 0x1840, 0x900C, 0x3F8C, 0xB7C0, 0xA426, 0x2C6A,
+        0x1CDA, 0x9496, 0x8770, 0x0F3C, 0xA0BC, 0x28F0, 0x3B16, 0xB35A, 0xEF24, 0x6768, 0x748E, 0xFCC2,
+        0x5342, 0xDB0E, 0xC8E8, 0x40A4, 0xA988, 0x21C4, 0x3222, 0xBA6E, 0x15EE, 0x9DA2, 0x8E44, 0x0608,
+        0x5A76, 0xD23A, 0xC1DC, 0x4990, 0xE610, 0x6E5C, 0x7DBA, 0xF5F6, 0xC546, 0x4D0A, 0x5EEC, 0xD6A0,
+        0x7920, 0xF16C, 0xE28A, 0x6AC6, 0x36B8, 0xBEF4, 0xAD12, 0x255E, 0x8ADE, 0x0292, 0x1174, 0x9938,
+        0x481E, 0xC052, 0xD3B4, 0x5BF8, 0xF478, 0x7C34, 0x6FD2, 0xE79E, 0xBBE0, 0x33AC, 0x204A, 0xA806,
+        0x0786, 0x8FCA, 0x9C2C, 0x1460, 0x24D0, 0xAC9C, 0xBF7A, 0x3736, 0x98B6, 0x10FA, 0x031C, 0x8B50,
+        0xD72E, 0x5F62, 0x4C84, 0xC4C8, 0x6B48, 0xE304, 0xF0E2, 0x78AE, 0x9182, 0x19CE, 0x0A28, 0x8264,
+        0x2DE4, 0xA5A8, 0xB64E, 0x3E02, 0x627C, 0xEA30, 0xF9D6, 0x719A, 0xDE1A, 0x5656, 0x45B0, 0xCDFC,
+        0xFD4C, 0x7500, 0x66E6, 0xEEAA, 0x412A, 0xC966, 0xDA80, 0x52CC, 0x0EB2, 0x86FE, 0x9518, 0x1D54,
+        0xB2D4, 0x3A98, 0x297E, 0xA132
+    },
+    {
+        0x0000, 0xE028, 0x4B62, 0xAB4A, 0x96C4, 0x76EC, 0xDDA6, 0x3D8E, 0xA6BA, 0x4692, 0xEDD8, 0x0DF0,
+        0x307E, 0xD056, 0x7B1C, 0x9B34, 0xC646, 0x266E, 0x8D24, 0x6D0C, 0x5082, 0xB0AA, 0x1BE0, 0xFBC8,
+        0x60FC, 0x80D4, 0x2B9E, 0xCBB6, 0xF638, 0x1610, 0xBD5A, 0x5D72, 0x07BE, 0xE796, 0x4CDC, 0xACF4,
+        0x917A, 0x7152, 0xDA18, 0x3A30, 0xA104, 0x412C, 0xEA66, 0x0A4E, 0x37C0, 0xD7E8, 0x7CA2, 0x9C8A,
+        0xC1F8, 0x21D0, 0x8A9A, 0x6AB2, 0x573C, 0xB714, 0x1C5E, 0xFC76, 0x6742, 0x876A, 0x2C20, 0xCC08,
+        0xF186, 0x11AE, 0xBAE4, 0x5ACC, 0x0F7C, 0xEF54, 0x441E, 0xA436, 0x99B8, 0x7990, 0xD2DA, 0x32F2,
+        0xA9C6, 0x49EE, 0xE2A4, 0x028C, 0x3F02, 0xDF2A, 0x7460, 0x9448, 0xC93A, 0x2912, 0x8258, 0x6270,
+        0x5FFE, 0xBFD6, 0x149C, 0xF4B4, 0x6F80, 0x8FA8, 0x24E2, 0xC4CA, 0xF944, 0x196C, 0xB226, 0x520E,
+        0x08C2, 0xE8EA, 0x43A0, 0xA388, 0x9E06, 0x7E2E, 0xD564, 0x354C, 0xAE78, 0x4E50, 0xE51A, 0x0532,
+        0x38BC, 0xD894, 0x73DE, 0x93F6, 0xCE84, 0x2EAC, 0x85E6, 0x65CE, 0x5840, 0xB868, 0x1322, 0xF30A,
+        0x683E, 0x8816, 0x235C, 0xC374, 0xFEFA, 0x1ED2, 0xB598, 0x55B0, 0x1EF8, 0xFED0, 0x559A, 0xB5B2,
+        0x883C, 0x6814, 0xC35E, 0x2376, 0xB842, 0x586A, 0xF320, 0x1308, 0x2E86, 0xCEAE, 0x65E4, 0x85CC,
+        0xD8BE, 0x3896, 0x93DC, 0x73F4, 0x4E7A, 0xAE52, 0x0518, 0xE530, 0x7E04, 0x9E2C, 0x3566, 0xD54E,
+        0xE8C0, 0x08E8, 0xA3A2, 0x438A, 0x1946, 0xF96E, 0x5224, 0xB20C, 0x8F82, 0x6FAA, 0xC4E0, 0x24C8,
+        0xBFFC, 0x5FD4, 0xF49E, 0x14B6, 0x2938, 0xC910, 0x625A, 0x8272, 0xDF00, 0x3F28, 0x9462, 0x744A,
+        0x49C4, 0xA9EC, 0x02A6, 0xE28E, 0x79BA, 0x9992, 0x32D8, 0xD2F0, 0xEF7E, 0x0F56, 0xA41C, 0x4434,
+        0x1184, 0xF1AC, 0x5AE6, 0xBACE, 0x8740, 0x6768, 0xCC22, 0x2C0A, 0xB73E, 0x5716, 0xFC5C, 0x1C74,
+        0x21FA, 0xC1D2, 0x6A98, 0x8AB0, 0xD7C2, 0x37EA, 0x9CA0, 0x7C88, 0x4106, 0xA12E, 0x0A64, 0xEA4C,
+        0x7178, 0x9150, 0x3A1A, 0xDA32, 0xE7BC, 0x0794, 0xACDE, 0x4CF6, 0x163A, 0xF612, 0x5D58, 0xBD70,
+        0x80FE, 0x60D6, 0xCB9C, 0x2BB4, 0xB080, 0x50A8, 0xFBE2, 0x1BCA, 0x2644, 0xC66C, 0x6D26, 0x8D0E,
+        0xD07C, 0x3054, 0x9B1E, 0x7B36, 0x46B8, 0xA690, 0x0DDA, 0xEDF2, 0x76C6, 0x96EE, 0x3DA4, 0xDD8C,
+        0xE002, 0x002A, 0xAB60, 0x4B48
+    },
+    {
+        0x0000, 0x3DF0, 0x7BE0, 0x4610, 0xF7C0, 0xCA30, 0x8C20, 0xB1D0, 0x64B2, 0x5942, 0x1F52, 0x22A2,
+        0x9372, 0xAE82, 0xE892, 0xD562, 0xC964, 0xF494, 0xB284, 0x8F74, 0x3EA4, 0x0354, 0x4544, 0x78B4,
+        0xADD6, 0x9026, 0xD636, 0xEBC6, 0x5A16, 0x67E6, 0x21F6, 0x1C06, 0x19FA, 0x240A, 0x621A, 0x5FEA,
+        0xEE3A, 0xD3CA, 0x95DA, 0xA82A, 0x7D48, 0x40B8, 0x06A8, 0x3B58, 0x8A88, 0xB778, 0xF168, 0xCC98,
+        0xD09E, 0xED6E, 0xAB7E, 0x968E, 0x275E, 0x1AAE, 0x5CBE, 0x614E, 0xB42C, 0x89DC, 0xCFCC, 0xF23C,
+        0x43EC, 0x7E1C, 0x380C, 0x05FC, 0x33F4, 0x0E04, 0x4814, 0x75E4, 0xC434, 0xF9C4, 0xBFD4, 0x8224,
+        0x5746, 0x6AB6, 0x2CA6, 0x1156, 0xA086, 0x9D76, 0xDB66, 0xE696, 0xFA90, 0xC760, 0x8170, 0xBC80,
+        0x0D50, 0x30A0, 0x76B0, 0x4B40, 0x9E22, 0xA3D2, 0xE5C2, 0xD832, 0x69E2, 0x5412, 0x1202, 0x2FF2,
+        0x2A0E, 0x17FE, 0x51EE, 0x6C1E, 0xDDCE, 0xE03E, 0xA62E, 0x9BDE, 0x4EBC, 0x734C, 0x355C, 0x08AC,
+        0xB97C, 0x848C, 0xC29C, 0xFF6C, 0xE36A, 0xDE9A, 0x988A, 0xA57A, 0x14AA, 0x295A, 0x6F4A, 0x52BA,
+        0x87D8, 0xBA28, 0xFC38, 0xC1C8, 0x7018, 0x4DE8, 0x0BF8, 0x3608, 0x67E8, 0x5A18, 0x1C08, 0x21F8,
+        0x9028, 0xADD8, 0xEBC8, 0xD638, 0x035A, 0x3EAA, 0x78BA, 0x454A, 0xF49A, 0xC96A, 0x8F7A, 0xB28A,
+        0xAE8C, 0x937C, 0xD56C, 0xE89C, 0x594C, 0x64BC, 0x22AC, 0x1F5C, 0xCA3E, 0xF7CE, 0xB1DE, 0x8C2E,
+        0x3DFE, 0x000E, 0x461E, 0x7BEE, 0x7E12, 0x43E2, 0x05F2, 0x3802, 0x89D2, 0xB422, 0xF232, 0xCFC2,
+        0x1AA0, 0x2750, 0x6140, 0x5CB0, 0xED60, 0xD090, 0x9680, 0xAB70, 0xB776, 0x8A86, 0xCC96, 0xF166,
+        0x40B6, 0x7D46, 0x3B56, 0x06A6, 0xD3C4, 0xEE34, 0xA824, 0x95D4, 0x2404, 0x19F4, 0x5FE4, 0x6214,
+        0x541C, 0x69EC, 0x2FFC, 0x120C, 0xA3DC, 0x9E2C, 0xD83C, 0xE5CC, 0x30AE, 0x0D5E, 0x4B4E, 0x76BE,
+        0xC76E, 0xFA9E, 0xBC8E, 0x817E, 0x9D78, 0xA088, 0xE698, 0xDB68, 0x6AB8, 0x5748, 0x1158, 0x2CA8,
+        0xF9CA, 0xC43A, 0x822A, 0xBFDA, 0x0E0A, 0x33FA, 0x75EA, 0x481A, 0x4DE6, 0x7016, 0x3606, 0x0BF6,
+        0xBA26, 0x87D6, 0xC1C6, 0xFC36, 0x2954, 0x14A4, 0x52B4, 0x6F44, 0xDE94, 0xE364, 0xA574, 0x9884,
+        0x8482, 0xB972, 0xFF62, 0xC292, 0x7342, 0x4EB2, 0x08A2, 0x3552, 0xE030, 0xDDC0, 0x9BD0, 0xA620,
+        0x17F0, 0x2A00, 0x6C10, 0x51E0
+    }
+};
+
+// PEC10 on a left-aligned 16-bit register (poly 0x08F << 6), same layout.
+static const uint16_t pec10_slice[4][256] = {
+    {
+        0x0000, 0x23C0, 0x4780, 0x6440, 0x8F00, 0xACC0, 0xC880, 0xEB40, 0x3DC0, 0x1E00, 0x7A40, 0x5980,
+        0xB2C0, 0x9100, 0xF540, 0xD680, 0x7B80, 0x5840, 0x3C00, 0x1FC0, 0xF480, 0xD740, 0xB300, 0x90C0,
+        0x4640, 0x6580, 0x01C0, 0x2200, 0xC940, 0xEA80, 0x8EC0, 0xAD00, 0xF700, 0xD4C0, 0xB080, 0x9340,
+        0x7800, 0x5BC0, 0x3F80, 0x1C40, 0xCAC0, 0xE900, 0x8D40, 0xAE80, 0x45C0, 0x6600, 0x0240, 0x2180,
+        0x8C80, 0xAF40, 0xCB00, 0xE8C0, 0x0380, 0x2040, 0x4400, 0x67C0, 0xB140, 0x9280, 0xF6C0, 0xD500,
+        0x3E40, 0x1D80, 0x79C0, 0x5A00, 0xCDC0, 0xEE00, 0x8A40, 0xA980, 0x42C0, 0x6100, 0x0540, 0x2680,
+        0xF000, 0xD3C0, 0xB780, 0x9440, 0x7F00, 0x5CC0, 0x3880, 0x1B40, 0xB640, 0x9580, 0xF1C0, 0xD200,
+        0x3940, 0x1A80, 0x7EC0, 0x5D00, 0x8B80, 0xA840, 0xCC00, 0xEFC0, 0x0480, 0x2740, 0x4300, 0x60C0,
+        0x3AC0, 0x1900, 0x7D40, 0x5E80, 0xB5C0, 0x9600, 0xF240, 0xD180, 0x0700, 0x24C0, 0x4080, 0x6340,
+        0x8800, 0xABC0, 0xCF80, 0xEC40, 0x4140, 0x6280, 0x06C0, 0x2500, 0xCE40, 0xED80, 0x89C0, 0xAA00,
+        0x7C80, 0x5F40, 0x3B00, 0x18C0, 0xF380, 0xD040, 0xB400, 0x97C0, 0xB840, 0x9B80, 0xFFC0, 0xDC00,
+        0x3740, 0x1480, 0x70C0, 0x5300, 0x8580, 0xA640, 0xC200, 0xE1C0, 0x0A80, 0x2940, 0x4D00, 0x6EC0,
+        0xC3C0, 0xE000, 0x8440, 0xA780, 0x4CC0, 0x6F00, 0x0B40, 0x2880, 0xFE00, 0xDDC0, 0xB980, 0x9A40,
+        0x7100, 0x52C0, 0x3680, 0x1540, 0x4F40, 0x6C80, 0x08C0, 0x2B00, 0xC040, 0xE380, 0x87C0, 0xA400,
+        0x7280, 0x5140, 0x3500, 0x16C0, 0xFD80, 0xDE40, 0xBA00, 0x99C0, 0x34C0, 0x1700, 0x7340, 0x5080,
+        0xBBC0, 0x9800, 0xFC40, 0xDF80, 0x0900, 0x2AC0, 0x4E80, 0x6D40, 0x8600, 0xA5C0, 0xC180, 0xE240,
+        0x7580, 0x5640, 0x3200, 0x11C0, 0xFA80, 0xD940, 0xBD00, 0x9EC0, 0x4840, 0x6B80, 0x0FC0, 0x2C00,
+        0xC740, 0xE480, 0x80C0, 0xA300, 0x0E00, 0x2DC0, 0x4980, 0x6A40, 0x8100, 0xA2C0, 0xC680, 0xE540,
+        0x33C0, 0x1000, 0x7440, 0x5780, 0xBCC0, 0x9F00, 0xFB40, 0xD880, 0x8280, 0xA140, 0xC500, 0xE6C0,
+        0x0D80, 0x2E40, 0x4A00, 0x69C0, 0xBF40, 0x9C80, 0xF8C0, 0xDB00, 0x3040, 0x1380, 0x77C0, 0x5400,
+        0xF900, 0xDAC0, 0xBE80, 0x9D40, 0x7600, 0x55C0, 0x3180, 0x1240, 0xC4C0, 0xE700, 0x8340, 0xA080,
+        0x4BC0, 0x6800, 0x0C40, 0x2F80
+    },
+    {
+        0x0000, 0x5340, 0xA680, 0xF5C0, 0x6EC0, 0x3D80, 0xC840, 0x9B00, 0xDD80, 0x8EC0, 0x7B00, 0x2840,
+        0xB340, 0xE000, 0x15C0, 0x4680, 0x98C0, 0xCB80, 0x3E40, 0x6D00, 0xF600, 0xA540, 0x5080, 0x03C0,
+        0x4540, 0x1600, 0xE3C0, 0xB080, 0x2B80, 0x78C0, 0x8D00, 0xDE40, 0x1240, 0x4100, 0xB4C0, 0xE780,
+        0x7C80, 0x2FC0, 0xDA00, 0x8940, 0xCFC0, 0x9C80, 0x6940, 0x3A00, 0xA100, 0xF240, 0x0780, 0x54C0,
+        0x8A80, 0xD9C0, 0x2C00, 0x7F40, 0xE440, 0xB700, 0x42C0, 0x1180, 0x5700, 0x0440, 0xF180, 0xA2C0,
+        0x39C0, 0x6A80, 0x9F40, 0xCC00, 0x2480, 0x77C0, 0x8200, 0xD140, 0x4A40, 0x1900, 0xECC0, 0xBF80,
+        0xF900, 0xAA40, 0x5F80, 0x0CC0, 0x97C0, 0xC480, 0x3140, 0x6200, 0xBC40, 0xEF00, 0x1AC0, 0x4980,
+        0xD280, 0x81C0, 0x7400, 0x2740, 0x61C0, 0x3280, 0xC740, 0x9400, 0x0F00, 0x5C40, 0xA980, 0xFAC0,
+        0x36C0, 0x6580, 0x9040, 0xC300, 0x5800, 0x0B40, 0xFE80, 0xADC0, 0xEB40, 0xB800, 0x4DC0, 0x1E80,
+        0x8580, 0xD6C0, 0x2300, 0x7040, 0xAE00, 0xFD40, 0x0880, 0x5BC0, 0xC0C0, 0x9380, 0x6640, 0x3500,
+        0x7380, 0x20C0, 0xD500, 0x8640, 0x1D40, 0x4E00, 0xBBC0, 0xE880, 0x4900, 0x1A40, 0xEF80, 0xBCC0,
+        0x27C0, 0x7480, 0x8140, 0xD200, 0x9480, 0xC7C0, 0x3200, 0x6140, 0xFA40, 0xA900, 0x5CC0, 0x0F80,
+        0xD1C0, 0x8280, 0x7740, 0x2400, 0xBF00, 0xEC40, 0x1980, 0x4AC0, 0x0C40, 0x5F00, 0xAAC0, 0xF980,
+        0x6280, 0x31C0, 0xC400, 0x9740, 0x5B40, 0x0800, 0xFDC0, 0xAE80, 0x3580, 0x66C0, 0x9300, 0xC040,
+        0x86C0, 0xD580, 0x2040, 0x7300, 0xE800, 0xBB40, 0x4E80, 0x1DC0, 0xC380, 0x90C0, 0x6500, 0x3640,
+        0xAD40, 0xFE00, 0x0BC0, 0x5880, 0x1E00, 0x4D40, 0xB880, 0xEBC0, 0x70C0, 0x2380, 0xD640, 0x8500,
+        0x6D80, 0x3EC0, 0xCB00, 0x9840, 0x0340, 0x5000, 0xA5C0, 0xF680, 0xB000, 0xE340, 0x1680, 0x45C0,
+        0xDEC0, 0x8D80, 0x7840, 0x2B00, 0xF540, 0xA600, 0x53C0, 0x0080, 0x9B80, 0xC8C0, 0x3D00, 0x6E40,
+        0x28C0, 0x7B80, 0x8E40, 0xDD00, 0x4600, 0x1540, 0xE080, 0xB3C0, 0x7FC0, 0x2C80, 0xD940, 0x8A00,
+        0x1100, 0x4240, 0xB780, 0xE4C0, 0xA240, 0xF100, 0x04C0, 0x5780, 0xCC80, 0x9FC0, 0x6A00, 0x3940,
+        0xE700, 0xB440, 0x4180, 0x12C0, 0x89C0, 0xDA80, 0x2F40, 0x7C00, 0x3A80, 0x69C0, 0x9C00, 0xCF40,
+        0x5440, 0x0700, 0xF2C0, 0xA180
+    },
+    {
+        0x0000, 0x9200, 0x07C0, 0x95C0, 0x0F80, 0x9D80, 0x0840, 0x9A40, 0x1F00, 0x8D00, 0x18C0, 0x8AC0,
+        0x1080, 0x8280, 0x1740, 0x8540, 0x3E00, 0xAC00, 0x39C0, 0xABC0, 0x3180, 0xA380, 0x3640, 0xA440,
+        0x2100, 0xB300, 0x26C0, 0xB4C0, 0x2E80, 0xBC80, 0x2940, 0xBB40, 0x7C00, 0xEE00, 0x7BC0, 0xE9C0,
+        0x7380, 0xE180, 0x7440, 0xE640, 0x6300, 0xF100, 0x64C0, 0xF6C0, 0x6C80, 0xFE80, 0x6B40, 0xF940,
+        0x4200, 0xD000, 0x45C0, 0xD7C0, 0x4D80, 0xDF80, 0x4A40, 0xD840, 0x5D00, 0xCF00, 0x5AC0, 0xC8C0,
+        0x5280, 0xC080, 0x5540, 0xC740, 0xF800, 0x6A00, 0xFFC0, 0x6DC0, 0xF780, 0x6580, 0xF040, 0x6240,
+        0xE700, 0x7500, 0xE0C0, 0x72C0, 0xE880, 0x7A80, 0xEF40, 0x7D40, 0xC600, 0x5400, 0xC1C0, 0x53C0,
+        0xC980, 0x5B80, 0xCE40, 0x5C40, 0xD900, 0x4B00, 0xDEC0, 0x4CC0, 0xD680, 0x4480, 0xD140, 0x4340,
+        0x8400, 0x1600, 0x83C0, 0x11C0, 0x8B80, 0x1980, 0x8C40, 0x1E40, 0x9B00, 0x0900, 0x9CC0, 0x0EC0,
+        0x9480, 0x0680, 0x9340, 0x0140, 0xBA00, 0x2800, 0xBDC0, 0x2FC0, 0xB580, 0x2780, 0xB240, 0x2040,
+        0xA500, 0x3700, 0xA2C0, 0x30C0, 0xAA80, 0x3880, 0xAD40, 0x3F40, 0xD3C0, 0x41C0, 0xD400, 0x4600,
+        0xDC40, 0x4E40, 0xDB80, 0x4980, 0xCCC0, 0x5EC0, 0xCB00, 0x5900, 0xC340, 0x5140, 0xC480, 0x5680,
+        0xEDC0, 0x7FC0, 0xEA00, 0x7800, 0xE240, 0x7040, 0xE580, 0x7780, 0xF2C0, 0x60C0, 0xF500, 0x6700,
+        0xFD40, 0x6F40, 0xFA80, 0x6880, 0xAFC0, 0x3DC0, 0xA800, 0x3A00, 0xA040, 0x3240, 0xA780, 0x3580,
+        0xB0C0, 0x22C0, 0xB700, 0x2500, 0xBF40, 0x2D40, 0xB880, 0x2A80, 0x91C0, 0x03C0, 0x9600, 0x0400,
+        0x9E40, 0x0C40, 0x9980, 0x0B80, 0x8EC0, 0x1CC0, 0x8900, 0x1B00, 0x8140, 0x1340, 0x8680, 0x1480,
+        0x2BC0, 0xB9C0, 0x2C00, 0xBE00, 0x2440, 0xB640, 0x2380, 0xB180, 0x34C0, 0xA6C0, 0x3300, 0xA100,
+        0x3B40, 0xA940, 0x3C80, 0xAE80, 0x15C0, 0x87C0, 0x1200, 0x8000, 0x1A40, 0x8840, 0x1D80, 0x8F80,
+        0x0AC0, 0x98C0, 0x0D00, 0x9F00, 0x0540, 0x9740, 0x0280, 0x9080, 0x57C0, 0xC5C0, 0x5000, 0xC200,
+        0x5840, 0xCA40, 0x5F80, 0xCD80, 0x48C0, 0xDAC0, 0x4F00, 0xDD00, 0x4740, 0xD540, 0x4080, 0xD280,
+        0x69C0, 0xFBC0, 0x6E00, 0xFC00, 0x6640, 0xF440, 0x6180, 0xF380, 0x76C0, 0xE4C0, 0x7100, 0xE300,
+        0x7940, 0xEB40, 0x7E80, 0xEC80
+    },
+    {
+        0x0000, 0x8440, 0x2B40, 0xAF00, 0x5680, 0xD2C0, 0x7DC0, 0xF980, 0xAD00, 0x2940, 0x8640, 0x0200,
+        0xFB80, 0x7FC0, 0xD0C0, 0x5480, 0x79C0, 0xFD80, 0x5280, 0xD6C0, 0x2F40, 0xAB00, 0x0400, 0x8040,
+        0xD4C0, 0x5080, 0xFF80, 0x7BC0, 0x8240, 0x0600, 0xA900, 0x2D40, 0xF380, 0x77C0, 0xD8C0, 0x5C80,
+        0xA500, 0x2140, 0x8E40, 0x0A00, 0x5E80, 0xDAC0, 0x75C0, 0xF180, 0x0800, 0x8C40, 0x2340, 0xA700,
+        0x8A40, 0x0E00, 0xA100, 0x2540, 0xDCC0, 0x5880, 0xF780, 0x73C0, 0x2740, 0xA300, 0x0C00, 0x8840,
+        0x71C0, 0xF580, 0x5A80, 0xDEC0, 0xC4C0, 0x4080, 0xEF80, 0x6BC0, 0x9240, 0x1600, 0xB900, 0x3D40,
+        0x69C0, 0xED80, 0x4280, 0xC6C0, 0x3F40, 0xBB00, 0x1400, 0x9040, 0xBD00, 0x3940, 0x9640, 0x1200,
+        0xEB80, 0x6FC0, 0xC0C0, 0x4480, 0x1000, 0x9440, 0x3B40, 0xBF00, 0x4680, 0xC2C0, 0x6DC0, 0xE980,
+        0x3740, 0xB300, 0x1C00, 0x9840, 0x61C0, 0xE580, 0x4A80, 0xCEC0, 0x9A40, 0x1E00, 0xB100, 0x3540,
+        0xCCC0, 0x4880, 0xE780, 0x63C0, 0x4E80, 0xCAC0, 0x65C0, 0xE180, 0x1800, 0x9C40, 0x3340, 0xB700,
+        0xE380, 0x67C0, 0xC8C0, 0x4C80, 0xB500, 0x3140, 0x9E40, 0x1A00, 0xAA40, 0x2E00, 0x8100, 0x0540,
+        0xFCC0, 0x7880, 0xD780, 0x53C0, 0x0740, 0x8300, 0x2C00, 0xA840, 0x51C0, 0xD580, 0x7A80, 0xFEC0,
+        0xD380, 0x57C0, 0xF8C0, 0x7C80, 0x8500, 0x0140, 0xAE40, 0x2A00, 0x7E80, 0xFAC0, 0x55C0, 0xD180,
+        0x2800, 0xAC40, 0x0340, 0x8700, 0x59C0, 0xDD80, 0x7280, 0xF6C0, 0x0F40, 0x8B00, 0x2400, 0xA040,
+        0xF4C0, 0x7080, 0xDF80, 0x5BC0, 0xA240, 0x2600, 0x8900, 0x0D40, 0x2000, 0xA440, 0x0B40, 0x8F00,
+        0x7680, 0xF2C0, 0x5DC0, 0xD980, 0x8D00, 0x0940, 0xA640, 0x2200, 0xDB80, 0x5FC0, 0xF0C0, 0x7480,
+        0x6E80, 0xEAC0, 0x45C0, 0xC180, 0x3800, 0xBC40, 0x1340, 0x9700, 0xC380, 0x47C0, 0xE8C0, 0x6C80,
+        0x9500, 0x1140, 0xBE40, 0x3A00, 0x1740, 0x9300, 0x3C00, 0xB840, 0x41C0, 0xC580, 0x6A80, 0xEEC0,
+        0xBA40, 0x3E00, 0x9100, 0x1540, 0xECC0, 0x6880, 0xC780, 0x43C0, 0x9D00, 0x1940, 0xB640, 0x3200,
+        0xCB80, 0x4FC0, 0xE0C0, 0x6480, 0x3000, 0xB440, 0x1B40, 0x9F00, 0x6680, 0xE2C0, 0x4DC0, 0xC980,
+        0xE4C0, 0x6080, 0xCF80, 0x4BC0, 0xB240, 0x3600, 0x9900, 0x1D40, 0x49C0, 0xCD80, 0x6280, 0xE6C0,
+        0x1F40, 0x9B00, 0x3400, 0xB040
+    }
+};
+
+// PEC10 over the trailing 6-bit command-counter field.
+static const uint16_t pec10_tail[64] = {
+    0x0000, 0x23C0, 0x4780, 0x6440, 0x8F00, 0xACC0, 0xC880, 0xEB40, 0x3DC0, 0x1E00, 0x7A40, 0x5980,
+    0xB2C0, 0x9100, 0xF540, 0xD680, 0x7B80, 0x5840, 0x3C00, 0x1FC0, 0xF480, 0xD740, 0xB300, 0x90C0,
+    0x4640, 0x6580, 0x01C0, 0x2200, 0xC940, 0xEA80, 0x8EC0, 0xAD00, 0xF700, 0xD4C0, 0xB080, 0x9340,
+    0x7800, 0x5BC0, 0x3F80, 0x1C40, 0xCAC0, 0xE900, 0x8D40, 0xAE80, 0x45C0, 0x6600, 0x0240, 0x2180,
+    0x8C80, 0xAF40, 0xCB00, 0xE8C0, 0x0380, 0x2040, 0x4400, 0x67C0, 0xB140, 0x9280, 0xF6C0, 0xD500,
+    0x3E40, 0x1D80, 0x79C0, 0x5A00};
+
+// ********************************** Error Correction ***************************
+
+// One slice-by-4 CRC over a 16-bit left-aligned register.
+static inline uint16_t pec_slice4(const uint16_t table[4][256], uint16_t crc, const uint8_t *data, uint8_t len)
+{
+  while (len >= 4u)
+  {
+    uint16_t x = (uint16_t)(crc ^ (((uint16_t)data[0] << 8) | data[1]));
+    crc = (uint16_t)(table[3][x >> 8] ^ table[2][x & 0xFFu] ^ table[1][data[2]] ^ table[0][data[3]]);
+    data += 4;
+    len -= 4u;
+  }
+  if (len >= 2u)
+  {
+    uint16_t x = (uint16_t)(crc ^ (((uint16_t)data[0] << 8) | data[1]));
+    crc = (uint16_t)(table[1][x >> 8] ^ table[0][x & 0xFFu]);
+    data += 2;
+    len -= 2u;
+  }
+  if (len != 0u)
+  {
+    crc = (uint16_t)((crc << 8) ^ table[0][(crc >> 8) ^ data[0]]);
+  }
+  return crc;
+}
+
+/* Calculates and returns the CRC15 */
+uint16_t pec15_calc(uint8_t len, uint8_t *data)
+{
+  // Seed 16, left-aligned; the result already carries the 0 LSB the chip expects.
+  return pec_slice4(pec15_slice, (uint16_t)(16u << 1), data, len);
+}
+
+/* Calculates and returns the CRC10 */
+uint16_t Pec10_calc(bool bIsRxCmd, uint8_t nLength, uint8_t *pDataBuf)
+{
+  uint16_t crc = pec_slice4(pec10_slice, (uint16_t)(16u << 6), pDataBuf, nLength);
+
+  // The 6-bit register-group field always takes part: the command counter on
+  // RX, zero on TX (see the reference implementation below).
+  if (bIsRxCmd == true)
+  {
+    crc ^= (uint16_t)(((uint16_t)pDataBuf[nLength] & 0xFCu) << 8);
+  }
+  crc = (uint16_t)((crc << 6) ^ pec10_tail[crc >> 10]);
+  return (uint16_t)((crc >> 6) & 0x3FFu);
+}
+
+#else /* ADBMS_PEC_ENGINE_REFERENCE */
+
+// ********************************** CRC Tables *********************************
+
+static const uint16_t crc15Table[256] = {
+    0x0,    0xc599, 0xceab, 0xb32,  0xd8cf, 0x1d56, 0x1664, 0xd3fd, 0xf407, 0x319e, 0x3aac, // precomputed CRC15 Table
+    0xff35, 0x2cc8, 0xe951, 0xe263, 0x27fa, 0xad97, 0x680e, 0x633c, 0xa6a5, 0x7558, 0xb0c1, 0xbbf3, 0x7e6a, 0x5990,
+    0x9c09, 0x973b, 0x52a2, 0x815f, 0x44c6, 0x4ff4, 0x8a6d, 0x5b2e, 0x9eb7, 0x9585, 0x501c, 0x83e1, 0x4678, 0x4d4a,
+    0x88d3, 0xaf29, 0x6ab0, 0x6182, 0xa41b, 0x77e6, 0xb27f, 0xb94d, 0x7cd4, 0xf6b9, 0x3320, 0x3812, 0xfd8b, 0x2e76,
+    0xebef, 0xe0dd, 0x2544, 0x2be,  0xc727, 0xcc15, 0x98c,  0xda71, 0x1fe8, 0x14da, 0xd143, 0xf3c5, 0x365c, 0x3d6e,
+    0xf8f7, 0x2b0a, 0xee93, 0xe5a1, 0x2038, 0x7c2,  0xc25b, 0xc969, 0xcf0,  0xdf0d, 0x1a94, 0x11a6, 0xd43f, 0x5e52,
+    0x9bcb, 0x90f9, 0x5560, 0x869d, 0x4304, 0x4836, 0x8daf, 0xaa55, 0x6fcc, 0x64fe, 0xa167, 0x729a, 0xb703, 0xbc31,
+    0x79a8, 0xa8eb, 0x6d72, 0x6640, 0xa3d9, 0x7024, 0xb5bd, 0xbe8f, 0x7b16, 0x5cec, 0x9975, 0x9247, 0x57de, 0x8423,
+    0x41ba, 0x4a88, 0x8f11, 0x57c,  0xc0e5, 0xcbd7, 0xe4e,  0xddb3, 0x182a, 0x1318, 0xd681, 0xf17b, 0x34e2, 0x3fd0,
+    0xfa49, 0x29b4, 0xec2d, 0xe71f, 0x2286, 0xa213, 0x678a, 0x6cb8, 0xa921, 0x7adc, 0xbf45, 0xb477, 0x71ee, 0x5614,
+    0x938d, 0x98bf, 0x5d26, 0x8edb, 0x4b42, 0x4070, 0x85e9, 0xf84,  0xca1d, 0xc12f, 0x4b6,  0xd74b, 0x12d2, 0x19e0,
+    0xdc79, 0xfb83, 0x3e1a, 0x3528, 0xf0b1, 0x234c, 0xe6d5, 0xede7, 0x287e, 0xf93d, 0x3ca4, 0x3796, 0xf20f, 0x21f2,
+    0xe46b, 0xef59, 0x2ac0, 0xd3a,  0xc8a3, 0xc391, 0x608,  0xd5f5, 0x106c, 0x1b5e, 0xdec7, 0x54aa, 0x9133, 0x9a01,
+    0x5f98, 0x8c65, 0x49fc, 0x42ce, 0x8757, 0xa0ad, 0x6534, 0x6e06, 0xab9f, 0x7862, 0xbdfb, 0xb6c9, 0x7350, 0x51d6,
+    0x944f, 0x9f7d, 0x5ae4, 0x8919, 0x4c80, 0x47b2, 0x822b, 0xa5d1, 0x6048, 0x6b7a, 0xaee3, 0x7d1e, 0xb887, 0xb3b5,
+    0x762c, 0xfc41, 0x39d8, 0x32ea, 0xf773, 0x248e, 0xe117, 0xea25, 0x2fbc, 0x846,  0xcddf, 0xc6ed, 0x374,  0xd089,
+    0x1510, 0x1e22, 0xdbbb, 0xaf8,  0xcf61, 0xc453, 0x1ca,  0xd237, 0x17ae, 0x1c9c, 0xd905, 0xfeff, 0x3b66, 0x3054,
+    0xf5cd, 0x2630, 0xe3a9, 0xe89b, 0x2d02, 0xa76f, 0x62f6, 0x69c4, 0xac5d, 0x7fa0, 0xba39, 0xb10b, 0x7492, 0x5368,
+    0x96f1, 0x9dc3, 0x585a, 0x8ba7, 0x4e3e, 0x450c, 0x8095};
+
+// ********************************** Error Correction ***************************
+
+/* Calculates and returns the CRC15 */
+uint16_t pec15_calc(uint8_t len,  // Number of bytes that will be used to calculate a PEC
+                    uint8_t *data // Array of data that will be used to calculate a PEC
+)
+{
+  uint16_t remainder, addr;
+  remainder = 16; // initialize the PEC
+
+  for (uint8_t i = 0; i < len; i++)
+  {                                             // loops for each byte in data array
+    addr = ((remainder >> 7) ^ data[i]) & 0xff; // calculate PEC table address
+    remainder = (remainder << 8) ^ crc15Table[addr];
+  }
+
+  return (remainder * 2); // The CRC15 has a 0 in the LSB so the remainder must be multiplied by 2
+}
+
+/* Calculates and returns the CRC10 */
+uint16_t Pec10_calc(bool bIsRxCmd, uint8_t nLength, uint8_t *pDataBuf)
+{
+  uint16_t nRemainder = 16u; /* PEC_SEED */
+  /* x10 + x7 + x3 + x2 + x + 1 <- the CRC10 polynomial 100 1000 1111 */
+  uint16_t nPolynomial = 0x8Fu;
+  uint8_t nByteIndex, nBitIndex;
+
+  for (nByteIndex = 0u; nByteIndex < nLength; ++nByteIndex)
+  {
+    /* Bring the next byte into the remainder. */
+    nRemainder ^= (uint16_t)((uint16_t)pDataBuf[nByteIndex] << 2u);
+
+    /* Perform modulo-2 division, a bit at a time. */
+    for (nBitIndex = 8u; nBitIndex > 0u; --nBitIndex)
+    {
+      /* Try to divide the current data bit. */
+      if ((nRemainder & 0x200u) > 0u)
+      {
+        nRemainder = (uint16_t)((nRemainder << 1u));
+        nRemainder = (uint16_t)(nRemainder ^ nPolynomial);
+      }
+      else
+      {
+        nRemainder = (uint16_t)(nRemainder << 1u);
+      }
+    }
+  }
+
+  /* On RX, fold the 6-bit command counter into the remainder before the
+   * trailing division below. On TX there is no command counter, so nothing
+   * is XOR'd here. */
+  if (bIsRxCmd == true)
+  {
+    nRemainder ^= (uint16_t)(((uint16_t)pDataBuf[nLength] & (uint8_t)0xFC) << 2u);
+  }
+
+  /* The 6-bit register-group field is always part of PEC10: it carries the
+   * command counter on RX (XOR'd above) and is implicitly zero on TX. Either
+   * way these 6 modulo-2 division steps MUST run unconditionally, or the TX
+   * write PEC will not match what the chip computes and every WRxxx command
+   * (WRCFGA/WRCFGB/WRPWM/...) is silently rejected. */
+  for (nBitIndex = 6u; nBitIndex > 0u; --nBitIndex)
+  {
+    if ((nRemainder & 0x200u) > 0u)
+    {
+      nRemainder = (uint16_t)((nRemainder << 1u));
+      nRemainder = (uint16_t)(nRemainder ^ nPolynomial);
+    }
+    else
+    {
+      nRemainder = (uint16_t)((nRemainder << 1u));
+    }
+  }
+  return ((uint16_t)(nRemainder & 0x3FFu));
+}
+
+#endif /* ADBMS_PEC_ENGINE */
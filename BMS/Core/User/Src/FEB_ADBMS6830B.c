@@ -1,12 +1,16 @@
 // ********************************** Includes & Externs *************************
 
 #include "FEB_ADBMS6830B.h"
+#include "FEB_Cell_History.h"
+#include "FEB_Cell_Voltage.h"
+#include "FEB_SOC.h"
+#include "FEB_Temp_Median.h"
 #include "FEB_SM.h"
 #include "FEB_HW.h"
 #include "FEB_Const.h"
 #include "FEB_Config.h"
 #include "FEB_Commands.h"
-// #include "FEB_CAN_IVT.h"
+#include "FEB_CAN_IVT.h"
 #include "FEB_CMDCODES.h"
 #include "FEB_Thermistor.h"
 #include "FEB_AD68xx_Interface.h"
@@ -16,9 +20,11 @@
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include "stm32f4xx_hal.h"
 #include "cmsis_os.h"
 #include "feb_log.h"
+#include "feb_time.h"
 
 /* External mutex from freertos.c */
 extern osMutexId_t ADBMSMutexHandle;
@@ -60,11 +66,36 @@ static uint32_t temp_telemetry_loss_tick = 0;
  * each process pass (writer holds ADBMSMutexHandle); read without the mutex
  * (aligned 32-bit float reads are atomic on Cortex-M4). The mutex-taking
  * FEB_ADBMS_GET_ACC_* getters MUST NOT be called from the SM task hot path:
- * a temperature scan holds the mutex for tens of ms and would stall it. */
+ * a voltage scan holds the mutex for several ms and would stall it. */
 static volatile float adbms_snap_total_V = 0.0f;
 static volatile float adbms_snap_max_cell_V = 0.0f;
 static volatile float adbms_snap_max_temp_C = NAN;
 
+/* Aux registers latched right after RDAUX so the channel can be decoded while
+ * the next channel's ADAX conversion overwrites IC_Config[].aux on the chip
+ * side and the next RDAUX overwrites it here. */
+static ax temp_latched_aux[FEB_NUM_IC];
+
+/* Temperature scan phase timing; written and read under ADBMSMutexHandle. */
+static FEB_ADBMS_Temp_Scan_Stats_t temp_scan_stats = {0};
+
+/* Set from a channel's SELECT (WRCFGA + ADAX) until its RDAUX. The sweep drops
+ * ADBMSMutexHandle in between, so holding the mutex alone does not make a
+ * config write safe: one landing here would move the MUX under the conversion.
+ * Written and read under ADBMSMutexHandle; see adbms_acquire_idle(). */
+static bool temp_mux_busy = false;
+
+/* FEB_Stop_Balance() could not take the chain (the SM task never blocks on it);
+ * the ADBMS task writes DCC=0 at its next idle point (service_balance_stop). */
+static volatile bool balance_stop_pending = false;
+
+/* SOC / R_pack estimator, stepped under ADBMSMutexHandle. soc_published is
+ * its lock-free copy for the SM task (CAN broadcast), like adbms_snap_*. */
+static FEB_SOC_t soc_est;
+static uint32_t soc_last_tick = 0; /* 0 = no step yet */
+static uint32_t soc_step_max_us = 0;
+static volatile FEB_ADBMS_SOC_t soc_published = {0};
+
 // ********************************** Config Bits ********************************
 
 static bool refon = 1;
@@ -74,7 +105,26 @@ static bool dcto_bits[6] = {1, 1, 1, 1, 1, 1};
 static uint16_t uv = 0x0010;
 static uint16_t ov = 0x3FF0;
 
-static float FEB_MIN_SLIPPAGE_V = 0.03;
+static const int32_t FEB_MIN_SLIPPAGE_uV = 30000;
+
+static void service_balance_stop(void);
+
+/* Take ADBMSMutexHandle at a point where no MUX channel is converting, for
+ * callers outside the ADBMS task that rewrite the configuration. Waits out the
+ * sweep in progress (FEB_TEMP_MUX_CHANNELS x FEB_TEMP_AUX_CONV_MS at most). */
+static void adbms_acquire_idle(void)
+{
+  for (;;)
+  {
+    osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+    if (!temp_mux_busy)
+    {
+      return;
+    }
+    osMutexRelease(ADBMSMutexHandle);
+    osDelay(1);
+  }
+}
 
 // ********************************** Helper Functions ***************************
 
@@ -83,6 +133,11 @@ static inline float convert_voltage(int16_t raw_code)
   return raw_code * ADBMS_ADC_LSB_V + ADBMS_ADC_OFFSET_V;
 }
 
+static inline float uV_to_V(int32_t uV)
+{
+  return (float)uV * 1e-6f;
+}
+
 // ********************************** Static Functions ***************************
 
 // ********************************** Voltage ************************************
@@ -174,125 +229,43 @@ static void read_cell_voltages()
   check_and_report_pec_errors();
 }
 
-static void store_cell_voltages()
+// Latch hook for FEB_Cell_Voltage_Process(): runs once per cell, on the scan
+// its violation counter reaches FEB_VOLTAGE_ERROR_THRESH.
+static void on_cell_voltage_latch(uint8_t bank, uint8_t cell, int32_t uV_C, int32_t uV_S)
 {
-  DEBUG_VOLTAGE_PRINT("Storing cell voltages for %d banks", FEB_NBANKS);
-  FEB_ACC.total_voltage_V = 0;
-
-  float min_cell_V = FLT_MAX;
-  float max_cell_V = -FLT_MAX;
-
-  for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
-  {
-    FEB_ACC.banks[bank].badReadV = 0; // Reset PEC error counter for this bank
-
-    for (uint8_t ic = 0; ic < FEB_NUM_ICPBANK; ic++)
-    {
-      uint8_t ic_idx = ic + bank * FEB_NUM_ICPBANK;
-
-      for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_IC; cell++)
-      {
-        // Check PEC error for this cell's register group (3 cells per register)
-        uint8_t reg_idx = cell / 3;
-        if (IC_Config[ic_idx].cells.pec_match[reg_idx] != 0)
-        {
-          // PEC error detected - skip this cell and count as bad read
-          FEB_ACC.banks[bank].badReadV++;
-          DEBUG_VOLTAGE_PRINT("PEC error: Bank %d IC %d Cell %d Reg %d", bank, ic, cell, reg_idx);
-          continue;
-        }
-
-        float CVoltage = convert_voltage(IC_Config[ic_idx].cells.c_codes[cell]);
-        float SVoltage = convert_voltage(IC_Config[ic_idx].cells.s_codes[cell]);
-
-        FEB_ACC.banks[bank].cells[cell + ic * FEB_NUM_CELLS_PER_IC].voltage_V = CVoltage;
-        FEB_ACC.banks[bank].cells[cell + ic * FEB_NUM_CELLS_PER_IC].voltage_S = SVoltage;
-        FEB_ACC.total_voltage_V += CVoltage;
-
-        if (CVoltage >= 0.0f)
-        {
-          if (CVoltage < min_cell_V)
-            min_cell_V = CVoltage;
-          if (CVoltage > max_cell_V)
-            max_cell_V = CVoltage;
-        }
-      }
-    }
-    DEBUG_VOLTAGE_PRINT("Bank %d: badReadV=%d", bank, FEB_ACC.banks[bank].badReadV);
-  }
-  FEB_ACC.pack_min_voltage_V = min_cell_V;
-  FEB_ACC.pack_max_voltage_V = max_cell_V;
-  DEBUG_VOLTAGE_PRINT("Voltage storage complete: Total=%.3fV Min=%.3fV Max=%.3fV", FEB_ACC.total_voltage_V, min_cell_V,
-                      max_cell_V);
+  const int32_t vMax_uV = (int32_t)FEB_Config_Get_Cell_Max_Voltage_mV() * 1000;
+  const int32_t vMin_uV = (int32_t)FEB_Config_Get_Cell_Min_Voltage_mV() * 1000;
+#if FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
+  /* Bench mode: report the violation but do not latch the fault. */
+  printf("[ADBMS] WARNING: voltage violation IGNORED (FEB_BMS_DISABLE_*_VOLT_CHECKS) - "
+         "Bank %d Cell %d: C=%.3fV S=%.3fV (limits: %.3f-%.3fV)\r\n",
+         bank, cell, uV_to_V(uV_C), uV_to_V(uV_S), uV_to_V(vMin_uV), uV_to_V(vMax_uV));
+#else
+  (void)uV_S;
+  printf("[ADBMS] FAULT: Cell voltage out of range - Bank %d Cell %d: %.3fV (limits: %.3f-%.3fV)\r\n", bank, cell,
+         uV_to_V(uV_C), uV_to_V(vMin_uV), uV_to_V(vMax_uV));
+  FEB_ADBMS_Update_Error_Type(ERROR_TYPE_VOLTAGE_VIOLATION);
+  /* Latch for the SM task; evaluate_faults() in FEB_SM.c routes this
+   * to FAULT_BMS (drive group) or FAULT_CHARGING (charger group). */
+  adbms_fault_flags |= ADBMS_FAULT_FLAG_VOLTAGE;
+#endif
 }
 
-static void validate_voltages()
+// Single pass over the freshly read registers (FEB_Cell_Voltage.c): latch good
+// codes into the pack-order arrays, build the pack aggregates in µV and run
+// the limit check. Everything stays integer; the getters convert to volts at
+// the edge.
+static void process_cell_voltages()
 {
-  DEBUG_VOLTAGE_PRINT("Validating voltages");
-  uint16_t vMax = FEB_Config_Get_Cell_Max_Voltage_mV();
-  uint16_t vMin = FEB_Config_Get_Cell_Min_Voltage_mV();
-  DEBUG_VOLTAGE_PRINT("Voltage limits: Min=%.3fV Max=%.3fV", vMin / 1000.0f, vMax / 1000.0f);
+  DEBUG_VOLTAGE_PRINT("Processing cell voltages for %d banks", FEB_NBANKS);
+  const int32_t vMax_uV = (int32_t)FEB_Config_Get_Cell_Max_Voltage_mV() * 1000;
+  const int32_t vMin_uV = (int32_t)FEB_Config_Get_Cell_Min_Voltage_mV() * 1000;
 
-  for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
-  {
-    // Note: badReadV is now set in store_cell_voltages() via PEC checking
-    for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_BANK; cell++)
-    {
-      float voltageC = FEB_ACC.banks[bank].cells[cell].voltage_V * 1000;
-      float voltageS = FEB_ACC.banks[bank].cells[cell].voltage_S * 1000;
-
-      /* Per-ADC bench overrides (FEB_BMS_DISABLE_*_VOLT_CHECKS in FEB_Const.h):
-       * the normal rule is "primary (C) triggers, secondary (S) confirms" —
-       * both must be out of range. A disabled side is removed from the
-       * judgment; with both disabled the normal rule still counts violations
-       * but only warns instead of latching the fault. */
-      const bool primary_bad = (voltageC > vMax || voltageC < vMin);
-      const bool secondary_bad = (voltageS > vMax || voltageS < vMin);
-#if FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && !FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
-      const bool violation = secondary_bad;
-      (void)primary_bad;
-#elif !FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
-      const bool violation = primary_bad;
-      (void)secondary_bad;
-#else
-      const bool violation = primary_bad && secondary_bad;
-#endif
+  FEB_Cell_Voltage_Process(&FEB_ACC, IC_Config, vMin_uV, vMax_uV, on_cell_voltage_latch);
 
-      if (violation)
-      {
-        DEBUG_VOLTAGE_PRINT("Voltage violation detected: Bank %d Cell %d C=%.3fV S=%.3fV", bank, cell,
-                            voltageC / 1000.0f, voltageS / 1000.0f);
-        /* Saturating increment (counter is uint8_t — a free-running += would
-         * wrap at 255); actions fire exactly once, on the crossing scan. */
-        if (FEB_ACC.banks[bank].cells[cell].violations < FEB_VOLTAGE_ERROR_THRESH)
-        {
-          FEB_ACC.banks[bank].cells[cell].violations += 1;
-          if (FEB_ACC.banks[bank].cells[cell].violations >= FEB_VOLTAGE_ERROR_THRESH)
-          {
-#if FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
-            /* Bench mode: report the violation but do not latch the fault.
-             * Fires once per cell thanks to the saturating counter above. */
-            printf("[ADBMS] WARNING: voltage violation IGNORED (FEB_BMS_DISABLE_*_VOLT_CHECKS) - "
-                   "Bank %d Cell %d: C=%.3fV S=%.3fV (limits: %.3f-%.3fV)\r\n",
-                   bank, cell, voltageC / 1000.0f, voltageS / 1000.0f, vMin / 1000.0f, vMax / 1000.0f);
-#else
-            printf("[ADBMS] FAULT: Cell voltage out of range - Bank %d Cell %d: %.3fV (limits: %.3f-%.3fV)\r\n", bank,
-                   cell, voltageC / 1000.0f, vMin / 1000.0f, vMax / 1000.0f);
-            FEB_ADBMS_Update_Error_Type(ERROR_TYPE_VOLTAGE_VIOLATION);
-            /* Latch for the SM task; evaluate_faults() in FEB_SM.c routes this
-             * to FAULT_BMS (drive group) or FAULT_CHARGING (charger group). */
-            adbms_fault_flags |= ADBMS_FAULT_FLAG_VOLTAGE;
-#endif
-          }
-        }
-      }
-      else
-      {
-        FEB_ACC.banks[bank].cells[cell].violations = 0;
-      }
-    }
-  }
-  DEBUG_VOLTAGE_PRINT("Voltage validation complete");
+  DEBUG_VOLTAGE_PRINT("Voltage processing complete: Total=%.3fV Min=%.3fV (cell %d) Max=%.3fV (cell %d) violating=%d",
+                      uV_to_V(FEB_ACC.total_voltage_uV), uV_to_V(FEB_ACC.pack_min_voltage_uV), FEB_ACC.pack_min_cell,
+                      uV_to_V(FEB_ACC.pack_max_voltage_uV), FEB_ACC.pack_max_cell, FEB_ACC.cells_violating);
 }
 
 // ********************************** Temperature ********************************
@@ -324,12 +297,11 @@ static void configure_gpio_bits(uint8_t channel)
 static void start_aux_voltage_measurements()
 {
   DEBUG_TEMP_PRINT("Starting aux voltage measurements (all GPIOs)");
-  /* Note: Using osDelay instead of ADBMS6830B_pollAdc() - see comment in
-   * start_adc_cell_voltage_measurements() for rationale */
-  /* CH=0 converts all GPIO channels; we need GPIO1-6 for the 6 MUX outputs. */
+  /* CH=0 converts all GPIO channels; we need GPIO1-6 for the 6 MUX outputs.
+   * No wait here: the caller sleeps FEB_TEMP_AUX_CONV_MS with the mutex
+   * released (osDelayUntil rather than ADBMS6830B_pollAdc() - see comment in
+   * start_adc_cell_voltage_measurements() for rationale). */
   ADBMS6830B_adax(AUX_OW_OFF, PUP_DOWN, 0);
-  osDelay(pdMS_TO_TICKS(5));
-  DEBUG_TEMP_PRINT("Aux all-channel measurement complete");
 }
 
 static void read_aux_voltages()
@@ -340,6 +312,12 @@ static void read_aux_voltages()
 
   // Check and report PEC errors for redundancy failover
   check_and_report_pec_errors();
+
+  // Latch for store_cell_temps(); decode runs after the next channel is started
+  for (uint8_t icn = 0; icn < FEB_NUM_IC; icn++)
+  {
+    temp_latched_aux[icn] = IC_Config[icn].aux;
+  }
 }
 
 // True for thermistor inputs physically unconnected on the SN5 BMS harness;
@@ -374,33 +352,32 @@ static void store_cell_temps(uint8_t channel)
         if (feb_temp_sensor_ignored(mux, channel))
         {
           FEB_ACC.banks[bank].temp_sensor_readings_V[sensor_idx] = NAN;
-          FEB_ACC.banks[bank].therm_raw_voltages_mV[sensor_idx] = NAN;
           FEB_ACC.banks[bank].therm_raw_codes[sensor_idx] = 0xFFFF;
           DEBUG_TEMP_PRINT("Ignored (unconnected): Bank %d IC %d MUX%d ch%d -> idx=%d (NaN)", bank, icn, mux + 1,
                            channel, sensor_idx);
           continue;
         }
 
-        if (IC_Config[ic_idx].aux.pec_match[reg_idx] != 0)
+        if (temp_latched_aux[ic_idx].pec_match[reg_idx] != 0)
         {
           FEB_ACC.banks[bank].temp_sensor_readings_V[sensor_idx] = NAN;
-          FEB_ACC.banks[bank].therm_raw_voltages_mV[sensor_idx] = NAN;
           FEB_ACC.banks[bank].therm_raw_codes[sensor_idx] = 0xFFFF;
           DEBUG_TEMP_PRINT("PEC error: Bank %d IC %d MUX%d ch%d reg%d -> idx=%d (NaN)", bank, icn, mux + 1, channel,
                            reg_idx, sensor_idx);
           continue;
         }
 
-        uint16_t code = IC_Config[ic_idx].aux.a_codes[a_idx];
-        float V_mV = convert_voltage(code) * 1000.0f;
-        float T_C = FEB_Thermistor_Voltage_To_Temp_C(V_mV);
+        // The table takes the raw code directly; the mV view is derived from
+        // therm_raw_codes only when someone asks (FEB_ADBMS_GET_Therm_Raw_mV).
+        uint16_t code = temp_latched_aux[ic_idx].a_codes[a_idx];
+        int16_t T_dC = FEB_Thermistor_Code_To_Temp_dC((int16_t)code);
+        float T_C = (T_dC == THERM_TEMP_INVALID_DC) ? NAN : (float)T_dC * 0.1f;
 
         FEB_ACC.banks[bank].temp_sensor_readings_V[sensor_idx] = T_C;
         FEB_ACC.banks[bank].therm_raw_codes[sensor_idx] = code;
-        FEB_ACC.banks[bank].therm_raw_voltages_mV[sensor_idx] = V_mV;
 
-        DEBUG_TEMP_PRINT("Bank %d IC %d MUX%d ch%d: code=0x%04X V=%.1fmV T=%.1fC -> idx=%d", bank, icn, mux + 1,
-                         channel, code, V_mV, T_C, sensor_idx);
+        DEBUG_TEMP_PRINT("Bank %d IC %d MUX%d ch%d: code=0x%04X T=%.1fC -> idx=%d", bank, icn, mux + 1, channel,
+                         code, T_C, sensor_idx);
       }
     }
   }
@@ -453,26 +430,6 @@ static void compute_pack_temp_stats(void)
   }
 }
 
-/* Median of n readings (dC), sorted in place via insertion sort (n is bounded by
- * FEB_NUM_TEMP_SENSORS). Used as a robust per-bank plausibility reference: a
- * minority of bad-connection spikes cannot shift it, so genuine cell readings
- * still define the median while outliers stand out. Caller guarantees n >= 1. */
-static float temp_median_dC(float *a, int n)
-{
-  for (int i = 1; i < n; i++)
-  {
-    float key = a[i];
-    int j = i - 1;
-    while (j >= 0 && a[j] > key)
-    {
-      a[j + 1] = a[j];
-      j--;
-    }
-    a[j + 1] = key;
-  }
-  return (n & 1) ? a[n / 2] : 0.5f * (a[n / 2 - 1] + a[n / 2]);
-}
-
 static void validate_temps()
 {
   DEBUG_TEMP_PRINT("Validating temperatures");
@@ -498,7 +455,7 @@ static void validate_temps()
         vals_dC[n_valid++] = temp;
     }
     bool have_median = (n_valid >= FEB_TEMP_MIN_SENSORS_FOR_MEDIAN);
-    float median_dC = have_median ? temp_median_dC(vals_dC, n_valid) : 0.0f;
+    float median_dC = have_median ? FEB_Temp_Median_dC(vals_dC, n_valid) : 0.0f;
 
     // Pass 2: classify each sensor.
     for (uint16_t sensor = 0; sensor < FEB_NUM_TEMP_SENSORS; sensor++)
@@ -616,6 +573,85 @@ static void validate_temps()
   DEBUG_TEMP_PRINT("Temperature validation complete");
 }
 
+// Wake the SM task if this scan latched a fault bit that was clear before it,
+// so the relay opens now rather than on the SM's next 1 ms poll.
+static void notify_new_faults(uint32_t flags_before, uint64_t sample_us)
+{
+  if ((adbms_fault_flags & ~flags_before) != 0)
+  {
+    FEB_SM_Notify_Event(FEB_SM_EVENT_ADBMS, sample_us);
+  }
+}
+
+// ********************************** History ************************************
+
+// Append this scan to the history ring straight from FEB_ACC, then freeze the
+// ring on the first scan that sees a fault so the lead-up is kept. Caller holds
+// ADBMSMutexHandle.
+static void record_history(FEB_Hist_Kind_t kind)
+{
+  const uint8_t flags = (uint8_t)adbms_fault_flags;
+  if (FEB_Cell_History_Begin(kind, HAL_GetTick(), flags))
+  {
+    if (kind == FEB_HIST_KIND_VOLTAGE)
+    {
+      for (uint16_t idx = 0; idx < FEB_NUM_CELLS; idx++)
+      {
+        FEB_Cell_History_Push((uint16_t)FEB_ACC.cell_c_codes[idx]);
+      }
+    }
+    else
+    {
+      for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
+      {
+        for (uint16_t sensor = 0; sensor < FEB_NUM_TEMP_SENSORS; sensor++)
+        {
+          FEB_Cell_History_Push(FEB_ACC.banks[bank].therm_raw_codes[sensor]);
+        }
+      }
+    }
+    FEB_Cell_History_End();
+  }
+
+  BMS_State_t state = FEB_SM_Get_Current_State();
+  if (flags != 0 || (state >= BMS_STATE_FAULT_BMS && state <= BMS_STATE_FAULT_CHARGING))
+  {
+    FEB_Cell_History_Freeze(HAL_GetTick(), flags);
+  }
+}
+
+// ********************************** SOC ****************************************
+
+/* IVT current older than this is not paired with the scan */
+#define SOC_IVT_FRESH_MS 100
+
+static void update_soc(void)
+{
+  uint32_t now = HAL_GetTick();
+  float dt_s = (soc_last_tick == 0) ? 0.0f : (float)(now - soc_last_tick) * 0.001f;
+  soc_last_tick = now;
+
+  bool ivt_fresh = FEB_CAN_IVT_IsDataFresh(SOC_IVT_FRESH_MS);
+  float current_A = ivt_fresh ? FEB_CAN_IVT_GetCurrent() : 0.0f;
+
+  uint64_t t0 = FEB_Time_Us();
+  FEB_SOC_Step(&soc_est, dt_s, current_A, ivt_fresh, uV_to_V(FEB_ACC.total_voltage_uV), FEB_ACC.cells_read);
+  uint32_t step_us = (uint32_t)(FEB_Time_Us() - t0);
+  if (step_us > soc_step_max_us)
+  {
+    soc_step_max_us = step_us;
+  }
+
+  soc_published.soc = soc_est.soc;
+  soc_published.r_ohm = soc_est.r_ohm;
+  soc_published.pack_ocv_V = FEB_SOC_Cell_OCV(soc_est.soc) * (float)FEB_NUM_CELLS;
+  soc_published.ah_out = soc_est.ah_out;
+  soc_published.rls_updates = soc_est.rls_updates;
+  soc_published.flags = soc_est.flags;
+  soc_published.step_last_us = step_us;
+  soc_published.step_max_us = soc_step_max_us;
+}
+
 // ********************************** Balancing **********************************
 
 static void determineMinV()
@@ -623,8 +659,7 @@ static void determineMinV()
   transmitCMD(ADCV | AD_CONT | AD_RD);
   osDelay(pdMS_TO_TICKS(1));
   read_cell_voltages();
-  store_cell_voltages();
-  validate_voltages();
+  process_cell_voltages();
 }
 
 // ********************************** Functions **********************************
@@ -632,6 +667,8 @@ static void determineMinV()
 bool FEB_ADBMS_Init(void)
 {
   printf("[ADBMS] Initializing ADBMS\r\n");
+  FEB_Thermistor_Init();
+  FEB_SOC_Init(&soc_est);
   for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
   {
     FEB_ACC.banks[bank].badReadV = 0;
@@ -639,8 +676,9 @@ bool FEB_ADBMS_Init(void)
     FEB_ACC.banks[bank].total_voltage_V = 0;
     for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_BANK; cell++)
     {
-      FEB_ACC.banks[bank].cells[cell].voltage_V = 0;
-      FEB_ACC.banks[bank].cells[cell].voltage_S = 0;
+      // 0 V, as a raw code
+      FEB_ACC.cell_c_codes[bank * FEB_NUM_CELLS_PER_BANK + cell] = -(ADBMS_ADC_OFFSET_UV / ADBMS_ADC_LSB_UV);
+      FEB_ACC.cell_s_codes[bank * FEB_NUM_CELLS_PER_BANK + cell] = -(ADBMS_ADC_OFFSET_UV / ADBMS_ADC_LSB_UV);
       FEB_ACC.banks[bank].cells[cell].violations = 0;
       FEB_ACC.banks[bank].cells[cell].discharging = 0;
     }
@@ -651,7 +689,6 @@ bool FEB_ADBMS_Init(void)
       // Seed raw thermistor telemetry with PEC-failure sentinels so consumers
       // can tell "not yet scanned" from a genuine 0 reading.
       FEB_ACC.banks[bank].therm_raw_codes[sensor] = 0xFFFF;
-      FEB_ACC.banks[bank].therm_raw_voltages_mV[sensor] = NAN;
     }
   }
 
@@ -662,6 +699,13 @@ bool FEB_ADBMS_Init(void)
   FEB_ACC.pack_min_temp = NAN;
   FEB_ACC.average_pack_temp = NAN;
 
+  // Same for the cell-voltage extremes: an empty range (min > max) reads as
+  // "no valid data" to FEB_ADBMS_GET_Cell_Voltage_Delta_mV().
+  FEB_ACC.total_voltage_uV = 0;
+  FEB_ACC.pack_min_voltage_uV = INT32_MAX;
+  FEB_ACC.pack_max_voltage_uV = INT32_MIN;
+  FEB_ACC.cells_read = 0;
+
   // Initialize ADBMS configuration FIRST (matching SN4 sequence)
   printf("[ADBMS] Initializing ADBMS Configuration\r\n");
   FEB_cs_high();
@@ -716,43 +760,198 @@ void FEB_ADBMS_Voltage_Process()
 {
   // Note: Caller must hold ADBMSMutexHandle (acquired in FEB_Task_ADBMS.c)
   DEBUG_VOLTAGE_PRINT("=== Voltage Process Started ===");
+  const uint32_t flags_before = adbms_fault_flags;
+  const uint64_t sample_us = FEB_Time_Us();
   start_adc_cell_voltage_measurements();
   read_cell_voltages();
-  store_cell_voltages();
-  validate_voltages();
+  process_cell_voltages();
+  notify_new_faults(flags_before, sample_us);
+  record_history(FEB_HIST_KIND_VOLTAGE);
+  update_soc();
   /* Publish lock-free snapshots for the SM task (we hold the mutex here) */
-  adbms_snap_total_V = FEB_ACC.total_voltage_V;
-  adbms_snap_max_cell_V = FEB_ACC.pack_max_voltage_V;
+  adbms_snap_total_V = uV_to_V(FEB_ACC.total_voltage_uV);
+  adbms_snap_max_cell_V = uV_to_V(FEB_ACC.pack_max_voltage_uV);
   adbms_last_update_tick = HAL_GetTick(); /* freshness for SM sensor-timeout check */
+  service_balance_stop();
   DEBUG_VOLTAGE_PRINT("=== Voltage Process Completed ===");
 }
 
+/* Close one locked phase: charge the hold time to the sweep totals. */
+static uint32_t temp_phase_release(uint64_t t0, uint32_t *locked_us)
+{
+  uint32_t held = (uint32_t)(FEB_Time_Us() - t0);
+  *locked_us += held;
+  if (held > temp_scan_stats.hold_max_us)
+  {
+    temp_scan_stats.hold_max_us = held;
+  }
+  osMutexRelease(ADBMSMutexHandle);
+  return held;
+}
+
+/* Pipelined sweep. Per channel the work is SELECT (WRCFGA + ADAX), a
+ * conversion on the ICs, READ (RDAUX) and DECODE. Only SELECT and READ touch
+ * isoSPI, so channel N+1 is selected and started in the same locked phase that
+ * reads channel N back, and N is decoded from temp_latched_aux while N+1
+ * converts. The mutex is dropped between phases and across the conversion
+ * wait, so getters and the other tasks stall for one phase, not a sweep.
+ *
+ *   task  SELECT 0 | WAIT   | READ 0 + SELECT 1 | DECODE 0, WAIT | READ 1 + SELECT 2 | ...
+ *   chip           | conv 0 |                   | conv 1         |                   | conv 2
+ */
 void FEB_ADBMS_Temperature_Process()
 {
-  // Note: Caller must hold ADBMSMutexHandle (acquired in FEB_Task_ADBMS.c)
+  // Note: Takes ADBMSMutexHandle per phase; caller must NOT hold it.
   DEBUG_TEMP_PRINT("=== Temperature Process Started ===");
+  uint32_t phase_us[FEB_TEMP_PHASE_COUNT] = {0};
+  uint32_t locked_us = 0;
+  const uint64_t scan_t0 = FEB_Time_Us();
+  uint64_t t0;
+  uint32_t conv_tick;
+
+  // 6 MUXes on GPIO1..GPIO6, 7 channels per MUX selected via GPIO7..GPIO9 (SEL1..SEL3).
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  t0 = FEB_Time_Us();
   gpio_bits[9] ^= 0b1;
   DEBUG_TEMP_PRINT("Toggled gpio_bits[9] to %d", gpio_bits[9]);
+  configure_gpio_bits(0);
+  start_aux_voltage_measurements();
+  temp_mux_busy = true;
+  conv_tick = osKernelGetTickCount();
+  phase_us[FEB_TEMP_PHASE_SELECT] += temp_phase_release(t0, &locked_us);
 
-  // 6 MUXes on GPIO1..GPIO6, 7 channels per MUX selected via GPIO7..GPIO9 (SEL1..SEL3).
-  for (uint8_t channel = 0; channel < 7; channel++)
+  for (uint8_t channel = 0; channel < FEB_TEMP_MUX_CHANNELS; channel++)
   {
     DEBUG_TEMP_PRINT("--- Processing channel %d ---", channel);
-    configure_gpio_bits(channel);
-    start_aux_voltage_measurements();
+    /* Returns at once if the previous decode already outlasted the conversion */
+    t0 = FEB_Time_Us();
+    osDelayUntil(conv_tick + pdMS_TO_TICKS(FEB_TEMP_AUX_CONV_MS));
+    phase_us[FEB_TEMP_PHASE_WAIT] += (uint32_t)(FEB_Time_Us() - t0);
+
+    osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+    t0 = FEB_Time_Us();
     read_aux_voltages();
+    temp_mux_busy = false;
+    service_balance_stop();
+    uint32_t read_us = (uint32_t)(FEB_Time_Us() - t0);
+    phase_us[FEB_TEMP_PHASE_READ] += read_us;
+    if (channel + 1 < FEB_TEMP_MUX_CHANNELS)
+    {
+      configure_gpio_bits(channel + 1);
+      start_aux_voltage_measurements();
+      temp_mux_busy = true;
+      conv_tick = osKernelGetTickCount();
+    }
+    phase_us[FEB_TEMP_PHASE_SELECT] += temp_phase_release(t0, &locked_us) - read_us;
+
+    osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+    t0 = FEB_Time_Us();
     store_cell_temps(channel);
+    phase_us[FEB_TEMP_PHASE_DECODE] += temp_phase_release(t0, &locked_us);
     DEBUG_TEMP_PRINT("--- Channel %d complete ---", channel);
   }
+
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  t0 = FEB_Time_Us();
   compute_pack_temp_stats();
+  const uint32_t flags_before = adbms_fault_flags;
   validate_temps();
+  /* Channels were sampled across the sweep; its start bounds them all */
+  notify_new_faults(flags_before, scan_t0);
+  record_history(FEB_HIST_KIND_TEMP);
   /* Publish lock-free snapshot for the SM task (we hold the mutex here) */
   adbms_snap_max_temp_C = FEB_ACC.pack_max_temp;
   adbms_last_update_tick = HAL_GetTick(); /* freshness for SM sensor-timeout check */
 
+  phase_us[FEB_TEMP_PHASE_FINALIZE] = (uint32_t)(FEB_Time_Us() - t0);
+  locked_us += phase_us[FEB_TEMP_PHASE_FINALIZE];
+  const uint32_t scan_us = (uint32_t)(FEB_Time_Us() - scan_t0);
+  for (uint8_t p = 0; p < FEB_TEMP_PHASE_COUNT; p++)
+  {
+    temp_scan_stats.last_us[p] = phase_us[p];
+    if (phase_us[p] > temp_scan_stats.max_us[p])
+    {
+      temp_scan_stats.max_us[p] = phase_us[p];
+    }
+  }
+  temp_scan_stats.scan_last_us = scan_us;
+  if (scan_us > temp_scan_stats.scan_max_us)
+  {
+    temp_scan_stats.scan_max_us = scan_us;
+  }
+  temp_scan_stats.locked_last_us = locked_us;
+  if (locked_us > temp_scan_stats.locked_max_us)
+  {
+    temp_scan_stats.locked_max_us = locked_us;
+  }
+  if (phase_us[FEB_TEMP_PHASE_FINALIZE] > temp_scan_stats.hold_max_us)
+  {
+    temp_scan_stats.hold_max_us = phase_us[FEB_TEMP_PHASE_FINALIZE];
+  }
+  temp_scan_stats.scans++;
+  osMutexRelease(ADBMSMutexHandle);
+
   DEBUG_TEMP_PRINT("=== Temperature Process Completed ===");
 }
 
+void FEB_ADBMS_Get_Temp_Scan_Stats(FEB_ADBMS_Temp_Scan_Stats_t *out)
+{
+  if (out == NULL)
+  {
+    return;
+  }
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  *out = temp_scan_stats;
+  osMutexRelease(ADBMSMutexHandle);
+}
+
+void FEB_ADBMS_Reset_Temp_Scan_Stats(void)
+{
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  memset(&temp_scan_stats, 0, sizeof(temp_scan_stats));
+  osMutexRelease(ADBMSMutexHandle);
+}
+
+void FEB_ADBMS_History_Freeze(void)
+{
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  FEB_Cell_History_Freeze(HAL_GetTick(), 0);
+  osMutexRelease(ADBMSMutexHandle);
+}
+
+void FEB_ADBMS_History_Rearm(void)
+{
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  FEB_Cell_History_Rearm();
+  osMutexRelease(ADBMSMutexHandle);
+}
+
+void FEB_ADBMS_Get_SOC(FEB_ADBMS_SOC_t *out)
+{
+  if (out == NULL)
+  {
+    return;
+  }
+  out->soc = soc_published.soc;
+  out->r_ohm = soc_published.r_ohm;
+  out->pack_ocv_V = soc_published.pack_ocv_V;
+  out->ah_out = soc_published.ah_out;
+  out->rls_updates = soc_published.rls_updates;
+  out->flags = soc_published.flags;
+  out->step_last_us = soc_published.step_last_us;
+  out->step_max_us = soc_published.step_max_us;
+}
+
+void FEB_ADBMS_Reset_SOC(void)
+{
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  FEB_SOC_Init(&soc_est);
+  soc_last_tick = 0;
+  soc_step_max_us = 0;
+  soc_published.flags = 0;
+  osMutexRelease(ADBMSMutexHandle);
+}
+
 // ********************************** Voltage ************************************
 
 float FEB_ADBMS_GET_ACC_Total_Voltage()
@@ -762,7 +961,7 @@ float FEB_ADBMS_GET_ACC_Total_Voltage()
   return FEB_BMS_BENCH_PACK_VOLTAGE_V;
 #else
   osMutexAcquire(ADBMSMutexHandle, osWaitForever);
-  float voltage = FEB_ACC.total_voltage_V;
+  float voltage = uV_to_V(FEB_ACC.total_voltage_uV);
   osMutexRelease(ADBMSMutexHandle);
   return voltage;
 #endif
@@ -771,7 +970,7 @@ float FEB_ADBMS_GET_ACC_Total_Voltage()
 float FEB_ADBMS_GET_ACC_MIN_Voltage()
 {
   osMutexAcquire(ADBMSMutexHandle, osWaitForever);
-  float voltage = FEB_ACC.pack_min_voltage_V;
+  float voltage = uV_to_V(FEB_ACC.pack_min_voltage_uV);
   osMutexRelease(ADBMSMutexHandle);
   return voltage;
 }
@@ -779,7 +978,7 @@ float FEB_ADBMS_GET_ACC_MIN_Voltage()
 float FEB_ADBMS_GET_ACC_MAX_Voltage()
 {
   osMutexAcquire(ADBMSMutexHandle, osWaitForever);
-  float voltage = FEB_ACC.pack_max_voltage_V;
+  float voltage = uV_to_V(FEB_ACC.pack_max_voltage_uV);
   osMutexRelease(ADBMSMutexHandle);
   return voltage;
 }
@@ -792,7 +991,7 @@ float FEB_ADBMS_GET_Cell_Voltage(uint8_t bank, uint16_t cell)
   }
 
   osMutexAcquire(ADBMSMutexHandle, osWaitForever);
-  float voltage = FEB_ACC.banks[bank].cells[cell].voltage_V;
+  float voltage = uV_to_V(ADBMS_CODE_TO_UV(FEB_ACC.cell_c_codes[bank * FEB_NUM_CELLS_PER_BANK + cell]));
   osMutexRelease(ADBMSMutexHandle);
   return voltage;
 }
@@ -805,7 +1004,7 @@ float FEB_ADBMS_GET_Cell_Voltage_S(uint8_t bank, uint16_t cell)
   }
 
   osMutexAcquire(ADBMSMutexHandle, osWaitForever);
-  float voltage = FEB_ACC.banks[bank].cells[cell].voltage_S;
+  float voltage = uV_to_V(ADBMS_CODE_TO_UV(FEB_ACC.cell_s_codes[bank * FEB_NUM_CELLS_PER_BANK + cell]));
   osMutexRelease(ADBMSMutexHandle);
   return voltage;
 }
@@ -903,9 +1102,9 @@ float FEB_ADBMS_GET_Therm_Raw_mV(uint8_t bank, uint16_t sensor)
   }
 
   osMutexAcquire(ADBMSMutexHandle, osWaitForever);
-  float mV = FEB_ACC.banks[bank].therm_raw_voltages_mV[sensor];
+  uint16_t code = FEB_ACC.banks[bank].therm_raw_codes[sensor];
   osMutexRelease(ADBMSMutexHandle);
-  return mV;
+  return (code == 0xFFFF) ? NAN : convert_voltage((int16_t)code) * 1000.0f;
 }
 
 // ********************************** Balancing **********************************
@@ -913,9 +1112,16 @@ float FEB_ADBMS_GET_Therm_Raw_mV(uint8_t bank, uint16_t sensor)
 void FEB_Cell_Balance_Start()
 {
   LOG_I(TAG_BALANCE, "Starting cell balancing");
-  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  adbms_acquire_idle();
+  balance_stop_pending = false; /* a start after a deferred stop wins */
   FEB_cs_high();
   ADBMS6830B_init_cfg(FEB_NUM_IC, IC_Config);
+  // init_cfg drives every GPIO high; keep the thermistor MUX select where the
+  // sweep left it so the next channel is not read through the wrong input.
+  for (uint8_t ic = 0; ic < FEB_NUM_IC; ic++)
+  {
+    ADBMS6830B_set_cfgr(ic, IC_Config, refon, cth_bits, gpio_bits, 0, dcto_bits, uv, ov);
+  }
   ADBMS6830B_wrALL(FEB_NUM_IC, IC_Config);
   FEB_Cell_Balance_Process();
   osMutexRelease(ADBMSMutexHandle);
@@ -946,12 +1152,12 @@ void FEB_Cell_Balance_Process()
   }
   balancing_cycle++;
 #endif
-  // Use the pack-wide minimum written by store_cell_voltages().
-  // FEB_ACC.min_voltage_V is never written → reading it yields 0 and every
-  // cell clears the slippage threshold.
-  float min_cell_voltage = FEB_ACC.pack_min_voltage_V;
-  LOG_D(TAG_BALANCE, "Cycle %d: min=%.3fV max=%.3fV mask=0x%04X", balancing_cycle, min_cell_voltage,
-        FEB_ACC.pack_max_voltage_V, balancing_mask);
+  // Candidates are cells more than FEB_MIN_SLIPPAGE_uV above the pack-wide
+  // minimum from process_cell_voltages(); the minimum is only known once that
+  // pass ends, so the compare runs here over the packed code array.
+  const int32_t min_cell_uV = FEB_ACC.pack_min_voltage_uV;
+  LOG_D(TAG_BALANCE, "Cycle %d: min=%.3fV max=%.3fV mask=0x%04X", balancing_cycle, uV_to_V(min_cell_uV),
+        uV_to_V(FEB_ACC.pack_max_voltage_uV), balancing_mask);
 
   uint8_t total_balancing = 0;
   for (uint8_t icn = 0; icn < FEB_NUM_IC; icn++)
@@ -959,10 +1165,8 @@ void FEB_Cell_Balance_Process()
     uint16_t bits = 0x0000;
     for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_IC; cell++)
     {
-      float volt =
-          FEB_ACC.banks[icn / FEB_NUM_ICPBANK].cells[cell + FEB_NUM_CELLS_PER_IC * (icn % FEB_NUM_ICPBANK)].voltage_V;
-      float diff = volt - min_cell_voltage;
-      if (diff > FEB_MIN_SLIPPAGE_V)
+      const int32_t diff_uV = ADBMS_CODE_TO_UV(FEB_ACC.cell_c_codes[icn * FEB_NUM_CELLS_PER_IC + cell]) - min_cell_uV;
+      if (diff_uV > FEB_MIN_SLIPPAGE_uV)
       {
         bits |= (0b1 << cell);
 #if FEB_CELL_BALANCE_ALL_AT_ONCE
@@ -995,10 +1199,13 @@ void FEB_Cell_Balance_Process()
   if (total_balancing > 0)
   {
     LOG_I(TAG_BALANCE, "Balancing %d cells, delta=%.0fmV", total_balancing,
-          (FEB_ACC.pack_max_voltage_V - min_cell_voltage) * 1000);
+          (FEB_ACC.pack_max_voltage_uV - min_cell_uV) / 1000.0f);
   }
 
   ADBMS6830B_wrcfgb(FEB_NUM_IC, IC_Config);
+
+  /* A stop requested while this cycle computed its DCC bits still wins */
+  service_balance_stop();
 }
 
 bool FEB_Cell_Balancing_Status(void)
@@ -1018,38 +1225,17 @@ bool FEB_Cell_Balancing_Status(void)
   }
 #endif
 
-  float min_v = FLT_MAX;
-  float max_v = -FLT_MAX;
-
-  for (size_t i = 0; i < FEB_NBANKS; ++i)
-  {
-    for (size_t j = 0; j < FEB_NUM_CELLS_PER_BANK; ++j)
-    {
-      const float voltage = FEB_ADBMS_GET_Cell_Voltage(i, j) * 1000.0f;
-
-      if (voltage < 0)
-      {
-        continue;
-      }
-
-      if (voltage < min_v)
-        min_v = voltage;
-      if (voltage > max_v)
-        max_v = voltage;
-    }
-  }
-
-  if (max_v < 0 || min_v > 1e8f)
+  const float delta_v = FEB_ADBMS_GET_Cell_Voltage_Delta_mV();
+  if (delta_v < 0.0f)
   {
     LOG_W(TAG_BALANCE, "Invalid voltage readings, cannot balance");
     return false;
   }
 
-  const float delta_v = max_v - min_v;
-  LOG_D(TAG_BALANCE, "Status: delta=%.0fmV (threshold=%.0fmV)", delta_v, FEB_MIN_SLIPPAGE_V * 1000.0f);
+  LOG_D(TAG_BALANCE, "Status: delta=%.0fmV (threshold=%.0fmV)", delta_v, FEB_MIN_SLIPPAGE_uV / 1000.0f);
 
-  // delta_v is in millivolts, FEB_MIN_SLIPPAGE_V is in volts (0.03V = 30mV)
-  if (delta_v >= FEB_MIN_SLIPPAGE_V * 1000.0f)
+  // delta_v is in millivolts, FEB_MIN_SLIPPAGE_uV in microvolts (30000uV = 30mV)
+  if (delta_v >= FEB_MIN_SLIPPAGE_uV / 1000.0f)
   {
     return true;
   }
@@ -1080,30 +1266,16 @@ uint16_t FEB_ADBMS_GET_Balancing_Cell_Count(void)
 // balancing delta). Returns -1.0f when no valid cell readings are available.
 float FEB_ADBMS_GET_Cell_Voltage_Delta_mV(void)
 {
-  float min_v = FLT_MAX;
-  float max_v = -FLT_MAX;
-
-  for (size_t i = 0; i < FEB_NBANKS; ++i)
-  {
-    for (size_t j = 0; j < FEB_NUM_CELLS_PER_BANK; ++j)
-    {
-      const float voltage = FEB_ADBMS_GET_Cell_Voltage(i, j) * 1000.0f;
-      if (voltage < 0)
-      {
-        continue; // getter returns -1000mV (-1.0V * 1000) for invalid/out-of-range
-      }
-      if (voltage < min_v)
-        min_v = voltage;
-      if (voltage > max_v)
-        max_v = voltage;
-    }
-  }
+  osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+  const int32_t min_uV = FEB_ACC.pack_min_voltage_uV;
+  const int32_t max_uV = FEB_ACC.pack_max_voltage_uV;
+  osMutexRelease(ADBMSMutexHandle);
 
-  if (max_v < 0 || min_v > 1e8f)
+  if (max_uV < min_uV)
   {
     return -1.0f; // no valid readings
   }
-  return max_v - min_v;
+  return (max_uV - min_uV) / 1000.0f;
 }
 
 // "Done balancing": valid readings AND pack converged below the slippage
@@ -1112,7 +1284,7 @@ float FEB_ADBMS_GET_Cell_Voltage_Delta_mV(void)
 bool FEB_Cell_Balance_Complete(void)
 {
   const float delta_mV = FEB_ADBMS_GET_Cell_Voltage_Delta_mV();
-  return (delta_mV >= 0.0f && delta_mV < FEB_MIN_SLIPPAGE_V * 1000.0f);
+  return (delta_mV >= 0.0f && delta_mV < FEB_MIN_SLIPPAGE_uV / 1000.0f);
 }
 
 void FEB_Stop_Balance()
@@ -1135,6 +1307,30 @@ void FEB_Stop_Balance()
     }
   }
 
+  // The isoSPI write needs the chain. Callers include the 1ms SM task, so only
+  // take it if it is free and no MUX channel is converting; otherwise the ADBMS
+  // task writes DCC=0 at its next idle point, within one sweep phase.
+  balance_stop_pending = true;
+  if (osMutexAcquire(ADBMSMutexHandle, 0) == osOK)
+  {
+    if (!temp_mux_busy)
+    {
+      service_balance_stop();
+    }
+    osMutexRelease(ADBMSMutexHandle);
+  }
+}
+
+// Caller holds ADBMSMutexHandle with no MUX channel converting. gpio_bits is
+// the current MUX select, so the CFGA rewrite leaves the thermistors alone.
+static void service_balance_stop(void)
+{
+  if (!balance_stop_pending)
+  {
+    return;
+  }
+  balance_stop_pending = false;
+
   for (uint8_t ic = 0; ic < FEB_NUM_IC; ic++)
   {
     ADBMS6830B_set_cfgr(ic, IC_Config, refon, cth_bits, gpio_bits, 0, dcto_bits, uv, ov);
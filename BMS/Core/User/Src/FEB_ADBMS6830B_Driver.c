@@ -4,6 +4,7 @@
 #include "FEB_HW.h"
 #include "FEB_CMDCODES.h"
 #include "FEB_AD68xx_Interface.h"
+#include "FEB_AD68xx_Async.h"
 #include "FreeRTOS.h"
 #include "cmsis_os.h"
 #include <string.h>
@@ -282,11 +283,26 @@ uint8_t ADBMS6830B_rdcv(uint8_t total_ic, // The number of ICs in the system
   uint8_t TxSize = 8;
   uint8_t cell_data[TxSize * total_ic];
   uint16_t codes[6] = {RDCVA, RDCVB, RDCVC, RDCVD, RDCVE, RDCVF};
+  int8_t tickets[6];
 
+  // Queue all six groups behind a single chain wake-up; they run back to back
+  // on the DMA transport while we parse each one as it lands.
   for (int REGGRP = 0; REGGRP < 6; REGGRP++)
   {
-    wakeup_sleep(FEB_NUM_IC);
-    transmitCMDR(codes[REGGRP], cell_data, TxSize * total_ic);
+    tickets[REGGRP] = ADBMS_Async_Read(codes[REGGRP], total_ic);
+  }
+
+  for (int REGGRP = 0; REGGRP < 6; REGGRP++)
+  {
+    uint32_t pec_fail = 0;
+    if (ADBMS_Async_Wait(tickets[REGGRP], cell_data, &pec_fail, FEB_SPI_TIMEOUT_MS) != ADBMS_XFER_OK)
+    {
+      // No frame: leave c_codes alone and flag every IC so the consumer skips it.
+      for (int icn = 0; icn < total_ic; icn++)
+        ic[icn].cells.pec_match[REGGRP] = 1;
+      errorCount += total_ic;
+      continue;
+    }
     uint8_t bytesInGroup = (REGGRP == 5) ? 2 : 6;
 
     // One command on the wire -> one CC tick. Check the global counter once
@@ -308,16 +324,14 @@ uint8_t ADBMS6830B_rdcv(uint8_t total_ic, // The number of ICs in the system
           ic[icn].cells.c_codes[code_idx] |= (uint16_t)ic_data[byte] << 8;
       }
 
-      // Per-IC PEC: byte 6 = {CC[5:0], PEC[9:8]}, byte 7 = PEC[7:0].
-      // rdcv writes pec_match[REGGRP] unconditionally; rdsv runs after
+      // Per-IC PEC (checked by the transport). rdcv writes
+      // pec_match[REGGRP] unconditionally; rdsv runs after
       // (FEB_ADBMS6830B.c:146-147) and ORs in its result so the flag is
       // worst-of-two. Consumer at FEB_ADBMS6830B.c:174 gates use of
       // c_codes (rdcv data) on this flag.
-      uint16_t calc_pec = Pec10_calc(true, 6, ic_data);
-      uint16_t rx_pec = ((uint16_t)(ic_data[6] & 0x03) << 8) | ic_data[7];
       uint8_t ic_cc = (uint8_t)((ic_data[6] >> 2) & 0x3F);
       ADBMS_CC_CheckIC(icn, ic_cc, first_ic_cc);
-      bool mismatch = (calc_pec != rx_pec);
+      bool mismatch = ((pec_fail >> icn) & 1U) != 0U;
       ic[icn].cells.pec_match[REGGRP] = mismatch ? 1 : 0;
       if (mismatch)
         errorCount++;
@@ -334,11 +348,24 @@ uint8_t ADBMS6830B_rdsv(uint8_t total_ic, // The number of ICs in the system
   uint8_t TxSize = 8;
   uint8_t cell_data[TxSize * total_ic];
   uint16_t codes[6] = {RDSVA, RDSVB, RDSVC, RDSVD, RDSVE, RDSVF};
+  int8_t tickets[6];
 
+  // Batched like rdcv: one wake-up, six queued reads.
   for (int REGGRP = 0; REGGRP < 6; REGGRP++)
   {
-    wakeup_sleep(FEB_NUM_IC);
-    transmitCMDR(codes[REGGRP], cell_data, TxSize * total_ic);
+    tickets[REGGRP] = ADBMS_Async_Read(codes[REGGRP], total_ic);
+  }
+
+  for (int REGGRP = 0; REGGRP < 6; REGGRP++)
+  {
+    uint32_t pec_fail = 0;
+    if (ADBMS_Async_Wait(tickets[REGGRP], cell_data, &pec_fail, FEB_SPI_TIMEOUT_MS) != ADBMS_XFER_OK)
+    {
+      for (int icn = 0; icn < total_ic; icn++)
+        ic[icn].cells.pec_match[REGGRP] |= 1;
+      errorCount += total_ic;
+      continue;
+    }
     uint8_t bytesInGroup = (REGGRP == 5) ? 2 : 6;
 
     // One command on the wire -> one CC tick. See rdcv for rationale.
@@ -358,17 +385,14 @@ uint8_t ADBMS6830B_rdsv(uint8_t total_ic, // The number of ICs in the system
           ic[icn].cells.s_codes[code_idx] |= (uint16_t)ic_data[byte] << 8;
       }
 
-      // Per-IC PEC: byte 6 = {CC[5:0], PEC[9:8]}, byte 7 = PEC[7:0].
-      // Worst-of-two with rdcv: rdcv runs first (FEB_ADBMS6830B.c:146-147)
-      // and writes pec_match[REGGRP] unconditionally; we OR in rdsv's result
-      // so a rdcv PEC fail is not silently cleared by a rdsv pass. The
-      // consumer at FEB_ADBMS6830B.c:174 gates use of c_codes (rdcv data)
-      // on this flag.
-      uint16_t calc_pec = Pec10_calc(true, 6, ic_data);
-      uint16_t rx_pec = ((uint16_t)(ic_data[6] & 0x03) << 8) | ic_data[7];
+      // Per-IC PEC (checked by the transport). Worst-of-two with rdcv:
+      // rdcv runs first (FEB_ADBMS6830B.c:146-147) and writes
+      // pec_match[REGGRP] unconditionally; we OR in rdsv's result so a rdcv
+      // PEC fail is not silently cleared by a rdsv pass. The consumer at
+      // FEB_ADBMS6830B.c:174 gates use of c_codes (rdcv data) on this flag.
       uint8_t ic_cc = (uint8_t)((ic_data[6] >> 2) & 0x3F);
       ADBMS_CC_CheckIC(icn, ic_cc, first_ic_cc);
-      bool mismatch = (calc_pec != rx_pec);
+      bool mismatch = ((pec_fail >> icn) & 1U) != 0U;
       ic[icn].cells.pec_match[REGGRP] |= mismatch ? 1 : 0;
       if (mismatch)
         errorCount++;
@@ -651,65 +675,48 @@ uint8_t ADBMS6830B_rdaux(uint8_t total_ic, // The number of ICs in the system
 )
 {
   uint8_t pec_error = 0;
-  uint8_t *cell_data;
-  cell_data = (uint8_t *)pvPortMalloc((NUM_RX_BYT * total_ic) * sizeof(uint8_t));
-  if (cell_data == NULL)
-  {
-    return 1;
-  }
-
-  // Match rdcv/rdsv/rdsid: ensure the daisy chain is awake before the first
-  // command or the leading frames can be dropped on a sleeping chain.
-  wakeup_sleep(total_ic);
+  uint8_t cell_data[NUM_RX_BYT * total_ic];
+  const uint16_t codes[2] = {RDAUXA, RDAUXB};
+  int8_t tickets[2];
 
-  // RDAUXA: GPIO1-3 -> a_codes[0..2]
-  transmitCMDR(RDAUXA, cell_data, NUM_RX_BYT * total_ic);
-
-  // One command on the wire -> one CC tick. See rdcv for rationale.
-  uint8_t first_ic_cc_a = (uint8_t)((cell_data[6] >> 2) & 0x3F);
-  ADBMS_CC_Check(first_ic_cc_a);
-
-  for (int i = 0; i < total_ic; i++)
+  // Both groups go out behind one chain wake-up (queued transport, see rdcv).
+  // RDAUXA: GPIO1-3 -> a_codes[0..2], RDAUXB: GPIO4-6 -> a_codes[3..5].
+  for (int grp = 0; grp < 2; grp++)
   {
-    uint8_t *ic_data = cell_data + i * NUM_RX_BYT;
-    memcpy(&ic[i].aux.a_codes[0], ic_data, 6);
-
-    // On-wire layout: byte 6 = {CC[5:0], PEC[9:8]}, byte 7 = PEC[7:0].
-    // Mask 0x03 strips the command counter so only PEC[9:0] is compared.
-    // Record per-IC match so downstream consumers like
-    // check_and_report_pec_errors() can drive redundancy failover.
-    uint16_t calc_pec = Pec10_calc(true, 6, ic_data);
-    uint16_t rx_pec = ((uint16_t)(ic_data[6] & 0x03) << 8) | ic_data[7];
-    uint8_t ic_cc = (uint8_t)((ic_data[6] >> 2) & 0x3F);
-    ADBMS_CC_CheckIC(i, ic_cc, first_ic_cc_a);
-    bool mismatch = (calc_pec != rx_pec);
-    ic[i].aux.pec_match[0] = mismatch ? 1 : 0;
-    if (mismatch)
-      pec_error++;
+    tickets[grp] = ADBMS_Async_Read(codes[grp], total_ic);
   }
 
-  // RDAUXB: GPIO4-6 -> a_codes[3..5]
-  transmitCMDR(RDAUXB, cell_data, NUM_RX_BYT * total_ic);
+  for (int grp = 0; grp < 2; grp++)
+  {
+    uint32_t pec_fail = 0;
+    if (ADBMS_Async_Wait(tickets[grp], cell_data, &pec_fail, FEB_SPI_TIMEOUT_MS) != ADBMS_XFER_OK)
+    {
+      for (int i = 0; i < total_ic; i++)
+        ic[i].aux.pec_match[grp] = 1;
+      pec_error += total_ic;
+      continue;
+    }
 
-  uint8_t first_ic_cc_b = (uint8_t)((cell_data[6] >> 2) & 0x3F);
-  ADBMS_CC_Check(first_ic_cc_b);
+    // One command on the wire -> one CC tick. See rdcv for rationale.
+    uint8_t first_ic_cc = (uint8_t)((cell_data[6] >> 2) & 0x3F);
+    ADBMS_CC_Check(first_ic_cc);
 
-  for (int i = 0; i < total_ic; i++)
-  {
-    uint8_t *ic_data = cell_data + i * NUM_RX_BYT;
-    memcpy(&ic[i].aux.a_codes[3], ic_data, 6);
+    for (int i = 0; i < total_ic; i++)
+    {
+      uint8_t *ic_data = cell_data + i * NUM_RX_BYT;
+      memcpy(&ic[i].aux.a_codes[3 * grp], ic_data, 6);
 
-    uint16_t calc_pec = Pec10_calc(true, 6, ic_data);
-    uint16_t rx_pec = ((uint16_t)(ic_data[6] & 0x03) << 8) | ic_data[7];
-    uint8_t ic_cc = (uint8_t)((ic_data[6] >> 2) & 0x3F);
-    ADBMS_CC_CheckIC(i, ic_cc, first_ic_cc_b);
-    bool mismatch = (calc_pec != rx_pec);
-    ic[i].aux.pec_match[1] = mismatch ? 1 : 0;
-    if (mismatch)
-      pec_error++;
+      // Record per-IC match so downstream consumers like
+      // check_and_report_pec_errors() can drive redundancy failover.
+      uint8_t ic_cc = (uint8_t)((ic_data[6] >> 2) & 0x3F);
+      ADBMS_CC_CheckIC(i, ic_cc, first_ic_cc);
+      bool mismatch = ((pec_fail >> i) & 1U) != 0U;
+      ic[i].aux.pec_match[grp] = mismatch ? 1 : 0;
+      if (mismatch)
+        pec_error++;
+    }
   }
 
-  vPortFree(cell_data);
   return pec_error;
 }
 
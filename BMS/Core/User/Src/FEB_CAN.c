@@ -22,6 +22,7 @@
 #include "cmsis_os2.h"
 #include "main.h"
 #include "feb_log.h"
+#include "feb_time.h"
 #include "FEB_CAN_State.h"
 #include "FEB_CAN_PingPong.h"
 #include "FEB_CAN_DASH.h"
@@ -52,6 +53,7 @@ static void BMS_CAN_Init(void)
       .hcan1 = &hcan1,
       .hcan2 = NULL,
       .get_tick_ms = HAL_GetTick,
+      .get_time_us = FEB_Time_Us,
 #if FEB_CAN_USE_FREERTOS
       .tx_queue = canTxQueueHandle,
       .rx_queue = canRxQueueHandle,
@@ -69,6 +71,10 @@ static void BMS_CAN_Init(void)
     }
   }
 
+  /* Keep one CAN1 mailbox for the priority lane (BMS state heartbeat) so the
+   * cell history stream never makes it wait for a mailbox. */
+  FEB_CAN_TX_ReserveMailboxes(FEB_CAN_INSTANCE_1, 1);
+
   /* RX registrations live in the per-module *_Init() functions called from
    * StartBMSTaskRx(). CAN1 has only 14 hardware filter banks (one per unique
    * registered ID/mask) — keep registrations consolidated (mask filters for
@@ -112,7 +118,9 @@ void StartBMSTaskRx(void *argument)
 
   for (;;)
   {
-    /* Dispatch RX queue and invoke callbacks */
+    /* Dispatch RX queue and invoke callbacks. BMS builds the CAN library in
+     * bare-metal mode (callbacks run in the FIFO ISR), so this is a no-op
+     * poll; FEB_CAN_RX_Wait's batching needs FEB_CAN_USE_FREERTOS. */
     FEB_CAN_RX_Process();
     osDelay(1);
   }
@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_CAN_History.c
+ * @brief          : Bulk dump of the frozen cell history ring over CAN
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ */
+
+#include "FEB_CAN_History.h"
+#include "FEB_Cell_History.h"
+#include "FEB_Const.h"
+#include "feb_can_ext_frames.h"
+#include "feb_can_lib.h"
+#include <string.h>
+
+/* ============================================================================
+ * Internal State
+ * ============================================================================ */
+
+/* Written by the console task at Start/Stop, advanced by the SM task. A stream
+ * only reads a frozen ring, which nothing writes. */
+static volatile bool stream_active;
+static uint16_t stream_seq;
+static uint32_t stream_sent;
+static uint32_t stream_total;
+static uint32_t stream_records;
+
+/* ============================================================================
+ * API Implementation
+ * ============================================================================ */
+
+bool FEB_CAN_History_Start(void)
+{
+  FEB_Cell_History_Stats_t st;
+  FEB_Cell_History_Get_Stats(&st);
+  if (!st.frozen || st.used_bytes == 0)
+  {
+    return false;
+  }
+
+  stream_active = false;
+  stream_seq = 0;
+  stream_sent = 0;
+  stream_total = st.used_bytes;
+  stream_records = st.records;
+  stream_active = true;
+  return true;
+}
+
+void FEB_CAN_History_Stop(void)
+{
+  stream_active = false;
+}
+
+void FEB_CAN_History_Tick(void)
+{
+  if (!stream_active)
+  {
+    return;
+  }
+  if (!FEB_Cell_History_Is_Frozen())
+  {
+    stream_active = false;
+    return;
+  }
+
+  uint8_t tx_data[FEB_CAN_EXT_BMS_HIST_LENGTH] = {0};
+  uint8_t length;
+  uint32_t chunk = 0;
+
+  if (stream_seq == 0)
+  {
+    length = feb_can_ext_bms_hist_pack_header(tx_data, stream_total, (uint16_t)stream_records);
+  }
+  else
+  {
+    uint8_t bytes[FEB_CAN_EXT_BMS_HIST_CHUNK];
+    chunk = FEB_Cell_History_Read(stream_sent, bytes, FEB_CAN_EXT_BMS_HIST_CHUNK);
+    length = feb_can_ext_bms_hist_pack_data(tx_data, stream_seq, bytes, (uint8_t)chunk);
+  }
+
+  if (FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_EXT_BMS_HIST_FRAME_ID, FEB_CAN_ID_STD, tx_data, length) !=
+      FEB_CAN_OK)
+  {
+    return; /* TX queue full: same frame next tick */
+  }
+
+  stream_seq++;
+  stream_sent += chunk;
+  if (stream_seq > 1U && stream_sent >= stream_total)
+  {
+    stream_active = false;
+  }
+}
+
+bool FEB_CAN_History_Get_Progress(uint32_t *sent_bytes, uint32_t *total_bytes)
+{
+  if (sent_bytes != NULL)
+  {
+    *sent_bytes = stream_sent;
+  }
+  if (total_bytes != NULL)
+  {
+    *total_bytes = stream_total;
+  }
+  return stream_active;
+}
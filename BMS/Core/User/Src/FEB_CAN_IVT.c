@@ -9,10 +9,12 @@
 
 #include "FEB_CAN_IVT.h"
 #include "FEB_Const.h"
+#include "FEB_SM.h"
 #include "feb_can_lib.h"
 #include "feb_can.h"
 #include "stm32f4xx_hal.h"
 #include "cmsis_compiler.h"
+#include <math.h>
 #include <stddef.h>
 
 /* Note: Critical sections removed - float reads are atomic on ARM Cortex-M4 */
@@ -63,6 +65,12 @@ static void FEB_CAN_IVT_Callback(FEB_CAN_Instance_t instance, uint32_t can_id, F
     ivt_data.current_mA = (float)msg.current * (-0.001f) * 1000.0f;
     __DMB(); /* Memory barrier to ensure data write completes before timestamp */
     ivt_data.last_rx_tick = HAL_GetTick();
+    /* Over the limit: have the SM evaluate this frame now, not on its next poll
+     * (the overcurrent debounce still applies there) */
+    if (fabsf(ivt_data.current_mA) * 0.001f > FEB_SM_Get_Overcurrent_Limit_A())
+    {
+      FEB_SM_Notify_Event(FEB_SM_EVENT_IVT, FEB_CAN_RX_GetFrameTimeUs());
+    }
     break;
   }
 
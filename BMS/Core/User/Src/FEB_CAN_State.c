@@ -7,6 +7,8 @@
 #include "FEB_ADBMS6830B.h"
 #include "FEB_CAN_DASH.h"
 #include "FEB_SM.h"
+#include "FEB_SOC.h"
+#include "feb_can_ext_frames.h"
 #include "feb_can_lib.h"
 #include "feb_can.h"
 #include "stm32f4xx_hal.h"
@@ -18,6 +20,12 @@
 /* R2D timeout for state transitions */
 #define R2D_TIMEOUT_MS 500
 
+/* The estimator's flags go on 0x0E5 unchanged */
+_Static_assert(FEB_SOC_FLAG_VALID == FEB_CAN_EXT_BMS_SOC_FLAG_VALID, "0x0E5 flag drift");
+_Static_assert(FEB_SOC_FLAG_R_CONVERGED == FEB_CAN_EXT_BMS_SOC_FLAG_R_CONVERGED, "0x0E5 flag drift");
+_Static_assert(FEB_SOC_FLAG_AT_REST == FEB_CAN_EXT_BMS_SOC_FLAG_AT_REST, "0x0E5 flag drift");
+_Static_assert(FEB_SOC_FLAG_NO_CURRENT == FEB_CAN_EXT_BMS_SOC_FLAG_NO_CURRENT, "0x0E5 flag drift");
+
 /* CAN ready flag - prevents transmission before CAN is initialized */
 static volatile bool can_ready = false;
 
@@ -103,7 +111,10 @@ void FEB_CAN_State_Tick(void)
     uint8_t tx_data[FEB_CAN_BMS_STATE_LENGTH];
     feb_can_bms_state_pack(tx_data, &bms_state_msg, sizeof(tx_data));
 
-    FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_BMS_STATE_FRAME_ID, FEB_CAN_ID_STD, tx_data, FEB_CAN_BMS_STATE_LENGTH);
+    /* The PCU treats this frame as the BMS heartbeat (BMS_STATE_TIMEOUT_MS)
+     * and answers it, so it takes the priority lane past cell telemetry. */
+    FEB_CAN_TX_SendPriority(FEB_CAN_INSTANCE_1, FEB_CAN_BMS_STATE_FRAME_ID, FEB_CAN_ID_STD, tx_data,
+                            FEB_CAN_BMS_STATE_LENGTH);
   }
 
   /* Divider for 100ms period (called every 1ms) */
@@ -173,6 +184,34 @@ void FEB_CAN_State_Tick(void)
     FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_BMS_ACCUMULATOR_TEMPERATURE_FRAME_ID, FEB_CAN_ID_STD, tx_data,
                     FEB_CAN_BMS_ACCUMULATOR_TEMPERATURE_LENGTH);
   }
+
+  /* Divider for 100ms period (called every 1ms) */
+  static uint16_t soc_divider = 50;
+  soc_divider++;
+
+  if (soc_divider >= 100)
+  {
+    soc_divider = 0;
+
+    /* SOC / R_pack estimate (layout in feb_can_ext_frames.h; not in the generated library) */
+    static uint8_t soc_counter = 0;
+    FEB_ADBMS_SOC_t est;
+    FEB_ADBMS_Get_SOC(&est);
+
+    float r_tenth_mohm = est.r_ohm * 10000.0f + 0.5f;
+    struct feb_can_ext_bms_soc_t msg = {
+        .soc_cpct = (est.flags & FEB_SOC_FLAG_VALID) ? (uint16_t)(est.soc * 10000.0f + 0.5f)
+                                                      : (uint16_t)FEB_CAN_EXT_BMS_SOC_INVALID,
+        .r_pack_tenth_mohm = (r_tenth_mohm >= 65535.0f) ? 0xFFFF : (uint16_t)r_tenth_mohm,
+        .ocv_dv = (uint16_t)(est.pack_ocv_V * 10.0f + 0.5f),
+        .flags = est.flags,
+        .counter = soc_counter++,
+    };
+
+    uint8_t tx_data[FEB_CAN_EXT_BMS_SOC_LENGTH];
+    uint8_t length = feb_can_ext_bms_soc_pack(tx_data, &msg);
+    FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_EXT_BMS_SOC_FRAME_ID, FEB_CAN_ID_STD, tx_data, length);
+  }
 }
 
 void FEB_CAN_State_ProcessTransitions(void)
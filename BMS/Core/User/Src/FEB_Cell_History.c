@@ -0,0 +1,469 @@
+#include "FEB_Cell_History.h"
+
+#include <string.h>
+
+// ********************************** Variables **********************************
+
+static uint8_t hist_buf[FEB_HIST_BUF_BYTES];
+static uint32_t hist_tail; // Ring offset of the oldest record
+static uint32_t hist_used; // Bytes held, from hist_tail
+static uint32_t hist_records;
+static uint32_t hist_evicted;
+static uint32_t hist_newest_tick;
+static bool hist_frozen;
+static uint32_t hist_freeze_tick;
+static uint8_t hist_freeze_flags;
+
+// Last recorded frame of each kind: the reference for the next delta record.
+static uint16_t hist_prev_voltage[FEB_HIST_VOLTAGE_CHANNELS];
+static uint16_t hist_prev_temp[FEB_HIST_TEMP_CHANNELS];
+static bool hist_have_prev[FEB_HIST_KIND_COUNT];
+static uint16_t hist_since_key[FEB_HIST_KIND_COUNT];
+
+// Record being written (between Begin and End)
+static struct
+{
+  bool open;
+  bool key;
+  FEB_Hist_Kind_t kind;
+  uint8_t flags;
+  uint16_t *prev;
+  uint16_t channels;
+  uint16_t count;
+  uint16_t zero_run;
+  uint32_t start; // Ring offset of the header
+  uint32_t nibbles;
+  uint32_t tick;
+} hist_wr;
+
+// ********************************** Helper Functions ***************************
+
+static uint16_t *kind_frame(FEB_Hist_Kind_t kind, uint16_t *voltage, uint16_t *temp)
+{
+  return (kind == FEB_HIST_KIND_VOLTAGE) ? voltage : temp;
+}
+
+static uint16_t kind_channels(FEB_Hist_Kind_t kind)
+{
+  return (kind == FEB_HIST_KIND_VOLTAGE) ? FEB_HIST_VOLTAGE_CHANNELS : FEB_HIST_TEMP_CHANNELS;
+}
+
+// Largest record of a kind: every value as a 5-nibble token.
+static uint32_t kind_worst_bytes(FEB_Hist_Kind_t kind)
+{
+  return FEB_HIST_HEADER_BYTES + (5U * kind_channels(kind) + 1U) / 2U;
+}
+
+static inline uint16_t zigzag(uint16_t diff)
+{
+  return (uint16_t)((uint16_t)(diff << 1) ^ (uint16_t)((int16_t)diff >> 15));
+}
+
+static inline uint16_t unzigzag(uint16_t z)
+{
+  return (uint16_t)((z >> 1) ^ (uint16_t)(0U - (z & 1U)));
+}
+
+static inline uint8_t ring_byte(uint32_t offset)
+{
+  return hist_buf[(hist_tail + offset) % FEB_HIST_BUF_BYTES];
+}
+
+static void ring_put(uint32_t pos, uint8_t value)
+{
+  hist_buf[pos % FEB_HIST_BUF_BYTES] = value;
+}
+
+static uint16_t ring_u16(uint32_t offset)
+{
+  return (uint16_t)(ring_byte(offset) | ((uint16_t)ring_byte(offset + 1U) << 8));
+}
+
+static uint32_t ring_u32(uint32_t offset)
+{
+  return (uint32_t)ring_u16(offset) | ((uint32_t)ring_u16(offset + 2U) << 16);
+}
+
+// Drop the oldest record.
+static void evict_oldest(void)
+{
+  uint32_t size = FEB_HIST_HEADER_BYTES + ring_u16(4U);
+  hist_tail = (hist_tail + size) % FEB_HIST_BUF_BYTES;
+  hist_used -= size;
+  hist_records--;
+  hist_evicted++;
+}
+
+// ********************************** Encoder ************************************
+
+static void put_nibble(uint8_t nibble)
+{
+  uint32_t pos = hist_wr.start + FEB_HIST_HEADER_BYTES + (hist_wr.nibbles >> 1);
+  if ((hist_wr.nibbles & 1U) == 0U)
+  {
+    ring_put(pos, (uint8_t)(nibble << 4));
+  }
+  else
+  {
+    hist_buf[pos % FEB_HIST_BUF_BYTES] |= nibble;
+  }
+  hist_wr.nibbles++;
+}
+
+static void put_token(uint16_t z)
+{
+  if (z < 12U)
+  {
+    put_nibble((uint8_t)z);
+  }
+  else if (z < 28U)
+  {
+    put_nibble(0xC);
+    put_nibble((uint8_t)(z - 12U));
+  }
+  else if (z < 284U)
+  {
+    put_nibble(0xD);
+    put_nibble((uint8_t)((z - 28U) >> 4));
+    put_nibble((uint8_t)((z - 28U) & 0xFU));
+  }
+  else
+  {
+    put_nibble(0xE);
+    put_nibble((uint8_t)(z >> 12));
+    put_nibble((uint8_t)((z >> 8) & 0xFU));
+    put_nibble((uint8_t)((z >> 4) & 0xFU));
+    put_nibble((uint8_t)(z & 0xFU));
+  }
+}
+
+static void flush_zero_run(void)
+{
+  while (hist_wr.zero_run >= 2U)
+  {
+    uint16_t run = (hist_wr.zero_run > 17U) ? 17U : hist_wr.zero_run;
+    put_nibble(0xF);
+    put_nibble((uint8_t)(run - 2U));
+    hist_wr.zero_run -= run;
+  }
+  if (hist_wr.zero_run == 1U)
+  {
+    put_nibble(0x0);
+    hist_wr.zero_run = 0;
+  }
+}
+
+// ********************************** Writer *************************************
+
+void FEB_Cell_History_Init(void)
+{
+  memset(&hist_wr, 0, sizeof(hist_wr));
+  memset(hist_have_prev, 0, sizeof(hist_have_prev));
+  memset(hist_since_key, 0, sizeof(hist_since_key));
+  hist_tail = 0;
+  hist_used = 0;
+  hist_records = 0;
+  hist_evicted = 0;
+  hist_newest_tick = 0;
+  hist_frozen = false;
+  hist_freeze_tick = 0;
+  hist_freeze_flags = 0;
+}
+
+bool FEB_Cell_History_Begin(FEB_Hist_Kind_t kind, uint32_t tick, uint8_t flags)
+{
+  if (hist_frozen || hist_wr.open || kind >= FEB_HIST_KIND_COUNT)
+  {
+    return false;
+  }
+
+  const uint32_t worst = kind_worst_bytes(kind);
+  if (worst > FEB_HIST_BUF_BYTES)
+  {
+    return false;
+  }
+  while (FEB_HIST_BUF_BYTES - hist_used < worst)
+  {
+    evict_oldest();
+  }
+
+  hist_wr.open = true;
+  hist_wr.kind = kind;
+  hist_wr.key = !hist_have_prev[kind] || (hist_since_key[kind] + 1U >= FEB_HIST_KEYFRAME_INTERVAL);
+  hist_wr.flags = flags;
+  hist_wr.prev = kind_frame(kind, hist_prev_voltage, hist_prev_temp);
+  hist_wr.channels = kind_channels(kind);
+  hist_wr.count = 0;
+  hist_wr.zero_run = 0;
+  hist_wr.start = (hist_tail + hist_used) % FEB_HIST_BUF_BYTES;
+  hist_wr.nibbles = 0;
+  hist_wr.tick = tick;
+  return true;
+}
+
+void FEB_Cell_History_Push(uint16_t code)
+{
+  if (!hist_wr.open || hist_wr.count >= hist_wr.channels)
+  {
+    return;
+  }
+
+  uint16_t i = hist_wr.count++;
+  uint16_t ref;
+  if (hist_wr.key)
+  {
+    ref = (i == 0U) ? 0U : hist_wr.prev[i - 1U]; // Already this frame's value
+  }
+  else
+  {
+    ref = hist_wr.prev[i];
+  }
+  hist_wr.prev[i] = code;
+
+  uint16_t z = zigzag((uint16_t)(code - ref));
+  if (z == 0U)
+  {
+    hist_wr.zero_run++;
+    return;
+  }
+  flush_zero_run();
+  put_token(z);
+}
+
+void FEB_Cell_History_End(void)
+{
+  if (!hist_wr.open)
+  {
+    return;
+  }
+
+  // A short scan repeats the previous frame's values for the missing channels
+  while (hist_wr.count < hist_wr.channels)
+  {
+    FEB_Cell_History_Push(hist_wr.prev[hist_wr.count]);
+  }
+  flush_zero_run();
+
+  const uint32_t payload = (hist_wr.nibbles + 1U) >> 1;
+  const uint32_t h = hist_wr.start;
+  ring_put(h + 0U, (uint8_t)(FEB_HIST_TYPE_MARK | (hist_wr.key ? FEB_HIST_TYPE_KEY : 0U) | (uint8_t)hist_wr.kind));
+  ring_put(h + 1U, hist_wr.flags);
+  ring_put(h + 2U, (uint8_t)(hist_wr.channels & 0xFFU));
+  ring_put(h + 3U, (uint8_t)(hist_wr.channels >> 8));
+  ring_put(h + 4U, (uint8_t)(payload & 0xFFU));
+  ring_put(h + 5U, (uint8_t)(payload >> 8));
+  for (uint32_t b = 0; b < 4U; b++)
+  {
+    ring_put(h + 6U + b, (uint8_t)(hist_wr.tick >> (8U * b)));
+  }
+
+  hist_used += FEB_HIST_HEADER_BYTES + payload;
+  hist_records++;
+  hist_newest_tick = hist_wr.tick;
+  hist_have_prev[hist_wr.kind] = true;
+  hist_since_key[hist_wr.kind] = hist_wr.key ? 0U : (uint16_t)(hist_since_key[hist_wr.kind] + 1U);
+  hist_wr.open = false;
+}
+
+void FEB_Cell_History_Freeze(uint32_t tick, uint8_t flags)
+{
+  if (hist_frozen)
+  {
+    return;
+  }
+  hist_frozen = true;
+  hist_freeze_tick = tick;
+  hist_freeze_flags = flags;
+}
+
+void FEB_Cell_History_Rearm(void)
+{
+  FEB_Cell_History_Init();
+}
+
+bool FEB_Cell_History_Is_Frozen(void)
+{
+  return hist_frozen;
+}
+
+void FEB_Cell_History_Get_Stats(FEB_Cell_History_Stats_t *out)
+{
+  if (out == NULL)
+  {
+    return;
+  }
+  out->capacity_bytes = FEB_HIST_BUF_BYTES;
+  out->used_bytes = hist_used;
+  out->records = hist_records;
+  out->evicted = hist_evicted;
+  out->oldest_tick = (hist_records > 0U) ? ring_u32(6U) : 0U;
+  out->newest_tick = (hist_records > 0U) ? hist_newest_tick : 0U;
+  out->frozen = hist_frozen;
+  out->freeze_tick = hist_freeze_tick;
+  out->freeze_flags = hist_freeze_flags;
+}
+
+// ********************************** Reader *************************************
+
+uint32_t FEB_Cell_History_Read(uint32_t offset, uint8_t *dst, uint32_t len)
+{
+  if (offset >= hist_used)
+  {
+    return 0;
+  }
+  if (len > hist_used - offset)
+  {
+    len = hist_used - offset;
+  }
+
+  uint32_t start = (hist_tail + offset) % FEB_HIST_BUF_BYTES;
+  uint32_t first = FEB_HIST_BUF_BYTES - start;
+  if (first > len)
+  {
+    first = len;
+  }
+  memcpy(dst, &hist_buf[start], first);
+  memcpy(dst + first, hist_buf, len - first);
+  return len;
+}
+
+void FEB_Cell_History_Cursor_Init(FEB_Cell_History_Cursor_t *cur, const uint8_t *buf, uint32_t len)
+{
+  memset(cur->synced, 0, sizeof(cur->synced));
+  cur->buf = buf;
+  cur->pos = 0;
+  cur->end = (buf != NULL) ? len : hist_used;
+}
+
+static inline uint8_t cursor_byte(const FEB_Cell_History_Cursor_t *cur, uint32_t offset)
+{
+  return (cur->buf != NULL) ? cur->buf[offset] : ring_byte(offset);
+}
+
+static uint16_t cursor_u16(const FEB_Cell_History_Cursor_t *cur, uint32_t offset)
+{
+  return (uint16_t)(cursor_byte(cur, offset) | ((uint16_t)cursor_byte(cur, offset + 1U) << 8));
+}
+
+// Nibble reader over one record's payload; false once it runs past the end.
+typedef struct
+{
+  const FEB_Cell_History_Cursor_t *cur;
+  uint32_t base;
+  uint32_t nibbles;
+  uint32_t limit;
+} nibble_reader_t;
+
+static bool get_nibble(nibble_reader_t *r, uint8_t *out)
+{
+  if (r->nibbles >= r->limit)
+  {
+    return false;
+  }
+  uint8_t byte = cursor_byte(r->cur, r->base + (r->nibbles >> 1));
+  *out = ((r->nibbles & 1U) == 0U) ? (uint8_t)(byte >> 4) : (uint8_t)(byte & 0xFU);
+  r->nibbles++;
+  return true;
+}
+
+static bool get_nibbles(nibble_reader_t *r, int count, uint16_t *out)
+{
+  uint16_t v = 0;
+  for (int i = 0; i < count; i++)
+  {
+    uint8_t n;
+    if (!get_nibble(r, &n))
+    {
+      return false;
+    }
+    v = (uint16_t)((v << 4) | n);
+  }
+  *out = v;
+  return true;
+}
+
+bool FEB_Cell_History_Next(FEB_Cell_History_Cursor_t *cur, FEB_Cell_History_Record_t *rec)
+{
+  for (;;)
+  {
+    if (cur->end - cur->pos < FEB_HIST_HEADER_BYTES)
+    {
+      return false;
+    }
+
+    const uint32_t h = cur->pos;
+    const uint8_t type = cursor_byte(cur, h);
+    const FEB_Hist_Kind_t kind = (FEB_Hist_Kind_t)(type & FEB_HIST_TYPE_KIND_MASK);
+    const bool key = (type & FEB_HIST_TYPE_KEY) != 0U;
+    const uint16_t count = cursor_u16(cur, h + 2U);
+    const uint32_t payload = cursor_u16(cur, h + 4U);
+    if ((type & 0x70U) != FEB_HIST_TYPE_MARK || kind >= FEB_HIST_KIND_COUNT || count != kind_channels(kind) ||
+        payload > cur->end - h - FEB_HIST_HEADER_BYTES)
+    {
+      return false;
+    }
+    cur->pos = h + FEB_HIST_HEADER_BYTES + payload;
+
+    if (!key && !cur->synced[kind])
+    {
+      continue; // Reference frame was evicted
+    }
+
+    uint16_t *frame = kind_frame(kind, cur->voltage, cur->temp);
+    nibble_reader_t r = {.cur = cur, .base = h + FEB_HIST_HEADER_BYTES, .nibbles = 0, .limit = payload * 2U};
+    uint16_t zero_run = 0;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      uint16_t z = 0;
+      if (zero_run > 0U)
+      {
+        zero_run--;
+      }
+      else
+      {
+        uint16_t t;
+        bool ok = get_nibbles(&r, 1, &t);
+        if (ok && t == 0xCU)
+        {
+          ok = get_nibbles(&r, 1, &z);
+          z = (uint16_t)(z + 12U);
+        }
+        else if (ok && t == 0xDU)
+        {
+          ok = get_nibbles(&r, 2, &z);
+          z = (uint16_t)(z + 28U);
+        }
+        else if (ok && t == 0xEU)
+        {
+          ok = get_nibbles(&r, 4, &z);
+        }
+        else if (ok && t == 0xFU)
+        {
+          ok = get_nibbles(&r, 1, &zero_run);
+          zero_run = (uint16_t)(zero_run + 1U); // n+2 zeros, this one included
+        }
+        else
+        {
+          z = t;
+        }
+        if (!ok)
+        {
+          cur->synced[kind] = false;
+          return false;
+        }
+      }
+
+      uint16_t ref = key ? ((i == 0U) ? 0U : frame[i - 1U]) : frame[i];
+      frame[i] = (uint16_t)(ref + unzigzag(z));
+    }
+
+    cur->synced[kind] = true;
+    rec->kind = kind;
+    rec->key = key;
+    rec->flags = cursor_byte(cur, h + 1U);
+    rec->count = count;
+    rec->tick = (uint32_t)cursor_u16(cur, h + 6U) | ((uint32_t)cursor_u16(cur, h + 8U) << 16);
+    rec->values = frame;
+    return true;
+  }
+}
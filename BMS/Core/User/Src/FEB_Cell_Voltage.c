@@ -0,0 +1,123 @@
+#include "FEB_Cell_Voltage.h"
+
+#include <stdbool.h>
+
+// ********************************** Helper Functions ***************************
+
+// Limit check for one cell; returns true while the cell is out of range.
+static bool check_cell(cell_data_t *cell, int32_t uV_C, int32_t uV_S, int32_t vMin_uV, int32_t vMax_uV,
+                       bool *latched)
+{
+  /* Per-ADC bench overrides (FEB_BMS_DISABLE_*_VOLT_CHECKS in FEB_Const.h):
+   * the normal rule is "primary (C) triggers, secondary (S) confirms" —
+   * both must be out of range. A disabled side is removed from the
+   * judgment; with both disabled the normal rule still counts violations
+   * and the caller's latch hook decides what to do with them. */
+  const bool primary_bad = (uV_C > vMax_uV || uV_C < vMin_uV);
+  const bool secondary_bad = (uV_S > vMax_uV || uV_S < vMin_uV);
+#if FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && !FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
+  const bool violation = secondary_bad;
+  (void)primary_bad;
+#elif !FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
+  const bool violation = primary_bad;
+  (void)secondary_bad;
+#else
+  const bool violation = primary_bad && secondary_bad;
+#endif
+
+  *latched = false;
+  if (!violation)
+  {
+    cell->violations = 0;
+    return false;
+  }
+
+  /* Saturating increment (counter is uint8_t — a free-running += would
+   * wrap at 255); the hook fires exactly once, on the crossing scan. */
+  if (cell->violations < FEB_VOLTAGE_ERROR_THRESH)
+  {
+    cell->violations += 1;
+    *latched = (cell->violations >= FEB_VOLTAGE_ERROR_THRESH);
+  }
+  return true;
+}
+
+// ********************************** Functions **********************************
+
+void FEB_Cell_Voltage_Process(accumulator_t *acc, const cell_asic *ics, int32_t vMin_uV, int32_t vMax_uV,
+                              FEB_Cell_Voltage_Latch_t on_latch)
+{
+  int32_t total_uV = 0;
+  int32_t min_uV = INT32_MAX;
+  int32_t max_uV = INT32_MIN;
+  uint16_t min_cell = 0;
+  uint16_t max_cell = 0;
+  uint16_t cells_read = 0;
+  uint16_t cells_violating = 0;
+
+  for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
+  {
+    uint8_t bad_reads = 0;
+
+    for (uint8_t ic = 0; ic < FEB_NUM_ICPBANK; ic++)
+    {
+      const cv *regs = &ics[ic + bank * FEB_NUM_ICPBANK].cells;
+
+      for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_IC; cell++)
+      {
+        const uint8_t bank_cell = cell + ic * FEB_NUM_CELLS_PER_IC;
+        const uint16_t idx = bank * FEB_NUM_CELLS_PER_BANK + bank_cell;
+
+        // PEC error for this cell's register group (3 cells per register):
+        // count it and keep the last good code for the limit check.
+        if (regs->pec_match[cell / 3] != 0)
+        {
+          bad_reads++;
+        }
+        else
+        {
+          acc->cell_c_codes[idx] = (int16_t)regs->c_codes[cell];
+          acc->cell_s_codes[idx] = (int16_t)regs->s_codes[cell];
+
+          const int32_t uV = ADBMS_CODE_TO_UV(acc->cell_c_codes[idx]);
+          total_uV += uV;
+          cells_read++;
+          if (uV >= 0)
+          {
+            if (uV < min_uV)
+            {
+              min_uV = uV;
+              min_cell = idx;
+            }
+            if (uV > max_uV)
+            {
+              max_uV = uV;
+              max_cell = idx;
+            }
+          }
+        }
+
+        const int32_t uV_C = ADBMS_CODE_TO_UV(acc->cell_c_codes[idx]);
+        const int32_t uV_S = ADBMS_CODE_TO_UV(acc->cell_s_codes[idx]);
+        bool latched;
+        if (check_cell(&acc->banks[bank].cells[bank_cell], uV_C, uV_S, vMin_uV, vMax_uV, &latched))
+        {
+          cells_violating++;
+          if (latched && on_latch != NULL)
+          {
+            on_latch(bank, bank_cell, uV_C, uV_S);
+          }
+        }
+      }
+    }
+    acc->banks[bank].badReadV = bad_reads;
+  }
+
+  acc->total_voltage_uV = total_uV;
+  acc->pack_min_voltage_uV = min_uV;
+  acc->pack_max_voltage_uV = max_uV;
+  acc->pack_min_cell = min_cell;
+  acc->pack_max_cell = max_cell;
+  acc->cells_read = cells_read;
+  acc->cells_violating = cells_violating;
+}
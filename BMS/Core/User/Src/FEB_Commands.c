@@ -19,20 +19,26 @@
 #include "feb_console.h"
 #include "feb_log.h"
 #include "feb_string_utils.h"
+#include "feb_can_ext_frames.h"
 #include "FEB_ADBMS6830B.h"
 #include "ADBMS6830B_Registers.h"
 #include "FEB_CAN_Charger.h"
 #include "FEB_CAN_IVT.h"
 #include "FEB_CAN_PingPong.h"
 #include "FEB_CAN_State.h"
+#include "FEB_CAN_History.h"
+#include "FEB_Cell_History.h"
 #include "FEB_Const.h"
 #include "FEB_HW_Relay.h"
 #include "FEB_SM.h"
+#include "FEB_SOC.h"
+#include "FEB_Thermistor.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "cmsis_os.h"
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -838,6 +844,11 @@ static void print_bms_help(void)
   FEB_Console_Printf("  BMS|spi                 - Show isoSPI status\r\n");
   FEB_Console_Printf("  BMS|errors              - Show error summary\r\n");
   FEB_Console_Printf("  BMS|config              - Show configuration\r\n");
+  FEB_Console_Printf("  BMS|tempscan[|reset]    - Temperature sweep phase timing\r\n");
+  FEB_Console_Printf("  BMS|faultlat[|reset]    - Fault detect / relay-open latency\r\n");
+  FEB_Console_Printf("  BMS|hist[|<action>]     - Cell history ring: freeze, rearm, print,\r\n");
+  FEB_Console_Printf("                            dump (hex), can (stream on 0x0E4)\r\n");
+  FEB_Console_Printf("  BMS|soc[|reset]         - SOC / pack resistance estimate\r\n");
   FEB_Console_Printf("\r\n");
   FEB_Console_Printf("Register Access:\r\n");
   FEB_Console_Printf("  BMS|reg|list            - List all ADBMS commands\r\n");
@@ -856,7 +867,8 @@ static void print_bms_help(void)
   FEB_Console_Printf("CSV Protocol (machine-readable):\r\n");
   FEB_Console_Printf("  BMS|csv|<tx_id>|<sub>   - CSV-capable subs: status, cells, temps,\r\n");
   FEB_Console_Printf("                            therm-raw, state, gpio, ivt, tasks, mem,\r\n");
-  FEB_Console_Printf("                            errors, config, canstatus, cell-stats\r\n");
+  FEB_Console_Printf("                            errors, config, canstatus, cell-stats,\r\n");
+  FEB_Console_Printf("                            tempscan, faultlat, hist, soc\r\n");
   FEB_Console_Printf("  BMS|csv|<tx_id>|cell-stats - Voltages + temps (per cell / per sensor)\r\n");
   FEB_Console_Printf("  *|csv|<tx_id>|hello     - Discover all boards (system command)\r\n");
   FEB_Console_Printf("Each request emits: ack -> [rows] -> done\r\n");
@@ -1159,12 +1171,431 @@ static void subcmd_volts(int argc, char *argv[])
   }
 }
 
+/* ============================================================================
+ * Subcommand: tempscan - Pipelined temperature sweep phase timing
+ *
+ * Phase rows are totals over the 7 MUX channels of one sweep. "Mutex held" is
+ * what the sweep costs other ADBMSMutexHandle users; "Sweep" is what
+ * FEB_TEMP_SCAN_PERIOD_MS has to cover.
+ * ============================================================================ */
+static const char *const temp_phase_names[FEB_TEMP_PHASE_COUNT] = {"select", "wait", "read", "decode", "finalize"};
+
+static void subcmd_tempscan(int argc, char *argv[])
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_ADBMS_Reset_Temp_Scan_Stats();
+    FEB_Console_Printf("Temperature scan timing reset\r\n");
+    return;
+  }
+
+  FEB_ADBMS_Temp_Scan_Stats_t st;
+  FEB_ADBMS_Get_Temp_Scan_Stats(&st);
+
+  FEB_Console_Printf("\r\n=== Temperature Scan Timing (%lu sweeps) ===\r\n", (unsigned long)st.scans);
+  FEB_Console_Printf("%-12s %10s %10s\r\n", "Phase", "Last(us)", "Max(us)");
+  for (int p = 0; p < FEB_TEMP_PHASE_COUNT; p++)
+  {
+    FEB_Console_Printf("%-12s %10lu %10lu\r\n", temp_phase_names[p], (unsigned long)st.last_us[p],
+                       (unsigned long)st.max_us[p]);
+  }
+  FEB_Console_Printf("%-12s %10lu %10lu\r\n", "Mutex held", (unsigned long)st.locked_last_us,
+                     (unsigned long)st.locked_max_us);
+  FEB_Console_Printf("%-12s %10s %10lu\r\n", "Longest hold", "-", (unsigned long)st.hold_max_us);
+  FEB_Console_Printf("%-12s %10lu %10lu\r\n", "Sweep", (unsigned long)st.scan_last_us,
+                     (unsigned long)st.scan_max_us);
+  FEB_Console_Printf("Scan period: %d ms\r\n", FEB_TEMP_SCAN_PERIOD_MS);
+}
+
 /* ----------------------------------------------------------------------------
  * CSV handlers for the remaining diagnostic subcommands. Each mirrors the
  * fields its text handler prints, comma-separated with no human labels, so CSV
  * hosts can drive every BMS command. ack / done framing is automatic.
  * -------------------------------------------------------------------------- */
 
+/* tempscan,<phase>,<last_us>,<max_us> per phase, then held/sweep/period rows.
+ * `tempscan|reset` zeroes the counters and emits nothing. */
+static void cmd_tempscan_csv(int argc, char *argv[])
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_ADBMS_Reset_Temp_Scan_Stats();
+    return;
+  }
+
+  FEB_ADBMS_Temp_Scan_Stats_t st;
+  FEB_ADBMS_Get_Temp_Scan_Stats(&st);
+  for (int p = 0; p < FEB_TEMP_PHASE_COUNT; p++)
+  {
+    FEB_Console_CsvEmit("tempscan", "%s,%u,%u", temp_phase_names[p], (unsigned)st.last_us[p], (unsigned)st.max_us[p]);
+  }
+  FEB_Console_CsvEmit("tempscan", "held,%u,%u", (unsigned)st.locked_last_us, (unsigned)st.locked_max_us);
+  FEB_Console_CsvEmit("tempscan", "hold,,%u", (unsigned)st.hold_max_us);
+  FEB_Console_CsvEmit("tempscan", "sweep,%u,%u", (unsigned)st.scan_last_us, (unsigned)st.scan_max_us);
+  FEB_Console_CsvEmit("tempscan", "sweeps,%u,%d", (unsigned)st.scans, FEB_TEMP_SCAN_PERIOD_MS);
+}
+
+/* ============================================================================
+ * Subcommand: faultlat - Fault detection / relay-open latency histograms
+ *
+ * Per fault type, "detect" is data sample -> fault_begin() and "open" is
+ * fault_begin() -> BMS shutdown relay commanded open, both in FEB_Time_Us()
+ * microseconds. Bucket b counts latencies in [2^(b-1), 2^b) us; only non-empty
+ * buckets are listed.
+ * ============================================================================ */
+static const BMS_State_t faultlat_types[] = {BMS_STATE_FAULT_BMS, BMS_STATE_FAULT_BSPD, BMS_STATE_FAULT_IMD,
+                                             BMS_STATE_FAULT_CHARGING};
+static const char *const faultlat_stage_names[FEB_SM_LAT_STAGE_COUNT] = {"detect", "open"};
+#define FAULTLAT_TYPE_COUNT (sizeof(faultlat_types) / sizeof(faultlat_types[0]))
+
+/* Lower edge of a latency bucket in us */
+static uint32_t faultlat_bucket_lo(int b)
+{
+  return (b == 0) ? 0U : (1UL << (b - 1));
+}
+
+static void subcmd_faultlat(int argc, char *argv[])
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_SM_Reset_Fault_Latency();
+    FEB_Console_Printf("Fault latency histograms reset\r\n");
+    return;
+  }
+
+  FEB_Console_Printf("\r\n=== Fault Latency (us) ===\r\n");
+  FEB_Console_Printf("Events: adbms=%lu ivt=%lu\r\n", (unsigned long)FEB_SM_Get_Event_Count(FEB_SM_EVENT_ADBMS),
+                     (unsigned long)FEB_SM_Get_Event_Count(FEB_SM_EVENT_IVT));
+  FEB_Console_Printf("%-16s %-7s %6s %8s %8s %8s\r\n", "Fault", "Stage", "Count", "Min", "Avg", "Max");
+  for (size_t t = 0; t < FAULTLAT_TYPE_COUNT; t++)
+  {
+    for (int st = 0; st < FEB_SM_LAT_STAGE_COUNT; st++)
+    {
+      FEB_SM_Lat_Hist_t h;
+      FEB_SM_Get_Fault_Latency(faultlat_types[t], (FEB_SM_Lat_Stage_t)st, &h);
+      if (h.count == 0)
+      {
+        continue;
+      }
+      FEB_Console_Printf("%-16s %-7s %6lu %8lu %8lu %8lu\r\n", FEB_CAN_State_GetStateName(faultlat_types[t]),
+                         faultlat_stage_names[st], (unsigned long)h.count, (unsigned long)h.min_us,
+                         (unsigned long)(h.sum_us / h.count), (unsigned long)h.max_us);
+      for (int b = 0; b < FEB_SM_LAT_BUCKETS; b++)
+      {
+        if (h.bucket[b] == 0)
+        {
+          continue;
+        }
+        if (b == FEB_SM_LAT_BUCKETS - 1)
+        {
+          FEB_Console_Printf("    %8lu+         %lu\r\n", (unsigned long)faultlat_bucket_lo(b), (unsigned long)h.bucket[b]);
+        }
+        else
+        {
+          FEB_Console_Printf("    %8lu-%-8lu %lu\r\n", (unsigned long)faultlat_bucket_lo(b),
+                             (unsigned long)(faultlat_bucket_lo(b + 1) - 1U), (unsigned long)h.bucket[b]);
+        }
+      }
+    }
+  }
+}
+
+/* faultlat,<fault>,<stage>,<count>,<min_us>,<avg_us>,<max_us>,<b0>,...,<b19> per
+ * fault type and stage, then events,<adbms>,<ivt>. `faultlat|reset` zeroes the
+ * histograms and emits nothing. */
+static void cmd_faultlat_csv(int argc, char *argv[])
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_SM_Reset_Fault_Latency();
+    return;
+  }
+
+  for (size_t t = 0; t < FAULTLAT_TYPE_COUNT; t++)
+  {
+    for (int st = 0; st < FEB_SM_LAT_STAGE_COUNT; st++)
+    {
+      FEB_SM_Lat_Hist_t h;
+      FEB_SM_Get_Fault_Latency(faultlat_types[t], (FEB_SM_Lat_Stage_t)st, &h);
+      char buckets[FEB_SM_LAT_BUCKETS * 11 + 1];
+      size_t len = 0;
+      for (int b = 0; b < FEB_SM_LAT_BUCKETS; b++)
+      {
+        len += (size_t)snprintf(buckets + len, sizeof(buckets) - len, ",%lu", (unsigned long)h.bucket[b]);
+      }
+      FEB_Console_CsvEmit("faultlat", "%s,%s,%lu,%lu,%lu,%lu%s", FEB_CAN_State_GetStateName(faultlat_types[t]),
+                          faultlat_stage_names[st], (unsigned long)h.count, (unsigned long)h.min_us,
+                          (unsigned long)(h.count ? h.sum_us / h.count : 0), (unsigned long)h.max_us, buckets);
+    }
+  }
+  FEB_Console_CsvEmit("faultlat", "events,%lu,%lu", (unsigned long)FEB_SM_Get_Event_Count(FEB_SM_EVENT_ADBMS),
+                      (unsigned long)FEB_SM_Get_Event_Count(FEB_SM_EVENT_IVT));
+}
+
+/* ============================================================================
+ * Subcommand: hist - Per-cell history ring (FEB_Cell_History)
+ *
+ * The ring records every voltage and thermistor scan and freezes itself on a
+ * latched ADBMS fault or a BMS fault state. dump/print/can freeze it first so
+ * they read a stable ring without holding the ADBMS mutex; rearm discards the
+ * contents and resumes recording (it refreezes at the next scan while a fault
+ * is still latched).
+ * ============================================================================ */
+#define HIST_DUMP_LINE_BYTES 32U
+
+/* Decoder state is ~1.1 KB: keep it off the console task stack */
+static FEB_Cell_History_Cursor_t hist_cursor;
+
+static void hist_print_stats(const FEB_Cell_History_Stats_t *st)
+{
+  FEB_Console_Printf("\r\n=== Cell History ===\r\n");
+  FEB_Console_Printf("Used:     %lu / %lu bytes, %lu records (%lu evicted)\r\n", (unsigned long)st->used_bytes,
+                     (unsigned long)st->capacity_bytes, (unsigned long)st->records, (unsigned long)st->evicted);
+  FEB_Console_Printf("Span:     %lu - %lu ms (%lu ms)\r\n", (unsigned long)st->oldest_tick,
+                     (unsigned long)st->newest_tick, (unsigned long)(st->newest_tick - st->oldest_tick));
+  if (st->frozen)
+  {
+    FEB_Console_Printf("State:    FROZEN at %lu ms, flags=0x%02X%s\r\n", (unsigned long)st->freeze_tick,
+                       st->freeze_flags, st->freeze_flags ? "" : " (manual)");
+  }
+  else
+  {
+    FEB_Console_Printf("State:    recording\r\n");
+  }
+}
+
+/* Min/max of a decoded record in engineering units; returns false if every channel is invalid */
+static bool hist_record_range(const FEB_Cell_History_Record_t *rec, int32_t *lo, int32_t *hi)
+{
+  bool any = false;
+  for (uint16_t i = 0; i < rec->count; i++)
+  {
+    int32_t v;
+    if (rec->kind == FEB_HIST_KIND_VOLTAGE)
+    {
+      v = ADBMS_CODE_TO_UV((int16_t)rec->values[i]) / 1000; /* mV */
+    }
+    else
+    {
+      if (rec->values[i] == 0xFFFF)
+      {
+        continue;
+      }
+      v = FEB_Thermistor_Code_To_Temp_dC((int16_t)rec->values[i]); /* 0.1 degC */
+    }
+    if (!any || v < *lo)
+    {
+      *lo = v;
+    }
+    if (!any || v > *hi)
+    {
+      *hi = v;
+    }
+    any = true;
+  }
+  return any;
+}
+
+/* Fixed-point value (scale 10 or 1000) as "[-]int.frac" */
+static void hist_fmt_fixed(char *buf, size_t len, int32_t v, int32_t scale)
+{
+  int32_t mag = (v < 0) ? -v : v;
+  snprintf(buf, len, "%s%ld.%0*ld", (v < 0) ? "-" : "", (long)(mag / scale), (scale == 10) ? 1 : 3,
+           (long)(mag % scale));
+}
+
+static void hist_print_records(void)
+{
+  FEB_Cell_History_Record_t rec;
+  uint32_t n = 0;
+
+  FEB_Cell_History_Cursor_Init(&hist_cursor, NULL, 0);
+  FEB_Console_Printf("%10s %-4s %s %5s %5s %9s %9s\r\n", "Tick", "Kind", "K", "Flags", "Chans", "Min", "Max");
+  while (FEB_Cell_History_Next(&hist_cursor, &rec))
+  {
+    bool volt = (rec.kind == FEB_HIST_KIND_VOLTAGE);
+    int32_t scale = volt ? 1000 : 10;
+    int32_t lo = 0;
+    int32_t hi = 0;
+    char lo_s[16] = "--";
+    char hi_s[16] = "--";
+    if (hist_record_range(&rec, &lo, &hi))
+    {
+      hist_fmt_fixed(lo_s, sizeof(lo_s), lo, scale);
+      hist_fmt_fixed(hi_s, sizeof(hi_s), hi, scale);
+    }
+    FEB_Console_Printf("%10lu %-4s %c  0x%02X %5u %9s %9s %s\r\n", (unsigned long)rec.tick, volt ? "volt" : "temp",
+                       rec.key ? 'K' : 'D', rec.flags, rec.count, lo_s, hi_s, volt ? "V" : "C");
+    n++;
+  }
+  FEB_Console_Printf("%lu records decoded\r\n", (unsigned long)n);
+}
+
+/* Raw ring bytes, oldest record first, 32 per line/row with their offset;
+ * decode off-board with FEB_Cell_History_Cursor_Init(buf, len) */
+static void hist_dump_hex(uint32_t used, bool csv)
+{
+  uint8_t chunk[HIST_DUMP_LINE_BYTES];
+  char line[HIST_DUMP_LINE_BYTES * 2 + 1];
+
+  for (uint32_t off = 0; off < used; off += HIST_DUMP_LINE_BYTES)
+  {
+    uint32_t n = FEB_Cell_History_Read(off, chunk, HIST_DUMP_LINE_BYTES);
+    for (uint32_t i = 0; i < n; i++)
+    {
+      snprintf(&line[i * 2], 3, "%02X", chunk[i]);
+    }
+    line[n * 2] = '\0';
+    if (csv)
+    {
+      FEB_Console_CsvEmit("hist", "data,%lu,%s", (unsigned long)off, line);
+    }
+    else
+    {
+      FEB_Console_Printf("%05lu: %s\r\n", (unsigned long)off, line);
+    }
+  }
+}
+
+static void subcmd_hist(int argc, char *argv[])
+{
+  FEB_Cell_History_Stats_t st;
+  const char *action = (argc >= 2) ? argv[1] : "";
+
+  if (FEB_strcasecmp(action, "freeze") == 0)
+  {
+    FEB_ADBMS_History_Freeze();
+    FEB_Console_Printf("History frozen\r\n");
+    return;
+  }
+  if (FEB_strcasecmp(action, "rearm") == 0)
+  {
+    FEB_CAN_History_Stop();
+    FEB_ADBMS_History_Rearm();
+    FEB_Console_Printf("History cleared and recording\r\n");
+    return;
+  }
+  if (FEB_strcasecmp(action, "can") == 0)
+  {
+    FEB_ADBMS_History_Freeze();
+    if (FEB_CAN_History_Start())
+    {
+      FEB_Cell_History_Get_Stats(&st);
+      FEB_Console_Printf("Streaming %lu bytes on 0x%03X (~%lu ms)\r\n", (unsigned long)st.used_bytes,
+                         (unsigned)FEB_CAN_EXT_BMS_HIST_FRAME_ID,
+                         (unsigned long)(st.used_bytes / FEB_CAN_EXT_BMS_HIST_CHUNK + 2U));
+    }
+    else
+    {
+      FEB_Console_Printf("History is empty\r\n");
+    }
+    return;
+  }
+
+  if (FEB_strcasecmp(action, "dump") == 0 || FEB_strcasecmp(action, "print") == 0)
+  {
+    FEB_ADBMS_History_Freeze();
+  }
+  FEB_Cell_History_Get_Stats(&st);
+  hist_print_stats(&st);
+
+  uint32_t sent;
+  uint32_t total;
+  if (FEB_CAN_History_Get_Progress(&sent, &total))
+  {
+    FEB_Console_Printf("CAN dump: %lu / %lu bytes\r\n", (unsigned long)sent, (unsigned long)total);
+  }
+
+  if (FEB_strcasecmp(action, "dump") == 0)
+  {
+    hist_dump_hex(st.used_bytes, false);
+  }
+  else if (FEB_strcasecmp(action, "print") == 0)
+  {
+    hist_print_records();
+  }
+}
+
+/* hist,stats,<used>,<capacity>,<records>,<evicted>,<oldest_ms>,<newest_ms>,<frozen>,<freeze_ms>,<freeze_flags>,
+ * then for `hist|dump` one hist,data,<offset>,<hex> row per 32 bytes. freeze/rearm/dump act as in the text
+ * command. */
+static void cmd_hist_csv(int argc, char *argv[])
+{
+  FEB_Cell_History_Stats_t st;
+  const char *action = (argc >= 2) ? argv[1] : "";
+  bool dump = FEB_strcasecmp(action, "dump") == 0;
+
+  if (dump || FEB_strcasecmp(action, "freeze") == 0)
+  {
+    FEB_ADBMS_History_Freeze();
+  }
+  else if (FEB_strcasecmp(action, "rearm") == 0)
+  {
+    FEB_CAN_History_Stop();
+    FEB_ADBMS_History_Rearm();
+  }
+
+  FEB_Cell_History_Get_Stats(&st);
+  FEB_Console_CsvEmit("hist", "stats,%lu,%lu,%lu,%lu,%lu,%lu,%d,%lu,%u", (unsigned long)st.used_bytes,
+                      (unsigned long)st.capacity_bytes, (unsigned long)st.records, (unsigned long)st.evicted,
+                      (unsigned long)st.oldest_tick, (unsigned long)st.newest_tick, st.frozen ? 1 : 0,
+                      (unsigned long)st.freeze_tick, (unsigned)st.freeze_flags);
+  if (dump)
+  {
+    hist_dump_hex(st.used_bytes, true);
+  }
+}
+
+/* ============================================================================
+ * Subcommand: soc - SOC / pack resistance estimator (FEB_SOC)
+ * ============================================================================ */
+static void subcmd_soc(int argc, char *argv[])
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_ADBMS_Reset_SOC();
+    FEB_Console_Printf("SOC estimator reset: reseeds from OCV at the next voltage scan\r\n");
+    return;
+  }
+
+  FEB_ADBMS_SOC_t est;
+  FEB_ADBMS_Get_SOC(&est);
+  FEB_Console_Printf("\r\n=== SOC Estimator ===\r\n");
+  if (!(est.flags & FEB_SOC_FLAG_VALID))
+  {
+    FEB_Console_Printf("No voltage scan yet\r\n");
+    return;
+  }
+  FEB_Console_Printf("SOC:       %.2f %%%s\r\n", est.soc * 100.0f,
+                     (est.flags & FEB_SOC_FLAG_NO_CURRENT) ? " (held: IVT stale)"
+                     : (est.flags & FEB_SOC_FLAG_AT_REST) ? " (OCV correction)"
+                                                          : "");
+  FEB_Console_Printf("R_pack:    %.1f mOhm (%s, %lu updates)\r\n", est.r_ohm * 1000.0f,
+                     (est.flags & FEB_SOC_FLAG_R_CONVERGED) ? "converged" : "settling",
+                     (unsigned long)est.rls_updates);
+  FEB_Console_Printf("Pack OCV:  %.1f V\r\n", est.pack_ocv_V);
+  FEB_Console_Printf("Net out:   %.3f Ah of %.1f Ah\r\n", est.ah_out, FEB_SOC_PACK_CAPACITY_AH);
+  FEB_Console_Printf("Step cost: %lu us (max %lu us)\r\n", (unsigned long)est.step_last_us,
+                     (unsigned long)est.step_max_us);
+}
+
+/* soc,<soc_pct>,<r_mohm>,<ocv_V>,<ah_out>,<rls_updates>,<flags>,<step_us>,<step_max_us>.
+ * `soc|reset` reseeds the estimator and emits nothing. */
+static void cmd_soc_csv(int argc, char *argv[])
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_ADBMS_Reset_SOC();
+    return;
+  }
+
+  FEB_ADBMS_SOC_t est;
+  FEB_ADBMS_Get_SOC(&est);
+  FEB_Console_CsvEmit("soc", "%.2f,%.1f,%.1f,%.3f,%lu,%u,%lu,%lu", est.soc * 100.0f, est.r_ohm * 1000.0f,
+                      est.pack_ocv_V, est.ah_out, (unsigned long)est.rls_updates, (unsigned)est.flags,
+                      (unsigned long)est.step_last_us, (unsigned long)est.step_max_us);
+}
+
 static void cmd_balance_csv(int argc, char *argv[])
 {
   if (argc < 2)
@@ -1446,6 +1877,26 @@ static const FEB_Console_Cmd_t bms_volts_cmd = {.name = "volts",
                                                 .handler = subcmd_volts,
                                                 .csv_handler = cmd_volts_csv,
                                                 .hidden = true};
+static const FEB_Console_Cmd_t bms_tempscan_cmd = {.name = "tempscan",
+                                                   .help = "Temperature sweep phase timing (tempscan[|reset])",
+                                                   .handler = subcmd_tempscan,
+                                                   .csv_handler = cmd_tempscan_csv,
+                                                   .hidden = true};
+static const FEB_Console_Cmd_t bms_faultlat_cmd = {.name = "faultlat",
+                                                   .help = "Fault detect / relay-open latency (faultlat[|reset])",
+                                                   .handler = subcmd_faultlat,
+                                                   .csv_handler = cmd_faultlat_csv,
+                                                   .hidden = true};
+static const FEB_Console_Cmd_t bms_hist_cmd = {.name = "hist",
+                                               .help = "Cell history ring (hist[|freeze|rearm|print|dump|can])",
+                                               .handler = subcmd_hist,
+                                               .csv_handler = cmd_hist_csv,
+                                               .hidden = true};
+static const FEB_Console_Cmd_t bms_soc_cmd = {.name = "soc",
+                                              .help = "SOC / pack resistance estimate (soc[|reset])",
+                                              .handler = subcmd_soc,
+                                              .csv_handler = cmd_soc_csv,
+                                              .hidden = true};
 static const FEB_Console_Cmd_t bms_charger_cmd = {.name = "charger",
                                                   .help = "Charger status (latest RX + command)",
                                                   .handler = subcmd_charger,
@@ -1459,7 +1910,8 @@ static const FEB_Console_Cmd_t *const BMS_SUBCMDS[] = {
     &bms_status_cmd,     &bms_cells_cmd,  &bms_temps_cmd, &bms_therm_raw_cmd, &bms_state_cmd,   &bms_balance_cmd,
     &bms_gpio_cmd,       &bms_ivt_cmd,    &bms_tasks_cmd, &bms_mem_cmd,       &bms_cell_cmd,    &bms_spi_cmd,
     &bms_errors_cmd,     &bms_config_cmd, &bms_ping_cmd,  &bms_pong_cmd,      &bms_canstop_cmd, &bms_canstatus_cmd,
-    &bms_cell_stats_cmd, &bms_reg_cmd,    &bms_volts_cmd, &bms_charger_cmd,
+    &bms_cell_stats_cmd, &bms_reg_cmd,    &bms_volts_cmd, &bms_charger_cmd,   &bms_tempscan_cmd, &bms_faultlat_cmd,
+    &bms_hist_cmd,       &bms_soc_cmd,
 };
 #define BMS_SUBCMDS_COUNT (sizeof(BMS_SUBCMDS) / sizeof(BMS_SUBCMDS[0]))
 
@@ -16,7 +16,10 @@ spi_redundancy_state_t g_spi_redundancy = {0};
 // Perform the actual failover operation
 static void perform_failover(void)
 {
-  // Swap active and backup channels
+  // Swap active and backup channels. The async isoSPI transport latches the
+  // handle/port/pin trio when it queues a frame; the critical section keeps
+  // it from ever latching a half-swapped set.
+  taskENTER_CRITICAL();
   SPI_HandleTypeDef *temp_spi = g_spi_redundancy.active_spi;
   g_spi_redundancy.active_spi = g_spi_redundancy.backup_spi;
   g_spi_redundancy.backup_spi = temp_spi;
@@ -28,6 +31,7 @@ static void perform_failover(void)
   uint16_t temp_pin = g_spi_redundancy.active_cs_pin;
   g_spi_redundancy.active_cs_pin = g_spi_redundancy.backup_cs_pin;
   g_spi_redundancy.backup_cs_pin = temp_pin;
+  taskEXIT_CRITICAL();
 
   // Update channel indicator
   g_spi_redundancy.current_channel = (g_spi_redundancy.current_channel == 0) ? 1 : 0;
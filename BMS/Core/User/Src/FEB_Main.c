@@ -15,6 +15,7 @@
 #include "FEB_Commands.h"
 #include "FEB_CAN_State.h"
 #include "FEB_CAN_PingPong.h"
+#include "FEB_CAN_History.h"
 #include "FEB_CAN_Charger.h"
 #include "FEB_SM.h"
 #include "FEB_Const.h"
@@ -87,6 +88,10 @@ void FEB_Init(void)
       .get_tick_ms = HAL_GetTick,
 #if FEB_LOG_USE_FREERTOS
       .mutex = logMutexHandle,
+#endif
+#if FEB_LOG_DEFERRED
+      /* Call sites only record; the low-priority StartLogTask formats and prints */
+      .deferred = true,
 #endif
   };
   FEB_Log_Init(&log_cfg);
@@ -184,22 +189,52 @@ void StartUartRxTask(void *argument)
   }
 }
 
+void StartLogTask(void *argument)
+{
+  (void)argument;
+
+  /* Lowest-priority consumer of the deferred log ring: formatting and UART
+   * output never preempt the SM / ADBMS / console tasks. The first pass prints
+   * what FEB_Init() recorded before the scheduler started. */
+  for (;;)
+  {
+    FEB_Log_Process();
+    osDelay(10);
+  }
+}
+
 void StartSMTask(void *argument)
 {
   (void)argument;
   static uint16_t pingpong_divider = 0;
+  uint32_t last_tick = HAL_GetTick();
 
   for (;;)
   {
-    /* Wait for notification from ISR (1ms tick) */
+    /* Wait for notification from ISR (1ms tick) or from a fault event
+     * (FEB_SM_Notify_Event: ADBMS task, IVT RX callback) */
     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
+    /* Fault events are evaluated as soon as they arrive */
+    FEB_SM_Process_Events();
+
+    /* Everything below is periodic: skip it on an event-only wake */
+    uint32_t tick = HAL_GetTick();
+    if (tick == last_tick)
+    {
+      continue;
+    }
+    last_tick = tick;
+
     /* State machine processing */
     FEB_SM_Process();
 
     /* CAN state publishing (every 100ms via internal divider in function) */
     FEB_CAN_State_Tick();
 
+    /* Frozen cell history dump, one frame per tick while requested */
+    FEB_CAN_History_Tick();
+
     /* PingPong + charger command tick every 100ms */
     pingpong_divider++;
     if (pingpong_divider >= 100)
@@ -25,8 +25,15 @@
 #include "feb_log.h"
 #include "feb_time.h"
 #include "stm32f4xx_hal.h"
+#include "cmsis_os.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include <math.h>
 #include <stdbool.h>
+#include <string.h>
+
+/* SM task handle (freertos.c): fault events notify it directly */
+extern osThreadId_t SMTaskHandle;
 
 /* Logging tag for state machine */
 #define TAG_SM "[SM]"
@@ -87,6 +94,9 @@ static volatile bool fault_from_shutdown = false;
 static volatile uint16_t shutdown_recover_count = 0;
 #define SHUTDOWN_RECOVER_COUNT 50 /* consecutive healthy (~1 ms) reads before recovery */
 
+/* Deferred-log mode to restore on fault_recover(); faults log synchronously */
+static bool log_deferred_before_fault = false;
+
 /* Non-blocking delay state for precharge->energized transition */
 static volatile bool energize_pending = false;
 static volatile uint32_t energize_delay_start = 0;
@@ -122,6 +132,24 @@ static uint32_t balance_hv_start_tick = 0;
  * cleared at runtime: a power cycle resets both the MCU and the latch. */
 static bool imd_armed = false;
 
+/* Fault events: sources pending since the last evaluation (bit per
+ * FEB_SM_Event_t), and the sample time each source last reported. Written by
+ * producers in task or ISR context under SM_ENTER_CRITICAL(). */
+static volatile uint32_t sm_event_pending = 0;
+static uint64_t sm_event_sample_us[FEB_SM_EVENT_COUNT];
+static volatile uint32_t sm_event_count[FEB_SM_EVENT_COUNT];
+
+/* When the inputs of the evaluation in progress were sampled; fault_begin()
+ * measures detection latency from here. Set at the top of every SM tick and
+ * event evaluation, overridden by the event sample time for event-driven
+ * faults. */
+static uint64_t fault_sample_us = 0;
+
+/* Fault latency histograms, indexed [fault_type - BMS_STATE_FAULT_BMS][stage].
+ * Written by the SM task only; copied out under SM_ENTER_CRITICAL(). */
+#define SM_FAULT_TYPE_COUNT (BMS_STATE_FAULT_CHARGING - BMS_STATE_FAULT_BMS + 1)
+static FEB_SM_Lat_Hist_t fault_latency[SM_FAULT_TYPE_COUNT][FEB_SM_LAT_STAGE_COUNT];
+
 /* Special DEFAULT value for transition function calls during FEB_SM_Process */
 #define BMS_STATE_DEFAULT BMS_STATE_COUNT
 
@@ -136,6 +164,8 @@ static void fault_recover(void);
 static bool fault_process(void);
 static void check_reset_button(void);
 static void evaluate_faults(void);
+static void fault_latency_record(BMS_State_t fault_type, FEB_SM_Lat_Stage_t stage, uint64_t us);
+static uint64_t event_sample_us(FEB_SM_Event_t event);
 
 /* TODO(spec 5->10 BSPD): no BSPD GPIO/CAN input on SN5 yet. Drive-only fault.
  * Safe default: never trips until a real BSPD source is wired in. */
@@ -220,6 +250,19 @@ static void fault_begin(BMS_State_t fault_type)
     return;
   }
 
+  /* Open BMS shutdown relay before anything else (disables HV path): the
+   * logging and the isoSPI traffic of FEB_Stop_Balance() below must not delay
+   * it. The BMS indicator (PC0) is always the inverse of the relay pin (PC1),
+   * and the buzzer sounds for as long as the fault is latched (power-cycle to
+   * clear). */
+  uint64_t begin_us = FEB_Time_Us();
+  FEB_HW_BMS_Shutdown_Set(false);
+  uint64_t open_us = FEB_Time_Us();
+
+  uint64_t sample_us = (fault_sample_us != 0 && fault_sample_us <= begin_us) ? fault_sample_us : begin_us;
+  fault_latency_record(fault_type, FEB_SM_LAT_DETECT, begin_us - sample_us);
+  fault_latency_record(fault_type, FEB_SM_LAT_OPEN, open_us - begin_us);
+
   /* Fresh fault: default to non-recoverable. Only fault_begin_shutdown() tags
    * the shutdown/AIR- cause as recoverable, after this returns. */
   fault_from_shutdown = false;
@@ -233,10 +276,6 @@ static void fault_begin(BMS_State_t fault_type)
   /* Stop cell balancing immediately */
   FEB_Stop_Balance();
 
-  /* Open BMS shutdown relay immediately (disables HV path). The BMS
-   * indicator (PC0) is always the inverse of the relay pin (PC1), and the
-   * buzzer sounds for as long as the fault is latched (power-cycle to clear). */
-  FEB_HW_BMS_Shutdown_Set(false);
   FEB_HW_BMS_Indicator_Set(true);
   FEB_HW_Buzzer_Set(true);
   LOG_W(TAG_SM, "BMS shutdown relay opened");
@@ -248,6 +287,12 @@ static void fault_begin(BMS_State_t fault_type)
   fault_pending = true;
   fault_delay_start = HAL_GetTick();
   pending_fault_type = fault_type;
+
+  /* Flush the deferred log ring and print synchronously while latched, so the
+   * fault trail does not wait on the low-priority log task. Done last: the
+   * contactor delay above is already running. */
+  log_deferred_before_fault = FEB_Log_GetDeferred();
+  FEB_Log_SetDeferred(false);
 }
 
 /**
@@ -294,6 +339,7 @@ static void fault_recover(void)
   fault_pending = false;
   shutdown_recover_count = 0;
   shutdown_open_count = 0;
+  FEB_Log_SetDeferred(log_deferred_before_fault);
 
   /* Leave the fault directly (bypasses the updateStateProtected latch). */
   SM_Current_State = BMS_STATE_LV_POWER;
@@ -366,7 +412,8 @@ static void check_reset_button(void)
 }
 
 /**
- * @brief Centralized safety-condition evaluation (runs every SM tick).
+ * @brief Centralized safety-condition evaluation (runs every SM tick, and at
+ *        once when a fault event wakes the SM task).
  *
  * Faults route per the spec diagram by state group:
  *  - drive group (BOOT..DRIVE)             -> FAULT_BMS / FAULT_IMD
@@ -398,6 +445,7 @@ static void evaluate_faults(void)
   if (af & (ADBMS_FAULT_FLAG_VOLTAGE | ADBMS_FAULT_FLAG_TEMP | ADBMS_FAULT_FLAG_SENSOR))
   {
     LOG_E(TAG_SM, "Cell V/T/sensor violation (flags=0x%02lX)", (unsigned long)af);
+    fault_sample_us = event_sample_us(FEB_SM_EVENT_ADBMS);
     fault_begin(grp_fault);
     return;
   }
@@ -442,8 +490,7 @@ static void evaluate_faults(void)
       return;
     }
 
-    bool charging_path = (s == BMS_STATE_CHARGER_PRECHARGE || s == BMS_STATE_CHARGING);
-    float ilim = charging_path ? FEB_CHARGE_OVERCURRENT_A : FEB_DISCHARGE_OVERCURRENT_A;
+    float ilim = FEB_SM_Get_Overcurrent_Limit_A();
     if (fabsf(FEB_CAN_IVT_GetCurrent()) > ilim)
     {
       if (overcurrent_start_tick == 0)
@@ -453,6 +500,7 @@ static void evaluate_faults(void)
       else if ((HAL_GetTick() - overcurrent_start_tick) >= FEB_OVERCURRENT_CONFIRM_MS)
       {
         LOG_E(TAG_SM, "Overcurrent event (|I| > %.0fA)", (double)ilim);
+        fault_sample_us = event_sample_us(FEB_SM_EVENT_IVT);
         fault_begin(grp_fault);
         return;
       }
@@ -574,6 +622,52 @@ static void evaluate_faults(void)
 #endif
 }
 
+/**
+ * @brief Take the sample time last reported by an event source, or the time
+ *        of the evaluation in progress if there is none. Consumed by the fault
+ *        it explains, so a later fault on the same source cannot inherit it.
+ */
+static uint64_t event_sample_us(FEB_SM_Event_t event)
+{
+  SM_ENTER_CRITICAL();
+  uint64_t us = sm_event_sample_us[event];
+  sm_event_sample_us[event] = 0;
+  SM_EXIT_CRITICAL();
+  return (us != 0) ? us : fault_sample_us;
+}
+
+/**
+ * @brief Add one latency sample to a fault type's histogram
+ */
+static void fault_latency_record(BMS_State_t fault_type, FEB_SM_Lat_Stage_t stage, uint64_t us)
+{
+  if (!isFaultState(fault_type))
+  {
+    return;
+  }
+  uint32_t v = (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+  uint32_t b = (v == 0) ? 0 : (uint32_t)(32 - __builtin_clz(v));
+  if (b >= FEB_SM_LAT_BUCKETS)
+  {
+    b = FEB_SM_LAT_BUCKETS - 1;
+  }
+
+  FEB_SM_Lat_Hist_t *h = &fault_latency[fault_type - BMS_STATE_FAULT_BMS][stage];
+  SM_ENTER_CRITICAL();
+  if (h->count == 0 || v < h->min_us)
+  {
+    h->min_us = v;
+  }
+  if (v > h->max_us)
+  {
+    h->max_us = v;
+  }
+  h->count++;
+  h->sum_us += v;
+  h->bucket[b]++;
+  SM_EXIT_CRITICAL();
+}
+
 /* ============================================================================
  * Public Interface
  * ============================================================================ */
@@ -621,6 +715,9 @@ void FEB_SM_Transition(BMS_State_t next_state)
 
 void FEB_SM_Process(void)
 {
+  /* Everything this tick evaluates is sampled from here on */
+  fault_sample_us = FEB_Time_Us();
+
   /* Check reset button */
   check_reset_button();
 
@@ -701,6 +798,87 @@ bool FEB_SM_IMD_Armed(void)
   return imd_armed;
 }
 
+float FEB_SM_Get_Overcurrent_Limit_A(void)
+{
+  BMS_State_t s = SM_Current_State;
+  bool charging_path = (s == BMS_STATE_CHARGER_PRECHARGE || s == BMS_STATE_CHARGING);
+  return charging_path ? FEB_CHARGE_OVERCURRENT_A : FEB_DISCHARGE_OVERCURRENT_A;
+}
+
+/* ============================================================================
+ * Fault Events and Latency Instrumentation
+ * ============================================================================ */
+
+void FEB_SM_Process_Events(void)
+{
+  if (sm_event_pending == 0)
+  {
+    return;
+  }
+
+  SM_ENTER_CRITICAL();
+  sm_event_pending = 0;
+  SM_EXIT_CRITICAL();
+
+  /* Same checks as the tick, without the transition handlers: a fault caught
+   * here is exactly the one the next tick would have caught. */
+  fault_sample_us = FEB_Time_Us();
+  evaluate_faults();
+}
+
+void FEB_SM_Notify_Event(FEB_SM_Event_t event, uint64_t sample_us)
+{
+  if (event >= FEB_SM_EVENT_COUNT)
+  {
+    return;
+  }
+
+  SM_ENTER_CRITICAL();
+  sm_event_sample_us[event] = sample_us;
+  sm_event_pending |= (1UL << event);
+  sm_event_count[event]++;
+  SM_EXIT_CRITICAL();
+
+  if (SMTaskHandle == NULL)
+  {
+    return;
+  }
+  if (__get_IPSR() != 0U)
+  {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR((TaskHandle_t)SMTaskHandle, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  }
+  else
+  {
+    xTaskNotifyGive((TaskHandle_t)SMTaskHandle);
+  }
+}
+
+uint32_t FEB_SM_Get_Event_Count(FEB_SM_Event_t event)
+{
+  return (event < FEB_SM_EVENT_COUNT) ? sm_event_count[event] : 0;
+}
+
+bool FEB_SM_Get_Fault_Latency(BMS_State_t fault_type, FEB_SM_Lat_Stage_t stage, FEB_SM_Lat_Hist_t *out)
+{
+  if (!isFaultState(fault_type) || stage >= FEB_SM_LAT_STAGE_COUNT || out == NULL)
+  {
+    return false;
+  }
+  SM_ENTER_CRITICAL();
+  *out = fault_latency[fault_type - BMS_STATE_FAULT_BMS][stage];
+  SM_EXIT_CRITICAL();
+  return true;
+}
+
+void FEB_SM_Reset_Fault_Latency(void)
+{
+  SM_ENTER_CRITICAL();
+  memset(fault_latency, 0, sizeof(fault_latency));
+  SM_EXIT_CRITICAL();
+}
+
 /* ============================================================================
  * Transition Functions
  * ============================================================================ */
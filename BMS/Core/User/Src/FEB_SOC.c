@@ -0,0 +1,189 @@
+#include "FEB_SOC.h"
+#include <math.h>
+
+// ********************************** OCV Table **********************************
+
+// Cell OCV at 0, 5, ..., 100 % SOC for a generic NMC 21700, 25 C, relaxed.
+// TUNE: replace with a C/20 characterisation of the pack's cells.
+#define OCV_POINTS 21
+#define OCV_STEP (1.0f / (float)(OCV_POINTS - 1))
+
+static const float ocv_table_V[OCV_POINTS] = {
+    3.000f, 3.300f, 3.420f, 3.500f, 3.550f, 3.590f, 3.620f, 3.650f, 3.680f, 3.710f, 3.740f,
+    3.780f, 3.820f, 3.860f, 3.900f, 3.940f, 3.980f, 4.030f, 4.080f, 4.130f, 4.200f,
+};
+
+// Initial RLS covariance: a first 50 A step moves R most of the way to the
+// measured value. Also the cap, so a long quiet stretch cannot inflate it.
+#define RLS_VAR_INIT 1.0e-3f
+// Converged once enough excitation has shrunk the covariance this far
+#define RLS_VAR_CONVERGED (RLS_VAR_INIT / 20.0f)
+#define RLS_MIN_UPDATES 10U
+
+#define SOC_MAX_DT_S 1.0f
+
+float FEB_SOC_Cell_OCV(float soc)
+{
+  if (soc <= 0.0f)
+  {
+    return ocv_table_V[0];
+  }
+  if (soc >= 1.0f)
+  {
+    return ocv_table_V[OCV_POINTS - 1];
+  }
+  float pos = soc * (float)(OCV_POINTS - 1);
+  int i = (int)pos;
+  float frac = pos - (float)i;
+  return ocv_table_V[i] + frac * (ocv_table_V[i + 1] - ocv_table_V[i]);
+}
+
+float FEB_SOC_From_Cell_OCV(float cell_V)
+{
+  if (cell_V <= ocv_table_V[0])
+  {
+    return 0.0f;
+  }
+  if (cell_V >= ocv_table_V[OCV_POINTS - 1])
+  {
+    return 1.0f;
+  }
+  // Table is monotonic: bisect for the segment holding cell_V
+  int lo = 0;
+  int hi = OCV_POINTS - 1;
+  while (hi - lo > 1)
+  {
+    int mid = (lo + hi) / 2;
+    if (ocv_table_V[mid] <= cell_V)
+    {
+      lo = mid;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  float frac = (cell_V - ocv_table_V[lo]) / (ocv_table_V[hi] - ocv_table_V[lo]);
+  return ((float)lo + frac) * OCV_STEP;
+}
+
+// ********************************** Estimator **********************************
+
+void FEB_SOC_Init(FEB_SOC_t *est)
+{
+  est->soc = 0.0f;
+  est->r_ohm = FEB_SOC_R_INIT_OHM;
+  est->r_var = RLS_VAR_INIT;
+  est->ah_out = 0.0f;
+  est->rest_s = 0.0f;
+  est->prev_pack_V = 0.0f;
+  est->prev_current_A = 0.0f;
+  est->prev_valid = false;
+  est->rls_updates = 0;
+  est->flags = 0;
+}
+
+static void update_resistance(FEB_SOC_t *est, float current_A, float pack_V)
+{
+  float dI = current_A - est->prev_current_A;
+  if (!est->prev_valid || fabsf(dI) < FEB_SOC_RLS_MIN_DI_A)
+  {
+    return;
+  }
+
+  float drop = est->prev_pack_V - pack_V;
+  float gain = est->r_var * dI / (FEB_SOC_RLS_LAMBDA + dI * est->r_var * dI);
+  est->r_ohm += gain * (drop - dI * est->r_ohm);
+  est->r_var = (est->r_var - gain * dI * est->r_var) / FEB_SOC_RLS_LAMBDA;
+
+  if (est->r_ohm < FEB_SOC_R_MIN_OHM)
+  {
+    est->r_ohm = FEB_SOC_R_MIN_OHM;
+  }
+  else if (est->r_ohm > FEB_SOC_R_MAX_OHM)
+  {
+    est->r_ohm = FEB_SOC_R_MAX_OHM;
+  }
+  if (est->r_var > RLS_VAR_INIT)
+  {
+    est->r_var = RLS_VAR_INIT;
+  }
+  est->rls_updates++;
+}
+
+void FEB_SOC_Step(FEB_SOC_t *est, float dt_s, float current_A, bool current_valid, float pack_V, uint16_t cells)
+{
+  if (cells == 0 || pack_V <= 0.0f)
+  {
+    return;
+  }
+  float cell_V = pack_V / (float)cells;
+
+  if (!(est->flags & FEB_SOC_FLAG_VALID))
+  {
+    est->soc = FEB_SOC_From_Cell_OCV(cell_V);
+    est->flags = FEB_SOC_FLAG_VALID;
+    est->prev_valid = false;
+    return;
+  }
+
+  if (dt_s < 0.0f)
+  {
+    dt_s = 0.0f;
+  }
+  else if (dt_s > SOC_MAX_DT_S)
+  {
+    dt_s = SOC_MAX_DT_S;
+  }
+
+  uint8_t flags = FEB_SOC_FLAG_VALID;
+
+  if (!current_valid)
+  {
+    // Without current there is no rest detection or RLS pair either
+    est->rest_s = 0.0f;
+    est->prev_valid = false;
+    flags |= FEB_SOC_FLAG_NO_CURRENT;
+  }
+  else
+  {
+    float dAh = current_A * dt_s * (1.0f / 3600.0f);
+    est->ah_out += dAh;
+    est->soc -= dAh * (1.0f / FEB_SOC_PACK_CAPACITY_AH);
+
+    if (fabsf(current_A) < FEB_SOC_REST_CURRENT_A)
+    {
+      est->rest_s += dt_s;
+    }
+    else
+    {
+      est->rest_s = 0.0f;
+    }
+    if (est->rest_s * 1000.0f >= (float)FEB_SOC_REST_TIME_MS)
+    {
+      float k = dt_s * (1.0f / FEB_SOC_OCV_TAU_S);
+      est->soc += k * (FEB_SOC_From_Cell_OCV(cell_V) - est->soc);
+      flags |= FEB_SOC_FLAG_AT_REST;
+    }
+
+    update_resistance(est, current_A, pack_V);
+    est->prev_pack_V = pack_V;
+    est->prev_current_A = current_A;
+    est->prev_valid = true;
+  }
+
+  if (est->soc < 0.0f)
+  {
+    est->soc = 0.0f;
+  }
+  else if (est->soc > 1.0f)
+  {
+    est->soc = 1.0f;
+  }
+
+  if (est->rls_updates >= RLS_MIN_UPDATES && est->r_var <= RLS_VAR_CONVERGED)
+  {
+    flags |= FEB_SOC_FLAG_R_CONVERGED;
+  }
+  est->flags = flags;
+}
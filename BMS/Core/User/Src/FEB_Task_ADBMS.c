@@ -9,6 +9,7 @@
 #include "FEB_Task_ADBMS.h"
 #include "main.h"
 #include "FEB_ADBMS6830B.h"
+#include "FEB_AD68xx_Async.h"
 #include "FEB_HW.h"
 #include "FEB_SM.h"
 #include "FEB_Const.h"
@@ -38,6 +39,9 @@ void StartADBMSTask(void *argument)
 
   LOG_I(TAG_ADBMS, "Task Begun");
 
+  /* Check spi.c linked the isoSPI DMA streams before the first register read */
+  ADBMS_Async_Init();
+
   /* === Initialization Phase === */
   while (init_attempts < MAX_INIT_RETRIES && !init_success)
   {
@@ -99,9 +103,8 @@ void StartADBMSTask(void *argument)
      * the per-sensor over/under-temp debounce latches within the FSAE 1 s window. */
     if (now - temp_tick >= pdMS_TO_TICKS(FEB_TEMP_SCAN_PERIOD_MS))
     {
-      osMutexAcquire(ADBMSMutexHandle, osWaitForever);
+      /* Pipelined sweep takes ADBMSMutexHandle per phase itself */
       FEB_ADBMS_Temperature_Process();
-      osMutexRelease(ADBMSMutexHandle);
       temp_tick = now;
     }
 
@@ -0,0 +1,73 @@
+#include "FEB_Temp_Median.h"
+
+// ********************************** Helper Functions ***************************
+
+static inline void temp_swap(float *a, int i, int j)
+{
+  float t = a[i];
+  a[i] = a[j];
+  a[j] = t;
+}
+
+// Quickselect: reorders a[0..n) so a[k] is the k-th smallest and nothing
+// before it is larger.
+static float temp_select_dC(float *a, int n, int k)
+{
+  int lo = 0;
+  int hi = n - 1;
+  while (lo < hi)
+  {
+    int mid = lo + (hi - lo) / 2;
+    if (a[mid] < a[lo])
+      temp_swap(a, mid, lo);
+    if (a[hi] < a[lo])
+      temp_swap(a, hi, lo);
+    if (a[hi] < a[mid])
+      temp_swap(a, hi, mid);
+
+    const float pivot = a[mid];
+    int i = lo;
+    int j = hi;
+    while (i <= j)
+    {
+      while (a[i] < pivot)
+        i++;
+      while (a[j] > pivot)
+        j--;
+      if (i <= j)
+      {
+        temp_swap(a, i, j);
+        i++;
+        j--;
+      }
+    }
+
+    // [lo..j] <= pivot <= [i..hi]; anything strictly between equals pivot.
+    if (k <= j)
+      hi = j;
+    else if (k >= i)
+      lo = i;
+    else
+      break;
+  }
+  return a[k];
+}
+
+// ********************************** Functions **********************************
+
+float FEB_Temp_Median_dC(float *a, int n)
+{
+  const int k = n / 2;
+  const float upper = temp_select_dC(a, n, k);
+  if (n & 1)
+    return upper;
+
+  // Even count: the lower middle is the largest element left of k.
+  float lower = a[0];
+  for (int i = 1; i < k; i++)
+  {
+    if (a[i] > lower)
+      lower = a[i];
+  }
+  return 0.5f * (lower + upper);
+}
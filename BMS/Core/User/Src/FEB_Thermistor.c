@@ -0,0 +1,99 @@
+#include "FEB_Thermistor.h"
+
+#include <stdbool.h>
+
+// ********************************** Variables **********************************
+
+// Node k holds the temperature at code (k << THERM_LUT_SHIFT) - 32768, in
+// centi-degC, or THERM_TEMP_INVALID_DC where the Beta equation has no
+// representable value (only far outside the valid voltage window).
+static int16_t therm_lut_cC[THERM_LUT_SIZE];
+
+// Valid code window, derived from THERM_MIN/MAX_VOLTAGE_MV with the same float
+// conversion the scan uses, so both paths reject exactly the same codes.
+static int16_t therm_code_min = INT16_MAX;
+static int16_t therm_code_max = INT16_MIN;
+
+// ********************************** Helper Functions ***************************
+
+static float therm_code_to_mV(int32_t code)
+{
+  return ((float)code * ADBMS_ADC_LSB_V + ADBMS_ADC_OFFSET_V) * 1000.0f;
+}
+
+static bool therm_code_valid(int32_t code)
+{
+  float mV = therm_code_to_mV(code);
+  return mV >= THERM_MIN_VOLTAGE_MV && mV <= THERM_MAX_VOLTAGE_MV;
+}
+
+// Beta equation without the voltage window check, for nodes just outside it.
+static float therm_beta_C(float voltage_mV)
+{
+  float denominator = THERM_VS_MV - voltage_mV;
+  if (voltage_mV <= 0.0f || denominator <= 0.0f)
+  {
+    return NAN;
+  }
+
+  float R_thermistor = (voltage_mV * THERM_R_PULLUP_OHMS) / denominator;
+  float inv_T_kelvin = THERM_INV_T_REF + (THERM_INV_BETA * logf(R_thermistor / THERM_R_REF_OHMS));
+  if (inv_T_kelvin <= 0.0f)
+  {
+    return NAN;
+  }
+  return 1.0f / inv_T_kelvin - THERM_KELVIN_OFFSET;
+}
+
+// ********************************** Functions **********************************
+
+void FEB_Thermistor_Init(void)
+{
+  for (uint32_t k = 0; k < THERM_LUT_SIZE; k++)
+  {
+    int32_t code = (int32_t)(k << THERM_LUT_SHIFT) - 32768;
+    float cC = therm_beta_C(therm_code_to_mV(code)) * 100.0f;
+    if (!isfinite(cC) || cC <= (float)INT16_MIN || cC > (float)INT16_MAX)
+    {
+      therm_lut_cC[k] = THERM_TEMP_INVALID_DC;
+      continue;
+    }
+    therm_lut_cC[k] = (int16_t)lroundf(cC);
+  }
+
+  // Solve the window edges in closed form, then settle them against the exact
+  // float comparison to absorb rounding.
+  int32_t lo = (int32_t)ceilf((THERM_MIN_VOLTAGE_MV / 1000.0f - ADBMS_ADC_OFFSET_V) / ADBMS_ADC_LSB_V);
+  int32_t hi = (int32_t)floorf((THERM_MAX_VOLTAGE_MV / 1000.0f - ADBMS_ADC_OFFSET_V) / ADBMS_ADC_LSB_V);
+  while (lo > INT16_MIN && therm_code_valid(lo - 1))
+    lo--;
+  while (lo <= hi && !therm_code_valid(lo))
+    lo++;
+  while (hi < INT16_MAX && therm_code_valid(hi + 1))
+    hi++;
+  while (hi >= lo && !therm_code_valid(hi))
+    hi--;
+  therm_code_min = (int16_t)lo;
+  therm_code_max = (int16_t)hi;
+}
+
+int16_t FEB_Thermistor_Code_To_Temp_dC(int16_t code)
+{
+  if (code < therm_code_min || code > therm_code_max)
+  {
+    return THERM_TEMP_INVALID_DC;
+  }
+
+  uint32_t offset = (uint32_t)((int32_t)code + 32768);
+  uint32_t k = offset >> THERM_LUT_SHIFT;
+  int32_t frac = (int32_t)(offset & ((1U << THERM_LUT_SHIFT) - 1U));
+  int32_t a = therm_lut_cC[k];
+  int32_t b = therm_lut_cC[k + 1U];
+
+  // Both neighbours of an in-window code are finite: nodes only overflow
+  // int16 centi-degC (> 327 degC) well below THERM_MIN_VOLTAGE_MV.
+  int32_t scaled = a * (1 << THERM_LUT_SHIFT) + (b - a) * frac; // centi-degC << THERM_LUT_SHIFT
+  int32_t div = 10 << THERM_LUT_SHIFT;
+  int32_t half = div / 2;
+  return (int16_t)((scaled >= 0) ? (scaled + half) / div : (scaled - half) / div);
+}
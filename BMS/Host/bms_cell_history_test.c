@@ -0,0 +1,398 @@
+/**
+ ******************************************************************************
+ * @file           : bms_cell_history_test.c
+ * @brief          : Cell history ring round trip, corruption and footprint
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Records TEST_SCAN_SECONDS of seeded 10 Hz voltage and temperature scans into
+ * FEB_Cell_History the way FEB_ADBMS6830B.c does (Begin, one Push per
+ * channel, End), keeps every scan in a shadow log, freezes, and checks:
+ *
+ *   ring       - a cursor over the ring itself decodes every surviving
+ *                record byte-exact against the shadow log (values, flags,
+ *                tick, kind), in scan order with no gaps, ending at the
+ *                newest scan. Only the delta records ahead of the oldest
+ *                surviving keyframe of their kind may be skipped.
+ *   dump       - the same ring read out FEB_CAN_EXT_BMS_HIST_CHUNK bytes at
+ *                a time, framed as 0x0E4 with the feb_can_ext_frames.h
+ *                helpers, reassembled by sequence number and decoded from
+ *                the linear buffer: identical records.
+ *   corrupt    - a dump with one header's type byte damaged, and one cut
+ *                mid-payload: decoding stops at that record, every record
+ *                before it still decodes exactly, and nothing reads past
+ *                the buffer (build with ASan to enforce that).
+ *   rearm      - Rearm empties the ring and recording resumes.
+ *   footprint  - ring capacity, the writer's previous-frame state and the
+ *                cursor, and the window the ring holds at this scan rate,
+ *                which must cover at least TEST_MIN_WINDOW_MS.
+ *
+ * Scans, a quiet pack: cells random-walk around TEST_CELL_NOMINAL_CODE by up to
+ * +/- TEST_CELL_JITTER codes with an occasional larger step; thermistors
+ * drift slowly and one read in TEST_PEC_FAIL_ONE_IN is a PEC failure
+ * (0xFFFF). The last second carries a fault flag and the ring is frozen with
+ * it, as on a latched fault.
+ *
+ * stdout: `check,records,bytes,mismatches`
+ * stderr: summary. Exit status 1 on any failed check.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_Cell_History.h"
+#include "feb_can_ext_frames.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define TEST_SEED 0xE4C0FFEEU
+#define TEST_SCAN_SECONDS 30U
+#define TEST_SCAN_PERIOD_MS 100U
+#define TEST_SCANS (TEST_SCAN_SECONDS * 1000U / TEST_SCAN_PERIOD_MS) /* Per kind */
+#define TEST_START_TICK 120000U
+#define TEST_TEMP_OFFSET_MS 50U                 /* Temperature scan half a period after the voltage scan */
+#define TEST_CELL_NOMINAL_CODE 14667            /* 3.7 V: (3700000 - 1500000) / 150 */
+#define TEST_CELL_JITTER 1                      /* Codes, per scan */
+#define TEST_STEP_ONE_IN 256U                   /* Cells taking a 20..120 code step */
+#define TEST_THERM_NOMINAL_CODE 12000
+#define TEST_PEC_FAIL_ONE_IN 1000U
+#define TEST_FAULT_FLAG 0x01U                   /* Any ADBMS_FAULT_FLAG_* */
+#define TEST_MIN_WINDOW_MS 4000U                /* FEB_Const.h documents ~4 s at 16 KB */
+
+#define TEST_RECORDS (2U * TEST_SCANS)
+
+/* ============================================================================
+ * Shadow Log
+ * ============================================================================ */
+
+static uint16_t shadow_voltage[TEST_SCANS][FEB_HIST_VOLTAGE_CHANNELS];
+static uint16_t shadow_temp[TEST_SCANS][FEB_HIST_TEMP_CHANNELS];
+static uint8_t shadow_flags[TEST_RECORDS];
+
+/* Records interleave V0, T0, V1, T1, ...; index = 2 * scan + kind */
+static uint32_t record_tick(uint32_t index)
+{
+  return TEST_START_TICK + (index / 2U) * TEST_SCAN_PERIOD_MS + ((index & 1U) ? TEST_TEMP_OFFSET_MS : 0U);
+}
+
+static const uint16_t *record_values(uint32_t index)
+{
+  return (index & 1U) ? shadow_temp[index / 2U] : shadow_voltage[index / 2U];
+}
+
+static uint32_t rng_state = TEST_SEED;
+
+static uint32_t rng(void)
+{
+  /* xorshift32 */
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static void generate_scans(void)
+{
+  for (uint32_t c = 0; c < FEB_HIST_VOLTAGE_CHANNELS; c++)
+  {
+    shadow_voltage[0][c] = (uint16_t)(TEST_CELL_NOMINAL_CODE + (int32_t)(rng() % 200U) - 100);
+  }
+  for (uint32_t t = 0; t < FEB_HIST_TEMP_CHANNELS; t++)
+  {
+    shadow_temp[0][t] = (uint16_t)(TEST_THERM_NOMINAL_CODE + (int32_t)(rng() % 400U) - 200);
+  }
+
+  for (uint32_t s = 1; s < TEST_SCANS; s++)
+  {
+    for (uint32_t c = 0; c < FEB_HIST_VOLTAGE_CHANNELS; c++)
+    {
+      int32_t step = (int32_t)(rng() % (2U * TEST_CELL_JITTER + 1U)) - TEST_CELL_JITTER;
+      if (rng() % TEST_STEP_ONE_IN == 0U)
+      {
+        step += ((rng() & 1U) ? 1 : -1) * (int32_t)(20U + rng() % 100U);
+      }
+      shadow_voltage[s][c] = (uint16_t)(shadow_voltage[s - 1U][c] + step);
+    }
+    for (uint32_t t = 0; t < FEB_HIST_TEMP_CHANNELS; t++)
+    {
+      /* Drift from the last good reading, not from a PEC failure */
+      uint16_t base = shadow_temp[s - 1U][t];
+      for (uint32_t back = s - 1U; base == 0xFFFFU && back > 0U; back--)
+      {
+        base = shadow_temp[back - 1U][t];
+      }
+      shadow_temp[s][t] = (rng() % TEST_PEC_FAIL_ONE_IN == 0U) ? 0xFFFFU
+                                                                : (uint16_t)(base + (int32_t)(rng() % 3U) - 1);
+    }
+  }
+
+  const uint32_t fault_from = TEST_RECORDS - 2U * (1000U / TEST_SCAN_PERIOD_MS);
+  for (uint32_t i = 0; i < TEST_RECORDS; i++)
+  {
+    shadow_flags[i] = (i >= fault_from) ? TEST_FAULT_FLAG : 0U;
+  }
+}
+
+/* As FEB_ADBMS6830B.c records a scan */
+static void record(uint32_t index)
+{
+  const FEB_Hist_Kind_t kind = (index & 1U) ? FEB_HIST_KIND_TEMP : FEB_HIST_KIND_VOLTAGE;
+  const uint16_t channels = (index & 1U) ? FEB_HIST_TEMP_CHANNELS : FEB_HIST_VOLTAGE_CHANNELS;
+  if (!FEB_Cell_History_Begin(kind, record_tick(index), shadow_flags[index]))
+  {
+    return;
+  }
+  const uint16_t *values = record_values(index);
+  for (uint16_t c = 0; c < channels; c++)
+  {
+    FEB_Cell_History_Push(values[c]);
+  }
+  FEB_Cell_History_End();
+}
+
+/* ============================================================================
+ * Decode Check
+ * ============================================================================ */
+
+typedef struct
+{
+  uint32_t records;    /* Decoded */
+  uint32_t first;      /* Shadow index of the first decoded record */
+  uint32_t last;       /* Shadow index of the last decoded record */
+  uint32_t mismatches; /* Records that differ from the shadow log, or out of order */
+  bool seen[FEB_HIST_KIND_COUNT];
+  uint32_t kind_last[FEB_HIST_KIND_COUNT];
+} decode_result_t;
+
+static bool shadow_index(const FEB_Cell_History_Record_t *rec, uint32_t *index)
+{
+  const uint32_t offset = (rec->kind == FEB_HIST_KIND_TEMP) ? TEST_TEMP_OFFSET_MS : 0U;
+  if (rec->tick < TEST_START_TICK + offset || (rec->tick - TEST_START_TICK - offset) % TEST_SCAN_PERIOD_MS != 0U)
+  {
+    return false;
+  }
+  const uint32_t scan = (rec->tick - TEST_START_TICK - offset) / TEST_SCAN_PERIOD_MS;
+  if (scan >= TEST_SCANS)
+  {
+    return false;
+  }
+  *index = 2U * scan + ((rec->kind == FEB_HIST_KIND_TEMP) ? 1U : 0U);
+  return true;
+}
+
+/* Decode with cur (already initialised) and hold every record to the shadow log. */
+static decode_result_t decode_and_compare(FEB_Cell_History_Cursor_t *cur)
+{
+  decode_result_t res = {0};
+  FEB_Cell_History_Record_t rec;
+  while (FEB_Cell_History_Next(cur, &rec))
+  {
+    uint32_t index = 0;
+    const uint16_t channels = (rec.kind == FEB_HIST_KIND_TEMP) ? FEB_HIST_TEMP_CHANNELS : FEB_HIST_VOLTAGE_CHANNELS;
+    bool ok = shadow_index(&rec, &index) && rec.count == channels && rec.flags == shadow_flags[index] &&
+              memcmp(rec.values, record_values(index), channels * sizeof(uint16_t)) == 0;
+    /* Each kind resyncs at its own first keyframe; after that, no gaps */
+    if (ok && ((res.records > 0U && index <= res.last) ||
+               (res.seen[rec.kind] && index != res.kind_last[rec.kind] + 2U)))
+    {
+      ok = false; /* Gap or reordering */
+    }
+    if (!ok)
+    {
+      if (res.mismatches == 0U)
+      {
+        fprintf(stderr, "first mismatch: decoded record %u (kind %d, tick %u)\n", res.records, (int)rec.kind,
+                rec.tick);
+      }
+      res.mismatches++;
+    }
+    if (res.records == 0U)
+    {
+      res.first = index;
+    }
+    res.last = index;
+    res.seen[rec.kind] = true;
+    res.kind_last[rec.kind] = index;
+    res.records++;
+  }
+  return res;
+}
+
+/* Read the frozen ring out as 0x0E4 frames and reassemble them in sequence order. */
+static uint32_t dump_over_frames(uint8_t *dst, uint32_t cap, uint32_t *header_total, uint16_t *header_records)
+{
+  FEB_Cell_History_Stats_t st;
+  FEB_Cell_History_Get_Stats(&st);
+
+  uint8_t frame[FEB_CAN_EXT_BMS_HIST_LENGTH];
+  (void)feb_can_ext_bms_hist_pack_header(frame, st.used_bytes, (uint16_t)st.records);
+  const feb_can_ext_bms_hist_wire_t *w = (const feb_can_ext_bms_hist_wire_t *)frame;
+  *header_total = (uint32_t)w->body.header.total_bytes[0] | ((uint32_t)w->body.header.total_bytes[1] << 8) |
+                  ((uint32_t)w->body.header.total_bytes[2] << 16) | ((uint32_t)w->body.header.total_bytes[3] << 24);
+  *header_records = (uint16_t)(w->body.header.records[0] | (w->body.header.records[1] << 8));
+
+  uint32_t received = 0;
+  for (uint16_t seq = 1;; seq++)
+  {
+    uint8_t bytes[FEB_CAN_EXT_BMS_HIST_CHUNK];
+    const uint32_t n = FEB_Cell_History_Read(received, bytes, FEB_CAN_EXT_BMS_HIST_CHUNK);
+    if (n == 0U)
+    {
+      break;
+    }
+    const uint8_t dlc = feb_can_ext_bms_hist_pack_data(frame, seq, bytes, (uint8_t)n);
+
+    /* Receiver side: the sequence number places the chunk */
+    const uint32_t at = (uint32_t)(feb_can_ext_bms_hist_seq(frame) - 1U) * FEB_CAN_EXT_BMS_HIST_CHUNK;
+    const uint32_t len = (uint32_t)dlc - offsetof(feb_can_ext_bms_hist_wire_t, body.chunk);
+    if (at + len > cap)
+    {
+      break;
+    }
+    memcpy(&dst[at], w->body.chunk, len);
+    received += len;
+  }
+  return received;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static uint8_t dump[FEB_HIST_BUF_BYTES];
+
+static void report(const char *check, uint32_t records, uint32_t bytes, uint32_t mismatches)
+{
+  printf("%s,%u,%u,%u\n", check, records, bytes, mismatches);
+}
+
+int main(void)
+{
+  uint32_t failures = 0;
+  generate_scans();
+
+  FEB_Cell_History_Init();
+  for (uint32_t i = 0; i < TEST_RECORDS; i++)
+  {
+    record(i);
+  }
+  FEB_Cell_History_Freeze(record_tick(TEST_RECORDS - 1U), TEST_FAULT_FLAG);
+
+  FEB_Cell_History_Stats_t st;
+  FEB_Cell_History_Get_Stats(&st);
+
+  /* A frozen ring takes no more records */
+  const uint32_t records_frozen = st.records;
+  record(TEST_RECORDS - 1U);
+  FEB_Cell_History_Get_Stats(&st);
+  if (st.records != records_frozen || !st.frozen || st.freeze_flags != TEST_FAULT_FLAG)
+  {
+    fprintf(stderr, "freeze: ring changed after Freeze\n");
+    failures++;
+  }
+
+  printf("check,records,bytes,mismatches\n");
+
+  /* Ring: at most KEYFRAME_INTERVAL - 1 leading deltas of each kind may be skipped */
+  FEB_Cell_History_Cursor_t cur;
+  FEB_Cell_History_Cursor_Init(&cur, NULL, 0);
+  const decode_result_t ring = decode_and_compare(&cur);
+  const uint32_t max_skipped = 2U * (FEB_HIST_KEYFRAME_INTERVAL - 1U);
+  const bool ring_ok = ring.mismatches == 0U && ring.records > 0U && ring.last == TEST_RECORDS - 1U &&
+                       ring.records + max_skipped >= st.records && ring.records <= st.records &&
+                       record_tick(ring.first) >= st.oldest_tick && st.newest_tick == record_tick(TEST_RECORDS - 1U);
+  report("ring", ring.records, st.used_bytes, ring.mismatches);
+  failures += ring_ok ? 0U : 1U;
+
+  /* Dump: framed, reassembled, decoded from the linear copy */
+  uint32_t header_total;
+  uint16_t header_records;
+  const uint32_t dumped = dump_over_frames(dump, sizeof(dump), &header_total, &header_records);
+  FEB_Cell_History_Cursor_Init(&cur, dump, dumped);
+  const decode_result_t lin = decode_and_compare(&cur);
+  const bool dump_ok = dumped == st.used_bytes && header_total == st.used_bytes && header_records == st.records &&
+                       lin.mismatches == 0U && lin.records == ring.records && lin.first == ring.first &&
+                       lin.last == ring.last;
+  report("dump", lin.records, dumped, lin.mismatches);
+  failures += dump_ok ? 0U : 1U;
+
+  /* Corrupt: damage the header of the record half way through the decoded ones */
+  uint32_t cut_at = 0;
+  uint32_t cut_record = 0;
+  {
+    FEB_Cell_History_Record_t rec;
+    FEB_Cell_History_Cursor_Init(&cur, dump, dumped);
+    while (FEB_Cell_History_Next(&cur, &rec))
+    {
+      if (++cut_record == ring.records / 2U)
+      {
+        cut_at = cur.pos; /* Header of the next record */
+        break;
+      }
+    }
+  }
+  uint32_t corrupt_mismatches = 0;
+  uint32_t corrupt_records = 0;
+  {
+    static uint8_t damaged[FEB_HIST_BUF_BYTES];
+    memcpy(damaged, dump, dumped);
+    damaged[cut_at] ^= 0x70U; /* Breaks FEB_HIST_TYPE_MARK */
+    FEB_Cell_History_Cursor_Init(&cur, damaged, dumped);
+    const decode_result_t bad = decode_and_compare(&cur);
+    corrupt_records += bad.records;
+    corrupt_mismatches += bad.mismatches + ((bad.records == cut_record && cur.pos == cut_at) ? 0U : 1U);
+
+    /* Truncated: the buffer ends 3 bytes into that record's payload */
+    FEB_Cell_History_Cursor_Init(&cur, dump, cut_at + FEB_HIST_HEADER_BYTES + 3U);
+    const decode_result_t cut = decode_and_compare(&cur);
+    corrupt_records += cut.records;
+    corrupt_mismatches += cut.mismatches + ((cut.records == cut_record) ? 0U : 1U);
+  }
+  report("corrupt", corrupt_records, cut_at, corrupt_mismatches);
+  failures += (corrupt_mismatches == 0U) ? 0U : 1U;
+
+  /* Rearm: empty, then records again */
+  FEB_Cell_History_Rearm();
+  FEB_Cell_History_Stats_t re;
+  FEB_Cell_History_Get_Stats(&re);
+  const bool empty_ok = !re.frozen && re.used_bytes == 0U && re.records == 0U && re.evicted == 0U;
+  record(0);
+  record(1);
+  FEB_Cell_History_Get_Stats(&re);
+  FEB_Cell_History_Cursor_Init(&cur, NULL, 0);
+  const decode_result_t again = decode_and_compare(&cur);
+  const bool rearm_ok = empty_ok && re.records == 2U && again.records == 2U && again.mismatches == 0U;
+  report("rearm", again.records, re.used_bytes, again.mismatches + (rearm_ok ? 0U : 1U));
+  failures += rearm_ok ? 0U : 1U;
+
+  /* Footprint: what the window costs, and what it holds */
+  const uint32_t window_ms = st.newest_tick - st.oldest_tick + TEST_SCAN_PERIOD_MS;
+  const uint32_t prev_bytes = (uint32_t)((FEB_HIST_VOLTAGE_CHANNELS + FEB_HIST_TEMP_CHANNELS) * sizeof(uint16_t));
+  const bool footprint_ok = st.capacity_bytes == FEB_HIST_BUF_BYTES && st.used_bytes <= st.capacity_bytes &&
+                            window_ms >= TEST_MIN_WINDOW_MS;
+  report("footprint", st.records, st.capacity_bytes + prev_bytes, footprint_ok ? 0U : 1U);
+  failures += footprint_ok ? 0U : 1U;
+
+  fprintf(stderr, "scans: %u s at %u ms, %u voltage x %u + %u temp x %u channels, seed 0x%08X\n",
+          TEST_SCAN_SECONDS, TEST_SCAN_PERIOD_MS, TEST_SCANS, FEB_HIST_VOLTAGE_CHANNELS, TEST_SCANS,
+          FEB_HIST_TEMP_CHANNELS, TEST_SEED);
+  fprintf(stderr, "ring: %u records held (%u evicted), %u decoded byte-exact, %u mismatches\n", st.records,
+          st.evicted, ring.records, ring.mismatches);
+  fprintf(stderr, "dump: %u bytes in %u frames on 0x%03X, %u records, %u mismatches\n", dumped,
+          (dumped + FEB_CAN_EXT_BMS_HIST_CHUNK - 1U) / FEB_CAN_EXT_BMS_HIST_CHUNK + 1U,
+          (unsigned)FEB_CAN_EXT_BMS_HIST_FRAME_ID, lin.records, lin.mismatches);
+  fprintf(stderr, "corrupt: stops at record %u on a bad header and on a cut payload, %s\n", cut_record,
+          corrupt_mismatches == 0U ? "earlier records intact" : "WRONG");
+  fprintf(stderr, "footprint: ring %u B + previous frames %u B, cursor %zu B; %.1f s held at %.0f B/s\n",
+          st.capacity_bytes, prev_bytes, sizeof(FEB_Cell_History_Cursor_t), window_ms / 1000.0,
+          st.used_bytes * 1000.0 / window_ms);
+  fprintf(stderr, "%s\n", failures == 0U ? "PASS" : "FAIL");
+  return failures == 0U ? 0 : 1;
+}
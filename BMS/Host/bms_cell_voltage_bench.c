@@ -0,0 +1,532 @@
+/**
+ ******************************************************************************
+ * @file           : bms_cell_voltage_bench.c
+ * @brief          : Integer cell-voltage pass vs the former float passes
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Feeds the same randomized rdcv/rdsv register images to
+ * FEB_Cell_Voltage_Process() and to a copy of the float path it replaced
+ * (store_cell_voltages() + validate_voltages(), and the balancing delta /
+ * status loops that fetched every cell through the mutex-taking getter):
+ *
+ *   equivalence - BENCH_SCANS scans around BENCH_CELL_NOMINAL_MV, with
+ *                 register groups failing PEC, cells held out of range for
+ *                 a few scans (C and S, or C alone) and codes landing
+ *                 exactly on a limit. Per scan: badReadV, every violation
+ *                 counter and every latch event must match; total, min and
+ *                 max must agree within the float path's rounding; the
+ *                 delta is compared on scans with no PEC failure only (the
+ *                 float getter loop also counted cells holding a stale
+ *                 reading). A code exactly on a limit can judge differently
+ *                 (float mV vs the integer mV limit); those cells are
+ *                 reported as boundary_diffs and re-synced, not failed.
+ *   timing      - one scan through each path: process = register images to
+ *                 aggregates + limit check, query = the balancing delta and
+ *                 status reads. The mutex is a host osMutex standing in for
+ *                 ADBMSMutexHandle; the temperature gate both paths share is
+ *                 left out.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted.
+ * Compare the rows with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `path,scans,mismatches,boundary_diffs,max_total_err_uV,max_minmax_err_uV,max_delta_err_uV,process_ns,query_ns`
+ * stderr: summary. Exit status 1 on any mismatch or an aggregate outside
+ * tolerance, 2 if the mutex cannot be created.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_Cell_Voltage.h"
+#include "FEB_Config.h"
+#include "cmsis_os2.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_SEED 0x6830B014U
+#define BENCH_SCANS 20000U
+#define BENCH_CELL_NOMINAL_MV 3700     /* Spread of healthy cells: nominal +/- jitter */
+#define BENCH_CELL_JITTER_MV 60
+#define BENCH_PEC_FAIL_PERMILLE 10     /* Per register group, per scan */
+#define BENCH_EXCURSION_PERMILLE 2     /* Per cell, per scan: start an out-of-range run */
+#define BENCH_BOUNDARY_PERMILLE 1      /* Per cell, per scan: code exactly on a limit */
+#define BENCH_TOTAL_TOL_UV 2000.0      /* Float sum of FEB_NUM_CELLS cells */
+#define BENCH_MINMAX_TOL_UV 5.0        /* One float conversion */
+#define BENCH_SLIPPAGE_MV 30.0f        /* FEB_MIN_SLIPPAGE_uV / 1000 */
+#define BENCH_TIMING_REPS 20000U
+
+typedef struct
+{
+  uint32_t scans;
+  uint32_t mismatches;
+  uint32_t boundary_diffs;
+  double max_total_err_uV;
+  double max_minmax_err_uV;
+  double max_delta_err_uV;
+  double process_ns;
+  double query_ns;
+} bench_result_t;
+
+/* ============================================================================
+ * Former float path
+ * ============================================================================ */
+
+typedef struct
+{
+  float voltage_V[FEB_NBANKS][FEB_NUM_CELLS_PER_BANK];
+  float voltage_S[FEB_NBANKS][FEB_NUM_CELLS_PER_BANK];
+  uint8_t violations[FEB_NBANKS][FEB_NUM_CELLS_PER_BANK];
+  uint8_t badReadV[FEB_NBANKS];
+  float total_voltage_V;
+  float pack_min_voltage_V;
+  float pack_max_voltage_V;
+} float_acc_t;
+
+static float_acc_t old_acc;
+static bool old_latched[FEB_NBANKS][FEB_NUM_CELLS_PER_BANK];
+static osMutexId_t bench_mutex;
+
+static float convert_voltage(int16_t raw_code)
+{
+  return raw_code * ADBMS_ADC_LSB_V + ADBMS_ADC_OFFSET_V;
+}
+
+static void float_store(const cell_asic *ics)
+{
+  old_acc.total_voltage_V = 0;
+  float min_cell_V = FLT_MAX;
+  float max_cell_V = -FLT_MAX;
+
+  for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
+  {
+    old_acc.badReadV[bank] = 0;
+    for (uint8_t ic = 0; ic < FEB_NUM_ICPBANK; ic++)
+    {
+      const cv *regs = &ics[ic + bank * FEB_NUM_ICPBANK].cells;
+      for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_IC; cell++)
+      {
+        if (regs->pec_match[cell / 3] != 0)
+        {
+          old_acc.badReadV[bank]++;
+          continue;
+        }
+        float CVoltage = convert_voltage((int16_t)regs->c_codes[cell]);
+        float SVoltage = convert_voltage((int16_t)regs->s_codes[cell]);
+        old_acc.voltage_V[bank][cell + ic * FEB_NUM_CELLS_PER_IC] = CVoltage;
+        old_acc.voltage_S[bank][cell + ic * FEB_NUM_CELLS_PER_IC] = SVoltage;
+        old_acc.total_voltage_V += CVoltage;
+        if (CVoltage >= 0.0f)
+        {
+          if (CVoltage < min_cell_V)
+            min_cell_V = CVoltage;
+          if (CVoltage > max_cell_V)
+            max_cell_V = CVoltage;
+        }
+      }
+    }
+  }
+  old_acc.pack_min_voltage_V = min_cell_V;
+  old_acc.pack_max_voltage_V = max_cell_V;
+}
+
+static void float_validate(void)
+{
+  uint16_t vMax = FEB_Config_Get_Cell_Max_Voltage_mV();
+  uint16_t vMin = FEB_Config_Get_Cell_Min_Voltage_mV();
+
+  for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
+  {
+    for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_BANK; cell++)
+    {
+      float voltageC = old_acc.voltage_V[bank][cell] * 1000;
+      float voltageS = old_acc.voltage_S[bank][cell] * 1000;
+      const bool primary_bad = (voltageC > vMax || voltageC < vMin);
+      const bool secondary_bad = (voltageS > vMax || voltageS < vMin);
+#if FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && !FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
+      const bool violation = secondary_bad;
+      (void)primary_bad;
+#elif !FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS
+      const bool violation = primary_bad;
+      (void)secondary_bad;
+#else
+      const bool violation = primary_bad && secondary_bad;
+#endif
+      old_latched[bank][cell] = false;
+      if (violation)
+      {
+        if (old_acc.violations[bank][cell] < FEB_VOLTAGE_ERROR_THRESH)
+        {
+          old_acc.violations[bank][cell] += 1;
+          old_latched[bank][cell] = (old_acc.violations[bank][cell] >= FEB_VOLTAGE_ERROR_THRESH);
+        }
+      }
+      else
+      {
+        old_acc.violations[bank][cell] = 0;
+      }
+    }
+  }
+}
+
+static float float_get_cell_voltage(uint8_t bank, uint16_t cell)
+{
+  if (bank >= FEB_NBANKS || cell >= FEB_NUM_CELLS_PER_BANK)
+  {
+    return -1.0f;
+  }
+  osMutexAcquire(bench_mutex, osWaitForever);
+  float voltage = old_acc.voltage_V[bank][cell];
+  osMutexRelease(bench_mutex);
+  return voltage;
+}
+
+/* FEB_ADBMS_GET_Cell_Voltage_Delta_mV() and the body of
+ * FEB_Cell_Balancing_Status() both ran this loop. */
+static float float_delta_mV(void)
+{
+  float min_v = FLT_MAX;
+  float max_v = -FLT_MAX;
+  for (uint8_t i = 0; i < FEB_NBANKS; ++i)
+  {
+    for (uint16_t j = 0; j < FEB_NUM_CELLS_PER_BANK; ++j)
+    {
+      const float voltage = float_get_cell_voltage(i, j) * 1000.0f;
+      if (voltage < 0)
+      {
+        continue;
+      }
+      if (voltage < min_v)
+        min_v = voltage;
+      if (voltage > max_v)
+        max_v = voltage;
+    }
+  }
+  if (max_v < 0 || min_v > 1e8f)
+  {
+    return -1.0f;
+  }
+  return max_v - min_v;
+}
+
+/* ============================================================================
+ * Integer path
+ * ============================================================================ */
+
+static accumulator_t new_acc;
+static bool new_latched[FEB_NBANKS][FEB_NUM_CELLS_PER_BANK];
+
+static void on_latch(uint8_t bank, uint8_t bank_cell, int32_t uV_C, int32_t uV_S)
+{
+  (void)uV_C;
+  (void)uV_S;
+  new_latched[bank][bank_cell] = true;
+}
+
+static void int_process(const cell_asic *ics)
+{
+  FEB_Cell_Voltage_Process(&new_acc, ics, (int32_t)FEB_Config_Get_Cell_Min_Voltage_mV() * 1000,
+                           (int32_t)FEB_Config_Get_Cell_Max_Voltage_mV() * 1000, on_latch);
+}
+
+/* FEB_ADBMS_GET_Cell_Voltage_Delta_mV(): two aggregates under the mutex */
+static float int_delta_mV(void)
+{
+  osMutexAcquire(bench_mutex, osWaitForever);
+  const int32_t min_uV = new_acc.pack_min_voltage_uV;
+  const int32_t max_uV = new_acc.pack_max_voltage_uV;
+  osMutexRelease(bench_mutex);
+  if (max_uV < min_uV)
+  {
+    return -1.0f;
+  }
+  return (max_uV - min_uV) / 1000.0f;
+}
+
+/* ============================================================================
+ * Scan generator
+ * ============================================================================ */
+
+static cell_asic ics[FEB_NUM_IC];
+static uint8_t excursion_left[FEB_NUM_CELLS];
+static bool excursion_c_only[FEB_NUM_CELLS];
+
+static uint32_t rng_state = BENCH_SEED;
+
+static uint32_t rng(void)
+{
+  /* xorshift32 */
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static bool chance(uint32_t permille)
+{
+  return (rng() % 1000U) < permille;
+}
+
+static uint16_t code_for_uV(int32_t uV)
+{
+  return (uint16_t)(int16_t)((uV - ADBMS_ADC_OFFSET_UV) / ADBMS_ADC_LSB_UV);
+}
+
+static int32_t healthy_uV(void)
+{
+  const int32_t jitter_uV = BENCH_CELL_JITTER_MV * 1000;
+  return BENCH_CELL_NOMINAL_MV * 1000 - jitter_uV + (int32_t)(rng() % (uint32_t)(2 * jitter_uV + 1));
+}
+
+static int32_t excursion_uV(void)
+{
+  const int32_t vMax_uV = (int32_t)FEB_Config_Get_Cell_Max_Voltage_mV() * 1000;
+  const int32_t vMin_uV = (int32_t)FEB_Config_Get_Cell_Min_Voltage_mV() * 1000;
+  return (rng() & 1U) ? vMax_uV + 1000 + (int32_t)(rng() % 200000U) : vMin_uV - 1000 - (int32_t)(rng() % 200000U);
+}
+
+static void generate_scan(void)
+{
+  const int32_t limits_uV[2] = {(int32_t)FEB_Config_Get_Cell_Min_Voltage_mV() * 1000,
+                                (int32_t)FEB_Config_Get_Cell_Max_Voltage_mV() * 1000};
+
+  for (uint16_t ic = 0; ic < FEB_NUM_IC; ic++)
+  {
+    cv *regs = &ics[ic].cells;
+    for (uint8_t reg = 0; reg < 6; reg++)
+    {
+      regs->pec_match[reg] = chance(BENCH_PEC_FAIL_PERMILLE) ? 1 : 0;
+    }
+    for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_IC; cell++)
+    {
+      const uint16_t idx = ic * FEB_NUM_CELLS_PER_IC + cell;
+      int32_t c_uV = healthy_uV();
+      int32_t s_uV = c_uV + (int32_t)(rng() % 2001U) - 1000;
+
+      if (excursion_left[idx] == 0 && chance(BENCH_EXCURSION_PERMILLE))
+      {
+        excursion_left[idx] = (uint8_t)(1U + rng() % (2U * FEB_VOLTAGE_ERROR_THRESH));
+        excursion_c_only[idx] = chance(250);
+      }
+      if (excursion_left[idx] > 0)
+      {
+        excursion_left[idx]--;
+        c_uV = excursion_uV();
+        if (!excursion_c_only[idx])
+        {
+          s_uV = c_uV;
+        }
+      }
+      else if (chance(BENCH_BOUNDARY_PERMILLE))
+      {
+        c_uV = limits_uV[rng() & 1U];
+        s_uV = chance(500) ? c_uV : limits_uV[rng() & 1U];
+      }
+      regs->c_codes[cell] = code_for_uV(c_uV);
+      regs->s_codes[cell] = code_for_uV(s_uV);
+    }
+  }
+}
+
+/* ============================================================================
+ * Equivalence
+ * ============================================================================ */
+
+static bool on_limit(int16_t code)
+{
+  const int32_t uV = ADBMS_CODE_TO_UV(code);
+  return uV == (int32_t)FEB_Config_Get_Cell_Min_Voltage_mV() * 1000 ||
+         uV == (int32_t)FEB_Config_Get_Cell_Max_Voltage_mV() * 1000;
+}
+
+static void compare_scan(bench_result_t *r, bool any_pec_fail)
+{
+  for (uint8_t bank = 0; bank < FEB_NBANKS; bank++)
+  {
+    if (old_acc.badReadV[bank] != new_acc.banks[bank].badReadV)
+    {
+      r->mismatches++;
+    }
+    for (uint8_t cell = 0; cell < FEB_NUM_CELLS_PER_BANK; cell++)
+    {
+      const uint16_t idx = bank * FEB_NUM_CELLS_PER_BANK + cell;
+      const uint8_t new_count = new_acc.banks[bank].cells[cell].violations;
+      if (old_acc.violations[bank][cell] == new_count && old_latched[bank][cell] == new_latched[bank][cell])
+      {
+        continue;
+      }
+      if (on_limit(new_acc.cell_c_codes[idx]) || on_limit(new_acc.cell_s_codes[idx]))
+      {
+        r->boundary_diffs++;
+        old_acc.violations[bank][cell] = new_count;
+      }
+      else
+      {
+        r->mismatches++;
+      }
+    }
+  }
+
+  const double total_err = fabs((double)old_acc.total_voltage_V * 1e6 - (double)new_acc.total_voltage_uV);
+  const double min_err = fabs((double)old_acc.pack_min_voltage_V * 1e6 - (double)new_acc.pack_min_voltage_uV);
+  const double max_err = fabs((double)old_acc.pack_max_voltage_V * 1e6 - (double)new_acc.pack_max_voltage_uV);
+  r->max_total_err_uV = fmax(r->max_total_err_uV, total_err);
+  r->max_minmax_err_uV = fmax(r->max_minmax_err_uV, fmax(min_err, max_err));
+
+  if (!any_pec_fail)
+  {
+    const double delta_err = fabs(((double)float_delta_mV() - (double)int_delta_mV()) * 1000.0);
+    r->max_delta_err_uV = fmax(r->max_delta_err_uV, delta_err);
+  }
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+static volatile float sink;
+
+static void time_float(bench_result_t *r)
+{
+  uint64_t process_ns = 0, query_ns = 0;
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    uint64_t t0 = now_ns();
+    float_store(ics);
+    float_validate();
+    process_ns += elapsed_ns(t0, now_ns());
+
+    t0 = now_ns();
+    const float delta = float_delta_mV(); /* Delta getter */
+    const bool status = float_delta_mV() >= BENCH_SLIPPAGE_MV; /* Balancing_Status */
+    query_ns += elapsed_ns(t0, now_ns());
+    sink = delta + (float)status;
+  }
+  r->process_ns = (double)process_ns / BENCH_TIMING_REPS;
+  r->query_ns = (double)query_ns / BENCH_TIMING_REPS;
+}
+
+static void time_int(bench_result_t *r)
+{
+  uint64_t process_ns = 0, query_ns = 0;
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    uint64_t t0 = now_ns();
+    int_process(ics);
+    process_ns += elapsed_ns(t0, now_ns());
+
+    t0 = now_ns();
+    const float delta = int_delta_mV();
+    const bool status = int_delta_mV() >= BENCH_SLIPPAGE_MV;
+    query_ns += elapsed_ns(t0, now_ns());
+    sink = delta + (float)status;
+  }
+  r->process_ns = (double)process_ns / BENCH_TIMING_REPS;
+  r->query_ns = (double)query_ns / BENCH_TIMING_REPS;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  bench_result_t ref = {0}, fused = {0};
+
+  bench_mutex = osMutexNew(NULL);
+  if (bench_mutex == NULL)
+  {
+    fprintf(stderr, "osMutexNew failed\n");
+    return 2;
+  }
+
+  for (uint32_t scan = 0; scan < BENCH_SCANS; scan++)
+  {
+    generate_scan();
+    bool any_pec_fail = false;
+    for (uint16_t ic = 0; ic < FEB_NUM_IC; ic++)
+    {
+      for (uint8_t reg = 0; reg < 6; reg++)
+      {
+        any_pec_fail |= (ics[ic].cells.pec_match[reg] != 0);
+      }
+    }
+
+    memset(new_latched, 0, sizeof(new_latched));
+    float_store(ics);
+    float_validate();
+    int_process(ics);
+    compare_scan(&fused, any_pec_fail);
+    ref.scans++;
+    fused.scans++;
+  }
+
+  calibrate_clock();
+  time_float(&ref);
+  time_int(&fused);
+
+  printf("path,scans,mismatches,boundary_diffs,max_total_err_uV,max_minmax_err_uV,max_delta_err_uV,process_ns,"
+         "query_ns\n");
+  const bench_result_t *rows[] = {&ref, &fused};
+  const char *names[] = {"float", "int"};
+  for (int i = 0; i < 2; i++)
+  {
+    const bench_result_t *r = rows[i];
+    printf("%s,%u,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f\n", names[i], r->scans, r->mismatches, r->boundary_diffs,
+           r->max_total_err_uV, r->max_minmax_err_uV, r->max_delta_err_uV, r->process_ns, r->query_ns);
+  }
+
+  const bool ok = (fused.mismatches == 0U) && (fused.max_total_err_uV <= BENCH_TOTAL_TOL_UV) &&
+                  (fused.max_minmax_err_uV <= BENCH_MINMAX_TOL_UV) && (fused.max_delta_err_uV <= 2.0 * BENCH_MINMAX_TOL_UV);
+  fprintf(stderr, "scans: %u x %u cells, limits %u..%u mV, seed 0x%08X\n", fused.scans, (unsigned)FEB_NUM_CELLS,
+          FEB_Config_Get_Cell_Min_Voltage_mV(), FEB_Config_Get_Cell_Max_Voltage_mV(), BENCH_SEED);
+  fprintf(stderr, "equivalence: %u mismatches, %u on-limit judgment diffs (float mV vs integer limit)\n",
+          fused.mismatches, fused.boundary_diffs);
+  fprintf(stderr, "error: total %.1f uV (limit %.0f), min/max %.1f uV (limit %.0f), delta %.1f uV\n",
+          fused.max_total_err_uV, BENCH_TOTAL_TOL_UV, fused.max_minmax_err_uV, BENCH_MINMAX_TOL_UV,
+          fused.max_delta_err_uV);
+  fprintf(stderr, "process: float %.1f ns/scan, int %.1f ns/scan (%.1fx)\n", ref.process_ns, fused.process_ns,
+          fused.process_ns > 0.0 ? ref.process_ns / fused.process_ns : 0.0);
+  fprintf(stderr, "query: float %.1f ns, int %.1f ns (%.1fx)\n", ref.query_ns, fused.query_ns,
+          fused.query_ns > 0.0 ? ref.query_ns / fused.query_ns : 0.0);
+  fprintf(stderr, "%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,287 @@
+/**
+ ******************************************************************************
+ * @file           : bms_pec_bench.c
+ * @brief          : PEC15 / PEC10 conformance and throughput, per engine
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Built once per ADBMS_PEC_ENGINE (bms_pec_bench_slice4,
+ * bms_pec_bench_reference) so both implementations in FEB_AD68xx_PEC.c are
+ * held to the same bit-serial model of the datasheet polynomials:
+ *
+ *   PEC15 - x^15 + x^14 + x^10 + x^8 + x^7 + x^4 + x^3 + 1 (0x4599), seed
+ *           0x0010, data MSB first, result shifted left one bit.
+ *   PEC10 - x^10 + x^7 + x^3 + x^2 + x + 1 (0x08F), seed 0x0010, data MSB
+ *           first followed by the 6-bit command counter (upper six bits of
+ *           the byte after the data on RX, zero on TX).
+ *
+ *   conformance - every 2-byte command, BENCH_RANDOM_BUFFERS seeded buffers
+ *                 of 0..BENCH_MAX_LEN bytes through PEC15 and both PEC10
+ *                 directions, and datasheet vectors (RDCVA).
+ *   throughput  - the sizes the driver sends: a 2-byte command (PEC15), a
+ *                 6-byte register group read (PEC10 RX) and written (PEC10
+ *                 TX), and a 32-byte buffer for the table engines' stride.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted.
+ * Compare the engines with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `engine,case,bytes,mismatches,bytes_per_us`
+ * stderr: summary. Exit status 1 on any mismatch.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_AD68xx_Interface.h"
+#include "FEB_Const.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_SEED 0xADB16830U
+#define BENCH_RANDOM_BUFFERS 2000000U
+#define BENCH_MAX_LEN 32U
+#define BENCH_TIMING_BYTES (64U * 1024U * 1024U) /* Per case */
+#define BENCH_POOL_BUFFERS 256U                   /* Distinct inputs the timing cycles through */
+
+#if (ADBMS_PEC_ENGINE == ADBMS_PEC_ENGINE_SLICE4)
+#define BENCH_ENGINE_NAME "slice4"
+#else
+#define BENCH_ENGINE_NAME "reference"
+#endif
+
+/* ============================================================================
+ * Bit-serial model
+ * ============================================================================ */
+
+static uint16_t model_shift(uint16_t rem, uint8_t bit, uint8_t width, uint16_t poly)
+{
+  const uint16_t mask = (uint16_t)((1U << width) - 1U);
+  const uint8_t in = (uint8_t)(((rem >> (width - 1U)) & 1U) ^ bit);
+  rem = (uint16_t)((rem << 1) & mask);
+  return in ? (uint16_t)(rem ^ poly) : rem;
+}
+
+static uint16_t model_pec15(uint8_t len, const uint8_t *data)
+{
+  uint16_t rem = 0x0010;
+  for (uint8_t i = 0; i < len; i++)
+  {
+    for (int8_t b = 7; b >= 0; b--)
+    {
+      rem = model_shift(rem, (uint8_t)((data[i] >> b) & 1U), 15, 0x4599);
+    }
+  }
+  return (uint16_t)(rem << 1);
+}
+
+static uint16_t model_pec10(bool rx, uint8_t len, const uint8_t *data)
+{
+  uint16_t rem = 0x0010;
+  for (uint8_t i = 0; i < len; i++)
+  {
+    for (int8_t b = 7; b >= 0; b--)
+    {
+      rem = model_shift(rem, (uint8_t)((data[i] >> b) & 1U), 10, 0x08F);
+    }
+  }
+  const uint8_t cc = rx ? (uint8_t)(data[len] >> 2) : 0U;
+  for (int8_t b = 5; b >= 0; b--)
+  {
+    rem = model_shift(rem, (uint8_t)((cc >> b) & 1U), 10, 0x08F);
+  }
+  return rem;
+}
+
+/* ============================================================================
+ * Conformance
+ * ============================================================================ */
+
+static uint32_t rng_state = BENCH_SEED;
+
+static uint32_t rng(void)
+{
+  /* xorshift32 */
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+typedef struct
+{
+  uint32_t pec15_cmd;
+  uint32_t pec15;
+  uint32_t pec10_rx;
+  uint32_t pec10_tx;
+  uint32_t vectors;
+} mismatches_t;
+
+static void check_conformance(mismatches_t *m)
+{
+  uint8_t buf[BENCH_MAX_LEN + 1];
+
+  for (uint32_t cmd = 0; cmd <= 0xFFFFU; cmd++)
+  {
+    buf[0] = (uint8_t)(cmd >> 8);
+    buf[1] = (uint8_t)cmd;
+    if (pec15_calc(2, buf) != model_pec15(2, buf))
+    {
+      m->pec15_cmd++;
+    }
+  }
+
+  for (uint32_t n = 0; n < BENCH_RANDOM_BUFFERS; n++)
+  {
+    const uint8_t len = (uint8_t)(rng() % (BENCH_MAX_LEN + 1U));
+    for (uint8_t i = 0; i <= len; i++)
+    {
+      buf[i] = (uint8_t)rng();
+    }
+    if (pec15_calc(len, buf) != model_pec15(len, buf))
+    {
+      m->pec15++;
+    }
+    if (Pec10_calc(true, len, buf) != model_pec10(true, len, buf))
+    {
+      m->pec10_rx++;
+    }
+    if (Pec10_calc(false, len, buf) != model_pec10(false, len, buf))
+    {
+      m->pec10_tx++;
+    }
+  }
+
+  /* RDCVA (0x0004): PEC 0x07C2 in the ADBMS6830B command table */
+  uint8_t rdcva[2] = {0x00, 0x04};
+  if (pec15_calc(2, rdcva) != 0x07C2 || model_pec15(2, rdcva) != 0x07C2)
+  {
+    m->vectors++;
+  }
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+static volatile uint16_t sink;
+
+typedef enum
+{
+  CASE_PEC15,
+  CASE_PEC10_RX,
+  CASE_PEC10_TX
+} pec_case_t;
+
+/* Bytes per microsecond over BENCH_TIMING_BYTES of len-byte calls. Calls
+ * cycle through a pool of prefilled buffers: writing the buffer inside the
+ * timed loop would stall a wide load on store forwarding and time that
+ * instead of the CRC. */
+static uint8_t pool[BENCH_POOL_BUFFERS][BENCH_MAX_LEN + 1];
+
+static double time_case(pec_case_t c, uint8_t len)
+{
+  const uint32_t calls = BENCH_TIMING_BYTES / len;
+  uint16_t acc = 0;
+
+  uint64_t t0 = now_ns();
+  for (uint32_t n = 0; n < calls; n++)
+  {
+    uint8_t *buf = pool[n % BENCH_POOL_BUFFERS];
+    switch (c)
+    {
+      case CASE_PEC15:
+        acc ^= pec15_calc(len, buf);
+        break;
+      case CASE_PEC10_RX:
+        acc ^= Pec10_calc(true, len, buf);
+        break;
+      case CASE_PEC10_TX:
+      default:
+        acc ^= Pec10_calc(false, len, buf);
+        break;
+    }
+  }
+  const uint64_t total_ns = elapsed_ns(t0, now_ns());
+  sink = acc;
+  return total_ns > 0 ? (double)calls * len * 1000.0 / (double)total_ns : 0.0;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  mismatches_t m = {0};
+  check_conformance(&m);
+
+  for (uint32_t b = 0; b < BENCH_POOL_BUFFERS; b++)
+  {
+    for (uint8_t i = 0; i <= BENCH_MAX_LEN; i++)
+    {
+      pool[b][i] = (uint8_t)rng();
+    }
+  }
+
+  calibrate_clock();
+  const struct
+  {
+    const char *name;
+    pec_case_t c;
+    uint8_t len;
+    uint32_t mismatches;
+  } cases[] = {
+      {"pec15_cmd", CASE_PEC15, 2, m.pec15_cmd + m.vectors},
+      {"pec10_rx_group", CASE_PEC10_RX, 6, m.pec10_rx},
+      {"pec10_tx_group", CASE_PEC10_TX, 6, m.pec10_tx},
+      {"pec15_32", CASE_PEC15, 32, m.pec15},
+  };
+
+  printf("engine,case,bytes,mismatches,bytes_per_us\n");
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    const double rate = time_case(cases[i].c, cases[i].len);
+    printf("%s,%s,%u,%u,%.1f\n", BENCH_ENGINE_NAME, cases[i].name, cases[i].len, cases[i].mismatches, rate);
+    fprintf(stderr, "%-9s %-15s %2u B  %7.1f B/us\n", BENCH_ENGINE_NAME, cases[i].name, cases[i].len, rate);
+  }
+
+  const uint32_t total = m.pec15_cmd + m.pec15 + m.pec10_rx + m.pec10_tx + m.vectors;
+  fprintf(stderr, "conformance: 65536 commands, %u buffers of 0..%u B, %u mismatches (RDCVA %s)\n",
+          BENCH_RANDOM_BUFFERS, BENCH_MAX_LEN, total, m.vectors ? "WRONG" : "0x07C2");
+  fprintf(stderr, "%s\n", total == 0U ? "PASS" : "FAIL");
+  return total == 0U ? 0 : 1;
+}
@@ -0,0 +1,432 @@
+/**
+ ******************************************************************************
+ * @file           : bms_replay_plant.c
+ * @brief          : BMS SM replay - relay and cell-monitor plant model
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ */
+
+#include "bms_replay_plant.h"
+
+#include "FEB_ADBMS6830B.h"
+#include "FEB_CAN_IVT.h"
+#include "FEB_Config.h"
+#include "FEB_Const.h"
+#include "FEB_HW_Relay.h"
+#include "FEB_SM.h"
+#include "FEB_SOC.h"
+#include "feb_time.h"
+
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+/* ============================================================================
+ * Internal State
+ * ============================================================================ */
+
+static const char *const input_names[BMS_PLANT_IN_COUNT] = {
+    "SDC", "SHUTDOWN", "AIR_MINUS", "AIR_PLUS", "PRECHARGE", "IMD", "RESET",
+};
+
+static int input_level[BMS_PLANT_IN_COUNT];
+static BMS_Plant_Outputs_t outputs;
+
+/* Readings the next scans report */
+static bool cells_set;
+static float cell_pack_v, cell_min_v, cell_max_v;
+static bool temps_set;
+static float temp_min_c, temp_max_c, temp_valid_pct;
+
+/* Published by the last completed scans */
+static float snap_pack_v, snap_min_v, snap_max_v;
+static float snap_min_c = NAN, snap_max_c = NAN;
+static uint32_t fault_flags;
+static uint32_t last_update_tick;
+
+/* Scan schedule and debounce state */
+static uint32_t voltage_tick, temp_tick;
+static uint8_t voltage_violations, temp_violations;
+static uint32_t telemetry_loss_tick;
+static FEB_SOC_t soc_est;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static bool level_closed(BMS_Plant_Input_t input, bool model)
+{
+  int level = input_level[input];
+  return (level == BMS_PLANT_LEVEL_AUTO) ? model : (level == BMS_PLANT_LEVEL_CLOSE);
+}
+
+static bool shutdown_closed(void)
+{
+  bool loop = level_closed(BMS_PLANT_IN_SDC, false) && outputs.bms_shutdown;
+  return level_closed(BMS_PLANT_IN_SHUTDOWN, loop);
+}
+
+static FEB_Relay_State_t relay_state(bool closed)
+{
+  return closed ? FEB_RELAY_STATE_CLOSE : FEB_RELAY_STATE_OPEN;
+}
+
+/* Latch new fault bits and wake the SM with the scan's sample time, as
+ * notify_new_faults() does in FEB_ADBMS6830B.c. */
+static void latch_faults(uint32_t flags, uint64_t sample_us)
+{
+  uint32_t added = flags & ~fault_flags;
+  fault_flags |= flags;
+  if (added != 0U)
+  {
+    FEB_SM_Notify_Event(FEB_SM_EVENT_ADBMS, sample_us);
+  }
+}
+
+/* Pack-extreme version of validate_cell_voltage(): the extreme cell is the
+ * one whose counter trips first, so the debounce lands on the same scan. */
+static void voltage_scan(uint32_t tick)
+{
+  uint64_t sample_us = FEB_Time_Us();
+
+  snap_pack_v = cell_pack_v;
+  snap_min_v = cell_min_v;
+  snap_max_v = cell_max_v;
+
+  float max_mV = cell_max_v * 1000.0f;
+  float min_mV = cell_min_v * 1000.0f;
+  bool violation = max_mV > (float)FEB_Config_Get_Cell_Max_Voltage_mV() ||
+                   min_mV < (float)FEB_Config_Get_Cell_Min_Voltage_mV();
+  if (!violation)
+  {
+    voltage_violations = 0;
+  }
+  else if (voltage_violations < FEB_VOLTAGE_ERROR_THRESH)
+  {
+    voltage_violations++;
+#if !(FEB_BMS_DISABLE_PRIMARY_VOLT_CHECKS && FEB_BMS_DISABLE_SECONDARY_VOLT_CHECKS)
+    if (voltage_violations >= FEB_VOLTAGE_ERROR_THRESH)
+    {
+      latch_faults(ADBMS_FAULT_FLAG_VOLTAGE, sample_us);
+    }
+#endif
+  }
+
+  /* Same estimator step as update_soc(), on the pack reading and IVT current */
+  if (cells_set)
+  {
+    bool ivt_fresh = FEB_CAN_IVT_IsDataFresh(100);
+    FEB_SOC_Step(&soc_est, (float)BMS_PLANT_VOLTAGE_SCAN_MS * 0.001f, ivt_fresh ? FEB_CAN_IVT_GetCurrent() : 0.0f,
+                 ivt_fresh, cell_pack_v, FEB_NUM_CELLS);
+  }
+
+  last_update_tick = tick;
+}
+
+/* Pack-extreme version of validate_temps(): limit debounce on the hottest and
+ * coldest valid sensor, then the telemetry-loss timer on the valid share. */
+static void temp_scan(uint32_t tick)
+{
+  uint64_t sample_us = FEB_Time_Us();
+  bool any_valid = temp_valid_pct > 0.0f;
+
+  snap_min_c = any_valid ? temp_min_c : NAN;
+  snap_max_c = any_valid ? temp_max_c : NAN;
+
+  bool violation = any_valid && (temp_max_c * 10.0f > (float)FEB_Config_Get_Cell_Max_Temperature_dC() ||
+                                 temp_min_c * 10.0f < (float)FEB_Config_Get_Cell_Min_Temperature_dC());
+  if (!violation)
+  {
+    temp_violations = 0;
+  }
+  else if (temp_violations < FEB_TEMP_ERROR_THRESH)
+  {
+    temp_violations++;
+#if !FEB_BMS_DISABLE_TEMP_CHECKS
+    if (temp_violations >= FEB_TEMP_ERROR_THRESH)
+    {
+      latch_faults(ADBMS_FAULT_FLAG_TEMP, sample_us);
+    }
+#endif
+  }
+
+  if (temp_valid_pct < FEB_TEMP_MIN_VALID_FRACTION * 100.0f)
+  {
+    if (telemetry_loss_tick == 0)
+    {
+      telemetry_loss_tick = (tick == 0) ? 1U : tick;
+    }
+    else if ((tick - telemetry_loss_tick) >= FEB_TEMP_TELEMETRY_TIMEOUT_MS)
+    {
+#if !FEB_BMS_DISABLE_TEMP_CHECKS
+      latch_faults(ADBMS_FAULT_FLAG_SENSOR, sample_us);
+#endif
+    }
+  }
+  else
+  {
+    telemetry_loss_tick = 0;
+  }
+
+  last_update_tick = tick;
+}
+
+/* ============================================================================
+ * Plant Control
+ * ============================================================================ */
+
+void BMS_Plant_Init(void)
+{
+  for (int i = 0; i < BMS_PLANT_IN_COUNT; i++)
+  {
+    input_level[i] = BMS_PLANT_LEVEL_AUTO;
+  }
+  input_level[BMS_PLANT_IN_SDC] = BMS_PLANT_LEVEL_OPEN;
+  input_level[BMS_PLANT_IN_IMD] = BMS_PLANT_LEVEL_CLOSE;
+  input_level[BMS_PLANT_IN_RESET] = BMS_PLANT_LEVEL_OPEN;
+
+  memset(&outputs, 0, sizeof(outputs));
+  cells_set = false;
+  temps_set = false;
+  snap_pack_v = snap_min_v = snap_max_v = 0.0f;
+  snap_min_c = snap_max_c = NAN;
+  fault_flags = 0;
+  last_update_tick = 0;
+  voltage_violations = 0;
+  temp_violations = 0;
+  telemetry_loss_tick = 0;
+  FEB_SOC_Init(&soc_est);
+}
+
+int BMS_Plant_Input_From_Name(const char *name)
+{
+  for (int i = 0; i < BMS_PLANT_IN_COUNT; i++)
+  {
+    if (strcasecmp(name, input_names[i]) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void BMS_Plant_Set_Input(BMS_Plant_Input_t input, int level)
+{
+  if (input < BMS_PLANT_IN_COUNT)
+  {
+    input_level[input] = level;
+  }
+}
+
+void BMS_Plant_Set_Cells(float pack_v, float min_cell_v, float max_cell_v)
+{
+  cell_pack_v = pack_v;
+  cell_min_v = min_cell_v;
+  cell_max_v = max_cell_v;
+  cells_set = true;
+}
+
+void BMS_Plant_Set_Temps(float min_c, float max_c, float valid_pct)
+{
+  temp_min_c = min_c;
+  temp_max_c = max_c;
+  temp_valid_pct = valid_pct;
+  temps_set = true;
+}
+
+void BMS_Plant_Set_Fault_Flags(uint32_t flags, uint64_t sample_us)
+{
+  uint32_t added = flags & ~fault_flags;
+  fault_flags = flags;
+  if (added != 0U)
+  {
+    FEB_SM_Notify_Event(FEB_SM_EVENT_ADBMS, sample_us);
+  }
+}
+
+void BMS_Plant_Step(uint32_t tick)
+{
+  /* Same phase as StartADBMSTask: temperature half a period behind voltage.
+   * Scans only run once the trace has given them something to report, like a
+   * cell monitor that has not come up yet. */
+  if (!cells_set)
+  {
+    voltage_tick = tick - BMS_PLANT_VOLTAGE_SCAN_MS;
+  }
+  else if ((tick - voltage_tick) >= BMS_PLANT_VOLTAGE_SCAN_MS)
+  {
+    voltage_scan(tick);
+    voltage_tick = tick;
+  }
+
+  if (!temps_set)
+  {
+    temp_tick = tick - FEB_TEMP_SCAN_PERIOD_MS / 2U;
+  }
+  else if ((tick - temp_tick) >= FEB_TEMP_SCAN_PERIOD_MS)
+  {
+    temp_scan(tick);
+    temp_tick = tick;
+  }
+}
+
+void BMS_Plant_Get_Outputs(BMS_Plant_Outputs_t *out)
+{
+  *out = outputs;
+}
+
+/* ============================================================================
+ * FEB_HW_Relay.h
+ * ============================================================================ */
+
+void FEB_HW_AIR_Plus_Set(bool closed)
+{
+  outputs.air_plus = closed;
+}
+
+void FEB_HW_Precharge_Set(bool closed)
+{
+  outputs.precharge = closed;
+}
+
+void FEB_HW_BMS_Shutdown_Set(bool closed)
+{
+  outputs.bms_shutdown = closed;
+}
+
+void FEB_HW_BMS_Indicator_Set(bool on)
+{
+  outputs.bms_indicator = on;
+}
+
+void FEB_HW_Fault_Indicator_Set(bool on)
+{
+  outputs.fault_indicator = on;
+}
+
+void FEB_HW_Buzzer_Set(bool on)
+{
+  outputs.buzzer = on;
+}
+
+void FEB_HW_TSSI_Set(bool green)
+{
+  outputs.tssi_green = green;
+}
+
+FEB_Relay_State_t FEB_HW_Shutdown_Sense(void)
+{
+  return relay_state(shutdown_closed());
+}
+
+FEB_Relay_State_t FEB_HW_AIR_Minus_Sense(void)
+{
+  return relay_state(level_closed(BMS_PLANT_IN_AIR_MINUS, shutdown_closed()));
+}
+
+FEB_Relay_State_t FEB_HW_AIR_Plus_Sense(void)
+{
+  return relay_state(level_closed(BMS_PLANT_IN_AIR_PLUS, outputs.air_plus && shutdown_closed()));
+}
+
+FEB_Relay_State_t FEB_HW_Precharge_Sense(void)
+{
+  return relay_state(level_closed(BMS_PLANT_IN_PRECHARGE, outputs.precharge && shutdown_closed()));
+}
+
+FEB_Relay_State_t FEB_HW_IMD_Sense(void)
+{
+  return relay_state(level_closed(BMS_PLANT_IN_IMD, true));
+}
+
+bool FEB_HW_Reset_Button_Pressed(void)
+{
+  return level_closed(BMS_PLANT_IN_RESET, false);
+}
+
+/* ============================================================================
+ * FEB_ADBMS6830B.h
+ * ============================================================================ */
+
+uint32_t FEB_ADBMS_Get_Fault_Flags(void)
+{
+  return fault_flags;
+}
+
+uint32_t FEB_ADBMS_Get_Last_Update_Tick(void)
+{
+  return last_update_tick;
+}
+
+float FEB_ADBMS_Snapshot_Total_Voltage(void)
+{
+  return snap_pack_v;
+}
+
+float FEB_ADBMS_Snapshot_Max_Cell_Voltage(void)
+{
+  return snap_max_v;
+}
+
+float FEB_ADBMS_Snapshot_Max_Temp(void)
+{
+  return snap_max_c;
+}
+
+void FEB_ADBMS_Get_SOC(FEB_ADBMS_SOC_t *out)
+{
+  memset(out, 0, sizeof(*out));
+  out->soc = soc_est.soc;
+  out->r_ohm = soc_est.r_ohm;
+  out->pack_ocv_V = FEB_SOC_Cell_OCV(soc_est.soc) * (float)FEB_NUM_CELLS;
+  out->ah_out = soc_est.ah_out;
+  out->rls_updates = soc_est.rls_updates;
+  out->flags = soc_est.flags;
+}
+
+float FEB_ADBMS_GET_ACC_Total_Voltage(void)
+{
+  return snap_pack_v;
+}
+
+/* Only the pack extremes are modelled: cell 0 of bank 0 is the lowest cell
+ * and every other cell reads the highest, which is all FEB_CAN_State needs to
+ * publish min/max. Both ADCs agree. */
+float FEB_ADBMS_GET_Cell_Voltage(uint8_t bank, uint16_t cell)
+{
+  return (bank == 0 && cell == 0) ? snap_min_v : snap_max_v;
+}
+
+float FEB_ADBMS_GET_Cell_Voltage_S(uint8_t bank, uint16_t cell)
+{
+  return FEB_ADBMS_GET_Cell_Voltage(bank, cell);
+}
+
+float FEB_ADBMS_GET_ACC_AVG_Temp(void)
+{
+  return (snap_min_c + snap_max_c) * 0.5f;
+}
+
+float FEB_ADBMS_GET_ACC_MAX_Temp(void)
+{
+  return snap_max_c;
+}
+
+float FEB_ADBMS_GET_ACC_MIN_Temp(void)
+{
+  return snap_min_c;
+}
+
+bool FEB_Cell_Balance_Complete(void)
+{
+  if (snap_max_v <= 0.0f)
+  {
+    return false;
+  }
+  return (snap_max_v - snap_min_v) * 1000.0f < (float)FEB_Config_Get_Balance_Threshold_mV();
+}
+
+void FEB_Stop_Balance(void)
+{
+  outputs.balance_stops++;
+}
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : bms_replay_plant.h
+ * @brief          : BMS SM replay - relay and cell-monitor plant model
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Stands in for FEB_HW_Relay.c and the ADBMS task when FEB_SM.c runs on the
+ * host. The state machine sees the same FEB_HW_* and FEB_ADBMS_* surface it
+ * uses on target; the replay drives the plant from trace rows.
+ *
+ * Relays: every sense follows the command and the shutdown loop unless the
+ * trace forces it.
+ *   SHUTDOWN  = SDC (rest of the loop) AND the BMS shutdown relay
+ *   AIR_MINUS = SHUTDOWN (coil powered by the loop)
+ *   AIR_PLUS  = AIR+ command AND SHUTDOWN
+ *   PRECHARGE = precharge command AND SHUTDOWN
+ *   IMD       = closed (IMD OK), RESET = released
+ *
+ * Cell monitor: the trace sets pack-level readings, which are "scanned" at
+ * the ADBMS task cadence (voltage every BMS_PLANT_VOLTAGE_SCAN_MS,
+ * temperature every FEB_TEMP_SCAN_PERIOD_MS, half a period apart). Each scan
+ * runs the same limit debounce as validate_cell_voltage() / validate_temps()
+ * on the pack extremes, so FEB_*_ERROR_THRESH and the telemetry-loss timer
+ * latch ADBMS_FAULT_FLAG_* at the scan they would on target, and the SM is
+ * notified with the scan start time like notify_new_faults().
+ *
+ ******************************************************************************
+ */
+
+#ifndef BMS_REPLAY_PLANT_H
+#define BMS_REPLAY_PLANT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Voltage scan cadence of StartADBMSTask. */
+#define BMS_PLANT_VOLTAGE_SCAN_MS 100U
+
+typedef enum
+{
+  BMS_PLANT_IN_SDC = 0,   /**< Shutdown loop upstream of the BMS relay (default open) */
+  BMS_PLANT_IN_SHUTDOWN,  /**< SHS_IN */
+  BMS_PLANT_IN_AIR_MINUS, /**< AIR- sense */
+  BMS_PLANT_IN_AIR_PLUS,  /**< AIR+ sense */
+  BMS_PLANT_IN_PRECHARGE, /**< Precharge relay sense */
+  BMS_PLANT_IN_IMD,       /**< IMD latch (closed = OK) */
+  BMS_PLANT_IN_RESET,     /**< Reset button (closed = pressed) */
+  BMS_PLANT_IN_COUNT,
+} BMS_Plant_Input_t;
+
+/** Input level: open, closed, or back to the model above. */
+#define BMS_PLANT_LEVEL_OPEN 0
+#define BMS_PLANT_LEVEL_CLOSE 1
+#define BMS_PLANT_LEVEL_AUTO (-1)
+
+/** Commanded outputs, as last written by the SM. */
+typedef struct
+{
+  bool air_plus;
+  bool precharge;
+  bool bms_shutdown;
+  bool bms_indicator;
+  bool fault_indicator;
+  bool buzzer;
+  bool tssi_green;
+  uint32_t balance_stops; /**< FEB_Stop_Balance() calls */
+} BMS_Plant_Outputs_t;
+
+/** Reset to power-on: relays open, SDC open, no cell data. */
+void BMS_Plant_Init(void);
+
+/** Input by trace name (SDC, SHUTDOWN, AIR_MINUS, ...); -1 if unknown. */
+int BMS_Plant_Input_From_Name(const char *name);
+
+void BMS_Plant_Set_Input(BMS_Plant_Input_t input, int level);
+
+/** Pack readings reported by every following voltage scan. */
+void BMS_Plant_Set_Cells(float pack_v, float min_cell_v, float max_cell_v);
+
+/**
+ * @brief Pack readings reported by every following temperature scan
+ * @param valid_pct Share of populated sensors reading in range (100 = all)
+ */
+void BMS_Plant_Set_Temps(float min_c, float max_c, float valid_pct);
+
+/** Overwrite the latched ADBMS_FAULT_FLAG_* set (notifies on new bits). */
+void BMS_Plant_Set_Fault_Flags(uint32_t flags, uint64_t sample_us);
+
+/** Run the scans due at tick. Call once per simulated millisecond. */
+void BMS_Plant_Step(uint32_t tick);
+
+void BMS_Plant_Get_Outputs(BMS_Plant_Outputs_t *out);
+
+#endif /* BMS_REPLAY_PLANT_H */
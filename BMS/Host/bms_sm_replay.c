@@ -0,0 +1,873 @@
+/**
+ ******************************************************************************
+ * @file           : bms_sm_replay.c
+ * @brief          : BMS state-machine replay against recorded traces
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real FEB_SM.c, FEB_CAN_IVT.c, FEB_CAN_Charger.c, FEB_CAN_DASH.c,
+ * FEB_CAN_Heartbeat.c and FEB_CAN_State.c on the host shim's virtual clock,
+ * fed by a trace, and prints the resulting state / relay / fault timeline.
+ * Time only moves when the replay steps it, so a run is deterministic and
+ * goes as fast as the host can execute the SM task.
+ *
+ * Each simulated millisecond does what the target does in that tick:
+ *   1. trace rows due by now are applied (CAN frames go through the bxCAN
+ *      filters and FEB_CAN_RX_Process into the real RX callbacks)
+ *   2. held sources (IVT, DASH, heartbeats, charger) repeat their frames
+ *   3. the plant runs any cell-monitor scan that is due
+ *   4. StartSMTask's body: FEB_SM_Process_Events, FEB_SM_Process,
+ *      FEB_CAN_State_Tick and, every 100 ms, FEB_CAN_Charger_Process
+ *   5. TX frames are drained onto the bus
+ *
+ * Trace format: see README.md next to this file.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_ADBMS6830B.h"
+#include "FEB_CAN_Charger.h"
+#include "FEB_CAN_DASH.h"
+#include "FEB_CAN_Heartbeat.h"
+#include "FEB_CAN_IVT.h"
+#include "FEB_CAN_State.h"
+#include "FEB_SM.h"
+#include "bms_replay_plant.h"
+#include "cmsis_os2.h"
+#include "feb_can.h"
+#include "feb_can_lib.h"
+#include "feb_host.h"
+#include "feb_log.h"
+#include "feb_time.h"
+#include "main.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+/* Repeat periods of the held sources. Each is well inside the staleness
+ * window its consumer applies (IVT 1 s, R2D 500 ms, heartbeat 1 s, charger
+ * FEB_CHARGER_RX_TIMEOUT_MS). */
+#define REPLAY_IVT_PERIOD_MS 10U
+#define REPLAY_DASH_PERIOD_MS 100U
+#define REPLAY_HB_PERIOD_MS 100U
+#define REPLAY_CHARGER_PERIOD_MS 500U
+
+/* Virtual time charged per DWT read, so the DRIVE shutdown-trip filter's
+ * 10 us spin takes ~100 reads instead of never ending. */
+#define REPLAY_DWT_READ_NS 100U
+
+#define REPLAY_DEFAULT_TAIL_MS 2000U
+#define REPLAY_MAX_FIELDS 16
+#define REPLAY_LINE_MAX 256
+
+/* ============================================================================
+ * Board Globals
+ * ============================================================================ */
+
+CAN_HandleTypeDef hcan1;
+
+/* No SM task on the host: FEB_SM_Notify_Event only latches the event, and
+ * the replay loop evaluates it before the tick's periodic work. */
+osThreadId_t SMTaskHandle = NULL;
+
+/* ============================================================================
+ * Held Sources
+ * ============================================================================ */
+
+typedef enum
+{
+  SRC_IVT_CURRENT = 0,
+  SRC_IVT_VOLTAGE1,
+  SRC_IVT_VOLTAGE2,
+  SRC_IVT_VOLTAGE3,
+  SRC_DASH_STATE,
+  SRC_CHARGER_STATUS,
+  SRC_HB_PCU,
+  SRC_HB_DASH,
+  SRC_HB_LVPDB,
+  SRC_HB_DCU,
+  SRC_HB_FSN,
+  SRC_HB_RSN,
+  SRC_COUNT
+} replay_source_id_t;
+
+typedef struct
+{
+  bool active;
+  uint32_t period_ms;
+  uint32_t next_ms;
+  uint32_t id;
+  uint32_t ide;
+  uint8_t dlc;
+  uint8_t data[8];
+} replay_source_t;
+
+static replay_source_t sources[SRC_COUNT];
+
+/* Heartbeat names accepted by HB rows, in replay_source_id_t order. */
+static const char *const hb_names[] = {"PCU", "DASH", "LVPDB", "DCU", "FSN", "RSN"};
+static const uint32_t hb_ids[] = {
+    FEB_CAN_PCU_HEARTBEAT_FRAME_ID,   FEB_CAN_DASH_HEARTBEAT_FRAME_ID,
+    FEB_CAN_LVPDB_HEARTBEAT_FRAME_ID, FEB_CAN_DCU_HEARTBEAT_FRAME_ID,
+    FEB_CAN_FRONT_SENSOR_HEARTBEAT_MESSAGE_FRAME_ID, FEB_CAN_REAR_SENSOR_HEARTBEAT_MESSAGE_FRAME_ID,
+};
+
+/* ============================================================================
+ * Replay State
+ * ============================================================================ */
+
+typedef struct
+{
+  const char *path;
+  unsigned long line;
+  uint32_t t0_ms;    /* trace time of the first row */
+  uint32_t now_ms;   /* simulated ms since the first row */
+  uint64_t base_ns;  /* virtual time at now_ms == 0 */
+  uint8_t bus;       /* DCU bus wired to BMS CAN1 */
+  uint32_t rows;
+  uint32_t frames_in;
+  uint32_t frames_out;
+  FILE *timeline;
+} replay_t;
+
+static replay_t rp;
+
+/* Last values written to the timeline */
+typedef struct
+{
+  int state;
+  int air_plus;
+  int precharge;
+  int bms_shutdown;
+  int tssi;
+  long adbms_flags;
+  int charger_control;
+  int charger_current_dA;
+} replay_signals_t;
+
+static replay_signals_t shown;
+static int charger_control = -1;
+static int charger_current_dA = -1;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint64_t wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void trace_error(const char *msg, const char *field)
+{
+  fprintf(stderr, "%s:%lu: %s%s%s\n", rp.path, rp.line, msg, field ? ": " : "", field ? field : "");
+  exit(2);
+}
+
+static float parse_float(const char *s)
+{
+  char *end;
+  float v = strtof(s, &end);
+  if (end == s || *end != '\0')
+  {
+    trace_error("bad number", s);
+  }
+  return v;
+}
+
+static long parse_long(const char *s, int base)
+{
+  char *end;
+  errno = 0;
+  long v = strtol(s, &end, base);
+  if (end == s || *end != '\0' || errno != 0)
+  {
+    trace_error("bad integer", s);
+  }
+  return v;
+}
+
+static bool is_off(const char *s)
+{
+  return strcasecmp(s, "off") == 0;
+}
+
+/* Split a CSV line in place; trailing CR/LF and surrounding blanks dropped. */
+static int split_fields(char *line, char **fields)
+{
+  int n = 0;
+  char *p = line;
+  for (;;)
+  {
+    while (*p == ' ' || *p == '\t')
+    {
+      p++;
+    }
+    fields[n++] = p;
+    char *end = p + strcspn(p, ",\r\n");
+    char sep = *end;
+    char *trim = end;
+    while (trim > p && (trim[-1] == ' ' || trim[-1] == '\t'))
+    {
+      trim--;
+    }
+    *trim = '\0';
+    if (sep != ',' || n == REPLAY_MAX_FIELDS)
+    {
+      return n;
+    }
+    p = end + 1;
+  }
+}
+
+/* ============================================================================
+ * Bus
+ * ============================================================================ */
+
+static void inject(uint32_t id, uint32_t ide, const uint8_t *data, uint8_t dlc)
+{
+  FEB_Host_CAN_Receive(&hcan1, id, ide, data, dlc);
+  FEB_CAN_RX_Process();
+  rp.frames_in++;
+}
+
+static void on_tx(CAN_HandleTypeDef *hcan, const FEB_Host_CAN_Frame_t *frame, void *user)
+{
+  (void)hcan;
+  (void)user;
+  rp.frames_out++;
+
+  if (frame->ide == CAN_ID_EXT && frame->id == FEB_CAN_CHARGER_LIMITS_FRAME_ID)
+  {
+    struct feb_can_charger_limits_t cmd;
+    if (feb_can_charger_limits_unpack(&cmd, frame->data, frame->dlc) == 0)
+    {
+      charger_control = cmd.control;
+      charger_current_dA = cmd.max_current;
+    }
+  }
+}
+
+static void source_set(replay_source_id_t src, uint32_t period_ms, uint32_t id, uint32_t ide, const uint8_t *data,
+                       int dlc)
+{
+  replay_source_t *s = &sources[src];
+  if (dlc < 0 || dlc > 8)
+  {
+    trace_error("frame pack failed", NULL);
+  }
+  bool restart = !s->active;
+  s->active = true;
+  s->period_ms = period_ms;
+  s->id = id;
+  s->ide = ide;
+  s->dlc = (uint8_t)dlc;
+  memcpy(s->data, data, (size_t)dlc);
+  if (restart)
+  {
+    s->next_ms = rp.now_ms;
+  }
+}
+
+static void sources_run(void)
+{
+  for (int i = 0; i < SRC_COUNT; i++)
+  {
+    replay_source_t *s = &sources[i];
+    if (s->active && (int32_t)(rp.now_ms - s->next_ms) >= 0)
+    {
+      inject(s->id, s->ide, s->data, s->dlc);
+      s->next_ms += s->period_ms;
+    }
+  }
+}
+
+/* ============================================================================
+ * Trace Rows
+ * ============================================================================ */
+
+/* timestamp_ms,bus,can_id,dlc,d0..d7 as written by the DCU logger */
+static void row_can(char **f, int n)
+{
+  if (n < 4)
+  {
+    trace_error("CAN row needs bus,can_id,dlc", NULL);
+  }
+  if (parse_long(f[1], 10) != rp.bus)
+  {
+    return;
+  }
+
+  uint32_t id = (uint32_t)parse_long(f[2], 0);
+  long dlc = parse_long(f[3], 10);
+  if (dlc < 0 || dlc > 8 || n < 4 + dlc)
+  {
+    trace_error("bad dlc", f[3]);
+  }
+  uint8_t data[8] = {0};
+  for (long i = 0; i < dlc; i++)
+  {
+    data[i] = (uint8_t)parse_long(f[4 + i], 16);
+  }
+  /* The CSV carries no IDE bit: anything past 11 bits is extended. */
+  inject(id, (id > 0x7FFU) ? CAN_ID_EXT : CAN_ID_STD, data, (uint8_t)dlc);
+}
+
+/* IVT,current_A,pack_V | IVT,off */
+static void row_ivt(char **f, int n)
+{
+  if (n >= 2 && is_off(f[1]))
+  {
+    for (int i = SRC_IVT_CURRENT; i <= SRC_IVT_VOLTAGE3; i++)
+    {
+      sources[i].active = false;
+    }
+    return;
+  }
+  if (n < 3)
+  {
+    trace_error("IVT row needs current_A,voltage_V", NULL);
+  }
+
+  uint8_t data[8];
+  /* FEB_CAN_IVT.c negates the raw current (reversed sensor direction). */
+  struct feb_can_ivt_current_t cur;
+  memset(&cur, 0, sizeof(cur));
+  cur.current = (int32_t)lroundf(parse_float(f[1]) * -1000.0f);
+  source_set(SRC_IVT_CURRENT, REPLAY_IVT_PERIOD_MS, FEB_CAN_IVT_CURRENT_FRAME_ID, CAN_ID_STD, data,
+             feb_can_ivt_current_pack(data, &cur, sizeof(data)));
+
+  /* Same voltage on all three channels, whichever one
+   * FEB_IVT_PACK_VOLTAGE_CHANNEL selects. */
+  int32_t mV = (int32_t)lroundf(parse_float(f[2]) * 1000.0f);
+  struct feb_can_ivt_voltage1_t v1;
+  memset(&v1, 0, sizeof(v1));
+  v1.voltage1 = mV;
+  source_set(SRC_IVT_VOLTAGE1, REPLAY_IVT_PERIOD_MS, FEB_CAN_IVT_VOLTAGE1_FRAME_ID, CAN_ID_STD, data,
+             feb_can_ivt_voltage1_pack(data, &v1, sizeof(data)));
+  struct feb_can_ivt_voltage2_t v2;
+  memset(&v2, 0, sizeof(v2));
+  v2.voltage2 = mV;
+  source_set(SRC_IVT_VOLTAGE2, REPLAY_IVT_PERIOD_MS, FEB_CAN_IVT_VOLTAGE2_FRAME_ID, CAN_ID_STD, data,
+             feb_can_ivt_voltage2_pack(data, &v2, sizeof(data)));
+  struct feb_can_ivt_voltage3_t v3;
+  memset(&v3, 0, sizeof(v3));
+  v3.voltage3 = mV;
+  source_set(SRC_IVT_VOLTAGE3, REPLAY_IVT_PERIOD_MS, FEB_CAN_IVT_VOLTAGE3_FRAME_ID, CAN_ID_STD, data,
+             feb_can_ivt_voltage3_pack(data, &v3, sizeof(data)));
+}
+
+/* DASH,<ready_to_drive 0|1> | DASH,off */
+static void row_dash(char **f, int n)
+{
+  if (n < 2)
+  {
+    trace_error("DASH row needs ready_to_drive", NULL);
+  }
+  if (is_off(f[1]))
+  {
+    sources[SRC_DASH_STATE].active = false;
+    return;
+  }
+
+  uint8_t data[8];
+  struct feb_can_dash_state_t msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.ready_to_drive = (parse_long(f[1], 10) != 0);
+  source_set(SRC_DASH_STATE, REPLAY_DASH_PERIOD_MS, FEB_CAN_DASH_STATE_FRAME_ID, CAN_ID_STD, data,
+             feb_can_dash_state_pack(data, &msg, sizeof(data)));
+}
+
+/* HB,<PCU|DASH|LVPDB|DCU|FSN|RSN>[,off] */
+static void row_hb(char **f, int n)
+{
+  if (n < 2)
+  {
+    trace_error("HB row needs a device", NULL);
+  }
+  for (size_t i = 0; i < sizeof(hb_names) / sizeof(hb_names[0]); i++)
+  {
+    if (strcasecmp(f[1], hb_names[i]) == 0)
+    {
+      replay_source_id_t src = (replay_source_id_t)(SRC_HB_PCU + i);
+      if (n >= 3 && is_off(f[2]))
+      {
+        sources[src].active = false;
+        return;
+      }
+      /* Presence only: FEB_CAN_Heartbeat.c ignores the payload. */
+      static const uint8_t zero[8] = {0};
+      source_set(src, REPLAY_HB_PERIOD_MS, hb_ids[i], CAN_ID_STD, zero, 8);
+      return;
+    }
+  }
+  trace_error("unknown heartbeat device", f[1]);
+}
+
+/* CHARGER,out_dV,out_dA[,hw,temp,input,state,comm] | CHARGER,off */
+static void row_charger(char **f, int n)
+{
+  if (n >= 2 && is_off(f[1]))
+  {
+    sources[SRC_CHARGER_STATUS].active = false;
+    return;
+  }
+  if (n < 3)
+  {
+    trace_error("CHARGER row needs out_dV,out_dA", NULL);
+  }
+
+  uint8_t data[8];
+  struct feb_can_charger_status_t msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.output_voltage = (uint16_t)parse_long(f[1], 10);
+  msg.output_current = (uint16_t)parse_long(f[2], 10);
+  msg.hw_status = (n > 3) ? (uint8_t)parse_long(f[3], 10) : 0;
+  msg.temperature = (n > 4) ? (uint8_t)parse_long(f[4], 10) : 0;
+  msg.input_voltage = (n > 5) ? (uint8_t)parse_long(f[5], 10) : 0;
+  msg.state = (n > 6) ? (uint8_t)parse_long(f[6], 10) : 0;
+  msg.communication_state = (n > 7) ? (uint8_t)parse_long(f[7], 10) : 0;
+  source_set(SRC_CHARGER_STATUS, REPLAY_CHARGER_PERIOD_MS, FEB_CAN_CHARGER_STATUS_FRAME_ID, CAN_ID_EXT, data,
+             feb_can_charger_status_pack(data, &msg, sizeof(data)));
+}
+
+/* CELLV,pack_V,min_cell_V,max_cell_V */
+static void row_cellv(char **f, int n)
+{
+  if (n < 4)
+  {
+    trace_error("CELLV row needs pack_V,min_V,max_V", NULL);
+  }
+  BMS_Plant_Set_Cells(parse_float(f[1]), parse_float(f[2]), parse_float(f[3]));
+}
+
+/* TEMP,min_C,max_C[,valid_pct] */
+static void row_temp(char **f, int n)
+{
+  if (n < 3)
+  {
+    trace_error("TEMP row needs min_C,max_C", NULL);
+  }
+  BMS_Plant_Set_Temps(parse_float(f[1]), parse_float(f[2]), (n > 3) ? parse_float(f[3]) : 100.0f);
+}
+
+/* FLAGS,<ADBMS_FAULT_FLAG_* mask> */
+static void row_flags(char **f, int n)
+{
+  if (n < 2)
+  {
+    trace_error("FLAGS row needs a mask", NULL);
+  }
+  BMS_Plant_Set_Fault_Flags((uint32_t)parse_long(f[1], 0), FEB_Time_Us());
+}
+
+/* GPIO,<input>,<0|1|auto> */
+static void row_gpio(char **f, int n)
+{
+  if (n < 3)
+  {
+    trace_error("GPIO row needs input,level", NULL);
+  }
+  int input = BMS_Plant_Input_From_Name(f[1]);
+  if (input < 0)
+  {
+    trace_error("unknown input", f[1]);
+  }
+  int level = (strcasecmp(f[2], "auto") == 0) ? BMS_PLANT_LEVEL_AUTO : (parse_long(f[2], 10) != 0);
+  BMS_Plant_Set_Input((BMS_Plant_Input_t)input, level);
+}
+
+/* SM,<state name>: a console-requested transition (BMS|state|...) */
+static void row_sm(char **f, int n)
+{
+  if (n < 2)
+  {
+    trace_error("SM row needs a state", NULL);
+  }
+  for (int s = 0; s < BMS_STATE_COUNT; s++)
+  {
+    if (strcasecmp(f[1], FEB_CAN_State_GetStateName((BMS_State_t)s)) == 0)
+    {
+      FEB_SM_Transition((BMS_State_t)s);
+      return;
+    }
+  }
+  trace_error("unknown state", f[1]);
+}
+
+typedef struct
+{
+  const char *keyword;
+  void (*apply)(char **f, int n);
+} replay_row_t;
+
+static const replay_row_t row_table[] = {
+    {"IVT", row_ivt},     {"DASH", row_dash},   {"HB", row_hb},     {"CHARGER", row_charger}, {"CELLV", row_cellv},
+    {"TEMP", row_temp},   {"FLAGS", row_flags}, {"GPIO", row_gpio}, {"SM", row_sm},
+};
+
+static void apply_row(char **f, int n)
+{
+  rp.rows++;
+  if (isdigit((unsigned char)f[1][0]))
+  {
+    row_can(f, n);
+    return;
+  }
+  for (size_t i = 0; i < sizeof(row_table) / sizeof(row_table[0]); i++)
+  {
+    if (strcasecmp(f[1], row_table[i].keyword) == 0)
+    {
+      /* Handlers see the keyword as f[0] and their arguments from f[1]. */
+      row_table[i].apply(f + 1, n - 1);
+      return;
+    }
+  }
+  trace_error("unknown row type", f[1]);
+}
+
+/* Next data row; false at end of file. Headers, blanks and # comments are
+ * skipped. */
+static bool read_row(FILE *in, char *line, char **f, int *n, uint32_t *t_ms)
+{
+  while (fgets(line, REPLAY_LINE_MAX, in) != NULL)
+  {
+    rp.line++;
+    if (strchr(line, '\n') == NULL && !feof(in))
+    {
+      trace_error("line too long", NULL);
+    }
+    *n = split_fields(line, f);
+    if (f[0][0] == '#' || f[0][0] == '\0' || !isdigit((unsigned char)f[0][0]))
+    {
+      continue;
+    }
+    if (*n < 2 || f[1][0] == '\0')
+    {
+      trace_error("row has no type", NULL);
+    }
+    *t_ms = (uint32_t)parse_long(f[0], 10);
+    return true;
+  }
+  return false;
+}
+
+/* ============================================================================
+ * Timeline
+ * ============================================================================ */
+
+static void emit(const char *signal, const char *value)
+{
+  fprintf(rp.timeline, "%lu,%s,%s\n", (unsigned long)(rp.t0_ms + rp.now_ms), signal, value);
+}
+
+static void emit_int(const char *signal, int *shown_value, int value)
+{
+  if (*shown_value != value)
+  {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", value);
+    emit(signal, buf);
+    *shown_value = value;
+  }
+}
+
+static void timeline_update(void)
+{
+  BMS_State_t state = FEB_SM_Get_Current_State();
+  if (shown.state != (int)state)
+  {
+    emit("state", FEB_CAN_State_GetStateName(state));
+    shown.state = (int)state;
+  }
+
+  BMS_Plant_Outputs_t out;
+  BMS_Plant_Get_Outputs(&out);
+  emit_int("air_plus", &shown.air_plus, out.air_plus);
+  emit_int("precharge", &shown.precharge, out.precharge);
+  emit_int("bms_shutdown", &shown.bms_shutdown, out.bms_shutdown);
+  emit_int("tssi", &shown.tssi, out.tssi_green);
+
+  long flags = (long)FEB_ADBMS_Get_Fault_Flags();
+  if (shown.adbms_flags != flags)
+  {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "0x%02lX", flags);
+    emit("adbms_flags", buf);
+    shown.adbms_flags = flags;
+  }
+
+  if (charger_control >= 0)
+  {
+    emit_int("charger_control", &shown.charger_control, charger_control);
+    emit_int("charger_current_dA", &shown.charger_current_dA, charger_current_dA);
+  }
+}
+
+static void print_latency_summary(void)
+{
+  static const BMS_State_t faults[] = {BMS_STATE_FAULT_BMS, BMS_STATE_FAULT_BSPD, BMS_STATE_FAULT_IMD,
+                                       BMS_STATE_FAULT_CHARGING};
+  static const char *const stages[] = {"detect", "open"};
+
+  for (size_t i = 0; i < sizeof(faults) / sizeof(faults[0]); i++)
+  {
+    for (int stage = 0; stage < FEB_SM_LAT_STAGE_COUNT; stage++)
+    {
+      FEB_SM_Lat_Hist_t h;
+      if (!FEB_SM_Get_Fault_Latency(faults[i], (FEB_SM_Lat_Stage_t)stage, &h) || h.count == 0)
+      {
+        continue;
+      }
+      fprintf(stderr, "  %-14s %-6s n=%lu min=%luus avg=%luus max=%luus\n", FEB_CAN_State_GetStateName(faults[i]),
+              stages[stage], (unsigned long)h.count, (unsigned long)h.min_us,
+              (unsigned long)(h.sum_us / h.count), (unsigned long)h.max_us);
+    }
+  }
+}
+
+/* ============================================================================
+ * Setup
+ * ============================================================================ */
+
+static int log_to_stderr(const char *data, size_t len)
+{
+  return (int)fwrite(data, 1, len, stderr);
+}
+
+static void replay_init(bool verbose)
+{
+  FEB_Host_Time_UseVirtual(true);
+  FEB_Host_Time_SetDwtReadCostNs(REPLAY_DWT_READ_NS);
+
+  /* Start on a whole tick, 1 ms past zero: the RX modules treat tick 0 as
+   * "never received". */
+  uint64_t now = FEB_Host_Time_Ns();
+  uint64_t start = (now / 1000000ULL + 1ULL) * 1000000ULL;
+  FEB_Host_Time_AdvanceNs(start - now);
+
+  if (verbose)
+  {
+    FEB_Log_Config_t log_cfg = {
+        .level = FEB_LOG_DEBUG,
+        .colors = false,
+        .timestamps = true,
+        .get_tick_ms = HAL_GetTick,
+        .custom_output = log_to_stderr,
+#if FEB_LOG_USE_FREERTOS
+        .mutex = osMutexNew(NULL),
+#endif
+    };
+    FEB_Log_Init(&log_cfg);
+  }
+
+  BMS_Plant_Init();
+
+  /* FEB_Init() order: CAN state publisher, time base, state machine */
+  FEB_CAN_State_Init();
+  FEB_Time_Init();
+  FEB_SM_Init();
+
+  /* StartBMSTaskRx() order: CAN, RX modules, filters, publisher ready */
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+  FEB_Host_CAN_SetTxHook(&hcan1, on_tx, NULL);
+  FEB_CAN_Config_t cfg = {
+      .hcan1 = &hcan1,
+      .hcan2 = NULL,
+      .get_tick_ms = HAL_GetTick,
+      .get_time_us = FEB_Time_Us,
+#if FEB_CAN_USE_FREERTOS
+      .tx_queue = osMessageQueueNew(16, sizeof(FEB_CAN_Message_t), NULL),
+      .rx_queue = osMessageQueueNew(32, sizeof(FEB_CAN_Message_t), NULL),
+      .tx_mutex = osMutexNew(NULL),
+      .rx_mutex = osMutexNew(NULL),
+      .tx_mailbox_sem = osSemaphoreNew(3, 3, NULL),
+#endif
+  };
+  if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+  {
+    fprintf(stderr, "FEB_CAN_Init failed\n");
+    exit(1);
+  }
+  FEB_CAN_DASH_Init();
+  FEB_CAN_IVT_Init();
+  FEB_CAN_Charger_Init();
+  FEB_CAN_Heartbeat_Init();
+  FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_INSTANCE_1);
+  FEB_CAN_State_SetReady();
+
+  rp.base_ns = FEB_Host_Time_Ns();
+
+  memset(&shown, 0xFF, sizeof(shown));
+}
+
+/* One StartSMTask iteration plus the TX task's drain. */
+static void replay_tick(void)
+{
+  static uint16_t charger_divider = 0;
+
+  BMS_Plant_Step(HAL_GetTick());
+
+  FEB_SM_Process_Events();
+  FEB_SM_Process();
+  FEB_CAN_State_Tick();
+  if (++charger_divider >= 100)
+  {
+    charger_divider = 0;
+    FEB_CAN_Charger_Process();
+  }
+
+  FEB_CAN_TX_Process();
+  FEB_Host_CAN_BusFlush(&hcan1);
+}
+
+static void set_clock(uint32_t ms)
+{
+  uint64_t target = rp.base_ns + (uint64_t)ms * 1000000ULL;
+  uint64_t now = FEB_Host_Time_Ns();
+  if (target > now)
+  {
+    FEB_Host_Time_AdvanceNs(target - now);
+  }
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+          "usage: %s [-v] [-b bus] [-t tail_ms] [-o timeline.csv] trace.csv\n"
+          "  -v  echo the firmware log to stderr\n"
+          "  -b  DCU bus carrying the BMS CAN frames (default 1)\n"
+          "  -t  keep running this long after the last row (default %u ms)\n"
+          "  -o  write the timeline here instead of stdout\n",
+          argv0, REPLAY_DEFAULT_TAIL_MS);
+  exit(2);
+}
+
+int main(int argc, char **argv)
+{
+  bool verbose = false;
+  uint32_t tail_ms = REPLAY_DEFAULT_TAIL_MS;
+  const char *out_path = NULL;
+  int argi = 1;
+
+  rp.bus = 1;
+  for (; argi < argc && argv[argi][0] == '-' && argv[argi][1] != '\0'; argi++)
+  {
+    const char *opt = argv[argi];
+    if (strcmp(opt, "-v") == 0)
+    {
+      verbose = true;
+    }
+    else if ((strcmp(opt, "-b") == 0 || strcmp(opt, "-t") == 0 || strcmp(opt, "-o") == 0) && argi + 1 < argc)
+    {
+      const char *val = argv[++argi];
+      if (opt[1] == 'b')
+      {
+        rp.bus = (uint8_t)atoi(val);
+      }
+      else if (opt[1] == 't')
+      {
+        tail_ms = (uint32_t)strtoul(val, NULL, 10);
+      }
+      else
+      {
+        out_path = val;
+      }
+    }
+    else
+    {
+      usage(argv[0]);
+    }
+  }
+  if (argi != argc - 1)
+  {
+    usage(argv[0]);
+  }
+
+  rp.path = argv[argi];
+  FILE *in = (strcmp(rp.path, "-") == 0) ? stdin : fopen(rp.path, "r");
+  if (in == NULL)
+  {
+    perror(rp.path);
+    return 1;
+  }
+  rp.timeline = stdout;
+  if (out_path != NULL && (rp.timeline = fopen(out_path, "w")) == NULL)
+  {
+    perror(out_path);
+    return 1;
+  }
+
+  char line[REPLAY_LINE_MAX];
+  char *f[REPLAY_MAX_FIELDS];
+  int n = 0;
+  uint32_t row_t = 0;
+  bool have_row = read_row(in, line, f, &n, &row_t);
+  rp.t0_ms = have_row ? row_t : 0;
+
+  replay_init(verbose);
+  fprintf(rp.timeline, "timestamp_ms,signal,value\n");
+
+  uint64_t wall_start = wall_ns();
+  uint32_t last_row_ms = 0;
+
+  for (rp.now_ms = 0;; rp.now_ms++)
+  {
+    set_clock(rp.now_ms);
+
+    while (have_row && (row_t - rp.t0_ms) <= rp.now_ms)
+    {
+      apply_row(f, n);
+      last_row_ms = rp.now_ms;
+      uint32_t prev_t = row_t;
+      have_row = read_row(in, line, f, &n, &row_t);
+      if (have_row && row_t < prev_t)
+      {
+        trace_error("timestamp goes backwards", f[0]);
+      }
+    }
+
+    sources_run();
+    replay_tick();
+    timeline_update();
+
+    if (!have_row && rp.now_ms >= last_row_ms + tail_ms)
+    {
+      break;
+    }
+  }
+
+  double wall_ms = (double)(wall_ns() - wall_start) / 1e6;
+  double sim_ms = (double)rp.now_ms + 1.0;
+  fprintf(stderr, "replayed %.0f ms (%lu rows, %lu frames in, %lu out) in %.1f ms wall: %.0fx real time\n", sim_ms,
+          (unsigned long)rp.rows, (unsigned long)rp.frames_in, (unsigned long)rp.frames_out, wall_ms,
+          (wall_ms > 0.0) ? sim_ms / wall_ms : 0.0);
+  print_latency_summary();
+
+  if (in != stdin)
+  {
+    fclose(in);
+  }
+  if (rp.timeline != stdout)
+  {
+    fclose(rp.timeline);
+  }
+  return 0;
+}
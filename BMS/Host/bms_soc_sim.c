@@ -0,0 +1,388 @@
+/**
+ ******************************************************************************
+ * @file           : bms_soc_sim.c
+ * @brief          : SOC / pack-resistance estimator simulation over a drive cycle
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real FEB_SOC.c at the ADBMS voltage-scan cadence (100 ms) over a
+ * drive cycle and reports how the estimate converges and what a step costs.
+ *
+ * Cycle rows are `timestamp_ms,current_A[,pack_V]`, current positive for
+ * discharge and linearly interpolated between rows:
+ *   - with pack_V (a recorded IVT current + cell-sum log) the estimator runs
+ *     on the recorded voltage and only the estimate is reported;
+ *   - without it, a pack model supplies the voltage and the true SOC / R:
+ *       V = N * OCV(soc) - R0 * I - v1,   dv1/dt = (R1 * I - v1) / tau1
+ *     plus uniform noise, with the capacity optionally off from
+ *     FEB_SOC_PACK_CAPACITY_AH. The model uses the estimator's own OCV
+ *     table, so table error is not part of the result.
+ *
+ * stdout: one `t_s,current_A,pack_V,soc_true,soc_est,r_true,r_est,flags`
+ * row per second (true columns empty for recorded voltage). stderr: summary.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_SOC.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define SIM_STEP_MS 100U /* StartADBMSTask voltage scan */
+#define SIM_LINE_MAX 256
+#define SIM_TIMING_PASSES 200
+#define SIM_R_SETTLED_PCT 5.0
+
+typedef struct
+{
+  uint32_t t_ms;
+  float current_A;
+  float pack_V; /* NAN when the row has no voltage */
+} cycle_row_t;
+
+typedef struct
+{
+  float soc0;         /* initial true SOC */
+  float r0_ohm;       /* ohmic pack resistance */
+  float r1_ohm;       /* polarisation branch */
+  float tau1_s;
+  float capacity_err; /* true capacity = FEB_SOC_PACK_CAPACITY_AH * (1 + err) */
+  float noise_mV;     /* +/- pack voltage noise */
+} plant_params_t;
+
+/* ============================================================================
+ * Cycle Input
+ * ============================================================================ */
+
+static cycle_row_t *rows;
+static size_t row_count;
+static bool recorded_voltage;
+
+static void load_cycle(FILE *in, const char *path)
+{
+  char line[SIM_LINE_MAX];
+  size_t cap = 0;
+  unsigned long lineno = 0;
+  bool any_voltage = false;
+  bool all_voltage = true;
+
+  while (fgets(line, sizeof(line), in) != NULL)
+  {
+    lineno++;
+    char *p = line;
+    while (isspace((unsigned char)*p))
+    {
+      p++;
+    }
+    if (*p == '\0' || *p == '#' || !isdigit((unsigned char)*p))
+    {
+      continue; /* blank, comment or header */
+    }
+
+    char *end;
+    cycle_row_t r;
+    r.t_ms = (uint32_t)strtoul(p, &end, 10);
+    if (*end != ',')
+    {
+      fprintf(stderr, "%s:%lu: expected timestamp_ms,current_A[,pack_V]\n", path, lineno);
+      exit(2);
+    }
+    r.current_A = strtof(end + 1, &end);
+    r.pack_V = NAN;
+    if (*end == ',')
+    {
+      r.pack_V = strtof(end + 1, &end);
+    }
+    if (row_count > 0 && r.t_ms < rows[row_count - 1].t_ms)
+    {
+      fprintf(stderr, "%s:%lu: timestamp goes backwards\n", path, lineno);
+      exit(2);
+    }
+
+    if (row_count == cap)
+    {
+      cap = cap ? cap * 2 : 256;
+      rows = realloc(rows, cap * sizeof(*rows));
+      if (rows == NULL)
+      {
+        perror("realloc");
+        exit(1);
+      }
+    }
+    rows[row_count++] = r;
+    any_voltage |= !isnan(r.pack_V);
+    all_voltage &= !isnan(r.pack_V);
+  }
+
+  if (row_count < 2)
+  {
+    fprintf(stderr, "%s: need at least two rows\n", path);
+    exit(2);
+  }
+  if (any_voltage && !all_voltage)
+  {
+    fprintf(stderr, "%s: pack_V must be on every row or none\n", path);
+    exit(2);
+  }
+  recorded_voltage = any_voltage;
+}
+
+/* Linear interpolation at t; *hint walks forward with t */
+static void cycle_at(uint32_t t_ms, size_t *hint, float *current_A, float *pack_V)
+{
+  size_t i = *hint;
+  while (i + 1 < row_count && rows[i + 1].t_ms <= t_ms)
+  {
+    i++;
+  }
+  *hint = i;
+  if (i + 1 >= row_count || rows[i + 1].t_ms == rows[i].t_ms)
+  {
+    *current_A = rows[i].current_A;
+    *pack_V = rows[i].pack_V;
+    return;
+  }
+  float frac = (float)(t_ms - rows[i].t_ms) / (float)(rows[i + 1].t_ms - rows[i].t_ms);
+  *current_A = rows[i].current_A + frac * (rows[i + 1].current_A - rows[i].current_A);
+  *pack_V = rows[i].pack_V + frac * (rows[i + 1].pack_V - rows[i].pack_V);
+}
+
+/* ============================================================================
+ * Pack Model
+ * ============================================================================ */
+
+typedef struct
+{
+  float soc;
+  float v1; /* polarisation voltage */
+  uint32_t rng;
+} plant_t;
+
+/* Deterministic noise in [-1, 1) */
+static float plant_noise(plant_t *pl)
+{
+  pl->rng = pl->rng * 1664525U + 1013904223U;
+  return (float)(pl->rng >> 8) / (float)(1U << 23) - 1.0f;
+}
+
+static float plant_step(plant_t *pl, const plant_params_t *pp, float dt_s, float current_A)
+{
+  float capacity_Ah = FEB_SOC_PACK_CAPACITY_AH * (1.0f + pp->capacity_err);
+  pl->soc -= current_A * dt_s / (3600.0f * capacity_Ah);
+  pl->v1 += (pp->r1_ohm * current_A - pl->v1) * (1.0f - expf(-dt_s / pp->tau1_s));
+  return (float)FEB_NUM_CELLS * FEB_SOC_Cell_OCV(pl->soc) - pp->r0_ohm * current_A - pl->v1 +
+         plant_noise(pl) * pp->noise_mV * 0.001f;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static uint64_t wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+          "usage: %s [-s soc0] [-r r0_ohm] [-p r1_ohm] [-T tau1_s] [-c capacity_err] [-n noise_mV] cycle.csv\n"
+          "  -s  initial true SOC (default 0.90)\n"
+          "  -r  ohmic pack resistance (default 0.35)\n"
+          "  -p  polarisation resistance (default 0.15), -T its time constant (default 15 s)\n"
+          "  -c  true capacity error vs FEB_SOC_PACK_CAPACITY_AH (default 0.05 = 5 %% larger)\n"
+          "  -n  +/- pack voltage noise (default 50 mV)\n"
+          "The model options only apply to cycles without a pack_V column.\n",
+          argv0);
+  exit(2);
+}
+
+int main(int argc, char **argv)
+{
+  plant_params_t pp = {
+      .soc0 = 0.90f, .r0_ohm = 0.35f, .r1_ohm = 0.15f, .tau1_s = 15.0f, .capacity_err = 0.05f, .noise_mV = 50.0f};
+  int argi = 1;
+
+  for (; argi < argc && argv[argi][0] == '-' && argv[argi][1] != '\0'; argi++)
+  {
+    const char *opt = argv[argi];
+    if (strlen(opt) != 2 || strchr("srpTcn", opt[1]) == NULL || argi + 1 >= argc)
+    {
+      usage(argv[0]);
+    }
+    float val = strtof(argv[++argi], NULL);
+    switch (opt[1])
+    {
+    case 's':
+      pp.soc0 = val;
+      break;
+    case 'r':
+      pp.r0_ohm = val;
+      break;
+    case 'p':
+      pp.r1_ohm = val;
+      break;
+    case 'T':
+      pp.tau1_s = val;
+      break;
+    case 'c':
+      pp.capacity_err = val;
+      break;
+    default:
+      pp.noise_mV = val;
+      break;
+    }
+  }
+  if (argi != argc - 1)
+  {
+    usage(argv[0]);
+  }
+
+  const char *path = argv[argi];
+  FILE *in = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+  if (in == NULL)
+  {
+    perror(path);
+    return 1;
+  }
+  load_cycle(in, path);
+  if (in != stdin)
+  {
+    fclose(in);
+  }
+
+  uint32_t t0 = rows[0].t_ms;
+  uint32_t span_ms = rows[row_count - 1].t_ms - t0;
+  size_t steps = span_ms / SIM_STEP_MS + 1;
+  float *step_I = malloc(steps * sizeof(float));
+  float *step_V = malloc(steps * sizeof(float));
+  if (step_I == NULL || step_V == NULL)
+  {
+    perror("malloc");
+    return 1;
+  }
+
+  /* Closed-loop pass: inputs, truth and estimate */
+  plant_t pl = {.soc = pp.soc0, .v1 = 0.0f, .rng = 1U};
+  FEB_SOC_t est;
+  FEB_SOC_Init(&est);
+  size_t hint = 0;
+  const float dt_s = (float)SIM_STEP_MS * 0.001f;
+  double soc_err_max = 0.0;
+  double soc_err_sum = 0.0;
+  double r_settled_s = -1.0;
+  double ah_out = 0.0;
+
+  printf("t_s,current_A,pack_V,soc_true,soc_est,r_true,r_est,flags\n");
+  for (size_t k = 0; k < steps; k++)
+  {
+    uint32_t t_ms = t0 + (uint32_t)k * SIM_STEP_MS;
+    float current_A;
+    float pack_V;
+    cycle_at(t_ms, &hint, &current_A, &pack_V);
+    if (!recorded_voltage)
+    {
+      pack_V = plant_step(&pl, &pp, (k == 0) ? 0.0f : dt_s, current_A);
+    }
+    step_I[k] = current_A;
+    step_V[k] = pack_V;
+    ah_out += (k == 0) ? 0.0 : (double)current_A * dt_s / 3600.0;
+
+    FEB_SOC_Step(&est, (k == 0) ? 0.0f : dt_s, current_A, true, pack_V, FEB_NUM_CELLS);
+
+    if (!recorded_voltage)
+    {
+      double err = fabs((double)est.soc - (double)pl.soc);
+      soc_err_sum += err;
+      if (err > soc_err_max)
+      {
+        soc_err_max = err;
+      }
+      double r_err_pct = 100.0 * fabs((double)est.r_ohm - (double)pp.r0_ohm) / (double)pp.r0_ohm;
+      if (r_err_pct > SIM_R_SETTLED_PCT)
+      {
+        r_settled_s = -1.0;
+      }
+      else if (r_settled_s < 0.0)
+      {
+        r_settled_s = (double)(t_ms - t0) * 0.001;
+      }
+    }
+
+    if ((t_ms - t0) % 1000U == 0)
+    {
+      if (recorded_voltage)
+      {
+        printf("%.1f,%.2f,%.2f,,%.4f,,%.4f,0x%02X\n", (t_ms - t0) * 0.001, current_A, pack_V, est.soc, est.r_ohm,
+               est.flags);
+      }
+      else
+      {
+        printf("%.1f,%.2f,%.2f,%.4f,%.4f,%.4f,%.4f,0x%02X\n", (t_ms - t0) * 0.001, current_A, pack_V, pl.soc,
+               est.soc, pp.r0_ohm, est.r_ohm, est.flags);
+      }
+    }
+  }
+
+  /* Open-loop timing: the same inputs through a fresh estimator, many times */
+  uint64_t wall_start = wall_ns();
+  volatile float sink = 0.0f;
+  for (int pass = 0; pass < SIM_TIMING_PASSES; pass++)
+  {
+    FEB_SOC_t t_est;
+    FEB_SOC_Init(&t_est);
+    for (size_t k = 0; k < steps; k++)
+    {
+      FEB_SOC_Step(&t_est, (k == 0) ? 0.0f : dt_s, step_I[k], true, step_V[k], FEB_NUM_CELLS);
+    }
+    sink += t_est.soc;
+  }
+  double ns_per_step = (double)(wall_ns() - wall_start) / ((double)SIM_TIMING_PASSES * (double)steps);
+  (void)sink;
+
+  fprintf(stderr, "cycle: %.1f s, %zu steps, %.2f Ah net out (%s voltage)\n", span_ms * 0.001, steps, ah_out,
+          recorded_voltage ? "recorded" : "modelled");
+  if (!recorded_voltage)
+  {
+    fprintf(stderr, "model: soc0 %.3f, R0 %.3f ohm, R1 %.3f ohm / %.0f s, capacity %+.0f %%, noise +/-%.0f mV\n",
+            pp.soc0, pp.r0_ohm, pp.r1_ohm, pp.tau1_s, pp.capacity_err * 100.0f, pp.noise_mV);
+    fprintf(stderr, "soc: final %.4f vs true %.4f (err %.2f %%), mean |err| %.2f %%, max |err| %.2f %%\n", est.soc,
+            pl.soc, 100.0 * fabs((double)est.soc - (double)pl.soc), 100.0 * soc_err_sum / (double)steps,
+            100.0 * soc_err_max);
+    if (r_settled_s >= 0.0)
+    {
+      fprintf(stderr, "R_pack: %.4f ohm vs R0 %.4f, within %.0f %% from t=%.1f s on (%lu updates)\n", est.r_ohm,
+              pp.r0_ohm, SIM_R_SETTLED_PCT, r_settled_s, (unsigned long)est.rls_updates);
+    }
+    else
+    {
+      fprintf(stderr, "R_pack: %.4f ohm vs R0 %.4f, not settled within %.0f %% (%lu updates)\n", est.r_ohm,
+              pp.r0_ohm, SIM_R_SETTLED_PCT, (unsigned long)est.rls_updates);
+    }
+  }
+  else
+  {
+    fprintf(stderr, "final: soc %.4f, R_pack %.4f ohm (%lu updates), flags 0x%02X\n", est.soc, est.r_ohm,
+            (unsigned long)est.rls_updates, est.flags);
+  }
+  fprintf(stderr, "cost: %.1f ns per FEB_SOC_Step on this host (BMS|soc shows the target figure)\n", ns_per_step);
+
+  free(step_I);
+  free(step_V);
+  free(rows);
+  return 0;
+}
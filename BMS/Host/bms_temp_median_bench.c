@@ -0,0 +1,263 @@
+/**
+ ******************************************************************************
+ * @file           : bms_temp_median_bench.c
+ * @brief          : Bank temperature median: quickselect vs insertion sort
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Checks FEB_Temp_Median_dC() against the insertion-sort median it replaced
+ * in validate_temps() and times both at today's sensor count and at twice it:
+ *
+ *   equivalence - BENCH_CASES seeded banks, n = 1..2 * FEB_NUM_TEMP_SENSORS,
+ *                 drawn from each distribution below. The medians must be
+ *                 bit-identical (the even-count 0.5 * (lo + hi) included)
+ *                 and the reordered array must still hold the same readings.
+ *   timing      - one bank of FEB_NUM_TEMP_SENSORS and one of twice that,
+ *                 per distribution. Both paths work on a fresh copy each
+ *                 call (the median reorders its input), so the copy is in
+ *                 both rows.
+ *
+ * Distributions (dC, the way validate_temps() passes them):
+ *   uniform    - anywhere in TEMP_VALID_MIN_DC..TEMP_VALID_MAX_DC
+ *   duplicates - four distinct values (an idle, soaked pack)
+ *   ascending  - a gradient along the MUX order, plus noise
+ *   descending - the same gradient reversed
+ *   spiky      - 30 degC +/- 2 with one reading in eight a bad connection
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted.
+ * Compare the rows with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `path,sensors,distribution,cases,mismatches,ns_per_median`
+ * stderr: summary. Exit status 1 on any mismatch.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_Temp_Median.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "FEB_Const.h" /* needs <stdint.h> first */
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_SEED 0x7E3D015U
+#define BENCH_CASES 200000U
+#define BENCH_MAX_N (2 * FEB_NUM_TEMP_SENSORS)
+#define BENCH_TIMING_REPS 200000U
+
+typedef enum
+{
+  DIST_UNIFORM,
+  DIST_DUPLICATES,
+  DIST_ASCENDING,
+  DIST_DESCENDING,
+  DIST_SPIKY,
+  DIST_COUNT
+} dist_t;
+
+static const char *const dist_names[DIST_COUNT] = {"uniform", "duplicates", "ascending", "descending", "spiky"};
+
+/* ============================================================================
+ * Paths
+ * ============================================================================ */
+
+/* Former validate_temps() median */
+static float insertion_median_dC(float *a, int n)
+{
+  for (int i = 1; i < n; i++)
+  {
+    float key = a[i];
+    int j = i - 1;
+    while (j >= 0 && a[j] > key)
+    {
+      a[j + 1] = a[j];
+      j--;
+    }
+    a[j + 1] = key;
+  }
+  return (n & 1) ? a[n / 2] : 0.5f * (a[n / 2 - 1] + a[n / 2]);
+}
+
+typedef float (*median_fn_t)(float *a, int n);
+
+/* ============================================================================
+ * Bank generator
+ * ============================================================================ */
+
+static uint32_t rng_state = BENCH_SEED;
+
+static uint32_t rng(void)
+{
+  /* xorshift32 */
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static float rng_dC(int32_t lo, int32_t hi)
+{
+  return (float)(lo + (int32_t)(rng() % (uint32_t)(hi - lo + 1)));
+}
+
+static void generate_bank(float *a, int n, dist_t dist)
+{
+  float dup[4];
+  for (int i = 0; i < 4; i++)
+  {
+    dup[i] = rng_dC(200, 400);
+  }
+  for (int i = 0; i < n; i++)
+  {
+    const float gradient_dC = 200.0f + 150.0f * (float)i / (float)n;
+    switch (dist)
+    {
+      case DIST_UNIFORM:
+        a[i] = rng_dC(TEMP_VALID_MIN_DC, TEMP_VALID_MAX_DC);
+        break;
+      case DIST_DUPLICATES:
+        a[i] = dup[rng() & 3U];
+        break;
+      case DIST_ASCENDING:
+        a[i] = gradient_dC + rng_dC(-5, 5);
+        break;
+      case DIST_DESCENDING:
+        a[n - 1 - i] = gradient_dC + rng_dC(-5, 5);
+        break;
+      case DIST_SPIKY:
+      default:
+        a[i] = ((rng() & 7U) == 0U) ? rng_dC(TEMP_VALID_MIN_DC, TEMP_VALID_MAX_DC) : rng_dC(280, 320);
+        break;
+    }
+  }
+}
+
+static int cmp_float(const void *x, const void *y)
+{
+  const float a = *(const float *)x;
+  const float b = *(const float *)y;
+  return (a > b) - (a < b);
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+static volatile float sink;
+
+static double time_median(median_fn_t fn, const float *bank, int n)
+{
+  float work[BENCH_MAX_N];
+  float acc = 0.0f;
+  uint64_t t0 = now_ns();
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    memcpy(work, bank, (size_t)n * sizeof(float));
+    acc += fn(work, n);
+  }
+  const uint64_t total_ns = elapsed_ns(t0, now_ns());
+  sink = acc;
+  return (double)total_ns / BENCH_TIMING_REPS;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  uint32_t cases = 0;
+  uint32_t mismatches = 0;
+
+  for (uint32_t c = 0; c < BENCH_CASES; c++)
+  {
+    const dist_t dist = (dist_t)(c % DIST_COUNT);
+    const int n = 1 + (int)(rng() % BENCH_MAX_N);
+    float bank[BENCH_MAX_N], ref[BENCH_MAX_N], sel[BENCH_MAX_N];
+    generate_bank(bank, n, dist);
+    memcpy(ref, bank, (size_t)n * sizeof(float));
+    memcpy(sel, bank, (size_t)n * sizeof(float));
+
+    const float expect = insertion_median_dC(ref, n);
+    const float got = FEB_Temp_Median_dC(sel, n);
+
+    /* ref is now sorted; sorting sel must give the same readings back */
+    qsort(sel, (size_t)n, sizeof(float), cmp_float);
+    cases++;
+    if (memcmp(&expect, &got, sizeof(float)) != 0 || memcmp(ref, sel, (size_t)n * sizeof(float)) != 0)
+    {
+      if (mismatches == 0U)
+      {
+        fprintf(stderr, "first mismatch: case %u, %s, n=%d: insertion %.2f, select %.2f\n", c, dist_names[dist], n,
+                (double)expect, (double)got);
+      }
+      mismatches++;
+    }
+  }
+
+  calibrate_clock();
+  printf("path,sensors,distribution,cases,mismatches,ns_per_median\n");
+  double worst_speedup[2] = {1e9, 1e9};
+  for (int scale = 1; scale <= 2; scale++)
+  {
+    const int n = scale * FEB_NUM_TEMP_SENSORS;
+    for (int d = 0; d < DIST_COUNT; d++)
+    {
+      float bank[BENCH_MAX_N];
+      generate_bank(bank, n, (dist_t)d);
+      const double ins_ns = time_median(insertion_median_dC, bank, n);
+      const double sel_ns = time_median(FEB_Temp_Median_dC, bank, n);
+      printf("insertion,%d,%s,%u,0,%.1f\n", n, dist_names[d], cases, ins_ns);
+      printf("select,%d,%s,%u,%u,%.1f\n", n, dist_names[d], cases, mismatches, sel_ns);
+      fprintf(stderr, "n=%-3d %-10s insertion %7.1f ns, select %7.1f ns (%.1fx)\n", n, dist_names[d], ins_ns, sel_ns,
+              sel_ns > 0.0 ? ins_ns / sel_ns : 0.0);
+      if (sel_ns > 0.0 && ins_ns / sel_ns < worst_speedup[scale - 1])
+      {
+        worst_speedup[scale - 1] = ins_ns / sel_ns;
+      }
+    }
+  }
+
+  const bool ok = (mismatches == 0U);
+  fprintf(stderr, "equivalence: %u banks, n=1..%d, %u mismatches\n", cases, BENCH_MAX_N, mismatches);
+  fprintf(stderr, "worst-case speedup: %.1fx at %d sensors, %.1fx at %d sensors\n", worst_speedup[0],
+          FEB_NUM_TEMP_SENSORS, worst_speedup[1], BENCH_MAX_N);
+  fprintf(stderr, "%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
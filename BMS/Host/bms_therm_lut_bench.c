@@ -0,0 +1,259 @@
+/**
+ ******************************************************************************
+ * @file           : bms_therm_lut_bench.c
+ * @brief          : Thermistor lookup table vs the float Beta equation
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Checks FEB_Thermistor_Code_To_Temp_dC() against the float reference
+ * FEB_Thermistor_Voltage_To_Temp_C() and times both the way store_cell_temps()
+ * used them:
+ *
+ *   accuracy - every one of the 65536 aux codes. Both paths must reject the
+ *              same codes (outside THERM_MIN/MAX_VOLTAGE_MV), and inside the
+ *              window the table must stay within BENCH_MAX_ERR_C of the
+ *              float path, rounding to deci-degC included.
+ *   timing   - one scan's worth of codes (FEB_NUM_TEMP_SENSORS per bank,
+ *              spread over BENCH_SCAN_MIN_C..BENCH_SCAN_MAX_C) through each
+ *              path: code -> mV -> Beta for the float path, code -> table ->
+ *              degC for the LUT.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted;
+ * on x86 the TSC count per call is reported as well. Compare the rows with
+ * each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `path,codes,valid,window_mismatches,max_err_C,max_err_operating_C,ns_per_call,cycles_per_call`
+ * stderr: summary. Exit status 1 on a window mismatch or an error above
+ * BENCH_MAX_ERR_C.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_Thermistor.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_MAX_ERR_C 0.1f          /* Allowed |table - Beta| inside the window */
+#define BENCH_OPERATING_MIN_C -40.0f  /* Range reported separately */
+#define BENCH_OPERATING_MAX_C 85.0f
+#define BENCH_SCAN_MIN_C 15.0f        /* Spread of the timed scan */
+#define BENCH_SCAN_MAX_C 60.0f
+#define BENCH_SCAN_CODES (FEB_NBANKS * FEB_NUM_TEMP_SENSORS)
+#define BENCH_TIMING_REPS 2000U
+
+typedef struct
+{
+  uint32_t codes;
+  uint32_t valid;
+  uint32_t window_mismatches;
+  float max_err_C;
+  float max_err_code; /* code where max_err_C was seen */
+  float max_err_operating_C;
+  double ns_per_call;
+  double cycles_per_call; /* NAN without a TSC */
+} bench_result_t;
+
+/* ============================================================================
+ * Paths
+ * ============================================================================ */
+
+static float code_to_mV(int16_t code)
+{
+  return ((float)code * ADBMS_ADC_LSB_V + ADBMS_ADC_OFFSET_V) * 1000.0f;
+}
+
+/* Former store_cell_temps() conversion */
+static float float_path_C(int16_t code)
+{
+  return FEB_Thermistor_Voltage_To_Temp_C(code_to_mV(code));
+}
+
+/* Current store_cell_temps() conversion */
+static float lut_path_C(int16_t code)
+{
+  int16_t dC = FEB_Thermistor_Code_To_Temp_dC(code);
+  return (dC == THERM_TEMP_INVALID_DC) ? NAN : (float)dC * 0.1f;
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+static volatile float sink;
+
+typedef float (*path_fn_t)(int16_t code);
+
+static void time_path(path_fn_t fn, const int16_t *codes, bench_result_t *r)
+{
+  uint64_t total_ns = 0;
+  uint64_t total_tsc = 0;
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    float acc = 0.0f;
+#if BENCH_HAVE_TSC
+    uint64_t c0 = __rdtsc();
+#endif
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_SCAN_CODES; i++)
+    {
+      acc += fn(codes[i]);
+    }
+    total_ns += elapsed_ns(t0, now_ns());
+#if BENCH_HAVE_TSC
+    total_tsc += __rdtsc() - c0;
+#endif
+    sink = acc;
+  }
+  const double calls = (double)BENCH_TIMING_REPS * BENCH_SCAN_CODES;
+  r->ns_per_call = (double)total_ns / calls;
+  r->cycles_per_call = BENCH_HAVE_TSC ? (double)total_tsc / calls : NAN;
+}
+
+/* Code whose float temperature is closest to target_C (the curve is monotonic). */
+static int16_t code_for_temp(float target_C)
+{
+  int16_t best = 0;
+  float best_err = INFINITY;
+  for (int32_t code = INT16_MIN; code <= INT16_MAX; code++)
+  {
+    float t = float_path_C((int16_t)code);
+    if (!isnan(t) && fabsf(t - target_C) < best_err)
+    {
+      best_err = fabsf(t - target_C);
+      best = (int16_t)code;
+    }
+  }
+  return best;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  bench_result_t ref = {0}, lut = {0};
+
+  uint64_t t0 = now_ns();
+  FEB_Thermistor_Init();
+  const uint64_t build_ns = now_ns() - t0;
+
+  for (int32_t code = INT16_MIN; code <= INT16_MAX; code++)
+  {
+    float expect = float_path_C((int16_t)code);
+    float got = lut_path_C((int16_t)code);
+    ref.codes++;
+    lut.codes++;
+    if (isnan(expect) != isnan(got))
+    {
+      lut.window_mismatches++;
+      continue;
+    }
+    if (isnan(expect))
+    {
+      continue;
+    }
+    ref.valid++;
+    lut.valid++;
+
+    float err = fabsf(got - expect);
+    if (err > lut.max_err_C)
+    {
+      lut.max_err_C = err;
+      lut.max_err_code = (float)code;
+    }
+    if (expect >= BENCH_OPERATING_MIN_C && expect <= BENCH_OPERATING_MAX_C && err > lut.max_err_operating_C)
+    {
+      lut.max_err_operating_C = err;
+    }
+  }
+
+  static int16_t scan_codes[BENCH_SCAN_CODES];
+  const int16_t code_lo = code_for_temp(BENCH_SCAN_MAX_C); /* hotter = lower voltage */
+  const int16_t code_hi = code_for_temp(BENCH_SCAN_MIN_C);
+  for (uint32_t i = 0; i < BENCH_SCAN_CODES; i++)
+  {
+    /* Stride through the range so neighbouring calls hit different nodes */
+    uint32_t j = (i * 97U) % BENCH_SCAN_CODES;
+    scan_codes[i] = (int16_t)(code_lo + (int32_t)((int64_t)(code_hi - code_lo) * j / (BENCH_SCAN_CODES - 1U)));
+  }
+
+  calibrate_clock();
+  time_path(float_path_C, scan_codes, &ref);
+  time_path(lut_path_C, scan_codes, &lut);
+
+  printf("path,codes,valid,window_mismatches,max_err_C,max_err_operating_C,ns_per_call,cycles_per_call\n");
+  const bench_result_t *rows[] = {&ref, &lut};
+  const char *names[] = {"float", "lut"};
+  for (int i = 0; i < 2; i++)
+  {
+    const bench_result_t *r = rows[i];
+    printf("%s,%u,%u,%u,%.4f,%.4f,%.2f,", names[i], r->codes, r->valid, r->window_mismatches, r->max_err_C,
+           r->max_err_operating_C, r->ns_per_call);
+    if (isnan(r->cycles_per_call))
+    {
+      printf("\n");
+    }
+    else
+    {
+      printf("%.1f\n", r->cycles_per_call);
+    }
+  }
+
+  const bool ok = (lut.window_mismatches == 0U) && (lut.max_err_C <= BENCH_MAX_ERR_C);
+  fprintf(stderr, "table: %u nodes, %u bytes, built in %.1f us\n", THERM_LUT_SIZE,
+          (unsigned)(THERM_LUT_SIZE * sizeof(int16_t)), (double)build_ns / 1000.0);
+  fprintf(stderr, "window: %u valid codes (%.0f..%.0f mV), %u mismatches\n", lut.valid, THERM_MIN_VOLTAGE_MV,
+          THERM_MAX_VOLTAGE_MV, lut.window_mismatches);
+  fprintf(stderr, "error: max %.4f degC at code %d (%.1f mV), %.4f degC over %.0f..%.0f degC (limit %.2f)\n",
+          lut.max_err_C, (int)lut.max_err_code, code_to_mV((int16_t)lut.max_err_code), lut.max_err_operating_C,
+          BENCH_OPERATING_MIN_C, BENCH_OPERATING_MAX_C, BENCH_MAX_ERR_C);
+  fprintf(stderr, "scan: %u codes over %.0f..%.0f degC, float %.2f ns/call, lut %.2f ns/call (%.1fx)\n",
+          (unsigned)BENCH_SCAN_CODES, BENCH_SCAN_MIN_C, BENCH_SCAN_MAX_C, ref.ns_per_call, lut.ns_per_call,
+          lut.ns_per_call > 0.0 ? ref.ns_per_call / lut.ns_per_call : 0.0);
+  fprintf(stderr, "%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
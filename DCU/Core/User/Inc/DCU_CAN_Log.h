@@ -1,12 +1,14 @@
 /**
  ******************************************************************************
  * @file           : DCU_CAN_Log.h
- * @brief          : Raw CAN frame capture and CSV logging to SD card
+ * @brief          : Raw CAN frame capture and logging to SD card
  * @author         : Formula Electric @ Berkeley
  *
  * Captures every frame received on CAN1 and CAN2 via wildcard callbacks
- * registered with feb_can, queues them, and writes a CSV file per boot to
- * the SD card.
+ * registered with feb_can, queues them, and writes one log file per boot to
+ * the SD card: packed binary `log_NNNN.fcl` by default (see
+ * DCU_CAN_Log_Format.h; convert with scripts/canlog-to-csv.py), or the
+ * legacy `log_NNNN.csv` when built with DCU_CAN_LOG_BINARY=0.
  *
  * Pipeline (all FreeRTOS):
  *
@@ -16,7 +18,14 @@
  *   canLogQueue (256 × DCU_CAN_Frame_t)
  *        │
  *        ▼
- *   canLogTask: format CSV → 4 KB batch buffer → DCU_SD_Append
+ *   canLogTask: encode record in place into ring buffer N
+ *        │ full (or 1 s old) → DCU_SD_LogWriteAsync, move to N+1
+ *        ▼
+ *   sdTask: f_write straight from ring buffer N (one open file per
+ *           session, f_sync on a timer, rotated at DCU_CAN_LOG_ROTATE_BYTES)
+ *
+ * canLogTask only blocks ("stalls") when every ring buffer is still queued
+ * behind sdTask.
  *
  * The canLogTask is the only entity that touches the SD card via this path;
  * it serializes through the project's `sdTask` like all other SD users.
@@ -35,6 +44,15 @@ extern "C"
 #include <stddef.h>
 #include <stdint.h>
 
+/**
+ * @brief SD log format: 1 = packed binary blocks (default), 0 = CSV rows.
+ *
+ * The live console stream always emits CSV rows regardless of this setting.
+ */
+#ifndef DCU_CAN_LOG_BINARY
+#define DCU_CAN_LOG_BINARY 1
+#endif
+
   /**
    * @brief Captured CAN frame, sized to match the canLogQueue item width (24 B).
    *
@@ -58,23 +76,42 @@ extern "C"
   /**
    * @brief Print `dcu|can|log` status to the console.
    *
-   * Emits: active filename, frames written, drops, queue depth.
+   * Emits: active filename, frames written, drops, queue depth, SD ring
+   * high-water and stall counters.
    */
   void DCU_CAN_Log_PrintStats(void);
 
-  /** @return true once the SD card is open and the CSV header has been written. */
+  /** @return true once the SD card is open and the file header has been written. */
   bool DCU_CAN_Log_IsActive(void);
 
   /** @return Number of frames dropped from canLogQueue (queue-full events). */
   uint32_t DCU_CAN_Log_GetDropCount(void);
 
-  /** @return Number of CSV rows successfully written to the SD card. */
+  /** @return Number of frames encoded into the SD log. */
   uint32_t DCU_CAN_Log_GetWrittenCount(void);
 
-  /** @return Current canLogQueue depth (frames awaiting CSV format). */
+  /** @return Most SD ring buffers ever waiting on sdTask at once (out of DCU_CAN_Log_GetBufCount()). */
+  uint32_t DCU_CAN_Log_GetBufHighWater(void);
+
+  /** @return Number of SD ring buffers. */
+  uint32_t DCU_CAN_Log_GetBufCount(void);
+
+  /** @return Times canLogTask blocked because every ring buffer was with sdTask. */
+  uint32_t DCU_CAN_Log_GetStallCount(void);
+
+  /** @return Total ms canLogTask spent stalled (not draining canLogQueue). */
+  uint32_t DCU_CAN_Log_GetStallTimeMs(void);
+
+  /** @return Longest single stall in ms. */
+  uint32_t DCU_CAN_Log_GetStallMaxMs(void);
+
+  /** @return Ring buffers whose SD write failed (data lost). */
+  uint32_t DCU_CAN_Log_GetWriteErrorCount(void);
+
+  /** @return Current canLogQueue depth (frames awaiting encoding). */
   uint32_t DCU_CAN_Log_GetQueueDepth(void);
 
-  /** @return Active CSV filename, or "(none)" if logging has not started. */
+  /** @return Active log filename, or "(none)" if logging has not started. */
   const char *DCU_CAN_Log_GetFilename(void);
 
   /* ============================================================================
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file           : DCU_CAN_Log_Format.h
+ * @brief          : Packed binary on-disk format for the DCU CAN logger
+ * @author         : Formula Electric @ Berkeley
+ *
+ * The binary log replaces the ~50-byte ASCII row per frame with a ~12-byte
+ * record and does no printf work on the logging path. scripts/canlog-to-csv.py
+ * turns a binary log back into the CSV the downstream tools already read.
+ *
+ * File layout (all integers little-endian, every block DCU_CAN_LOG_BLOCK_BYTES):
+ *
+ *   block 0   file header
+ *               0  char[8]  "FEBCANLG"
+ *               8  u16      format version (DCU_CAN_LOG_FORMAT_VERSION)
+ *              10  u16      block size in bytes
+ *              12  u16      session id (matches log_NNNN)
+ *              14  u16      reserved (0)
+ *              16  u32      HAL_GetTick() when the file was opened
+ *              20  u32      CRC-32 of bytes 0..19
+ *               …  zero padding
+ *
+ *   block 1.. data block
+ *               0  u32      "FCLB" block magic
+ *               4  u32      block sequence number (1, 2, 3, …)
+ *               8  u32      base timestamp (ts_ms of the first record)
+ *              12  u16      payload bytes used
+ *              14  u16      record count
+ *              16  u32      CRC-32 of bytes 0..15 followed by the payload
+ *              20  records, then zero padding to the block size
+ *
+ *   record      u8 flags    [3:0] dlc, [4] bus (0 = CAN1, 1 = CAN2),
+ *                           [5] extended id, [7:6] timestamp delta width
+ *                           (0 = same ms, 1 = u8, 2 = u16, 3 = u32)
+ *               delta       0/1/2/4 bytes, ms since the previous record in
+ *                           the same block (first record: since base)
+ *               id          u16 (standard) or u32 (extended)
+ *               data[dlc]
+ *
+ * Records never straddle blocks and every block restarts its timestamp
+ * chain, so a corrupt block loses only its own frames. Blocks are
+ * sector-sized so an appended block never splits an SD sector.
+ *
+ * CRC-32 is the zlib/IEEE polynomial (reflected 0xEDB88320, init and final
+ * XOR 0xFFFFFFFF) so the converter can check it with zlib.crc32().
+ ******************************************************************************
+ */
+
+#ifndef DCU_CAN_LOG_FORMAT_H
+#define DCU_CAN_LOG_FORMAT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+  struct DCU_CAN_Frame;
+  typedef struct DCU_CAN_Frame DCU_CAN_Frame_t;
+
+/* ============================================================================
+ * Format constants — keep scripts/canlog-to-csv.py in sync
+ * ============================================================================ */
+
+#define DCU_CAN_LOG_FORMAT_VERSION 1U
+#define DCU_CAN_LOG_BLOCK_BYTES 512U
+#define DCU_CAN_LOG_FILE_MAGIC "FEBCANLG"
+#define DCU_CAN_LOG_BLOCK_MAGIC 0x424C4346UL /* "FCLB" little-endian */
+#define DCU_CAN_LOG_BLOCK_HEADER_BYTES 20U
+#define DCU_CAN_LOG_BLOCK_PAYLOAD_BYTES (DCU_CAN_LOG_BLOCK_BYTES - DCU_CAN_LOG_BLOCK_HEADER_BYTES)
+#define DCU_CAN_LOG_RECORD_MAX_BYTES 17U /* flags + u32 delta + u32 id + 8 data */
+
+#define DCU_CAN_LOG_REC_DLC_MASK 0x0FU
+#define DCU_CAN_LOG_REC_BUS2 0x10U
+#define DCU_CAN_LOG_REC_EXT 0x20U
+#define DCU_CAN_LOG_REC_TS_SHIFT 6U
+
+  /**
+   * @brief Data block under construction.
+   *
+   * The caller owns the DCU_CAN_LOG_BLOCK_BYTES buffer; the encoder fills
+   * records in place and writes the header on seal, so a sealed block can be
+   * handed to the SD layer without copying.
+   */
+  typedef struct
+  {
+    uint8_t *buf;     /**< DCU_CAN_LOG_BLOCK_BYTES backing store */
+    uint32_t seq;     /**< Sequence number written into the header */
+    uint32_t base_ts; /**< ts_ms of the first record */
+    uint32_t prev_ts; /**< ts_ms of the last record (delta reference) */
+    uint16_t used;    /**< Payload bytes used */
+    uint16_t count;   /**< Records in this block */
+  } DCU_CAN_Log_Block_t;
+
+  /**
+   * @brief Fill a DCU_CAN_LOG_BLOCK_BYTES buffer with the file header block.
+   */
+  void DCU_CAN_Log_Format_FileHeader(uint8_t *out, uint16_t session, uint32_t start_ms);
+
+  /** @brief Start an empty data block in @p buf with sequence number @p seq. */
+  void DCU_CAN_Log_Format_BlockBegin(DCU_CAN_Log_Block_t *block, uint8_t *buf, uint32_t seq);
+
+  /**
+   * @brief Encode one frame into the block.
+   * @return false if the record does not fit (seal and start a new block).
+   */
+  bool DCU_CAN_Log_Format_BlockAppend(DCU_CAN_Log_Block_t *block, const DCU_CAN_Frame_t *frame);
+
+  /** @brief Write the header + CRC and zero the unused tail of the block. */
+  void DCU_CAN_Log_Format_BlockSeal(DCU_CAN_Log_Block_t *block);
+
+  /** @brief zlib-compatible CRC-32; pass 0 to start, the previous result to continue. */
+  uint32_t DCU_CAN_Log_Format_Crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DCU_CAN_LOG_FORMAT_H */
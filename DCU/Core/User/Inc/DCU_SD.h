@@ -41,6 +41,10 @@ extern "C"
     DCU_SD_OP_DELETE,
     DCU_SD_OP_SMOKE_TEST,
     DCU_SD_OP_BENCH,
+    DCU_SD_OP_LOG_OPEN,
+    DCU_SD_OP_LOG_WRITE,
+    DCU_SD_OP_LOG_SYNC,
+    DCU_SD_OP_LOG_CLOSE,
   } DCU_SD_OpType_t;
 
   typedef struct
@@ -65,11 +69,31 @@ extern "C"
     /* The thread that posted the request — sdTask wakes it via thread flags
      * when the operation completes. No allocation per call. */
     osThreadId_t caller;
+
+    /* Flag set on `caller` at completion; 0 means DCU_SD_FLAG_DONE. Async
+     * submitters pick their own bit so it never collides with a synchronous
+     * call made from the same thread. */
+    uint32_t done_flag;
+
+    /* Set by sdTask (after `result`) once the request is finished and the
+     * buffer may be reused. */
+    volatile bool complete;
   } DCU_SD_Request_t;
 
   /* Thread flag bit used by sdTask to signal completion to the caller. */
 #define DCU_SD_FLAG_DONE (1U << 24)
 
+/* Log session: the open file is f_sync'd at most this often (directory entry
+ * + FAT updated), bounding what a power cut can lose. */
+#ifndef DCU_SD_LOG_SYNC_INTERVAL_MS
+#define DCU_SD_LOG_SYNC_INTERVAL_MS 2000U
+#endif
+
+/* Sector size log writers should align to (FATFS _MAX_SS). Whole-sector
+ * writes at a sector-aligned offset go straight to the card without passing
+ * through the FIL sector buffer. */
+#define DCU_SD_SECTOR_BYTES 512U
+
   /* ============================================================================
    * Public API — every call routes through sdTask. Returns FR_TIMEOUT on
    * queue post failure or when the SD task takes longer than `timeout_ms`.
@@ -95,10 +119,59 @@ extern "C"
 
   FRESULT DCU_SD_Delete(const char *path, uint32_t timeout_ms);
 
+  /* ============================================================================
+   * Log session — one persistent file handle owned by sdTask, for
+   * high-rate appenders (the CAN logger). Avoids the f_open / cluster-chain
+   * walk / f_close that DCU_SD_Append does on every call.
+   *
+   *   DCU_SD_LogOpen  → DCU_SD_LogWrite … (auto f_sync every
+   *   DCU_SD_LOG_SYNC_INTERVAL_MS) → DCU_SD_LogClose at rotation
+   *
+   * Only one session may be open at a time.
+   * ==========================================================================*/
+
+  /**
+   * @brief Create (truncate) @p path and keep it open for appending.
+   *
+   * @param prealloc_bytes When non-zero, f_expand reserves a contiguous run of
+   *                       clusters this large so appends never search the FAT.
+   *                       Lack of contiguous space is not an error — the file
+   *                       just grows the normal way.
+   * @return FR_LOCKED if a session is already open.
+   */
+  FRESULT DCU_SD_LogOpen(const char *path, uint32_t prealloc_bytes, uint32_t timeout_ms);
+
+  /** Append to the open session file. FR_INVALID_OBJECT if none is open. */
+  FRESULT DCU_SD_LogWrite(const uint8_t *data, uint32_t len, uint32_t timeout_ms);
+
+  /**
+   * @brief Queue an append to the session file and return immediately.
+   *
+   * sdTask writes straight from @p data — nothing is copied — so @p data and
+   * @p req must stay untouched until `req->complete` is true. Completion is
+   * also signalled by setting @p done_flag on the calling thread. Requests
+   * complete in submission order.
+   *
+   * @param timeout_ms How long to wait for room in sdRequestQueue.
+   * @return FR_OK if queued, FR_TIMEOUT if the queue stayed full.
+   */
+  FRESULT DCU_SD_LogWriteAsync(DCU_SD_Request_t *req, const uint8_t *data, uint32_t len, uint32_t done_flag,
+                               uint32_t timeout_ms);
+
+  /** Force an f_sync now (e.g. before a planned power-down). */
+  FRESULT DCU_SD_LogSync(uint32_t timeout_ms);
+
+  /** Sync and close the session file. No-op if none is open. */
+  FRESULT DCU_SD_LogClose(uint32_t timeout_ms);
+
   /** Self-contained smoke test (mount + write + read + unmount). */
   void DCU_SD_RunSmokeTest(void);
 
-  /** 64 KB write+read benchmark; prints throughput via FEB_Console_Printf. */
+  /**
+   * 64 KB write+read benchmark, then sustained-append throughput for
+   * open/append/close per flush vs. a persistent pre-allocated handle.
+   * Prints via FEB_Console_Printf.
+   */
   void DCU_SD_RunBenchmark(void);
 
   /** Convert a FRESULT into a printable string. */
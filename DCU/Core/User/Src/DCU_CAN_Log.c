@@ -1,7 +1,7 @@
 /**
  ******************************************************************************
  * @file           : DCU_CAN_Log.c
- * @brief          : Raw CAN → SD card CSV logger
+ * @brief          : Raw CAN → SD card logger (packed binary or CSV)
  * @author         : Formula Electric @ Berkeley
  ******************************************************************************
  */
@@ -9,6 +9,7 @@
 #include "DCU_CAN_Log.h"
 
 #include "DCU_CAN_Filter.h"
+#include "DCU_CAN_Log_Format.h"
 #include "FEB_Task_Radio.h"
 #include "DCU_SD.h"
 #include "cmsis_os.h"
@@ -33,21 +34,36 @@ _Static_assert(sizeof(DCU_CAN_Frame_t) == 20, "DCU_CAN_Frame_t layout changed 
 /* Tunables ----------------------------------------------------------------- */
 
 #define DCU_CAN_LOG_IDX_PATH "0:canlog.idx"
-/* 8.3 name: "log_NNNN" (8 chars) + "csv" (3 chars). FATFS is built with
+/* 8.3 name: "log_NNNN" (8 chars) + 3-char extension. FATFS is built with
  * _USE_LFN=0 (see DCU/FATFS/Target/ffconf.h), so longer bases fail with
  * FR_INVALID_NAME. The .idx file already fits 8.3 unchanged. */
+#if DCU_CAN_LOG_BINARY
+#define DCU_CAN_LOG_FILENAME_TEMPLATE "0:log_%04u.fcl"
+#else
 #define DCU_CAN_LOG_FILENAME_TEMPLATE "0:log_%04u.csv"
+#endif
 #define DCU_CAN_LOG_FILENAME_MAX 24U
 
 #define DCU_CAN_LOG_HEADER "timestamp_ms,bus,can_id,dlc,d0,d1,d2,d3,d4,d5,d6,d7\r\n"
 
-#define DCU_CAN_LOG_FLUSH_BUF_BYTES 4096U
-#define DCU_CAN_LOG_FLUSH_THRESHOLD_BYTES 3072U
+/* Ring of sector-multiple buffers: canLogTask fills one while sdTask writes
+ * the ones before it straight out of the ring. A full buffer is submitted at
+ * once; a partly filled one goes out after DCU_CAN_LOG_FLUSH_INTERVAL_MS. */
+#define DCU_CAN_LOG_RING_BUFS 4U
+#define DCU_CAN_LOG_RING_BUF_BYTES 2048U
 #define DCU_CAN_LOG_FLUSH_INTERVAL_MS 1000U
+/* Thread flag sdTask sets on canLogTask when a ring buffer write completes
+ * (DCU_SD_FLAG_DONE stays reserved for synchronous DCU_SD_* calls). */
+#define DCU_CAN_LOG_FLAG_SD_DONE (1U << 25)
 #define DCU_CAN_LOG_LINE_BUF_BYTES 80U
 #define DCU_CAN_LOG_SD_MOUNT_TIMEOUT_MS 5000U
 #define DCU_CAN_LOG_SD_IO_TIMEOUT_MS 5000U
 #define DCU_CAN_LOG_MAX_SESSION_ID 9999U
+/* Each log file gets a contiguous cluster run reserved up front (f_expand)
+ * and is closed and rotated to the next session id once it reaches the
+ * same size, so appends never walk a fragmented FAT. */
+#define DCU_CAN_LOG_PREALLOC_BYTES (32UL * 1024UL * 1024UL)
+#define DCU_CAN_LOG_ROTATE_BYTES DCU_CAN_LOG_PREALLOC_BYTES
 
 /* External RTOS handles defined in freertos.c ----------------------------- */
 extern osMessageQueueId_t canLogQueueHandle;
@@ -59,8 +75,37 @@ static volatile bool s_active = false;
 static volatile uint32_t s_written_count = 0;
 static volatile uint32_t s_drop_count = 0;
 
-static uint8_t s_flush_buf[DCU_CAN_LOG_FLUSH_BUF_BYTES];
-static size_t s_flush_used = 0;
+_Static_assert((DCU_CAN_LOG_RING_BUF_BYTES % DCU_SD_SECTOR_BYTES) == 0U, "ring buffers must be whole sectors");
+
+typedef struct
+{
+  uint8_t data[DCU_CAN_LOG_RING_BUF_BYTES] __attribute__((aligned(4)));
+  DCU_SD_Request_t req; /* Owned by sdTask while in_flight */
+  uint16_t used;
+  uint16_t cap; /* Fill limit; ends the buffer on a file sector boundary */
+  bool in_flight;
+} LogBuf_t;
+
+static LogBuf_t s_ring[DCU_CAN_LOG_RING_BUFS];
+static uint8_t s_fill_idx = 0;   /* Buffer canLogTask is filling */
+static uint8_t s_oldest_idx = 0; /* Oldest buffer still with sdTask */
+static uint8_t s_in_flight = 0;
+static uint32_t s_file_bytes = 0; /* Bytes submitted to the current file */
+
+/* Ring health, read by the console. */
+static volatile uint32_t s_ring_high_water = 0;
+static volatile uint32_t s_stall_count = 0;
+static volatile uint32_t s_stall_ms_total = 0;
+static volatile uint32_t s_stall_ms_max = 0;
+static volatile uint32_t s_write_errors = 0;
+
+#if DCU_CAN_LOG_BINARY
+_Static_assert((DCU_CAN_LOG_RING_BUF_BYTES % DCU_CAN_LOG_BLOCK_BYTES) == 0U, "ring buffers must hold whole blocks");
+
+/* Block being encoded in place at the fill buffer's `used` offset. */
+static DCU_CAN_Log_Block_t s_block;
+static uint32_t s_block_seq = 0;
+#endif
 
 /* Live console stream state. Shared between the pipe-form handlers in
  * DCU_Commands.c and the CSV-form handlers registered below. */
@@ -207,15 +252,157 @@ static uint16_t pick_session_id(void)
   return (uint16_t)session;
 }
 
-static bool prepare_sd_file(void)
+/* Ring buffer management ------------------------------------------------- */
+
+/* Retire finished writes, oldest first (sdTask completes them in order). */
+static void reap_completed(void)
 {
-  FRESULT r = DCU_SD_Mount(DCU_CAN_LOG_SD_MOUNT_TIMEOUT_MS);
-  if (r != FR_OK)
+  while (s_in_flight > 0U && s_ring[s_oldest_idx].req.complete)
   {
-    LOG_E(TAG_CAN_LOG, "Mount failed: %s (%d)", DCU_SD_FresultString(r), (int)r);
-    return false;
+    LogBuf_t *buf = &s_ring[s_oldest_idx];
+    if (buf->req.result != FR_OK)
+    {
+      s_write_errors++;
+      LOG_W(TAG_CAN_LOG, "Write failed: %s (%d)", DCU_SD_FresultString(buf->req.result), (int)buf->req.result);
+    }
+    buf->in_flight = false;
+    s_oldest_idx = (uint8_t)((s_oldest_idx + 1U) % DCU_CAN_LOG_RING_BUFS);
+    s_in_flight--;
+  }
+}
+
+/* Make s_ring[s_fill_idx] writable, blocking while sdTask still owns it.
+ * Time spent here is a stall: canLogQueue is not being drained. */
+static void acquire_fill_buffer(void)
+{
+  LogBuf_t *buf = &s_ring[s_fill_idx];
+  reap_completed();
+  if (buf->in_flight)
+  {
+    const uint32_t t0 = HAL_GetTick();
+    while (buf->in_flight)
+    {
+      const uint32_t flags =
+          osThreadFlagsWait(DCU_CAN_LOG_FLAG_SD_DONE, osFlagsWaitAny, pdMS_TO_TICKS(DCU_CAN_LOG_SD_IO_TIMEOUT_MS));
+      if ((flags & osFlagsError) != 0U)
+      {
+        /* The request is still queued and points at this buffer, so it
+         * cannot be reused — keep waiting, but say so. */
+        LOG_W(TAG_CAN_LOG, "sdTask has not completed a log write in %lu ms",
+              (unsigned long)DCU_CAN_LOG_SD_IO_TIMEOUT_MS);
+      }
+      reap_completed();
+    }
+    const uint32_t dt = HAL_GetTick() - t0;
+    s_stall_count++;
+    s_stall_ms_total += dt;
+    if (dt > s_stall_ms_max)
+    {
+      s_stall_ms_max = dt;
+    }
+  }
+
+  buf->used = 0;
+  /* A timed flush may have left the file mid-sector; shorten this buffer so
+   * it ends back on a sector boundary and later full buffers stay aligned. */
+  buf->cap = (uint16_t)(DCU_CAN_LOG_RING_BUF_BYTES - (s_file_bytes % DCU_SD_SECTOR_BYTES));
+}
+
+static bool open_log_file(void);
+
+/* Hand the fill buffer to sdTask and move on to the next one. */
+static void submit_fill_buffer(void)
+{
+  LogBuf_t *buf = &s_ring[s_fill_idx];
+  if (buf->used == 0U)
+  {
+    return;
   }
 
+  /* If the queue stays full the request comes back already complete with
+   * FR_TIMEOUT, and reap_completed() counts the lost buffer like any other
+   * failed write. */
+  buf->in_flight = true;
+  (void)DCU_SD_LogWriteAsync(&buf->req, buf->data, buf->used, DCU_CAN_LOG_FLAG_SD_DONE, DCU_CAN_LOG_SD_IO_TIMEOUT_MS);
+  s_in_flight++;
+  if (s_in_flight > s_ring_high_water)
+  {
+    s_ring_high_water = s_in_flight;
+  }
+  s_file_bytes += buf->used;
+
+  s_fill_idx = (uint8_t)((s_fill_idx + 1U) % DCU_CAN_LOG_RING_BUFS);
+  acquire_fill_buffer();
+
+  if (s_file_bytes >= DCU_CAN_LOG_ROTATE_BYTES)
+  {
+    /* LogClose queues behind every in-flight write, so the old file is
+     * complete when it returns. */
+    (void)DCU_SD_LogClose(DCU_CAN_LOG_SD_IO_TIMEOUT_MS);
+    reap_completed();
+    if (!open_log_file())
+    {
+      LOG_E(TAG_CAN_LOG, "Rotation failed — logging stopped");
+      s_active = false;
+    }
+  }
+}
+
+#if DCU_CAN_LOG_BINARY
+
+static void begin_block(void)
+{
+  LogBuf_t *buf = &s_ring[s_fill_idx];
+  DCU_CAN_Log_Format_BlockBegin(&s_block, &buf->data[buf->used], s_block_seq);
+}
+
+/* Seal the block being filled and open the next one behind it, submitting
+ * the buffer once no further block fits. */
+static void seal_block(void)
+{
+  LogBuf_t *buf = &s_ring[s_fill_idx];
+  DCU_CAN_Log_Format_BlockSeal(&s_block);
+  buf->used = (uint16_t)(buf->used + DCU_CAN_LOG_BLOCK_BYTES);
+  s_block_seq++;
+  if ((uint32_t)buf->used + DCU_CAN_LOG_BLOCK_BYTES > buf->cap)
+  {
+    submit_fill_buffer();
+  }
+  begin_block();
+}
+
+#else
+
+/* Copy bytes into the ring, splitting across buffers so every submitted
+ * buffer is full (and therefore ends on a sector boundary). */
+static void ring_write(const uint8_t *src, size_t len)
+{
+  while (len > 0U)
+  {
+    LogBuf_t *buf = &s_ring[s_fill_idx];
+    size_t n = (size_t)(buf->cap - buf->used);
+    if (n > len)
+    {
+      n = len;
+    }
+    memcpy(&buf->data[buf->used], src, n);
+    buf->used = (uint16_t)(buf->used + n);
+    src += n;
+    len -= n;
+    if (buf->used == buf->cap)
+    {
+      submit_fill_buffer();
+    }
+  }
+}
+
+#endif
+
+/* Open the next session file through the SD log session (one persistent
+ * handle) and stage its header at the start of the (empty) fill buffer.
+ * Called at startup and on rotation. */
+static bool open_log_file(void)
+{
   uint16_t session = pick_session_id();
   int n = snprintf(s_filename, sizeof(s_filename), DCU_CAN_LOG_FILENAME_TEMPLATE, (unsigned)session);
   if (n <= 0 || (size_t)n >= sizeof(s_filename))
@@ -225,33 +412,116 @@ static bool prepare_sd_file(void)
     return false;
   }
 
-  r = DCU_SD_Write(s_filename, (const uint8_t *)DCU_CAN_LOG_HEADER, (uint32_t)(sizeof(DCU_CAN_LOG_HEADER) - 1U),
-                   DCU_CAN_LOG_SD_IO_TIMEOUT_MS);
+  FRESULT r = DCU_SD_LogOpen(s_filename, DCU_CAN_LOG_PREALLOC_BYTES, DCU_CAN_LOG_SD_IO_TIMEOUT_MS);
   if (r != FR_OK)
   {
-    LOG_E(TAG_CAN_LOG, "Header write failed: %s (%d)", DCU_SD_FresultString(r), (int)r);
+    LOG_E(TAG_CAN_LOG, "Open %s failed: %s (%d)", s_filename, DCU_SD_FresultString(r), (int)r);
     s_filename[0] = '\0';
     return false;
   }
 
+  LogBuf_t *buf = &s_ring[s_fill_idx];
+  s_file_bytes = 0;
+  buf->used = 0;
+  buf->cap = DCU_CAN_LOG_RING_BUF_BYTES;
+#if DCU_CAN_LOG_BINARY
+  DCU_CAN_Log_Format_FileHeader(buf->data, session, HAL_GetTick());
+  buf->used = DCU_CAN_LOG_BLOCK_BYTES;
+  s_block_seq = 1U;
+  begin_block();
+#else
+  ring_write((const uint8_t *)DCU_CAN_LOG_HEADER, sizeof(DCU_CAN_LOG_HEADER) - 1U);
+#endif
+
   LOG_I(TAG_CAN_LOG, "Logging to %s", s_filename);
   return true;
 }
 
+static bool prepare_sd_file(void)
+{
+  FRESULT r = DCU_SD_Mount(DCU_CAN_LOG_SD_MOUNT_TIMEOUT_MS);
+  if (r != FR_OK)
+  {
+    LOG_E(TAG_CAN_LOG, "Mount failed: %s (%d)", DCU_SD_FresultString(r), (int)r);
+    return false;
+  }
+  s_fill_idx = 0;
+  acquire_fill_buffer();
+  return open_log_file();
+}
+
 /* Logger task ------------------------------------------------------------- */
 
-static void flush_buffer(void)
+/* Timed flush: ship whatever the fill buffer holds so frames never sit in RAM
+ * longer than DCU_CAN_LOG_FLUSH_INTERVAL_MS. */
+static void flush_partial(void)
 {
-  if (s_flush_used == 0U)
+#if DCU_CAN_LOG_BINARY
+  /* The partial block goes out padded to a full block so the file stays
+   * block-aligned. */
+  if (s_block.count > 0U)
   {
-    return;
+    DCU_CAN_Log_Format_BlockSeal(&s_block);
+    s_ring[s_fill_idx].used = (uint16_t)(s_ring[s_fill_idx].used + DCU_CAN_LOG_BLOCK_BYTES);
+    s_block_seq++;
   }
-  FRESULT r = DCU_SD_Append(s_filename, s_flush_buf, (uint32_t)s_flush_used, DCU_CAN_LOG_SD_IO_TIMEOUT_MS);
-  if (r != FR_OK)
+  submit_fill_buffer();
+  begin_block();
+#else
+  submit_fill_buffer();
+#endif
+}
+
+static bool flush_pending(void)
+{
+#if DCU_CAN_LOG_BINARY
+  return (s_ring[s_fill_idx].used > 0U) || (s_block.count > 0U);
+#else
+  return s_ring[s_fill_idx].used > 0U;
+#endif
+}
+
+#if DCU_CAN_LOG_BINARY
+
+static void log_frame(const DCU_CAN_Frame_t *frame)
+{
+  if (!DCU_CAN_Log_Format_BlockAppend(&s_block, frame))
   {
-    LOG_W(TAG_CAN_LOG, "Append failed: %s (%d)", DCU_SD_FresultString(r), (int)r);
+    seal_block();
+    (void)DCU_CAN_Log_Format_BlockAppend(&s_block, frame);
+  }
+  s_written_count++;
+}
+
+#else
+
+/* SD path: prepend timestamp, append CRLF.
+ *   "<ts_ms>,<bus>,<can_id>,<dlc>,<d0..d7>\r\n" */
+static void log_row(const DCU_CAN_Frame_t *frame, const char *body, int body_len)
+{
+  char ts_buf[12];
+  const int ts_len = snprintf(ts_buf, sizeof(ts_buf), "%lu,", (unsigned long)frame->ts_ms);
+  if (ts_len <= 0)
+  {
+    return;
   }
-  s_flush_used = 0;
+  ring_write((const uint8_t *)ts_buf, (size_t)ts_len);
+  ring_write((const uint8_t *)body, (size_t)body_len);
+  ring_write((const uint8_t *)"\r\n", 2U);
+  s_written_count++;
+}
+
+#endif
+
+/* Live console stream: emit one CSV-protocol `can` row under the active
+ * streaming tx_id. The body matches the spec schema for the `can` response
+ * type: bus,can_id,dlc,d0,...,d7. feb_console adds csv,<tx>,<board>,<us> in
+ * front. CsvEmitAs is the right primitive here because we're emitting from a
+ * different task than the one that handled `can-stream-on` (dispatcher is no
+ * longer in a CSV transaction). */
+static void stream_row(const char *body)
+{
+  (void)FEB_Console_CsvEmitAs(s_stream_tx_id, "can", "%s", body);
 }
 
 void StartCanLogTask(void *argument)
@@ -291,37 +561,31 @@ void StartCanLogTask(void *argument)
 
     if (osMessageQueueGet(canLogQueueHandle, &frame, NULL, pdMS_TO_TICKS(wait_ms)) == osOK)
     {
+      const bool streaming = s_stream_active && s_stream_tx_id[0] != '\0';
+#if DCU_CAN_LOG_BINARY
+      /* Binary records need no text; only format when someone is watching. */
+      if (s_active)
+      {
+        log_frame(&frame);
+      }
+      if (streaming && format_row(line_buf, sizeof(line_buf), &frame) > 0)
+      {
+        stream_row(line_buf);
+      }
+#else
       const int body_len = format_row(line_buf, sizeof(line_buf), &frame);
       if (body_len > 0)
       {
-        /* SD path: prepend timestamp, append CRLF.
-         *   "<ts_ms>,<bus>,<can_id>,<dlc>,<d0..d7>\r\n" */
-        char ts_buf[12];
-        const int ts_len = snprintf(ts_buf, sizeof(ts_buf), "%lu,", (unsigned long)frame.ts_ms);
-        const size_t total = (size_t)ts_len + (size_t)body_len + 2U;
-        if (ts_len > 0 && (s_flush_used + total) <= sizeof(s_flush_buf))
+        if (s_active)
         {
-          memcpy(&s_flush_buf[s_flush_used], ts_buf, (size_t)ts_len);
-          s_flush_used += (size_t)ts_len;
-          memcpy(&s_flush_buf[s_flush_used], line_buf, (size_t)body_len);
-          s_flush_used += (size_t)body_len;
-          s_flush_buf[s_flush_used++] = '\r';
-          s_flush_buf[s_flush_used++] = '\n';
-          s_written_count++;
+          log_row(&frame, line_buf, body_len);
         }
-
-        /* Live console stream: emit one CSV-protocol `can` row under the
-         * active streaming tx_id. The body matches the spec schema for the
-         * `can` response type: bus,can_id,dlc,d0,...,d7. feb_console adds
-         * csv,<tx>,<board>,<us> in front. CsvEmitAs is the right primitive
-         * here because we're emitting from a different task than the one
-         * that handled `can-stream-on` (dispatcher is no longer in a CSV
-         * transaction). */
-        if (s_stream_active && s_stream_tx_id[0] != '\0')
+        if (streaming)
         {
-          (void)FEB_Console_CsvEmitAs(s_stream_tx_id, "can", "%s", line_buf);
+          stream_row(line_buf);
         }
       }
+#endif
 
       if (DCU_CAN_Filter_ShouldForwardToRadio(&frame))
       {
@@ -331,10 +595,14 @@ void StartCanLogTask(void *argument)
       }
     }
 
-    if (s_flush_used >= DCU_CAN_LOG_FLUSH_THRESHOLD_BYTES ||
-        (s_flush_used > 0U && (HAL_GetTick() - last_flush_ms) >= DCU_CAN_LOG_FLUSH_INTERVAL_MS))
+    /* Full buffers were already submitted as they filled. */
+    reap_completed();
+    if ((HAL_GetTick() - last_flush_ms) >= DCU_CAN_LOG_FLUSH_INTERVAL_MS)
     {
-      flush_buffer();
+      if (s_active && flush_pending())
+      {
+        flush_partial();
+      }
       last_flush_ms = HAL_GetTick();
     }
   }
@@ -355,6 +623,36 @@ uint32_t DCU_CAN_Log_GetWrittenCount(void)
   return s_written_count;
 }
 
+uint32_t DCU_CAN_Log_GetBufHighWater(void)
+{
+  return s_ring_high_water;
+}
+
+uint32_t DCU_CAN_Log_GetBufCount(void)
+{
+  return DCU_CAN_LOG_RING_BUFS;
+}
+
+uint32_t DCU_CAN_Log_GetStallCount(void)
+{
+  return s_stall_count;
+}
+
+uint32_t DCU_CAN_Log_GetStallTimeMs(void)
+{
+  return s_stall_ms_total;
+}
+
+uint32_t DCU_CAN_Log_GetStallMaxMs(void)
+{
+  return s_stall_ms_max;
+}
+
+uint32_t DCU_CAN_Log_GetWriteErrorCount(void)
+{
+  return s_write_errors;
+}
+
 uint32_t DCU_CAN_Log_GetQueueDepth(void)
 {
   return (uint32_t)osMessageQueueGetCount(canLogQueueHandle);
@@ -367,8 +665,10 @@ const char *DCU_CAN_Log_GetFilename(void)
 
 void DCU_CAN_Log_PrintStats(void)
 {
-  LOG_I(TAG_CAN_LOG, "active=%d file=%s written=%lu drops=%lu qdepth=%lu", (int)s_active, DCU_CAN_Log_GetFilename(),
-        (unsigned long)s_written_count, (unsigned long)s_drop_count, (unsigned long)DCU_CAN_Log_GetQueueDepth());
+  LOG_I(TAG_CAN_LOG, "active=%d file=%s written=%lu drops=%lu qdepth=%lu bufs=%lu/%u stalls=%lu (%lu ms, max %lu)",
+        (int)s_active, DCU_CAN_Log_GetFilename(), (unsigned long)s_written_count, (unsigned long)s_drop_count,
+        (unsigned long)DCU_CAN_Log_GetQueueDepth(), (unsigned long)s_ring_high_water, (unsigned)DCU_CAN_LOG_RING_BUFS,
+        (unsigned long)s_stall_count, (unsigned long)s_stall_ms_total, (unsigned long)s_stall_ms_max);
 }
 
 /* ============================================================================
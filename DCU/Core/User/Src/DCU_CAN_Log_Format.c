@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ * @file           : DCU_CAN_Log_Format.c
+ * @brief          : Binary CAN log block encoder
+ * @author         : Formula Electric @ Berkeley
+ *
+ * Pure encoding — no RTOS, no SD. Layout is documented in DCU_CAN_Log_Format.h.
+ ******************************************************************************
+ */
+
+#include "DCU_CAN_Log_Format.h"
+
+#include "DCU_CAN_Log.h"
+
+#include <string.h>
+
+/* Little-endian store helpers --------------------------------------------- */
+
+static inline void put_u16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+/* CRC-32 (IEEE, reflected) ------------------------------------------------ */
+
+static uint32_t s_crc_table[256];
+static bool s_crc_table_ready = false;
+
+static void crc32_build_table(void)
+{
+  for (uint32_t i = 0; i < 256U; i++)
+  {
+    uint32_t c = i;
+    for (uint8_t k = 0; k < 8U; k++)
+    {
+      c = (c & 1U) ? (0xEDB88320UL ^ (c >> 1)) : (c >> 1);
+    }
+    s_crc_table[i] = c;
+  }
+  s_crc_table_ready = true;
+}
+
+uint32_t DCU_CAN_Log_Format_Crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+  if (!s_crc_table_ready)
+  {
+    crc32_build_table();
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++)
+  {
+    crc = s_crc_table[(crc ^ data[i]) & 0xFFU] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+/* File header ------------------------------------------------------------- */
+
+void DCU_CAN_Log_Format_FileHeader(uint8_t *out, uint16_t session, uint32_t start_ms)
+{
+  memset(out, 0, DCU_CAN_LOG_BLOCK_BYTES);
+  memcpy(out, DCU_CAN_LOG_FILE_MAGIC, 8U);
+  put_u16(&out[8], (uint16_t)DCU_CAN_LOG_FORMAT_VERSION);
+  put_u16(&out[10], (uint16_t)DCU_CAN_LOG_BLOCK_BYTES);
+  put_u16(&out[12], session);
+  put_u16(&out[14], 0U);
+  put_u32(&out[16], start_ms);
+  put_u32(&out[20], DCU_CAN_Log_Format_Crc32(0U, out, 20U));
+}
+
+/* Data blocks ------------------------------------------------------------- */
+
+void DCU_CAN_Log_Format_BlockBegin(DCU_CAN_Log_Block_t *block, uint8_t *buf, uint32_t seq)
+{
+  block->buf = buf;
+  block->seq = seq;
+  block->base_ts = 0;
+  block->prev_ts = 0;
+  block->used = 0;
+  block->count = 0;
+}
+
+bool DCU_CAN_Log_Format_BlockAppend(DCU_CAN_Log_Block_t *block, const DCU_CAN_Frame_t *frame)
+{
+  if (block->count == 0U)
+  {
+    block->base_ts = frame->ts_ms;
+    block->prev_ts = frame->ts_ms;
+  }
+
+  /* HAL_GetTick is monotonic between queue puts, but compute the delta as an
+   * unsigned wrap so a tick rollover still encodes (as a large u32). */
+  const uint32_t delta = frame->ts_ms - block->prev_ts;
+  uint8_t ts_code;
+  uint8_t ts_bytes;
+  if (delta == 0U)
+  {
+    ts_code = 0U;
+    ts_bytes = 0U;
+  }
+  else if (delta <= 0xFFU)
+  {
+    ts_code = 1U;
+    ts_bytes = 1U;
+  }
+  else if (delta <= 0xFFFFU)
+  {
+    ts_code = 2U;
+    ts_bytes = 2U;
+  }
+  else
+  {
+    ts_code = 3U;
+    ts_bytes = 4U;
+  }
+
+  const bool ext = (frame->id_type != 0U);
+  const uint8_t dlc = (frame->dlc > 8U) ? 8U : frame->dlc;
+  const uint16_t rec_len = (uint16_t)(1U + ts_bytes + (ext ? 4U : 2U) + dlc);
+
+  if ((uint32_t)block->used + rec_len > DCU_CAN_LOG_BLOCK_PAYLOAD_BYTES)
+  {
+    return false;
+  }
+
+  uint8_t *p = &block->buf[DCU_CAN_LOG_BLOCK_HEADER_BYTES + block->used];
+  *p++ = (uint8_t)(dlc | ((frame->bus == 2U) ? DCU_CAN_LOG_REC_BUS2 : 0U) | (ext ? DCU_CAN_LOG_REC_EXT : 0U) |
+                   (uint8_t)(ts_code << DCU_CAN_LOG_REC_TS_SHIFT));
+  switch (ts_bytes)
+  {
+  case 1U:
+    *p++ = (uint8_t)delta;
+    break;
+  case 2U:
+    put_u16(p, (uint16_t)delta);
+    p += 2;
+    break;
+  case 4U:
+    put_u32(p, delta);
+    p += 4;
+    break;
+  default:
+    break;
+  }
+  if (ext)
+  {
+    put_u32(p, frame->can_id);
+    p += 4;
+  }
+  else
+  {
+    put_u16(p, (uint16_t)frame->can_id);
+    p += 2;
+  }
+  memcpy(p, frame->data, dlc);
+
+  block->used = (uint16_t)(block->used + rec_len);
+  block->count++;
+  block->prev_ts = frame->ts_ms;
+  return true;
+}
+
+void DCU_CAN_Log_Format_BlockSeal(DCU_CAN_Log_Block_t *block)
+{
+  uint8_t *b = block->buf;
+  put_u32(&b[0], DCU_CAN_LOG_BLOCK_MAGIC);
+  put_u32(&b[4], block->seq);
+  put_u32(&b[8], block->base_ts);
+  put_u16(&b[12], block->used);
+  put_u16(&b[14], block->count);
+
+  const uint32_t payload_end = DCU_CAN_LOG_BLOCK_HEADER_BYTES + block->used;
+  memset(&b[payload_end], 0, DCU_CAN_LOG_BLOCK_BYTES - payload_end);
+
+  uint32_t crc = DCU_CAN_Log_Format_Crc32(0U, b, 16U);
+  crc = DCU_CAN_Log_Format_Crc32(crc, &b[DCU_CAN_LOG_BLOCK_HEADER_BYTES], block->used);
+  put_u32(&b[16], crc);
+}
@@ -82,12 +82,17 @@ static void cmd_tps_csv(int argc, char *argv[])
 
 static void cmd_can_log(void)
 {
-  FEB_Console_Printf("CAN CSV Logger:\r\n");
+  FEB_Console_Printf("CAN SD Logger:\r\n");
   FEB_Console_Printf("  Active:         %s\r\n", DCU_CAN_Log_IsActive() ? "Yes" : "No");
   FEB_Console_Printf("  Filename:       %s\r\n", DCU_CAN_Log_GetFilename());
   FEB_Console_Printf("  Frames written: %lu\r\n", (unsigned long)DCU_CAN_Log_GetWrittenCount());
   FEB_Console_Printf("  Drops:          %lu\r\n", (unsigned long)DCU_CAN_Log_GetDropCount());
   FEB_Console_Printf("  Queue depth:    %lu\r\n", (unsigned long)DCU_CAN_Log_GetQueueDepth());
+  FEB_Console_Printf("  SD buffers:     %lu/%lu peak in flight\r\n", (unsigned long)DCU_CAN_Log_GetBufHighWater(),
+                     (unsigned long)DCU_CAN_Log_GetBufCount());
+  FEB_Console_Printf("  Stalls:         %lu (%lu ms total, %lu ms max)\r\n", (unsigned long)DCU_CAN_Log_GetStallCount(),
+                     (unsigned long)DCU_CAN_Log_GetStallTimeMs(), (unsigned long)DCU_CAN_Log_GetStallMaxMs());
+  FEB_Console_Printf("  Write errors:   %lu\r\n", (unsigned long)DCU_CAN_Log_GetWriteErrorCount());
 }
 
 static void cmd_can_stream(int argc, char *argv[])
@@ -154,10 +159,14 @@ static void cmd_can_csv(int argc, char *argv[])
 {
   if (argc >= 2 && FEB_strcasecmp(argv[1], "log") == 0)
   {
-    /* Body: active,filename,written,drops,queue_depth */
-    FEB_Console_CsvEmit("can-log", "%d,%s,%lu,%lu,%lu", DCU_CAN_Log_IsActive() ? 1 : 0, DCU_CAN_Log_GetFilename(),
-                        (unsigned long)DCU_CAN_Log_GetWrittenCount(), (unsigned long)DCU_CAN_Log_GetDropCount(),
-                        (unsigned long)DCU_CAN_Log_GetQueueDepth());
+    /* Body: active,filename,written,drops,queue_depth,buf_high_water,
+     * buf_count,stalls,stall_ms,stall_max_ms,write_errors */
+    FEB_Console_CsvEmit("can-log", "%d,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu", DCU_CAN_Log_IsActive() ? 1 : 0,
+                        DCU_CAN_Log_GetFilename(), (unsigned long)DCU_CAN_Log_GetWrittenCount(),
+                        (unsigned long)DCU_CAN_Log_GetDropCount(), (unsigned long)DCU_CAN_Log_GetQueueDepth(),
+                        (unsigned long)DCU_CAN_Log_GetBufHighWater(), (unsigned long)DCU_CAN_Log_GetBufCount(),
+                        (unsigned long)DCU_CAN_Log_GetStallCount(), (unsigned long)DCU_CAN_Log_GetStallTimeMs(),
+                        (unsigned long)DCU_CAN_Log_GetStallMaxMs(), (unsigned long)DCU_CAN_Log_GetWriteErrorCount());
     return;
   }
   if (argc >= 2 && FEB_strcasecmp(argv[1], "stream") == 0)
@@ -778,7 +787,7 @@ static void print_sd_help(void)
   FEB_Console_Printf("  dcu|sd|append <file> <text>     - Append text to file\r\n");
   FEB_Console_Printf("  dcu|sd|read <file>              - Print file contents\r\n");
   FEB_Console_Printf("  dcu|sd|rm <file>                - Delete a file\r\n");
-  FEB_Console_Printf("  dcu|sd|bench                    - 64 KB write+read throughput\r\n");
+  FEB_Console_Printf("  dcu|sd|bench                    - 64 KB write+read + sustained append throughput\r\n");
 }
 
 static void cmd_sd_mount(void)
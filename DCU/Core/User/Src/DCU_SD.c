@@ -20,11 +20,22 @@
 #define DCU_SD_TEST_FILE "smoke.txt"
 #define DCU_SD_BENCH_FILE "bench.bin"
 #define DCU_SD_BENCH_BYTES (64UL * 1024UL)
+/* Sustained-append bench: the CAN logger's shape — 4 KB flushes, synced on
+ * the same schedule the log session uses. */
+#define DCU_SD_BENCH_APPEND_FILE "bench_ap.bin"
+#define DCU_SD_BENCH_APPEND_BYTES (256UL * 1024UL)
+#define DCU_SD_BENCH_FLUSH_BYTES 4096UL
+#define DCU_SD_BENCH_SYNC_EVERY 8U
 
 extern osMessageQueueId_t sdRequestQueueHandle;
 
 static bool s_mounted = false;
 
+/* Log session state — touched only by sdTask. */
+static FIL s_log_fp;
+static bool s_log_open = false;
+static uint32_t s_log_last_sync_ms = 0;
+
 const char *DCU_SD_FresultString(FRESULT result)
 {
   switch (result)
@@ -89,8 +100,12 @@ static FRESULT sd_op_mount(void)
   return r;
 }
 
+static FRESULT sd_op_log_close(void);
+
 static FRESULT sd_op_unmount(void)
 {
+  /* An open session would hold a FIL on the volume being torn down. */
+  (void)sd_op_log_close();
   FRESULT r = f_mount(NULL, USERPath, 1);
   s_mounted = false;
   return r;
@@ -191,6 +206,72 @@ static FRESULT sd_op_write(const char *path, const uint8_t *buf, uint32_t len, b
   return r;
 }
 
+/* Log session ----------------------------------------------------------- */
+
+static FRESULT sd_op_log_open(const char *path, uint32_t prealloc_bytes)
+{
+  if (s_log_open)
+    return FR_LOCKED;
+  if (!s_mounted)
+  {
+    FRESULT r = sd_op_mount();
+    if (r != FR_OK)
+      return r;
+  }
+  FRESULT r = f_open(&s_log_fp, path, FA_CREATE_ALWAYS | FA_WRITE);
+  if (r != FR_OK)
+    return r;
+
+  if (prealloc_bytes > 0U)
+  {
+#if _USE_EXPAND
+    /* opt=0: find and reserve a contiguous cluster run without growing the
+     * file, so f_size stays the bytes actually written and a power cut
+     * leaves no garbage tail. Falls back to normal allocation on failure. */
+    FRESULT e = f_expand(&s_log_fp, (FSIZE_t)prealloc_bytes, 0);
+    if (e != FR_OK)
+      LOG_W(TAG_SD, "f_expand(%lu) on %s: %s (continuing unreserved)", (unsigned long)prealloc_bytes, path,
+            DCU_SD_FresultString(e));
+#else
+    LOG_W(TAG_SD, "_USE_EXPAND=0 in ffconf.h; %s not pre-allocated", path);
+#endif
+  }
+
+  s_log_open = true;
+  s_log_last_sync_ms = HAL_GetTick();
+  return FR_OK;
+}
+
+static FRESULT sd_op_log_sync(void)
+{
+  if (!s_log_open)
+    return FR_INVALID_OBJECT;
+  s_log_last_sync_ms = HAL_GetTick();
+  return f_sync(&s_log_fp);
+}
+
+static FRESULT sd_op_log_write(const uint8_t *buf, uint32_t len)
+{
+  if (!s_log_open)
+    return FR_INVALID_OBJECT;
+  UINT n = 0;
+  FRESULT r = f_write(&s_log_fp, buf, (UINT)len, &n);
+  if (r == FR_OK && n != len)
+    r = FR_DISK_ERR; /* volume full */
+  if (r == FR_OK && (HAL_GetTick() - s_log_last_sync_ms) >= DCU_SD_LOG_SYNC_INTERVAL_MS)
+    r = sd_op_log_sync();
+  return r;
+}
+
+static FRESULT sd_op_log_close(void)
+{
+  if (!s_log_open)
+    return FR_OK;
+  FRESULT r = f_close(&s_log_fp);
+  s_log_open = false;
+  return r;
+}
+
 static FRESULT sd_op_delete(const char *path)
 {
   if (!s_mounted)
@@ -249,6 +330,90 @@ static FRESULT sd_op_smoke(void)
   return sd_op_unmount();
 }
 
+/* One logger-sized flush: DCU_SD_BENCH_FLUSH_BYTES in sector-sized writes. */
+static FRESULT bench_write_flush(FIL *fp, const uint8_t *chunk)
+{
+  for (uint32_t off = 0; off < DCU_SD_BENCH_FLUSH_BYTES; off += DCU_SD_SECTOR_BYTES)
+  {
+    UINT got = 0;
+    FRESULT r = f_write(fp, chunk, DCU_SD_SECTOR_BYTES, &got);
+    if (r != FR_OK)
+      return r;
+    if (got != DCU_SD_SECTOR_BYTES)
+      return FR_DISK_ERR;
+  }
+  return FR_OK;
+}
+
+static void bench_report(const char *label, uint32_t bytes, uint32_t ms, uint32_t worst_ms)
+{
+  if (ms == 0U)
+    ms = 1U;
+  FEB_Console_Printf("%s %lu bytes in %lu ms (%lu KB/s, worst flush %lu ms)\r\n", label, (unsigned long)bytes,
+                     (unsigned long)ms, (unsigned long)(bytes / ms), (unsigned long)worst_ms);
+}
+
+/* Sustained append, both strategies, same bytes and flush size. */
+static FRESULT sd_op_bench_append(const uint8_t *chunk)
+{
+  FIL fp;
+  FRESULT r = FR_OK;
+  uint32_t worst = 0;
+
+  /* A: open(FA_OPEN_APPEND) / write / close per flush — DCU_SD_Append. */
+  (void)f_unlink(DCU_SD_BENCH_APPEND_FILE);
+  uint32_t t0 = HAL_GetTick();
+  uint32_t total = 0;
+  while (total < DCU_SD_BENCH_APPEND_BYTES && r == FR_OK)
+  {
+    const uint32_t f0 = HAL_GetTick();
+    r = f_open(&fp, DCU_SD_BENCH_APPEND_FILE, FA_OPEN_APPEND | FA_WRITE);
+    if (r != FR_OK)
+      break;
+    r = bench_write_flush(&fp, chunk);
+    FRESULT c = f_close(&fp);
+    if (r == FR_OK)
+      r = c;
+    const uint32_t dt = HAL_GetTick() - f0;
+    worst = (dt > worst) ? dt : worst;
+    total += DCU_SD_BENCH_FLUSH_BYTES;
+  }
+  if (r != FR_OK)
+    return r;
+  bench_report("Append (open/close):", total, HAL_GetTick() - t0, worst);
+
+  /* B: persistent handle, contiguous pre-allocation, periodic f_sync —
+   * the log session path. */
+  r = f_open(&fp, DCU_SD_BENCH_APPEND_FILE, FA_CREATE_ALWAYS | FA_WRITE);
+  if (r != FR_OK)
+    return r;
+#if _USE_EXPAND
+  (void)f_expand(&fp, (FSIZE_t)DCU_SD_BENCH_APPEND_BYTES, 0);
+#endif
+  worst = 0;
+  total = 0;
+  uint32_t flushes = 0;
+  t0 = HAL_GetTick();
+  while (total < DCU_SD_BENCH_APPEND_BYTES && r == FR_OK)
+  {
+    const uint32_t f0 = HAL_GetTick();
+    r = bench_write_flush(&fp, chunk);
+    if (r == FR_OK && (++flushes % DCU_SD_BENCH_SYNC_EVERY) == 0U)
+      r = f_sync(&fp);
+    const uint32_t dt = HAL_GetTick() - f0;
+    worst = (dt > worst) ? dt : worst;
+    total += DCU_SD_BENCH_FLUSH_BYTES;
+  }
+  FRESULT c = f_close(&fp);
+  if (r == FR_OK)
+    r = c;
+  if (r != FR_OK)
+    return r;
+  bench_report("Append (session):   ", total, HAL_GetTick() - t0, worst);
+
+  return f_unlink(DCU_SD_BENCH_APPEND_FILE);
+}
+
 static FRESULT sd_op_bench(void)
 {
   if (!s_mounted)
@@ -304,7 +469,8 @@ static FRESULT sd_op_bench(void)
                      (unsigned long)(written_total / w_ms));
   FEB_Console_Printf("Read  %lu bytes in %lu ms (%lu KB/s)\r\n", (unsigned long)read_total, (unsigned long)r_ms,
                      (unsigned long)(read_total / r_ms));
-  return FR_OK;
+
+  return sd_op_bench_append(chunk);
 }
 
 void StartSdTask(void *argument)
@@ -355,13 +521,30 @@ void StartSdTask(void *argument)
     case DCU_SD_OP_BENCH:
       r = sd_op_bench();
       break;
+    case DCU_SD_OP_LOG_OPEN:
+      r = sd_op_log_open(req->path, req->buffer_len);
+      break;
+    case DCU_SD_OP_LOG_WRITE:
+      r = sd_op_log_write(req->buffer, req->buffer_len);
+      break;
+    case DCU_SD_OP_LOG_SYNC:
+      r = sd_op_log_sync();
+      break;
+    case DCU_SD_OP_LOG_CLOSE:
+      r = sd_op_log_close();
+      break;
     default:
       break;
     }
 
     req->result = r;
-    if (req->caller)
-      osThreadFlagsSet(req->caller, DCU_SD_FLAG_DONE);
+    /* Read everything needed before publishing `complete`: a synchronous
+     * caller's request lives on its stack and may vanish right after. */
+    const osThreadId_t caller = req->caller;
+    const uint32_t done_flag = (req->done_flag != 0U) ? req->done_flag : DCU_SD_FLAG_DONE;
+    req->complete = true;
+    if (caller)
+      osThreadFlagsSet(caller, done_flag);
   }
 }
 
@@ -374,6 +557,8 @@ static FRESULT submit_and_wait(DCU_SD_Request_t *req, uint32_t timeout_ms)
 {
   req->result = FR_NOT_READY;
   req->caller = osThreadGetId();
+  req->done_flag = 0U;
+  req->complete = false;
 
   /* Clear any stale DONE flag bit before posting so we wait on a fresh signal. */
   (void)osThreadFlagsClear(DCU_SD_FLAG_DONE);
@@ -460,6 +645,59 @@ FRESULT DCU_SD_Delete(const char *path, uint32_t timeout_ms)
   return submit_and_wait(&req, timeout_ms);
 }
 
+FRESULT DCU_SD_LogOpen(const char *path, uint32_t prealloc_bytes, uint32_t timeout_ms)
+{
+  DCU_SD_Request_t req = {
+      .op = DCU_SD_OP_LOG_OPEN,
+      .path = path,
+      .buffer_len = prealloc_bytes,
+  };
+  return submit_and_wait(&req, timeout_ms);
+}
+
+FRESULT DCU_SD_LogWrite(const uint8_t *data, uint32_t len, uint32_t timeout_ms)
+{
+  DCU_SD_Request_t req = {
+      .op = DCU_SD_OP_LOG_WRITE,
+      .buffer = (uint8_t *)data,
+      .buffer_len = len,
+  };
+  return submit_and_wait(&req, timeout_ms);
+}
+
+FRESULT DCU_SD_LogWriteAsync(DCU_SD_Request_t *req, const uint8_t *data, uint32_t len, uint32_t done_flag,
+                             uint32_t timeout_ms)
+{
+  req->op = DCU_SD_OP_LOG_WRITE;
+  req->path = NULL;
+  req->buffer = (uint8_t *)data;
+  req->buffer_len = len;
+  req->result = FR_NOT_READY;
+  req->caller = osThreadGetId();
+  req->done_flag = done_flag;
+  req->complete = false;
+
+  if (osMessageQueuePut(sdRequestQueueHandle, &req, 0U, timeout_ms) != osOK)
+  {
+    req->complete = true;
+    req->result = FR_TIMEOUT;
+    return FR_TIMEOUT;
+  }
+  return FR_OK;
+}
+
+FRESULT DCU_SD_LogSync(uint32_t timeout_ms)
+{
+  DCU_SD_Request_t req = {.op = DCU_SD_OP_LOG_SYNC};
+  return submit_and_wait(&req, timeout_ms);
+}
+
+FRESULT DCU_SD_LogClose(uint32_t timeout_ms)
+{
+  DCU_SD_Request_t req = {.op = DCU_SD_OP_LOG_CLOSE};
+  return submit_and_wait(&req, timeout_ms);
+}
+
 void DCU_SD_RunSmokeTest(void)
 {
   DCU_SD_Request_t req = {.op = DCU_SD_OP_SMOKE_TEST};
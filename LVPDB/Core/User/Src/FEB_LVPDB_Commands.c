@@ -109,6 +109,18 @@ static const RegInfo_t *get_register_info(const char *name)
  * I2C Helper Functions (for direct register access in debug commands)
  * ============================================================================ */
 
+/**
+ * Let an in-flight background TPS batch (started from FEB_Main_Loop) finish so
+ * the raw HAL calls below don't collide with it and fail with HAL_BUSY.
+ */
+static void tps_wait_batch_idle(void)
+{
+  uint32_t start = HAL_GetTick();
+  while (FEB_TPS_BatchIsBusy() && (uint32_t)(HAL_GetTick() - start) < 100U)
+  {
+  }
+}
+
 /**
  * Read a 16-bit TPS2482 register over I2C and store its MSB-first value.
  *
@@ -122,6 +134,7 @@ static const RegInfo_t *get_register_info(const char *name)
  */
 static HAL_StatusTypeDef tps_read_reg(uint8_t i2c_addr, uint8_t reg, uint16_t *value)
 {
+  tps_wait_batch_idle();
   uint8_t buf[2];
   HAL_StatusTypeDef status =
       HAL_I2C_Mem_Read(&hi2c1, (uint16_t)(i2c_addr << 1), reg, I2C_MEMADD_SIZE_8BIT, buf, 2, 100);
@@ -141,6 +154,7 @@ static HAL_StatusTypeDef tps_read_reg(uint8_t i2c_addr, uint8_t reg, uint16_t *v
  */
 static HAL_StatusTypeDef tps_write_reg(uint8_t i2c_addr, uint8_t reg, uint16_t value)
 {
+  tps_wait_batch_idle();
   uint8_t buf[2];
   buf[0] = (uint8_t)(value >> 8); // MSB first
   buf[1] = (uint8_t)(value & 0xFF);
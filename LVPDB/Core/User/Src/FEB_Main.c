@@ -25,6 +25,7 @@ static uint8_t uart_tx_buf[4096];
 static uint8_t uart_rx_buf[256];
 
 static void FEB_Variable_Conversion(void);
+static int lvpdb_heartbeat_pack(uint8_t *dst, const void *src, size_t size);
 
 /* ============================================================================
  * TPS Device Handles and Data
@@ -321,6 +322,21 @@ void FEB_Main_Setup(void)
   };
   FEB_CAN_Init(&can_cfg);
 
+  // Heartbeat as a 100 ms periodic slot; FEB_1ms_Callback services the schedule
+  FEB_CAN_TX_Params_t heartbeat_params = {
+      .instance = FEB_CAN_INSTANCE_1,
+      .can_id = FEB_CAN_LVPDB_HEARTBEAT_FRAME_ID,
+      .id_type = FEB_CAN_ID_STD,
+      .data_ptr = &lvpdb_heartbeat_msg,
+      .data_size = sizeof(lvpdb_heartbeat_msg),
+      .period_ms = 100,
+      .pack_func = lvpdb_heartbeat_pack,
+  };
+  if (FEB_CAN_TX_Register(&heartbeat_params) < 0)
+  {
+    LOG_E(TAG_MAIN, "Heartbeat TX slot registration failed");
+  }
+
   // Initialize ping/pong module
   FEB_CAN_PingPong_Init();
   FEB_CAN_DASH_Init();
@@ -334,56 +350,69 @@ void FEB_Main_Setup(void)
 
 #define MAIN_LOOP_POLL_INTERVAL_MS 50
 static bool tps_polled_success[NUM_TPS2482];
+static uint8_t tps_batch_polled;
+
+/**
+ * Batch result for one TPS. Runs from FEB_TPS_BatchProcess() in the main loop;
+ * maps the handle back to its rail index so per-rail LSBs in
+ * FEB_Variable_Conversion stay correct.
+ */
+static void tps_batch_callback(FEB_TPS_Handle_t handle, FEB_TPS_Status_t status, const FEB_TPS_Measurement_t *m,
+                               void *ctx)
+{
+  (void)ctx;
+  for (uint8_t i = 0; i < NUM_TPS2482; i++)
+  {
+    if (tps_handles[i] != handle)
+    {
+      continue;
+    }
+    if (status == FEB_TPS_OK)
+    {
+      tps2482_bus_voltage_raw[i] = m->bus_voltage_raw;
+      tps2482_current_raw[i] = m->current_raw;
+      tps2482_shunt_voltage_raw[i] = m->shunt_voltage_raw;
+      tps_polled_success[i] = true;
+      tps_batch_polled++;
+    }
+    else
+    {
+      tps2482_bus_voltage_raw[i] = 0;
+      tps2482_current_raw[i] = 0;
+      tps2482_shunt_voltage_raw[i] = 0;
+      tps_polled_success[i] = false;
+    }
+    return;
+  }
+}
 
 /**
- * Main periodic loop. Polls each TPS via its own handle (position-aligned with
- * tps_device_configs[] so per-rail LSBs in FEB_Variable_Conversion stay correct),
- * runs the conversion, and processes any UART input.
+ * Main periodic loop. Kicks off a background TPS batch read every
+ * MAIN_LOOP_POLL_INTERVAL_MS (advanced from the I2C interrupt), runs the
+ * conversion when a batch lands, and processes any UART input.
  */
 void FEB_Main_Loop(void)
 {
   static uint32_t last_poll_tick = 0;
   uint32_t now = HAL_GetTick();
 
-  if (tps_init_success && (uint32_t)(now - last_poll_tick) >= MAIN_LOOP_POLL_INTERVAL_MS)
+  if (FEB_TPS_BatchProcess())
   {
-    last_poll_tick = now;
-
-    uint8_t polled = 0;
-    for (uint8_t i = 0; i < NUM_TPS2482; i++)
+    if (tps_batch_polled < tps_registered_count)
     {
-      if (tps_handles[i] == NULL)
-      {
-        tps2482_bus_voltage_raw[i] = 0;
-        tps2482_current_raw[i] = 0;
-        tps2482_shunt_voltage_raw[i] = 0;
-        continue;
-      }
-      uint16_t bv;
-      int16_t cur;
-      int16_t sv;
-      if (FEB_TPS_PollRaw(tps_handles[i], &bv, &cur, &sv) == FEB_TPS_OK)
-      {
-        tps2482_bus_voltage_raw[i] = bv;
-        tps2482_current_raw[i] = cur;
-        tps2482_shunt_voltage_raw[i] = sv;
-        tps_polled_success[i] = true;
-        polled++;
-      }
-      else
-      {
-        tps2482_bus_voltage_raw[i] = 0;
-        tps2482_current_raw[i] = 0;
-        tps2482_shunt_voltage_raw[i] = 0;
-        tps_polled_success[i] = false;
-      }
+      LOG_W(TAG_MAIN, "TPS poll: %u/%u registered devices succeeded", (unsigned)tps_batch_polled,
+            (unsigned)tps_registered_count);
     }
-    if (polled < tps_registered_count)
+    FEB_Variable_Conversion();
+  }
+
+  if (tps_init_success && (uint32_t)(now - last_poll_tick) >= MAIN_LOOP_POLL_INTERVAL_MS)
+  {
+    tps_batch_polled = 0;
+    if (FEB_TPS_BatchStart(tps_batch_callback, NULL) == FEB_TPS_OK)
     {
-      LOG_W(TAG_MAIN, "TPS poll: %u/%u registered devices succeeded", (unsigned)polled, (unsigned)tps_registered_count);
+      last_poll_tick = now;
     }
-
-    FEB_Variable_Conversion();
   }
 
   if (FEB_CAN_DASH_IsDataFresh(250))
@@ -409,6 +438,7 @@ void FEB_Main_Loop(void)
  * Called from the 1 kHz timer interrupt; maintains internal 1 ms counters and, every 100 ms,
  * invokes the CAN ping/pong maintenance tick and the CAN TPS polling tick using the
  * tps2482_current_raw and tps2482_bus_voltage_raw arrays for all devices (NUM_TPS2482).
+ * The heartbeat is a periodic CAN TX slot serviced here on every tick.
  */
 void FEB_1ms_Callback(void)
 {
@@ -434,40 +464,40 @@ void FEB_1ms_Callback(void)
     }
   }
 
-  static uint16_t heartbeat_divider = 0;
-  heartbeat_divider++;
-  if (heartbeat_divider >=
-      67) // not 100ms to offset message from other two statuses (ran into issue where mailbox got full)
-  {
-    heartbeat_divider = 0;
-
-    lvpdb_heartbeat_msg.tps_init_failed = !tps_init_success;
-
-    lvpdb_heartbeat_msg.tps_lv_poll_failed = !tps_polled_success[0];
-    lvpdb_heartbeat_msg.tps_sh_poll_failed = !tps_polled_success[1];
-    lvpdb_heartbeat_msg.tps_lt_poll_failed = !tps_polled_success[2];
-    lvpdb_heartbeat_msg.tps_bm_l_poll_failed = !tps_polled_success[3];
-    lvpdb_heartbeat_msg.tps_sm_poll_failed = !tps_polled_success[4];
-    lvpdb_heartbeat_msg.tps_af1_af2_poll_failed = !tps_polled_success[5];
-    lvpdb_heartbeat_msg.tps_cp_rf_poll_failed = !tps_polled_success[6];
-
-    lvpdb_heartbeat_msg.tps_lv_power_not_good = !tps_power_good[0];
-    lvpdb_heartbeat_msg.tps_sh_power_not_good = !tps_power_good[1];
-    lvpdb_heartbeat_msg.tps_lt_power_not_good = !tps_power_good[2];
-    lvpdb_heartbeat_msg.tps_bm_l_power_not_good = !tps_power_good[3];
-    lvpdb_heartbeat_msg.tps_sm_power_not_good = !tps_power_good[4];
-    lvpdb_heartbeat_msg.tps_af1_af2_power_not_good = !tps_power_good[5];
-    lvpdb_heartbeat_msg.tps_cp_rf_power_not_good = !tps_power_good[6];
-
-    lvpdb_heartbeat_msg.dash_state_stale = !FEB_CAN_DASH_IsDataFresh(250);
-
-    uint8_t tx_data[FEB_CAN_LVPDB_HEARTBEAT_LENGTH];
-    memset(tx_data, 0x00, sizeof(tx_data));
-    feb_can_lvpdb_heartbeat_pack(tx_data, &lvpdb_heartbeat_msg, sizeof(tx_data));
-
-    FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_LVPDB_HEARTBEAT_FRAME_ID, FEB_CAN_ID_STD, tx_data,
-                    FEB_CAN_LVPDB_HEARTBEAT_LENGTH);
-  }
+  // Heartbeat and any other periodic TX slots
+  FEB_CAN_TX_ProcessPeriodic();
+}
+
+/**
+ * Heartbeat slot pack function: refreshes the status flags, then packs the
+ * frame. Runs from FEB_CAN_TX_ProcessPeriodic in the 1 kHz tick.
+ */
+static int lvpdb_heartbeat_pack(uint8_t *dst, const void *src, size_t size)
+{
+  (void)src;
+
+  lvpdb_heartbeat_msg.tps_init_failed = !tps_init_success;
+
+  lvpdb_heartbeat_msg.tps_lv_poll_failed = !tps_polled_success[0];
+  lvpdb_heartbeat_msg.tps_sh_poll_failed = !tps_polled_success[1];
+  lvpdb_heartbeat_msg.tps_lt_poll_failed = !tps_polled_success[2];
+  lvpdb_heartbeat_msg.tps_bm_l_poll_failed = !tps_polled_success[3];
+  lvpdb_heartbeat_msg.tps_sm_poll_failed = !tps_polled_success[4];
+  lvpdb_heartbeat_msg.tps_af1_af2_poll_failed = !tps_polled_success[5];
+  lvpdb_heartbeat_msg.tps_cp_rf_poll_failed = !tps_polled_success[6];
+
+  lvpdb_heartbeat_msg.tps_lv_power_not_good = !tps_power_good[0];
+  lvpdb_heartbeat_msg.tps_sh_power_not_good = !tps_power_good[1];
+  lvpdb_heartbeat_msg.tps_lt_power_not_good = !tps_power_good[2];
+  lvpdb_heartbeat_msg.tps_bm_l_power_not_good = !tps_power_good[3];
+  lvpdb_heartbeat_msg.tps_sm_power_not_good = !tps_power_good[4];
+  lvpdb_heartbeat_msg.tps_af1_af2_power_not_good = !tps_power_good[5];
+  lvpdb_heartbeat_msg.tps_cp_rf_power_not_good = !tps_power_good[6];
+
+  lvpdb_heartbeat_msg.dash_state_stale = !FEB_CAN_DASH_IsDataFresh(250);
+
+  memset(dst, 0x00, size);
+  return feb_can_lvpdb_heartbeat_pack(dst, &lvpdb_heartbeat_msg, size);
 }
 
 /* ============================================================================
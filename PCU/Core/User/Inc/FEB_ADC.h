@@ -147,7 +147,8 @@ extern "C"
    * @brief Time-coherent ADC snapshot — one instant across all three ADCs.
    *
    * Built once per 1ms control tick by FEB_ADC_TickSample() from the most-recent
-   * TIM2-triggered samples (boxcar-averaged per channel). Because every ADC is
+   * TIM2-triggered samples (boxcar-averaged per channel by FEB_ADC_Stream as each
+   * DMA half-buffer completes). Because every ADC is
    * launched by the same TIM2 TRGO edge, all fields here represent the same
    * sampling instant: APPS1/APPS2, brake1/brake2 and APPS-vs-brake are mutually
    * coherent, so plausibility deviation reflects real sensor disagreement only.
@@ -157,6 +158,8 @@ extern "C"
   typedef struct
   {
     uint32_t tick_ms;         /* HAL_GetTick() when this snapshot was latched */
+    uint32_t sample_us;       /* FEB_Time_Us32() when the APPS (ADC3) half-buffer was consumed */
+    uint32_t latch_us;        /* FEB_Time_Us32() when this snapshot was latched */
     uint16_t apps1_raw;       /* ADC3 ch13 (PC3) */
     uint16_t apps2_raw;       /* ADC3 ch12 (PC2) */
     uint16_t brake1_raw;      /* ADC1 ch1  (PA1) */
@@ -544,7 +547,7 @@ extern "C"
 
   /**
    * @brief  Update the APPS boxcar-averaging config. samples (the boxcar
-   *         window) is clamped to [1, ADC_DMA_BUFFER_SIZE].
+   *         window) is clamped to [1, ADC_STREAM_MAX_WINDOW].
    */
   ADC_StatusTypeDef FEB_ADC_SetAPPSFilter(bool enabled, uint8_t samples);
 
@@ -0,0 +1,86 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_ADC_Stream.h
+ * @brief          : Streaming moving-sum (boxcar) stage for the ADC DMA stream
+ ******************************************************************************
+ * One ADC_StreamChannel_t per ADC channel. The DMA half/full-transfer callbacks
+ * feed each completed half-buffer through FEB_ADC_Stream_Push(), which keeps a
+ * running sum over the newest `window` samples at a fixed cost per sample, so
+ * reading the boxcar mean is O(1) regardless of the window.
+ *
+ * No HAL dependency: also built on the host by PCU/Host/pcu_adc_bench.c.
+ */
+
+#ifndef INC_FEB_ADC_STREAM_H_
+#define INC_FEB_ADC_STREAM_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+/* ========================================================================== */
+/*                              CONFIGURATION                                 */
+/* ========================================================================== */
+
+/* Longest boxcar window (samples). Power of two: the history ring index wraps
+ * with a mask. 64 samples = 6.4 ms at ADC_OVERSAMPLE_HZ. */
+#define ADC_STREAM_MAX_WINDOW 64U
+#define ADC_STREAM_RING_MASK (ADC_STREAM_MAX_WINDOW - 1U)
+
+  /* ========================================================================== */
+  /*                                  TYPES                                     */
+  /* ========================================================================== */
+
+  /**
+   * @brief Running boxcar over one channel's sample stream
+   *
+   * ring holds the newest ADC_STREAM_MAX_WINDOW samples whatever the window,
+   * so the window can change without waiting for the ring to refill.
+   */
+  typedef struct
+  {
+    uint16_t ring[ADC_STREAM_MAX_WINDOW]; /* Sample history, oldest overwritten */
+    uint32_t sum;                         /* Sum of the newest `window` samples */
+    uint8_t head;                         /* Next ring slot to write */
+    uint8_t window;                       /* Samples in sum, 1..ADC_STREAM_MAX_WINDOW */
+  } ADC_StreamChannel_t;
+
+  /* ========================================================================== */
+  /*                          FUNCTION PROTOTYPES                               */
+  /* ========================================================================== */
+
+  /**
+   * @brief  Clear the history and set the window (clamped to [1, ADC_STREAM_MAX_WINDOW])
+   */
+  void FEB_ADC_Stream_Reset(ADC_StreamChannel_t *ch, uint8_t window);
+
+  /**
+   * @brief  Change the window, re-summing the newest samples already in the ring.
+   *         O(window); a no-op when the window is unchanged.
+   */
+  void FEB_ADC_Stream_SetWindow(ADC_StreamChannel_t *ch, uint8_t window);
+
+  /**
+   * @brief  Append one channel of an interleaved DMA block to the stream
+   * @param  block: first sample of this channel in the block
+   * @param  stride: channels per scan (distance between consecutive samples)
+   * @param  scans: samples to append
+   */
+  void FEB_ADC_Stream_Push(ADC_StreamChannel_t *ch, const uint16_t *block, uint32_t stride, uint32_t scans);
+
+  /**
+   * @brief  Boxcar mean of the newest `window` samples
+   */
+  static inline uint16_t FEB_ADC_Stream_Mean(const ADC_StreamChannel_t *ch)
+  {
+    return (uint16_t)(ch->sum / ch->window);
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_FEB_ADC_STREAM_H_ */
@@ -3,6 +3,7 @@
 
 #include "stm32f4xx_hal.h"
 
+#include "feb_can_ext_frames.h"
 #include "feb_can_lib.h"
 #include "feb_can.h"
 
@@ -47,6 +48,11 @@ typedef struct BMS_MESSAGE_TYPE
   volatile float max_temperature;      // Max accumulator temperature in C
   volatile float accumulator_voltage;  // Accumulator voltage in V
   volatile uint32_t last_rx_timestamp; // 0 = never received, else HAL_GetTick() when last RX
+  volatile float soc;                  // 0..1, from the SOC frame
+  volatile float pack_resistance_ohm;  // BMS R_pack estimate
+  volatile float pack_ocv;             // Open-circuit pack voltage in V
+  volatile uint8_t soc_flags;          // FEB_CAN_EXT_BMS_SOC_FLAG_*
+  volatile uint32_t soc_rx_timestamp;  // 0 = never received, else HAL_GetTick() when last RX
 } BMS_MESSAGE_TYPE;
 
 // Global variable - defined in FEB_CAN_BMS.c
@@ -58,6 +64,10 @@ uint8_t FEB_CAN_BMS_getDeviceSelect(void);
 FEB_SM_ST_t FEB_CAN_BMS_getState(void);
 float FEB_CAN_BMS_getAccumulatorVoltage(void);
 float FEB_CAN_BMS_getMaxTemperature(void);
+float FEB_CAN_BMS_getSOC(void);
+float FEB_CAN_BMS_getPackResistance(void);
+bool FEB_CAN_BMS_IsSOCFresh(void);
+bool FEB_CAN_BMS_IsPackResistanceFresh(void);
 void FEB_CAN_BMS_Init(void);
 void FEB_CAN_HEARTBEAT_Transmit(void);
 void FEB_CAN_BMS_ProcessHeartbeat(void);
@@ -5,8 +5,10 @@
 #include "feb_can.h"
 #include "feb_can_lib.h"
 
-void FEB_CAN_Diagnostics_TransmitBrakeData(void);
-void FEB_CAN_Diagnostics_TransmitAPPSData(void);
-void FEB_CAN_Diagnostics_TransmitPedalVoltages(void);
+/**
+ * Register the brake, APPS and pedal-voltage telemetry as periodic CAN TX
+ * slots. Call once after FEB_CAN_Init; FEB_CAN_TX_ProcessPeriodic sends them.
+ */
+void FEB_CAN_Diagnostics_Init(void);
 
 #endif /* INC_FEB_CAN_DIAGNOSTICS_H_ */
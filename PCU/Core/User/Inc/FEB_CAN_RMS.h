@@ -148,15 +148,33 @@ typedef struct RMS_MESSAGE_TYPE
   volatile uint32_t fw_rx_timestamp;
 } RMS_MESSAGE_TYPE;
 
-// Global variable - defined in FEB_CAN_RMS.c
+/* Inverter feedback the control path decides on, read as one coherent set */
+typedef struct
+{
+  uint32_t last_rx_tick;   // 0 = no RMS frame yet, else HAL_GetTick() at the last one
+  float dc_bus_voltage_v;  // M167 DC bus voltage (V)
+  int16_t motor_speed_rpm; // M165 motor speed (RPM)
+} FEB_CAN_RMS_Feedback_t;
+
+// Global variable - defined in FEB_CAN_RMS_Decode.c. Written frame by frame in
+// the RX ISR; direct field reads may mix frames, which is fine for console
+// dumps. Control decisions use FEB_CAN_RMS_GetFeedback().
 extern RMS_MESSAGE_TYPE RMS_MESSAGE;
 
-// Raw per-ID capture table for every inverter broadcast frame - defined in FEB_CAN_RMS.c
+// Raw per-ID capture table for every inverter broadcast frame - defined in FEB_CAN_RMS_Decode.c
 extern RMS_Frame_Record_t RMS_FRAMES[FEB_CAN_RMS_FRAME_TABLE_SIZE];
 
 // Initialization and callback
 void FEB_CAN_RMS_Init(void);
 
+// Decode one received inverter frame into RMS_MESSAGE / RMS_FRAMES and publish
+// it (seqlock). Called from the RX ISR; the only writer of the decoded state.
+void FEB_CAN_RMS_Decode(uint32_t can_id, const uint8_t *data, uint8_t length, uint32_t tick);
+
+// Copy speed, DC bus voltage and last-RX tick from one point between frames
+// (seqlock reader; retries while a frame is being decoded).
+void FEB_CAN_RMS_GetFeedback(FEB_CAN_RMS_Feedback_t *out);
+
 // Transmit functions. M192 torque/enable is the only frame sent automatically.
 // M193 parameter writes are emitted ONLY from explicit console commands (never
 // at init): ClearFaults (param 20, transient) is always safe; PrechargeBypass
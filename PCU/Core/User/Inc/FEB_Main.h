@@ -15,12 +15,14 @@
 // PCU-specific includes
 #include "FEB_ADC.h"
 #include "FEB_RMS.h"
+#include "FEB_RMS_Config.h"
 #include "FEB_CAN_RMS.h"
 #include "FEB_CAN_BMS.h"
 #include "FEB_CAN_IVT.h"
 #include "FEB_CAN_Diagnostics.h"
 #include "FEB_CAN_TPS.h"
 #include "FEB_PCU_Commands.h"
+#include "FEB_Torque_Latency.h"
 
 /* Main loop functions */
 void FEB_Main_Setup(void);
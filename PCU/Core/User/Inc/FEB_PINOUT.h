@@ -90,7 +90,11 @@ extern "C"
 #define ADC_MAX_SAMPLING_TIME ADC_SAMPLETIME_480CYCLES
 
 /* DMA Buffer Sizes */
-#define ADC_DMA_BUFFER_SIZE 16  /* Circular buffer depth (samples per channel) */
+/* Circular buffer depth (samples per channel). The DMA half/full-transfer
+ * callbacks feed each half (ADC_DMA_BUFFER_SIZE/2 scans = 0.4 ms at
+ * ADC_OVERSAMPLE_HZ) to the streaming boxcar, so this sets how old the newest
+ * sample in a 1ms snapshot can be, not the longest filter window. */
+#define ADC_DMA_BUFFER_SIZE 8   /* Must be even */
 #define ADC_AVERAGING_SAMPLES 8 /* Number of samples for averaging */
 
 /* TIM2 hardware trigger rate for all three ADCs. Each TIM2 TRGO edge launches
@@ -108,11 +112,12 @@ extern "C"
 /* Boxcar (moving-average) window per sensor class. ADC samples are hardware-
  * triggered by TIM2 (ADC_OVERSAMPLE_HZ), so the most-recent N samples per
  * channel are time-coherent across all three ADCs; the per-1ms snapshot
- * (FEB_ADC_TickSample) averages the most-recent SAMPLES values. NO IIR / low-
+ * (FEB_ADC_TickSample) reads a running average of the most-recent SAMPLES
+ * values kept by FEB_ADC_Stream in the DMA callbacks. NO IIR / low-
  * pass filtering is used — a boxcar is symmetric, so both members of a sensor
  * pair (APPS1/2, brake1/2) share one window with identical group delay and
  * filtering can never manufacture an artificial inter-sensor deviation. SAMPLES
- * is clamped to [1, ADC_DMA_BUFFER_SIZE]; ENABLED=0 forces a single most-recent
+ * is clamped to [1, ADC_STREAM_MAX_WINDOW]; ENABLED=0 forces a single most-recent
  * sample. */
 #define FILTER_BRAKE_INPUT_ENABLED 1 /* Enable averaging for brake input */
 #define FILTER_BRAKE_INPUT_SAMPLES 8 /* Boxcar window (samples) */
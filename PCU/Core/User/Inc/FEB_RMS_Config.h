@@ -26,6 +26,17 @@ extern "C"
 /*                           MOTOR CONFIGURATION                              */
 /* ========================================================================== */
 
+/**
+ * @brief Torque command (M192) period in 1 ms ticks
+ * @note 5 = 200 Hz. M192 goes out on the CAN priority lane with a reserved
+ *       mailbox, so its queueing delay does not grow with the rate; bus load
+ *       does (one 8-byte frame is ~270 us at 500 kbit/s, so 1 ms costs ~27%
+ *       of the bus). See PCU/Host/pcu_can_lane_bench.
+ */
+#ifndef FEB_RMS_TORQUE_PERIOD_MS
+#define FEB_RMS_TORQUE_PERIOD_MS 5
+#endif
+
 /**
  * @brief Maximum motor torque in tenths of Nm
  * @note RMS PM100DX typical max: 220 Nm = 2200 in tenths
@@ -78,6 +89,17 @@ extern "C"
  */
 #define INIT_VOLTAGE 5100 /* 510.0V in decivolts */
 
+/* ========================================================================== */
+/*                           REGEN CONFIGURATION                              */
+/* ========================================================================== */
+
+/**
+ * @brief Regen torque cap (Nm) and charging current limit (A)
+ * @note Electrical regen limit: min(MAX_TORQUE_REGEN, V_bus * PEAK_CURRENT_REGEN / omega)
+ */
+#define MAX_TORQUE_REGEN 230.0f  /* Maximum regen torque (Nm) */
+#define PEAK_CURRENT_REGEN 20.0f /* 20A charging limit */
+
 /* ========================================================================== */
 /*                         CONVERSION FACTORS                                 */
 /* ========================================================================== */
@@ -105,12 +127,30 @@ extern "C"
  */
 #define MIN_PACK_VOLTAGE_V 400.0f
 
+/**
+ * @brief End of the peak current derating ramp
+ * @note At or below DERATE_FLOOR_VOLTAGE_V the peak current is held at
+ *       PEAK_CURRENT_FLOOR_A (16.7% of PEAK_CURRENT)
+ */
+#define DERATE_FLOOR_VOLTAGE_V 410.0f
+#define PEAK_CURRENT_FLOOR_A 10.0f
+
 /**
  * @brief Assumed accumulator internal resistance (ohms)
- * @note Used for voltage drop estimation under load
+ * @note Used for voltage drop estimation under load while the BMS R_pack
+ *       estimate is unavailable or not yet converged
  */
 #define ACCUMULATOR_RESISTANCE_OHM 1.0f
 
+/**
+ * @brief Bounds applied to the BMS R_pack estimate (ohms)
+ * @note The derating ramp starts at MIN_PACK_VOLTAGE_V + PEAK_CURRENT * R and
+ *       ends at DERATE_FLOOR_VOLTAGE_V. The lower bound puts the start at
+ *       400 + 60 * 0.42 = 425.2 V, so the ramp is at least 15 V wide.
+ */
+#define ACCUMULATOR_RESISTANCE_MIN_OHM 0.42f
+#define ACCUMULATOR_RESISTANCE_MAX_OHM 2.0f
+
 /**
  * @brief Brake position threshold for torque cutoff (%)
  * @note If brake position exceeds this, acceleration is cut
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_RMS_Limits.h
+ * @brief          : Fixed-point drive and regen torque limits
+ ******************************************************************************
+ * Integer form of the torque limits in FEB_RMS_GetMaxTorque() and
+ * FEB_Regen_GetElecMaxRegenTorque(). The constants in FEB_RMS_Config.h are
+ * folded into integer coefficients at compile time; the voltage derating slope
+ * is cached per R_pack, so a call costs one divide by the motor speed (plus
+ * one more while the IVT reports overcurrent).
+ *
+ * Units: current in mA, voltage in cV, torque out in hundredths of the float
+ * path's units. Every rounding step rounds toward less torque.
+ *
+ * No HAL dependency: also built on the host by PCU/Host/pcu_limits_bench.c.
+ */
+
+#ifndef INC_FEB_RMS_LIMITS_H_
+#define INC_FEB_RMS_LIMITS_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ========================================================================== */
+/*                              CONFIGURATION                                 */
+/* ========================================================================== */
+
+/* Voltages are clamped to [0, RMS_LIMITS_MAX_CV] before use, which keeps the
+ * power term within the 32-bit divide. 650 V is above a full 140S pack. */
+#define RMS_LIMITS_MAX_CV 65000U
+
+/* Drive limit flags, for the caller's rate-limited warnings */
+#define RMS_LIMITS_FLAG_NO_VOLTAGE 0x01U     /* No IVT or RMS voltage yet: current not derated */
+#define RMS_LIMITS_FLAG_CURRENT_FLOOR 0x02U  /* Pack at/below DERATE_FLOOR_VOLTAGE_V */
+#define RMS_LIMITS_FLAG_LOW_PACK 0x04U       /* IVT below LOW_PACK_VOLTAGE_V: MAX_TORQUE_LOW_V */
+#define RMS_LIMITS_FLAG_IVT_OVERCURRENT 0x08U /* IVT current above IVT_CURRENT_LIMIT_A */
+
+  /* ========================================================================== */
+  /*                                  TYPES                                     */
+  /* ========================================================================== */
+
+  /**
+   * @brief Inputs to the drive limit, sampled once per torque tick
+   */
+  typedef struct
+  {
+    bool ivt_fresh;          /* IVT voltage/current below are valid */
+    float ivt_voltage_v;     /* IVT pack voltage */
+    float ivt_current_a;     /* IVT pack current (sign ignored) */
+    bool rms_seen;           /* An RMS frame has arrived: rms_dc_bus_v is valid */
+    float rms_dc_bus_v;      /* M167 DC bus voltage, fallback for the derating */
+    bool r_pack_fresh;       /* BMS R_pack estimate has converged and is fresh */
+    float r_pack_ohm;        /* BMS R_pack estimate (clamped here) */
+    int16_t motor_speed_rpm; /* M165 motor speed */
+  } FEB_RMS_Limits_Input_t;
+
+  /**
+   * @brief Drive limit result
+   */
+  typedef struct
+  {
+    int32_t max_torque_c;     /* Hundredths of the FEB_RMS_GetMaxTorque() return value */
+    uint32_t peak_current_ma; /* Derated peak current, mA (PEAK_CURRENT_FLOOR_A..PEAK_CURRENT) */
+    uint8_t flags;            /* RMS_LIMITS_FLAG_* */
+  } FEB_RMS_Limits_Drive_t;
+
+  /* ========================================================================== */
+  /*                          FUNCTION PROTOTYPES                               */
+  /* ========================================================================== */
+
+  /**
+   * @brief  Drive torque limit: voltage-derated peak current times pack voltage
+   *         over motor speed, capped at MAX_TORQUE (MAX_TORQUE_LOW_V on a low
+   *         IVT voltage) and scaled down on IVT overcurrent
+   * @note   Keeps the float path's unit mix: the cap is in tenths of Nm while
+   *         the power term comes out in Nm.
+   */
+  void FEB_RMS_Limits_Drive(const FEB_RMS_Limits_Input_t *in, FEB_RMS_Limits_Drive_t *out);
+
+  /**
+   * @brief  Electrical regen limit: min(MAX_TORQUE_REGEN, V * PEAK_CURRENT_REGEN / omega)
+   *         with V the DC bus voltage capped at INIT_VOLTAGE; 0 below 1 rad/s
+   * @return Hundredths of Nm, >= 0
+   */
+  int32_t FEB_RMS_Limits_Regen(float dc_bus_v, int16_t motor_speed_rpm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_FEB_RMS_LIMITS_H_ */
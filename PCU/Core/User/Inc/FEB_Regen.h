@@ -26,16 +26,16 @@ extern "C"
 /*                          REGEN CONSTANTS (SN3)                            */
 /* ========================================================================== */
 
-/* Torque and Current Limits */
-#define MAX_TORQUE_REGEN 230.0f  /* Maximum regen torque (Nm) */
-#define PEAK_CURRENT_REGEN 20.0f /* 20A charging limit */
+/* Torque and current limits (MAX_TORQUE_REGEN, PEAK_CURRENT_REGEN) live in
+ * FEB_RMS_Config.h, shared with the fixed-point limits in FEB_RMS_Limits.c */
 
 /* Speed Filter */
 #define FADE_SPEED_RPM 200 /* No regen below this speed */
 
 /* SOC Filter - Linear interpolation */
-#define START_REGEN_SOC 0.95f /* Start reducing regen at 95% SOC */
-#define MAX_REGEN_SOC 0.80f   /* Full regen available at/below 80% SOC */
+#define START_REGEN_SOC 0.95f    /* Start reducing regen at 95% SOC */
+#define MAX_REGEN_SOC 0.80f      /* Full regen available at/below 80% SOC */
+#define REGEN_FALLBACK_SOC 0.85f /* Assumed SOC while the BMS SOC frame is stale */
 
 /* Temperature Filter - Exponential decay */
 #define MAX_CELL_TEMP 45           /* Vertical asymptote at 45°C */
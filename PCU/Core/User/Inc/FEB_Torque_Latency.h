@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_Torque_Latency.h
+ * @brief          : Pedal-to-inverter latency and jitter of the torque command
+ ******************************************************************************
+ * Every M192 torque command is traced from the APPS samples it was computed
+ * from to the moment it left the CAN mailbox:
+ *
+ *   sample   APPS (ADC3) DMA half-buffer consumed -> 1 ms tick latched it
+ *   compute  latch -> frame handed to FEB_CAN_TX_Send
+ *   wire     handed to CAN -> transmit complete (mailbox empty, frame ACKed)
+ *   total    sample -> transmit complete
+ *   jitter   |total - total of the previous frame|
+ *
+ * The transmit side is matched on the frame's 4-bit rolling counter through
+ * the CAN library's TX-complete hook. Histograms are log2-bucketed like the
+ * BMS fault-latency ones: bucket 0 holds 0 us, bucket b holds
+ * [2^(b-1), 2^b) us, the last bucket is open-ended.
+ */
+
+#ifndef INC_FEB_TORQUE_LATENCY_H_
+#define INC_FEB_TORQUE_LATENCY_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ========================================================================== */
+/*                              CONFIGURATION                                 */
+/* ========================================================================== */
+
+#define FEB_TORQUE_LAT_BUCKETS 20
+
+/* Optional 1 Hz report on the vehicle bus, off by default (PCU|torquelat|can|on).
+ * Not in the generated CAN library. Per report window, all in us (LE, saturated):
+ *   [0..1] last total  [2..3] mean total  [4..5] max total  [6..7] max jitter */
+#define FEB_TORQUE_LAT_CAN_FRAME_ID 0xE6
+#define FEB_TORQUE_LAT_CAN_PERIOD_MS 1000U
+
+  /* ========================================================================== */
+  /*                                  TYPES                                     */
+  /* ========================================================================== */
+
+  typedef enum
+  {
+    FEB_TORQUE_LAT_SAMPLE = 0,
+    FEB_TORQUE_LAT_COMPUTE,
+    FEB_TORQUE_LAT_WIRE,
+    FEB_TORQUE_LAT_TOTAL,
+    FEB_TORQUE_LAT_JITTER,
+    FEB_TORQUE_LAT_STAGE_COUNT
+  } FEB_Torque_Lat_Stage_t;
+
+  typedef struct
+  {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t bucket[FEB_TORQUE_LAT_BUCKETS];
+  } FEB_Torque_Lat_Hist_t;
+
+  typedef struct
+  {
+    uint32_t stamped;   /* Commands handed to CAN with a timestamp */
+    uint32_t completed; /* Of those, seen leaving the mailbox */
+    uint32_t lost;      /* Stamped but never completed (counter slot reused) */
+    uint32_t unmatched; /* M192 completions with no stamp (startup frames) */
+  } FEB_Torque_Lat_Counters_t;
+
+  /* ========================================================================== */
+  /*                          FUNCTION PROTOTYPES                               */
+  /* ========================================================================== */
+
+  /**
+   * @brief  Clear the histograms and install the TX-complete hook.
+   *         Call after FEB_CAN_Init(), which clears the hook.
+   */
+  void FEB_Torque_Latency_Init(void);
+
+  /**
+   * @brief  Record that the M192 frame carrying this rolling counter is about
+   *         to be handed to FEB_CAN_TX_Send(). Takes the sample/latch times
+   *         from the current coherent ADC snapshot.
+   */
+  void FEB_Torque_Latency_Stamp(uint8_t rolling_counter);
+
+  /**
+   * @brief  Copy one stage's histogram
+   */
+  void FEB_Torque_Latency_Get(FEB_Torque_Lat_Stage_t stage, FEB_Torque_Lat_Hist_t *out);
+
+  void FEB_Torque_Latency_Get_Counters(FEB_Torque_Lat_Counters_t *out);
+  const char *FEB_Torque_Latency_StageName(FEB_Torque_Lat_Stage_t stage);
+
+  /**
+   * @brief  Zero histograms, counters and pending stamps
+   */
+  void FEB_Torque_Latency_Reset(void);
+
+  /* CAN report enable (off at boot) */
+  void FEB_Torque_Latency_SetCanReport(bool enabled);
+  bool FEB_Torque_Latency_GetCanReport(void);
+
+  /**
+   * @brief  1 ms tick: sends the CAN report every FEB_TORQUE_LAT_CAN_PERIOD_MS
+   *         while enabled. Call from FEB_1ms_Callback.
+   */
+  void FEB_Torque_Latency_Tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_FEB_TORQUE_LATENCY_H_ */
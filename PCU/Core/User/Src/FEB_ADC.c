@@ -13,9 +13,11 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "FEB_ADC.h"
+#include "FEB_ADC_Stream.h"
 #include "FEB_CAN_BMS.h"
 #include "feb_log.h"
 #include "feb_string_utils.h"
+#include "feb_time.h"
 #include "adc.h"
 #include "usart.h"
 #include <math.h>
@@ -173,8 +175,8 @@ static ADC_CalibrationTypeDef brake_pressure2_calibration = {
 #define VOLTAGE_DIVIDER_RATIO_ACCEL2 1.0f         /* APPS2: direct connection, no resistor divider */
 
 /* Private function prototypes -----------------------------------------------*/
-static uint16_t ADC_BoxcarRaw(ADC_HandleTypeDef *hadc, uint16_t *buffer_ptr, uint32_t num_channels,
-                              uint32_t channel_idx, uint8_t samples);
+static void ADC_StreamInit(void);
+static void ADC_StreamBlock(ADC_HandleTypeDef *hadc, uint32_t half);
 static bool ADC_InDriveState(void);
 static void ADC_UpdateFaultEdges(uint32_t new_faults);
 static void ADC_StatsAccumulate(float p1, float p2, float deviation);
@@ -237,6 +239,7 @@ ADC_StatusTypeDef FEB_ADC_Init(void)
   memset(adc1_dma_buffer, 0, sizeof(adc1_dma_buffer));
   memset(adc2_dma_buffer, 0, sizeof(adc2_dma_buffer));
   memset(adc3_dma_buffer, 0, sizeof(adc3_dma_buffer));
+  ADC_StreamInit();
 
   /* Reset runtime data */
   memset(&adc_runtime, 0, sizeof(adc_runtime));
@@ -326,88 +329,190 @@ ADC_StatusTypeDef FEB_ADC_Stop(void)
 static ADC_CoherentSnapshot_t adc_snapshot = {0};
 static volatile uint32_t adc_snapshot_seq = 0;
 
-/* Staleness watchdog: if the summed DMA NDTR across all three ADCs stops
- * advancing (TIM2 trigger or DMA stalled) the snapshot would silently freeze.
- * Detect it and raise FAULT_ADC_TIMEOUT so it is visible and edge-counted. */
-static uint32_t adc_prev_ndtr_sum = 0xFFFFFFFFu;
+/* Staleness watchdog: if no DMA half-block has completed for several ticks
+ * (TIM2 trigger, DMA or its interrupt stalled) the snapshot would silently
+ * freeze. Detect it and raise FAULT_ADC_TIMEOUT so it is visible and
+ * edge-counted. */
+static uint32_t adc_prev_block_sum = 0xFFFFFFFFu;
 static uint32_t adc_stale_ticks = 0;
 #define ADC_STALE_FAULT_TICKS 5u /* ~5 ms with no new conversions => stalled */
 
-/* Boxcar-average the most-recent `samples` conversions for one channel by
- * walking back from the DMA write pointer. Every ADC is launched by the same
- * TIM2 TRGO edge, so the most-recent samples are time-coherent across ADCs.
- * Mirrors the NDTR index math in FEB_ADC_GetRawValue, extended to N samples. */
-static uint16_t ADC_BoxcarRaw(ADC_HandleTypeDef *hadc, uint16_t *buffer_ptr, uint32_t num_channels,
-                              uint32_t channel_idx, uint8_t samples)
+/* Streaming boxcar ----------------------------------------------------------*/
+
+/* Each DMA half/full-transfer callback hands its completed half-buffer
+ * (ADC_DMA_BUFFER_SIZE/2 scans) to FEB_ADC_Stream, which keeps a running sum
+ * per channel, and publishes the channel means into one bank of a per-ADC
+ * double buffer. FEB_ADC_TickSample() only copies finished means: its cost no
+ * longer depends on the boxcar windows.
+ *
+ * The tick (TIM1, NVIC priority 0) preempts the DMA callbacks (priority 2), so
+ * it can never wait for a writer; it reads the published bank while the
+ * callback fills the other one. Every ADC completes the same block of TIM2
+ * scans, so banks are tagged with the block number and the tick takes the
+ * newest block all three have published: if it lands between two ADCs'
+ * callbacks, the ADCs that are one block ahead serve their previous bank. */
+#define ADC_STREAM_MAX_CHANNELS 4U
+#define ADC_STREAM_HALF_SCANS (ADC_DMA_BUFFER_SIZE / 2U)
+
+_Static_assert((ADC_DMA_BUFFER_SIZE % 2U) == 0U, "DMA half-buffers must hold whole scans");
+
+typedef struct
 {
-  if (samples < 1)
-    samples = 1;
-  if (samples > ADC_DMA_BUFFER_SIZE)
-    samples = ADC_DMA_BUFFER_SIZE;
+  volatile uint32_t block; /* Block number of these means, 0 while being written */
+  uint32_t done_us;        /* FEB_Time_Us32() when the half-buffer was consumed */
+  uint16_t mean[ADC_STREAM_MAX_CHANNELS];
+} ADC_StreamBank_t;
 
-  uint32_t buffer_total = num_channels * ADC_DMA_BUFFER_SIZE;
+typedef struct
+{
+  ADC_HandleTypeDef *hadc;
+  const uint16_t *dma_buffer;
+  uint32_t num_channels;
+  const ADC_ChannelConfigTypeDef *config[ADC_STREAM_MAX_CHANNELS]; /* NULL => window 1 */
+  ADC_StreamChannel_t channel[ADC_STREAM_MAX_CHANNELS];
+  ADC_StreamBank_t bank[2];
+  volatile uint32_t published; /* Index of the bank the tick reads */
+  uint32_t blocks;             /* Half-buffers consumed since FEB_ADC_Init */
+} ADC_StreamADC_t;
+
+enum
+{
+  ADC_STREAM_ADC1 = 0,
+  ADC_STREAM_ADC2,
+  ADC_STREAM_ADC3,
+  ADC_STREAM_ADC_COUNT
+};
 
-  if (hadc->DMA_Handle == NULL)
-    return buffer_ptr[channel_idx];
+static ADC_StreamADC_t adc_stream[ADC_STREAM_ADC_COUNT];
 
-  uint32_t ndtr = __HAL_DMA_GET_COUNTER(hadc->DMA_Handle);
-  if (ndtr == 0 || ndtr > buffer_total)
-    return buffer_ptr[channel_idx];
+static uint8_t ADC_FilterWindow(const ADC_ChannelConfigTypeDef *config)
+{
+  if (config == NULL || !config->filter.enabled)
+    return 1;
+  return config->filter.samples;
+}
 
-  /* Most-recent fully-written slot for this channel (see FEB_ADC_GetRawValue). */
-  uint32_t last_written = (buffer_total - ndtr + buffer_total - 1) % buffer_total;
-  uint32_t offset = (last_written + buffer_total - channel_idx) % num_channels;
-  uint32_t latest = (last_written + buffer_total - offset) % buffer_total;
+static void ADC_StreamInit(void)
+{
+  memset(adc_stream, 0, sizeof(adc_stream));
 
-  uint32_t sum = 0;
-  for (uint8_t i = 0; i < samples; i++)
+  /* ADC1 (DMA2_S0): brake2 (idx0), brake1 (idx1), brake_input (idx2). */
+  adc_stream[ADC_STREAM_ADC1].hadc = &hadc1;
+  adc_stream[ADC_STREAM_ADC1].dma_buffer = adc1_dma_buffer;
+  adc_stream[ADC_STREAM_ADC1].num_channels = 3;
+  adc_stream[ADC_STREAM_ADC1].config[ADC1_CH0_BRAKE_PRESSURE2_IDX] = &brake_pressure1_config;
+  adc_stream[ADC_STREAM_ADC1].config[ADC1_CH1_BRAKE_PRESSURE1_IDX] = &brake_pressure1_config;
+  adc_stream[ADC_STREAM_ADC1].config[ADC1_CH14_BRAKE_INPUT_IDX] = &brake_input_config;
+
+  /* ADC2 (DMA2_S2): current (idx0), shutdown (idx1), pre-timing (idx2). */
+  adc_stream[ADC_STREAM_ADC2].hadc = &hadc2;
+  adc_stream[ADC_STREAM_ADC2].dma_buffer = adc2_dma_buffer;
+  adc_stream[ADC_STREAM_ADC2].num_channels = 3;
+  adc_stream[ADC_STREAM_ADC2].config[ADC2_CH4_CURRENT_SENSE_IDX] = &current_sense_config;
+  adc_stream[ADC_STREAM_ADC2].config[ADC2_CH6_SHUTDOWN_IN_IDX] = &shutdown_in_config;
+
+  /* ADC3 (DMA2_S1): bspd_ind (idx0), bspd_rst (idx1), apps2 (idx2), apps1 (idx3). */
+  adc_stream[ADC_STREAM_ADC3].hadc = &hadc3;
+  adc_stream[ADC_STREAM_ADC3].dma_buffer = adc3_dma_buffer;
+  adc_stream[ADC_STREAM_ADC3].num_channels = 4;
+  adc_stream[ADC_STREAM_ADC3].config[ADC3_CH12_ACCEL_PEDAL2_IDX] = &accel_pedal1_config;
+  adc_stream[ADC_STREAM_ADC3].config[ADC3_CH13_ACCEL_PEDAL1_IDX] = &accel_pedal1_config;
+
+  /* Both pair members take their window from the first sensor's config, as
+   * the boxcar always has, so a pair can never run on two windows. */
+  for (uint32_t a = 0; a < ADC_STREAM_ADC_COUNT; a++)
   {
-    uint32_t slot = (latest + buffer_total - (uint32_t)i * num_channels) % buffer_total;
-    sum += buffer_ptr[slot];
+    ADC_StreamADC_t *st = &adc_stream[a];
+    for (uint32_t c = 0; c < st->num_channels; c++)
+      FEB_ADC_Stream_Reset(&st->channel[c], ADC_FilterWindow(st->config[c]));
   }
-  return (uint16_t)(sum / samples);
 }
 
-static uint32_t ADC_SumNDTR(void)
+static ADC_StreamADC_t *ADC_StreamFor(ADC_HandleTypeDef *hadc)
 {
-  uint32_t s = 0;
-  if (hadc1.DMA_Handle)
-    s += __HAL_DMA_GET_COUNTER(hadc1.DMA_Handle);
-  if (hadc2.DMA_Handle)
-    s += __HAL_DMA_GET_COUNTER(hadc2.DMA_Handle);
-  if (hadc3.DMA_Handle)
-    s += __HAL_DMA_GET_COUNTER(hadc3.DMA_Handle);
-  return s;
+  for (uint32_t a = 0; a < ADC_STREAM_ADC_COUNT; a++)
+  {
+    if (adc_stream[a].hadc == hadc)
+      return &adc_stream[a];
+  }
+  return NULL;
+}
+
+/* Consume one completed half-buffer (DMA callback context). */
+static void ADC_StreamBlock(ADC_HandleTypeDef *hadc, uint32_t half)
+{
+  ADC_StreamADC_t *st = ADC_StreamFor(hadc);
+  if (st == NULL)
+    return;
+
+  const uint16_t *block = st->dma_buffer + half * st->num_channels * ADC_STREAM_HALF_SCANS;
+  ADC_StreamBank_t *bank = &st->bank[st->published ^ 1u];
+
+  bank->block = 0;
+  __DMB();
+  bank->done_us = FEB_Time_Us32();
+  for (uint32_t c = 0; c < st->num_channels; c++)
+  {
+    ADC_StreamChannel_t *ch = &st->channel[c];
+    /* Window changes (PCU|apps|filter) are picked up here, on the writer side. */
+    FEB_ADC_Stream_SetWindow(ch, ADC_FilterWindow(st->config[c]));
+    FEB_ADC_Stream_Push(ch, block + c, st->num_channels, ADC_STREAM_HALF_SCANS);
+    bank->mean[c] = FEB_ADC_Stream_Mean(ch);
+  }
+  __DMB();
+  if (++st->blocks == 0) /* 0 marks a bank being written */
+    st->blocks = 1;
+  bank->block = st->blocks;
+  __DMB();
+  st->published ^= 1u;
+}
+
+/* Bank of the newest block every ADC has published (tick context). */
+static const ADC_StreamBank_t *ADC_StreamBankAt(const ADC_StreamADC_t *st, uint32_t block)
+{
+  const ADC_StreamBank_t *latest = &st->bank[st->published];
+  if (latest->block == block)
+    return latest;
+  const ADC_StreamBank_t *previous = &st->bank[st->published ^ 1u];
+  if (previous->block == block)
+    return previous;
+  return latest; /* Streams out of step (one restarted): best effort */
 }
 
 void FEB_ADC_TickSample(void)
 {
-  /* Per-class boxcar window (samples), shared within each plausibility pair so
-   * filtering can never manufacture an inter-sensor deviation. enabled=0 => 1. */
-  uint8_t n_apps = accel_pedal1_config.filter.enabled ? accel_pedal1_config.filter.samples : 1;
-  uint8_t n_brkp = brake_pressure1_config.filter.enabled ? brake_pressure1_config.filter.samples : 1;
-  uint8_t n_brki = brake_input_config.filter.enabled ? brake_input_config.filter.samples : 1;
-  uint8_t n_curr = current_sense_config.filter.enabled ? current_sense_config.filter.samples : 1;
-  uint8_t n_shdn = shutdown_in_config.filter.enabled ? shutdown_in_config.filter.samples : 1;
+  uint32_t block = 0xFFFFFFFFu;
+  uint32_t block_sum = 0;
+  for (uint32_t a = 0; a < ADC_STREAM_ADC_COUNT; a++)
+  {
+    uint32_t b = adc_stream[a].bank[adc_stream[a].published].block;
+    if (b < block)
+      block = b;
+    block_sum += adc_stream[a].blocks;
+  }
+
+  const uint16_t *adc1 = ADC_StreamBankAt(&adc_stream[ADC_STREAM_ADC1], block)->mean;
+  const uint16_t *adc2 = ADC_StreamBankAt(&adc_stream[ADC_STREAM_ADC2], block)->mean;
+  const ADC_StreamBank_t *apps_bank = ADC_StreamBankAt(&adc_stream[ADC_STREAM_ADC3], block);
+  const uint16_t *adc3 = apps_bank->mean;
 
   ADC_CoherentSnapshot_t s;
   s.tick_ms = HAL_GetTick();
+  s.sample_us = apps_bank->done_us;
+  s.latch_us = FEB_Time_Us32();
 
-  /* ADC1 (DMA2_S0): brake2 (idx0), brake1 (idx1), brake_input (idx2). */
-  s.brake2_raw = ADC_BoxcarRaw(&hadc1, adc1_dma_buffer, 3, ADC1_CH0_BRAKE_PRESSURE2_IDX, n_brkp);
-  s.brake1_raw = ADC_BoxcarRaw(&hadc1, adc1_dma_buffer, 3, ADC1_CH1_BRAKE_PRESSURE1_IDX, n_brkp);
-  s.brake_input_raw = ADC_BoxcarRaw(&hadc1, adc1_dma_buffer, 3, ADC1_CH14_BRAKE_INPUT_IDX, n_brki);
+  s.brake2_raw = adc1[ADC1_CH0_BRAKE_PRESSURE2_IDX];
+  s.brake1_raw = adc1[ADC1_CH1_BRAKE_PRESSURE1_IDX];
+  s.brake_input_raw = adc1[ADC1_CH14_BRAKE_INPUT_IDX];
 
-  /* ADC2 (DMA2_S2): current (idx0), shutdown (idx1), pre-timing (idx2). */
-  s.current_raw = ADC_BoxcarRaw(&hadc2, adc2_dma_buffer, 3, ADC2_CH4_CURRENT_SENSE_IDX, n_curr);
-  s.shutdown_raw = ADC_BoxcarRaw(&hadc2, adc2_dma_buffer, 3, ADC2_CH6_SHUTDOWN_IN_IDX, n_shdn);
-  s.pretiming_raw = ADC_BoxcarRaw(&hadc2, adc2_dma_buffer, 3, ADC2_CH7_PRE_TIMING_IDX, 1);
+  s.current_raw = adc2[ADC2_CH4_CURRENT_SENSE_IDX];
+  s.shutdown_raw = adc2[ADC2_CH6_SHUTDOWN_IN_IDX];
+  s.pretiming_raw = adc2[ADC2_CH7_PRE_TIMING_IDX];
 
-  /* ADC3 (DMA2_S1): bspd_ind (idx0), bspd_rst (idx1), apps2 (idx2), apps1 (idx3). */
-  s.bspd_ind_raw = ADC_BoxcarRaw(&hadc3, adc3_dma_buffer, 4, ADC3_CH10_BSPD_INDICATOR_IDX, 1);
-  s.bspd_rst_raw = ADC_BoxcarRaw(&hadc3, adc3_dma_buffer, 4, ADC3_CH11_BSPD_RESET_IDX, 1);
-  s.apps2_raw = ADC_BoxcarRaw(&hadc3, adc3_dma_buffer, 4, ADC3_CH12_ACCEL_PEDAL2_IDX, n_apps);
-  s.apps1_raw = ADC_BoxcarRaw(&hadc3, adc3_dma_buffer, 4, ADC3_CH13_ACCEL_PEDAL1_IDX, n_apps);
+  s.bspd_ind_raw = adc3[ADC3_CH10_BSPD_INDICATOR_IDX];
+  s.bspd_rst_raw = adc3[ADC3_CH11_BSPD_RESET_IDX];
+  s.apps2_raw = adc3[ADC3_CH12_ACCEL_PEDAL2_IDX];
+  s.apps1_raw = adc3[ADC3_CH13_ACCEL_PEDAL1_IDX];
 
   /* Publish atomically (seqlock): odd -> write payload -> even. */
   adc_snapshot_seq++;
@@ -416,10 +521,10 @@ void FEB_ADC_TickSample(void)
   __DMB();
   adc_snapshot_seq++;
 
-  /* Staleness watchdog. NDTR steadily decrements while conversions flow; if the
-   * sum is unchanged for several ticks the trigger/DMA has stalled. */
-  uint32_t ndtr_sum = ADC_SumNDTR();
-  if (ndtr_sum != 0 && ndtr_sum == adc_prev_ndtr_sum)
+  /* Staleness watchdog. Every ADC completes a half-buffer every
+   * ADC_STREAM_HALF_SCANS TIM2 periods while conversions flow; if the block
+   * count is unchanged for several ticks the trigger/DMA has stalled. */
+  if (block_sum == adc_prev_block_sum)
   {
     if (adc_stale_ticks < 0xFFFFu)
       adc_stale_ticks++;
@@ -431,7 +536,7 @@ void FEB_ADC_TickSample(void)
     adc_stale_ticks = 0;
     active_faults &= ~FAULT_ADC_TIMEOUT;
   }
-  adc_prev_ndtr_sum = ndtr_sum;
+  adc_prev_block_sum = block_sum;
 }
 
 void FEB_ADC_GetCoherentSnapshot(ADC_CoherentSnapshot_t *out)
@@ -1576,8 +1681,8 @@ ADC_StatusTypeDef FEB_ADC_SetAPPSFilter(bool enabled, uint8_t samples)
 {
   if (samples < 1)
     samples = 1;
-  if (samples > ADC_DMA_BUFFER_SIZE)
-    samples = ADC_DMA_BUFFER_SIZE;
+  if (samples > ADC_STREAM_MAX_WINDOW)
+    samples = ADC_STREAM_MAX_WINDOW;
   /* Both APPS channels share one boxcar window so group delay stays symmetric. */
   accel_pedal1_config.filter.enabled = enabled ? 1 : 0;
   accel_pedal1_config.filter.samples = samples;
@@ -1690,13 +1795,14 @@ void FEB_ADC_ResetErrors(void)
 
 void FEB_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
-  /* Handle conversion complete - update filtered values */
-  /* This would be called from HAL_ADC_ConvCpltCallback */
+  /* DMA transfer complete: second half-buffer is final */
+  ADC_StreamBlock(hadc, 1);
 }
 
 void FEB_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
 {
-  /* Handle half-transfer complete for DMA mode */
+  /* DMA half-transfer complete: first half-buffer is final */
+  ADC_StreamBlock(hadc, 0);
 }
 
 void FEB_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
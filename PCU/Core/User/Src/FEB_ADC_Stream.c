@@ -0,0 +1,67 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_ADC_Stream.c
+ * @brief          : Streaming moving-sum (boxcar) stage for the ADC DMA stream
+ ******************************************************************************
+ * Each pushed sample adds itself to the running sum and subtracts the sample
+ * that leaves the window, read from the history ring before it is overwritten
+ * (for a full-ring window the leaving sample is the slot being written).
+ * Sums are exact integers, so there is no drift to re-seed.
+ */
+
+#include "FEB_ADC_Stream.h"
+
+#include <string.h>
+
+static uint8_t clamp_window(uint8_t window)
+{
+  if (window < 1)
+    return 1;
+  if (window > ADC_STREAM_MAX_WINDOW)
+    return ADC_STREAM_MAX_WINDOW;
+  return window;
+}
+
+void FEB_ADC_Stream_Reset(ADC_StreamChannel_t *ch, uint8_t window)
+{
+  memset(ch->ring, 0, sizeof(ch->ring));
+  ch->sum = 0;
+  ch->head = 0;
+  ch->window = clamp_window(window);
+}
+
+void FEB_ADC_Stream_SetWindow(ADC_StreamChannel_t *ch, uint8_t window)
+{
+  window = clamp_window(window);
+  if (window == ch->window)
+    return;
+
+  uint32_t sum = 0;
+  uint32_t slot = ch->head;
+  for (uint8_t i = 0; i < window; i++)
+  {
+    slot = (slot - 1U) & ADC_STREAM_RING_MASK;
+    sum += ch->ring[slot];
+  }
+  ch->sum = sum;
+  ch->window = window;
+}
+
+void FEB_ADC_Stream_Push(ADC_StreamChannel_t *ch, const uint16_t *block, uint32_t stride, uint32_t scans)
+{
+  uint32_t sum = ch->sum;
+  uint32_t head = ch->head;
+  uint32_t lag = ADC_STREAM_MAX_WINDOW - ch->window; /* head + lag == slot leaving the window */
+
+  for (uint32_t i = 0; i < scans; i++)
+  {
+    uint16_t sample = block[i * stride];
+    sum += sample;
+    sum -= ch->ring[(head + lag) & ADC_STREAM_RING_MASK];
+    ch->ring[head] = sample;
+    head = (head + 1U) & ADC_STREAM_RING_MASK;
+  }
+
+  ch->sum = sum;
+  ch->head = (uint8_t)head;
+}
@@ -53,6 +53,31 @@ float FEB_CAN_BMS_getMaxTemperature(void)
   return BMS_MESSAGE.max_temperature;
 }
 
+float FEB_CAN_BMS_getSOC(void)
+{
+  return BMS_MESSAGE.soc;
+}
+
+float FEB_CAN_BMS_getPackResistance(void)
+{
+  return BMS_MESSAGE.pack_resistance_ohm;
+}
+
+static bool soc_frame_fresh(void)
+{
+  return BMS_MESSAGE.soc_rx_timestamp != 0 && (HAL_GetTick() - BMS_MESSAGE.soc_rx_timestamp <= BMS_STATE_TIMEOUT_MS);
+}
+
+bool FEB_CAN_BMS_IsSOCFresh(void)
+{
+  return soc_frame_fresh() && (BMS_MESSAGE.soc_flags & FEB_CAN_EXT_BMS_SOC_FLAG_VALID);
+}
+
+bool FEB_CAN_BMS_IsPackResistanceFresh(void)
+{
+  return soc_frame_fresh() && (BMS_MESSAGE.soc_flags & FEB_CAN_EXT_BMS_SOC_FLAG_R_CONVERGED);
+}
+
 void FEB_CAN_BMS_Init(void)
 {
   LOG_I(TAG_BMS, "Initializing BMS CAN communication");
@@ -76,9 +101,12 @@ void FEB_CAN_BMS_Init(void)
   params.can_id = FEB_CAN_BMS_ACCUMULATOR_VOLTAGE_FRAME_ID;
   FEB_CAN_RX_Register(&params);
 
-  LOG_I(TAG_BMS, "Registered BMS CAN callbacks (Temp: 0x%03X, State: 0x%03X, Voltage: 0x%03X)",
+  params.can_id = FEB_CAN_EXT_BMS_SOC_FRAME_ID;
+  FEB_CAN_RX_Register(&params);
+
+  LOG_I(TAG_BMS, "Registered BMS CAN callbacks (Temp: 0x%03X, State: 0x%03X, Voltage: 0x%03X, SOC: 0x%03X)",
         FEB_CAN_BMS_ACCUMULATOR_TEMPERATURE_FRAME_ID, FEB_CAN_BMS_STATE_FRAME_ID,
-        FEB_CAN_BMS_ACCUMULATOR_VOLTAGE_FRAME_ID);
+        FEB_CAN_BMS_ACCUMULATOR_VOLTAGE_FRAME_ID, FEB_CAN_EXT_BMS_SOC_FRAME_ID);
 
   BMS_MESSAGE.temperature = 0;
   BMS_MESSAGE.voltage = 0;
@@ -87,6 +115,11 @@ void FEB_CAN_BMS_Init(void)
   BMS_MESSAGE.max_temperature = 0.0f;
   BMS_MESSAGE.accumulator_voltage = 0.0f;
   BMS_MESSAGE.last_rx_timestamp = 0;
+  BMS_MESSAGE.soc = 0.0f;
+  BMS_MESSAGE.pack_resistance_ohm = 0.0f;
+  BMS_MESSAGE.pack_ocv = 0.0f;
+  BMS_MESSAGE.soc_flags = 0;
+  BMS_MESSAGE.soc_rx_timestamp = 0;
 
   LOG_I(TAG_BMS, "BMS CAN initialization complete");
 }
@@ -129,6 +162,21 @@ static void FEB_CAN_BMS_Callback(FEB_CAN_Instance_t instance, uint32_t can_id, F
     BMS_MESSAGE.voltage = v.total_pack_voltage;
     BMS_MESSAGE.accumulator_voltage = (float)v.total_pack_voltage / 10.0f;
   }
+  else if (can_id == FEB_CAN_EXT_BMS_SOC_FRAME_ID)
+  {
+    /* SOC 0.01 %, R_pack 0.1 mOhm, OCV 0.1 V, flags (feb_can_ext_frames.h) */
+    struct feb_can_ext_bms_soc_t s;
+    if (feb_can_ext_bms_soc_unpack(&s, data, length) != 0)
+    {
+      return;
+    }
+    const bool soc_ok = (s.soc_cpct <= 10000);
+    BMS_MESSAGE.soc = soc_ok ? (float)s.soc_cpct / 10000.0f : 0.0f;
+    BMS_MESSAGE.pack_resistance_ohm = (float)s.r_pack_tenth_mohm / 10000.0f;
+    BMS_MESSAGE.pack_ocv = (float)s.ocv_dv / 10.0f;
+    BMS_MESSAGE.soc_flags = soc_ok ? s.flags : (uint8_t)(s.flags & ~FEB_CAN_EXT_BMS_SOC_FLAG_VALID);
+    BMS_MESSAGE.soc_rx_timestamp = HAL_GetTick();
+  }
 }
 
 void FEB_CAN_HEARTBEAT_Transmit(void)
@@ -140,8 +188,8 @@ void FEB_CAN_HEARTBEAT_Transmit(void)
   feb_can_pcu_heartbeat_pack(tx_data, &((struct feb_can_pcu_heartbeat_t){.error0 = !apps_data.plausible}),
                              sizeof(tx_data));
 
-  FEB_CAN_Status_t status = FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_PCU_HEARTBEAT_FRAME_ID, FEB_CAN_ID_STD, tx_data,
-                                            FEB_CAN_PCU_HEARTBEAT_LENGTH);
+  FEB_CAN_Status_t status = FEB_CAN_TX_SendPriority(FEB_CAN_INSTANCE_1, FEB_CAN_PCU_HEARTBEAT_FRAME_ID, FEB_CAN_ID_STD,
+                                                    tx_data, FEB_CAN_PCU_HEARTBEAT_LENGTH);
 
   if (status != FEB_CAN_OK)
   {
@@ -3,73 +3,96 @@
 
 Brake_DataTypeDef Brake_Data;
 
-void FEB_CAN_Diagnostics_TransmitBrakeData(void)
+/* Telemetry only: brake and pedal-mV at 10 Hz, APPS at 20 Hz. The library
+ * spreads the three across the 100 ms grid (FEB_CAN_TX_Register, phase 0). */
+#define DIAG_BRAKE_PERIOD_MS 100U
+#define DIAG_APPS_PERIOD_MS 50U
+#define DIAG_PEDAL_MV_PERIOD_MS 100U
+
+static struct feb_can_brake_t brake_msg;
+static struct feb_can_pcu_raw_acc_t apps_msg;
+static struct feb_can_pcu_pedal_voltages_t pedal_mv_msg;
+
+/*
+ * Slot pack functions. Each refreshes its message from the latest ADC snapshot
+ * and packs it through the generated definition (common/FEB_CAN_Library_SN4),
+ * which owns layout and endianness. They run from FEB_CAN_TX_ProcessPeriodic.
+ */
+
+static int pack_brake(uint8_t *dst, const void *src, size_t size)
 {
-  // Get latest brake data
-  FEB_ADC_GetBrakeData(&Brake_Data);
+  (void)src;
+  // Local copy: Brake_Data belongs to the torque path in the 1 ms ISR.
+  Brake_DataTypeDef brake_data;
+  FEB_ADC_GetBrakeData(&brake_data);
 
   // Position + per-sensor pressure are sent as centi-percent (0-10000); status
-  // flags ride in bytes 6-7. Layout/endianness are owned by the generated brake
-  // definition (common/FEB_CAN_Library_SN4) — pack through it, don't hand-roll.
-  struct feb_can_brake_t msg = {0};
-  msg.brake_position = (uint16_t)(Brake_Data.brake_position * 100.0f);
-  msg.brake1_pct = (uint16_t)(Brake_Data.pressure1_percent * 100.0f);
-  msg.brake2_pct = (uint16_t)(Brake_Data.pressure2_percent * 100.0f);
-  msg.plausible = Brake_Data.plausible ? 1u : 0u;
-  msg.brake_pressed = Brake_Data.brake_pressed ? 1u : 0u;
-  msg.bots_active = Brake_Data.bots_active ? 1u : 0u;
-  msg.brake_switch = Brake_Data.brake_switch ? 1u : 0u;
+  // flags ride in bytes 6-7.
+  brake_msg.brake_position = (uint16_t)(brake_data.brake_position * 100.0f);
+  brake_msg.brake1_pct = (uint16_t)(brake_data.pressure1_percent * 100.0f);
+  brake_msg.brake2_pct = (uint16_t)(brake_data.pressure2_percent * 100.0f);
+  brake_msg.plausible = brake_data.plausible ? 1u : 0u;
+  brake_msg.brake_pressed = brake_data.brake_pressed ? 1u : 0u;
+  brake_msg.bots_active = brake_data.bots_active ? 1u : 0u;
+  brake_msg.brake_switch = brake_data.brake_switch ? 1u : 0u;
 
-  uint8_t data[FEB_CAN_BRAKE_LENGTH];
-  int packed = feb_can_brake_pack(data, &msg, sizeof(data));
-  FEB_CAN_Status_t status =
-      FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_BRAKE_FRAME_ID, FEB_CAN_ID_STD, data, (uint8_t)packed);
-  if (status != FEB_CAN_OK)
-  {
-    LOG_E(TAG_CAN, "Failed to transmit brake data: %s", FEB_CAN_StatusToString(status));
-  }
+  return feb_can_brake_pack(dst, &brake_msg, size);
 }
 
-void FEB_CAN_Diagnostics_TransmitAPPSData(void)
+static int pack_apps(uint8_t *dst, const void *src, size_t size)
 {
+  (void)src;
   APPS_DataTypeDef apps_data;
   FEB_ADC_GetAPPSData(&apps_data);
 
-  struct feb_can_pcu_raw_acc_t msg = {0};
-  msg.acc0 = (uint16_t)(apps_data.position1 * 100.0f);
-  msg.acc1 = (uint16_t)(apps_data.position2 * 100.0f);
-  msg.accel = (uint16_t)(apps_data.acceleration * 100.0f);
-  msg.plausible = apps_data.plausible ? 1u : 0u;
-  msg.short_circuit = apps_data.short_circuit ? 1u : 0u;
-  msg.open_circuit = apps_data.open_circuit ? 1u : 0u;
+  apps_msg.acc0 = (uint16_t)(apps_data.position1 * 100.0f);
+  apps_msg.acc1 = (uint16_t)(apps_data.position2 * 100.0f);
+  apps_msg.accel = (uint16_t)(apps_data.acceleration * 100.0f);
+  apps_msg.plausible = apps_data.plausible ? 1u : 0u;
+  apps_msg.short_circuit = apps_data.short_circuit ? 1u : 0u;
+  apps_msg.open_circuit = apps_data.open_circuit ? 1u : 0u;
 
-  uint8_t data[FEB_CAN_PCU_RAW_ACC_LENGTH];
-  int packed = feb_can_pcu_raw_acc_pack(data, &msg, sizeof(data));
-  FEB_CAN_Status_t status =
-      FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_PCU_RAW_ACC_FRAME_ID, FEB_CAN_ID_STD, data, (uint8_t)packed);
-  if (status != FEB_CAN_OK)
-  {
-    LOG_E(TAG_CAN, "Failed to transmit APPS data: %s", FEB_CAN_StatusToString(status));
-  }
+  return feb_can_pcu_raw_acc_pack(dst, &apps_msg, size);
 }
 
-void FEB_CAN_Diagnostics_TransmitPedalVoltages(void)
+static int pack_pedal_mv(uint8_t *dst, const void *src, size_t size)
 {
+  (void)src;
   // Raw sensor-side voltages (post on-board divider) in mV — same domain as the
   // APPS/brake calibration thresholds in FEB_PINOUT.h. The Get*Voltage() getters
   // return volts already corrected for the divider ratio; ×1000 yields mV.
-  struct feb_can_pcu_pedal_voltages_t msg = {0};
-  msg.acc1_mv = (uint16_t)(FEB_ADC_GetAccelPedal1Voltage() * 1000.0f);
-  msg.acc2_mv = (uint16_t)(FEB_ADC_GetAccelPedal2Voltage() * 1000.0f);
-  msg.brake1_mv = (uint16_t)(FEB_ADC_GetBrakePressure1Voltage() * 1000.0f);
-  msg.brake2_mv = (uint16_t)(FEB_ADC_GetBrakePressure2Voltage() * 1000.0f);
+  pedal_mv_msg.acc1_mv = (uint16_t)(FEB_ADC_GetAccelPedal1Voltage() * 1000.0f);
+  pedal_mv_msg.acc2_mv = (uint16_t)(FEB_ADC_GetAccelPedal2Voltage() * 1000.0f);
+  pedal_mv_msg.brake1_mv = (uint16_t)(FEB_ADC_GetBrakePressure1Voltage() * 1000.0f);
+  pedal_mv_msg.brake2_mv = (uint16_t)(FEB_ADC_GetBrakePressure2Voltage() * 1000.0f);
 
-  uint8_t data[FEB_CAN_PCU_PEDAL_VOLTAGES_LENGTH];
-  int packed = feb_can_pcu_pedal_voltages_pack(data, &msg, sizeof(data));
-  FEB_CAN_Status_t status =
-      FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_PCU_PEDAL_VOLTAGES_FRAME_ID, FEB_CAN_ID_STD, data, (uint8_t)packed);
-  if (status != FEB_CAN_OK)
+  return feb_can_pcu_pedal_voltages_pack(dst, &pedal_mv_msg, size);
+}
+
+static void register_slot(uint32_t can_id, void *msg, size_t msg_size, uint32_t period_ms,
+                          int (*pack_func)(uint8_t *, const void *, size_t))
+{
+  FEB_CAN_TX_Params_t params = {
+      .instance = FEB_CAN_INSTANCE_1,
+      .can_id = can_id,
+      .id_type = FEB_CAN_ID_STD,
+      .data_ptr = msg,
+      .data_size = msg_size,
+      .period_ms = period_ms,
+      .pack_func = pack_func,
+  };
+  int32_t handle = FEB_CAN_TX_Register(&params);
+  if (handle < 0)
   {
-    LOG_E(TAG_CAN, "Failed to transmit pedal voltages: %s", FEB_CAN_StatusToString(status));
+    LOG_E(TAG_CAN, "Failed to register diagnostic 0x%03lX: %s", (unsigned long)can_id,
+          FEB_CAN_StatusToString((FEB_CAN_Status_t)-handle));
   }
 }
+
+void FEB_CAN_Diagnostics_Init(void)
+{
+  register_slot(FEB_CAN_BRAKE_FRAME_ID, &brake_msg, sizeof(brake_msg), DIAG_BRAKE_PERIOD_MS, pack_brake);
+  register_slot(FEB_CAN_PCU_PEDAL_VOLTAGES_FRAME_ID, &pedal_mv_msg, sizeof(pedal_mv_msg), DIAG_PEDAL_MV_PERIOD_MS,
+                pack_pedal_mv);
+  register_slot(FEB_CAN_PCU_RAW_ACC_FRAME_ID, &apps_msg, sizeof(apps_msg), DIAG_APPS_PERIOD_MS, pack_apps);
+}
@@ -1,4 +1,5 @@
 #include "FEB_CAN_RMS.h"
+#include "FEB_Torque_Latency.h"
 #include "feb_log.h"
 
 /* Number of inverter-disabled (0x0C0, enable=0) command frames sent at startup,
@@ -8,13 +9,6 @@
 
 extern CAN_HandleTypeDef hcan1;
 
-/* Global RMS message data */
-RMS_MESSAGE_TYPE RMS_MESSAGE;
-
-/* Raw per-ID capture of every inverter broadcast frame (0x0A0..0x0AF + 0x0C2).
- * Updated in the RX ISR, dumped on demand by `PCU|rms|raw`. */
-RMS_Frame_Record_t RMS_FRAMES[FEB_CAN_RMS_FRAME_TABLE_SIZE];
-
 /* Forward declaration of callback with new signature */
 static void FEB_CAN_RMS_Callback(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
                                  const uint8_t *data, uint8_t length, void *user_data);
@@ -117,6 +111,10 @@ void FEB_CAN_RMS_Init(void)
 {
   LOG_I(TAG_CAN, "Initializing RMS CAN communication");
 
+  // Clear the decoded state before the RX callback can start writing it.
+  memset(&RMS_MESSAGE, 0, sizeof(RMS_MESSAGE));
+  memset(RMS_FRAMES, 0, sizeof(RMS_FRAMES));
+
   // Subscribe to the WHOLE inverter broadcast block (0x0A0..0x0AF = M160..M175)
   // with a single mask filter so every frame the inverter emits is captured, not
   // just a hand-picked few. mask 0x7F0 makes the low 4 ID bits don't-care.
@@ -142,9 +140,6 @@ void FEB_CAN_RMS_Init(void)
         (unsigned)FEB_CAN_RMS_FRAME_BASE_ID, (unsigned)(FEB_CAN_RMS_FRAME_BASE_ID + FEB_CAN_RMS_FRAME_BLOCK_N - 1u),
         (unsigned)FEB_CAN_M194_READ_WRITE_PARAM_RESPONSE_FRAME_ID);
 
-  memset(&RMS_MESSAGE, 0, sizeof(RMS_MESSAGE));
-  memset(RMS_FRAMES, 0, sizeof(RMS_FRAMES));
-
   // NOTE: the PCU sends NO parameter (M193 / 0x0C1) writes at init. The RMS
   // "Read/Write Parameter Command" writes the inverter's EEPROM (addresses
   // 100..499), so a per-boot broadcast/config write would touch EEPROM on every
@@ -169,32 +164,6 @@ void FEB_CAN_RMS_Init(void)
   LOG_I(TAG_CAN, "RMS CAN initialization complete");
 }
 
-/* Store the raw payload of one inverter frame in its per-ID slot. Maps the
- * broadcast block 0x0A0..0x0AF to slots 0..15 and the param response 0x0C2 to
- * the last slot; anything else is ignored. Runs in ISR context. */
-static void rms_capture_raw(uint32_t can_id, const uint8_t *data, uint8_t length, uint32_t tick)
-{
-  int idx = -1;
-  if (can_id >= FEB_CAN_RMS_FRAME_BASE_ID && can_id < FEB_CAN_RMS_FRAME_BASE_ID + FEB_CAN_RMS_FRAME_BLOCK_N)
-    idx = (int)(can_id - FEB_CAN_RMS_FRAME_BASE_ID);
-  else if (can_id == FEB_CAN_M194_READ_WRITE_PARAM_RESPONSE_FRAME_ID)
-    idx = FEB_CAN_RMS_FRAME_PARAM_RESP_IDX;
-
-  if (idx < 0)
-    return;
-
-  RMS_Frame_Record_t *rec = &RMS_FRAMES[idx];
-  uint8_t n = (length > 8u) ? 8u : length;
-  for (uint8_t i = 0; i < n; i++)
-    rec->data[i] = data[i];
-  for (uint8_t i = n; i < 8u; i++)
-    rec->data[i] = 0;
-  rec->dlc = length;
-  rec->count++;
-  rec->last_rx_tick = tick;
-  rec->seen = 1u;
-}
-
 static void FEB_CAN_RMS_Callback(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
                                  const uint8_t *data, uint8_t length, void *user_data)
 {
@@ -203,200 +172,7 @@ static void FEB_CAN_RMS_Callback(FEB_CAN_Instance_t instance, uint32_t can_id, F
   (void)user_data;
 
   /* NOTE: This callback runs in ISR context - avoid logging and blocking operations */
-
-  uint32_t tick = HAL_GetTick();
-  RMS_MESSAGE.last_rx_timestamp = tick;
-
-  /* Capture the raw frame for EVERY inverter ID first (nothing dropped), then
-   * decode the ones we surface as engineering fields. */
-  rms_capture_raw(can_id, data, length, tick);
-
-  switch (can_id)
-  {
-  case FEB_CAN_M160_TEMPERATURE_SET_1_FRAME_ID:
-  {
-    struct feb_can_m160_temperature_set_1_t m160;
-    feb_can_m160_temperature_set_1_unpack(&m160, data, length);
-    RMS_MESSAGE.temp_module_a = m160.inv_module_a;
-    RMS_MESSAGE.temp_module_b = m160.inv_module_b;
-    RMS_MESSAGE.temp_module_c = m160.inv_module_c;
-    RMS_MESSAGE.temp_gate_driver = m160.inv_gate_driver_board;
-    RMS_MESSAGE.temps_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M161_TEMPERATURE_SET_2_FRAME_ID:
-  {
-    struct feb_can_m161_temperature_set_2_t m161;
-    feb_can_m161_temperature_set_2_unpack(&m161, data, length);
-    RMS_MESSAGE.temp_control_board = m161.inv_control_board_temperature;
-    RMS_MESSAGE.temp_rtd1 = m161.inv_rtd1_temperature;
-    RMS_MESSAGE.temp_rtd2 = m161.inv_rtd2_temperature;
-    RMS_MESSAGE.temp_rtd3 = m161.inv_rtd3_temperature;
-    RMS_MESSAGE.temps_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M162_TEMPERATURE_SET_3_FRAME_ID:
-  {
-    struct feb_can_m162_temperature_set_3_t m162;
-    feb_can_m162_temperature_set_3_unpack(&m162, data, length);
-    RMS_MESSAGE.temp_rtd4 = m162.inv_rtd4_temperature;
-    RMS_MESSAGE.temp_rtd5 = m162.inv_rtd5_temperature;
-    RMS_MESSAGE.temp_motor = m162.inv_motor_temperature;
-    RMS_MESSAGE.torque_shudder = m162.inv_torque_shudder;
-    RMS_MESSAGE.temps_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_ID_RMS_MOTOR: /* M165 motor position */
-  {
-    struct feb_can_m165_motor_position_info_t m165;
-    feb_can_m165_motor_position_info_unpack(&m165, data, length);
-    RMS_MESSAGE.Motor_Speed = m165.inv_motor_speed;
-    RMS_MESSAGE.Motor_Angle = (int16_t)m165.inv_motor_angle_electrical;
-    RMS_MESSAGE.electrical_freq = m165.inv_electrical_output_frequency;
-    break;
-  }
-  case FEB_CAN_M166_CURRENT_INFO_FRAME_ID:
-  {
-    struct feb_can_m166_current_info_t m166;
-    feb_can_m166_current_info_unpack(&m166, data, length);
-    RMS_MESSAGE.phase_a_current = m166.inv_phase_a_current;
-    RMS_MESSAGE.phase_b_current = m166.inv_phase_b_current;
-    RMS_MESSAGE.phase_c_current = m166.inv_phase_c_current;
-    RMS_MESSAGE.dc_bus_current = m166.inv_dc_bus_current;
-    RMS_MESSAGE.current_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_ID_RMS_VOLTAGE: /* M167 voltage info */
-  {
-    /* INV_DC_Bus_Voltage is signed, scale 0.1 V, no offset. */
-    struct feb_can_m167_voltage_info_t m167;
-    feb_can_m167_voltage_info_unpack(&m167, data, length);
-    RMS_MESSAGE.HV_Bus_Voltage = m167.inv_dc_bus_voltage;
-    RMS_MESSAGE.DC_Bus_Voltage_V = m167.inv_dc_bus_voltage / 10.0f;
-    RMS_MESSAGE.output_voltage = m167.inv_output_voltage;
-    RMS_MESSAGE.vab_vd_voltage = m167.inv_vab_vd_voltage;
-    RMS_MESSAGE.vbc_voltage = m167.inv_vbc_vq_voltage;
-    break;
-  }
-  case FEB_CAN_ID_RMS_STATES: /* M170 internal states — the "why won't it enable" frame */
-  {
-    struct feb_can_m170_internal_states_t m170;
-    feb_can_m170_internal_states_unpack(&m170, data, length);
-    RMS_MESSAGE.vsm_state = m170.inv_vsm_state;
-    RMS_MESSAGE.inverter_state = m170.inv_inverter_state;
-    RMS_MESSAGE.enable_state = m170.inv_inverter_enable_state;
-    RMS_MESSAGE.enable_lockout = m170.inv_inverter_enable_lockout;
-    RMS_MESSAGE.command_mode = m170.inv_inverter_command_mode;
-    RMS_MESSAGE.echo_rolling_counter = m170.inv_rolling_counter;
-    RMS_MESSAGE.pwm_frequency = m170.inv_pwm_frequency;
-    RMS_MESSAGE.relay_status = (uint8_t)((m170.inv_relay_1_status & 1u) | ((m170.inv_relay_2_status & 1u) << 1) |
-                                         ((m170.inv_relay_3_status & 1u) << 2) | ((m170.inv_relay_4_status & 1u) << 3) |
-                                         ((m170.inv_relay_5_status & 1u) << 4) | ((m170.inv_relay_6_status & 1u) << 5));
-    RMS_MESSAGE.discharge_state = m170.inv_inverter_discharge_state;
-    RMS_MESSAGE.run_mode = m170.inv_inverter_run_mode;
-    RMS_MESSAGE.direction_command = m170.inv_direction_command;
-    RMS_MESSAGE.bms_active = m170.inv_bms_active;
-    RMS_MESSAGE.start_mode_active = m170.inv_start_mode_active;
-    RMS_MESSAGE.bms_torque_limiting = m170.inv_bms_torque_limiting;
-    RMS_MESSAGE.max_speed_limiting = m170.inv_max_speed_limiting;
-    RMS_MESSAGE.low_speed_limiting = m170.inv_low_speed_limiting;
-    RMS_MESSAGE.states_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_ID_RMS_FAULTS: /* M171 fault codes — POST/Run bitfields (see PM100 manual) */
-  {
-    struct feb_can_m171_fault_codes_t m171;
-    feb_can_m171_fault_codes_unpack(&m171, data, length);
-    RMS_MESSAGE.post_fault_lo = m171.inv_post_fault_lo;
-    RMS_MESSAGE.post_fault_hi = m171.inv_post_fault_hi;
-    RMS_MESSAGE.run_fault_lo = m171.inv_run_fault_lo;
-    RMS_MESSAGE.run_fault_hi = m171.inv_run_fault_hi;
-    RMS_MESSAGE.faults_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M172_TORQUE_AND_TIMER_INFO_FRAME_ID:
-  {
-    struct feb_can_m172_torque_and_timer_info_t m172;
-    feb_can_m172_torque_and_timer_info_unpack(&m172, data, length);
-    RMS_MESSAGE.inv_commanded_torque = m172.inv_commanded_torque;
-    RMS_MESSAGE.Torque_Feedback = m172.inv_torque_feedback;
-    RMS_MESSAGE.power_on_timer = m172.inv_power_on_timer;
-    RMS_MESSAGE.torque_timer_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M163_ANALOG_INPUT_VOLTAGES_FRAME_ID:
-  {
-    struct feb_can_m163_analog_input_voltages_t m163;
-    feb_can_m163_analog_input_voltages_unpack(&m163, data, length);
-    RMS_MESSAGE.analog_in[0] = m163.inv_analog_input_1;
-    RMS_MESSAGE.analog_in[1] = m163.inv_analog_input_2;
-    RMS_MESSAGE.analog_in[2] = m163.inv_analog_input_3;
-    RMS_MESSAGE.analog_in[3] = m163.inv_analog_input_4;
-    RMS_MESSAGE.analog_in[4] = m163.inv_analog_input_5;
-    RMS_MESSAGE.analog_in[5] = m163.inv_analog_input_6;
-    RMS_MESSAGE.analog_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M164_DIGITAL_INPUT_STATUS_FRAME_ID:
-  {
-    struct feb_can_m164_digital_input_status_t m164;
-    feb_can_m164_digital_input_status_unpack(&m164, data, length);
-    RMS_MESSAGE.digital_in = (uint8_t)((m164.inv_digital_input_1 & 1u) | ((m164.inv_digital_input_2 & 1u) << 1) |
-                                       ((m164.inv_digital_input_3 & 1u) << 2) | ((m164.inv_digital_input_4 & 1u) << 3) |
-                                       ((m164.inv_digital_input_5 & 1u) << 4) | ((m164.inv_digital_input_6 & 1u) << 5) |
-                                       ((m164.inv_digital_input_7 & 1u) << 6) | ((m164.inv_digital_input_8 & 1u) << 7));
-    RMS_MESSAGE.digital_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M168_FLUX_ID_IQ_INFO_FRAME_ID:
-  {
-    struct feb_can_m168_flux_id_iq_info_t m168;
-    feb_can_m168_flux_id_iq_info_unpack(&m168, data, length);
-    RMS_MESSAGE.flux_command = m168.inv_flux_command;
-    RMS_MESSAGE.flux_feedback = m168.inv_flux_feedback;
-    RMS_MESSAGE.i_d = m168.inv_id;
-    RMS_MESSAGE.i_q = m168.inv_iq;
-    RMS_MESSAGE.flux_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M169_INTERNAL_VOLTAGES_FRAME_ID:
-  {
-    struct feb_can_m169_internal_voltages_t m169;
-    feb_can_m169_internal_voltages_unpack(&m169, data, length);
-    RMS_MESSAGE.ref_voltage_1_5 = m169.inv_reference_voltage_1_5;
-    RMS_MESSAGE.ref_voltage_2_5 = m169.inv_reference_voltage_2_5;
-    RMS_MESSAGE.ref_voltage_5_0 = m169.inv_reference_voltage_5_0;
-    RMS_MESSAGE.ref_voltage_12_0 = m169.inv_reference_voltage_12_0;
-    RMS_MESSAGE.intv_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M173_MODULATION_AND_FLUX_INFO_FRAME_ID:
-  {
-    struct feb_can_m173_modulation_and_flux_info_t m173;
-    feb_can_m173_modulation_and_flux_info_unpack(&m173, data, length);
-    RMS_MESSAGE.modulation_index = m173.inv_modulation_index;
-    RMS_MESSAGE.flux_weakening_output = m173.inv_flux_weakening_output;
-    RMS_MESSAGE.id_command = m173.inv_id_command;
-    RMS_MESSAGE.iq_command = m173.inv_iq_command;
-    RMS_MESSAGE.mod_rx_timestamp = tick;
-    break;
-  }
-  case FEB_CAN_M174_FIRMWARE_INFO_FRAME_ID:
-  {
-    struct feb_can_m174_firmware_info_t m174;
-    feb_can_m174_firmware_info_unpack(&m174, data, length);
-    RMS_MESSAGE.fw_eeprom_version = m174.inv_project_code_eep_ver;
-    RMS_MESSAGE.fw_sw_version = m174.inv_sw_version;
-    RMS_MESSAGE.fw_date_mmdd = m174.inv_date_code_mmdd;
-    RMS_MESSAGE.fw_date_yyyy = m174.inv_date_code_yyyy;
-    RMS_MESSAGE.fw_rx_timestamp = tick;
-    break;
-  }
-  default:
-    /* Diagnostic data (M175) and the param response (M194) are captured raw
-     * above and visible via `PCU|rms|raw`; no engineering decode needed. */
-    break;
-  }
+  FEB_CAN_RMS_Decode(can_id, data, length, HAL_GetTick());
 }
 
 /**
@@ -441,8 +217,10 @@ void FEB_CAN_RMS_Transmit_UpdateTorque(int16_t torque, uint8_t enabled)
 
   uint8_t data[FEB_CAN_M192_COMMAND_MESSAGE_LENGTH];
   int packed = feb_can_m192_command_message_pack(data, &msg, sizeof(data));
+  FEB_Torque_Latency_Stamp(msg.vcu_inv_rolling_counter);
   FEB_CAN_Status_t status =
-      FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_CAN_M192_COMMAND_MESSAGE_FRAME_ID, FEB_CAN_ID_STD, data, (uint8_t)packed);
+      FEB_CAN_TX_SendPriority(FEB_CAN_INSTANCE_1, FEB_CAN_M192_COMMAND_MESSAGE_FRAME_ID, FEB_CAN_ID_STD, data,
+                              (uint8_t)packed);
   if (status != FEB_CAN_OK)
   {
     LOG_E(TAG_CAN, "Failed to transmit torque command: %s", FEB_CAN_StatusToString(status));
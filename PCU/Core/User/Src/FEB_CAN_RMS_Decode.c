@@ -0,0 +1,312 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_CAN_RMS_Decode.c
+ * @brief          : RMS inverter RX decode: decoder table in ID order, seqlocked state
+ ******************************************************************************
+ * Every inverter frame is looked up in one const decoder table in CAN ID
+ * order (indexed directly: the broadcast block is dense), captured raw into
+ * its RMS_FRAMES slot and decoded straight into RMS_MESSAGE. The word-aligned
+ * frames are read as little-endian 16/32-bit words in place; the bit-packed
+ * ones (M163, M164, M170) still go through the generated unpack.
+ *
+ * Each frame is published under a seqlock, so a reader of
+ * FEB_CAN_RMS_GetFeedback() sees RMS_MESSAGE as it stood between two frames,
+ * never halfway through one and never straddling one. Single writer: the CAN1
+ * FIFO0 RX ISR. Torque_Command is written by the main loop and is not covered.
+ *
+ * No HAL calls (the tick is passed in): also built on the host by
+ * PCU/Host/pcu_rms_decode_bench.c.
+ */
+
+#include "FEB_CAN_RMS.h"
+
+/* Global RMS message data */
+RMS_MESSAGE_TYPE RMS_MESSAGE;
+
+/* Raw per-ID capture of every inverter broadcast frame (0x0A0..0x0AF + 0x0C2).
+ * Updated in the RX ISR, dumped on demand by `PCU|rms|raw`. */
+RMS_Frame_Record_t RMS_FRAMES[FEB_CAN_RMS_FRAME_TABLE_SIZE];
+
+/* Odd while the ISR is writing a frame into RMS_MESSAGE / RMS_FRAMES. */
+static volatile uint32_t rms_seq = 0;
+
+/* Every RMS broadcast frame is 8 bytes; shorter ones are captured raw only. */
+#define RMS_DECODE_LENGTH 8u
+
+/* ============================================================================
+ * Decoders
+ * ============================================================================ */
+
+static inline uint16_t rd_u16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static inline int16_t rd_i16(const uint8_t *p)
+{
+  return (int16_t)rd_u16(p);
+}
+
+static inline uint32_t rd_u32(const uint8_t *p)
+{
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void decode_m160(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.temp_module_a = rd_i16(&d[0]);
+  RMS_MESSAGE.temp_module_b = rd_i16(&d[2]);
+  RMS_MESSAGE.temp_module_c = rd_i16(&d[4]);
+  RMS_MESSAGE.temp_gate_driver = rd_i16(&d[6]);
+  RMS_MESSAGE.temps_rx_timestamp = tick;
+}
+
+static void decode_m161(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.temp_control_board = rd_i16(&d[0]);
+  RMS_MESSAGE.temp_rtd1 = rd_i16(&d[2]);
+  RMS_MESSAGE.temp_rtd2 = rd_i16(&d[4]);
+  RMS_MESSAGE.temp_rtd3 = rd_i16(&d[6]);
+  RMS_MESSAGE.temps_rx_timestamp = tick;
+}
+
+static void decode_m162(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.temp_rtd4 = rd_i16(&d[0]);
+  RMS_MESSAGE.temp_rtd5 = rd_i16(&d[2]);
+  RMS_MESSAGE.temp_motor = rd_i16(&d[4]);
+  RMS_MESSAGE.torque_shudder = rd_i16(&d[6]);
+  RMS_MESSAGE.temps_rx_timestamp = tick;
+}
+
+/* Analog inputs are 10-bit fields packed across byte boundaries */
+static void decode_m163(const uint8_t *d, uint32_t tick)
+{
+  struct feb_can_m163_analog_input_voltages_t m163;
+  feb_can_m163_analog_input_voltages_unpack(&m163, d, RMS_DECODE_LENGTH);
+  RMS_MESSAGE.analog_in[0] = m163.inv_analog_input_1;
+  RMS_MESSAGE.analog_in[1] = m163.inv_analog_input_2;
+  RMS_MESSAGE.analog_in[2] = m163.inv_analog_input_3;
+  RMS_MESSAGE.analog_in[3] = m163.inv_analog_input_4;
+  RMS_MESSAGE.analog_in[4] = m163.inv_analog_input_5;
+  RMS_MESSAGE.analog_in[5] = m163.inv_analog_input_6;
+  RMS_MESSAGE.analog_rx_timestamp = tick;
+}
+
+static void decode_m164(const uint8_t *d, uint32_t tick)
+{
+  struct feb_can_m164_digital_input_status_t m164;
+  feb_can_m164_digital_input_status_unpack(&m164, d, RMS_DECODE_LENGTH);
+  RMS_MESSAGE.digital_in = (uint8_t)((m164.inv_digital_input_1 & 1u) | ((m164.inv_digital_input_2 & 1u) << 1) |
+                                     ((m164.inv_digital_input_3 & 1u) << 2) | ((m164.inv_digital_input_4 & 1u) << 3) |
+                                     ((m164.inv_digital_input_5 & 1u) << 4) | ((m164.inv_digital_input_6 & 1u) << 5) |
+                                     ((m164.inv_digital_input_7 & 1u) << 6) | ((m164.inv_digital_input_8 & 1u) << 7));
+  RMS_MESSAGE.digital_rx_timestamp = tick;
+}
+
+/* M165 motor position */
+static void decode_m165(const uint8_t *d, uint32_t tick)
+{
+  (void)tick;
+  RMS_MESSAGE.Motor_Angle = rd_i16(&d[0]);
+  RMS_MESSAGE.Motor_Speed = rd_i16(&d[2]);
+  RMS_MESSAGE.electrical_freq = rd_i16(&d[4]);
+}
+
+static void decode_m166(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.phase_a_current = rd_i16(&d[0]);
+  RMS_MESSAGE.phase_b_current = rd_i16(&d[2]);
+  RMS_MESSAGE.phase_c_current = rd_i16(&d[4]);
+  RMS_MESSAGE.dc_bus_current = rd_i16(&d[6]);
+  RMS_MESSAGE.current_rx_timestamp = tick;
+}
+
+/* M167 voltage info. INV_DC_Bus_Voltage is signed, scale 0.1 V, no offset. */
+static void decode_m167(const uint8_t *d, uint32_t tick)
+{
+  (void)tick;
+  int16_t dc_bus = rd_i16(&d[0]);
+  RMS_MESSAGE.HV_Bus_Voltage = dc_bus;
+  RMS_MESSAGE.DC_Bus_Voltage_V = dc_bus / 10.0f;
+  RMS_MESSAGE.output_voltage = rd_i16(&d[2]);
+  RMS_MESSAGE.vab_vd_voltage = rd_i16(&d[4]);
+  RMS_MESSAGE.vbc_voltage = rd_i16(&d[6]);
+}
+
+static void decode_m168(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.flux_command = rd_i16(&d[0]);
+  RMS_MESSAGE.flux_feedback = rd_i16(&d[2]);
+  RMS_MESSAGE.i_d = rd_i16(&d[4]);
+  RMS_MESSAGE.i_q = rd_i16(&d[6]);
+  RMS_MESSAGE.flux_rx_timestamp = tick;
+}
+
+static void decode_m169(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.ref_voltage_1_5 = rd_i16(&d[0]);
+  RMS_MESSAGE.ref_voltage_2_5 = rd_i16(&d[2]);
+  RMS_MESSAGE.ref_voltage_5_0 = rd_i16(&d[4]);
+  RMS_MESSAGE.ref_voltage_12_0 = rd_i16(&d[6]);
+  RMS_MESSAGE.intv_rx_timestamp = tick;
+}
+
+/* M170 internal states — the "why won't it enable" frame; single-bit fields */
+static void decode_m170(const uint8_t *d, uint32_t tick)
+{
+  struct feb_can_m170_internal_states_t m170;
+  feb_can_m170_internal_states_unpack(&m170, d, RMS_DECODE_LENGTH);
+  RMS_MESSAGE.vsm_state = m170.inv_vsm_state;
+  RMS_MESSAGE.inverter_state = m170.inv_inverter_state;
+  RMS_MESSAGE.enable_state = m170.inv_inverter_enable_state;
+  RMS_MESSAGE.enable_lockout = m170.inv_inverter_enable_lockout;
+  RMS_MESSAGE.command_mode = m170.inv_inverter_command_mode;
+  RMS_MESSAGE.echo_rolling_counter = m170.inv_rolling_counter;
+  RMS_MESSAGE.pwm_frequency = m170.inv_pwm_frequency;
+  RMS_MESSAGE.relay_status = (uint8_t)((m170.inv_relay_1_status & 1u) | ((m170.inv_relay_2_status & 1u) << 1) |
+                                       ((m170.inv_relay_3_status & 1u) << 2) | ((m170.inv_relay_4_status & 1u) << 3) |
+                                       ((m170.inv_relay_5_status & 1u) << 4) | ((m170.inv_relay_6_status & 1u) << 5));
+  RMS_MESSAGE.discharge_state = m170.inv_inverter_discharge_state;
+  RMS_MESSAGE.run_mode = m170.inv_inverter_run_mode;
+  RMS_MESSAGE.direction_command = m170.inv_direction_command;
+  RMS_MESSAGE.bms_active = m170.inv_bms_active;
+  RMS_MESSAGE.start_mode_active = m170.inv_start_mode_active;
+  RMS_MESSAGE.bms_torque_limiting = m170.inv_bms_torque_limiting;
+  RMS_MESSAGE.max_speed_limiting = m170.inv_max_speed_limiting;
+  RMS_MESSAGE.low_speed_limiting = m170.inv_low_speed_limiting;
+  RMS_MESSAGE.states_rx_timestamp = tick;
+}
+
+/* M171 fault codes — POST/Run bitfields (see PM100 manual) */
+static void decode_m171(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.post_fault_lo = rd_u16(&d[0]);
+  RMS_MESSAGE.post_fault_hi = rd_u16(&d[2]);
+  RMS_MESSAGE.run_fault_lo = rd_u16(&d[4]);
+  RMS_MESSAGE.run_fault_hi = rd_u16(&d[6]);
+  RMS_MESSAGE.faults_rx_timestamp = tick;
+}
+
+static void decode_m172(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.inv_commanded_torque = rd_i16(&d[0]);
+  RMS_MESSAGE.Torque_Feedback = rd_i16(&d[2]);
+  RMS_MESSAGE.power_on_timer = rd_u32(&d[4]);
+  RMS_MESSAGE.torque_timer_rx_timestamp = tick;
+}
+
+static void decode_m173(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.modulation_index = rd_i16(&d[0]);
+  RMS_MESSAGE.flux_weakening_output = rd_i16(&d[2]);
+  RMS_MESSAGE.id_command = rd_i16(&d[4]);
+  RMS_MESSAGE.iq_command = rd_i16(&d[6]);
+  RMS_MESSAGE.mod_rx_timestamp = tick;
+}
+
+static void decode_m174(const uint8_t *d, uint32_t tick)
+{
+  RMS_MESSAGE.fw_eeprom_version = rd_u16(&d[0]);
+  RMS_MESSAGE.fw_sw_version = rd_u16(&d[2]);
+  RMS_MESSAGE.fw_date_mmdd = rd_u16(&d[4]);
+  RMS_MESSAGE.fw_date_yyyy = rd_u16(&d[6]);
+  RMS_MESSAGE.fw_rx_timestamp = tick;
+}
+
+/* ============================================================================
+ * Decoder Table
+ * ============================================================================ */
+
+typedef void (*rms_decode_fn_t)(const uint8_t *d, uint32_t tick);
+
+#define RMS_SLOT(id) ((id) - FEB_CAN_RMS_FRAME_BASE_ID)
+
+/* Indexed by RMS_FRAMES slot, i.e. CAN ID order. NULL = raw capture only:
+ * diagnostic data (M175) and the param response (M194) are visible via
+ * `PCU|rms|raw`; no engineering decode needed. */
+static const rms_decode_fn_t RMS_DECODERS[FEB_CAN_RMS_FRAME_TABLE_SIZE] = {
+    [RMS_SLOT(FEB_CAN_M160_TEMPERATURE_SET_1_FRAME_ID)] = decode_m160,
+    [RMS_SLOT(FEB_CAN_M161_TEMPERATURE_SET_2_FRAME_ID)] = decode_m161,
+    [RMS_SLOT(FEB_CAN_M162_TEMPERATURE_SET_3_FRAME_ID)] = decode_m162,
+    [RMS_SLOT(FEB_CAN_M163_ANALOG_INPUT_VOLTAGES_FRAME_ID)] = decode_m163,
+    [RMS_SLOT(FEB_CAN_M164_DIGITAL_INPUT_STATUS_FRAME_ID)] = decode_m164,
+    [RMS_SLOT(FEB_CAN_ID_RMS_MOTOR)] = decode_m165,
+    [RMS_SLOT(FEB_CAN_M166_CURRENT_INFO_FRAME_ID)] = decode_m166,
+    [RMS_SLOT(FEB_CAN_ID_RMS_VOLTAGE)] = decode_m167,
+    [RMS_SLOT(FEB_CAN_M168_FLUX_ID_IQ_INFO_FRAME_ID)] = decode_m168,
+    [RMS_SLOT(FEB_CAN_M169_INTERNAL_VOLTAGES_FRAME_ID)] = decode_m169,
+    [RMS_SLOT(FEB_CAN_ID_RMS_STATES)] = decode_m170,
+    [RMS_SLOT(FEB_CAN_ID_RMS_FAULTS)] = decode_m171,
+    [RMS_SLOT(FEB_CAN_M172_TORQUE_AND_TIMER_INFO_FRAME_ID)] = decode_m172,
+    [RMS_SLOT(FEB_CAN_M173_MODULATION_AND_FLUX_INFO_FRAME_ID)] = decode_m173,
+    [RMS_SLOT(FEB_CAN_M174_FIRMWARE_INFO_FRAME_ID)] = decode_m174,
+};
+
+/* RMS_FRAMES slot for a CAN ID: the broadcast block 0x0A0..0x0AF is dense, so
+ * it indexes directly; the param response 0x0C2 takes the last slot. */
+static int rms_slot(uint32_t can_id)
+{
+  if (RMS_SLOT(can_id) < FEB_CAN_RMS_FRAME_BLOCK_N)
+    return (int)RMS_SLOT(can_id);
+  if (can_id == FEB_CAN_M194_READ_WRITE_PARAM_RESPONSE_FRAME_ID)
+    return FEB_CAN_RMS_FRAME_PARAM_RESP_IDX;
+  return -1;
+}
+
+/* Store the raw payload of one inverter frame in its per-ID slot. */
+static void rms_capture_raw(RMS_Frame_Record_t *rec, const uint8_t *data, uint8_t length, uint32_t tick)
+{
+  uint8_t n = (length > 8u) ? 8u : length;
+  for (uint8_t i = 0; i < n; i++)
+    rec->data[i] = data[i];
+  for (uint8_t i = n; i < 8u; i++)
+    rec->data[i] = 0;
+  rec->dlc = length;
+  rec->count++;
+  rec->last_rx_tick = tick;
+  rec->seen = 1u;
+}
+
+/* ============================================================================
+ * Public Interface
+ * ============================================================================ */
+
+void FEB_CAN_RMS_Decode(uint32_t can_id, const uint8_t *data, uint8_t length, uint32_t tick)
+{
+  int slot = rms_slot(can_id);
+
+  /* Publish atomically (seqlock): odd -> write frame -> even. */
+  rms_seq++;
+  __DMB();
+
+  RMS_MESSAGE.last_rx_timestamp = tick;
+  if (slot >= 0)
+  {
+    /* Capture the raw frame for EVERY inverter ID first (nothing dropped),
+     * then decode the ones we surface as engineering fields. */
+    rms_capture_raw(&RMS_FRAMES[slot], data, length, tick);
+    if (RMS_DECODERS[slot] && length >= RMS_DECODE_LENGTH)
+      RMS_DECODERS[slot](data, tick);
+  }
+
+  __DMB();
+  rms_seq++;
+}
+
+void FEB_CAN_RMS_GetFeedback(FEB_CAN_RMS_Feedback_t *out)
+{
+  if (!out)
+    return;
+  uint32_t s0, s1;
+  do
+  {
+    s0 = rms_seq;
+    __DMB();
+    out->last_rx_tick = RMS_MESSAGE.last_rx_timestamp;
+    out->dc_bus_voltage_v = RMS_MESSAGE.DC_Bus_Voltage_V;
+    out->motor_speed_rpm = RMS_MESSAGE.Motor_Speed;
+    __DMB();
+    s1 = rms_seq;
+  } while ((s0 & 1u) || (s0 != s1));
+}
@@ -89,6 +89,9 @@ void FEB_Main_Setup(void)
   else
   {
     can_init_success = true;
+    // Keep one CAN1 mailbox for the priority lane (M192 torque, heartbeat) so a
+    // telemetry backlog never makes the torque command wait for a mailbox.
+    FEB_CAN_TX_ReserveMailboxes(FEB_CAN_INSTANCE_1, 1);
     // === CHECKPOINT 3: CAN ready ===
     LOG_I(TAG_MAIN, "[3/8] CAN initialized");
     HAL_Delay(50);
@@ -112,6 +115,9 @@ void FEB_Main_Setup(void)
   {
     FEB_CAN_RMS_Init();
 
+    // Pedal-to-inverter latency trace (PCU|torquelat); hooks M192 TX-complete.
+    FEB_Torque_Latency_Init();
+
     // === CHECKPOINT 5: RMS ready ===
     LOG_I(TAG_MAIN, "[5/8] RMS initialized");
     HAL_Delay(50);
@@ -130,6 +136,10 @@ void FEB_Main_Setup(void)
     FEB_CAN_IVT_Init();
     LOG_I(TAG_MAIN, "[6/8] IVT initialized");
     HAL_Delay(50);
+
+    // Brake / APPS / pedal-mV telemetry as periodic TX slots; the library
+    // spreads their phases and FEB_Main_Loop sends them via ProcessPeriodic.
+    FEB_CAN_Diagnostics_Init();
   }
   else
   {
@@ -166,8 +176,8 @@ void FEB_Main_Setup(void)
 /**
  * Perform the application's main-loop tasks.
  *
- * Processes UART RX data, polls the TPS power monitor at approximately 10 Hz and transmits TPS updates,
- * and services CAN transmit queues (normal and periodic).
+ * Processes UART RX data, polls the TPS power monitor at approximately 4 Hz and transmits TPS updates,
+ * and services CAN transmit queues (normal and periodic, which carries the brake/APPS/pedal-mV telemetry).
  */
 void FEB_Main_Loop(void)
 {
@@ -207,20 +217,13 @@ void FEB_Main_Loop(void)
 /**
  * Handle periodic tasks driven by the 1 ms system tick.
  *
- * Processes the BMS heartbeat on every invocation, triggers the RMS torque
- * update at a 10 ms cadence, and transmits brake, APPS, and raw pedal-voltage
- * diagnostics at a 10 Hz cadence.
+ * Latches the ADC snapshot, runs the APPS and brake fault logic, and triggers
+ * the RMS torque update every FEB_RMS_TORQUE_PERIOD_MS. The brake, APPS and
+ * raw pedal-voltage diagnostics are periodic CAN TX slots (FEB_CAN_Diagnostics_Init).
  */
 void FEB_1ms_Callback(void)
 {
   static uint16_t torque_divider = 0;
-  static uint16_t brake_divider = 0;
-  // Diagnostics are throttled hard (brake/APPS/pedal-mV @ 10 Hz) to keep CAN
-  // traffic low; the dividers are offset (brake @ 0 ms, pedal-mV @ 25 ms, APPS @
-  // 50 ms) so the three never fire in the same tick. The software TX FIFO in
-  // feb_can absorbs any residual bursting.
-  static uint16_t apps_divider = 50;
-  static uint16_t pedal_mv_divider = 75; // first fire at tick 25, then every 100
 
   // Latch ONE time-coherent ADC snapshot for this control cycle. MUST run first
   // so every consumer below (APPS plausibility, brake faults, RMS torque, CAN
@@ -231,7 +234,7 @@ void FEB_1ms_Callback(void)
 
   // Refresh the APPS cache every 1 ms so the implausibility timer
   // accumulates correctly across all consumers (FEB_RMS_Torque,
-  // FEB_CAN_Diagnostics_TransmitAPPSData, the CLI snapshot view).
+  // the APPS diagnostic slot, the CLI snapshot view).
   FEB_ADC_TickAPPS();
 
   // Brake fault detection at 1 ms: BSE sensor open/short (T.4.3.4/.5, 100 ms
@@ -249,35 +252,15 @@ void FEB_1ms_Callback(void)
   // BMS heartbeat is processed in FEB_Main_Loop, not here, to avoid combining
   // its TX with RMS + diagnostics and saturating all 3 hardware CAN mailboxes.
 
-  // Torque command to the RMS — control signal, kept relatively fast (50 Hz).
-  // Well within the inverter command timeout; drop to >= 10 (100 Hz) if needed.
+  // Torque command to the RMS every FEB_RMS_TORQUE_PERIOD_MS (200 Hz default).
+  // M192 rides the CAN priority lane, so the rate costs bus load, not latency.
   torque_divider++;
-  if (torque_divider >= 20)
+  if (torque_divider >= FEB_RMS_TORQUE_PERIOD_MS)
   {
     torque_divider = 0;
     FEB_RMS_Torque();
   }
 
-  // Brake + APPS diagnostics — telemetry only, 10 Hz is plenty.
-  brake_divider++;
-  if (brake_divider >= 100)
-  {
-    brake_divider = 0;
-    FEB_CAN_Diagnostics_TransmitBrakeData();
-  }
-
-  apps_divider++;
-  if (apps_divider >= 50)
-  {
-    apps_divider = 0;
-    FEB_CAN_Diagnostics_TransmitAPPSData();
-  }
-
-  // Raw pedal sensor voltages (mV) — telemetry only, 10 Hz.
-  pedal_mv_divider++;
-  if (pedal_mv_divider >= 100)
-  {
-    pedal_mv_divider = 0;
-    FEB_CAN_Diagnostics_TransmitPedalVoltages();
-  }
+  // Torque latency report (0xE6, 1 Hz) — only when enabled from the console.
+  FEB_Torque_Latency_Tick();
 }
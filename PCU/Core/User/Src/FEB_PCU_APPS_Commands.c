@@ -318,7 +318,7 @@ static void cmd_filter(int argc, char *argv[])
   {
     if (argc < 3)
     {
-      FEB_Console_Printf("Usage: PCU|apps|filter|samples|<1..16>\r\n");
+      FEB_Console_Printf("Usage: PCU|apps|filter|samples|<1..64>\r\n");
       return;
     }
     uint32_t n;
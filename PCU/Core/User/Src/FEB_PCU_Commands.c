@@ -13,10 +13,12 @@
 #include "FEB_CAN_TPS.h"
 #include "FEB_PCU_APPS_Commands.h"
 #include "FEB_RMS.h"
+#include "FEB_Torque_Latency.h"
 #include "feb_can_lib.h"
 #include "feb_console.h"
 #include "feb_string_utils.h"
 #include <ctype.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -45,6 +47,7 @@ static void print_pcu_help(void)
   FEB_Console_Printf("  PCU|bms|state|<drive|0-13|off>  - Sim BMS state (bench only, refused if BMS on bus)\r\n");
   FEB_Console_Printf("  PCU|can      - CAN TX/error diagnostics (PCU|can|reset to clear)\r\n");
   FEB_Console_Printf("  PCU|faults   - Show active faults / faults|clear / faults|inject\r\n");
+  FEB_Console_Printf("  PCU|torquelat[|reset|can|<on|off>]  - Pedal-to-inverter latency/jitter (us)\r\n");
   FEB_Console_Printf("\r\nDeep dives:\r\n");
   FEB_Console_Printf("  PCU|apps|raw|stream|stats|cal|filter|deadzone|mode|sim\r\n");
   FEB_Console_Printf("\r\n");
@@ -1057,6 +1060,8 @@ static void cmd_can(int argc, char *argv[])
                      (unsigned long)FEB_CAN_TX_GetFreeMailboxes(FEB_CAN_INSTANCE_2));
   FEB_Console_Printf("  tx_queue_overflow: %lu  (frames dropped: software FIFO full)\r\n",
                      (unsigned long)FEB_CAN_GetTxQueueOverflowCount());
+  FEB_Console_Printf("  tx_prio_overflow:  %lu  (priority lane full: M192/heartbeat dropped)\r\n",
+                     (unsigned long)FEB_CAN_GetTxPriorityOverflowCount());
   FEB_Console_Printf("  hal_errors:        %lu\r\n", (unsigned long)FEB_CAN_GetHalErrorCount());
   FEB_Console_Printf("  error_callbacks:   %lu\r\n", (unsigned long)FEB_CAN_GetErrorCallbackCount());
   FEB_Console_Printf("  ewg/epv recover:   %lu\r\n", (unsigned long)FEB_CAN_GetEwgRecoveryCount());
@@ -1071,13 +1076,101 @@ static void cmd_can_csv(int argc, char *argv[])
 {
   (void)argc;
   (void)argv;
-  /* fields: mb_free1,mb_free2,tx_overflow,hal_err,err_cb,ewg_recover,bus_off,esr */
-  FEB_Console_CsvEmit("can", "%lu,%lu,%lu,%lu,%lu,%lu,%lu,0x%08lX",
+  /* fields: mb_free1,mb_free2,tx_overflow,hal_err,err_cb,ewg_recover,bus_off,esr,prio_overflow */
+  FEB_Console_CsvEmit("can", "%lu,%lu,%lu,%lu,%lu,%lu,%lu,0x%08lX,%lu",
                       (unsigned long)FEB_CAN_TX_GetFreeMailboxes(FEB_CAN_INSTANCE_1),
                       (unsigned long)FEB_CAN_TX_GetFreeMailboxes(FEB_CAN_INSTANCE_2),
                       (unsigned long)FEB_CAN_GetTxQueueOverflowCount(), (unsigned long)FEB_CAN_GetHalErrorCount(),
                       (unsigned long)FEB_CAN_GetErrorCallbackCount(), (unsigned long)FEB_CAN_GetEwgRecoveryCount(),
-                      (unsigned long)FEB_CAN_GetBusOffCount(), (unsigned long)FEB_CAN_GetLastErrorEsr());
+                      (unsigned long)FEB_CAN_GetBusOffCount(), (unsigned long)FEB_CAN_GetLastErrorEsr(),
+                      (unsigned long)FEB_CAN_GetTxPriorityOverflowCount());
+}
+
+/* `PCU|torquelat` - APPS sample -> M192 out of the mailbox, per stage. `reset`
+ * zeroes the histograms; `can|on|off` toggles the 1 Hz 0xE6 report. */
+static bool cmd_torquelat_control(int argc, char *argv[], bool verbose)
+{
+  if (argc >= 2 && FEB_strcasecmp(argv[1], "reset") == 0)
+  {
+    FEB_Torque_Latency_Reset();
+    if (verbose)
+      FEB_Console_Printf("Torque latency histograms reset\r\n");
+    return true;
+  }
+  if (argc >= 3 && FEB_strcasecmp(argv[1], "can") == 0)
+  {
+    bool on = FEB_strcasecmp(argv[2], "on") == 0;
+    FEB_Torque_Latency_SetCanReport(on);
+    if (verbose)
+      FEB_Console_Printf("Torque latency CAN report (0x%03X) %s\r\n", FEB_TORQUE_LAT_CAN_FRAME_ID, on ? "on" : "off");
+    return true;
+  }
+  return false;
+}
+
+static uint32_t torquelat_bucket_lo(int b)
+{
+  return (b == 0) ? 0U : (1UL << (b - 1));
+}
+
+static void cmd_torquelat(int argc, char *argv[])
+{
+  if (cmd_torquelat_control(argc, argv, true))
+    return;
+
+  FEB_Torque_Lat_Counters_t c;
+  FEB_Torque_Latency_Get_Counters(&c);
+  FEB_Console_Printf("\r\n=== Torque Command Latency (us) ===\r\n");
+  FEB_Console_Printf("Frames: stamped=%lu completed=%lu lost=%lu unmatched=%lu  CAN report: %s\r\n",
+                     (unsigned long)c.stamped, (unsigned long)c.completed, (unsigned long)c.lost,
+                     (unsigned long)c.unmatched, FEB_Torque_Latency_GetCanReport() ? "on" : "off");
+  FEB_Console_Printf("%-8s %8s %8s %8s %8s\r\n", "Stage", "Count", "Min", "Avg", "Max");
+  for (int st = 0; st < FEB_TORQUE_LAT_STAGE_COUNT; st++)
+  {
+    FEB_Torque_Lat_Hist_t h;
+    FEB_Torque_Latency_Get((FEB_Torque_Lat_Stage_t)st, &h);
+    if (h.count == 0)
+      continue;
+    FEB_Console_Printf("%-8s %8lu %8lu %8lu %8lu\r\n", FEB_Torque_Latency_StageName((FEB_Torque_Lat_Stage_t)st),
+                       (unsigned long)h.count, (unsigned long)h.min_us, (unsigned long)(h.sum_us / h.count),
+                       (unsigned long)h.max_us);
+    for (int b = 0; b < FEB_TORQUE_LAT_BUCKETS; b++)
+    {
+      if (h.bucket[b] == 0)
+        continue;
+      if (b == FEB_TORQUE_LAT_BUCKETS - 1)
+        FEB_Console_Printf("    %8lu+         %lu\r\n", (unsigned long)torquelat_bucket_lo(b),
+                           (unsigned long)h.bucket[b]);
+      else
+        FEB_Console_Printf("    %8lu-%-8lu %lu\r\n", (unsigned long)torquelat_bucket_lo(b),
+                           (unsigned long)(torquelat_bucket_lo(b + 1) - 1U), (unsigned long)h.bucket[b]);
+    }
+  }
+}
+
+/* torquelat,<stage>,<count>,<min_us>,<avg_us>,<max_us>,<b0>,...,<b19> per stage,
+ * then torquelat,frames,<stamped>,<completed>,<lost>,<unmatched>. */
+static void cmd_torquelat_csv(int argc, char *argv[])
+{
+  if (cmd_torquelat_control(argc, argv, false))
+    return;
+
+  for (int st = 0; st < FEB_TORQUE_LAT_STAGE_COUNT; st++)
+  {
+    FEB_Torque_Lat_Hist_t h;
+    FEB_Torque_Latency_Get((FEB_Torque_Lat_Stage_t)st, &h);
+    char buckets[FEB_TORQUE_LAT_BUCKETS * 11 + 1];
+    size_t len = 0;
+    for (int b = 0; b < FEB_TORQUE_LAT_BUCKETS; b++)
+      len += (size_t)snprintf(buckets + len, sizeof(buckets) - len, ",%lu", (unsigned long)h.bucket[b]);
+    FEB_Console_CsvEmit("torquelat", "%s,%lu,%lu,%lu,%lu%s", FEB_Torque_Latency_StageName((FEB_Torque_Lat_Stage_t)st),
+                        (unsigned long)h.count, (unsigned long)h.min_us,
+                        (unsigned long)(h.count ? h.sum_us / h.count : 0), (unsigned long)h.max_us, buckets);
+  }
+  FEB_Torque_Lat_Counters_t c;
+  FEB_Torque_Latency_Get_Counters(&c);
+  FEB_Console_CsvEmit("torquelat", "frames,%lu,%lu,%lu,%lu", (unsigned long)c.stamped, (unsigned long)c.completed,
+                      (unsigned long)c.lost, (unsigned long)c.unmatched);
 }
 
 /* ============================================================================
@@ -1111,9 +1204,15 @@ static const FEB_Console_Cmd_t pcu_can_cmd = {.name = "can",
                                               .handler = cmd_can,
                                               .csv_handler = cmd_can_csv,
                                               .hidden = true};
+static const FEB_Console_Cmd_t pcu_torquelat_cmd = {.name = "torquelat",
+                                                    .help = "Pedal-to-inverter latency; `torquelat|reset|can|<on|off>`",
+                                                    .handler = cmd_torquelat,
+                                                    .csv_handler = cmd_torquelat_csv,
+                                                    .hidden = true};
 
 static const FEB_Console_Cmd_t *const PCU_SUBCMDS[] = {
-    &pcu_status_cmd, &pcu_apps_cmd, &pcu_brake_cmd, &pcu_rms_cmd, &pcu_tps_cmd, &pcu_bms_cmd, &pcu_can_cmd,
+    &pcu_status_cmd, &pcu_apps_cmd, &pcu_brake_cmd, &pcu_rms_cmd,
+    &pcu_tps_cmd,    &pcu_bms_cmd,  &pcu_can_cmd,   &pcu_torquelat_cmd,
 };
 #define PCU_SUBCMDS_COUNT (sizeof(PCU_SUBCMDS) / sizeof(PCU_SUBCMDS[0]))
 
@@ -4,14 +4,12 @@
 #include "FEB_CAN_RMS.h"
 #include "FEB_CAN_IVT.h"
 #include "FEB_RMS_Config.h"
+#include "FEB_RMS_Limits.h"
 #include "feb_log.h"
 #include "FEB_Regen.h"
 #include "main.h"
 #include <math.h>
 
-/* Safe min macro with proper parentheses */
-#define min(x1, x2) (((x1) < (x2)) ? (x1) : (x2))
-
 /* Regen brake position threshold (from FEB_Regen.h) */
 #ifndef REGEN_BRAKE_POS_THRESH
 #define REGEN_BRAKE_POS_THRESH 20.0f /* 20% brake position to activate regen */
@@ -24,6 +22,7 @@ extern Brake_DataTypeDef Brake_Data;
 bool DRIVE_STATE;
 
 static uint32_t last_rms_implaus_log_tick = 0;
+static uint32_t last_brake_implaus_log_tick = 0;
 
 /* Bench brake bypass (runtime): treat the brake as released+plausible and skip
  * the BSPD check. Bus-guarded — refused/auto-cancelled when a real BMS is on
@@ -108,142 +107,107 @@ bool FEB_RMS_IsForceDisabled(void)
 }
 
 /**
- * @brief Calculate current derating factor based on pack voltage
- *
- * To prevent pack voltage from dropping below 400V (~2.85V/cell for 140S),
- * we derate the peak current limit as voltage approaches the minimum threshold.
- *
- * Based on empirical data:
- * - At 510V, commanding 65A causes ~62V drop
- * - This suggests pack resistance ≈ 1 Ohm
- * - Linear interpolation between (460V, 100% current) and (410V, 16.7% current)
+ * @brief Compute the drive torque limit for this tick
  *
- * @return Current derating multiplier (0.167 to 1.0)
+ * Samples the IVT, RMS and BMS inputs once and hands them to the fixed-point
+ * limit in FEB_RMS_Limits.c; the warnings it flags are rate-limited here.
  */
-float FEB_Get_Peak_Current_Delimiter()
+static void rms_drive_limits(FEB_RMS_Limits_Drive_t *out)
 {
-  // Pack voltage for limiting: prefer the IVT (measured terminal voltage, sags
-  // under load); fall back to the inverter's M167 DC bus voltage if the IVT is
-  // stale; if neither is available, don't limit torque.
-  float accumulator_voltage;
-  if (FEB_CAN_IVT_IsDataFresh(FEB_CAN_IVT_DATA_TIMEOUT_MS))
-  {
-    accumulator_voltage = FEB_CAN_IVT_GetVoltage();
-  }
-  else if (RMS_MESSAGE.last_rx_timestamp != 0)
-  {
-    accumulator_voltage = RMS_MESSAGE.DC_Bus_Voltage_V;
-  }
-  else
+  // Measured pack voltage/current from the IVT (terminal values, sag under load).
+  // The getters return 0.0 when stale, so every use is gated on freshness.
+  FEB_RMS_Limits_Input_t in;
+  in.ivt_fresh = FEB_CAN_IVT_IsDataFresh(FEB_CAN_IVT_DATA_TIMEOUT_MS);
+  in.ivt_voltage_v = in.ivt_fresh ? FEB_CAN_IVT_GetVoltage() : 0.0f;
+  in.ivt_current_a = in.ivt_fresh ? FEB_CAN_IVT_GetCurrent() : 0.0f;
+  FEB_CAN_RMS_Feedback_t rms;
+  FEB_CAN_RMS_GetFeedback(&rms);
+  in.rms_seen = rms.last_rx_tick != 0;
+  in.rms_dc_bus_v = rms.dc_bus_voltage_v;
+  in.r_pack_fresh = FEB_CAN_BMS_IsPackResistanceFresh();
+  in.r_pack_ohm = in.r_pack_fresh ? FEB_CAN_BMS_getPackResistance() : 0.0f;
+  in.motor_speed_rpm = rms.motor_speed_rpm;
+
+  FEB_RMS_Limits_Drive(&in, out);
+
+  uint32_t now = HAL_GetTick();
+  if (out->flags & RMS_LIMITS_FLAG_NO_VOLTAGE)
   {
     static uint32_t last_no_data_log = 0;
-    if (HAL_GetTick() - last_no_data_log >= 5000)
+    if (now - last_no_data_log >= 5000)
     {
-      last_no_data_log = HAL_GetTick();
+      last_no_data_log = now;
       LOG_W(TAG_RMS, "No pack voltage data (IVT + RMS) received yet");
     }
-    return 1.0f; // Don't limit torque without real data
   }
-
-  // Start derating when voltage = MIN_PACK_VOLTAGE_V + expected_drop_at_peak_current
-  // With R_acc = 1Ω and PEAK_CURRENT = 60A: start_derating = 400V + 60V = 460V
-  float start_derating_voltage = MIN_PACK_VOLTAGE_V + PEAK_CURRENT;
-
-  // Above derating threshold: allow full current
-  if (accumulator_voltage > start_derating_voltage)
+  if (out->flags & RMS_LIMITS_FLAG_CURRENT_FLOOR)
   {
-    return 1.0f;
+    static uint32_t last_low_voltage_log = 0;
+    if (now - last_low_voltage_log >= 1000)
+    {
+      last_low_voltage_log = now;
+      LOG_W(TAG_RMS, "Low pack voltage: %.1fV, limiting to %.0fA",
+            (double)(in.ivt_fresh ? in.ivt_voltage_v : in.rms_dc_bus_v), (double)PEAK_CURRENT_FLOOR_A);
+    }
   }
-
-  // Below minimum safe voltage: limit to 10A (16.7% of 60A)
-  if (accumulator_voltage <= 410.0f)
+  if (out->flags & RMS_LIMITS_FLAG_LOW_PACK)
   {
-    // Rate-limit this warning to once per second
-    static uint32_t last_low_voltage_log = 0;
-    if (HAL_GetTick() - last_low_voltage_log >= 1000)
+    static uint32_t last_low_pack_log = 0;
+    if (now - last_low_pack_log >= 1000)
     {
-      last_low_voltage_log = HAL_GetTick();
-      LOG_W(TAG_RMS, "Low pack voltage: %.1fV, limiting to 10A", accumulator_voltage);
+      last_low_pack_log = now;
+      LOG_W(TAG_RMS, "Low pack voltage detected, reducing max torque to %d", MAX_TORQUE_LOW_V);
     }
-    return (10.0f / PEAK_CURRENT);
   }
+  if (out->flags & RMS_LIMITS_FLAG_IVT_OVERCURRENT)
+  {
+    static uint32_t last_overcurrent_log = 0;
+    if (now - last_overcurrent_log >= 1000)
+    {
+      last_overcurrent_log = now;
+      LOG_W(TAG_RMS, "IVT overcurrent %.1fA > %.1fA, derating torque", (double)fabsf(in.ivt_current_a),
+            (double)IVT_CURRENT_LIMIT_A);
+    }
+  }
+}
 
-  // Linear interpolation between limits
-  // y = mx + b where m = (y1 - y0) / (x1 - x0)
-  float slope = ((10.0f / PEAK_CURRENT) - 1.0f) / (410.0f - start_derating_voltage);
-  float derater = slope * (accumulator_voltage - start_derating_voltage) + 1.0f;
-
-  return derater;
+/**
+ * @brief Calculate current derating factor based on pack voltage
+ *
+ * To prevent pack voltage from dropping below 400V (~2.85V/cell for 140S),
+ * we derate the peak current limit as voltage approaches the minimum threshold.
+ *
+ * The derating starts at MIN_PACK_VOLTAGE_V plus the drop expected at
+ * PEAK_CURRENT, using the BMS's online R_pack estimate once it has converged
+ * and the empirical 1 Ohm (65A at 510V caused ~62V drop) until then. Linear
+ * interpolation between (start, 100% current) and (DERATE_FLOOR_VOLTAGE_V,
+ * PEAK_CURRENT_FLOOR_A). Without any pack voltage, current is not derated.
+ *
+ * @return Current derating multiplier (0.167 to 1.0)
+ */
+float FEB_Get_Peak_Current_Delimiter()
+{
+  FEB_RMS_Limits_Drive_t limits;
+  rms_drive_limits(&limits);
+  return (float)limits.peak_current_ma / (PEAK_CURRENT * 1000.0f);
 }
 
 /**
  * @brief Calculate maximum allowable motor torque based on speed and voltage
  *
  * Implements power limiting to protect accumulator and comply with FSAE rules.
- * Uses constant torque at low speeds, transitions to constant power at high speeds.
+ * Uses constant torque at low speeds, transitions to constant power at high speeds
+ * (derated peak current times the IVT pack voltage, MIN_PACK_VOLTAGE_V if stale),
+ * and scales down proportionally while the IVT measures more than
+ * IVT_CURRENT_LIMIT_A. See FEB_RMS_Limits.h.
  *
  * @return Maximum torque in tenths of Nm (e.g., 2300 = 230.0 Nm)
  */
 float FEB_RMS_GetMaxTorque(void)
 {
-  float motor_speed = RMS_MESSAGE.Motor_Speed * RPM_TO_RAD_S;
-  float peak_current_limited = PEAK_CURRENT * FEB_Get_Peak_Current_Delimiter();
-
-  // Measured pack voltage/current from the IVT (terminal values, sag under load).
-  // The getters return 0.0 when stale, so gate every use on freshness.
-  bool ivt_fresh = FEB_CAN_IVT_IsDataFresh(FEB_CAN_IVT_DATA_TIMEOUT_MS);
-  float pack_voltage_v = ivt_fresh ? FEB_CAN_IVT_GetVoltage() : MIN_PACK_VOLTAGE_V;
-
-  // Cap power to peak_current * measured pack voltage (constant-power budget).
-  float power_capped = peak_current_limited * pack_voltage_v;
-
-  // Select torque limit based on the measured (IVT) pack voltage. Only trip when
-  // the IVT is fresh — a stale getter reads 0.0 and would look like a brownout.
-  uint16_t minimum_torque = MAX_TORQUE;
-  if (ivt_fresh && FEB_CAN_IVT_GetVoltage() < LOW_PACK_VOLTAGE_V)
-  {
-    minimum_torque = MAX_TORQUE_LOW_V;
-    // Rate-limit this warning to once per second
-    static uint32_t last_low_pack_log = 0;
-    if (HAL_GetTick() - last_low_pack_log >= 1000)
-    {
-      last_low_pack_log = HAL_GetTick();
-      LOG_W(TAG_RMS, "Low pack voltage detected, reducing max torque to %d", minimum_torque);
-    }
-  }
-
-  // Below minimum speed threshold: use constant torque mode (prevents division by
-  // zero and handles stopped/negative rotation). Otherwise limit by power.
-  float maxTorque;
-  if (motor_speed < MIN_MOTOR_SPEED_RAD_S)
-  {
-    maxTorque = (float)minimum_torque;
-  }
-  else
-  {
-    maxTorque = min((float)minimum_torque, (power_capped) / motor_speed);
-  }
-
-  // Measured-current protective limit: if the pack is already sourcing more than
-  // IVT_CURRENT_LIMIT_A, scale torque down proportionally. Mirrors the BMS
-  // measured-current check (FEB_SM.c). Conservative backstop — bench-tune.
-  if (ivt_fresh)
-  {
-    float ivt_current = fabsf(FEB_CAN_IVT_GetCurrent());
-    if (ivt_current > IVT_CURRENT_LIMIT_A)
-    {
-      maxTorque *= (IVT_CURRENT_LIMIT_A / ivt_current);
-      static uint32_t last_overcurrent_log = 0;
-      if (HAL_GetTick() - last_overcurrent_log >= 1000)
-      {
-        last_overcurrent_log = HAL_GetTick();
-        LOG_W(TAG_RMS, "IVT overcurrent %.1fA > %.1fA, derating torque", (double)ivt_current,
-              (double)IVT_CURRENT_LIMIT_A);
-      }
-    }
-  }
-
-  return maxTorque;
+  FEB_RMS_Limits_Drive_t limits;
+  rms_drive_limits(&limits);
+  return (float)limits.max_torque_c * 0.01f;
 }
 
 /**
@@ -323,8 +287,9 @@ void FEB_RMS_Torque(void)
       FEB_ADC_GetAPPSCacheSnapshot(NULL, NULL, NULL, &v1_mv, &v2_mv, NULL, NULL, NULL);
       LOG_E(TAG_RMS, "APPS implausible, cutting torque (V1=%.0fmV V2=%.0fmV)", v1_mv, v2_mv);
     }
-    if (!brake_plausible)
+    if (!brake_plausible && (now_rms - last_brake_implaus_log_tick) >= 1000)
     {
+      last_brake_implaus_log_tick = now_rms;
       LOG_E(TAG_RMS, "Brake sensor implausible, cutting torque (P1=%.1f%%/%.0fmV P2=%.1f%%/%.0fmV in=%.0fmV)",
             Brake_Data.pressure1_percent, FEB_ADC_GetBrakePressure1Voltage() * 1000.0f, Brake_Data.pressure2_percent,
             FEB_ADC_GetBrakePressure2Voltage() * 1000.0f, FEB_ADC_GetBrakeInputVoltage() * 1000.0f);
@@ -0,0 +1,222 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_RMS_Limits.c
+ * @brief          : Fixed-point drive and regen torque limits
+ ******************************************************************************
+ * The limit is separable: a current that depends only on pack voltage (and
+ * R_pack), times a voltage, over the motor speed. The current term is a
+ * clamp plus one multiply by a cached Q12 slope; the speed term is one
+ * 32-bit divide by the rpm and a Q24 multiply by the reciprocal of
+ * RPM_TO_RAD_S.
+ * The speed term stays a divide rather than a table: interpolating 1/omega
+ * between grid points would overestimate the power-limited torque.
+ */
+
+#include "FEB_RMS_Limits.h"
+#include "FEB_RMS_Config.h"
+
+#include <math.h>
+
+/* ============================================================================
+ * Compile-time Coefficients
+ * ============================================================================ */
+
+#define LIM_CEIL(x) ((int32_t)(x) + (((float)(int32_t)(x) < (x)) ? 1 : 0))
+
+#define LIM_PEAK_MA ((uint32_t)(PEAK_CURRENT * 1000.0f + 0.5f))
+#define LIM_FLOOR_MA ((uint32_t)(PEAK_CURRENT_FLOOR_A * 1000.0f + 0.5f))
+#define LIM_FLOOR_CV ((uint32_t)(DERATE_FLOOR_VOLTAGE_V * 100.0f + 0.5f))
+#define LIM_MIN_PACK_CV ((uint32_t)(MIN_PACK_VOLTAGE_V * 100.0f + 0.5f))
+#define LIM_LOW_PACK_CV ((uint32_t)(LOW_PACK_VOLTAGE_V * 100.0f + 0.5f))
+#define LIM_OVERCURRENT_CA ((uint32_t)(IVT_CURRENT_LIMIT_A * 100.0f + 0.5f))
+#define LIM_TORQUE_C ((int32_t)MAX_TORQUE * 100)
+#define LIM_TORQUE_LOW_C ((int32_t)MAX_TORQUE_LOW_V * 100)
+#define LIM_R_MIN_MOHM ((uint32_t)(ACCUMULATOR_RESISTANCE_MIN_OHM * 1000.0f + 0.5f))
+#define LIM_R_MAX_MOHM ((uint32_t)(ACCUMULATOR_RESISTANCE_MAX_OHM * 1000.0f + 0.5f))
+#define LIM_R_DEFAULT_MOHM ((uint32_t)(ACCUMULATOR_RESISTANCE_OHM * 1000.0f + 0.5f))
+
+#define LIM_REGEN_MA ((uint32_t)(PEAK_CURRENT_REGEN * 1000.0f + 0.5f))
+#define LIM_REGEN_CAP_C ((int32_t)(MAX_TORQUE_REGEN * 100.0f))
+#define LIM_REGEN_MAX_CV ((uint32_t)INIT_VOLTAGE * 10U) /* INIT_VOLTAGE is in decivolts */
+
+/* Lowest rpm the float path treats as turning: rpm * RPM_TO_RAD_S >= threshold */
+#define LIM_MIN_RPM LIM_CEIL(MIN_MOTOR_SPEED_RAD_S / RPM_TO_RAD_S)
+#define LIM_REGEN_MIN_RPM LIM_CEIL(1.0f / RPM_TO_RAD_S)
+
+/* Power is mA * cV (1e-5 W), taken from a 64-bit product and shifted right by
+ * LIM_POWER_SHIFT so the divide by rpm stays 32-bit. Over rpm * RPM_TO_RAD_S
+ * that is 1000 / 2^LIM_POWER_SHIFT times the torque in hundredths, so the
+ * reciprocal is 2^(24 + LIM_POWER_SHIFT) / (RPM_TO_RAD_S * 1000). Truncated,
+ * so the product never exceeds the exact quotient. */
+#define LIM_POWER_SHIFT 2U
+#define LIM_INV_SPEED_Q24 ((uint32_t)((double)(1UL << (24U + LIM_POWER_SHIFT)) / ((double)RPM_TO_RAD_S * 1000.0)))
+_Static_assert(((uint64_t)LIM_PEAK_MA * RMS_LIMITS_MAX_CV) >> LIM_POWER_SHIFT <= UINT32_MAX,
+               "drive power overflows the divide");
+_Static_assert(((uint64_t)LIM_REGEN_MA * LIM_REGEN_MAX_CV) >> LIM_POWER_SHIFT <= UINT32_MAX,
+               "regen power overflows the divide");
+
+/* ============================================================================
+ * State
+ * ============================================================================ */
+
+/* Derating ramp for the last R_pack seen; R_pack moves slowly, so this is
+ * recomputed a handful of times per drive. 0 never matches (R is clamped). */
+static uint32_t cached_r_mohm = 0;
+static uint32_t cached_start_cv;
+static uint32_t cached_slope_q12;
+
+/* ============================================================================
+ * Internal Functions
+ * ============================================================================ */
+
+static uint32_t volts_to_cv(float v)
+{
+  if (!(v > 0.0f))
+  {
+    return 0;
+  }
+  if (v >= RMS_LIMITS_MAX_CV * 0.01f)
+  {
+    return RMS_LIMITS_MAX_CV;
+  }
+  return (uint32_t)(v * 100.0f);
+}
+
+/* BMS R_pack in mOhm, clamped, rounded up (a higher R starts derating sooner). */
+static uint32_t r_pack_mohm(const FEB_RMS_Limits_Input_t *in)
+{
+  if (!in->r_pack_fresh)
+  {
+    return LIM_R_DEFAULT_MOHM;
+  }
+  if (!(in->r_pack_ohm > ACCUMULATOR_RESISTANCE_MIN_OHM))
+  {
+    return LIM_R_MIN_MOHM;
+  }
+  if (in->r_pack_ohm >= ACCUMULATOR_RESISTANCE_MAX_OHM)
+  {
+    return LIM_R_MAX_MOHM;
+  }
+  float scaled = in->r_pack_ohm * 1000.0f;
+  uint32_t mohm = (uint32_t)scaled;
+  return ((float)mohm < scaled) ? mohm + 1U : mohm;
+}
+
+/* Peak current after voltage derating: PEAK_CURRENT above
+ * MIN_PACK_VOLTAGE_V + PEAK_CURRENT * R, PEAK_CURRENT_FLOOR_A at or below
+ * DERATE_FLOOR_VOLTAGE_V, linear in between. */
+static uint32_t derated_current_ma(uint32_t v_cv, uint32_t r_mohm, uint8_t *flags)
+{
+  if (r_mohm != cached_r_mohm)
+  {
+    cached_r_mohm = r_mohm;
+    /* mA * mOhm / 10000 = cV, rounded up */
+    cached_start_cv = LIM_MIN_PACK_CV + (LIM_PEAK_MA * r_mohm + 9999U) / 10000U;
+    /* (PEAK - FLOOR) << 12 must fit 32 bits: fine up to ~1000 A */
+    cached_slope_q12 = (cached_start_cv > LIM_FLOOR_CV)
+                           ? ((LIM_PEAK_MA - LIM_FLOOR_MA) << 12) / (cached_start_cv - LIM_FLOOR_CV)
+                           : 0;
+  }
+
+  if (v_cv > cached_start_cv)
+  {
+    return LIM_PEAK_MA;
+  }
+  if (v_cv <= LIM_FLOOR_CV)
+  {
+    *flags |= RMS_LIMITS_FLAG_CURRENT_FLOOR;
+    return LIM_FLOOR_MA;
+  }
+  /* v_cv - FLOOR < start - FLOOR, so the product stays below (PEAK - FLOOR) << 12 */
+  return LIM_FLOOR_MA + (((v_cv - LIM_FLOOR_CV) * cached_slope_q12) >> 12);
+}
+
+/* current * voltage / omega in hundredths; rpm > 0 */
+static int32_t power_over_speed_c(uint32_t current_ma, uint32_t voltage_cv, int16_t rpm)
+{
+  uint32_t power = (uint32_t)(((uint64_t)current_ma * voltage_cv) >> LIM_POWER_SHIFT);
+  uint32_t q = power / (uint32_t)rpm;
+  return (int32_t)(((uint64_t)q * LIM_INV_SPEED_Q24) >> 24);
+}
+
+/* ============================================================================
+ * Public Interface
+ * ============================================================================ */
+
+void FEB_RMS_Limits_Drive(const FEB_RMS_Limits_Input_t *in, FEB_RMS_Limits_Drive_t *out)
+{
+  uint8_t flags = 0;
+  uint32_t ivt_cv = in->ivt_fresh ? volts_to_cv(in->ivt_voltage_v) : 0;
+
+  /* Derate on the IVT voltage, else the inverter's DC bus; with neither,
+   * don't limit on data that hasn't arrived. */
+  uint32_t current_ma;
+  if (in->ivt_fresh || in->rms_seen)
+  {
+    uint32_t v_cv = in->ivt_fresh ? ivt_cv : volts_to_cv(in->rms_dc_bus_v);
+    current_ma = derated_current_ma(v_cv, r_pack_mohm(in), &flags);
+  }
+  else
+  {
+    flags |= RMS_LIMITS_FLAG_NO_VOLTAGE;
+    current_ma = LIM_PEAK_MA;
+  }
+
+  /* Only a fresh IVT can trip the low-voltage cap; a stale one reads 0 */
+  int32_t torque_c = LIM_TORQUE_C;
+  if (in->ivt_fresh && ivt_cv < LIM_LOW_PACK_CV)
+  {
+    flags |= RMS_LIMITS_FLAG_LOW_PACK;
+    torque_c = LIM_TORQUE_LOW_C;
+  }
+
+  /* Constant torque below the speed threshold (and in reverse), else power-limited */
+  if (in->motor_speed_rpm >= LIM_MIN_RPM)
+  {
+    uint32_t pack_cv = in->ivt_fresh ? ivt_cv : LIM_MIN_PACK_CV;
+    int32_t power_c = power_over_speed_c(current_ma, pack_cv, in->motor_speed_rpm);
+    if (power_c < torque_c)
+    {
+      torque_c = power_c;
+    }
+  }
+
+  /* Measured-current backstop: scale by limit / |I|, with |I| rounded up */
+  if (in->ivt_fresh)
+  {
+    float ivt_current = fabsf(in->ivt_current_a);
+    if (ivt_current > IVT_CURRENT_LIMIT_A)
+    {
+      flags |= RMS_LIMITS_FLAG_IVT_OVERCURRENT;
+      uint32_t i_ca = 2000000U;
+      if (ivt_current < 20000.0f)
+      {
+        float scaled = ivt_current * 100.0f;
+        i_ca = (uint32_t)scaled;
+        i_ca += ((float)i_ca < scaled) ? 1U : 0U;
+      }
+      torque_c = (int32_t)(((uint32_t)torque_c * LIM_OVERCURRENT_CA) / i_ca);
+    }
+  }
+
+  out->max_torque_c = torque_c;
+  out->peak_current_ma = current_ma;
+  out->flags = flags;
+}
+
+int32_t FEB_RMS_Limits_Regen(float dc_bus_v, int16_t motor_speed_rpm)
+{
+  if (motor_speed_rpm < LIM_REGEN_MIN_RPM)
+  {
+    return 0;
+  }
+
+  uint32_t v_cv = volts_to_cv(dc_bus_v);
+  if (v_cv > LIM_REGEN_MAX_CV)
+  {
+    v_cv = LIM_REGEN_MAX_CV;
+  }
+
+  int32_t torque_c = power_over_speed_c(LIM_REGEN_MA, v_cv, motor_speed_rpm);
+  return (torque_c < LIM_REGEN_CAP_C) ? torque_c : LIM_REGEN_CAP_C;
+}
@@ -10,39 +10,27 @@
  */
 
 #include "FEB_Regen.h"
+#include "FEB_RMS_Limits.h"
 #include "feb_log.h"
 
-/* External references to RMS and BMS data */
-extern RMS_MESSAGE_TYPE RMS_MESSAGE;
-
 /**
  * @brief Calculate maximum regenerative torque based on electrical limits
  * Formula: max_torque = min(MAX_TORQUE_REGEN, (V_acc * 20A) / omega)
  *
  * This ensures we don't exceed the 20A charging limit while maximizing
- * energy recovery at different speeds.
+ * energy recovery at different speeds. V_acc is the M167 DC bus voltage,
+ * capped at INIT_VOLTAGE; computed in fixed point by FEB_RMS_Limits_Regen().
  */
 float FEB_Regen_GetElecMaxRegenTorque(void)
 {
-  // Real DC bus voltage from the M167 broadcast (decoded to Volts in DC_Bus_Voltage_V).
-  // INIT_VOLTAGE is in decivolts (5100 = 510V), so divide by 10 for the cap.
-  float accumulator_voltage = MIN(INIT_VOLTAGE / 10.0f, RMS_MESSAGE.DC_Bus_Voltage_V);
-
-  // Convert motor speed from RPM to rad/s
-  float motor_speed_rads = RMS_MESSAGE.Motor_Speed * RPM_TO_RAD_S;
-
-  // Avoid division by zero at very low speeds
-  if (motor_speed_rads < 1.0f)
-  {
-    LOG_D(TAG_RMS, "Regen disabled: motor speed too low (%.2f rad/s)", motor_speed_rads);
-    return 0.0f;
-  }
+  FEB_CAN_RMS_Feedback_t rms;
+  FEB_CAN_RMS_GetFeedback(&rms);
+  int16_t motor_speed_rpm = rms.motor_speed_rpm;
+  float accumulator_voltage = rms.dc_bus_voltage_v;
 
-  // Calculate max torque: P = V*I, and P = τ*ω, so τ = V*I/ω
-  float max_torque = MIN(MAX_TORQUE_REGEN, (accumulator_voltage * PEAK_CURRENT_REGEN) / motor_speed_rads);
+  float max_torque = (float)FEB_RMS_Limits_Regen(accumulator_voltage, motor_speed_rpm) * 0.01f;
 
-  LOG_D(TAG_RMS, "Regen max torque: %.1f Nm (V=%.1fV, ω=%.1f rad/s)", max_torque, accumulator_voltage,
-        motor_speed_rads);
+  LOG_D(TAG_RMS, "Regen max torque: %.1f Nm (V=%.1fV, %d rpm)", max_torque, accumulator_voltage, motor_speed_rpm);
 
   return max_torque;
 }
@@ -54,7 +42,7 @@ float FEB_Regen_GetElecMaxRegenTorque(void)
  */
 float FEB_Regen_FilterSpeed(float unfiltered_regen_torque)
 {
-  float motor_speed_rpm = (float)RMS_MESSAGE.Motor_Speed;
+  float motor_speed_rpm = (float)FEB_CAN_RMS_getMotorSpeed();
 
   if (motor_speed_rpm < FADE_SPEED_RPM)
   {
@@ -74,9 +62,9 @@ float FEB_Regen_FilterSpeed(float unfiltered_regen_torque)
  */
 float FEB_Regen_FilterSOC(float unfiltered_regen_torque)
 {
-  // TODO: Get actual SOC from BMS - placeholder for now
-  // Assume 85% SOC as conservative default (allows full regen)
-  float state_of_charge = 0.85f; // FEB_CAN_BMS_getSOC() when available
+  // BMS coulomb-count / OCV estimate. Without it (old BMS firmware, frame
+  // stale), fall back to the previous fixed 85 % assumption.
+  float state_of_charge = FEB_CAN_BMS_IsSOCFresh() ? FEB_CAN_BMS_getSOC() : REGEN_FALLBACK_SOC;
 
   // Calculate slope: m = (y1 - y0) / (x1 - x0)
   float slope = (1.0f - 0.0f) / (MAX_REGEN_SOC - START_REGEN_SOC);
@@ -0,0 +1,260 @@
+/**
+ ******************************************************************************
+ * @file           : FEB_Torque_Latency.c
+ * @brief          : Pedal-to-inverter latency and jitter of the torque command
+ ******************************************************************************
+ * Stamps are written from the torque path (1 ms tick, or the console) and
+ * consumed by the CAN TX-complete hook (TX IRQ); both sides and the readers
+ * share state under a nest-safe PRIMASK critical section of a few dozen
+ * instructions.
+ */
+
+#include "FEB_Torque_Latency.h"
+#include "FEB_ADC.h"
+#include "feb_can.h"
+#include "feb_can_lib.h"
+#include "feb_time.h"
+#include "stm32f4xx_hal.h"
+
+#include <string.h>
+
+/* ============================================================================
+ * State
+ * ============================================================================ */
+
+#define TORQUE_LAT_SLOTS 16U /* One per M192 rolling-counter value */
+
+typedef struct
+{
+  bool valid;
+  uint32_t sample_us;
+  uint32_t latch_us;
+  uint32_t command_us;
+} torque_lat_pending_t;
+
+static torque_lat_pending_t pending[TORQUE_LAT_SLOTS];
+static FEB_Torque_Lat_Hist_t hist[FEB_TORQUE_LAT_STAGE_COUNT];
+static FEB_Torque_Lat_Counters_t counters;
+static uint32_t prev_total_us;
+static bool have_prev_total;
+
+/* CAN report window, restarted by every report */
+static struct
+{
+  uint32_t count;
+  uint64_t sum_us;
+  uint32_t max_us;
+  uint32_t max_jitter_us;
+  uint32_t last_us;
+} report;
+static bool can_report_enabled;
+
+static const char *const stage_names[FEB_TORQUE_LAT_STAGE_COUNT] = {"sample", "compute", "wire", "total", "jitter"};
+
+#define TORQUE_LAT_ENTER_CRITICAL()                                                                                    \
+  uint32_t primask = __get_PRIMASK();                                                                                  \
+  __disable_irq()
+#define TORQUE_LAT_EXIT_CRITICAL() __set_PRIMASK(primask)
+
+/* ============================================================================
+ * Internal Functions
+ * ============================================================================ */
+
+/* Caller holds the critical section. */
+static void hist_record(FEB_Torque_Lat_Stage_t stage, uint32_t v)
+{
+  uint32_t b = (v == 0) ? 0 : (uint32_t)(32 - __builtin_clz(v));
+  if (b >= FEB_TORQUE_LAT_BUCKETS)
+  {
+    b = FEB_TORQUE_LAT_BUCKETS - 1;
+  }
+
+  FEB_Torque_Lat_Hist_t *h = &hist[stage];
+  if (h->count == 0 || v < h->min_us)
+  {
+    h->min_us = v;
+  }
+  if (v > h->max_us)
+  {
+    h->max_us = v;
+  }
+  h->count++;
+  h->sum_us += v;
+  h->bucket[b]++;
+}
+
+/* TX IRQ: an M192 left its mailbox. */
+static void on_tx_complete(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                           const uint8_t *data, uint8_t length)
+{
+  if (instance != FEB_CAN_INSTANCE_1 || id_type != FEB_CAN_ID_STD || can_id != FEB_CAN_M192_COMMAND_MESSAGE_FRAME_ID)
+  {
+    return;
+  }
+  uint32_t wire_us = FEB_Time_Us32();
+
+  struct feb_can_m192_command_message_t msg;
+  if (feb_can_m192_command_message_unpack(&msg, data, length) != 0)
+  {
+    return;
+  }
+
+  TORQUE_LAT_ENTER_CRITICAL();
+  torque_lat_pending_t *p = &pending[msg.vcu_inv_rolling_counter & (TORQUE_LAT_SLOTS - 1U)];
+  if (!p->valid)
+  {
+    counters.unmatched++;
+    TORQUE_LAT_EXIT_CRITICAL();
+    return;
+  }
+  p->valid = false;
+  counters.completed++;
+
+  uint32_t total = wire_us - p->sample_us;
+  hist_record(FEB_TORQUE_LAT_SAMPLE, p->latch_us - p->sample_us);
+  hist_record(FEB_TORQUE_LAT_COMPUTE, p->command_us - p->latch_us);
+  hist_record(FEB_TORQUE_LAT_WIRE, wire_us - p->command_us);
+  hist_record(FEB_TORQUE_LAT_TOTAL, total);
+
+  uint32_t jitter = 0;
+  if (have_prev_total)
+  {
+    jitter = (total > prev_total_us) ? total - prev_total_us : prev_total_us - total;
+    hist_record(FEB_TORQUE_LAT_JITTER, jitter);
+  }
+  prev_total_us = total;
+  have_prev_total = true;
+
+  report.count++;
+  report.sum_us += total;
+  report.last_us = total;
+  if (total > report.max_us)
+  {
+    report.max_us = total;
+  }
+  if (jitter > report.max_jitter_us)
+  {
+    report.max_jitter_us = jitter;
+  }
+  TORQUE_LAT_EXIT_CRITICAL();
+}
+
+static void put_u16_sat(uint8_t *dst, uint32_t v)
+{
+  if (v > 0xFFFFu)
+  {
+    v = 0xFFFFu;
+  }
+  dst[0] = (uint8_t)(v & 0xFF);
+  dst[1] = (uint8_t)(v >> 8);
+}
+
+/* ============================================================================
+ * Public Interface
+ * ============================================================================ */
+
+void FEB_Torque_Latency_Init(void)
+{
+  FEB_Torque_Latency_Reset();
+  FEB_CAN_TX_SetCompleteHook(on_tx_complete);
+}
+
+void FEB_Torque_Latency_Stamp(uint8_t rolling_counter)
+{
+  ADC_CoherentSnapshot_t snap;
+  FEB_ADC_GetCoherentSnapshot(&snap);
+  uint32_t command_us = FEB_Time_Us32();
+
+  /* No half-buffer consumed yet (ADC not running): nothing to trace from. */
+  if (snap.sample_us == 0)
+  {
+    return;
+  }
+
+  TORQUE_LAT_ENTER_CRITICAL();
+  torque_lat_pending_t *p = &pending[rolling_counter & (TORQUE_LAT_SLOTS - 1U)];
+  if (p->valid)
+  {
+    counters.lost++;
+  }
+  p->valid = true;
+  p->sample_us = snap.sample_us;
+  p->latch_us = snap.latch_us;
+  p->command_us = command_us;
+  counters.stamped++;
+  TORQUE_LAT_EXIT_CRITICAL();
+}
+
+void FEB_Torque_Latency_Get(FEB_Torque_Lat_Stage_t stage, FEB_Torque_Lat_Hist_t *out)
+{
+  if (stage >= FEB_TORQUE_LAT_STAGE_COUNT || out == NULL)
+  {
+    return;
+  }
+  TORQUE_LAT_ENTER_CRITICAL();
+  *out = hist[stage];
+  TORQUE_LAT_EXIT_CRITICAL();
+}
+
+void FEB_Torque_Latency_Get_Counters(FEB_Torque_Lat_Counters_t *out)
+{
+  if (out == NULL)
+  {
+    return;
+  }
+  TORQUE_LAT_ENTER_CRITICAL();
+  *out = counters;
+  TORQUE_LAT_EXIT_CRITICAL();
+}
+
+const char *FEB_Torque_Latency_StageName(FEB_Torque_Lat_Stage_t stage)
+{
+  return (stage < FEB_TORQUE_LAT_STAGE_COUNT) ? stage_names[stage] : "?";
+}
+
+void FEB_Torque_Latency_Reset(void)
+{
+  TORQUE_LAT_ENTER_CRITICAL();
+  memset(pending, 0, sizeof(pending));
+  memset(hist, 0, sizeof(hist));
+  memset(&counters, 0, sizeof(counters));
+  memset(&report, 0, sizeof(report));
+  have_prev_total = false;
+  TORQUE_LAT_EXIT_CRITICAL();
+}
+
+void FEB_Torque_Latency_SetCanReport(bool enabled)
+{
+  can_report_enabled = enabled;
+}
+
+bool FEB_Torque_Latency_GetCanReport(void)
+{
+  return can_report_enabled;
+}
+
+void FEB_Torque_Latency_Tick(void)
+{
+  static uint32_t divider = 0;
+  if (!can_report_enabled || ++divider < FEB_TORQUE_LAT_CAN_PERIOD_MS)
+  {
+    return;
+  }
+  divider = 0;
+
+  TORQUE_LAT_ENTER_CRITICAL();
+  uint32_t count = report.count;
+  uint32_t mean = count ? (uint32_t)(report.sum_us / count) : 0;
+  uint32_t last = report.last_us;
+  uint32_t max = report.max_us;
+  uint32_t max_jitter = report.max_jitter_us;
+  memset(&report, 0, sizeof(report));
+  TORQUE_LAT_EXIT_CRITICAL();
+
+  uint8_t tx_data[8];
+  put_u16_sat(&tx_data[0], last);
+  put_u16_sat(&tx_data[2], mean);
+  put_u16_sat(&tx_data[4], max);
+  put_u16_sat(&tx_data[6], max_jitter);
+  FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, FEB_TORQUE_LAT_CAN_FRAME_ID, FEB_CAN_ID_STD, tx_data, sizeof(tx_data));
+}
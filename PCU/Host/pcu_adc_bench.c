@@ -0,0 +1,261 @@
+/**
+ ******************************************************************************
+ * @file           : pcu_adc_bench.c
+ * @brief          : Boxcar cost per 1ms tick: DMA walk vs streaming moving sum
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Replays a synthetic 10 kHz, three-ADC DMA stream (the PCU layout: 3 + 3 + 4
+ * channels, TIM2-triggered) through two implementations of the per-1ms
+ * boxcar, for every window from 1 to ADC_STREAM_MAX_WINDOW:
+ *
+ *   walk    - the former ADC_BoxcarRaw(): from the DMA write pointer, walk
+ *             back `window` samples per channel inside FEB_ADC_TickSample().
+ *             Needs a DMA ring at least `window` scans deep.
+ *   stream  - the real FEB_ADC_Stream.c fed one half-buffer at a time, as the
+ *             DMA half/full-transfer callbacks do; the tick copies the means.
+ *
+ * The walk is pointed at the last completed half-buffer, i.e. the samples
+ * the stream has consumed, so the two must agree exactly; any difference is
+ * counted as a mismatch.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted;
+ * compare the columns with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `window,walk_tick_ns,stream_tick_ns,stream_isr_ns_per_ms,mismatches`
+ * stderr: summary. Exit status 1 on any mismatch.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_ADC_Stream.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_OVERSAMPLE_HZ 10000U /* ADC_OVERSAMPLE_HZ */
+#define BENCH_SCANS_PER_TICK (BENCH_OVERSAMPLE_HZ / 1000U)
+#define BENCH_HALF_SCANS 4U  /* ADC_DMA_BUFFER_SIZE / 2 */
+#define BENCH_RING_SCANS 128U /* window plus the scans after the last half-buffer */
+#define BENCH_TICKS 20000U   /* 20 s of stream per window */
+#define BENCH_ADCS 3U
+#define BENCH_MAX_CHANNELS 4U
+
+static const uint32_t bench_channels[BENCH_ADCS] = {3, 3, 4};
+
+typedef struct
+{
+  uint32_t num_channels;
+  uint16_t dma[BENCH_RING_SCANS * BENCH_MAX_CHANNELS]; /* circular, interleaved */
+  uint32_t written;                                    /* samples written in total */
+  uint32_t completed;                                  /* samples through the last half-buffer */
+  ADC_StreamChannel_t stream[BENCH_MAX_CHANNELS];
+  uint16_t stream_mean[BENCH_MAX_CHANNELS];
+} bench_adc_t;
+
+static bench_adc_t adcs[BENCH_ADCS];
+static volatile uint32_t sink; /* keeps the tick reads alive */
+
+/* ============================================================================
+ * Stream source
+ * ============================================================================ */
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/* Slow pedal-like ramp per channel plus a few counts of noise, 12-bit. */
+static uint16_t sample_at(uint32_t scan, uint32_t adc, uint32_t ch)
+{
+  uint32_t phase = (scan + adc * 977U + ch * 331U) % 20000U;
+  uint32_t ramp = phase < 10000U ? phase : 20000U - phase;
+  uint32_t v = 400U + ramp * 3200U / 10000U + (rng_next() & 15U);
+  return (uint16_t)(v > 4095U ? 4095U : v);
+}
+
+/* ============================================================================
+ * Former per-tick walk (ADC_BoxcarRaw)
+ * ============================================================================ */
+
+static uint16_t boxcar_walk(const bench_adc_t *a, uint32_t channel_idx, uint8_t samples)
+{
+  uint32_t num_channels = a->num_channels;
+  uint32_t buffer_total = num_channels * BENCH_RING_SCANS;
+  uint32_t ndtr = buffer_total - (a->completed % buffer_total);
+
+  uint32_t last_written = (buffer_total - ndtr + buffer_total - 1) % buffer_total;
+  uint32_t offset = (last_written + buffer_total - channel_idx) % num_channels;
+  uint32_t latest = (last_written + buffer_total - offset) % buffer_total;
+
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < samples; i++)
+  {
+    uint32_t slot = (latest + buffer_total - (uint32_t)i * num_channels) % buffer_total;
+    sum += a->dma[slot];
+  }
+  return (uint16_t)(sum / samples);
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+typedef struct
+{
+  double walk_tick_ns;
+  double stream_tick_ns;
+  double stream_isr_ns;
+  uint32_t mismatches;
+} bench_result_t;
+
+static bench_result_t run_window(uint8_t window)
+{
+  bench_result_t r = {0};
+  uint64_t walk_ns = 0, tick_ns = 0, isr_ns = 0;
+
+  rng_state = 0x2545F491u;
+  for (uint32_t a = 0; a < BENCH_ADCS; a++)
+  {
+    memset(&adcs[a], 0, sizeof(adcs[a]));
+    adcs[a].num_channels = bench_channels[a];
+    for (uint32_t c = 0; c < adcs[a].num_channels; c++)
+      FEB_ADC_Stream_Reset(&adcs[a].stream[c], window);
+  }
+
+  for (uint32_t scan = 1; scan <= BENCH_TICKS * BENCH_SCANS_PER_TICK; scan++)
+  {
+    /* One TIM2 scan per ADC; the half/full-transfer callback follows every
+     * BENCH_HALF_SCANS scans. */
+    for (uint32_t a = 0; a < BENCH_ADCS; a++)
+    {
+      bench_adc_t *ad = &adcs[a];
+      uint32_t total = ad->num_channels * BENCH_RING_SCANS;
+      for (uint32_t c = 0; c < ad->num_channels; c++)
+        ad->dma[(ad->written + c) % total] = sample_at(scan, a, c);
+      ad->written += ad->num_channels;
+
+      if (scan % BENCH_HALF_SCANS == 0)
+      {
+        const uint16_t *half = &ad->dma[(ad->written - BENCH_HALF_SCANS * ad->num_channels) % total];
+        uint64_t t0 = now_ns();
+        for (uint32_t c = 0; c < ad->num_channels; c++)
+        {
+          FEB_ADC_Stream_Push(&ad->stream[c], half + c, ad->num_channels, BENCH_HALF_SCANS);
+          ad->stream_mean[c] = FEB_ADC_Stream_Mean(&ad->stream[c]);
+        }
+        isr_ns += elapsed_ns(t0, now_ns());
+        ad->completed = ad->written;
+      }
+    }
+
+    if (scan % BENCH_SCANS_PER_TICK != 0)
+      continue;
+
+    /* 1 ms tick. The walk reads the DMA ring up to the last completed
+     * half-buffer, i.e. the same samples the stream has consumed. */
+    uint16_t walk[BENCH_ADCS][BENCH_MAX_CHANNELS];
+    uint64_t t0 = now_ns();
+    for (uint32_t a = 0; a < BENCH_ADCS; a++)
+    {
+      for (uint32_t c = 0; c < adcs[a].num_channels; c++)
+        walk[a][c] = boxcar_walk(&adcs[a], c, window);
+    }
+    uint64_t t1 = now_ns();
+    uint32_t acc = 0;
+    for (uint32_t a = 0; a < BENCH_ADCS; a++)
+    {
+      for (uint32_t c = 0; c < adcs[a].num_channels; c++)
+        acc += adcs[a].stream_mean[c];
+    }
+    sink = acc;
+    uint64_t t2 = now_ns();
+    walk_ns += elapsed_ns(t0, t1);
+    tick_ns += elapsed_ns(t1, t2);
+
+    for (uint32_t a = 0; a < BENCH_ADCS; a++)
+    {
+      for (uint32_t c = 0; c < adcs[a].num_channels; c++)
+      {
+        if (walk[a][c] != adcs[a].stream_mean[c])
+          r.mismatches++;
+      }
+    }
+  }
+
+  r.walk_tick_ns = (double)walk_ns / BENCH_TICKS;
+  r.stream_tick_ns = (double)tick_ns / BENCH_TICKS;
+  r.stream_isr_ns = (double)isr_ns / BENCH_TICKS;
+  return r;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  calibrate_clock();
+  printf("window,walk_tick_ns,stream_tick_ns,stream_isr_ns_per_ms,mismatches\n");
+
+  uint32_t mismatches = 0;
+  double walk_1 = 0, walk_64 = 0, stream_max = 0, isr_max = 0;
+  for (uint32_t w = 1; w <= ADC_STREAM_MAX_WINDOW; w++)
+  {
+    bench_result_t r = run_window((uint8_t)w);
+    printf("%u,%.1f,%.1f,%.1f,%u\n", w, r.walk_tick_ns, r.stream_tick_ns, r.stream_isr_ns, r.mismatches);
+    mismatches += r.mismatches;
+    if (w == 1)
+      walk_1 = r.walk_tick_ns;
+    if (w == ADC_STREAM_MAX_WINDOW)
+      walk_64 = r.walk_tick_ns;
+    if (r.stream_tick_ns > stream_max)
+      stream_max = r.stream_tick_ns;
+    if (r.stream_isr_ns > isr_max)
+      isr_max = r.stream_isr_ns;
+  }
+
+  fprintf(stderr, "walk: %.1f ns/tick at window 1, %.1f at %u\n", walk_1, walk_64, ADC_STREAM_MAX_WINDOW);
+  fprintf(stderr, "stream: <= %.1f ns/tick, <= %.1f ns/ms in the DMA callbacks, any window\n", stream_max, isr_max);
+  fprintf(stderr, "mismatches: %u\n", mismatches);
+  return mismatches ? 1 : 0;
+}
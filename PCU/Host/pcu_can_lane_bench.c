@@ -0,0 +1,393 @@
+/**
+ ******************************************************************************
+ * @file           : pcu_can_lane_bench.c
+ * @brief          : M192 queueing delay on a loaded bus: software FIFO vs priority lane
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real bare-metal feb_can TX path (software FIFO, pump, TX-complete
+ * interrupt) against the host bxCAN model and clocks the bus in virtual time
+ * at 500 kbit/s. Every frame is charged its worst-case stuffed length
+ * (135 bits = 270 us for 8 data bytes).
+ *
+ * The PCU side replays the CAN1 load of FEB_1ms_Callback / FEB_Main_Loop:
+ * M192 at the torque rate, brake and pedal-mV diagnostics at 10 Hz, APPS at
+ * 20 Hz, TPS at 4 Hz, the heartbeat at 10 Hz, plus a telemetry burst (8
+ * frames every 100 ms by default, 1 ms ahead of a torque tick as the worst
+ * alignment) standing in for console and debug traffic.
+ * Telemetry uses stand-in IDs above M192 (0xC0). The other nodes are a
+ * Poisson stream of 8-byte frames sized so that the bus as a whole runs at
+ * 80 %; a quarter of them carry IDs below 0xC0 (BMS, heartbeats) and beat
+ * M192 in arbitration. When the bus goes idle the lowest pending ID wins,
+ * PCU mailbox or not.
+ *
+ * Two modes per torque rate, on the same foreign traffic:
+ *
+ *   fifo      - FEB_CAN_TX_Send for everything, no reserved mailbox (the
+ *               previous PCU behaviour)
+ *   priority  - M192 and the heartbeat via FEB_CAN_TX_SendPriority, one
+ *               CAN1 mailbox reserved (FEB_Main_Setup)
+ *
+ * queue = M192 handed to CAN -> wins arbitration; total = -> transmit done.
+ *
+ * usage: pcu_can_lane_bench [burst_frames [burst_period_ms]]
+ *
+ * stdout: `mode,torque_hz,bus_util_pct,m192_sent,m192_dropped,queue_p50_us,
+ *          queue_p99_us,queue_max_us,total_max_us,telemetry_dropped`
+ * stderr: summary. Exit status 1 if the priority lane dropped an M192.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_can_lib.h"
+#include "feb_host.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_BIT_US 2U          /* 500 kbit/s */
+#define BENCH_UTIL 0.80          /* whole-bus target */
+#define BENCH_DURATION_MS 20000U /* simulated per run */
+#define BENCH_HI_PRIO_SHARE 0.25 /* foreign frames that outrank M192 */
+#define BENCH_FOREIGN_MAX 256U   /* pending foreign frames */
+#define BENCH_SEED 0x2545F491u
+
+#define ID_M192 0x0C0U
+#define ID_HEARTBEAT 0x0B0U
+
+typedef struct
+{
+  const char *name;
+  uint32_t id;
+  uint32_t period_ms;
+  uint32_t phase_ms;
+  bool priority; /* on the lane in priority mode */
+} bench_pcu_frame_t;
+
+/* M192 first; its period is set per run */
+static bench_pcu_frame_t pcu_frames[] = {
+    {"m192", ID_M192, 0, 0, true},        {"heartbeat", ID_HEARTBEAT, 100, 75, true},
+    {"brake", 0x0D0U, 100, 0, false},     {"pedal_mv", 0x0D1U, 100, 25, false},
+    {"apps", 0x0D2U, 50, 0, false},       {"tps", 0x0D3U, 250, 10, false},
+};
+#define BENCH_PCU_FRAMES (sizeof(pcu_frames) / sizeof(pcu_frames[0]))
+#define ID_BURST 0x0D8U
+
+static const uint32_t torque_hz[] = {100, 200, 500, 1000};
+static const uint32_t hi_prio_ids[] = {0x0A0U, 0x0A1U, 0x0A2U, 0x0B1U, 0x0B2U, 0x0B3U, 0x0B4U, 0x0B5U};
+
+static uint32_t burst_frames = 8;
+static uint32_t burst_period_ms = 100;
+
+CAN_HandleTypeDef hcan1;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/* Worst-case stuffed standard data frame, including the interframe space */
+static uint32_t frame_us(uint32_t dlc)
+{
+  uint32_t stuffed = 34U + 8U * dlc;
+  return (stuffed + 13U + (stuffed - 1U) / 4U) * BENCH_BIT_US;
+}
+
+static uint32_t rng_state;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static double rng_unit(void)
+{
+  return ((double)rng_next() + 1.0) / 4294967297.0;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint32_t n, uint32_t pct)
+{
+  if (n == 0U)
+  {
+    return 0;
+  }
+  uint32_t idx = (uint32_t)(((uint64_t)n * pct + 99U) / 100U);
+  return sorted[idx > 0U ? idx - 1U : 0U];
+}
+
+/* ============================================================================
+ * Run
+ * ============================================================================ */
+
+typedef struct
+{
+  double util_pct;
+  uint32_t m192_sent;
+  uint32_t m192_dropped;
+  uint32_t queue_p50_us;
+  uint32_t queue_p99_us;
+  uint32_t queue_max_us;
+  uint32_t total_max_us;
+  uint32_t telemetry_dropped;
+} bench_result_t;
+
+static uint64_t now_us;
+static uint32_t m192_send_us[65536]; /* by sequence number in bytes 6..7 */
+static uint32_t queue_us[BENCH_DURATION_MS + 1U];
+static uint32_t queue_n;
+
+static void pcu_send(const bench_pcu_frame_t *f, bool lane, uint16_t seq, bench_result_t *r)
+{
+  uint8_t data[8] = {0};
+  data[6] = (uint8_t)(seq & 0xFFU);
+  data[7] = (uint8_t)(seq >> 8);
+
+  FEB_CAN_Status_t status = (lane && f->priority)
+                                ? FEB_CAN_TX_SendPriority(FEB_CAN_INSTANCE_1, f->id, FEB_CAN_ID_STD, data, 8)
+                                : FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, f->id, FEB_CAN_ID_STD, data, 8);
+  if (f->id != ID_M192)
+  {
+    return;
+  }
+  r->m192_sent++;
+  if (status != FEB_CAN_OK)
+  {
+    r->m192_dropped++;
+    return;
+  }
+  m192_send_us[seq] = (uint32_t)now_us;
+}
+
+static bench_result_t run(uint32_t hz, bool lane)
+{
+  bench_result_t r = {0};
+
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+  FEB_CAN_Config_t cfg = {.hcan1 = &hcan1, .get_tick_ms = HAL_GetTick};
+  if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+  {
+    fprintf(stderr, "FEB_CAN_Init failed\n");
+    exit(2);
+  }
+  FEB_CAN_TX_ReserveMailboxes(FEB_CAN_INSTANCE_1, lane ? 1U : 0U);
+  FEB_CAN_ResetErrorCounters();
+
+  pcu_frames[0].period_ms = 1000U / hz;
+
+  /* PCU share of the bus, then foreign traffic up to the target */
+  uint32_t f8 = frame_us(8);
+  double pcu_util = (double)burst_frames * f8 / (burst_period_ms * 1000.0);
+  for (uint32_t i = 0; i < BENCH_PCU_FRAMES; i++)
+  {
+    pcu_util += (double)f8 / (pcu_frames[i].period_ms * 1000.0);
+  }
+  double foreign_gap_us = (pcu_util < BENCH_UTIL) ? f8 / (BENCH_UTIL - pcu_util) : INFINITY;
+
+  rng_state = BENCH_SEED;
+  uint32_t foreign[BENCH_FOREIGN_MAX];
+  uint32_t foreign_n = 0;
+  double next_arrival = isinf(foreign_gap_us) ? INFINITY : -log(rng_unit()) * foreign_gap_us;
+
+  uint64_t t0 = now_us;
+  uint64_t end = t0 + (uint64_t)BENCH_DURATION_MS * 1000U;
+  uint64_t next_tick = t0;
+  uint32_t tick = 0;
+  uint64_t wire_end = 0, busy_us = 0;
+  bool wire_busy = false, wire_pcu = false;
+  FEB_Host_CAN_Frame_t wire_frame;
+  uint16_t seq = 0;
+  queue_n = 0;
+
+  while (now_us < end)
+  {
+    /* Frame on the wire finished: ACK it and let the TX interrupt refill */
+    if (wire_busy && now_us >= wire_end)
+    {
+      wire_busy = false;
+      if (wire_pcu)
+      {
+        FEB_Host_CAN_BusStep(&hcan1);
+        if (wire_frame.id == ID_M192)
+        {
+          uint16_t s = (uint16_t)(wire_frame.data[6] | (wire_frame.data[7] << 8));
+          uint32_t total = (uint32_t)now_us - m192_send_us[s];
+          if (total > r.total_max_us)
+          {
+            r.total_max_us = total;
+          }
+        }
+      }
+    }
+
+    /* 1 ms tick (TIM1 ISR on target) */
+    if (now_us >= next_tick)
+    {
+      FEB_Host_ISR_Enter();
+      for (uint32_t i = 0; i < BENCH_PCU_FRAMES; i++)
+      {
+        if (tick % pcu_frames[i].period_ms == pcu_frames[i].phase_ms % pcu_frames[i].period_ms)
+        {
+          pcu_send(&pcu_frames[i], lane, seq++, &r);
+        }
+      }
+      if (burst_frames > 0U && tick % burst_period_ms == burst_period_ms - 1U)
+      {
+        const bench_pcu_frame_t burst = {"burst", ID_BURST, burst_period_ms, 0, false};
+        for (uint32_t i = 0; i < burst_frames; i++)
+        {
+          pcu_send(&burst, lane, seq++, &r);
+        }
+      }
+      FEB_Host_ISR_Exit();
+      FEB_CAN_TX_Process();
+      tick++;
+      next_tick += 1000U;
+    }
+
+    /* Other nodes queue their frames */
+    while (next_arrival <= (double)(now_us - t0))
+    {
+      uint32_t id = (rng_unit() < BENCH_HI_PRIO_SHARE)
+                        ? hi_prio_ids[rng_next() % (sizeof(hi_prio_ids) / sizeof(hi_prio_ids[0]))]
+                        : 0x100U + rng_next() % 0x600U;
+      if (foreign_n < BENCH_FOREIGN_MAX)
+      {
+        foreign[foreign_n++] = id;
+      }
+      next_arrival += -log(rng_unit()) * foreign_gap_us;
+    }
+
+    /* Bus idle: lowest pending ID wins */
+    if (!wire_busy)
+    {
+      FEB_Host_CAN_Frame_t pcu;
+      bool have_pcu = FEB_Host_CAN_BusBegin(&hcan1, &pcu);
+      uint32_t best = 0;
+      for (uint32_t i = 1; i < foreign_n; i++)
+      {
+        if (foreign[i] < foreign[best])
+        {
+          best = i;
+        }
+      }
+
+      if (have_pcu && (foreign_n == 0U || pcu.id < foreign[best]))
+      {
+        wire_busy = true;
+        wire_pcu = true;
+        wire_frame = pcu;
+        wire_end = now_us + frame_us(pcu.dlc);
+        if (pcu.id == ID_M192 && queue_n < sizeof(queue_us) / sizeof(queue_us[0]))
+        {
+          uint16_t s = (uint16_t)(pcu.data[6] | (pcu.data[7] << 8));
+          queue_us[queue_n++] = (uint32_t)now_us - m192_send_us[s];
+        }
+      }
+      else if (foreign_n > 0U)
+      {
+        foreign[best] = foreign[--foreign_n];
+        wire_busy = true;
+        wire_pcu = false;
+        wire_end = now_us + f8;
+      }
+      if (wire_busy)
+      {
+        busy_us += wire_end - now_us;
+      }
+    }
+
+    /* Next event */
+    uint64_t next = next_tick;
+    uint64_t arrival = isinf(next_arrival) ? UINT64_MAX : t0 + (uint64_t)ceil(next_arrival);
+    if (arrival < next)
+    {
+      next = arrival;
+    }
+    if (wire_busy && wire_end < next)
+    {
+      next = wire_end;
+    }
+    if (next <= now_us)
+    {
+      next = now_us + 1U;
+    }
+    FEB_Host_Time_AdvanceUs(next - now_us);
+    now_us = next;
+  }
+
+  /* Let the last frame finish so the next run starts from idle mailboxes */
+  if (wire_busy && wire_pcu)
+  {
+    FEB_Host_CAN_BusStep(&hcan1);
+  }
+  FEB_CAN_DeInit();
+
+  qsort(queue_us, queue_n, sizeof(queue_us[0]), cmp_u32);
+  r.queue_p50_us = percentile(queue_us, queue_n, 50);
+  r.queue_p99_us = percentile(queue_us, queue_n, 99);
+  r.queue_max_us = queue_n ? queue_us[queue_n - 1U] : 0U;
+  r.util_pct = 100.0 * (double)(busy_us > end - t0 ? end - t0 : busy_us) / (double)(end - t0);
+  r.telemetry_dropped = FEB_CAN_GetTxQueueOverflowCount();
+  return r;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    burst_frames = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if (argc > 2)
+  {
+    burst_period_ms = (uint32_t)strtoul(argv[2], NULL, 0);
+  }
+  if (burst_period_ms == 0U)
+  {
+    fprintf(stderr, "usage: %s [burst_frames [burst_period_ms]]\n", argv[0]);
+    return 2;
+  }
+
+  FEB_Host_Time_UseVirtual(true);
+
+  printf("mode,torque_hz,bus_util_pct,m192_sent,m192_dropped,queue_p50_us,queue_p99_us,queue_max_us,total_max_us,"
+         "telemetry_dropped\n");
+
+  int status = 0;
+  for (uint32_t i = 0; i < sizeof(torque_hz) / sizeof(torque_hz[0]); i++)
+  {
+    bench_result_t res[2];
+    for (uint32_t lane = 0; lane < 2U; lane++)
+    {
+      bench_result_t r = run(torque_hz[i], lane != 0U);
+      printf("%s,%u,%.1f,%u,%u,%u,%u,%u,%u,%u\n", lane ? "priority" : "fifo", torque_hz[i], r.util_pct, r.m192_sent,
+             r.m192_dropped, r.queue_p50_us, r.queue_p99_us, r.queue_max_us, r.total_max_us, r.telemetry_dropped);
+      res[lane] = r;
+    }
+    fprintf(stderr, "%4u Hz: M192 worst-case queueing %u us (fifo) -> %u us (priority), p99 %u -> %u us\n",
+            torque_hz[i], res[0].queue_max_us, res[1].queue_max_us, res[0].queue_p99_us, res[1].queue_p99_us);
+    if (res[1].m192_dropped != 0U)
+    {
+      status = 1;
+    }
+  }
+  return status;
+}
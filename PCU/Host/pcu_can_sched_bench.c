@@ -0,0 +1,444 @@
+/**
+ ******************************************************************************
+ * @file           : pcu_can_sched_bench.c
+ * @brief          : CAN1 mailbox occupancy: hand-offset dividers vs periodic TX slots
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Replays the PCU's CAN1 traffic through the real bare-metal feb_can TX path
+ * against the host bxCAN model, on a bus held at 80 % by a Poisson stream of
+ * other nodes' frames (500 kbit/s, worst-case stuffed frame lengths, lowest
+ * ID wins when the bus goes idle), and records how full the mailboxes get.
+ *
+ * Common to every mode: M192 every FEB_RMS_TORQUE_PERIOD_MS (5 ms) and the
+ * heartbeat every 100 ms on the priority lane with one mailbox reserved, and
+ * TPS every 250 ms from the main loop. The brake (100 ms), pedal-mV (100 ms)
+ * and APPS (50 ms) telemetry is what changes:
+ *
+ *   aligned   - 1 ms ISR dividers all starting at 0 (no hand tuning)
+ *   dividers  - the former FEB_1ms_Callback dividers (brake / pedal-mV /
+ *               APPS hand-offset to 0 / 25 / 50 ms), sent from the ISR
+ *   slots     - FEB_CAN_Diagnostics_Init: periodic slots with auto-spread
+ *               phases, sent by FEB_CAN_TX_ProcessPeriodic in the main loop
+ *
+ * The 1 ms ISR dividers count from TIM1 start while slots and the TPS poll
+ * follow HAL_GetTick, so every mode is run with TIM1 starting at each offset
+ * 0..99 ms into the 100 ms HAL_GetTick grid and the worst run is reported.
+ *
+ * burst = PCU frames handed to CAN in one millisecond; mbox = mailboxes
+ * holding a PCU frame (bxCAN has 3); full_us = time all three were busy,
+ * which is when an M192 has nowhere to go; fifo = software TX FIFO depth.
+ *
+ * stdout: `mode,offsets,burst_max,mbox_peak,full_us_max,fifo_peak,
+ *          telemetry_queue_max_us,m192_queue_max_us`
+ * stderr: summary. Exit status 1 if slots do worse than the dividers on
+ * burst, mailbox peak or full time; 2 on setup failure.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_can_internal.h"
+#include "feb_can_lib.h"
+#include "feb_host.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_BIT_US 2U          /* 500 kbit/s */
+#define BENCH_UTIL 0.80          /* whole-bus target */
+#define BENCH_DURATION_MS 5000U  /* simulated per run */
+#define BENCH_OFFSETS 100U       /* TIM1 start vs the 100 ms HAL_GetTick grid */
+#define BENCH_HI_PRIO_SHARE 0.25 /* foreign frames that outrank M192 */
+#define BENCH_FOREIGN_MAX 256U   /* pending foreign frames */
+#define BENCH_MAILBOXES 3U
+#define BENCH_SEED 0x2545F491u
+
+#define TORQUE_PERIOD_MS 5U
+
+#define ID_M192 0x0C0U
+#define ID_HEARTBEAT 0x0B0U
+#define ID_BRAKE 0x0D0U
+#define ID_PEDAL_MV 0x0D1U
+#define ID_APPS 0x0D2U
+#define ID_TPS 0x0D3U
+
+typedef enum
+{
+  MODE_ALIGNED,
+  MODE_DIVIDERS,
+  MODE_SLOTS,
+  MODE_COUNT
+} bench_mode_t;
+
+static const char *const mode_names[MODE_COUNT] = {"aligned", "dividers", "slots"};
+
+typedef struct
+{
+  uint32_t id;
+  uint32_t period_ms;
+  uint32_t divider_start; /* FEB_1ms_Callback's initial counter value */
+} bench_diag_t;
+
+/* A divider starting at s with threshold P fires on ISR ticks where
+ * (tick + 1 + s) % P == 0 (tick counted from TIM1 start). */
+static const bench_diag_t diags[] = {
+    {ID_BRAKE, 100, 0},
+    {ID_PEDAL_MV, 100, 75},
+    {ID_APPS, 50, 50},
+};
+#define BENCH_DIAGS (sizeof(diags) / sizeof(diags[0]))
+
+static const uint32_t hi_prio_ids[] = {0x0A0U, 0x0A1U, 0x0A2U, 0x0B1U, 0x0B2U, 0x0B3U, 0x0B4U, 0x0B5U};
+
+CAN_HandleTypeDef hcan1;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+/* Worst-case stuffed standard data frame, including the interframe space */
+static uint32_t frame_us(uint32_t dlc)
+{
+  uint32_t stuffed = 34U + 8U * dlc;
+  return (stuffed + 13U + (stuffed - 1U) / 4U) * BENCH_BIT_US;
+}
+
+static uint32_t rng_state;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static double rng_unit(void)
+{
+  return ((double)rng_next() + 1.0) / 4294967297.0;
+}
+
+/* ============================================================================
+ * PCU Side
+ * ============================================================================ */
+
+typedef struct
+{
+  uint32_t burst_max;
+  uint32_t mbox_peak;
+  uint64_t full_us;
+  uint32_t fifo_peak;
+  uint32_t telemetry_queue_max_us;
+  uint32_t m192_queue_max_us;
+} bench_result_t;
+
+static uint64_t now_us;
+static uint16_t seq;
+static uint32_t send_us[65536]; /* by sequence number in bytes 6..7 */
+static uint64_t burst_ms;
+static uint32_t burst_n;
+static bench_result_t *cur;
+
+/* Every PCU frame funnels through here (directly or from a slot pack) */
+static void note_handoff(uint8_t *data)
+{
+  data[6] = (uint8_t)(seq & 0xFFU);
+  data[7] = (uint8_t)(seq >> 8);
+  send_us[seq++] = (uint32_t)now_us;
+
+  uint64_t ms = now_us / 1000U;
+  if (ms != burst_ms)
+  {
+    burst_ms = ms;
+    burst_n = 0;
+  }
+  if (++burst_n > cur->burst_max)
+  {
+    cur->burst_max = burst_n;
+  }
+}
+
+static void pcu_send(uint32_t id, bool lane)
+{
+  uint8_t data[8] = {0};
+  note_handoff(data);
+  if (lane)
+  {
+    FEB_CAN_TX_SendPriority(FEB_CAN_INSTANCE_1, id, FEB_CAN_ID_STD, data, 8);
+  }
+  else
+  {
+    FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, id, FEB_CAN_ID_STD, data, 8);
+  }
+}
+
+static int slot_pack(uint8_t *dst, const void *src, size_t size)
+{
+  (void)src;
+  memset(dst, 0, size);
+  note_handoff(dst);
+  return 8;
+}
+
+static void register_slots(void)
+{
+  static uint8_t slot_data[BENCH_DIAGS];
+  for (uint32_t i = 0; i < BENCH_DIAGS; i++)
+  {
+    FEB_CAN_TX_Params_t params = {
+        .instance = FEB_CAN_INSTANCE_1,
+        .can_id = diags[i].id,
+        .id_type = FEB_CAN_ID_STD,
+        .data_ptr = &slot_data[i],
+        .data_size = 8,
+        .period_ms = diags[i].period_ms,
+        .pack_func = slot_pack,
+    };
+    if (FEB_CAN_TX_Register(&params) < 0)
+    {
+      fprintf(stderr, "FEB_CAN_TX_Register failed\n");
+      exit(2);
+    }
+  }
+}
+
+/* ============================================================================
+ * Run
+ * ============================================================================ */
+
+static bench_result_t run(bench_mode_t mode, uint32_t offset_ms)
+{
+  bench_result_t r = {0};
+  cur = &r;
+  burst_ms = UINT64_MAX;
+
+  /* Start on a fresh 100 ms boundary of HAL_GetTick, then TIM1 `offset` later */
+  uint64_t start = ((now_us / 100000U) + 1U) * 100000U;
+  FEB_Host_Time_AdvanceUs(start - now_us);
+  now_us = start;
+
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+  FEB_CAN_Config_t cfg = {.hcan1 = &hcan1, .get_tick_ms = HAL_GetTick};
+  if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+  {
+    fprintf(stderr, "FEB_CAN_Init failed\n");
+    exit(2);
+  }
+  FEB_CAN_TX_ReserveMailboxes(FEB_CAN_INSTANCE_1, 1);
+  if (mode == MODE_SLOTS)
+  {
+    register_slots();
+  }
+  const FEB_CAN_Context_t *ctx = feb_can_get_context();
+
+  /* PCU share of the bus, then foreign traffic up to the target */
+  uint32_t f8 = frame_us(8);
+  double pcu_util = (double)f8 / (TORQUE_PERIOD_MS * 1000.0) + (double)f8 / 100000.0 + (double)f8 / 250000.0;
+  for (uint32_t i = 0; i < BENCH_DIAGS; i++)
+  {
+    pcu_util += (double)f8 / (diags[i].period_ms * 1000.0);
+  }
+  double foreign_gap_us = f8 / (BENCH_UTIL - pcu_util);
+
+  rng_state = BENCH_SEED;
+  uint32_t foreign[BENCH_FOREIGN_MAX];
+  uint32_t foreign_n = 0;
+  double next_arrival = -log(rng_unit()) * foreign_gap_us;
+
+  uint64_t t0 = now_us;
+  uint64_t end = t0 + (uint64_t)BENCH_DURATION_MS * 1000U;
+  uint64_t next_tick = t0 + (uint64_t)offset_ms * 1000U;
+  uint64_t next_ms = t0;
+  uint32_t tick = 0;
+  uint64_t wire_end = 0;
+  bool wire_busy = false, wire_pcu = false;
+
+  while (now_us < end)
+  {
+    /* Frame on the wire finished: ACK it and let the TX interrupt refill */
+    if (wire_busy && now_us >= wire_end)
+    {
+      wire_busy = false;
+      if (wire_pcu)
+      {
+        FEB_Host_CAN_BusStep(&hcan1);
+      }
+    }
+
+    /* 1 ms TIM1 tick: torque, and the diagnostics in the divider modes */
+    if (now_us >= next_tick)
+    {
+      FEB_Host_ISR_Enter();
+      if ((tick + 1U) % TORQUE_PERIOD_MS == 0U)
+      {
+        pcu_send(ID_M192, true);
+      }
+      if (mode != MODE_SLOTS)
+      {
+        for (uint32_t i = 0; i < BENCH_DIAGS; i++)
+        {
+          uint32_t s = (mode == MODE_DIVIDERS) ? diags[i].divider_start : 0U;
+          if ((tick + 1U + s) % diags[i].period_ms == 0U)
+          {
+            pcu_send(diags[i].id, false);
+          }
+        }
+      }
+      FEB_Host_ISR_Exit();
+      tick++;
+      next_tick += 1000U;
+    }
+
+    /* Main loop, once per HAL_GetTick millisecond: heartbeat (set by BMS RX),
+     * TPS, FEB_CAN_TX_Process and ProcessPeriodic */
+    if (now_us >= next_ms)
+    {
+      uint32_t ms = (uint32_t)((now_us - t0) / 1000U);
+      if (ms % 100U == 75U)
+      {
+        pcu_send(ID_HEARTBEAT, true);
+      }
+      if (ms % 250U == 0U)
+      {
+        pcu_send(ID_TPS, false);
+      }
+      FEB_CAN_TX_Process();
+      FEB_CAN_TX_ProcessPeriodic();
+      next_ms += 1000U;
+    }
+
+    /* Other nodes queue their frames */
+    while (next_arrival <= (double)(now_us - t0))
+    {
+      uint32_t id = (rng_unit() < BENCH_HI_PRIO_SHARE)
+                        ? hi_prio_ids[rng_next() % (sizeof(hi_prio_ids) / sizeof(hi_prio_ids[0]))]
+                        : 0x100U + rng_next() % 0x600U;
+      if (foreign_n < BENCH_FOREIGN_MAX)
+      {
+        foreign[foreign_n++] = id;
+      }
+      next_arrival += -log(rng_unit()) * foreign_gap_us;
+    }
+
+    /* Bus idle: lowest pending ID wins */
+    if (!wire_busy)
+    {
+      FEB_Host_CAN_Frame_t pcu;
+      bool have_pcu = FEB_Host_CAN_BusBegin(&hcan1, &pcu);
+      uint32_t best = 0;
+      for (uint32_t i = 1; i < foreign_n; i++)
+      {
+        if (foreign[i] < foreign[best])
+        {
+          best = i;
+        }
+      }
+
+      if (have_pcu && (foreign_n == 0U || pcu.id < foreign[best]))
+      {
+        wire_busy = true;
+        wire_pcu = true;
+        wire_end = now_us + frame_us(pcu.dlc);
+        uint16_t s = (uint16_t)(pcu.data[6] | (pcu.data[7] << 8));
+        uint32_t queued = (uint32_t)now_us - send_us[s];
+        uint32_t *worst = (pcu.id == ID_M192) ? &r.m192_queue_max_us : &r.telemetry_queue_max_us;
+        if (queued > *worst)
+        {
+          *worst = queued;
+        }
+      }
+      else if (foreign_n > 0U)
+      {
+        foreign[best] = foreign[--foreign_n];
+        wire_busy = true;
+        wire_pcu = false;
+        wire_end = now_us + f8;
+      }
+    }
+
+    /* Occupancy holds until the next event */
+    uint32_t mbox = FEB_Host_CAN_PendingMailboxes(&hcan1);
+    if (mbox > r.mbox_peak)
+    {
+      r.mbox_peak = mbox;
+    }
+    if (ctx->tx_ring_count[FEB_CAN_INSTANCE_1] > r.fifo_peak)
+    {
+      r.fifo_peak = ctx->tx_ring_count[FEB_CAN_INSTANCE_1];
+    }
+
+    uint64_t next = next_tick < next_ms ? next_tick : next_ms;
+    uint64_t arrival = t0 + (uint64_t)ceil(next_arrival);
+    if (arrival < next)
+    {
+      next = arrival;
+    }
+    if (wire_busy && wire_end < next)
+    {
+      next = wire_end;
+    }
+    if (next <= now_us)
+    {
+      next = now_us + 1U;
+    }
+    if (mbox >= BENCH_MAILBOXES)
+    {
+      r.full_us += next - now_us;
+    }
+    FEB_Host_Time_AdvanceUs(next - now_us);
+    now_us = next;
+  }
+
+  /* Let the last frames finish so the next run starts from idle mailboxes */
+  FEB_Host_CAN_BusFlush(&hcan1);
+  FEB_CAN_DeInit();
+  return r;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  FEB_Host_Time_UseVirtual(true);
+  now_us = FEB_Host_Time_Ns() / 1000U;
+
+  printf("mode,offsets,burst_max,mbox_peak,full_us_max,fifo_peak,telemetry_queue_max_us,m192_queue_max_us\n");
+
+  bench_result_t worst[MODE_COUNT];
+  memset(worst, 0, sizeof(worst));
+  for (uint32_t m = 0; m < MODE_COUNT; m++)
+  {
+    bench_result_t *w = &worst[m];
+    for (uint32_t off = 0; off < BENCH_OFFSETS; off++)
+    {
+      bench_result_t r = run((bench_mode_t)m, off);
+      w->burst_max = r.burst_max > w->burst_max ? r.burst_max : w->burst_max;
+      w->mbox_peak = r.mbox_peak > w->mbox_peak ? r.mbox_peak : w->mbox_peak;
+      w->full_us = r.full_us > w->full_us ? r.full_us : w->full_us;
+      w->fifo_peak = r.fifo_peak > w->fifo_peak ? r.fifo_peak : w->fifo_peak;
+      w->telemetry_queue_max_us =
+          r.telemetry_queue_max_us > w->telemetry_queue_max_us ? r.telemetry_queue_max_us : w->telemetry_queue_max_us;
+      w->m192_queue_max_us = r.m192_queue_max_us > w->m192_queue_max_us ? r.m192_queue_max_us : w->m192_queue_max_us;
+    }
+    printf("%s,%u,%u,%u,%llu,%u,%u,%u\n", mode_names[m], BENCH_OFFSETS, w->burst_max, w->mbox_peak,
+           (unsigned long long)w->full_us, w->fifo_peak, w->telemetry_queue_max_us, w->m192_queue_max_us);
+  }
+
+  const bench_result_t *d = &worst[MODE_DIVIDERS], *s = &worst[MODE_SLOTS];
+  fprintf(stderr,
+          "worst over %u TIM1 offsets: burst %u (aligned) / %u (dividers) -> %u (slots) frames/ms, "
+          "all-mailboxes-busy %llu -> %llu us, M192 queueing %u -> %u us\n",
+          BENCH_OFFSETS, worst[MODE_ALIGNED].burst_max, d->burst_max, s->burst_max, (unsigned long long)d->full_us,
+          (unsigned long long)s->full_us, d->m192_queue_max_us, s->m192_queue_max_us);
+
+  return (s->burst_max > d->burst_max || s->mbox_peak > d->mbox_peak || s->full_us > d->full_us) ? 1 : 0;
+}
@@ -0,0 +1,535 @@
+/**
+ ******************************************************************************
+ * @file           : pcu_limits_bench.c
+ * @brief          : Torque limits: float reference vs FEB_RMS_Limits fixed point
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Holds the former float implementations of FEB_Get_Peak_Current_Delimiter(),
+ * FEB_RMS_GetMaxTorque() and FEB_Regen_GetElecMaxRegenTorque() (warnings
+ * replaced by flags), reading the same simulated IVT/RMS/BMS getters the
+ * firmware does, and checks the real FEB_RMS_Limits.c against them:
+ *
+ *   equivalence - every pack voltage 0..600 V in 0.25 V steps, every motor
+ *                 speed -200..7000 rpm (1 rpm steps up to 400), for each
+ *                 combination of IVT fresh / RMS only / no data, R_pack
+ *                 stale / clamped / in range, and IVT current below and above
+ *                 IVT_CURRENT_LIMIT_A.
+ *   timing      - both paths over the same 4096 drive-like inputs; the fixed
+ *                 path includes the input snapshot FEB_RMS.c takes.
+ *
+ * The fixed-point path rounds toward less torque, so it may read below the
+ * float path by up to BENCH_MAX_UNDER but never above it (beyond float
+ * rounding, BENCH_OVER_EPS). The warning flags must match exactly.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted;
+ * compare the columns with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `limit,points,over,max_under,max_under_pct,flag_mismatches,float_ns,fixed_ns`
+ * stderr: summary. Exit status 1 on any overshoot, excess undershoot or
+ * flag mismatch. max_under_pct is taken over limits of at least 10; the
+ * current row has no timing (nothing calls the delimiter on its own now).
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_RMS_Config.h"
+#include "FEB_RMS_Limits.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_V_STEP 0.25f       /* Pack voltage sweep step (V) */
+#define BENCH_V_MAX 600.0f       /* Pack voltage sweep end (V) */
+#define BENCH_RPM_MIN (-200)     /* Motor speed sweep start */
+#define BENCH_RPM_FINE_END 400   /* 1 rpm steps up to here (covers both thresholds) */
+#define BENCH_RPM_MAX 7000       /* Motor speed sweep end */
+#define BENCH_RPM_COARSE_STEP 7  /* Step above BENCH_RPM_FINE_END */
+#define BENCH_OVER_EPS 1e-5      /* Relative float rounding allowed above the reference */
+#define BENCH_MAX_UNDER 0.001     /* Relative undershoot allowed (0.1 %) ... */
+#define BENCH_MAX_UNDER_ABS 0.025 /* ... or 2.5 steps of the 0.01 output, whichever is larger */
+#define BENCH_TIMING_INPUTS 4096U
+#define BENCH_TIMING_REPS 500U
+
+/* Flags the reference sets where it used to log */
+#define REF_FLAG_NO_VOLTAGE RMS_LIMITS_FLAG_NO_VOLTAGE
+#define REF_FLAG_CURRENT_FLOOR RMS_LIMITS_FLAG_CURRENT_FLOOR
+#define REF_FLAG_LOW_PACK RMS_LIMITS_FLAG_LOW_PACK
+#define REF_FLAG_IVT_OVERCURRENT RMS_LIMITS_FLAG_IVT_OVERCURRENT
+
+#define min(x1, x2) (((x1) < (x2)) ? (x1) : (x2))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+
+/* ============================================================================
+ * Simulated getters
+ * ============================================================================ */
+
+#define SIM_IVT_TIMEOUT_MS 1000U /* FEB_CAN_IVT_DATA_TIMEOUT_MS */
+#define SIM_BMS_TIMEOUT_MS 1000U
+
+static struct
+{
+  uint32_t tick;
+  uint32_t ivt_last_rx; /* 0 = never */
+  float ivt_voltage_v;
+  float ivt_current_a;
+  uint32_t rms_last_rx; /* 0 = never */
+  float rms_dc_bus_v;
+  int16_t motor_speed_rpm;
+  uint32_t bms_soc_rx; /* 0 = never */
+  bool r_converged;
+  float r_pack_ohm;
+} sim;
+
+/* Out of line, like the firmware getters in FEB_CAN_IVT.c / FEB_CAN_BMS.c */
+__attribute__((noinline)) static uint32_t sim_get_tick(void)
+{
+  return sim.tick;
+}
+
+__attribute__((noinline)) static bool sim_ivt_is_fresh(uint32_t timeout_ms)
+{
+  if (sim.ivt_last_rx == 0)
+  {
+    return false;
+  }
+  return (sim_get_tick() - sim.ivt_last_rx) < timeout_ms;
+}
+
+__attribute__((noinline)) static float sim_ivt_get_voltage(void)
+{
+  return sim_ivt_is_fresh(SIM_IVT_TIMEOUT_MS) ? sim.ivt_voltage_v : 0.0f;
+}
+
+__attribute__((noinline)) static float sim_ivt_get_current(void)
+{
+  return sim_ivt_is_fresh(SIM_IVT_TIMEOUT_MS) ? sim.ivt_current_a : 0.0f;
+}
+
+__attribute__((noinline)) static bool sim_bms_r_fresh(void)
+{
+  return sim.bms_soc_rx != 0 && (sim_get_tick() - sim.bms_soc_rx <= SIM_BMS_TIMEOUT_MS) && sim.r_converged;
+}
+
+__attribute__((noinline)) static float sim_bms_get_r(void)
+{
+  return sim.r_pack_ohm;
+}
+
+/* ============================================================================
+ * Former float path (FEB_RMS.c / FEB_Regen.c), logs replaced by flags
+ * ============================================================================ */
+
+static uint8_t ref_flags;
+
+static float ref_peak_current_delimiter(void)
+{
+  float accumulator_voltage;
+  if (sim_ivt_is_fresh(SIM_IVT_TIMEOUT_MS))
+  {
+    accumulator_voltage = sim_ivt_get_voltage();
+  }
+  else if (sim.rms_last_rx != 0)
+  {
+    accumulator_voltage = sim.rms_dc_bus_v;
+  }
+  else
+  {
+    ref_flags |= REF_FLAG_NO_VOLTAGE;
+    return 1.0f;
+  }
+
+  float r_acc = ACCUMULATOR_RESISTANCE_OHM;
+  if (sim_bms_r_fresh())
+  {
+    r_acc = sim_bms_get_r();
+    if (r_acc < ACCUMULATOR_RESISTANCE_MIN_OHM)
+    {
+      r_acc = ACCUMULATOR_RESISTANCE_MIN_OHM;
+    }
+    else if (r_acc > ACCUMULATOR_RESISTANCE_MAX_OHM)
+    {
+      r_acc = ACCUMULATOR_RESISTANCE_MAX_OHM;
+    }
+  }
+  float start_derating_voltage = MIN_PACK_VOLTAGE_V + PEAK_CURRENT * r_acc;
+
+  if (accumulator_voltage > start_derating_voltage)
+  {
+    return 1.0f;
+  }
+
+  if (accumulator_voltage <= 410.0f)
+  {
+    ref_flags |= REF_FLAG_CURRENT_FLOOR;
+    return (10.0f / PEAK_CURRENT);
+  }
+
+  float slope = ((10.0f / PEAK_CURRENT) - 1.0f) / (410.0f - start_derating_voltage);
+  float derater = slope * (accumulator_voltage - start_derating_voltage) + 1.0f;
+
+  return derater;
+}
+
+static float ref_get_max_torque(void)
+{
+  float motor_speed = sim.motor_speed_rpm * RPM_TO_RAD_S;
+  float peak_current_limited = PEAK_CURRENT * ref_peak_current_delimiter();
+
+  bool ivt_fresh = sim_ivt_is_fresh(SIM_IVT_TIMEOUT_MS);
+  float pack_voltage_v = ivt_fresh ? sim_ivt_get_voltage() : MIN_PACK_VOLTAGE_V;
+
+  float power_capped = peak_current_limited * pack_voltage_v;
+
+  uint16_t minimum_torque = MAX_TORQUE;
+  if (ivt_fresh && sim_ivt_get_voltage() < LOW_PACK_VOLTAGE_V)
+  {
+    minimum_torque = MAX_TORQUE_LOW_V;
+    ref_flags |= REF_FLAG_LOW_PACK;
+  }
+
+  float maxTorque;
+  if (motor_speed < MIN_MOTOR_SPEED_RAD_S)
+  {
+    maxTorque = (float)minimum_torque;
+  }
+  else
+  {
+    maxTorque = min((float)minimum_torque, (power_capped) / motor_speed);
+  }
+
+  if (ivt_fresh)
+  {
+    float ivt_current = fabsf(sim_ivt_get_current());
+    if (ivt_current > IVT_CURRENT_LIMIT_A)
+    {
+      maxTorque *= (IVT_CURRENT_LIMIT_A / ivt_current);
+      ref_flags |= REF_FLAG_IVT_OVERCURRENT;
+    }
+  }
+
+  return maxTorque;
+}
+
+static float ref_regen_max_torque(void)
+{
+  float accumulator_voltage = MIN(INIT_VOLTAGE / 10.0f, sim.rms_dc_bus_v);
+  float motor_speed_rads = sim.motor_speed_rpm * RPM_TO_RAD_S;
+  if (motor_speed_rads < 1.0f)
+  {
+    return 0.0f;
+  }
+  return MIN(MAX_TORQUE_REGEN, (accumulator_voltage * PEAK_CURRENT_REGEN) / motor_speed_rads);
+}
+
+/* ============================================================================
+ * Fixed-point path, as wired in FEB_RMS.c / FEB_Regen.c
+ * ============================================================================ */
+
+static void fixed_drive(FEB_RMS_Limits_Drive_t *out)
+{
+  FEB_RMS_Limits_Input_t in;
+  in.ivt_fresh = sim_ivt_is_fresh(SIM_IVT_TIMEOUT_MS);
+  in.ivt_voltage_v = in.ivt_fresh ? sim_ivt_get_voltage() : 0.0f;
+  in.ivt_current_a = in.ivt_fresh ? sim_ivt_get_current() : 0.0f;
+  in.rms_seen = sim.rms_last_rx != 0;
+  in.rms_dc_bus_v = sim.rms_dc_bus_v;
+  in.r_pack_fresh = sim_bms_r_fresh();
+  in.r_pack_ohm = in.r_pack_fresh ? sim_bms_get_r() : 0.0f;
+  in.motor_speed_rpm = sim.motor_speed_rpm;
+  FEB_RMS_Limits_Drive(&in, out);
+}
+
+static float fixed_get_max_torque(void)
+{
+  FEB_RMS_Limits_Drive_t limits;
+  fixed_drive(&limits);
+  return (float)limits.max_torque_c * 0.01f;
+}
+
+static float fixed_regen_max_torque(void)
+{
+  return (float)FEB_RMS_Limits_Regen(sim.rms_dc_bus_v, sim.motor_speed_rpm) * 0.01f;
+}
+
+/* ============================================================================
+ * Equivalence
+ * ============================================================================ */
+
+typedef struct
+{
+  uint64_t points;
+  uint64_t over;
+  uint64_t excess_under;
+  uint64_t flag_mismatches;
+  double max_under;
+  double max_under_rel;
+  double float_ns;
+  double fixed_ns;
+} bench_result_t;
+
+static void compare(bench_result_t *r, double ref, double fixed)
+{
+  r->points++;
+  double mag = fabs(ref);
+  if (fixed > ref + BENCH_OVER_EPS * mag)
+  {
+    r->over++;
+    if (r->over <= 5U)
+    {
+      fprintf(stderr, "over: ref %.6f fixed %.6f (V %.2f rpm %d)\n", ref, fixed,
+              (double)(sim.ivt_last_rx ? sim.ivt_voltage_v : sim.rms_dc_bus_v), sim.motor_speed_rpm);
+    }
+  }
+  double under = ref - fixed;
+  if (under > r->max_under)
+  {
+    r->max_under = under;
+  }
+  if (mag >= 10.0 && under / mag > r->max_under_rel)
+  {
+    r->max_under_rel = under / mag;
+  }
+  if (under > BENCH_MAX_UNDER * mag && under > BENCH_MAX_UNDER_ABS)
+  {
+    r->excess_under++;
+  }
+}
+
+typedef enum
+{
+  SRC_IVT,
+  SRC_RMS_ONLY,
+  SRC_NONE,
+  SRC_COUNT
+} bench_source_t;
+
+static const float r_cases[] = {-1.0f /* stale */, 0.1f, 0.42f, 0.6f, 1.0f, 1.37f, 2.0f, 3.5f};
+static const float i_cases[] = {0.0f, 59.99f, 60.01f, -85.0f, 240.0f};
+
+static int16_t next_rpm(int32_t rpm)
+{
+  return (int16_t)(rpm < BENCH_RPM_FINE_END ? rpm + 1 : rpm + BENCH_RPM_COARSE_STEP);
+}
+
+static void check_drive(bench_result_t *drive, bench_result_t *current)
+{
+  sim.tick = 100000U;
+  for (uint32_t src = 0; src < SRC_COUNT; src++)
+  {
+    for (uint32_t ri = 0; ri < sizeof(r_cases) / sizeof(r_cases[0]); ri++)
+    {
+      for (uint32_t ii = 0; ii < sizeof(i_cases) / sizeof(i_cases[0]); ii++)
+      {
+        /* Current only matters with a fresh IVT */
+        if (src != SRC_IVT && ii > 0)
+        {
+          continue;
+        }
+        sim.ivt_last_rx = (src == SRC_IVT) ? sim.tick - 10U : 0;
+        sim.rms_last_rx = (src != SRC_NONE) ? sim.tick - 10U : 0;
+        sim.bms_soc_rx = (r_cases[ri] >= 0.0f) ? sim.tick - 10U : 0;
+        sim.r_converged = true;
+        sim.r_pack_ohm = r_cases[ri];
+        sim.ivt_current_a = i_cases[ii];
+
+        for (float v = 0.0f; v <= BENCH_V_MAX; v += BENCH_V_STEP)
+        {
+          sim.ivt_voltage_v = v;
+          sim.rms_dc_bus_v = v;
+
+          ref_flags = 0;
+          float ref_delim = ref_peak_current_delimiter();
+          FEB_RMS_Limits_Drive_t limits;
+          fixed_drive(&limits);
+          compare(current, ref_delim * PEAK_CURRENT, limits.peak_current_ma * 0.001);
+
+          for (int32_t rpm = BENCH_RPM_MIN; rpm <= BENCH_RPM_MAX; rpm = next_rpm(rpm))
+          {
+            sim.motor_speed_rpm = (int16_t)rpm;
+            ref_flags = 0;
+            float ref = ref_get_max_torque();
+            fixed_drive(&limits);
+            compare(drive, ref, limits.max_torque_c * 0.01);
+            if (limits.flags != ref_flags)
+            {
+              drive->flag_mismatches++;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+static void check_regen(bench_result_t *regen)
+{
+  for (float v = -10.0f; v <= BENCH_V_MAX; v += BENCH_V_STEP)
+  {
+    sim.rms_dc_bus_v = v;
+    for (int32_t rpm = BENCH_RPM_MIN; rpm <= BENCH_RPM_MAX; rpm = next_rpm(rpm))
+    {
+      sim.motor_speed_rpm = (int16_t)rpm;
+      float ref = ref_regen_max_torque();
+      /* A negative bus reading gave a negative "limit" before; the fixed path
+       * returns 0. Only the physical range is compared. */
+      if (v < 0.0f)
+      {
+        if (fixed_regen_max_torque() != 0.0f)
+        {
+          regen->over++;
+        }
+        continue;
+      }
+      compare(regen, ref, fixed_regen_max_torque());
+    }
+  }
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+typedef struct
+{
+  float voltage_v;
+  float current_a;
+  int16_t rpm;
+} timing_input_t;
+
+static timing_input_t timing_inputs[BENCH_TIMING_INPUTS];
+static volatile float sink;
+
+typedef float (*limit_fn_t)(void);
+
+static double time_limit(limit_fn_t fn)
+{
+  uint64_t total = 0;
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    float acc = 0.0f;
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_TIMING_INPUTS; i++)
+    {
+      sim.ivt_voltage_v = timing_inputs[i].voltage_v;
+      sim.rms_dc_bus_v = timing_inputs[i].voltage_v;
+      sim.ivt_current_a = timing_inputs[i].current_a;
+      sim.motor_speed_rpm = timing_inputs[i].rpm;
+      acc += fn();
+    }
+    total += elapsed_ns(t0, now_ns());
+    sink = acc;
+  }
+  return (double)total / ((double)BENCH_TIMING_REPS * BENCH_TIMING_INPUTS);
+}
+
+/* A drive: fresh IVT and R_pack, 380..590 V, 0..6500 rpm, -20..90 A. */
+static void run_timing(bench_result_t *drive, bench_result_t *regen)
+{
+  for (uint32_t i = 0; i < BENCH_TIMING_INPUTS; i++)
+  {
+    timing_inputs[i].voltage_v = 380.0f + (float)(rng_next() % 21000U) * 0.01f;
+    timing_inputs[i].current_a = -20.0f + (float)(rng_next() % 11000U) * 0.01f;
+    timing_inputs[i].rpm = (int16_t)(rng_next() % 6500U);
+  }
+  sim.tick = 100000U;
+  sim.ivt_last_rx = sim.tick - 10U;
+  sim.rms_last_rx = sim.tick - 10U;
+  sim.bms_soc_rx = sim.tick - 10U;
+  sim.r_converged = true;
+  sim.r_pack_ohm = 0.9f;
+
+  drive->float_ns = time_limit(ref_get_max_torque);
+  drive->fixed_ns = time_limit(fixed_get_max_torque);
+  regen->float_ns = time_limit(ref_regen_max_torque);
+  regen->fixed_ns = time_limit(fixed_regen_max_torque);
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static void print_row(const char *name, const bench_result_t *r)
+{
+  printf("%s,%llu,%llu,%.4f,%.4f,%llu,", name, (unsigned long long)r->points, (unsigned long long)r->over,
+         r->max_under, r->max_under_rel * 100.0, (unsigned long long)r->flag_mismatches);
+  fprintf(stderr, "%-8s %10llu points, %llu over, max under %.4f (%.4f %%), %llu flag mismatches", name,
+          (unsigned long long)r->points, (unsigned long long)r->over, r->max_under, r->max_under_rel * 100.0,
+          (unsigned long long)r->flag_mismatches);
+  if (r->float_ns > 0)
+  {
+    printf("%.1f,%.1f\n", r->float_ns, r->fixed_ns);
+    fprintf(stderr, ", %.1f -> %.1f ns/call\n", r->float_ns, r->fixed_ns);
+  }
+  else
+  {
+    printf(",\n");
+    fprintf(stderr, "\n");
+  }
+}
+
+int main(void)
+{
+  bench_result_t drive = {0}, current = {0}, regen = {0};
+
+  check_drive(&drive, &current);
+  check_regen(&regen);
+
+  calibrate_clock();
+  run_timing(&drive, &regen);
+
+  printf("limit,points,over,max_under,max_under_pct,flag_mismatches,float_ns,fixed_ns\n");
+  print_row("drive", &drive);
+  print_row("current", &current);
+  print_row("regen", &regen);
+
+  uint64_t failures = drive.over + drive.excess_under + drive.flag_mismatches + current.over + current.excess_under +
+                      regen.over + regen.excess_under;
+  fprintf(stderr, "failures: %llu\n", (unsigned long long)failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,548 @@
+/**
+ ******************************************************************************
+ * @file           : pcu_rms_decode_bench.c
+ * @brief          : RMS RX decode: former switch vs decoder table, and torn reads
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Holds the former FEB_CAN_RMS_Callback() body (switch over the inverter IDs,
+ * generated unpack into a stack struct, copy into RMS_MESSAGE) writing into a
+ * reference copy of the state, and checks the real FEB_CAN_RMS_Decode.c
+ * against it:
+ *
+ *   equivalence - a random stream of 8-byte frames over every ID the PCU
+ *                 subscribes to (0x0A0..0x0AF, 0x0C2) plus a few it does not;
+ *                 after each frame RMS_MESSAGE and RMS_FRAMES must match the
+ *                 reference byte for byte.
+ *   timing      - both decoders per ID over random payloads, and over the
+ *                 shuffled mix, in ns per frame. The table path includes the
+ *                 seqlock's two barriers; barrier_ns is their cost alone.
+ *                 On the host each is a full fence, on the Cortex-M4 a DMB
+ *                 of a few cycles, so compare switch_ns with
+ *                 table_ns - barrier_ns for the decode itself.
+ *   stress      - a writer thread (bracketed as an ISR) alternates M165 with
+ *                 speed k and M167 with DC bus k/10 V, ticks 2k-1 and 2k. The
+ *                 main thread reads FEB_CAN_RMS_GetFeedback() and, for
+ *                 comparison, the three RMS_MESSAGE fields directly, as
+ *                 FEB_RMS.c did. A read is torn unless it is one of the two
+ *                 states that exist between frames: (k, k, 2k) or
+ *                 (k, k-1, 2k-1).
+ *
+ * Needs the generated CAN library (FEB_CAN_GEN_DIR); see CMakeLists.txt.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted;
+ * compare the columns with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `frame,frames,mismatches,switch_ns,table_ns,barrier_ns`, then
+ *         `stress,reads,frames_written,feedback_torn,direct_torn`
+ * stderr: summary. Exit status 1 on any mismatch or any torn feedback read.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_CAN_RMS.h"
+#include "feb_host.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_EQUIV_FRAMES 200000U
+#define BENCH_TIMING_FRAMES 4096U
+#define BENCH_TIMING_REPS 200U
+#define BENCH_STRESS_READS 20000000U
+#define BENCH_STRESS_K_MAX 16383 /* k cycles 1..K_MAX; k / 10.0f round-trips */
+
+/* IDs the RX filters pass, then ones the decoder must ignore */
+static const uint32_t bench_ids[] = {0x0A0u, 0x0A1u, 0x0A2u, 0x0A3u, 0x0A4u, 0x0A5u, 0x0A6u, 0x0A7u, 0x0A8u,
+                                     0x0A9u, 0x0AAu, 0x0ABu, 0x0ACu, 0x0ADu, 0x0AEu, 0x0AFu, 0x0C2u};
+#define BENCH_RMS_IDS (sizeof(bench_ids) / sizeof(bench_ids[0]))
+static const uint32_t bench_foreign_ids[] = {0x09Fu, 0x0B0u, 0x0C0u, 0x0C1u, 0x0C3u};
+#define BENCH_FOREIGN_IDS (sizeof(bench_foreign_ids) / sizeof(bench_foreign_ids[0]))
+
+/* ============================================================================
+ * Reference: the former switch decoder
+ * ============================================================================ */
+
+static RMS_MESSAGE_TYPE ref;
+static RMS_Frame_Record_t ref_frames[FEB_CAN_RMS_FRAME_TABLE_SIZE];
+
+static void ref_capture_raw(uint32_t can_id, const uint8_t *data, uint8_t length, uint32_t tick)
+{
+  int idx = -1;
+  if (can_id >= FEB_CAN_RMS_FRAME_BASE_ID && can_id < FEB_CAN_RMS_FRAME_BASE_ID + FEB_CAN_RMS_FRAME_BLOCK_N)
+    idx = (int)(can_id - FEB_CAN_RMS_FRAME_BASE_ID);
+  else if (can_id == FEB_CAN_M194_READ_WRITE_PARAM_RESPONSE_FRAME_ID)
+    idx = FEB_CAN_RMS_FRAME_PARAM_RESP_IDX;
+
+  if (idx < 0)
+    return;
+
+  RMS_Frame_Record_t *rec = &ref_frames[idx];
+  uint8_t n = (length > 8u) ? 8u : length;
+  for (uint8_t i = 0; i < n; i++)
+    rec->data[i] = data[i];
+  for (uint8_t i = n; i < 8u; i++)
+    rec->data[i] = 0;
+  rec->dlc = length;
+  rec->count++;
+  rec->last_rx_tick = tick;
+  rec->seen = 1u;
+}
+
+static void ref_decode(uint32_t can_id, const uint8_t *data, uint8_t length, uint32_t tick)
+{
+  ref.last_rx_timestamp = tick;
+  ref_capture_raw(can_id, data, length, tick);
+
+  switch (can_id)
+  {
+  case FEB_CAN_M160_TEMPERATURE_SET_1_FRAME_ID:
+  {
+    struct feb_can_m160_temperature_set_1_t m160;
+    feb_can_m160_temperature_set_1_unpack(&m160, data, length);
+    ref.temp_module_a = m160.inv_module_a;
+    ref.temp_module_b = m160.inv_module_b;
+    ref.temp_module_c = m160.inv_module_c;
+    ref.temp_gate_driver = m160.inv_gate_driver_board;
+    ref.temps_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M161_TEMPERATURE_SET_2_FRAME_ID:
+  {
+    struct feb_can_m161_temperature_set_2_t m161;
+    feb_can_m161_temperature_set_2_unpack(&m161, data, length);
+    ref.temp_control_board = m161.inv_control_board_temperature;
+    ref.temp_rtd1 = m161.inv_rtd1_temperature;
+    ref.temp_rtd2 = m161.inv_rtd2_temperature;
+    ref.temp_rtd3 = m161.inv_rtd3_temperature;
+    ref.temps_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M162_TEMPERATURE_SET_3_FRAME_ID:
+  {
+    struct feb_can_m162_temperature_set_3_t m162;
+    feb_can_m162_temperature_set_3_unpack(&m162, data, length);
+    ref.temp_rtd4 = m162.inv_rtd4_temperature;
+    ref.temp_rtd5 = m162.inv_rtd5_temperature;
+    ref.temp_motor = m162.inv_motor_temperature;
+    ref.torque_shudder = m162.inv_torque_shudder;
+    ref.temps_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_ID_RMS_MOTOR:
+  {
+    struct feb_can_m165_motor_position_info_t m165;
+    feb_can_m165_motor_position_info_unpack(&m165, data, length);
+    ref.Motor_Speed = m165.inv_motor_speed;
+    ref.Motor_Angle = (int16_t)m165.inv_motor_angle_electrical;
+    ref.electrical_freq = m165.inv_electrical_output_frequency;
+    break;
+  }
+  case FEB_CAN_M166_CURRENT_INFO_FRAME_ID:
+  {
+    struct feb_can_m166_current_info_t m166;
+    feb_can_m166_current_info_unpack(&m166, data, length);
+    ref.phase_a_current = m166.inv_phase_a_current;
+    ref.phase_b_current = m166.inv_phase_b_current;
+    ref.phase_c_current = m166.inv_phase_c_current;
+    ref.dc_bus_current = m166.inv_dc_bus_current;
+    ref.current_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_ID_RMS_VOLTAGE:
+  {
+    struct feb_can_m167_voltage_info_t m167;
+    feb_can_m167_voltage_info_unpack(&m167, data, length);
+    ref.HV_Bus_Voltage = m167.inv_dc_bus_voltage;
+    ref.DC_Bus_Voltage_V = m167.inv_dc_bus_voltage / 10.0f;
+    ref.output_voltage = m167.inv_output_voltage;
+    ref.vab_vd_voltage = m167.inv_vab_vd_voltage;
+    ref.vbc_voltage = m167.inv_vbc_vq_voltage;
+    break;
+  }
+  case FEB_CAN_ID_RMS_STATES:
+  {
+    struct feb_can_m170_internal_states_t m170;
+    feb_can_m170_internal_states_unpack(&m170, data, length);
+    ref.vsm_state = m170.inv_vsm_state;
+    ref.inverter_state = m170.inv_inverter_state;
+    ref.enable_state = m170.inv_inverter_enable_state;
+    ref.enable_lockout = m170.inv_inverter_enable_lockout;
+    ref.command_mode = m170.inv_inverter_command_mode;
+    ref.echo_rolling_counter = m170.inv_rolling_counter;
+    ref.pwm_frequency = m170.inv_pwm_frequency;
+    ref.relay_status = (uint8_t)((m170.inv_relay_1_status & 1u) | ((m170.inv_relay_2_status & 1u) << 1) |
+                                 ((m170.inv_relay_3_status & 1u) << 2) | ((m170.inv_relay_4_status & 1u) << 3) |
+                                 ((m170.inv_relay_5_status & 1u) << 4) | ((m170.inv_relay_6_status & 1u) << 5));
+    ref.discharge_state = m170.inv_inverter_discharge_state;
+    ref.run_mode = m170.inv_inverter_run_mode;
+    ref.direction_command = m170.inv_direction_command;
+    ref.bms_active = m170.inv_bms_active;
+    ref.start_mode_active = m170.inv_start_mode_active;
+    ref.bms_torque_limiting = m170.inv_bms_torque_limiting;
+    ref.max_speed_limiting = m170.inv_max_speed_limiting;
+    ref.low_speed_limiting = m170.inv_low_speed_limiting;
+    ref.states_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_ID_RMS_FAULTS:
+  {
+    struct feb_can_m171_fault_codes_t m171;
+    feb_can_m171_fault_codes_unpack(&m171, data, length);
+    ref.post_fault_lo = m171.inv_post_fault_lo;
+    ref.post_fault_hi = m171.inv_post_fault_hi;
+    ref.run_fault_lo = m171.inv_run_fault_lo;
+    ref.run_fault_hi = m171.inv_run_fault_hi;
+    ref.faults_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M172_TORQUE_AND_TIMER_INFO_FRAME_ID:
+  {
+    struct feb_can_m172_torque_and_timer_info_t m172;
+    feb_can_m172_torque_and_timer_info_unpack(&m172, data, length);
+    ref.inv_commanded_torque = m172.inv_commanded_torque;
+    ref.Torque_Feedback = m172.inv_torque_feedback;
+    ref.power_on_timer = m172.inv_power_on_timer;
+    ref.torque_timer_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M163_ANALOG_INPUT_VOLTAGES_FRAME_ID:
+  {
+    struct feb_can_m163_analog_input_voltages_t m163;
+    feb_can_m163_analog_input_voltages_unpack(&m163, data, length);
+    ref.analog_in[0] = m163.inv_analog_input_1;
+    ref.analog_in[1] = m163.inv_analog_input_2;
+    ref.analog_in[2] = m163.inv_analog_input_3;
+    ref.analog_in[3] = m163.inv_analog_input_4;
+    ref.analog_in[4] = m163.inv_analog_input_5;
+    ref.analog_in[5] = m163.inv_analog_input_6;
+    ref.analog_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M164_DIGITAL_INPUT_STATUS_FRAME_ID:
+  {
+    struct feb_can_m164_digital_input_status_t m164;
+    feb_can_m164_digital_input_status_unpack(&m164, data, length);
+    ref.digital_in = (uint8_t)((m164.inv_digital_input_1 & 1u) | ((m164.inv_digital_input_2 & 1u) << 1) |
+                               ((m164.inv_digital_input_3 & 1u) << 2) | ((m164.inv_digital_input_4 & 1u) << 3) |
+                               ((m164.inv_digital_input_5 & 1u) << 4) | ((m164.inv_digital_input_6 & 1u) << 5) |
+                               ((m164.inv_digital_input_7 & 1u) << 6) | ((m164.inv_digital_input_8 & 1u) << 7));
+    ref.digital_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M168_FLUX_ID_IQ_INFO_FRAME_ID:
+  {
+    struct feb_can_m168_flux_id_iq_info_t m168;
+    feb_can_m168_flux_id_iq_info_unpack(&m168, data, length);
+    ref.flux_command = m168.inv_flux_command;
+    ref.flux_feedback = m168.inv_flux_feedback;
+    ref.i_d = m168.inv_id;
+    ref.i_q = m168.inv_iq;
+    ref.flux_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M169_INTERNAL_VOLTAGES_FRAME_ID:
+  {
+    struct feb_can_m169_internal_voltages_t m169;
+    feb_can_m169_internal_voltages_unpack(&m169, data, length);
+    ref.ref_voltage_1_5 = m169.inv_reference_voltage_1_5;
+    ref.ref_voltage_2_5 = m169.inv_reference_voltage_2_5;
+    ref.ref_voltage_5_0 = m169.inv_reference_voltage_5_0;
+    ref.ref_voltage_12_0 = m169.inv_reference_voltage_12_0;
+    ref.intv_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M173_MODULATION_AND_FLUX_INFO_FRAME_ID:
+  {
+    struct feb_can_m173_modulation_and_flux_info_t m173;
+    feb_can_m173_modulation_and_flux_info_unpack(&m173, data, length);
+    ref.modulation_index = m173.inv_modulation_index;
+    ref.flux_weakening_output = m173.inv_flux_weakening_output;
+    ref.id_command = m173.inv_id_command;
+    ref.iq_command = m173.inv_iq_command;
+    ref.mod_rx_timestamp = tick;
+    break;
+  }
+  case FEB_CAN_M174_FIRMWARE_INFO_FRAME_ID:
+  {
+    struct feb_can_m174_firmware_info_t m174;
+    feb_can_m174_firmware_info_unpack(&m174, data, length);
+    ref.fw_eeprom_version = m174.inv_project_code_eep_ver;
+    ref.fw_sw_version = m174.inv_sw_version;
+    ref.fw_date_mmdd = m174.inv_date_code_mmdd;
+    ref.fw_date_yyyy = m174.inv_date_code_yyyy;
+    ref.fw_rx_timestamp = tick;
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+/* ============================================================================
+ * Equivalence
+ * ============================================================================ */
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static void random_payload(uint8_t *data)
+{
+  for (uint32_t i = 0; i < 8u; i++)
+    data[i] = (uint8_t)rng_next();
+}
+
+static uint64_t check_equivalence(uint64_t *frames)
+{
+  memset(&RMS_MESSAGE, 0, sizeof(RMS_MESSAGE));
+  memset(RMS_FRAMES, 0, sizeof(RMS_FRAMES));
+  memset(&ref, 0, sizeof(ref));
+  memset(ref_frames, 0, sizeof(ref_frames));
+
+  uint64_t mismatches = 0;
+  for (uint32_t n = 0; n < BENCH_EQUIV_FRAMES; n++)
+  {
+    uint32_t pick = rng_next() % (BENCH_RMS_IDS + 1u);
+    uint32_t id = (pick < BENCH_RMS_IDS) ? bench_ids[pick] : bench_foreign_ids[rng_next() % BENCH_FOREIGN_IDS];
+    uint8_t data[8];
+    random_payload(data);
+    uint32_t tick = n + 1u;
+
+    ref_decode(id, data, 8u, tick);
+    FEB_CAN_RMS_Decode(id, data, 8u, tick);
+
+    if (memcmp(&ref, &RMS_MESSAGE, sizeof(ref)) != 0 || memcmp(ref_frames, RMS_FRAMES, sizeof(ref_frames)) != 0)
+    {
+      if (mismatches == 0)
+        fprintf(stderr, "first mismatch: frame %u, id 0x%03X\n", (unsigned)n, (unsigned)id);
+      mismatches++;
+      memcpy(&ref, &RMS_MESSAGE, sizeof(ref));
+      memcpy(ref_frames, RMS_FRAMES, sizeof(ref_frames));
+    }
+  }
+  *frames = BENCH_EQUIV_FRAMES;
+  return mismatches;
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static uint64_t elapsed_ns(uint64_t t0, uint64_t t1)
+{
+  uint64_t d = t1 - t0;
+  return d > clock_overhead_ns ? d - clock_overhead_ns : 0;
+}
+
+typedef struct
+{
+  uint32_t id;
+  uint8_t data[8];
+} timing_frame_t;
+
+static timing_frame_t timing_frames[BENCH_TIMING_FRAMES];
+
+typedef void (*decode_fn_t)(uint32_t can_id, const uint8_t *data, uint8_t length, uint32_t tick);
+
+static double time_decode(decode_fn_t fn)
+{
+  uint64_t total = 0;
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_TIMING_FRAMES; i++)
+      fn(timing_frames[i].id, timing_frames[i].data, 8u, i);
+    total += elapsed_ns(t0, now_ns());
+  }
+  return (double)total / ((double)BENCH_TIMING_REPS * BENCH_TIMING_FRAMES);
+}
+
+/* The seqlock's publish step on its own, as in FEB_CAN_RMS_Decode() */
+static double time_barriers(void)
+{
+  static volatile uint32_t seq;
+  uint64_t total = 0;
+  for (uint32_t rep = 0; rep < BENCH_TIMING_REPS; rep++)
+  {
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_TIMING_FRAMES; i++)
+    {
+      seq++;
+      __DMB();
+      __DMB();
+      seq++;
+    }
+    total += elapsed_ns(t0, now_ns());
+  }
+  return (double)total / ((double)BENCH_TIMING_REPS * BENCH_TIMING_FRAMES);
+}
+
+/* id 0 = the shuffled mix of every RMS ID */
+static void fill_timing_frames(uint32_t id)
+{
+  for (uint32_t i = 0; i < BENCH_TIMING_FRAMES; i++)
+  {
+    timing_frames[i].id = id ? id : bench_ids[rng_next() % BENCH_RMS_IDS];
+    random_payload(timing_frames[i].data);
+  }
+}
+
+/* ============================================================================
+ * Stress
+ * ============================================================================ */
+
+static volatile bool stress_stop;
+static volatile uint64_t stress_frames;
+
+static void stress_frame(uint32_t id, int16_t value, uint32_t tick)
+{
+  uint8_t data[8] = {0};
+  uint8_t at = (id == FEB_CAN_ID_RMS_MOTOR) ? 2u : 0u; /* M165 speed / M167 DC bus */
+  data[at] = (uint8_t)value;
+  data[at + 1u] = (uint8_t)((uint16_t)value >> 8);
+
+  FEB_Host_ISR_Enter();
+  FEB_CAN_RMS_Decode(id, data, 8u, tick);
+  FEB_Host_ISR_Exit();
+}
+
+/* The CAN RX ISR: M165 (speed k, tick 2k-1) then M167 (k / 10 V, tick 2k) */
+static void *stress_writer(void *arg)
+{
+  (void)arg;
+  int16_t k = 2;
+  uint64_t frames = 0;
+  while (!stress_stop)
+  {
+    stress_frame(FEB_CAN_ID_RMS_MOTOR, k, 2u * (uint32_t)k - 1u);
+    stress_frame(FEB_CAN_ID_RMS_VOLTAGE, k, 2u * (uint32_t)k);
+    frames += 2u;
+    k = (k == BENCH_STRESS_K_MAX) ? 1 : (int16_t)(k + 1);
+  }
+  stress_frames = frames;
+  return NULL;
+}
+
+static bool stress_consistent(int16_t speed, float voltage_v, uint32_t tick)
+{
+  int32_t v = (int32_t)lrintf(voltage_v * 10.0f);
+  int32_t prev = (speed == 1) ? BENCH_STRESS_K_MAX : speed - 1;
+  return (v == speed && tick == 2u * (uint32_t)speed) || (v == prev && tick == 2u * (uint32_t)speed - 1u);
+}
+
+static void run_stress(uint64_t *feedback_torn, uint64_t *direct_torn)
+{
+  memset(&RMS_MESSAGE, 0, sizeof(RMS_MESSAGE));
+  memset(RMS_FRAMES, 0, sizeof(RMS_FRAMES));
+  stress_frame(FEB_CAN_ID_RMS_MOTOR, 1, 1u);
+  stress_frame(FEB_CAN_ID_RMS_VOLTAGE, 1, 2u);
+
+  stress_stop = false;
+  pthread_t writer;
+  pthread_create(&writer, NULL, stress_writer, NULL);
+
+  *feedback_torn = 0;
+  *direct_torn = 0;
+  for (uint32_t n = 0; n < BENCH_STRESS_READS; n++)
+  {
+    FEB_CAN_RMS_Feedback_t fb;
+    FEB_CAN_RMS_GetFeedback(&fb);
+    if (!stress_consistent(fb.motor_speed_rpm, fb.dc_bus_voltage_v, fb.last_rx_tick))
+      (*feedback_torn)++;
+
+    /* The former reads in rms_drive_limits() / FEB_Regen_GetElecMaxRegenTorque() */
+    int16_t speed = RMS_MESSAGE.Motor_Speed;
+    float voltage_v = RMS_MESSAGE.DC_Bus_Voltage_V;
+    uint32_t tick = RMS_MESSAGE.last_rx_timestamp;
+    if (!stress_consistent(speed, voltage_v, tick))
+      (*direct_torn)++;
+  }
+
+  stress_stop = true;
+  pthread_join(writer, NULL);
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  uint64_t frames = 0;
+  uint64_t mismatches = check_equivalence(&frames);
+
+  calibrate_clock();
+  double barrier_ns = time_barriers();
+  printf("frame,frames,mismatches,switch_ns,table_ns,barrier_ns\n");
+  for (uint32_t i = 0; i <= BENCH_RMS_IDS; i++)
+  {
+    uint32_t id = (i < BENCH_RMS_IDS) ? bench_ids[i] : 0u;
+    fill_timing_frames(id);
+    double switch_ns = time_decode(ref_decode);
+    double table_ns = time_decode(FEB_CAN_RMS_Decode);
+    if (id)
+    {
+      printf("0x%03X,,,%.1f,%.1f,%.1f\n", (unsigned)id, switch_ns, table_ns, barrier_ns);
+      fprintf(stderr, "0x%03X    %6.1f -> %6.1f ns/frame\n", (unsigned)id, switch_ns, table_ns);
+    }
+    else
+    {
+      printf("mix,%llu,%llu,%.1f,%.1f,%.1f\n", (unsigned long long)frames, (unsigned long long)mismatches, switch_ns,
+             table_ns, barrier_ns);
+      fprintf(stderr, "mix      %6.1f -> %6.1f ns/frame, %llu frames, %llu mismatches\n", switch_ns, table_ns,
+              (unsigned long long)frames, (unsigned long long)mismatches);
+    }
+  }
+  fprintf(stderr, "barriers %6.1f ns/frame of the table path\n", barrier_ns);
+
+  uint64_t feedback_torn = 0, direct_torn = 0;
+  run_stress(&feedback_torn, &direct_torn);
+  printf("stress,reads,frames_written,feedback_torn,direct_torn\n");
+  printf("stress,%u,%llu,%llu,%llu\n", (unsigned)BENCH_STRESS_READS, (unsigned long long)stress_frames,
+         (unsigned long long)feedback_torn, (unsigned long long)direct_torn);
+  fprintf(stderr, "stress   %u reads against %llu frames: %llu torn via GetFeedback, %llu torn direct\n",
+          (unsigned)BENCH_STRESS_READS, (unsigned long long)stress_frames, (unsigned long long)feedback_torn,
+          (unsigned long long)direct_torn);
+
+  uint64_t failures = mismatches + feedback_torn;
+  fprintf(stderr, "failures: %llu\n", (unsigned long long)failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,380 @@
+/**
+ ******************************************************************************
+ * @file           : pcu_torque_latency_test.c
+ * @brief          : Torque-command latency trace through the CAN TX-complete hook
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real FEB_Torque_Latency.c on the real bare-metal feb_can TX path
+ * against the host bxCAN model in virtual time. Each M192 is sent the way
+ * FEB_CAN_RMS_Transmit_UpdateTorque sends it: packed with the generated
+ * library, stamped by rolling counter, then FEB_CAN_TX_SendPriority with one
+ * mailbox reserved as in FEB_Main_Setup. Completion reaches the module only
+ * through FEB_CAN_TX_SetCompleteHook, as on target.
+ *
+ * The ADC is stubbed: FEB_ADC_GetCoherentSnapshot returns sample_us and
+ * latch_us set by the test. Every command gets seeded stage times:
+ *
+ *   sample   0..TEST_SAMPLE_MAX_US     half-buffer consumed -> tick latch
+ *   compute  0..TEST_COMPUTE_MAX_US    latch -> stamp and send
+ *   wire     0..2 telemetry frames (lower ID, normal lane) ahead of it on the
+ *            bus, TEST_FRAME_US each, plus 0..TEST_ARB_MAX_US lost to
+ *            arbitration before its own slot
+ *
+ * and a shadow histogram with the module's log2 buckets is kept alongside.
+ * Checks:
+ *
+ *   startup  - a completion with no stamp counts as unmatched, and a stamp
+ *              taken before the ADC runs (sample_us == 0) is ignored
+ *   stages   - every stage histogram (count, min, max, sum, all buckets)
+ *              equals the shadow, and the telemetry completions leave it alone
+ *   counters - stamped == completed, nothing lost or unmatched
+ *   report   - the 0xE6 frame after FEB_TORQUE_LAT_CAN_PERIOD_MS ticks holds
+ *              the window's last, mean, max total and max jitter; the next
+ *              one, with no commands in between, is all zero
+ *   lost     - a stamp whose counter slot is reused before completion
+ *              counts as lost, and the reused stamp still completes
+ *
+ * stdout: `check,count,mismatches`
+ * stderr: summary. Exit status 1 on any failed check, 2 on setup failure.
+ *
+ ******************************************************************************
+ */
+
+#include "FEB_ADC.h"
+#include "FEB_Torque_Latency.h"
+#include "feb_can.h"
+#include "feb_can_lib.h"
+#include "feb_host.h"
+#include "feb_time.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define TEST_SEED 0x7A1C0192U
+#define TEST_COMMANDS 2000U
+#define TEST_PERIOD_US 5000U     /* 200 Hz torque loop */
+#define TEST_FRAME_US 270U       /* 8 data bytes, worst-case stuffing, 500 kbit/s */
+#define TEST_SAMPLE_MAX_US 1000U /* ADC3 half-buffer to the next 1 ms tick */
+#define TEST_COMPUTE_MAX_US 400U
+#define TEST_ARB_MAX_US 300U
+#define TEST_MAX_AHEAD 2U        /* Normal lane keeps the last mailbox free */
+#define TEST_ID_TELEMETRY 0x050U /* Outranks M192 (0x0C0) on the bus */
+
+/* ============================================================================
+ * Stubs and Bus
+ * ============================================================================ */
+
+CAN_HandleTypeDef hcan1;
+
+static ADC_CoherentSnapshot_t adc_snapshot;
+
+void FEB_ADC_GetCoherentSnapshot(ADC_CoherentSnapshot_t *out)
+{
+  if (out != NULL)
+  {
+    *out = adc_snapshot;
+  }
+}
+
+static uint32_t report_frames;
+static uint8_t report_data[8];
+
+static void on_bus_tx(CAN_HandleTypeDef *hcan, const FEB_Host_CAN_Frame_t *frame, void *user)
+{
+  (void)hcan;
+  (void)user;
+  if (frame->ide == CAN_ID_STD && frame->id == FEB_TORQUE_LAT_CAN_FRAME_ID)
+  {
+    report_frames++;
+    memcpy(report_data, frame->data, sizeof(report_data));
+  }
+}
+
+static uint32_t rng_state = TEST_SEED;
+
+static uint32_t rng(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+/* ============================================================================
+ * Shadow Histograms
+ * ============================================================================ */
+
+static FEB_Torque_Lat_Hist_t shadow[FEB_TORQUE_LAT_STAGE_COUNT];
+
+static void shadow_record(FEB_Torque_Lat_Stage_t stage, uint32_t v)
+{
+  uint32_t b = 0;
+  while (b < FEB_TORQUE_LAT_BUCKETS - 1U && v >= (1UL << b))
+  {
+    b++;
+  }
+
+  FEB_Torque_Lat_Hist_t *h = &shadow[stage];
+  if (h->count == 0U || v < h->min_us)
+  {
+    h->min_us = v;
+  }
+  if (v > h->max_us)
+  {
+    h->max_us = v;
+  }
+  h->count++;
+  h->sum_us += v;
+  h->bucket[b]++;
+}
+
+static uint32_t hist_mismatches(FEB_Torque_Lat_Stage_t stage)
+{
+  FEB_Torque_Lat_Hist_t got;
+  FEB_Torque_Latency_Get(stage, &got);
+  const FEB_Torque_Lat_Hist_t *want = &shadow[stage];
+
+  uint32_t bad = (got.count != want->count) + (got.min_us != want->min_us) + (got.max_us != want->max_us) +
+                 (got.sum_us != want->sum_us);
+  for (uint32_t b = 0; b < FEB_TORQUE_LAT_BUCKETS; b++)
+  {
+    bad += (got.bucket[b] != want->bucket[b]) ? 1U : 0U;
+  }
+  return bad;
+}
+
+/* ============================================================================
+ * Torque Path
+ * ============================================================================ */
+
+static uint8_t rolling_counter;
+
+/* FEB_CAN_RMS_Transmit_UpdateTorque, minus the limits */
+static void send_command(bool stamp)
+{
+  struct feb_can_m192_command_message_t msg = {0};
+  msg.vcu_inv_torque_command = 100;
+  msg.vcu_inv_direction_command = 1u;
+  msg.vcu_inv_inverter_enable = 1u;
+  msg.vcu_inv_rolling_counter = rolling_counter;
+  rolling_counter = (uint8_t)((rolling_counter + 1u) & 0x0Fu);
+
+  uint8_t data[FEB_CAN_M192_COMMAND_MESSAGE_LENGTH];
+  int packed = feb_can_m192_command_message_pack(data, &msg, sizeof(data));
+  if (stamp)
+  {
+    FEB_Torque_Latency_Stamp(msg.vcu_inv_rolling_counter);
+  }
+  (void)FEB_CAN_TX_SendPriority(FEB_CAN_INSTANCE_1, FEB_CAN_M192_COMMAND_MESSAGE_FRAME_ID, FEB_CAN_ID_STD, data,
+                                (uint8_t)packed);
+}
+
+static void send_telemetry(void)
+{
+  static const uint8_t data[8] = {0};
+  (void)FEB_CAN_TX_Send(FEB_CAN_INSTANCE_1, TEST_ID_TELEMETRY, FEB_CAN_ID_STD, data, sizeof(data));
+}
+
+/* One slot per pending frame, lowest ID first; returns the time it took. */
+static uint32_t drain_bus(uint32_t frames, uint32_t arbitration_us)
+{
+  FEB_Host_Time_AdvanceUs(arbitration_us);
+  for (uint32_t i = 0; i < frames; i++)
+  {
+    FEB_Host_Time_AdvanceUs(TEST_FRAME_US);
+    FEB_Host_CAN_BusStep(&hcan1);
+  }
+  return arbitration_us + frames * TEST_FRAME_US;
+}
+
+static void put_adc(uint32_t sample_us, uint32_t latch_us)
+{
+  adc_snapshot.sample_us = sample_us;
+  adc_snapshot.latch_us = latch_us;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+static void report(const char *check, uint32_t count, uint32_t mismatches)
+{
+  printf("%s,%u,%u\n", check, count, mismatches);
+}
+
+static uint16_t get_u16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t sat_u16(uint32_t v)
+{
+  return (v > 0xFFFFU) ? 0xFFFFU : v;
+}
+
+int main(void)
+{
+  uint32_t failures = 0;
+
+  FEB_Host_Time_UseVirtual(true);
+  FEB_Host_Time_AdvanceUs(10000);
+  FEB_Time_Init();
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+  FEB_Host_CAN_SetTxHook(&hcan1, on_bus_tx, NULL);
+
+  FEB_CAN_Config_t cfg = {.hcan1 = &hcan1, .get_tick_ms = HAL_GetTick, .get_time_us = FEB_Time_Us};
+  if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+  {
+    fprintf(stderr, "FEB_CAN_Init failed\n");
+    return 2;
+  }
+  FEB_CAN_TX_ReserveMailboxes(FEB_CAN_INSTANCE_1, 1);
+  FEB_Torque_Latency_Init();
+
+  /* Startup: the RMS gets commands before the ADC runs and before any stamp */
+  put_adc(0, 0);
+  send_command(false);
+  (void)drain_bus(1, 0);
+  send_command(true);
+  (void)drain_bus(1, 0);
+  FEB_Torque_Lat_Counters_t c;
+  FEB_Torque_Latency_Get_Counters(&c);
+  FEB_Torque_Lat_Hist_t total;
+  FEB_Torque_Latency_Get(FEB_TORQUE_LAT_TOTAL, &total);
+  const uint32_t startup_bad = (c.stamped != 0U) + (c.unmatched != 2U) + (total.count != 0U);
+  report("startup", c.unmatched, startup_bad);
+  failures += (startup_bad == 0U) ? 0U : 1U;
+
+  FEB_Torque_Latency_Reset();
+
+  /* Stages: seeded sample/compute/wire times, traced through the TX hook */
+  uint32_t prev_total = 0;
+  uint32_t window_count = 0;
+  uint64_t window_sum = 0;
+  uint32_t window_max = 0;
+  uint32_t window_jitter = 0;
+  uint32_t last_total = 0;
+  for (uint32_t i = 0; i < TEST_COMMANDS; i++)
+  {
+    const uint32_t sample = rng() % (TEST_SAMPLE_MAX_US + 1U);
+    const uint32_t compute = rng() % (TEST_COMPUTE_MAX_US + 1U);
+    const uint32_t ahead = rng() % (TEST_MAX_AHEAD + 1U);
+    const uint32_t arbitration = rng() % (TEST_ARB_MAX_US + 1U);
+
+    const uint32_t now = FEB_Time_Us32();
+    put_adc(now - compute - sample, now - compute);
+    for (uint32_t k = 0; k < ahead; k++)
+    {
+      send_telemetry();
+    }
+    send_command(true);
+    const uint32_t wire = drain_bus(ahead + 1U, arbitration);
+
+    const uint32_t t = sample + compute + wire;
+    shadow_record(FEB_TORQUE_LAT_SAMPLE, sample);
+    shadow_record(FEB_TORQUE_LAT_COMPUTE, compute);
+    shadow_record(FEB_TORQUE_LAT_WIRE, wire);
+    shadow_record(FEB_TORQUE_LAT_TOTAL, t);
+    if (i > 0U)
+    {
+      const uint32_t j = (t > prev_total) ? t - prev_total : prev_total - t;
+      shadow_record(FEB_TORQUE_LAT_JITTER, j);
+      window_jitter = (j > window_jitter) ? j : window_jitter;
+    }
+    prev_total = t;
+    last_total = t;
+    window_count++;
+    window_sum += t;
+    window_max = (t > window_max) ? t : window_max;
+
+    FEB_Host_Time_AdvanceUs(TEST_PERIOD_US - wire);
+  }
+
+  uint32_t stage_bad = 0;
+  FEB_Torque_Lat_Hist_t stages[FEB_TORQUE_LAT_STAGE_COUNT];
+  for (uint32_t s = 0; s < FEB_TORQUE_LAT_STAGE_COUNT; s++)
+  {
+    FEB_Torque_Latency_Get((FEB_Torque_Lat_Stage_t)s, &stages[s]);
+    const uint32_t bad = hist_mismatches((FEB_Torque_Lat_Stage_t)s);
+    char name[24];
+    snprintf(name, sizeof(name), "stage_%s", FEB_Torque_Latency_StageName((FEB_Torque_Lat_Stage_t)s));
+    report(name, shadow[s].count, bad);
+    stage_bad += bad;
+  }
+  failures += (stage_bad == 0U) ? 0U : 1U;
+
+  FEB_Torque_Latency_Get_Counters(&c);
+  const uint32_t counters_bad =
+      (c.stamped != TEST_COMMANDS) + (c.completed != TEST_COMMANDS) + (c.lost != 0U) + (c.unmatched != 0U);
+  report("counters", c.completed, counters_bad);
+  failures += (counters_bad == 0U) ? 0U : 1U;
+
+  /* Report: one 0xE6 per period with the window, then an empty window */
+  FEB_Torque_Latency_SetCanReport(true);
+  uint32_t report_bad = 0;
+  uint8_t first_report[8] = {0};
+  for (uint32_t round = 0; round < 2U; round++)
+  {
+    const uint32_t before = report_frames;
+    for (uint32_t ms = 0; ms < FEB_TORQUE_LAT_CAN_PERIOD_MS; ms++)
+    {
+      FEB_Torque_Latency_Tick();
+    }
+    (void)drain_bus(1, 0);
+    report_bad += (report_frames == before + 1U) ? 0U : 1U;
+
+    const bool empty = (round == 1U);
+    const uint32_t want_last = empty ? 0U : sat_u16(last_total);
+    const uint32_t want_mean = empty ? 0U : sat_u16((uint32_t)(window_sum / window_count));
+    const uint32_t want_max = empty ? 0U : sat_u16(window_max);
+    const uint32_t want_jitter = empty ? 0U : sat_u16(window_jitter);
+    report_bad += (get_u16(&report_data[0]) != want_last) + (get_u16(&report_data[2]) != want_mean) +
+                  (get_u16(&report_data[4]) != want_max) + (get_u16(&report_data[6]) != want_jitter);
+    if (round == 0U)
+    {
+      memcpy(first_report, report_data, sizeof(first_report));
+    }
+  }
+  FEB_Torque_Latency_SetCanReport(false);
+  report("report", report_frames, report_bad);
+  failures += (report_bad == 0U) ? 0U : 1U;
+
+  /* Lost: the counter wraps onto a stamp that never completed */
+  FEB_Torque_Latency_Get_Counters(&c);
+  const uint32_t completed_before = c.completed;
+  const uint32_t now = FEB_Time_Us32();
+  put_adc(now - 300U, now - 100U);
+  FEB_Torque_Latency_Stamp(rolling_counter);
+  send_command(true);
+  (void)drain_bus(1, 0);
+  FEB_Torque_Latency_Get_Counters(&c);
+  const uint32_t lost_bad = (c.lost != 1U) + (c.completed != completed_before + 1U) + (c.unmatched != 0U);
+  report("lost", c.lost, lost_bad);
+  failures += (lost_bad == 0U) ? 0U : 1U;
+
+  fprintf(stderr, "commands: %u at %u us, %u telemetry frames ahead at most, seed 0x%08X\n", TEST_COMMANDS,
+          TEST_PERIOD_US, TEST_MAX_AHEAD, TEST_SEED);
+  for (uint32_t s = 0; s < FEB_TORQUE_LAT_STAGE_COUNT; s++)
+  {
+    const FEB_Torque_Lat_Hist_t *h = &stages[s];
+    fprintf(stderr, "%-8s n=%-5u min %5u  mean %5u  max %5u us\n",
+            FEB_Torque_Latency_StageName((FEB_Torque_Lat_Stage_t)s), h->count, h->min_us,
+            h->count ? (uint32_t)(h->sum_us / h->count) : 0U, h->max_us);
+  }
+  fprintf(stderr, "stages: %u histogram fields differ from the shadow\n", stage_bad);
+  fprintf(stderr, "0x%03X report: last %u, mean %u, max %u, max jitter %u us; empty window %s\n",
+          (unsigned)FEB_TORQUE_LAT_CAN_FRAME_ID, get_u16(&first_report[0]), get_u16(&first_report[2]),
+          get_u16(&first_report[4]), get_u16(&first_report[6]), report_bad == 0U ? "all zero" : "WRONG");
+  fprintf(stderr, "counters: startup unmatched %s, lost on reuse %s\n", startup_bad == 0U ? "ok" : "WRONG",
+          lost_bad == 0U ? "ok" : "WRONG");
+  fprintf(stderr, "%s\n", failures == 0U ? "PASS" : "FAIL");
+  return failures == 0U ? 0 : 1;
+}
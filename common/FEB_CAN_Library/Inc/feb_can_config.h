@@ -28,6 +28,31 @@ extern "C"
 
 #ifndef FEB_CAN_MAX_FILTERS_PER_INSTANCE
 #define FEB_CAN_MAX_FILTERS_PER_INSTANCE 14
+#endif
+
+  /* ============================================================================
+   * RX Dispatch Index
+   * ============================================================================
+   *
+   * Exact-match RX handles are looked up through an open-addressed hash keyed
+   * by (instance, id_type, can_id). The table has 2^FEB_CAN_RX_HASH_BITS
+   * buckets and must be strictly larger than FEB_CAN_MAX_RX_HANDLES so a probe
+   * always terminates on an empty bucket. Keep it at >= 2x the handle count to
+   * hold probe lengths near one.
+   */
+
+#ifndef FEB_CAN_RX_HASH_BITS
+#define FEB_CAN_RX_HASH_BITS 6
+#endif
+
+#define FEB_CAN_RX_HASH_SIZE (1u << FEB_CAN_RX_HASH_BITS)
+
+#if FEB_CAN_MAX_RX_HANDLES >= 255
+#error "FEB_CAN_MAX_RX_HANDLES must fit in the uint8_t RX dispatch index (< 255)"
+#endif
+
+#if FEB_CAN_RX_HASH_SIZE <= FEB_CAN_MAX_RX_HANDLES
+#error "FEB_CAN_RX_HASH_BITS too small: hash table must have more buckets than FEB_CAN_MAX_RX_HANDLES"
 #endif
 
   /* ============================================================================
@@ -40,6 +65,43 @@ extern "C"
 
 #ifndef FEB_CAN_RX_QUEUE_SIZE
 #define FEB_CAN_RX_QUEUE_SIZE 32
+#endif
+
+/* Bare-metal priority TX lane (FEB_CAN_TX_SendPriority), per instance */
+#ifndef FEB_CAN_TX_PRIO_QUEUE_SIZE
+#define FEB_CAN_TX_PRIO_QUEUE_SIZE 4
+#endif
+
+  /* ============================================================================
+   * Batched RX (FreeRTOS only)
+   * ============================================================================
+   *
+   * FEB_CAN_RX_BATCH = 1 replaces the per-frame osMessageQueuePut in the FIFO
+   * ISR with a lock-free single-producer ring per (instance, FIFO). The ISR
+   * drains every pending frame into its ring, stamps each with the config's
+   * get_time_us source, and wakes the RX task once per batch through a thread
+   * flag (a FreeRTOS task notification). rx_queue is then unused and may be
+   * NULL. Consume with FEB_CAN_RX_Wait() from a single RX task.
+   *
+   * FEB_CAN_RX_RING_SIZE is per ring (power of two); RAM cost is
+   * 4 x FEB_CAN_RX_RING_SIZE x 32 bytes (4 KiB at the default, which matches the
+   * 32-deep rx_queue per FIFO).
+   */
+
+#ifndef FEB_CAN_RX_BATCH
+#define FEB_CAN_RX_BATCH 0
+#endif
+
+#ifndef FEB_CAN_RX_RING_SIZE
+#define FEB_CAN_RX_RING_SIZE 32
+#endif
+
+#ifndef FEB_CAN_RX_NOTIFY_FLAG
+#define FEB_CAN_RX_NOTIFY_FLAG 0x00010000U
+#endif
+
+#if (FEB_CAN_RX_RING_SIZE & (FEB_CAN_RX_RING_SIZE - 1)) != 0 || FEB_CAN_RX_RING_SIZE < 2 || FEB_CAN_RX_RING_SIZE > 32768
+#error "FEB_CAN_RX_RING_SIZE must be a power of two between 2 and 32768"
 #endif
 
   /* ============================================================================
@@ -0,0 +1,174 @@
+/**
+ ******************************************************************************
+ * @file           : feb_can_ext_frames.h
+ * @brief          : Hand-coded frames outside the generated CAN library
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * The single definition of frames that are not (yet) in FEB_CAN_Library_SN4.
+ * The sender and every receiver include this header, so the ID and byte layout
+ * cannot drift apart; the _Static_asserts below pin both, so moving a field or
+ * an ID is a deliberate edit here, not a silent one-board change.
+ *
+ *   0x0E4  BMS cell history dump (BMS -> logger, on request)
+ *     seq 0     [0..1] seq = 0 (LE), [2..5] total ring bytes (LE),
+ *               [6..7] record count (LE)
+ *     seq 1..N  [0..1] seq (LE), [2..7] next ring bytes, oldest first
+ *               (DLC shorter on the last frame)
+ *
+ *   0x0E5  BMS SOC / pack resistance estimate (BMS -> PCU, 10 Hz)
+ *     [0..1] SOC, 0.01 % (LE; 0xFFFF = not initialised)
+ *     [2..3] R_pack, 0.1 mOhm (LE; 0xFFFF = saturated)
+ *     [4..5] pack OCV, 0.1 V (LE)
+ *     [6]    FEB_CAN_EXT_BMS_SOC_FLAG_*
+ *     [7]    rolling counter (receivers accept DLC 7 without it)
+ ******************************************************************************
+ */
+
+#ifndef FEB_CAN_EXT_FRAMES_H
+#define FEB_CAN_EXT_FRAMES_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+  /* ============================================================================
+   * 0x0E4 - BMS Cell History Dump
+   * ============================================================================ */
+
+#define FEB_CAN_EXT_BMS_HIST_FRAME_ID 0x0E4U
+#define FEB_CAN_EXT_BMS_HIST_LENGTH 8U
+#define FEB_CAN_EXT_BMS_HIST_CHUNK 6U /* Ring bytes per data frame */
+
+  typedef struct
+  {
+    uint8_t seq[2];
+    union
+    {
+      struct
+      {
+        uint8_t total_bytes[4];
+        uint8_t records[2];
+      } header;                                  /* seq 0 */
+      uint8_t chunk[FEB_CAN_EXT_BMS_HIST_CHUNK]; /* seq 1..N */
+    } body;
+  } feb_can_ext_bms_hist_wire_t;
+
+  _Static_assert(FEB_CAN_EXT_BMS_HIST_FRAME_ID == 0x0E4U, "0x0E4: history dump ID moved");
+  _Static_assert(sizeof(feb_can_ext_bms_hist_wire_t) == FEB_CAN_EXT_BMS_HIST_LENGTH, "0x0E4: frame is 8 bytes");
+  _Static_assert(offsetof(feb_can_ext_bms_hist_wire_t, body.header.total_bytes) == 2, "0x0E4: total at [2..5]");
+  _Static_assert(offsetof(feb_can_ext_bms_hist_wire_t, body.header.records) == 6, "0x0E4: records at [6..7]");
+  _Static_assert(offsetof(feb_can_ext_bms_hist_wire_t, body.chunk) == 2, "0x0E4: ring bytes at [2..7]");
+
+  /** Header frame (seq 0). Returns the DLC. */
+  static inline uint8_t feb_can_ext_bms_hist_pack_header(uint8_t *dst, uint32_t total_bytes, uint16_t records)
+  {
+    feb_can_ext_bms_hist_wire_t *w = (feb_can_ext_bms_hist_wire_t *)dst;
+    w->seq[0] = 0;
+    w->seq[1] = 0;
+    w->body.header.total_bytes[0] = (uint8_t)(total_bytes & 0xFF);
+    w->body.header.total_bytes[1] = (uint8_t)((total_bytes >> 8) & 0xFF);
+    w->body.header.total_bytes[2] = (uint8_t)((total_bytes >> 16) & 0xFF);
+    w->body.header.total_bytes[3] = (uint8_t)((total_bytes >> 24) & 0xFF);
+    w->body.header.records[0] = (uint8_t)(records & 0xFF);
+    w->body.header.records[1] = (uint8_t)(records >> 8);
+    return FEB_CAN_EXT_BMS_HIST_LENGTH;
+  }
+
+  /** Data frame (seq >= 1) carrying len <= FEB_CAN_EXT_BMS_HIST_CHUNK ring bytes. Returns the DLC. */
+  static inline uint8_t feb_can_ext_bms_hist_pack_data(uint8_t *dst, uint16_t seq, const uint8_t *bytes, uint8_t len)
+  {
+    feb_can_ext_bms_hist_wire_t *w = (feb_can_ext_bms_hist_wire_t *)dst;
+    w->seq[0] = (uint8_t)(seq & 0xFF);
+    w->seq[1] = (uint8_t)(seq >> 8);
+    for (uint8_t i = 0; i < len && i < FEB_CAN_EXT_BMS_HIST_CHUNK; i++)
+    {
+      w->body.chunk[i] = bytes[i];
+    }
+    return (uint8_t)(offsetof(feb_can_ext_bms_hist_wire_t, body.chunk) + len);
+  }
+
+  static inline uint16_t feb_can_ext_bms_hist_seq(const uint8_t *src)
+  {
+    return (uint16_t)(src[0] | (src[1] << 8));
+  }
+
+  /* ============================================================================
+   * 0x0E5 - BMS SOC / Pack Resistance Estimate
+   * ============================================================================ */
+
+#define FEB_CAN_EXT_BMS_SOC_FRAME_ID 0x0E5U
+#define FEB_CAN_EXT_BMS_SOC_LENGTH 8U
+#define FEB_CAN_EXT_BMS_SOC_MIN_LENGTH 7U           /* Without the rolling counter */
+#define FEB_CAN_EXT_BMS_SOC_FLAG_VALID 0x01U        /* SOC initialised */
+#define FEB_CAN_EXT_BMS_SOC_FLAG_R_CONVERGED 0x02U  /* R_pack estimate has settled */
+#define FEB_CAN_EXT_BMS_SOC_FLAG_AT_REST 0x04U       /* OCV correction active */
+#define FEB_CAN_EXT_BMS_SOC_FLAG_NO_CURRENT 0x08U    /* IVT current stale: SOC held */
+#define FEB_CAN_EXT_BMS_SOC_INVALID 0xFFFFU         /* soc_cpct when not initialised */
+
+  typedef struct
+  {
+    uint8_t soc_cpct[2];
+    uint8_t r_pack_tenth_mohm[2];
+    uint8_t ocv_dv[2];
+    uint8_t flags;
+    uint8_t counter;
+  } feb_can_ext_bms_soc_wire_t;
+
+  _Static_assert(FEB_CAN_EXT_BMS_SOC_FRAME_ID == 0x0E5U, "0x0E5: SOC frame ID moved");
+  _Static_assert(sizeof(feb_can_ext_bms_soc_wire_t) == FEB_CAN_EXT_BMS_SOC_LENGTH, "0x0E5: frame is 8 bytes");
+  _Static_assert(offsetof(feb_can_ext_bms_soc_wire_t, r_pack_tenth_mohm) == 2, "0x0E5: R_pack at [2..3]");
+  _Static_assert(offsetof(feb_can_ext_bms_soc_wire_t, ocv_dv) == 4, "0x0E5: OCV at [4..5]");
+  _Static_assert(offsetof(feb_can_ext_bms_soc_wire_t, flags) == 6, "0x0E5: flags at [6]");
+  _Static_assert(offsetof(feb_can_ext_bms_soc_wire_t, counter) == FEB_CAN_EXT_BMS_SOC_MIN_LENGTH,
+                 "0x0E5: counter is the optional last byte");
+
+  struct feb_can_ext_bms_soc_t
+  {
+    uint16_t soc_cpct;          /* 0.01 %, FEB_CAN_EXT_BMS_SOC_INVALID when not initialised */
+    uint16_t r_pack_tenth_mohm; /* 0.1 mOhm */
+    uint16_t ocv_dv;            /* 0.1 V */
+    uint8_t flags;              /* FEB_CAN_EXT_BMS_SOC_FLAG_* */
+    uint8_t counter;
+  };
+
+  static inline uint8_t feb_can_ext_bms_soc_pack(uint8_t *dst, const struct feb_can_ext_bms_soc_t *src)
+  {
+    feb_can_ext_bms_soc_wire_t *w = (feb_can_ext_bms_soc_wire_t *)dst;
+    w->soc_cpct[0] = (uint8_t)(src->soc_cpct & 0xFF);
+    w->soc_cpct[1] = (uint8_t)(src->soc_cpct >> 8);
+    w->r_pack_tenth_mohm[0] = (uint8_t)(src->r_pack_tenth_mohm & 0xFF);
+    w->r_pack_tenth_mohm[1] = (uint8_t)(src->r_pack_tenth_mohm >> 8);
+    w->ocv_dv[0] = (uint8_t)(src->ocv_dv & 0xFF);
+    w->ocv_dv[1] = (uint8_t)(src->ocv_dv >> 8);
+    w->flags = src->flags;
+    w->counter = src->counter;
+    return FEB_CAN_EXT_BMS_SOC_LENGTH;
+  }
+
+  /** Returns 0, or -1 if length is below FEB_CAN_EXT_BMS_SOC_MIN_LENGTH. */
+  static inline int feb_can_ext_bms_soc_unpack(struct feb_can_ext_bms_soc_t *dst, const uint8_t *src, size_t length)
+  {
+    if (length < FEB_CAN_EXT_BMS_SOC_MIN_LENGTH)
+    {
+      return -1;
+    }
+    const feb_can_ext_bms_soc_wire_t *w = (const feb_can_ext_bms_soc_wire_t *)src;
+    dst->soc_cpct = (uint16_t)(w->soc_cpct[0] | (w->soc_cpct[1] << 8));
+    dst->r_pack_tenth_mohm = (uint16_t)(w->r_pack_tenth_mohm[0] | (w->r_pack_tenth_mohm[1] << 8));
+    dst->ocv_dv = (uint16_t)(w->ocv_dv[0] | (w->ocv_dv[1] << 8));
+    dst->flags = w->flags;
+    dst->counter = (length >= FEB_CAN_EXT_BMS_SOC_LENGTH) ? w->counter : 0;
+    return 0;
+  }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEB_CAN_EXT_FRAMES_H */
@@ -182,6 +182,35 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
     uint8_t reserved;       /**< Padding */
   } FEB_CAN_RX_Handle_Internal_t;
 
+  /* ============================================================================
+   * RX Dispatch Index
+   * ============================================================================ */
+
+#define FEB_CAN_RX_INDEX_EMPTY 0xFFu
+
+  /**
+   * @brief Compiled lookup structure over rx_handles[]
+   *
+   * Rebuilt by feb_can_rx_index_rebuild() whenever the handle table changes,
+   * so feb_can_rx_dispatch() never walks inactive or non-matching slots. Two
+   * copies are kept: the rebuild fills the one dispatch is not using and then
+   * publishes it through rx_index_live, so a frame arriving mid-rebuild is
+   * looked up in the previous, complete index.
+   *   - hash[]  : open-addressed (linear probe) buckets holding the first
+   *               exact handle for a (instance, id_type, can_id) key
+   *   - chain[] : next exact handle sharing the same key (FEB_CAN_RX_Register
+   *               rejects duplicates, but RegisterExtended does not)
+   *   - slow[]  : mask and wildcard handles, tested one by one
+   * All entries are rx_handles[] indices or FEB_CAN_RX_INDEX_EMPTY.
+   */
+  typedef struct
+  {
+    uint8_t hash[FEB_CAN_RX_HASH_SIZE];
+    uint8_t chain[FEB_CAN_MAX_RX_HANDLES];
+    uint8_t slow[FEB_CAN_MAX_RX_HANDLES];
+    uint8_t slow_count;
+  } FEB_CAN_RX_Index_t;
+
   /* ============================================================================
    * TX Handle Structure
    * ============================================================================ */
@@ -195,6 +224,9 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
     void *data_ptr;                                    /**< Pointer to source data structure */
     size_t data_size;                                  /**< Size of data structure */
     uint32_t period_ms;                                /**< Periodic interval (0 = manual only) */
+    uint32_t phase_ms;                                 /**< Requested phase (0 = auto-spread) */
+    uint32_t phase;                                    /**< Effective phase: fires when tick % period == phase */
+    uint32_t next_due;                                 /**< Tick of the next periodic transmission */
     uint32_t last_tx_time;                             /**< Last transmission timestamp */
     int (*pack_func)(uint8_t *, const void *, size_t); /**< Optional pack function */
     uint8_t instance;                                  /**< CAN instance */
@@ -203,6 +235,35 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
     uint8_t reserved;                                  /**< Padding */
   } FEB_CAN_TX_Handle_Internal_t;
 
+  /* ============================================================================
+   * Batched RX Ring
+   * ============================================================================ */
+
+#if FEB_CAN_USE_FREERTOS && FEB_CAN_RX_BATCH
+  /**
+   * @brief One received frame plus its microsecond capture time
+   */
+  typedef struct
+  {
+    FEB_CAN_Message_t msg; /**< Frame (msg.timestamp is the ms tick) */
+    uint64_t time_us;      /**< get_time_us() when the ISR read the frame */
+  } FEB_CAN_RX_Ring_Entry_t;
+
+  /**
+   * @brief Single-producer / single-consumer frame ring
+   *
+   * The producer is the FIFO ISR of one (instance, FIFO) pair and only writes
+   * head; the RX task only writes tail. Indices run free and wrap at 2^16, so
+   * head - tail is the fill level.
+   */
+  typedef struct
+  {
+    FEB_CAN_RX_Ring_Entry_t slot[FEB_CAN_RX_RING_SIZE];
+    uint16_t head;
+    uint16_t tail;
+  } FEB_CAN_RX_Ring_t;
+#endif
+
   /* ============================================================================
    * Filter Bank Tracking
    * ============================================================================ */
@@ -266,11 +327,47 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
     volatile uint16_t tx_ring_head[FEB_CAN_NUM_INSTANCES];
     volatile uint16_t tx_ring_tail[FEB_CAN_NUM_INSTANCES];
     volatile uint16_t tx_ring_count[FEB_CAN_NUM_INSTANCES];
+
+    /* Priority lane (FEB_CAN_TX_SendPriority): drained before tx_ring, and
+     * the only one allowed into the last tx_reserved_mailboxes free
+     * mailboxes, so a control frame never waits behind queued telemetry. */
+    FEB_CAN_Message_t tx_prio_ring[FEB_CAN_NUM_INSTANCES][FEB_CAN_TX_PRIO_QUEUE_SIZE];
+    volatile uint16_t tx_prio_head[FEB_CAN_NUM_INSTANCES];
+    volatile uint16_t tx_prio_tail[FEB_CAN_NUM_INSTANCES];
+    volatile uint16_t tx_prio_count[FEB_CAN_NUM_INSTANCES];
+    uint8_t tx_reserved_mailboxes[FEB_CAN_NUM_INSTANCES];
+#endif
+
+#if FEB_CAN_USE_FREERTOS && FEB_CAN_RX_BATCH
+    /* Batched RX: [instance][fifo] rings filled by the FIFO ISRs, and the
+     * task FEB_CAN_RX_Wait() runs in (thread-flag target, NULL until the
+     * first wait). */
+    FEB_CAN_RX_Ring_t rx_ring[FEB_CAN_NUM_INSTANCES][2];
+    void *volatile rx_task;
 #endif
 
+    /* Frame loaded into each hardware mailbox, recorded by
+     * feb_can_tx_hal_transmit so the TX-complete interrupt can tell the hook
+     * which frame left (only the fields the hook needs are filled) */
+    FEB_CAN_Message_t tx_mailbox_msg[FEB_CAN_NUM_INSTANCES][3];
+    FEB_CAN_TX_Complete_Hook_t tx_complete_hook;
+
+    /* Capture-time source for RX frames, and the stamp of the frame being
+     * dispatched (read back by FEB_CAN_RX_GetFrameTimeUs in callbacks) */
+    uint64_t (*get_time_us)(void);
+    uint64_t rx_frame_time_us;
+
+    /* RX batching statistics (FEB_CAN_GetRxBatchStats) */
+    volatile uint32_t rx_isr_batches;
+    volatile uint32_t rx_isr_frames;
+    volatile uint32_t rx_isr_max_batch;
+    volatile uint32_t rx_ring_high_water;
+    volatile uint32_t rx_wakeups;
+
     /* Error counters for diagnostics */
     volatile uint32_t rx_queue_overflow_count; /**< RX messages dropped due to queue full */
     volatile uint32_t tx_queue_overflow_count; /**< TX messages dropped due to queue full */
+    volatile uint32_t tx_prio_overflow_count;  /**< Priority-lane TX messages dropped due to queue full */
     volatile uint32_t tx_timeout_count;        /**< TX messages dropped due to mailbox timeout */
     volatile uint32_t hal_error_count;         /**< HAL errors encountered */
     volatile uint32_t error_callback_count;    /**< Times HAL_CAN_ErrorCallback fired */
@@ -282,11 +379,20 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
     /* RX handles */
     FEB_CAN_RX_Handle_Internal_t rx_handles[FEB_CAN_MAX_RX_HANDLES];
     uint32_t rx_handle_count;
+    FEB_CAN_RX_Index_t rx_index[2];
+    FEB_CAN_RX_Index_t *rx_index_live; /**< Index dispatch reads; swapped by feb_can_rx_index_rebuild() */
 
     /* TX handles */
     FEB_CAN_TX_Handle_Internal_t tx_handles[FEB_CAN_MAX_TX_HANDLES];
     uint32_t tx_handle_count;
 
+    /* Periodic schedule: tx_handles[] indices of every slot with period_ms > 0,
+     * ordered by next_due (earliest first). FEB_CAN_TX_ProcessPeriodic only
+     * looks at the head, so an idle pass costs one compare instead of a scan. */
+    uint8_t tx_sched[FEB_CAN_MAX_TX_HANDLES];
+    uint8_t tx_sched_count;
+    volatile uint32_t tx_periodic_late_count; /**< Periodic slots that missed a whole period */
+
     /* Filter tracking */
     FEB_CAN_Filter_Entry_t filters[FEB_CAN_TOTAL_FILTER_BANKS];
 
@@ -313,6 +419,16 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
   void feb_can_rx_dispatch(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_t id_type, const uint8_t *data,
                            uint8_t length, uint32_t timestamp);
 
+  /**
+   * @brief Rebuild the RX dispatch index from rx_handles[]
+   *
+   * Called from FEB_CAN_Init and after every RX register/unregister, with
+   * rx_mutex held in FreeRTOS mode. Builds into the spare copy and swaps it
+   * in with one pointer store, so it may run while feb_can_rx_dispatch()
+   * is active in the RX ISR (bare-metal) or the RX task.
+   */
+  void feb_can_rx_index_rebuild(void);
+
   /**
    * @brief Internal TX transmit via HAL
    */
@@ -338,18 +454,22 @@ typedef volatile uint8_t FEB_CAN_Semaphore_t;
    * @brief Enqueue a message into the bare-metal per-instance software TX FIFO.
    *
    * ISR- and main-loop-safe (PRIMASK critical section). On a full ring the
-   * frame is dropped and ctx->tx_queue_overflow_count is incremented.
+   * frame is dropped and ctx->tx_queue_overflow_count (or, for the priority
+   * lane, ctx->tx_prio_overflow_count) is incremented.
    *
+   * @param priority Queue on the priority lane instead of the normal FIFO
    * @return true if queued, false if the instance's ring was full.
    */
-  bool feb_can_tx_enqueue(FEB_CAN_Instance_t instance, const FEB_CAN_Message_t *msg);
+  bool feb_can_tx_enqueue(FEB_CAN_Instance_t instance, const FEB_CAN_Message_t *msg, bool priority);
 
   /**
    * @brief Drain queued frames for an instance into free hardware mailboxes.
    *
-   * ISR- and main-loop-safe. Stops at the first frame that cannot be loaded
-   * (mailboxes full, or peripheral in HAL ERROR state pending recovery),
-   * leaving the remainder queued for the next pump.
+   * ISR- and main-loop-safe. The priority lane goes first and may use any
+   * free mailbox; the normal FIFO only loads while more than the reserved
+   * number of mailboxes are free. Stops at the first frame that cannot be
+   * loaded (mailboxes full, or peripheral in HAL ERROR state pending
+   * recovery), leaving the remainder queued for the next pump.
    */
   void feb_can_tx_pump(FEB_CAN_Instance_t instance);
 #endif
@@ -171,6 +171,7 @@ extern "C"
     FEB_CAN_ERROR_QUEUE,          /**< Queue operation failed */
     FEB_CAN_ERROR_NO_MUTEX,       /**< Required mutex not provided (FreeRTOS) */
     FEB_CAN_ERROR_NO_SEMAPHORE,   /**< Required semaphore not provided (FreeRTOS) */
+    FEB_CAN_ERROR_UNSUPPORTED,    /**< Not available in this runtime mode */
   } FEB_CAN_Status_t;
 
   /* ============================================================================
@@ -240,6 +241,9 @@ extern "C"
     /* Optional: Timestamp source (defaults to HAL_GetTick if NULL) */
     uint32_t (*get_tick_ms)(void); /**< Function returning millisecond tick */
 
+    /* Optional: Microsecond RX capture stamp, e.g. FEB_Time_Us (defaults to get_tick_ms x 1000) */
+    uint64_t (*get_time_us)(void); /**< Function returning microseconds since boot */
+
 #if FEB_CAN_USE_FREERTOS
     /* ========================================================================
      * REQUIRED Sync Primitives (FreeRTOS mode)
@@ -252,7 +256,7 @@ extern "C"
     /** @brief TX queue - REQUIRED. For queued TX messages. Create in CubeMX. */
     FEB_CAN_QueueHandle_t tx_queue;
 
-    /** @brief RX queue - REQUIRED. For received messages. Create in CubeMX. */
+    /** @brief RX queue - REQUIRED unless FEB_CAN_RX_BATCH. For received messages. Create in CubeMX. */
     FEB_CAN_QueueHandle_t rx_queue;
 
     /** @brief TX mutex - REQUIRED. Protects TX state. Create in CubeMX. */
@@ -345,8 +349,12 @@ extern "C"
     size_t data_size;                                  /**< Size of data structure */
     uint32_t period_ms;                                /**< Periodic interval (0 = manual TX only) */
     int (*pack_func)(uint8_t *, const void *, size_t); /**< Pack function (from feb_can.h) */
+    uint32_t phase_ms; /**< Offset within the period (0 = auto-spread, use period_ms for an exact 0) */
   } FEB_CAN_TX_Params_t;
 
+/** FEB_CAN_TX_ProcessPeriodic() return value when no periodic slot is registered */
+#define FEB_CAN_TX_NO_PERIODIC UINT32_MAX
+
   /**
    * @brief Register a TX slot for a specific CAN ID
    *
@@ -354,6 +362,12 @@ extern "C"
    * - Manual one-shot transmissions
    * - Automatic periodic transmissions (if period_ms > 0)
    *
+   * Periodic slots fire on a fixed grid: whenever HAL_GetTick() % period_ms
+   * equals the slot's phase. With phase_ms = 0 the library picks the phase that
+   * avoids landing in the same millisecond as the instance's other periodic
+   * slots (taking harmonics into account), so slots sharing a period spread out
+   * without hand-tuned divider offsets.
+   *
    * @param params TX slot parameters
    * @return Handle ID (>= 0) on success, negative error code on failure
    */
@@ -373,6 +387,8 @@ extern "C"
    * @param handle Handle returned from FEB_CAN_TX_Register
    * @param period_ms New period (0 = disable periodic TX)
    * @return FEB_CAN_Status_t Operation status
+   *
+   * @note An auto-spread slot picks a fresh phase for the new period.
    */
   FEB_CAN_Status_t FEB_CAN_TX_SetPeriod(int32_t handle, uint32_t period_ms);
 
@@ -431,6 +447,63 @@ extern "C"
   FEB_CAN_Status_t FEB_CAN_TX_SendFromISR(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
                                           const uint8_t *data, uint8_t length);
 
+  /**
+   * @brief Transmit on the priority lane (bare-metal only)
+   *
+   * For control frames that must not queue behind telemetry. The frame goes
+   * into a short per-instance ring (FEB_CAN_TX_PRIO_QUEUE_SIZE) that is
+   * drained before the normal FIFO and may use mailboxes reserved with
+   * FEB_CAN_TX_ReserveMailboxes(). ISR-safe. Once loaded, the bxCAN picks
+   * among pending mailboxes by ID, so keep the lane for low IDs.
+   *
+   * FreeRTOS mode has one TX queue and a mailbox semaphore, with no lane to
+   * jump, so the call fails rather than quietly sending at normal priority.
+   *
+   * @return FEB_CAN_ERROR_FULL if the priority ring was full,
+   *         FEB_CAN_ERROR_UNSUPPORTED in FreeRTOS mode
+   */
+  FEB_CAN_Status_t FEB_CAN_TX_SendPriority(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                                           const uint8_t *data, uint8_t length);
+
+  /**
+   * @brief Keep hardware mailboxes free for the priority lane (bare-metal only)
+   *
+   * The normal FIFO stops loading while @p count or fewer mailboxes are free,
+   * so a FEB_CAN_TX_SendPriority() frame finds an empty mailbox instead of
+   * waiting for a telemetry frame to win arbitration. Costs the FIFO that much
+   * mailbox depth. FEB_CAN_Init() resets it to 0. FreeRTOS mode keeps no
+   * reservation, so only count 0 succeeds there.
+   *
+   * @param count Mailboxes to reserve, 0..2
+   * @return FEB_CAN_OK, FEB_CAN_ERROR_INVALID_PARAM for count > 2, or
+   *         FEB_CAN_ERROR_UNSUPPORTED for count > 0 in FreeRTOS mode
+   */
+  FEB_CAN_Status_t FEB_CAN_TX_ReserveMailboxes(FEB_CAN_Instance_t instance, uint8_t count);
+
+  /**
+   * @brief TX-complete hook type
+   *
+   * @param instance CAN instance the frame left on
+   * @param can_id CAN identifier of the frame
+   * @param id_type Standard or Extended ID
+   * @param data Payload as loaded into the mailbox
+   * @param length Data length
+   */
+  typedef void (*FEB_CAN_TX_Complete_Hook_t)(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                                             const uint8_t *data, uint8_t length);
+
+  /**
+   * @brief Install a hook called when a frame has left its hardware mailbox
+   *
+   * Runs in the CAN TX interrupt once per successfully transmitted frame, before
+   * the next queued frame is loaded. Not called for aborted or failed attempts.
+   * Keep it short: it delays every frame behind it. FEB_CAN_Init() clears the
+   * hook, so install it afterwards.
+   *
+   * @param hook Hook, or NULL to remove
+   */
+  void FEB_CAN_TX_SetCompleteHook(FEB_CAN_TX_Complete_Hook_t hook);
+
   /* ============================================================================
    * RX Registration API
    * ============================================================================ */
@@ -521,12 +594,121 @@ extern "C"
    * @brief Update filters based on registered RX callbacks
    *
    * Automatically reconfigures filters to match currently registered RX IDs.
+   * Exact and mask handles go through FEB_CAN_Filter_Compile; any wildcard
+   * handle still needs every frame, so it installs a single accept-all bank.
    *
    * @param instance CAN instance
    * @return FEB_CAN_Status_t Operation status
    */
   FEB_CAN_Status_t FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_Instance_t instance);
 
+  /* ============================================================================
+   * Filter Compiler
+   * ============================================================================
+   *
+   * Pure (no HAL) so it runs on the host. FEB_CAN_Filter_UpdateFromRegistry
+   * uses it to turn the RX registry into the fewest banks:
+   *   - standard exact IDs  -> 16-bit ID-list banks (4 per bank)
+   *   - standard masks      -> 16-bit mask banks (2 per bank)
+   *   - extended exact IDs  -> 32-bit ID-list banks (2 per bank)
+   *   - extended masks      -> 32-bit mask banks (1 per bank)
+   * If that still exceeds the bank budget, terms are merged into wider masks,
+   * always taking the merge that admits the fewest IDs nobody registered.
+   */
+
+/** Largest per-instance bank budget (CAN1 or CAN2 share of the 28 banks) */
+#define FEB_CAN_FILTER_PLAN_MAX_BANKS                                                                                  \
+  (((FEB_CAN_CAN2_FILTER_BANK_START - FEB_CAN_CAN1_FILTER_BANK_START) >                                               \
+    (FEB_CAN_TOTAL_FILTER_BANKS - FEB_CAN_CAN2_FILTER_BANK_START))                                                     \
+       ? (FEB_CAN_CAN2_FILTER_BANK_START - FEB_CAN_CAN1_FILTER_BANK_START)                                             \
+       : (FEB_CAN_TOTAL_FILTER_BANKS - FEB_CAN_CAN2_FILTER_BANK_START))
+
+  /**
+   * @brief One wanted ID (mask = all ones for an exact ID) or ID range
+   */
+  typedef struct
+  {
+    uint32_t id;     /**< CAN ID */
+    uint32_t mask;   /**< 1 bits must match (0x7FF / 0x1FFFFFFF = exact) */
+    uint8_t id_type; /**< FEB_CAN_ID_Type_t */
+    uint8_t fifo;    /**< FEB_CAN_FIFO_t */
+  } FEB_CAN_Filter_Term_t;
+
+  /**
+   * @brief Hardware layout of one compiled bank
+   */
+  typedef enum
+  {
+    FEB_CAN_BANK_LIST16 = 0, /**< 4 standard IDs: v[0..3] */
+    FEB_CAN_BANK_MASK16 = 1, /**< 2 standard id/mask pairs: v[0],v[1] and v[2],v[3] */
+    FEB_CAN_BANK_LIST32 = 2, /**< 2 extended IDs: v[0..1] */
+    FEB_CAN_BANK_MASK32 = 3, /**< 1 id/mask pair (standard or extended): v[0],v[1] */
+  } FEB_CAN_Bank_Kind_t;
+
+  typedef struct
+  {
+    uint32_t v[4];   /**< IDs / masks, see FEB_CAN_Bank_Kind_t (unused entries repeat the last one) */
+    uint8_t kind;    /**< FEB_CAN_Bank_Kind_t */
+    uint8_t id_type; /**< FEB_CAN_ID_Type_t (MASK32 only; 16-bit banks are standard, LIST32 extended) */
+    uint8_t fifo;    /**< FEB_CAN_FIFO_t */
+    uint8_t reserved;
+  } FEB_CAN_Filter_Bank_t;
+
+  typedef struct
+  {
+    FEB_CAN_Filter_Bank_t banks[FEB_CAN_FILTER_PLAN_MAX_BANKS];
+    uint8_t bank_count; /**< Banks used */
+    uint8_t term_count; /**< Terms after merging */
+    uint8_t merges;     /**< Merges needed to fit the budget */
+    bool accept_all;   /**< Could not fit (or wildcard): one accept-all bank */
+    uint32_t extra_ids; /**< Upper bound on IDs admitted that no term asked for (saturating) */
+  } FEB_CAN_Filter_Plan_t;
+
+  /**
+   * @brief Statistics of a plan replayed against a bus trace
+   */
+  typedef struct
+  {
+    uint32_t frames;       /**< Frames in the trace */
+    uint32_t wanted;       /**< Frames some term asked for */
+    uint32_t admitted;     /**< Frames the banks let through */
+    uint32_t false_admits; /**< Admitted but unwanted (ISR/queue/dispatch work for nothing) */
+    uint32_t missed;       /**< Wanted but rejected (always 0 unless the plan is broken) */
+  } FEB_CAN_Filter_TraceStats_t;
+
+  /**
+   * @brief Compile wanted IDs into at most @p max_banks filter banks
+   *
+   * @param terms Wanted IDs / ranges (duplicates allowed)
+   * @param count Number of terms (<= FEB_CAN_MAX_RX_HANDLES)
+   * @param max_banks Bank budget (<= FEB_CAN_FILTER_PLAN_MAX_BANKS)
+   * @param plan Output
+   * @return FEB_CAN_OK, or FEB_CAN_ERROR_INVALID_PARAM
+   */
+  FEB_CAN_Status_t FEB_CAN_Filter_Compile(const FEB_CAN_Filter_Term_t *terms, uint32_t count, uint8_t max_banks,
+                                          FEB_CAN_Filter_Plan_t *plan);
+
+  /**
+   * @brief Software model of the compiled banks: would this frame reach a FIFO?
+   */
+  bool FEB_CAN_Filter_PlanAdmits(const FEB_CAN_Filter_Plan_t *plan, uint32_t can_id, FEB_CAN_ID_Type_t id_type);
+
+  /**
+   * @brief Replay a recorded bus trace through a plan
+   *
+   * "False admit fraction" = stats->false_admits / stats->admitted.
+   *
+   * @param plan Compiled plan
+   * @param terms The terms the plan was compiled from (defines "wanted")
+   * @param term_count Number of terms
+   * @param frames Trace (only can_id / id_type are used)
+   * @param frame_count Number of frames
+   * @param stats Output
+   */
+  void FEB_CAN_Filter_EvaluateTrace(const FEB_CAN_Filter_Plan_t *plan, const FEB_CAN_Filter_Term_t *terms,
+                                    uint32_t term_count, const FEB_CAN_Message_t *frames, uint32_t frame_count,
+                                    FEB_CAN_Filter_TraceStats_t *stats);
+
   /**
    * @brief Dump filter registers for the given instance via LOG_D
    *
@@ -564,13 +746,50 @@ extern "C"
    */
   void FEB_CAN_RX_Process(void);
 
+  /**
+   * @brief Block until received frames arrive, then dispatch them
+   *
+   * With FEB_CAN_RX_BATCH the calling task becomes the RX task: the FIFO ISR
+   * sets FEB_CAN_RX_NOTIFY_FLAG on it once per drained batch, so the task
+   * wakes only when there is work instead of polling every tick. Without
+   * batching it blocks on rx_queue instead. Call from one task only.
+   * In bare-metal mode the callbacks already ran in the ISR: this sleeps
+   * (__WFI) until the ISR takes a frame or the timeout expires.
+   *
+   * @param timeout RTOS ticks to wait (osWaitForever to block); bare-metal:
+   *                HAL ticks (ms), 0xFFFFFFFF to block
+   * @return Number of frames dispatched, or taken by the ISR in bare-metal
+   *         mode (0 on timeout)
+   */
+  uint32_t FEB_CAN_RX_Wait(uint32_t timeout);
+
+  /**
+   * @brief Capture time of the frame currently being dispatched
+   *
+   * Valid inside an RX callback. Microseconds from the config's get_time_us
+   * source, read in the FIFO ISR (FEB_CAN_RX_BATCH or bare-metal). With the
+   * plain rx_queue only the ms tick travels with the frame, so this returns
+   * timestamp x 1000.
+   *
+   * @return Microseconds since boot
+   */
+  uint64_t FEB_CAN_RX_GetFrameTimeUs(void);
+
   /**
    * @brief Process periodic TX slots
    *
-   * Checks all registered periodic TX slots and transmits if due.
-   * Should be called from main loop or a timer callback.
+   * Transmits every periodic slot whose deadline has passed, earliest first.
+   * Slots are kept ordered by deadline, so a pass with nothing due is O(1).
+   * A slot that fell more than a period behind (stalled loop) sends once and
+   * rejoins its grid rather than bursting the missed frames.
+   * Should be called from main loop or a timer callback (bare metal: the tick
+   * ISR is fine). The schedule is locked against concurrent registration;
+   * slots are packed and sent with the lock released.
+   *
+   * @return Milliseconds until the next slot is due (0 = already due), or
+   *         FEB_CAN_TX_NO_PERIODIC. A task can sleep this long between passes.
    */
-  void FEB_CAN_TX_ProcessPeriodic(void);
+  uint32_t FEB_CAN_TX_ProcessPeriodic(void);
 
   /* ============================================================================
    * Status and Diagnostics API
@@ -638,6 +857,16 @@ extern "C"
    */
   uint32_t FEB_CAN_GetTxQueueOverflowCount(void);
 
+  /**
+   * @brief Get priority-lane TX overflow count
+   *
+   * Returns the number of FEB_CAN_TX_SendPriority() frames dropped because
+   * the priority ring was full (bare-metal mode only).
+   *
+   * @return Number of dropped priority TX messages
+   */
+  uint32_t FEB_CAN_GetTxPriorityOverflowCount(void);
+
   /**
    * @brief Get TX timeout count
    *
@@ -647,6 +876,16 @@ extern "C"
    */
   uint32_t FEB_CAN_GetTxTimeoutCount(void);
 
+  /**
+   * @brief Get periodic TX late count
+   *
+   * Number of times a periodic slot was serviced more than one full period
+   * after its deadline (main loop / task stalled) and skipped ahead.
+   *
+   * @return Number of late periodic slots
+   */
+  uint32_t FEB_CAN_GetTxPeriodicLateCount(void);
+
   /**
    * @brief Get HAL error count
    *
@@ -710,6 +949,25 @@ extern "C"
    */
   uint32_t FEB_CAN_GetLastErrorCode(void);
 
+  /**
+   * @brief RX interrupt batching statistics
+   */
+  typedef struct
+  {
+    uint32_t isr_batches;     /**< FIFO interrupts that delivered at least one frame */
+    uint32_t isr_frames;      /**< Frames read in those interrupts */
+    uint32_t max_batch;       /**< Most frames drained by one interrupt */
+    uint32_t ring_high_water; /**< Deepest RX ring fill seen (FEB_CAN_RX_BATCH only) */
+    uint32_t wakeups;         /**< FEB_CAN_RX_Wait returns (RX task wakeups) */
+  } FEB_CAN_RX_BatchStats_t;
+
+  /**
+   * @brief Get RX interrupt batching statistics
+   *
+   * @param stats Output
+   */
+  void FEB_CAN_GetRxBatchStats(FEB_CAN_RX_BatchStats_t *stats);
+
   /**
    * @brief Reset all error counters to zero
    */
@@ -41,6 +41,11 @@ static uint32_t feb_can_default_get_tick(void)
   return HAL_GetTick();
 }
 
+static uint64_t feb_can_default_get_time_us(void)
+{
+  return (uint64_t)feb_can_ctx.get_tick_ms() * 1000U;
+}
+
 /* ============================================================================
  * Instance Lookup Helper
  * ============================================================================ */
@@ -86,6 +91,7 @@ FEB_CAN_Status_t FEB_CAN_Init(const FEB_CAN_Config_t *config)
 
   /* Clear context */
   memset(&feb_can_ctx, 0, sizeof(feb_can_ctx));
+  feb_can_rx_index_rebuild();
 
   /* Store HAL handles */
   feb_can_ctx.hcan[FEB_CAN_INSTANCE_1] = config->hcan1;
@@ -93,10 +99,11 @@ FEB_CAN_Status_t FEB_CAN_Init(const FEB_CAN_Config_t *config)
 
   /* Set timestamp function */
   feb_can_ctx.get_tick_ms = config->get_tick_ms ? config->get_tick_ms : feb_can_default_get_tick;
+  feb_can_ctx.get_time_us = config->get_time_us ? config->get_time_us : feb_can_default_get_time_us;
 
 #if FEB_CAN_USE_FREERTOS
-  /* Validate REQUIRED sync primitives */
-  if (config->tx_queue == NULL || config->rx_queue == NULL)
+  /* Validate REQUIRED sync primitives (batched RX brings its own rings) */
+  if (config->tx_queue == NULL || (config->rx_queue == NULL && !FEB_CAN_RX_BATCH))
   {
     return FEB_CAN_ERROR_QUEUE;
   }
@@ -322,14 +329,81 @@ static void feb_can_rx_fifo_callback(FEB_CAN_Handle_t hcan_ptr, uint32_t fifo)
 
   CAN_HandleTypeDef *hcan = (CAN_HandleTypeDef *)hcan_ptr;
   CAN_RxHeaderTypeDef rx_header;
-  uint8_t rx_data[8];
+  FEB_CAN_Instance_t instance = feb_can_get_instance_from_handle(hcan);
+  uint32_t batch = 0;
 
   /* Do NOT call LOG_*() here. This is ISR context — FEB_UART_Write returns
    * -1 from ISR (so nothing prints), but FEB_Log_Output still allocates a
    * 128-byte isr_buffer + ~150 bytes of vsnprintf scratch on the MSP. With
    * the Cortex-M4F lazy-FPU frame (128 B) this can overflow the 1 KiB MSP
    * (_Min_Stack_Size = 0x400) when CAN frames cascade in loopback mode. Drain
-   * to the FreeRTOS RX queue and let FEB_CAN_RX_Process log from task ctx. */
+   * to the FreeRTOS RX queue (or batch ring) and let FEB_CAN_RX_Process log
+   * from task ctx. */
+
+#if FEB_CAN_USE_FREERTOS && FEB_CAN_RX_BATCH
+  if (instance >= FEB_CAN_INSTANCE_COUNT || instance >= FEB_CAN_NUM_INSTANCES)
+  {
+    /* No ring for this handle: pop the FIFO so the interrupt clears, and
+     * count the frames as dropped */
+    uint8_t discard[8];
+    while (HAL_CAN_GetRxFifoFillLevel(hcan, fifo) > 0 &&
+           HAL_CAN_GetRxMessage(hcan, fifo, &rx_header, discard) == HAL_OK)
+    {
+      feb_can_ctx.rx_queue_overflow_count++;
+    }
+    return;
+  }
+
+  /* Only this ISR writes head, so it is read plainly; tail belongs to the
+   * RX task and is loaded with acquire so a freed slot is really free */
+  FEB_CAN_RX_Ring_t *ring = &feb_can_ctx.rx_ring[instance][(fifo == CAN_RX_FIFO1) ? 1 : 0];
+  uint16_t head = ring->head;
+
+  while (HAL_CAN_GetRxFifoFillLevel(hcan, fifo) > 0)
+  {
+    uint16_t fill = (uint16_t)(head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE));
+    FEB_CAN_RX_Ring_Entry_t *entry = &ring->slot[head & (FEB_CAN_RX_RING_SIZE - 1U)];
+    uint8_t scratch[8];
+    uint8_t *dst = (fill < FEB_CAN_RX_RING_SIZE) ? entry->msg.data : scratch;
+
+    /* Read straight into the ring slot; a full ring still has to pop the
+     * hardware FIFO or the interrupt would re-fire forever */
+    if (HAL_CAN_GetRxMessage(hcan, fifo, &rx_header, dst) != HAL_OK)
+    {
+      break;
+    }
+
+    if (dst == scratch)
+    {
+      feb_can_ctx.rx_queue_overflow_count++;
+      continue;
+    }
+
+    entry->msg.can_id = (rx_header.IDE == CAN_ID_STD) ? rx_header.StdId : rx_header.ExtId;
+    entry->msg.id_type = (rx_header.IDE == CAN_ID_STD) ? FEB_CAN_ID_STD : FEB_CAN_ID_EXT;
+    entry->msg.instance = instance;
+    entry->msg.length = (uint8_t)rx_header.DLC;
+    entry->msg.timestamp = feb_can_ctx.get_tick_ms();
+    entry->time_us = feb_can_ctx.get_time_us();
+
+    head++;
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    batch++;
+
+    if ((uint32_t)fill + 1U > feb_can_ctx.rx_ring_high_water)
+    {
+      feb_can_ctx.rx_ring_high_water = (uint32_t)fill + 1U;
+    }
+  }
+
+  /* One wakeup per drained batch, however many frames it held */
+  void *rx_task = feb_can_ctx.rx_task;
+  if (batch > 0U && rx_task != NULL)
+  {
+    osThreadFlagsSet((osThreadId_t)rx_task, FEB_CAN_RX_NOTIFY_FLAG);
+  }
+#else
+  uint8_t rx_data[8];
 
   while (HAL_CAN_GetRxFifoFillLevel(hcan, fifo) > 0)
   {
@@ -338,10 +412,10 @@ static void feb_can_rx_fifo_callback(FEB_CAN_Handle_t hcan_ptr, uint32_t fifo)
       break;
     }
 
-    FEB_CAN_Instance_t instance = feb_can_get_instance_from_handle(hcan);
     uint32_t can_id = (rx_header.IDE == CAN_ID_STD) ? rx_header.StdId : rx_header.ExtId;
     uint8_t id_type = (rx_header.IDE == CAN_ID_STD) ? FEB_CAN_ID_STD : FEB_CAN_ID_EXT;
     uint32_t timestamp = feb_can_ctx.get_tick_ms();
+    batch++;
 
 #if FEB_CAN_USE_FREERTOS
     /* Queue message for deferred processing */
@@ -360,9 +434,21 @@ static void feb_can_rx_fifo_callback(FEB_CAN_Handle_t hcan_ptr, uint32_t fifo)
     }
 #else
     /* Direct dispatch in bare-metal mode */
+    feb_can_ctx.rx_frame_time_us = feb_can_ctx.get_time_us();
     feb_can_rx_dispatch(instance, can_id, id_type, rx_data, rx_header.DLC, timestamp);
 #endif
   }
+#endif
+
+  if (batch > 0U)
+  {
+    feb_can_ctx.rx_isr_batches++;
+    feb_can_ctx.rx_isr_frames += batch;
+    if (batch > feb_can_ctx.rx_isr_max_batch)
+    {
+      feb_can_ctx.rx_isr_max_batch = batch;
+    }
+  }
 }
 
 void FEB_CAN_RxFifo0Callback(FEB_CAN_Handle_t hcan)
@@ -379,13 +465,24 @@ void FEB_CAN_RxFifo1Callback(FEB_CAN_Handle_t hcan)
  * HAL Callback Routing - TX Complete
  * ============================================================================ */
 
-static void feb_can_tx_complete_callback(FEB_CAN_Handle_t hcan)
+static void feb_can_tx_complete_callback(FEB_CAN_Handle_t hcan, uint32_t box, bool sent)
 {
   if (!feb_can_ctx.initialized)
   {
     return;
   }
 
+  FEB_CAN_TX_Complete_Hook_t hook = feb_can_ctx.tx_complete_hook;
+  if (sent && hook != NULL)
+  {
+    FEB_CAN_Instance_t instance = feb_can_get_instance_from_handle((CAN_HandleTypeDef *)hcan);
+    if (instance < FEB_CAN_INSTANCE_COUNT)
+    {
+      const FEB_CAN_Message_t *m = &feb_can_ctx.tx_mailbox_msg[instance][box];
+      hook(instance, m->can_id, (FEB_CAN_ID_Type_t)m->id_type, m->data, m->length);
+    }
+  }
+
 #if FEB_CAN_USE_FREERTOS
   (void)hcan;
   /* One ISR notification ↔ one successful HAL_CAN_AddTxMessage (tx_pending_count++).
@@ -407,17 +504,17 @@ static void feb_can_tx_complete_callback(FEB_CAN_Handle_t hcan)
 
 void FEB_CAN_TxMailbox0CompleteCallback(FEB_CAN_Handle_t hcan)
 {
-  feb_can_tx_complete_callback(hcan);
+  feb_can_tx_complete_callback(hcan, 0, true);
 }
 
 void FEB_CAN_TxMailbox1CompleteCallback(FEB_CAN_Handle_t hcan)
 {
-  feb_can_tx_complete_callback(hcan);
+  feb_can_tx_complete_callback(hcan, 1, true);
 }
 
 void FEB_CAN_TxMailbox2CompleteCallback(FEB_CAN_Handle_t hcan)
 {
-  feb_can_tx_complete_callback(hcan);
+  feb_can_tx_complete_callback(hcan, 2, true);
 }
 
 /* Software-abort callbacks: hardware mailbox is freed regardless, so the
@@ -427,17 +524,17 @@ void FEB_CAN_TxMailbox2CompleteCallback(FEB_CAN_Handle_t hcan)
  * this stays correct without a second bug hunt. */
 void FEB_CAN_TxMailbox0AbortCallback(FEB_CAN_Handle_t hcan)
 {
-  feb_can_tx_complete_callback(hcan);
+  feb_can_tx_complete_callback(hcan, 0, false);
 }
 
 void FEB_CAN_TxMailbox1AbortCallback(FEB_CAN_Handle_t hcan)
 {
-  feb_can_tx_complete_callback(hcan);
+  feb_can_tx_complete_callback(hcan, 1, false);
 }
 
 void FEB_CAN_TxMailbox2AbortCallback(FEB_CAN_Handle_t hcan)
 {
-  feb_can_tx_complete_callback(hcan);
+  feb_can_tx_complete_callback(hcan, 2, false);
 }
 
 /* ============================================================================
@@ -662,7 +759,18 @@ uint32_t FEB_CAN_TX_GetQueuePending(void)
 
 uint32_t FEB_CAN_RX_GetQueuePending(void)
 {
-#if FEB_CAN_USE_FREERTOS
+#if FEB_CAN_USE_FREERTOS && FEB_CAN_RX_BATCH
+  uint32_t pending = 0;
+  for (uint32_t inst = 0; inst < FEB_CAN_NUM_INSTANCES; inst++)
+  {
+    for (uint32_t fifo = 0; fifo < 2U; fifo++)
+    {
+      const FEB_CAN_RX_Ring_t *ring = &feb_can_ctx.rx_ring[inst][fifo];
+      pending += (uint16_t)(__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - ring->tail);
+    }
+  }
+  return pending;
+#elif FEB_CAN_USE_FREERTOS
   if (feb_can_ctx.rx_queue != NULL)
   {
     return FEB_CAN_QUEUE_COUNT(feb_can_ctx.rx_queue);
@@ -685,11 +793,21 @@ uint32_t FEB_CAN_GetTxQueueOverflowCount(void)
   return feb_can_ctx.tx_queue_overflow_count;
 }
 
+uint32_t FEB_CAN_GetTxPriorityOverflowCount(void)
+{
+  return feb_can_ctx.tx_prio_overflow_count;
+}
+
 uint32_t FEB_CAN_GetTxTimeoutCount(void)
 {
   return feb_can_ctx.tx_timeout_count;
 }
 
+uint32_t FEB_CAN_GetTxPeriodicLateCount(void)
+{
+  return feb_can_ctx.tx_periodic_late_count;
+}
+
 uint32_t FEB_CAN_GetHalErrorCount(void)
 {
   return feb_can_ctx.hal_error_count;
@@ -720,14 +838,34 @@ uint32_t FEB_CAN_GetLastErrorCode(void)
   return feb_can_ctx.last_error_code;
 }
 
+void FEB_CAN_GetRxBatchStats(FEB_CAN_RX_BatchStats_t *stats)
+{
+  if (stats == NULL)
+  {
+    return;
+  }
+  stats->isr_batches = feb_can_ctx.rx_isr_batches;
+  stats->isr_frames = feb_can_ctx.rx_isr_frames;
+  stats->max_batch = feb_can_ctx.rx_isr_max_batch;
+  stats->ring_high_water = feb_can_ctx.rx_ring_high_water;
+  stats->wakeups = feb_can_ctx.rx_wakeups;
+}
+
 void FEB_CAN_ResetErrorCounters(void)
 {
   feb_can_ctx.rx_queue_overflow_count = 0;
   feb_can_ctx.tx_queue_overflow_count = 0;
+  feb_can_ctx.tx_prio_overflow_count = 0;
   feb_can_ctx.tx_timeout_count = 0;
+  feb_can_ctx.tx_periodic_late_count = 0;
   feb_can_ctx.hal_error_count = 0;
   feb_can_ctx.bus_off_count = 0;
   feb_can_ctx.ewg_recovery_count = 0;
+  feb_can_ctx.rx_isr_batches = 0;
+  feb_can_ctx.rx_isr_frames = 0;
+  feb_can_ctx.rx_isr_max_batch = 0;
+  feb_can_ctx.rx_ring_high_water = 0;
+  feb_can_ctx.rx_wakeups = 0;
 }
 
 const char *FEB_CAN_StatusToString(FEB_CAN_Status_t status)
@@ -758,6 +896,8 @@ const char *FEB_CAN_StatusToString(FEB_CAN_Status_t status)
     return "NO_MUTEX";
   case FEB_CAN_ERROR_NO_SEMAPHORE:
     return "NO_SEMAPHORE";
+  case FEB_CAN_ERROR_UNSUPPORTED:
+    return "UNSUPPORTED";
   default:
     return "UNKNOWN";
   }
@@ -192,6 +192,108 @@ static FEB_CAN_Status_t feb_can_filter_disable(uint8_t filter_bank)
   return FEB_CAN_OK;
 }
 
+/* ============================================================================
+ * Compiled Bank Programming
+ * ============================================================================ */
+
+/* 16-bit filter element for a standard data/remote frame: STID[10:0] RTR IDE EXID[17:15] */
+#define FEB_CAN_FILTER16_STD(id) ((uint16_t)(((id) & 0x7FFU) << 5))
+#define FEB_CAN_FILTER16_IDE 0x0008U
+
+/* 32-bit filter word for an extended frame: EXID[28:0] IDE RTR 0 */
+#define FEB_CAN_FILTER32_EXT(id) ((((id) & 0x1FFFFFFFU) << 3) | CAN_ID_EXT)
+#define FEB_CAN_FILTER32_IDE CAN_ID_EXT
+
+static FEB_CAN_Status_t feb_can_filter_apply_bank(uint8_t filter_bank, const FEB_CAN_Filter_Bank_t *b)
+{
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+
+  CAN_HandleTypeDef *hcan = feb_can_get_filter_handle(ctx);
+  if (hcan == NULL)
+  {
+    return FEB_CAN_ERROR_NOT_INIT;
+  }
+
+  CAN_FilterTypeDef filter_config = {0};
+  filter_config.FilterBank = filter_bank;
+  filter_config.FilterFIFOAssignment = (b->fifo == FEB_CAN_FIFO_0) ? CAN_RX_FIFO0 : CAN_RX_FIFO1;
+  filter_config.FilterActivation = ENABLE;
+  filter_config.SlaveStartFilterBank = FEB_CAN_CAN2_FILTER_BANK_START;
+
+  /* HAL packs FR1 = MaskIdLow:IdLow and FR2 = MaskIdHigh:IdHigh */
+  switch (b->kind)
+  {
+  case FEB_CAN_BANK_LIST16:
+    filter_config.FilterMode = CAN_FILTERMODE_IDLIST;
+    filter_config.FilterScale = CAN_FILTERSCALE_16BIT;
+    filter_config.FilterIdLow = FEB_CAN_FILTER16_STD(b->v[0]);
+    filter_config.FilterMaskIdLow = FEB_CAN_FILTER16_STD(b->v[1]);
+    filter_config.FilterIdHigh = FEB_CAN_FILTER16_STD(b->v[2]);
+    filter_config.FilterMaskIdHigh = FEB_CAN_FILTER16_STD(b->v[3]);
+    break;
+  case FEB_CAN_BANK_MASK16:
+    /* IDE in the mask keeps extended frames out of standard-ID ranges */
+    filter_config.FilterMode = CAN_FILTERMODE_IDMASK;
+    filter_config.FilterScale = CAN_FILTERSCALE_16BIT;
+    filter_config.FilterIdLow = FEB_CAN_FILTER16_STD(b->v[0]);
+    filter_config.FilterMaskIdLow = FEB_CAN_FILTER16_STD(b->v[1]) | FEB_CAN_FILTER16_IDE;
+    filter_config.FilterIdHigh = FEB_CAN_FILTER16_STD(b->v[2]);
+    filter_config.FilterMaskIdHigh = FEB_CAN_FILTER16_STD(b->v[3]) | FEB_CAN_FILTER16_IDE;
+    break;
+  case FEB_CAN_BANK_LIST32:
+    filter_config.FilterMode = CAN_FILTERMODE_IDLIST;
+    filter_config.FilterScale = CAN_FILTERSCALE_32BIT;
+    filter_config.FilterIdHigh = (uint16_t)(FEB_CAN_FILTER32_EXT(b->v[0]) >> 16);
+    filter_config.FilterIdLow = (uint16_t)(FEB_CAN_FILTER32_EXT(b->v[0]) & 0xFFFFU);
+    filter_config.FilterMaskIdHigh = (uint16_t)(FEB_CAN_FILTER32_EXT(b->v[1]) >> 16);
+    filter_config.FilterMaskIdLow = (uint16_t)(FEB_CAN_FILTER32_EXT(b->v[1]) & 0xFFFFU);
+    break;
+  case FEB_CAN_BANK_MASK32:
+  default:
+    filter_config.FilterMode = CAN_FILTERMODE_IDMASK;
+    filter_config.FilterScale = CAN_FILTERSCALE_32BIT;
+    if (b->v[1] == 0U)
+    {
+      /* Accept-all: leave every bit (IDE included) unconstrained */
+    }
+    else if (b->id_type == FEB_CAN_ID_STD)
+    {
+      filter_config.FilterIdHigh = (uint16_t)((b->v[0] << 5) & 0xFFFFU);
+      filter_config.FilterMaskIdHigh = (uint16_t)((b->v[1] << 5) & 0xFFFFU);
+      filter_config.FilterMaskIdLow = FEB_CAN_FILTER32_IDE;
+    }
+    else
+    {
+      filter_config.FilterIdHigh = (uint16_t)(FEB_CAN_FILTER32_EXT(b->v[0]) >> 16);
+      filter_config.FilterIdLow = (uint16_t)(FEB_CAN_FILTER32_EXT(b->v[0]) & 0xFFFFU);
+      filter_config.FilterMaskIdHigh = (uint16_t)(((b->v[1] << 3) | FEB_CAN_FILTER32_IDE) >> 16);
+      filter_config.FilterMaskIdLow = (uint16_t)(((b->v[1] << 3) | FEB_CAN_FILTER32_IDE) & 0xFFFFU);
+    }
+    break;
+  }
+
+  if (HAL_CAN_ConfigFilter(hcan, &filter_config) != HAL_OK)
+  {
+    LOG_W("[CAN-FLT]", "ConfigFilter FAILED bank=%u kind=%u", filter_bank, (unsigned)b->kind);
+    return FEB_CAN_ERROR_HAL;
+  }
+
+  LOG_T("[CAN-FLT]", "bank=%u kind=%u fifo=%u v=0x%lX 0x%lX 0x%lX 0x%lX", filter_bank, (unsigned)b->kind,
+        (unsigned)b->fifo, (unsigned long)b->v[0], (unsigned long)b->v[1], (unsigned long)b->v[2],
+        (unsigned long)b->v[3]);
+
+  /* Track filter in context (first element of the bank) */
+  bool is_list = (b->kind == FEB_CAN_BANK_LIST16 || b->kind == FEB_CAN_BANK_LIST32);
+  ctx->filters[filter_bank].id = b->v[0];
+  ctx->filters[filter_bank].mask = is_list ? ((b->kind == FEB_CAN_BANK_LIST16) ? 0x7FFU : 0x1FFFFFFFU) : b->v[1];
+  ctx->filters[filter_bank].id_type = b->id_type;
+  ctx->filters[filter_bank].fifo = b->fifo;
+  ctx->filters[filter_bank].is_active = true;
+  ctx->filters[filter_bank].mode = is_list ? CAN_FILTERMODE_IDLIST : CAN_FILTERMODE_IDMASK;
+
+  return FEB_CAN_OK;
+}
+
 /* ============================================================================
  * Update Filters From Registry
  * ============================================================================ */
@@ -214,14 +316,13 @@ FEB_CAN_Status_t FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_Instance_t instance)
   uint8_t filter_end = feb_can_get_filter_bank_end(instance);
   uint8_t current_filter = filter_start;
 
-  /* Collect unique IDs from RX handles for this instance */
+  /* Init-time only: static to keep ~1 KB of term/plan tables off the caller's stack */
+  static FEB_CAN_Filter_Term_t terms[FEB_CAN_MAX_RX_HANDLES];
+  static FEB_CAN_Filter_Plan_t plan;
+
+  /* Collect exact / mask terms from RX handles for this instance */
   bool has_wildcard = false;
-  uint32_t unique_ids[FEB_CAN_MAX_RX_HANDLES];
-  uint8_t unique_id_types[FEB_CAN_MAX_RX_HANDLES];
-  uint32_t unique_masks[FEB_CAN_MAX_RX_HANDLES];
-  uint8_t unique_fifos[FEB_CAN_MAX_RX_HANDLES];
-  uint8_t unique_filter_types[FEB_CAN_MAX_RX_HANDLES];
-  uint32_t unique_count = 0;
+  uint32_t term_count = 0;
 
   for (uint32_t i = 0; i < FEB_CAN_MAX_RX_HANDLES; i++)
   {
@@ -238,27 +339,13 @@ FEB_CAN_Status_t FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_Instance_t instance)
       continue;
     }
 
-    /* Check if this ID/mask combination is already tracked */
-    bool found = false;
-    for (uint32_t j = 0; j < unique_count; j++)
-    {
-      if (unique_ids[j] == handle->can_id && unique_id_types[j] == handle->id_type && unique_masks[j] == handle->mask &&
-          unique_filter_types[j] == handle->filter_type)
-      {
-        found = true;
-        break;
-      }
-    }
-
-    if (!found && unique_count < FEB_CAN_MAX_RX_HANDLES)
-    {
-      unique_ids[unique_count] = handle->can_id;
-      unique_id_types[unique_count] = handle->id_type;
-      unique_masks[unique_count] = handle->mask;
-      unique_fifos[unique_count] = handle->fifo;
-      unique_filter_types[unique_count] = handle->filter_type;
-      unique_count++;
-    }
+    terms[term_count].id = handle->can_id;
+    terms[term_count].mask = (handle->filter_type == FEB_CAN_FILTER_MASK)
+                                 ? handle->mask
+                                 : ((handle->id_type == FEB_CAN_ID_STD) ? 0x7FFU : 0x1FFFFFFFU);
+    terms[term_count].id_type = handle->id_type;
+    terms[term_count].fifo = handle->fifo;
+    term_count++;
   }
 
   /* If wildcard is present, configure one filter to accept all */
@@ -270,7 +357,7 @@ FEB_CAN_Status_t FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_Instance_t instance)
       current_filter++;
     }
   }
-  else if (unique_count == 0)
+  else if (term_count == 0)
   {
     /* No handlers registered - configure reject-all filter */
     /* Use mask that matches nothing (ID = max, mask = max) */
@@ -282,35 +369,35 @@ FEB_CAN_Status_t FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_Instance_t instance)
   }
   else
   {
-    /* Configure one filter per unique ID */
-    for (uint32_t i = 0; i < unique_count && current_filter < filter_end; i++)
+    uint8_t budget = (uint8_t)(filter_end - filter_start);
+    if (FEB_CAN_Filter_Compile(terms, term_count, budget, &plan) != FEB_CAN_OK)
     {
-      uint32_t mask;
-      if (unique_filter_types[i] == FEB_CAN_FILTER_MASK)
-      {
-        mask = unique_masks[i];
-      }
-      else
-      {
-        /* Exact match */
-        mask = (unique_id_types[i] == FEB_CAN_ID_STD) ? 0x7FF : 0x1FFFFFFF;
-      }
-
-      FEB_CAN_Filter_Configure(instance, current_filter, unique_ids[i], mask, (FEB_CAN_ID_Type_t)unique_id_types[i],
-                               (FEB_CAN_FIFO_t)unique_fifos[i]);
+      return FEB_CAN_ERROR_INVALID_PARAM;
+    }
+
+    for (uint8_t i = 0; i < plan.bank_count && current_filter < filter_end; i++)
+    {
+      feb_can_filter_apply_bank(current_filter, &plan.banks[i]);
       current_filter++;
     }
-  }
 
-  /* Registered IDs beyond the bank budget never get a hardware filter and
-   * their frames are silently dropped — make that loud and report it. */
-  uint32_t needed = unique_count + (has_wildcard ? 1u : 0u);
-  uint32_t available = (uint32_t)(filter_end - filter_start);
-  bool overflow = (needed > available);
-  if (overflow)
-  {
-    LOG_E("[CAN-FLT]", "Filter overflow: %lu IDs registered, %lu banks available — %lu ID(s) will NOT be received",
-          (unsigned long)needed, (unsigned long)available, (unsigned long)(needed - available));
+    /* Merging never drops a registered ID, but it lets extra traffic in */
+    if (plan.accept_all)
+    {
+      LOG_W("[CAN-FLT]", "%lu filter terms do not fit %u banks - accepting all frames", (unsigned long)term_count,
+            (unsigned)budget);
+    }
+    else if (plan.merges > 0U)
+    {
+      LOG_W("[CAN-FLT]", "%lu filter terms merged into %u banks (%u merges, +%lu unregistered IDs admitted)",
+            (unsigned long)term_count, (unsigned)plan.bank_count, (unsigned)plan.merges,
+            (unsigned long)plan.extra_ids);
+    }
+    else
+    {
+      LOG_D("[CAN-FLT]", "%lu filter terms packed into %u of %u banks", (unsigned long)term_count,
+            (unsigned)plan.bank_count, (unsigned)budget);
+    }
   }
 
   /* Disable remaining filter banks for this instance */
@@ -320,7 +407,7 @@ FEB_CAN_Status_t FEB_CAN_Filter_UpdateFromRegistry(FEB_CAN_Instance_t instance)
     current_filter++;
   }
 
-  return overflow ? FEB_CAN_ERROR_FULL : FEB_CAN_OK;
+  return FEB_CAN_OK;
 }
 
 /* ============================================================================
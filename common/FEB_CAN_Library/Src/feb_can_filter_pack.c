@@ -0,0 +1,495 @@
+/**
+ ******************************************************************************
+ * @file           : feb_can_filter_pack.c
+ * @brief          : Filter compiler for FEB CAN Library
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Turns a list of wanted IDs / ranges into bxCAN filter banks. No HAL calls,
+ * so the same code runs on the host against recorded bus traces.
+ *
+ * Bank cost of a term set (per FIFO, banks never mix FIFOs):
+ *   ceil(E / 4) + ceil(M / 2) + ceil(XE / 2) + XM
+ * with E/M the standard exact/mask terms and XE/XM the extended ones. A lone
+ * leftover exact ID rides in the spare half of an odd 16-bit mask bank.
+ *
+ * Over budget, two terms of the same FIFO and ID type are merged into the
+ * tightest mask covering both: mask = m1 & m2 & ~(id1 ^ id2). Any other term
+ * the new mask already covers is absorbed. The cost of a merge is the number
+ * of IDs it newly admits. Two greedy rankings are run (cheapest merge first,
+ * and cheapest per bank saved) and the plan admitting fewer extra IDs wins.
+ ******************************************************************************
+ */
+
+#include "feb_can_lib.h"
+#include <string.h>
+
+#if FEB_CAN_MAX_RX_HANDLES > 64
+#error "feb_can_filter_pack.c tracks terms in a 64-bit set"
+#endif
+
+/* ============================================================================
+ * Term Helpers
+ * ============================================================================ */
+
+static uint32_t pack_width_mask(uint8_t id_type)
+{
+  return (id_type == FEB_CAN_ID_STD) ? 0x7FFU : 0x1FFFFFFFU;
+}
+
+static bool pack_is_exact(const FEB_CAN_Filter_Term_t *t)
+{
+  return t->mask == pack_width_mask(t->id_type);
+}
+
+/* Number of IDs a term admits */
+static uint64_t pack_term_size(const FEB_CAN_Filter_Term_t *t)
+{
+  uint32_t free_bits = (uint32_t)__builtin_popcount(pack_width_mask(t->id_type) & ~t->mask);
+  return 1ULL << free_bits;
+}
+
+static bool pack_same_group(const FEB_CAN_Filter_Term_t *a, const FEB_CAN_Filter_Term_t *b)
+{
+  return a->id_type == b->id_type && a->fifo == b->fifo;
+}
+
+/* True if every ID of @p inner is also admitted by @p outer */
+static bool pack_covers(const FEB_CAN_Filter_Term_t *outer, const FEB_CAN_Filter_Term_t *inner)
+{
+  return pack_same_group(outer, inner) && (inner->mask & outer->mask) == outer->mask &&
+         ((inner->id ^ outer->id) & outer->mask) == 0U;
+}
+
+static bool pack_term_matches(const FEB_CAN_Filter_Term_t *t, uint32_t can_id, uint8_t id_type)
+{
+  return t->id_type == id_type && ((can_id ^ t->id) & t->mask) == 0U;
+}
+
+/*
+ * Banks needed for work[] minus the terms in @p skip, plus @p extra (if not
+ * NULL). Lets the merge search price a candidate without building it.
+ */
+static uint32_t pack_bank_count(const FEB_CAN_Filter_Term_t *work, uint32_t n, uint64_t skip,
+                                const FEB_CAN_Filter_Term_t *extra)
+{
+  uint32_t banks = 0;
+
+  for (uint8_t fifo = 0; fifo < 2U; fifo++)
+  {
+    uint32_t e = 0, m = 0, xe = 0, xm = 0;
+    for (uint32_t i = 0; i <= n; i++)
+    {
+      const FEB_CAN_Filter_Term_t *t;
+      if (i < n)
+      {
+        if ((skip >> i) & 1U)
+        {
+          continue;
+        }
+        t = &work[i];
+      }
+      else if (extra != NULL)
+      {
+        t = extra;
+      }
+      else
+      {
+        break;
+      }
+      if (t->fifo != fifo)
+      {
+        continue;
+      }
+      bool exact = pack_is_exact(t);
+      if (t->id_type == FEB_CAN_ID_STD)
+      {
+        exact ? e++ : m++;
+      }
+      else
+      {
+        exact ? xe++ : xm++;
+      }
+    }
+
+    uint32_t fifo_banks = (e + 3U) / 4U + (m + 1U) / 2U + (xe + 1U) / 2U + xm;
+    if ((m % 2U) == 1U && (e % 4U) == 1U)
+    {
+      fifo_banks--;
+    }
+    banks += fifo_banks;
+  }
+
+  return banks;
+}
+
+/* ============================================================================
+ * Compiler
+ * ============================================================================ */
+
+static void pack_emit(FEB_CAN_Filter_Plan_t *plan, uint8_t kind, uint8_t id_type, uint8_t fifo, const uint32_t *v,
+                      uint8_t used)
+{
+  FEB_CAN_Filter_Bank_t *b = &plan->banks[plan->bank_count++];
+  b->kind = kind;
+  b->id_type = id_type;
+  b->fifo = fifo;
+  b->reserved = 0;
+  for (uint8_t i = 0; i < 4U; i++)
+  {
+    b->v[i] = v[(i < used) ? i : (uint8_t)(used - 1U)];
+  }
+}
+
+static void pack_emit_all(FEB_CAN_Filter_Plan_t *plan, const FEB_CAN_Filter_Term_t *work, uint32_t n)
+{
+  for (uint8_t fifo = 0; fifo < 2U; fifo++)
+  {
+    uint32_t std_ids[FEB_CAN_MAX_RX_HANDLES];
+    uint32_t std_pairs[2U * FEB_CAN_MAX_RX_HANDLES];
+    uint32_t e = 0, m = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+      if (work[i].fifo != fifo || work[i].id_type != FEB_CAN_ID_STD)
+      {
+        continue;
+      }
+      if (pack_is_exact(&work[i]))
+      {
+        std_ids[e++] = work[i].id;
+      }
+      else
+      {
+        std_pairs[2U * m] = work[i].id;
+        std_pairs[2U * m + 1U] = work[i].mask;
+        m++;
+      }
+    }
+
+    /* Lone leftover exact ID fills the spare half of the last 16-bit mask bank */
+    if ((m % 2U) == 1U && (e % 4U) == 1U)
+    {
+      e--;
+      std_pairs[2U * m] = std_ids[e];
+      std_pairs[2U * m + 1U] = 0x7FFU;
+      m++;
+    }
+
+    for (uint32_t i = 0; i < e; i += 4U)
+    {
+      pack_emit(plan, FEB_CAN_BANK_LIST16, FEB_CAN_ID_STD, fifo, &std_ids[i], (uint8_t)((e - i < 4U) ? e - i : 4U));
+    }
+    for (uint32_t i = 0; i < m; i += 2U)
+    {
+      uint32_t v[4] = {std_pairs[2U * i], std_pairs[2U * i + 1U], 0, 0};
+      if (i + 1U < m)
+      {
+        v[2] = std_pairs[2U * i + 2U];
+        v[3] = std_pairs[2U * i + 3U];
+      }
+      else
+      {
+        v[2] = v[0];
+        v[3] = v[1];
+      }
+      pack_emit(plan, FEB_CAN_BANK_MASK16, FEB_CAN_ID_STD, fifo, v, 4U);
+    }
+
+    uint32_t ext_ids[2];
+    uint8_t pending = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+      if (work[i].fifo != fifo || work[i].id_type != FEB_CAN_ID_EXT)
+      {
+        continue;
+      }
+      if (pack_is_exact(&work[i]))
+      {
+        ext_ids[pending++] = work[i].id;
+        if (pending == 2U)
+        {
+          pack_emit(plan, FEB_CAN_BANK_LIST32, FEB_CAN_ID_EXT, fifo, ext_ids, 2U);
+          pending = 0;
+        }
+      }
+      else
+      {
+        uint32_t v[2] = {work[i].id, work[i].mask};
+        pack_emit(plan, FEB_CAN_BANK_MASK32, FEB_CAN_ID_EXT, fifo, v, 2U);
+      }
+    }
+    if (pending != 0U)
+    {
+      pack_emit(plan, FEB_CAN_BANK_LIST32, FEB_CAN_ID_EXT, fifo, ext_ids, 1U);
+    }
+  }
+}
+
+/*
+ * Merge terms in place until they fit @p max_banks. Two rankings, since
+ * neither wins everywhere: @p cheapest_first takes the merge admitting the
+ * fewest new IDs even if it saves no bank yet (pairs nearby IDs first and
+ * collects them into masks), otherwise bank-saving merges are taken first by
+ * cost per bank saved. Returns false if even one term per group does not fit.
+ */
+static bool pack_reduce(FEB_CAN_Filter_Term_t *work, uint32_t *count, uint8_t max_banks, bool cheapest_first,
+                        uint64_t *extra, uint8_t *merges)
+{
+  uint32_t n = *count;
+
+  while (pack_bank_count(work, n, 0, NULL) > max_banks)
+  {
+    const uint32_t banks_now = pack_bank_count(work, n, 0, NULL);
+    bool found = false;
+    int32_t best_saved = 0;
+    uint64_t best_cost = 0;
+    FEB_CAN_Filter_Term_t best_term = {0};
+    uint64_t best_absorbed = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t j = i + 1U; j < n; j++)
+      {
+        if (!pack_same_group(&work[i], &work[j]))
+        {
+          continue;
+        }
+
+        FEB_CAN_Filter_Term_t merged = work[i];
+        merged.mask = work[i].mask & work[j].mask & ~(work[i].id ^ work[j].id);
+        merged.id = work[i].id & merged.mask;
+
+        uint64_t absorbed = 0;
+        uint64_t covered_size = 0;
+        for (uint32_t k = 0; k < n; k++)
+        {
+          if (pack_covers(&merged, &work[k]))
+          {
+            absorbed |= 1ULL << k;
+            covered_size += pack_term_size(&work[k]);
+          }
+        }
+        uint64_t size = pack_term_size(&merged);
+        uint64_t cost = (size > covered_size) ? (size - covered_size) : 0U;
+        int32_t saved = (int32_t)banks_now - (int32_t)pack_bank_count(work, n, absorbed, &merged);
+
+        bool better;
+        if (!found)
+        {
+          better = true;
+        }
+        else if (!cheapest_first && (saved > 0) != (best_saved > 0))
+        {
+          better = (saved > 0);
+        }
+        else if (!cheapest_first && saved > 0)
+        {
+          better = cost * (uint64_t)best_saved < best_cost * (uint64_t)saved;
+        }
+        else
+        {
+          better = cost < best_cost || (cost == best_cost && saved > best_saved);
+        }
+
+        if (better)
+        {
+          found = true;
+          best_saved = saved;
+          best_cost = cost;
+          best_term = merged;
+          best_absorbed = absorbed;
+        }
+      }
+    }
+
+    if (!found)
+    {
+      /* One term per FIFO/ID-type group and still over budget */
+      return false;
+    }
+
+    uint32_t kept = 0;
+    for (uint32_t k = 0; k < n; k++)
+    {
+      if (((best_absorbed >> k) & 1U) == 0U)
+      {
+        work[kept++] = work[k];
+      }
+    }
+    n = kept;
+    work[n++] = best_term;
+    *extra += best_cost;
+    (*merges)++;
+  }
+
+  *count = n;
+  return true;
+}
+
+FEB_CAN_Status_t FEB_CAN_Filter_Compile(const FEB_CAN_Filter_Term_t *terms, uint32_t count, uint8_t max_banks,
+                                        FEB_CAN_Filter_Plan_t *plan)
+{
+  if (plan == NULL || (terms == NULL && count > 0U) || count > FEB_CAN_MAX_RX_HANDLES || max_banks == 0U ||
+      max_banks > FEB_CAN_FILTER_PLAN_MAX_BANKS)
+  {
+    return FEB_CAN_ERROR_INVALID_PARAM;
+  }
+
+  memset(plan, 0, sizeof(*plan));
+
+  /* Normalize, then drop duplicates and terms another term already covers */
+  FEB_CAN_Filter_Term_t work[FEB_CAN_MAX_RX_HANDLES];
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    FEB_CAN_Filter_Term_t t = terms[i];
+    t.id_type = (t.id_type == FEB_CAN_ID_STD) ? FEB_CAN_ID_STD : FEB_CAN_ID_EXT;
+    t.fifo = (t.fifo == FEB_CAN_FIFO_0) ? FEB_CAN_FIFO_0 : FEB_CAN_FIFO_1;
+    t.mask &= pack_width_mask(t.id_type);
+    t.id &= t.mask;
+
+    bool redundant = false;
+    for (uint32_t j = 0; j < n && !redundant; j++)
+    {
+      redundant = pack_covers(&work[j], &t);
+    }
+    if (redundant)
+    {
+      continue;
+    }
+    uint32_t kept = 0;
+    for (uint32_t j = 0; j < n; j++)
+    {
+      if (!pack_covers(&t, &work[j]))
+      {
+        work[kept++] = work[j];
+      }
+    }
+    n = kept;
+    work[n++] = t;
+  }
+
+  /* Run both rankings and keep whichever admits fewer unwanted IDs */
+  FEB_CAN_Filter_Term_t alt[FEB_CAN_MAX_RX_HANDLES];
+  uint32_t alt_n = n;
+  memcpy(alt, work, n * sizeof(work[0]));
+
+  uint64_t extra = 0;
+  uint64_t alt_extra = 0;
+  uint8_t merges = 0;
+  uint8_t alt_merges = 0;
+  bool fits = pack_reduce(work, &n, max_banks, false, &extra, &merges);
+  bool alt_fits = pack_reduce(alt, &alt_n, max_banks, true, &alt_extra, &alt_merges);
+
+  if (!fits && !alt_fits)
+  {
+    const uint32_t v[2] = {0U, 0U};
+    pack_emit(plan, FEB_CAN_BANK_MASK32, FEB_CAN_ID_STD, FEB_CAN_FIFO_0, v, 2U);
+    plan->accept_all = true;
+    plan->term_count = 0;
+    plan->extra_ids = UINT32_MAX;
+    return FEB_CAN_OK;
+  }
+
+  if (!fits || (alt_fits && alt_extra < extra))
+  {
+    memcpy(work, alt, alt_n * sizeof(alt[0]));
+    n = alt_n;
+    extra = alt_extra;
+    merges = alt_merges;
+  }
+
+  pack_emit_all(plan, work, n);
+  plan->term_count = (uint8_t)n;
+  plan->merges = merges;
+  plan->extra_ids = (extra > UINT32_MAX) ? UINT32_MAX : (uint32_t)extra;
+  return FEB_CAN_OK;
+}
+
+/* ============================================================================
+ * Plan Evaluation
+ * ============================================================================ */
+
+bool FEB_CAN_Filter_PlanAdmits(const FEB_CAN_Filter_Plan_t *plan, uint32_t can_id, FEB_CAN_ID_Type_t id_type)
+{
+  if (plan == NULL)
+  {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < plan->bank_count; i++)
+  {
+    const FEB_CAN_Filter_Bank_t *b = &plan->banks[i];
+    switch (b->kind)
+    {
+    case FEB_CAN_BANK_LIST16:
+      if (id_type == FEB_CAN_ID_STD &&
+          (can_id == b->v[0] || can_id == b->v[1] || can_id == b->v[2] || can_id == b->v[3]))
+      {
+        return true;
+      }
+      break;
+    case FEB_CAN_BANK_MASK16:
+      if (id_type == FEB_CAN_ID_STD && (((can_id ^ b->v[0]) & b->v[1]) == 0U || ((can_id ^ b->v[2]) & b->v[3]) == 0U))
+      {
+        return true;
+      }
+      break;
+    case FEB_CAN_BANK_LIST32:
+      if (id_type == FEB_CAN_ID_EXT && (can_id == b->v[0] || can_id == b->v[1]))
+      {
+        return true;
+      }
+      break;
+    case FEB_CAN_BANK_MASK32:
+      /* An all-zero mask is the accept-all bank and ignores the ID type */
+      if (b->v[1] == 0U || (id_type == b->id_type && ((can_id ^ b->v[0]) & b->v[1]) == 0U))
+      {
+        return true;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  return false;
+}
+
+void FEB_CAN_Filter_EvaluateTrace(const FEB_CAN_Filter_Plan_t *plan, const FEB_CAN_Filter_Term_t *terms,
+                                  uint32_t term_count, const FEB_CAN_Message_t *frames, uint32_t frame_count,
+                                  FEB_CAN_Filter_TraceStats_t *stats)
+{
+  if (stats == NULL)
+  {
+    return;
+  }
+  memset(stats, 0, sizeof(*stats));
+  if (plan == NULL || frames == NULL)
+  {
+    return;
+  }
+
+  for (uint32_t f = 0; f < frame_count; f++)
+  {
+    uint32_t can_id = frames[f].can_id;
+    uint8_t id_type = (frames[f].id_type == FEB_CAN_ID_STD) ? FEB_CAN_ID_STD : FEB_CAN_ID_EXT;
+
+    bool wanted = false;
+    for (uint32_t t = 0; t < term_count && !wanted; t++)
+    {
+      FEB_CAN_Filter_Term_t term = terms[t];
+      term.mask &= pack_width_mask(term.id_type);
+      wanted = pack_term_matches(&term, can_id, id_type);
+    }
+    bool admitted = FEB_CAN_Filter_PlanAdmits(plan, can_id, (FEB_CAN_ID_Type_t)id_type);
+
+    stats->frames++;
+    stats->wanted += wanted ? 1U : 0U;
+    stats->admitted += admitted ? 1U : 0U;
+    stats->false_admits += (admitted && !wanted) ? 1U : 0U;
+    stats->missed += (wanted && !admitted) ? 1U : 0U;
+  }
+}
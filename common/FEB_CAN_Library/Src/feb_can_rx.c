@@ -13,85 +13,168 @@
 #include <string.h>
 
 /* ============================================================================
- * Internal RX Dispatch Function
+ * RX Dispatch Index
+ * ============================================================================
+ *
+ * The dispatcher used to walk every FEB_CAN_MAX_RX_HANDLES slot and test
+ * instance, ID type and filter for each received frame. With DASH/DCU-sized
+ * registries that is dozens of compares per frame in the RX task. Instead the
+ * handle table is compiled into FEB_CAN_RX_Index_t on every register/unregister:
+ * exact handles resolve with one hash + (usually) one probe, and only mask and
+ * wildcard handles are still tested linearly.
+ *
+ * Register/Unregister can run at any time (the PingPong console commands do),
+ * while bare-metal boards dispatch straight from the RX FIFO interrupt. The
+ * index is therefore double-buffered: the rebuild writes the copy dispatch is
+ * not reading and publishes it with a single release store of rx_index_live.
+ * A dispatch that loaded the old pointer finishes on the old, still intact
+ * copy; that copy is only rewritten by the next rebuild after this one.
  * ============================================================================ */
 
-void feb_can_rx_dispatch(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_t id_type, const uint8_t *data,
-                         uint8_t length, uint32_t timestamp)
+static inline uint32_t feb_can_rx_hash(uint8_t instance, uint8_t id_type, uint32_t can_id)
+{
+  /* CAN IDs are at most 29 bits, so instance/id_type fold into the top bits
+   * without colliding with ID bits. Fibonacci hashing spreads the dense,
+   * sequential ID ranges the SN4 message set uses across the buckets. */
+  uint32_t key = can_id ^ ((uint32_t)id_type << 29) ^ ((uint32_t)instance << 30);
+  return (key * 2654435761u) >> (32u - FEB_CAN_RX_HASH_BITS);
+}
+
+static inline bool feb_can_rx_key_equal(const FEB_CAN_RX_Handle_Internal_t *h, uint8_t instance, uint8_t id_type,
+                                        uint32_t can_id)
+{
+  return h->can_id == can_id && h->id_type == id_type && h->instance == instance;
+}
+
+void feb_can_rx_index_rebuild(void)
 {
   FEB_CAN_Context_t *ctx = feb_can_get_context();
+  FEB_CAN_RX_Index_t *live = __atomic_load_n(&ctx->rx_index_live, __ATOMIC_RELAXED);
+  FEB_CAN_RX_Index_t *idx = (live == &ctx->rx_index[0]) ? &ctx->rx_index[1] : &ctx->rx_index[0];
 
-  /* No per-frame LOG_D here: in loopback this runs at >100 Hz with a wildcard
-   * handler and saturates the UART, masking other diagnostic output. The
-   * registered RX callback can log if the application wants per-frame trace. */
+  memset(idx->hash, FEB_CAN_RX_INDEX_EMPTY, sizeof(idx->hash));
+  memset(idx->chain, FEB_CAN_RX_INDEX_EMPTY, sizeof(idx->chain));
+  idx->slow_count = 0;
 
-  bool dispatched_any = false;
+  /* Tail of each key's chain, indexed by the chain head, so handles sharing a
+   * key keep slot order when dispatched. */
+  uint8_t tail[FEB_CAN_MAX_RX_HANDLES];
 
   for (uint32_t i = 0; i < FEB_CAN_MAX_RX_HANDLES; i++)
   {
-    FEB_CAN_RX_Handle_Internal_t *handle = &ctx->rx_handles[i];
+    const FEB_CAN_RX_Handle_Internal_t *h = &ctx->rx_handles[i];
 
-    if (!handle->is_active)
+    if (!h->is_active)
     {
       continue;
     }
 
-    /* Check instance */
-    if (handle->instance != instance)
+    if (h->filter_type != FEB_CAN_FILTER_EXACT)
     {
+      idx->slow[idx->slow_count++] = (uint8_t)i;
       continue;
     }
 
-    /* Check ID type */
-    if (handle->id_type != id_type)
+    uint32_t bucket = feb_can_rx_hash(h->instance, h->id_type, h->can_id);
+    for (;;)
     {
-      continue;
+      uint8_t head = idx->hash[bucket];
+      if (head == FEB_CAN_RX_INDEX_EMPTY)
+      {
+        idx->hash[bucket] = (uint8_t)i;
+        tail[i] = (uint8_t)i;
+        break;
+      }
+      if (feb_can_rx_key_equal(&ctx->rx_handles[head], h->instance, h->id_type, h->can_id))
+      {
+        idx->chain[tail[head]] = (uint8_t)i;
+        tail[head] = (uint8_t)i;
+        break;
+      }
+      bucket = (bucket + 1u) & (FEB_CAN_RX_HASH_SIZE - 1u);
     }
+  }
+
+  __atomic_store_n(&ctx->rx_index_live, idx, __ATOMIC_RELEASE);
+}
+
+/* ============================================================================
+ * Internal RX Dispatch Function
+ * ============================================================================ */
 
-    /* Check filter match */
-    bool match = false;
-    switch (handle->filter_type)
+static void feb_can_rx_invoke(const FEB_CAN_RX_Handle_Internal_t *handle, FEB_CAN_Instance_t instance,
+                              uint32_t can_id, uint8_t id_type, const uint8_t *data, uint8_t length,
+                              uint32_t timestamp)
+{
+  if (handle->is_extended_cb)
+  {
+    FEB_CAN_RX_Extended_Callback_t ext_cb = (FEB_CAN_RX_Extended_Callback_t)handle->callback;
+    if (ext_cb != NULL)
     {
-    case FEB_CAN_FILTER_EXACT:
-      match = (can_id == handle->can_id);
-      break;
+      ext_cb(instance, can_id, (FEB_CAN_ID_Type_t)id_type, data, length, timestamp, 0, handle->user_data);
+    }
+  }
+  else
+  {
+    FEB_CAN_RX_Callback_t cb = (FEB_CAN_RX_Callback_t)handle->callback;
+    if (cb != NULL)
+    {
+      cb(instance, can_id, (FEB_CAN_ID_Type_t)id_type, data, length, handle->user_data);
+    }
+  }
+}
 
-    case FEB_CAN_FILTER_MASK:
-      match = ((can_id & handle->mask) == (handle->can_id & handle->mask));
-      break;
+void feb_can_rx_dispatch(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_t id_type, const uint8_t *data,
+                         uint8_t length, uint32_t timestamp)
+{
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+  const FEB_CAN_RX_Index_t *idx = __atomic_load_n(&ctx->rx_index_live, __ATOMIC_ACQUIRE);
 
-    case FEB_CAN_FILTER_WILDCARD:
-      match = true;
-      break;
+  /* No per-frame LOG_D here: in loopback this runs at >100 Hz with a wildcard
+   * handler and saturates the UART, masking other diagnostic output. The
+   * registered RX callback can log if the application wants per-frame trace. */
+
+  bool dispatched_any = false;
 
-    default:
+  /* Exact handles: probe until the key is found or an empty bucket ends it */
+  uint32_t bucket = feb_can_rx_hash((uint8_t)instance, id_type, can_id);
+  for (;;)
+  {
+    uint8_t head = idx->hash[bucket];
+    if (head == FEB_CAN_RX_INDEX_EMPTY)
+    {
       break;
     }
-
-    if (!match)
+    if (feb_can_rx_key_equal(&ctx->rx_handles[head], (uint8_t)instance, id_type, can_id))
     {
-      continue;
+      for (uint8_t i = head; i != FEB_CAN_RX_INDEX_EMPTY; i = idx->chain[i])
+      {
+        feb_can_rx_invoke(&ctx->rx_handles[i], instance, can_id, id_type, data, length, timestamp);
+      }
+      dispatched_any = true;
+      break;
     }
+    bucket = (bucket + 1u) & (FEB_CAN_RX_HASH_SIZE - 1u);
+  }
 
-    dispatched_any = true;
+  /* Mask and wildcard handles */
+  for (uint32_t s = 0; s < idx->slow_count; s++)
+  {
+    const FEB_CAN_RX_Handle_Internal_t *handle = &ctx->rx_handles[idx->slow[s]];
 
-    /* Invoke callback */
-    if (handle->is_extended_cb)
+    if (handle->instance != instance || handle->id_type != id_type)
     {
-      FEB_CAN_RX_Extended_Callback_t ext_cb = (FEB_CAN_RX_Extended_Callback_t)handle->callback;
-      if (ext_cb != NULL)
-      {
-        ext_cb(instance, can_id, (FEB_CAN_ID_Type_t)id_type, data, length, timestamp, 0, handle->user_data);
-      }
+      continue;
     }
-    else
+
+    if (handle->filter_type == FEB_CAN_FILTER_MASK &&
+        (can_id & handle->mask) != (handle->can_id & handle->mask))
     {
-      FEB_CAN_RX_Callback_t cb = (FEB_CAN_RX_Callback_t)handle->callback;
-      if (cb != NULL)
-      {
-        cb(instance, can_id, (FEB_CAN_ID_Type_t)id_type, data, length, handle->user_data);
-      }
+      continue;
     }
+
+    dispatched_any = true;
+    feb_can_rx_invoke(handle, instance, can_id, id_type, data, length, timestamp);
   }
 
   if (!dispatched_any)
@@ -177,6 +260,7 @@ int32_t FEB_CAN_RX_Register(const FEB_CAN_RX_Params_t *params)
   handle->is_active = true;
 
   ctx->rx_handle_count++;
+  feb_can_rx_index_rebuild();
 
 #if FEB_CAN_USE_FREERTOS
   FEB_CAN_MUTEX_UNLOCK(ctx->rx_mutex);
@@ -244,6 +328,7 @@ int32_t FEB_CAN_RX_RegisterExtended(const FEB_CAN_RX_Params_t *params, FEB_CAN_R
   handle->is_active = true;
 
   ctx->rx_handle_count++;
+  feb_can_rx_index_rebuild();
 
 #if FEB_CAN_USE_FREERTOS
   FEB_CAN_MUTEX_UNLOCK(ctx->rx_mutex);
@@ -284,7 +369,10 @@ FEB_CAN_Status_t FEB_CAN_RX_Unregister(int32_t handle)
 
   FEB_CAN_Instance_t instance = (FEB_CAN_Instance_t)h->instance;
 
-  /* Clear handle */
+  /* Drop the handle from the index before clearing it, so a frame dispatched
+   * from the previous index still finds its key and callback intact */
+  h->is_active = false;
+  feb_can_rx_index_rebuild();
   memset(h, 0, sizeof(FEB_CAN_RX_Handle_Internal_t));
   ctx->rx_handle_count--;
 
@@ -329,12 +417,52 @@ uint32_t FEB_CAN_RX_GetRegisteredCount(void)
  * RX Process Function (FreeRTOS mode)
  * ============================================================================ */
 
+#if FEB_CAN_USE_FREERTOS && FEB_CAN_RX_BATCH
+/* Dispatch everything currently in the ISR rings. Single consumer. */
+static uint32_t feb_can_rx_drain_rings(FEB_CAN_Context_t *ctx)
+{
+  uint32_t count = 0;
+
+  for (uint32_t inst = 0; inst < FEB_CAN_NUM_INSTANCES; inst++)
+  {
+    for (uint32_t fifo = 0; fifo < 2U; fifo++)
+    {
+      FEB_CAN_RX_Ring_t *ring = &ctx->rx_ring[inst][fifo];
+      uint16_t tail = ring->tail;
+      uint16_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+      while (tail != head)
+      {
+        const FEB_CAN_RX_Ring_Entry_t *entry = &ring->slot[tail & (FEB_CAN_RX_RING_SIZE - 1U)];
+        ctx->rx_frame_time_us = entry->time_us;
+        feb_can_rx_dispatch((FEB_CAN_Instance_t)entry->msg.instance, entry->msg.can_id, entry->msg.id_type,
+                            entry->msg.data, entry->msg.length, entry->msg.timestamp);
+        tail++;
+        /* Release per frame so a long callback does not starve the ISR */
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+        count++;
+      }
+    }
+  }
+
+  return count;
+}
+#endif
+
 void FEB_CAN_RX_Process(void)
 {
 #if FEB_CAN_USE_FREERTOS
   FEB_CAN_Context_t *ctx = feb_can_get_context();
 
-  if (!ctx->initialized || ctx->rx_queue == NULL)
+  if (!ctx->initialized)
+  {
+    return;
+  }
+
+#if FEB_CAN_RX_BATCH
+  feb_can_rx_drain_rings(ctx);
+#else
+  if (ctx->rx_queue == NULL)
   {
     return;
   }
@@ -344,9 +472,87 @@ void FEB_CAN_RX_Process(void)
   /* Process all pending messages */
   while (FEB_CAN_QUEUE_RECEIVE(ctx->rx_queue, &msg, 0))
   {
+    ctx->rx_frame_time_us = (uint64_t)msg.timestamp * 1000U;
     feb_can_rx_dispatch((FEB_CAN_Instance_t)msg.instance, msg.can_id, msg.id_type, msg.data, msg.length, msg.timestamp);
   }
+#endif
 #else
   /* In bare-metal mode, callbacks are invoked directly in ISR */
 #endif
 }
+
+uint32_t FEB_CAN_RX_Wait(uint32_t timeout)
+{
+#if FEB_CAN_USE_FREERTOS
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+
+  if (!ctx->initialized)
+  {
+    return 0;
+  }
+
+  uint32_t count;
+
+#if FEB_CAN_RX_BATCH
+  if (ctx->rx_task == NULL)
+  {
+    ctx->rx_task = (void *)osThreadGetId();
+  }
+
+  /* Clear before draining: a batch that lands after the drain sets the flag
+   * again and ends the wait, so no frame can sit unnoticed in a ring */
+  osThreadFlagsClear(FEB_CAN_RX_NOTIFY_FLAG);
+  count = feb_can_rx_drain_rings(ctx);
+  if (count == 0U)
+  {
+    osThreadFlagsWait(FEB_CAN_RX_NOTIFY_FLAG, osFlagsWaitAny, timeout);
+    count = feb_can_rx_drain_rings(ctx);
+  }
+#else
+  if (ctx->rx_queue == NULL)
+  {
+    return 0;
+  }
+
+  FEB_CAN_Message_t msg;
+  count = 0;
+
+  /* Block for the first frame only, then take whatever else is queued */
+  while (FEB_CAN_QUEUE_RECEIVE(ctx->rx_queue, &msg, (count == 0U) ? timeout : 0U))
+  {
+    ctx->rx_frame_time_us = (uint64_t)msg.timestamp * 1000U;
+    feb_can_rx_dispatch((FEB_CAN_Instance_t)msg.instance, msg.can_id, msg.id_type, msg.data, msg.length, msg.timestamp);
+    count++;
+  }
+#endif
+
+  ctx->rx_wakeups++;
+  return count;
+#else
+  /* Bare-metal: the FIFO ISR has already run the callbacks, so this only
+   * waits for it to take a frame. Sleep between interrupts until it does or
+   * the timeout (ms, 0xFFFFFFFF = forever) runs out, so a caller looping on
+   * this cannot spin. */
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+
+  if (!ctx->initialized)
+  {
+    return 0;
+  }
+
+  const uint32_t seen = ctx->rx_isr_frames;
+  const uint32_t start = ctx->get_tick_ms();
+  while (ctx->rx_isr_frames == seen && (timeout == 0xFFFFFFFFU || ctx->get_tick_ms() - start < timeout))
+  {
+    __WFI();
+  }
+
+  ctx->rx_wakeups++;
+  return ctx->rx_isr_frames - seen;
+#endif
+}
+
+uint64_t FEB_CAN_RX_GetFrameTimeUs(void)
+{
+  return feb_can_get_context()->rx_frame_time_us;
+}
@@ -73,10 +73,17 @@ int feb_can_tx_hal_transmit(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_
   ctx->tx_pending_count++;
 #endif
 
-  /* Add to mailbox */
+  /* Load the mailbox and record the frame in it as one step. The 1 ms tick
+   * runs above the CAN interrupts, so between the two it could finish this
+   * frame and let the TX-complete hook read the previous frame's record.
+   * Nest-safe PRIMASK save/restore, as in the FIFO below. */
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+
   uint32_t tx_mailbox;
   if (HAL_CAN_AddTxMessage(hcan, &tx_header, tx_data, &tx_mailbox) != HAL_OK)
   {
+    __set_PRIMASK(primask);
 #if FEB_CAN_USE_FREERTOS
     /* Rollback the increment on failure */
     if (ctx->tx_pending_count > 0)
@@ -91,6 +98,14 @@ int feb_can_tx_hal_transmit(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_
     return -FEB_CAN_ERROR_HAL;
   }
 
+  uint32_t box = (tx_mailbox == CAN_TX_MAILBOX0) ? 0U : (tx_mailbox == CAN_TX_MAILBOX1) ? 1U : 2U;
+  FEB_CAN_Message_t *loaded = &ctx->tx_mailbox_msg[instance][box];
+  loaded->can_id = can_id;
+  loaded->id_type = id_type;
+  loaded->length = length;
+  memcpy(loaded->data, tx_data, sizeof(loaded->data));
+
+  __set_PRIMASK(primask);
   return FEB_CAN_OK;
 }
 
@@ -117,7 +132,7 @@ int feb_can_tx_hal_transmit(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_
  * context.
  * ============================================================================ */
 
-bool feb_can_tx_enqueue(FEB_CAN_Instance_t instance, const FEB_CAN_Message_t *msg)
+bool feb_can_tx_enqueue(FEB_CAN_Instance_t instance, const FEB_CAN_Message_t *msg, bool priority)
 {
   FEB_CAN_Context_t *ctx = feb_can_get_context();
 
@@ -130,7 +145,21 @@ bool feb_can_tx_enqueue(FEB_CAN_Instance_t instance, const FEB_CAN_Message_t *ms
   __disable_irq();
 
   bool queued = false;
-  if (ctx->tx_ring_count[instance] < FEB_CAN_TX_QUEUE_SIZE)
+  if (priority)
+  {
+    if (ctx->tx_prio_count[instance] < FEB_CAN_TX_PRIO_QUEUE_SIZE)
+    {
+      ctx->tx_prio_ring[instance][ctx->tx_prio_head[instance]] = *msg;
+      ctx->tx_prio_head[instance] = (uint16_t)((ctx->tx_prio_head[instance] + 1u) % FEB_CAN_TX_PRIO_QUEUE_SIZE);
+      ctx->tx_prio_count[instance]++;
+      queued = true;
+    }
+    else
+    {
+      ctx->tx_prio_overflow_count++;
+    }
+  }
+  else if (ctx->tx_ring_count[instance] < FEB_CAN_TX_QUEUE_SIZE)
   {
     ctx->tx_ring[instance][ctx->tx_ring_head[instance]] = *msg;
     ctx->tx_ring_head[instance] = (uint16_t)((ctx->tx_ring_head[instance] + 1u) % FEB_CAN_TX_QUEUE_SIZE);
@@ -164,7 +193,21 @@ void feb_can_tx_pump(FEB_CAN_Instance_t instance)
   uint32_t primask = __get_PRIMASK();
   __disable_irq();
 
-  while (ctx->tx_ring_count[instance] > 0 && HAL_CAN_GetTxMailboxesFreeLevel(hcan) > 0)
+  while (ctx->tx_prio_count[instance] > 0 && HAL_CAN_GetTxMailboxesFreeLevel(hcan) > 0)
+  {
+    const FEB_CAN_Message_t *m = &ctx->tx_prio_ring[instance][ctx->tx_prio_tail[instance]];
+    if (feb_can_tx_hal_transmit(instance, m->can_id, m->id_type, m->data, m->length) < 0)
+    {
+      /* Same retry rules as the FIFO below; it cannot load either. */
+      __set_PRIMASK(primask);
+      return;
+    }
+    ctx->tx_prio_tail[instance] = (uint16_t)((ctx->tx_prio_tail[instance] + 1u) % FEB_CAN_TX_PRIO_QUEUE_SIZE);
+    ctx->tx_prio_count[instance]--;
+  }
+
+  while (ctx->tx_ring_count[instance] > 0 &&
+         HAL_CAN_GetTxMailboxesFreeLevel(hcan) > ctx->tx_reserved_mailboxes[instance])
   {
     const FEB_CAN_Message_t *m = &ctx->tx_ring[instance][ctx->tx_ring_tail[instance]];
     int result = feb_can_tx_hal_transmit(instance, m->can_id, m->id_type, m->data, m->length);
@@ -184,6 +227,226 @@ void feb_can_tx_pump(FEB_CAN_Instance_t instance)
 }
 #endif /* !FEB_CAN_USE_FREERTOS */
 
+/* ============================================================================
+ * Periodic TX Schedule
+ * ============================================================================
+ *
+ * Every slot with period_ms > 0 fires on a fixed tick grid (tick % period ==
+ * phase) and sits in ctx->tx_sched ordered by next_due. ProcessPeriodic pops
+ * due slots off the head and re-inserts them one period later, so it never
+ * touches slots that are not due.
+ *
+ * Two slots on grids (p1, P1) and (p2, P2) land in the same millisecond iff
+ * p1 == p2 (mod gcd(P1, P2)). Auto-spread uses that to pick, for a new slot,
+ * the phase with the fewest same-tick collisions on its instance, breaking
+ * ties by the largest distance to the nearest neighbour. That replaces the
+ * hand-offset dividers boards used to keep bursts out of the 3 mailboxes.
+ *
+ * The schedule is edited from registration (setup or console task) and from
+ * ProcessPeriodic, which a board may run from its tick ISR, so every access
+ * goes through sched_lock(): tx_mutex under FreeRTOS, PRIMASK on bare metal.
+ * Slots are packed and sent outside the lock, and the phase search, which is
+ * O(period x slots), runs on a snapshot of the other slots' grids.
+ * ============================================================================ */
+
+static inline uint32_t sched_lock(FEB_CAN_Context_t *ctx)
+{
+#if FEB_CAN_USE_FREERTOS
+  FEB_CAN_MUTEX_LOCK(ctx->tx_mutex);
+  return 0U;
+#else
+  (void)ctx;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+#endif
+}
+
+static inline void sched_unlock(FEB_CAN_Context_t *ctx, uint32_t key)
+{
+#if FEB_CAN_USE_FREERTOS
+  (void)key;
+  FEB_CAN_MUTEX_UNLOCK(ctx->tx_mutex);
+#else
+  (void)ctx;
+  __set_PRIMASK(key);
+#endif
+}
+
+static inline bool sched_tick_before(uint32_t a, uint32_t b)
+{
+  return (int32_t)(a - b) < 0;
+}
+
+static uint32_t sched_gcd(uint32_t a, uint32_t b)
+{
+  while (b != 0U)
+  {
+    uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/* First tick at or after @p from that lies on the (period, phase) grid */
+static uint32_t sched_align(uint32_t from, uint32_t period, uint32_t phase)
+{
+  return from + (phase + period - (from % period)) % period;
+}
+
+static void sched_remove(FEB_CAN_Context_t *ctx, uint8_t idx)
+{
+  for (uint8_t i = 0; i < ctx->tx_sched_count; i++)
+  {
+    if (ctx->tx_sched[i] == idx)
+    {
+      memmove(&ctx->tx_sched[i], &ctx->tx_sched[i + 1], (size_t)(ctx->tx_sched_count - i - 1U));
+      ctx->tx_sched_count--;
+      return;
+    }
+  }
+}
+
+/* Insert after any slot with the same deadline so equal-deadline slots keep FIFO order */
+static void sched_insert(FEB_CAN_Context_t *ctx, uint8_t idx)
+{
+  uint32_t due = ctx->tx_handles[idx].next_due;
+  uint8_t pos = ctx->tx_sched_count;
+  while (pos > 0U && sched_tick_before(due, ctx->tx_handles[ctx->tx_sched[pos - 1U]].next_due))
+  {
+    ctx->tx_sched[pos] = ctx->tx_sched[pos - 1U];
+    pos--;
+  }
+  ctx->tx_sched[pos] = idx;
+  ctx->tx_sched_count++;
+}
+
+/* Grid of another slot on the same instance, copied out for the phase search */
+typedef struct
+{
+  uint32_t period;
+  uint32_t phase;
+} sched_grid_t;
+
+static bool sched_contains(const FEB_CAN_Context_t *ctx, uint8_t idx)
+{
+  for (uint8_t i = 0; i < ctx->tx_sched_count; i++)
+  {
+    if (ctx->tx_sched[i] == idx)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Under sched_lock(): grids of the scheduled slots sharing @p self's instance */
+static uint8_t sched_snapshot(const FEB_CAN_Context_t *ctx, uint8_t self, sched_grid_t *grids)
+{
+  const FEB_CAN_TX_Handle_Internal_t *h = &ctx->tx_handles[self];
+  uint8_t n = 0;
+
+  for (uint8_t i = 0; i < ctx->tx_sched_count; i++)
+  {
+    const FEB_CAN_TX_Handle_Internal_t *o = &ctx->tx_handles[ctx->tx_sched[i]];
+    if (ctx->tx_sched[i] == self || o->instance != h->instance)
+    {
+      continue;
+    }
+    grids[n].period = o->period_ms;
+    grids[n].phase = o->phase;
+    n++;
+  }
+  return n;
+}
+
+/* Lock-free: reduces each grid to (gcd, phase mod gcd) in place, then scores
+ * every phase of @p period against them. */
+static uint32_t sched_pick_phase(uint32_t period, sched_grid_t *grids, uint8_t n)
+{
+  uint32_t best_phase = 0;
+  uint32_t best_collisions = UINT32_MAX;
+  uint32_t best_gap = 0;
+
+  for (uint8_t i = 0; i < n; i++)
+  {
+    grids[i].period = sched_gcd(period, grids[i].period);
+    grids[i].phase %= grids[i].period;
+  }
+
+  for (uint32_t phase = 0; phase < period; phase++)
+  {
+    uint32_t collisions = 0;
+    uint32_t gap = UINT32_MAX;
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+      uint32_t g = grids[i].period;
+      uint32_t d = (phase % g + g - grids[i].phase) % g;
+      if (d == 0U)
+      {
+        collisions++;
+      }
+      if (g - d < d)
+      {
+        d = g - d;
+      }
+      if (d < gap)
+      {
+        gap = d;
+      }
+    }
+
+    if (collisions < best_collisions || (collisions == best_collisions && gap > best_gap))
+    {
+      best_phase = phase;
+      best_collisions = collisions;
+      best_gap = gap;
+    }
+  }
+
+  return best_phase;
+}
+
+/* (Re)compute phase and first deadline, then enter the slot into the schedule.
+ * Called under sched_lock(); an auto-spread search drops the lock while it
+ * runs and retakes it through @p key. */
+static void sched_add(FEB_CAN_Context_t *ctx, uint8_t idx, uint32_t *key)
+{
+  FEB_CAN_TX_Handle_Internal_t *h = &ctx->tx_handles[idx];
+  uint32_t period = h->period_ms;
+  if (period == 0U)
+  {
+    return;
+  }
+
+  uint32_t phase;
+  if (h->phase_ms != 0U)
+  {
+    phase = h->phase_ms % period;
+  }
+  else
+  {
+    sched_grid_t grids[FEB_CAN_MAX_TX_HANDLES];
+    uint8_t n = sched_snapshot(ctx, idx, grids);
+
+    sched_unlock(ctx, *key);
+    phase = sched_pick_phase(period, grids, n);
+    *key = sched_lock(ctx);
+
+    /* Unregistered, re-timed or already scheduled by another caller meanwhile */
+    if (!h->is_active || h->period_ms != period || sched_contains(ctx, idx))
+    {
+      return;
+    }
+  }
+
+  h->phase = phase;
+  h->next_due = sched_align(ctx->get_tick_ms(), period, phase);
+  sched_insert(ctx, idx);
+}
+
 /* ============================================================================
  * TX Registration API
  * ============================================================================ */
@@ -207,9 +470,7 @@ int32_t FEB_CAN_TX_Register(const FEB_CAN_TX_Params_t *params)
     return -FEB_CAN_ERROR_INVALID_PARAM;
   }
 
-#if FEB_CAN_USE_FREERTOS
-  FEB_CAN_MUTEX_LOCK(ctx->tx_mutex);
-#endif
+  uint32_t key = sched_lock(ctx);
 
   /* Find free slot */
   int32_t free_slot = -1;
@@ -224,9 +485,7 @@ int32_t FEB_CAN_TX_Register(const FEB_CAN_TX_Params_t *params)
 
   if (free_slot < 0)
   {
-#if FEB_CAN_USE_FREERTOS
-    FEB_CAN_MUTEX_UNLOCK(ctx->tx_mutex);
-#endif
+    sched_unlock(ctx, key);
     return -FEB_CAN_ERROR_FULL;
   }
 
@@ -239,14 +498,14 @@ int32_t FEB_CAN_TX_Register(const FEB_CAN_TX_Params_t *params)
   handle->data_size = params->data_size;
   handle->period_ms = params->period_ms;
   handle->pack_func = params->pack_func;
+  handle->phase_ms = params->phase_ms;
   handle->last_tx_time = 0;
   handle->is_active = true;
 
   ctx->tx_handle_count++;
+  sched_add(ctx, (uint8_t)free_slot, &key);
 
-#if FEB_CAN_USE_FREERTOS
-  FEB_CAN_MUTEX_UNLOCK(ctx->tx_mutex);
-#endif
+  sched_unlock(ctx, key);
 
   return free_slot;
 }
@@ -265,26 +524,21 @@ FEB_CAN_Status_t FEB_CAN_TX_Unregister(int32_t handle)
     return FEB_CAN_ERROR_INVALID_PARAM;
   }
 
-#if FEB_CAN_USE_FREERTOS
-  FEB_CAN_MUTEX_LOCK(ctx->tx_mutex);
-#endif
+  uint32_t key = sched_lock(ctx);
 
   FEB_CAN_TX_Handle_Internal_t *h = &ctx->tx_handles[handle];
   if (!h->is_active)
   {
-#if FEB_CAN_USE_FREERTOS
-    FEB_CAN_MUTEX_UNLOCK(ctx->tx_mutex);
-#endif
+    sched_unlock(ctx, key);
     return FEB_CAN_ERROR_NOT_FOUND;
   }
 
   /* Clear handle */
+  sched_remove(ctx, (uint8_t)handle);
   memset(h, 0, sizeof(FEB_CAN_TX_Handle_Internal_t));
   ctx->tx_handle_count--;
 
-#if FEB_CAN_USE_FREERTOS
-  FEB_CAN_MUTEX_UNLOCK(ctx->tx_mutex);
-#endif
+  sched_unlock(ctx, key);
 
   return FEB_CAN_OK;
 }
@@ -303,13 +557,20 @@ FEB_CAN_Status_t FEB_CAN_TX_SetPeriod(int32_t handle, uint32_t period_ms)
     return FEB_CAN_ERROR_INVALID_PARAM;
   }
 
+  uint32_t key = sched_lock(ctx);
+
   FEB_CAN_TX_Handle_Internal_t *h = &ctx->tx_handles[handle];
   if (!h->is_active)
   {
+    sched_unlock(ctx, key);
     return FEB_CAN_ERROR_NOT_FOUND;
   }
 
+  sched_remove(ctx, (uint8_t)handle);
   h->period_ms = period_ms;
+  sched_add(ctx, (uint8_t)handle, &key);
+
+  sched_unlock(ctx, key);
 
   return FEB_CAN_OK;
 }
@@ -390,7 +651,59 @@ FEB_CAN_Status_t FEB_CAN_TX_Send(FEB_CAN_Instance_t instance, uint32_t can_id, F
     memset(msg.data, 0, sizeof(msg.data));
   }
 
-  if (!feb_can_tx_enqueue(instance, &msg))
+  if (!feb_can_tx_enqueue(instance, &msg, false))
+  {
+    return FEB_CAN_ERROR_FULL;
+  }
+  feb_can_tx_pump(instance);
+  return FEB_CAN_OK;
+#endif
+}
+
+FEB_CAN_Status_t FEB_CAN_TX_SendPriority(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                                         const uint8_t *data, uint8_t length)
+{
+#if FEB_CAN_USE_FREERTOS
+  /* One TX queue feeds the mailboxes in FreeRTOS mode; no lane to jump.
+   * Fail loudly so a control frame is not sent behind telemetry unnoticed. */
+  (void)instance;
+  (void)can_id;
+  (void)id_type;
+  (void)data;
+  (void)length;
+  return FEB_CAN_ERROR_UNSUPPORTED;
+#else
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+
+  if (!ctx->initialized)
+  {
+    return FEB_CAN_ERROR_NOT_INIT;
+  }
+
+  if (instance >= FEB_CAN_INSTANCE_COUNT)
+  {
+    return FEB_CAN_ERROR_INVALID_PARAM;
+  }
+
+  if (length > 8)
+  {
+    length = 8;
+  }
+
+  FEB_CAN_Message_t msg;
+  msg.can_id = can_id;
+  msg.id_type = (uint8_t)id_type;
+  msg.instance = (uint8_t)instance;
+  msg.length = length;
+  msg.reserved = 0;
+  msg.timestamp = ctx->get_tick_ms();
+  memset(msg.data, 0, sizeof(msg.data));
+  if (data != NULL && length > 0)
+  {
+    memcpy(msg.data, data, length);
+  }
+
+  if (!feb_can_tx_enqueue(instance, &msg, true))
   {
     return FEB_CAN_ERROR_FULL;
   }
@@ -399,6 +712,29 @@ FEB_CAN_Status_t FEB_CAN_TX_Send(FEB_CAN_Instance_t instance, uint32_t can_id, F
 #endif
 }
 
+FEB_CAN_Status_t FEB_CAN_TX_ReserveMailboxes(FEB_CAN_Instance_t instance, uint8_t count)
+{
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+
+  if (!ctx->initialized)
+  {
+    return FEB_CAN_ERROR_NOT_INIT;
+  }
+
+  if (instance >= FEB_CAN_INSTANCE_COUNT || count > 2)
+  {
+    return FEB_CAN_ERROR_INVALID_PARAM;
+  }
+
+#if FEB_CAN_USE_FREERTOS
+  /* The tx_sem path loads any free mailbox; nothing to reserve for. */
+  return (count == 0U) ? FEB_CAN_OK : FEB_CAN_ERROR_UNSUPPORTED;
+#else
+  ctx->tx_reserved_mailboxes[instance] = count;
+  return FEB_CAN_OK;
+#endif
+}
+
 FEB_CAN_Status_t FEB_CAN_TX_SendSlot(int32_t handle)
 {
   FEB_CAN_Context_t *ctx = feb_can_get_context();
@@ -527,6 +863,12 @@ FEB_CAN_Status_t FEB_CAN_TX_SendFromISR(FEB_CAN_Instance_t instance, uint32_t ca
 #endif
 }
 
+void FEB_CAN_TX_SetCompleteHook(FEB_CAN_TX_Complete_Hook_t hook)
+{
+  /* Cleared by FEB_CAN_Init, so install after it */
+  feb_can_get_context()->tx_complete_hook = hook;
+}
+
 /* ============================================================================
  * TX Process Functions
  * ============================================================================ */
@@ -599,31 +941,52 @@ void FEB_CAN_TX_Process(void)
 #endif
 }
 
-void FEB_CAN_TX_ProcessPeriodic(void)
+uint32_t FEB_CAN_TX_ProcessPeriodic(void)
 {
   FEB_CAN_Context_t *ctx = feb_can_get_context();
 
   if (!ctx->initialized)
   {
-    return;
+    return FEB_CAN_TX_NO_PERIODIC;
   }
 
   uint32_t current_time = ctx->get_tick_ms();
+  uint32_t key = sched_lock(ctx);
 
-  for (uint32_t i = 0; i < FEB_CAN_MAX_TX_HANDLES; i++)
+  /* Pop every due slot off the head, earliest deadline first */
+  while (ctx->tx_sched_count > 0U)
   {
-    FEB_CAN_TX_Handle_Internal_t *h = &ctx->tx_handles[i];
+    uint8_t idx = ctx->tx_sched[0];
+    FEB_CAN_TX_Handle_Internal_t *h = &ctx->tx_handles[idx];
 
-    if (!h->is_active || h->period_ms == 0)
+    if (sched_tick_before(current_time, h->next_due))
     {
-      continue;
+      break;
     }
 
-    /* Check if it's time to transmit */
-    uint32_t elapsed = current_time - h->last_tx_time;
-    if (elapsed >= h->period_ms)
+    memmove(&ctx->tx_sched[0], &ctx->tx_sched[1], (size_t)(ctx->tx_sched_count - 1U));
+    ctx->tx_sched_count--;
+
+    /* Stay on the grid; if a whole period was missed, skip ahead instead of
+     * replaying the backlog as a burst. */
+    h->next_due += h->period_ms;
+    if (!sched_tick_before(current_time, h->next_due))
     {
-      FEB_CAN_TX_SendSlot((int32_t)i);
+      h->next_due = sched_align(current_time + 1U, h->period_ms, h->phase);
+      ctx->tx_periodic_late_count++;
     }
+    sched_insert(ctx, idx);
+
+    sched_unlock(ctx, key);
+    FEB_CAN_TX_SendSlot((int32_t)idx);
+    key = sched_lock(ctx);
+  }
+
+  uint32_t wait_ms = FEB_CAN_TX_NO_PERIODIC;
+  if (ctx->tx_sched_count > 0U)
+  {
+    wait_ms = ctx->tx_handles[ctx->tx_sched[0]].next_due - current_time;
   }
+  sched_unlock(ctx, key);
+  return wait_ms;
 }
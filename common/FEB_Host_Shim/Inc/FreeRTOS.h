@@ -0,0 +1,49 @@
+/**
+ ******************************************************************************
+ * @file           : FreeRTOS.h
+ * @brief          : FEB Host Shim - minimal FreeRTOS port surface
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * The common libraries only include FreeRTOS.h for the port-layer ISR check
+ * (xPortIsInsideInterrupt) and the configUSE_MUTEXES auto-detect. Everything
+ * else goes through cmsis_os2.h.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_FREERTOS_H
+#define FEB_HOST_FREERTOS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#define configUSE_MUTEXES 1
+#define configUSE_RECURSIVE_MUTEXES 1
+#define configUSE_COUNTING_SEMAPHORES 1
+#define configTICK_RATE_HZ ((TickType_t)1000)
+
+  typedef long BaseType_t;
+  typedef unsigned long UBaseType_t;
+  typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS (pdTRUE)
+#define pdFAIL (pdFALSE)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * configTICK_RATE_HZ) / 1000U))
+
+  /** pdTRUE while the calling thread is inside a simulated ISR. */
+  BaseType_t xPortIsInsideInterrupt(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEB_HOST_FREERTOS_H */
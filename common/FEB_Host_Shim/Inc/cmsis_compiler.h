@@ -0,0 +1,21 @@
+/**
+ ******************************************************************************
+ * @file           : cmsis_compiler.h
+ * @brief          : FEB Host Shim - CMSIS core intrinsics include
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Board code that only needs the barrier intrinsics (__DMB and friends)
+ * includes cmsis_compiler.h directly. On the host those live with the other
+ * core intrinsics in the shim's stm32f4xx_hal.h.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_CMSIS_COMPILER_H
+#define FEB_HOST_CMSIS_COMPILER_H
+
+#include "stm32f4xx_hal.h"
+
+#endif /* FEB_HOST_CMSIS_COMPILER_H */
@@ -0,0 +1,20 @@
+/**
+ ******************************************************************************
+ * @file           : cmsis_os.h
+ * @brief          : FEB Host Shim - CubeMX compatibility include
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * CubeMX-generated board code includes cmsis_os.h, which on target wraps the
+ * CMSIS-RTOS2 header. The host resolves it to the shim's cmsis_os2.h.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_CMSIS_OS_H
+#define FEB_HOST_CMSIS_OS_H
+
+#include "cmsis_os2.h"
+
+#endif /* FEB_HOST_CMSIS_OS_H */
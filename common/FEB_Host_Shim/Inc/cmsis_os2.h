@@ -0,0 +1,269 @@
+/**
+ ******************************************************************************
+ * @file           : cmsis_os2.h
+ * @brief          : FEB Host Shim - pthread-backed CMSIS-RTOS2 subset
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Types, constants and prototypes follow the CMSIS-RTOS2 v2.1 header so the
+ * common libraries compile unmodified. Implemented on POSIX threads in
+ * Src/cmsis_os2_posix.c:
+ *   - Kernel:   osKernelInitialize/Start/GetState/GetTickCount/GetTickFreq
+ *   - Threads:  osThreadNew/GetId/GetName/Yield/Exit/Join + thread flags
+ *               (FreeRTOS task notifications on the same threads: task.h)
+ *   - Delay:    osDelay, osDelayUntil (follow the host time base)
+ *   - Mutex:    osMutexNew/Acquire/Release/GetOwner/Delete
+ *   - Semaphore osSemaphoreNew/Acquire/Release/GetCount/Delete
+ *   - Queue:    osMessageQueueNew/Put/Get/GetCapacity/GetMsgSize/GetCount/
+ *               GetSpace/Reset/Delete
+ *
+ * ISR rules match the FreeRTOS port: blocking calls from a simulated ISR
+ * return osErrorParameter, mutex calls return osErrorISR. Timeouts are in
+ * ticks (1 tick = 1 ms) measured against the wall clock, even when the host
+ * time base is virtual. Thread priorities are recorded but not enforced.
+ *
+ ******************************************************************************
+ */
+
+#ifndef CMSIS_OS2_H_
+#define CMSIS_OS2_H_
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+  /* ============================================================================
+   * Status and Constants
+   * ============================================================================ */
+
+  typedef enum
+  {
+    osOK = 0,
+    osError = -1,
+    osErrorTimeout = -2,
+    osErrorResource = -3,
+    osErrorParameter = -4,
+    osErrorNoMemory = -5,
+    osErrorISR = -6,
+    osStatusReserved = 0x7FFFFFFF
+  } osStatus_t;
+
+#define osWaitForever 0xFFFFFFFFU
+
+#define osFlagsWaitAny 0x00000000U
+#define osFlagsWaitAll 0x00000001U
+#define osFlagsNoClear 0x00000002U
+
+#define osFlagsError 0x80000000U
+#define osFlagsErrorUnknown 0xFFFFFFFFU
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+#define osFlagsErrorResource 0xFFFFFFFDU
+#define osFlagsErrorParameter 0xFFFFFFFCU
+#define osFlagsErrorISR 0xFFFFFFFAU
+
+#define osThreadDetached 0x00000000U
+#define osThreadJoinable 0x00000001U
+
+#define osMutexRecursive 0x00000001U
+#define osMutexPrioInherit 0x00000002U
+#define osMutexRobust 0x00000008U
+
+  typedef enum
+  {
+    osKernelInactive = 0,
+    osKernelReady = 1,
+    osKernelRunning = 2,
+    osKernelLocked = 3,
+    osKernelSuspended = 4,
+    osKernelError = -1,
+    osKernelReserved = 0x7FFFFFFF
+  } osKernelState_t;
+
+  typedef enum
+  {
+    osPriorityNone = 0,
+    osPriorityIdle = 1,
+    osPriorityLow = 8,
+    osPriorityLow1 = 8 + 1,
+    osPriorityLow2 = 8 + 2,
+    osPriorityLow3 = 8 + 3,
+    osPriorityLow4 = 8 + 4,
+    osPriorityLow5 = 8 + 5,
+    osPriorityLow6 = 8 + 6,
+    osPriorityLow7 = 8 + 7,
+    osPriorityBelowNormal = 16,
+    osPriorityBelowNormal1 = 16 + 1,
+    osPriorityBelowNormal2 = 16 + 2,
+    osPriorityBelowNormal3 = 16 + 3,
+    osPriorityBelowNormal4 = 16 + 4,
+    osPriorityBelowNormal5 = 16 + 5,
+    osPriorityBelowNormal6 = 16 + 6,
+    osPriorityBelowNormal7 = 16 + 7,
+    osPriorityNormal = 24,
+    osPriorityNormal1 = 24 + 1,
+    osPriorityNormal2 = 24 + 2,
+    osPriorityNormal3 = 24 + 3,
+    osPriorityNormal4 = 24 + 4,
+    osPriorityNormal5 = 24 + 5,
+    osPriorityNormal6 = 24 + 6,
+    osPriorityNormal7 = 24 + 7,
+    osPriorityAboveNormal = 32,
+    osPriorityAboveNormal1 = 32 + 1,
+    osPriorityAboveNormal2 = 32 + 2,
+    osPriorityAboveNormal3 = 32 + 3,
+    osPriorityAboveNormal4 = 32 + 4,
+    osPriorityAboveNormal5 = 32 + 5,
+    osPriorityAboveNormal6 = 32 + 6,
+    osPriorityAboveNormal7 = 32 + 7,
+    osPriorityHigh = 40,
+    osPriorityHigh1 = 40 + 1,
+    osPriorityHigh2 = 40 + 2,
+    osPriorityHigh3 = 40 + 3,
+    osPriorityHigh4 = 40 + 4,
+    osPriorityHigh5 = 40 + 5,
+    osPriorityHigh6 = 40 + 6,
+    osPriorityHigh7 = 40 + 7,
+    osPriorityRealtime = 48,
+    osPriorityRealtime1 = 48 + 1,
+    osPriorityRealtime2 = 48 + 2,
+    osPriorityRealtime3 = 48 + 3,
+    osPriorityRealtime4 = 48 + 4,
+    osPriorityRealtime5 = 48 + 5,
+    osPriorityRealtime6 = 48 + 6,
+    osPriorityRealtime7 = 48 + 7,
+    osPriorityISR = 56,
+    osPriorityError = -1,
+    osPriorityReserved = 0x7FFFFFFF
+  } osPriority_t;
+
+  /* ============================================================================
+   * Object Handles and Attributes
+   * ============================================================================ */
+
+  typedef void (*osThreadFunc_t)(void *argument);
+
+  typedef void *osThreadId_t;
+  typedef void *osMutexId_t;
+  typedef void *osSemaphoreId_t;
+  typedef void *osMessageQueueId_t;
+
+  typedef struct
+  {
+    const char *name;
+    uint32_t attr_bits;
+    void *cb_mem;
+    uint32_t cb_size;
+    void *stack_mem;
+    uint32_t stack_size;
+    osPriority_t priority;
+    uint32_t tz_module;
+    uint32_t reserved;
+  } osThreadAttr_t;
+
+  typedef struct
+  {
+    const char *name;
+    uint32_t attr_bits;
+    void *cb_mem;
+    uint32_t cb_size;
+  } osMutexAttr_t;
+
+  typedef struct
+  {
+    const char *name;
+    uint32_t attr_bits;
+    void *cb_mem;
+    uint32_t cb_size;
+  } osSemaphoreAttr_t;
+
+  typedef struct
+  {
+    const char *name;
+    uint32_t attr_bits;
+    void *cb_mem;
+    uint32_t cb_size;
+    void *mq_mem;
+    uint32_t mq_size;
+  } osMessageQueueAttr_t;
+
+  /* ============================================================================
+   * Kernel
+   * ============================================================================ */
+
+  osStatus_t osKernelInitialize(void);
+  osStatus_t osKernelStart(void);
+  osKernelState_t osKernelGetState(void);
+  uint32_t osKernelGetTickCount(void);
+  uint32_t osKernelGetTickFreq(void);
+  uint32_t osKernelGetSysTimerCount(void);
+  uint32_t osKernelGetSysTimerFreq(void);
+
+  /* ============================================================================
+   * Threads and Thread Flags
+   * ============================================================================ */
+
+  osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr);
+  const char *osThreadGetName(osThreadId_t thread_id);
+  osThreadId_t osThreadGetId(void);
+  osPriority_t osThreadGetPriority(osThreadId_t thread_id);
+  osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority);
+  osStatus_t osThreadYield(void);
+  osStatus_t osThreadJoin(osThreadId_t thread_id);
+  void osThreadExit(void);
+
+  uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+  uint32_t osThreadFlagsClear(uint32_t flags);
+  uint32_t osThreadFlagsGet(void);
+  uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+  /* ============================================================================
+   * Delay
+   * ============================================================================ */
+
+  osStatus_t osDelay(uint32_t ticks);
+  osStatus_t osDelayUntil(uint32_t ticks);
+
+  /* ============================================================================
+   * Mutex
+   * ============================================================================ */
+
+  osMutexId_t osMutexNew(const osMutexAttr_t *attr);
+  osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+  osStatus_t osMutexRelease(osMutexId_t mutex_id);
+  osThreadId_t osMutexGetOwner(osMutexId_t mutex_id);
+  osStatus_t osMutexDelete(osMutexId_t mutex_id);
+
+  /* ============================================================================
+   * Semaphore
+   * ============================================================================ */
+
+  osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr);
+  osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout);
+  osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id);
+  uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id);
+  osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id);
+
+  /* ============================================================================
+   * Message Queue
+   * ============================================================================ */
+
+  osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr);
+  osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout);
+  osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout);
+  uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id);
+  uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id);
+  uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id);
+  uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id);
+  osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id);
+  osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CMSIS_OS2_H_ */
@@ -0,0 +1,567 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host.h
+ * @brief          : FEB Host Shim - harness API for the simulated peripherals
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * The common libraries only ever see the HAL / CMSIS-RTOS2 surface. A host
+ * benchmark, fuzzer or replay tool drives the "hardware" side through this
+ * header:
+ *
+ *   Time     - wall-clock or virtual time base behind HAL_GetTick, DWT and
+ *              osDelay. Virtual time only moves when advanced, so runs are
+ *              deterministic and timing-sensitive paths can be swept.
+ *   ISR      - FEB_Host_ISR_Enter/Exit bracket a simulated interrupt. Every
+ *              HAL callback fired by the shim already runs inside them.
+ *   CAN      - 3 TX mailboxes and 2 x 3-deep RX FIFOs per controller, with
+ *              the real bxCAN acceptance filter decode of the CAN1 filter
+ *              banks. Frames are injected with FEB_Host_CAN_Receive and the
+ *              bus is clocked one frame at a time with FEB_Host_CAN_BusStep.
+ *   UART     - TX lands in a per-handle sink; ReceiveToIdle DMA writes into
+ *              the user buffer and counts NDTR down, with circular and normal
+ *              modes. Line idle is raised with FEB_Host_UART_Idle.
+ *   I2C      - 7-bit devices with 16-bit register maps, blocking plus _IT /
+ *              _DMA transfers that complete on FEB_Host_I2C_Service.
+ *   SPI      - full-duplex byte exchange with targets selected by their CS
+ *              GPIO. Blocking transfers plus TransmitReceive_DMA completing
+ *              on FEB_Host_SPI_Service.
+ *   isoSPI   - an ADBMS68xx-style daisy chain of N ICs behind an SPI target:
+ *              PEC15 commands, PEC10 + command-counter replies, register
+ *              writes, and reply corruption for PEC-path testing.
+ *
+ * Board glue wired by stm32f4xx_it.c on target (HAL_UART_TxCpltCallback ->
+ * FEB_UART_TxCpltCallback, USART IRQ -> FEB_UART_IDLE_Callback, ...) is
+ * reproduced by weak defaults in the shim, so a harness only overrides what
+ * it wants to observe.
+ *
+ * Usage:
+ *   FEB_Host_Time_UseVirtual(true);
+ *   FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+ *   FEB_CAN_Init(&cfg);
+ *   FEB_Host_CAN_Receive(&hcan1, 0x123, CAN_ID_STD, data, 8);
+ *   FEB_CAN_RX_Process();
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_H
+#define FEB_HOST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stm32f4xx_hal.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+  /* ============================================================================
+   * Configuration
+   * ============================================================================ */
+
+#ifndef FEB_HOST_SYSCLK_HZ
+#define FEB_HOST_SYSCLK_HZ 180000000U
+#endif
+
+#ifndef FEB_HOST_UART_MAX_HANDLES
+#define FEB_HOST_UART_MAX_HANDLES 4
+#endif
+
+#ifndef FEB_HOST_I2C_MAX_DEVICES
+#define FEB_HOST_I2C_MAX_DEVICES 16
+#endif
+
+#ifndef FEB_HOST_SPI_MAX_TARGETS
+#define FEB_HOST_SPI_MAX_TARGETS 4
+#endif
+
+#ifndef FEB_HOST_ISOSPI_MAX_ICS
+#define FEB_HOST_ISOSPI_MAX_ICS 16
+#endif
+
+#ifndef FEB_HOST_ISOSPI_MAX_GROUPS
+#define FEB_HOST_ISOSPI_MAX_GROUPS 32
+#endif
+
+/** Depth of each bxCAN receive FIFO (hardware: 3). */
+#define FEB_HOST_CAN_FIFO_DEPTH 3U
+
+/** Number of bxCAN filter banks shared by CAN1/CAN2 (hardware: 28). */
+#define FEB_HOST_CAN_FILTER_BANKS 28U
+
+  /* ============================================================================
+   * Time Base
+   * ============================================================================ */
+
+  /**
+   * @brief Select the time base behind HAL_GetTick, DWT->CYCCNT and osDelay
+   * @param enable true = virtual clock (starts at the current reading and
+   *               only moves via FEB_Host_Time_Advance*), false = wall clock
+   */
+  void FEB_Host_Time_UseVirtual(bool enable);
+
+  bool FEB_Host_Time_IsVirtual(void);
+
+  /** Monotonic nanoseconds since the shim started. */
+  uint64_t FEB_Host_Time_Ns(void);
+
+  /** Monotonic microseconds since the shim started. */
+  uint64_t FEB_Host_Time_Us(void);
+
+  /** Advance the virtual clock. No-op on the wall clock. */
+  void FEB_Host_Time_AdvanceNs(uint64_t ns);
+  void FEB_Host_Time_AdvanceUs(uint64_t us);
+
+  /**
+   * @brief Charge virtual time for every DWT->CYCCNT read
+   *
+   * Firmware busy-waits on the cycle counter (FEB_Time_Us spin loops), which
+   * would never end on a clock that only moves when advanced. With a cost
+   * set, each read advances the virtual clock by ns, so a spin of N us takes
+   * about N * 1000 / ns reads. 0 (default) = reads are free. No-op on the
+   * wall clock.
+   */
+  void FEB_Host_Time_SetDwtReadCostNs(uint32_t ns);
+
+  /* ============================================================================
+   * Simulated Interrupts
+   * ============================================================================ */
+
+  /**
+   * @brief Enter a simulated ISR on the calling thread
+   *
+   * Takes the global interrupt lock, so the ISR body is serialised against
+   * every other ISR and every __disable_irq() critical section, and makes
+   * xPortIsInsideInterrupt() / __get_IPSR() report handler mode. Nests.
+   */
+  void FEB_Host_ISR_Enter(void);
+  void FEB_Host_ISR_Exit(void);
+
+  /** Called by NVIC_SystemReset() instead of exiting the process. */
+  typedef void (*FEB_Host_Reset_Hook_t)(void);
+  void FEB_Host_SetResetHook(FEB_Host_Reset_Hook_t hook);
+
+  /* ============================================================================
+   * CAN Simulation
+   * ============================================================================ */
+
+  /** Frame observed on the bus when a mailbox wins arbitration. */
+  typedef struct
+  {
+    uint32_t id;      /**< StdId or ExtId */
+    uint32_t ide;     /**< CAN_ID_STD / CAN_ID_EXT */
+    uint32_t rtr;     /**< CAN_RTR_DATA / CAN_RTR_REMOTE */
+    uint8_t dlc;      /**< 0..8 */
+    uint8_t data[8];  /**< Payload */
+  } FEB_Host_CAN_Frame_t;
+
+  typedef void (*FEB_Host_CAN_TxHook_t)(CAN_HandleTypeDef *hcan, const FEB_Host_CAN_Frame_t *frame, void *user);
+
+  typedef struct
+  {
+    uint32_t tx_frames;       /**< Frames that completed on the bus */
+    uint32_t tx_failed;       /**< Frames failed via FEB_Host_CAN_FailNextTx */
+    uint32_t tx_aborted;      /**< Frames removed by HAL_CAN_AbortTxRequest */
+    uint32_t rx_frames;       /**< Frames accepted into a FIFO */
+    uint32_t rx_filtered;     /**< Frames rejected by the acceptance filters */
+    uint32_t rx_overruns;     /**< Frames lost to a full FIFO */
+    uint32_t rx_fifo_peak[2]; /**< Highest FIFO fill level seen */
+  } FEB_Host_CAN_Stats_t;
+
+  /**
+   * @brief Bring a handle to the post-HAL_CAN_Init state (READY)
+   * @param instance CAN1 or CAN2
+   */
+  void FEB_Host_CAN_InitHandle(CAN_HandleTypeDef *hcan, CAN_TypeDef *instance);
+
+  /** Observe frames as they leave a mailbox (loop them back, log them, ...). */
+  void FEB_Host_CAN_SetTxHook(CAN_HandleTypeDef *hcan, FEB_Host_CAN_TxHook_t hook, void *user);
+
+  /**
+   * @brief Deliver a frame from the bus to a controller
+   *
+   * Runs the acceptance filters, pushes the frame into the matching FIFO and
+   * fires the FIFO message-pending callback inside a simulated ISR when that
+   * notification is active.
+   *
+   * @return true if the frame landed in a FIFO
+   */
+  bool FEB_Host_CAN_Receive(CAN_HandleTypeDef *hcan, uint32_t id, uint32_t ide, const uint8_t *data, uint8_t dlc);
+
+  /**
+   * @brief Clock the bus by one frame slot
+   *
+   * Transmits the highest-priority (lowest identifier) pending mailbox and
+   * fires its completion callback (or the error callback for a failure
+   * armed with FEB_Host_CAN_FailNextTx). Pending abort completions are
+   * delivered first.
+   *
+   * @return true if anything happened
+   */
+  bool FEB_Host_CAN_BusStep(CAN_HandleTypeDef *hcan);
+
+  /**
+   * @brief Start the next transmission without completing it
+   *
+   * Arbitrates among the pending mailboxes like FEB_Host_CAN_BusStep and
+   * locks the winner as the frame on the wire: the next BusStep completes
+   * that mailbox even if a higher-priority frame has been loaded since, as
+   * on bxCAN once arbitration is won. Lets a bus model hold the bus for the
+   * frame's duration or arbitrate it against other nodes' traffic first.
+   * Calling it again re-arbitrates, as after a lost arbitration.
+   *
+   * @param frame Filled with the frame on the wire (may be NULL)
+   * @return true if a mailbox was pending
+   */
+  bool FEB_Host_CAN_BusBegin(CAN_HandleTypeDef *hcan, FEB_Host_CAN_Frame_t *frame);
+
+  /** Run FEB_Host_CAN_BusStep until all mailboxes are empty. Returns frames sent. */
+  uint32_t FEB_Host_CAN_BusFlush(CAN_HandleTypeDef *hcan);
+
+  /** Number of mailboxes currently holding a frame. */
+  uint32_t FEB_Host_CAN_PendingMailboxes(const CAN_HandleTypeDef *hcan);
+
+  /**
+   * @brief Make the next N transmissions fail
+   * @param error_bits HAL_CAN_ERROR_TX_TERRx or HAL_CAN_ERROR_TX_ALSTx style
+   *                   per-mailbox bit for mailbox 0; shifted per mailbox
+   */
+  void FEB_Host_CAN_FailNextTx(CAN_HandleTypeDef *hcan, uint32_t count, uint32_t error_bits);
+
+  /**
+   * @brief Raise a controller error interrupt
+   *
+   * EWG / EPV / BOF move the handle to HAL_CAN_STATE_ERROR like the HAL IRQ
+   * handler does; BOF also drops every pending mailbox. The error callback
+   * fires when the matching notification is active.
+   */
+  void FEB_Host_CAN_InjectError(CAN_HandleTypeDef *hcan, uint32_t error_code, uint32_t esr);
+
+  void FEB_Host_CAN_GetStats(const CAN_HandleTypeDef *hcan, FEB_Host_CAN_Stats_t *stats);
+  void FEB_Host_CAN_ResetStats(CAN_HandleTypeDef *hcan);
+
+  /* ============================================================================
+   * UART Simulation
+   * ============================================================================ */
+
+  typedef void (*FEB_Host_UART_Sink_t)(UART_HandleTypeDef *huart, const uint8_t *data, size_t len, void *user);
+
+  typedef struct
+  {
+    uint32_t tx_bytes;        /**< Bytes handed to the sink */
+    uint32_t tx_dma_transfers;/**< Completed HAL_UART_Transmit_DMA calls */
+    uint32_t tx_blocking;     /**< HAL_UART_Transmit calls */
+    uint32_t rx_bytes;        /**< Bytes written into the DMA buffer */
+    uint32_t rx_dropped;      /**< Bytes lost while reception was stopped */
+    uint32_t rx_events;       /**< HAL_UARTEx_RxEventCallback invocations */
+  } FEB_Host_UART_Stats_t;
+
+  /**
+   * @brief Wire a UART handle to its register block and DMA streams
+   *
+   * Mirrors what MX_USARTx_UART_Init + HAL_UART_MspInit leave behind.
+   * hdma_rx_mode is DMA_CIRCULAR (F4 boards) or DMA_NORMAL.
+   */
+  void FEB_Host_UART_InitHandle(UART_HandleTypeDef *huart, USART_TypeDef *instance, DMA_HandleTypeDef *hdma_tx,
+                                DMA_Stream_TypeDef *tx_stream, DMA_HandleTypeDef *hdma_rx,
+                                DMA_Stream_TypeDef *rx_stream, uint32_t hdma_rx_mode, uint32_t baud);
+
+  void FEB_Host_UART_SetSink(UART_HandleTypeDef *huart, FEB_Host_UART_Sink_t sink, void *user);
+
+  /**
+   * @brief Complete an in-flight HAL_UART_Transmit_DMA
+   *
+   * Hands the bytes to the sink and fires HAL_UART_TxCpltCallback inside a
+   * simulated ISR. Loops while the callback chains another DMA transfer,
+   * up to max_transfers (0 = unlimited).
+   *
+   * @return Number of DMA transfers completed
+   */
+  uint32_t FEB_Host_UART_Service(UART_HandleTypeDef *huart, uint32_t max_transfers);
+
+  /** True while a DMA transmit is in flight. */
+  bool FEB_Host_UART_TxBusy(const UART_HandleTypeDef *huart);
+
+  /**
+   * @brief Feed bytes into the RX DMA stream
+   *
+   * Bytes are written at the DMA position and NDTR counts down. In circular
+   * mode NDTR reloads at the end of the buffer and the transfer-complete
+   * RxEvent fires; in normal mode reception stops there.
+   *
+   * @return Bytes accepted
+   */
+  size_t FEB_Host_UART_Receive(UART_HandleTypeDef *huart, const uint8_t *data, size_t len);
+
+  /**
+   * @brief Signal line idle: set SR.IDLE and run the USART IRQ
+   *
+   * The default IRQ (FEB_Host_UART_IRQHandler, weak) calls
+   * FEB_UART_IDLE_Callback then HAL_UART_IRQHandler, matching the board
+   * stm32f4xx_it.c wiring.
+   */
+  void FEB_Host_UART_Idle(UART_HandleTypeDef *huart);
+
+  /** Convenience: FEB_Host_UART_Receive followed by FEB_Host_UART_Idle. */
+  size_t FEB_Host_UART_ReceiveLine(UART_HandleTypeDef *huart, const char *text);
+
+  /** Simulated USARTx_IRQHandler body. Weak - override for custom wiring. */
+  void FEB_Host_UART_IRQHandler(UART_HandleTypeDef *huart);
+
+  void FEB_Host_UART_GetStats(const UART_HandleTypeDef *huart, FEB_Host_UART_Stats_t *stats);
+
+  /* ============================================================================
+   * I2C Simulation
+   * ============================================================================ */
+
+  struct FEB_Host_I2C_Device;
+
+  /** Optional hooks: observe / veto register access. Return false to NACK. */
+  typedef bool (*FEB_Host_I2C_ReadHook_t)(struct FEB_Host_I2C_Device *dev, uint8_t reg);
+  typedef bool (*FEB_Host_I2C_WriteHook_t)(struct FEB_Host_I2C_Device *dev, uint8_t reg, uint16_t value);
+
+  /**
+   * @brief Simulated I2C target with a 256-entry register map
+   *
+   * reg_bytes = 2 models 16-bit big-endian registers (TPS2482, INA2xx);
+   * reg_bytes = 1 models byte registers. Multi-register transfers advance
+   * the register pointer after each register.
+   */
+  typedef struct FEB_Host_I2C_Device
+  {
+    uint8_t addr7;                   /**< 7-bit address */
+    uint8_t reg_bytes;               /**< 1 or 2 */
+    bool present;                    /**< false = NACK the address */
+    uint16_t regs[256];              /**< Register file */
+    uint16_t read_only_mask[256];    /**< Bits ignored on write */
+    FEB_Host_I2C_ReadHook_t on_read; /**< Optional */
+    FEB_Host_I2C_WriteHook_t on_write; /**< Optional */
+    void *user;                      /**< Harness context */
+    uint32_t reads;                  /**< Completed read transactions */
+    uint32_t writes;                 /**< Completed write transactions */
+  } FEB_Host_I2C_Device_t;
+
+  typedef struct
+  {
+    uint32_t transactions; /**< Completed transfers (any mode) */
+    uint32_t nacks;        /**< Transfers NACKed */
+    uint32_t bytes;        /**< Payload bytes moved */
+    uint64_t bus_ns;       /**< Simulated SCL time spent on the bus */
+  } FEB_Host_I2C_Stats_t;
+
+  /** Bring a handle to the post-HAL_I2C_Init state. clock_hz defaults to 400 kHz when 0. */
+  void FEB_Host_I2C_InitHandle(I2C_HandleTypeDef *hi2c, uint32_t clock_hz);
+
+  /** Attach a device to a bus. The device must outlive the handle. */
+  bool FEB_Host_I2C_Attach(I2C_HandleTypeDef *hi2c, FEB_Host_I2C_Device_t *dev);
+
+  void FEB_Host_I2C_Detach(I2C_HandleTypeDef *hi2c, FEB_Host_I2C_Device_t *dev);
+
+  /**
+   * @brief Complete an in-flight _IT / _DMA memory transfer
+   *
+   * Fires HAL_I2C_MemRxCpltCallback / MemTxCpltCallback (or ErrorCallback
+   * on NACK) inside a simulated ISR.
+   *
+   * @return true if a transfer was completed
+   */
+  bool FEB_Host_I2C_Service(I2C_HandleTypeDef *hi2c);
+
+  /**
+   * Bus time for a memory transfer of len bytes at the handle's clock.
+   * In virtual time, blocking transfers advance the clock by this amount.
+   */
+  uint64_t FEB_Host_I2C_TransferNs(const I2C_HandleTypeDef *hi2c, bool read, uint16_t len);
+
+  void FEB_Host_I2C_GetStats(const I2C_HandleTypeDef *hi2c, FEB_Host_I2C_Stats_t *stats);
+
+  /* ============================================================================
+   * SPI Simulation
+   * ============================================================================ */
+
+  struct FEB_Host_SPI_Target;
+
+  /** CS edge: selected = true on the falling edge, false on the rising edge. */
+  typedef void (*FEB_Host_SPI_SelectFn_t)(struct FEB_Host_SPI_Target *target, bool selected);
+
+  /** Clock one byte: receives MOSI, returns MISO. */
+  typedef uint8_t (*FEB_Host_SPI_ExchangeFn_t)(struct FEB_Host_SPI_Target *target, uint8_t mosi);
+
+  /**
+   * @brief Simulated SPI target
+   *
+   * A target takes part in a transfer only while its CS pin (as driven by
+   * HAL_GPIO_WritePin) is low. MISO from several selected targets is
+   * wired-AND; with nothing selected the bus reads 0xFF.
+   */
+  typedef struct FEB_Host_SPI_Target
+  {
+    GPIO_TypeDef *cs_port;             /**< Chip-select port */
+    uint16_t cs_pin;                   /**< Chip-select pin (active low) */
+    FEB_Host_SPI_SelectFn_t select;    /**< Optional */
+    FEB_Host_SPI_ExchangeFn_t exchange; /**< Required */
+    void *user;                        /**< Harness context */
+  } FEB_Host_SPI_Target_t;
+
+  typedef struct
+  {
+    uint32_t transfers;     /**< Completed transfers (any mode) */
+    uint32_t dma_transfers; /**< Completed TransmitReceive_DMA transfers */
+    uint32_t dma_failed;    /**< DMA transfers failed via FEB_Host_SPI_FailNextDma */
+    uint32_t aborts;        /**< HAL_SPI_Abort calls that dropped a transfer */
+    uint32_t bytes;         /**< Bytes clocked */
+    uint64_t bus_ns;        /**< Simulated SCK time spent on the bus */
+  } FEB_Host_SPI_Stats_t;
+
+  /**
+   * @brief Bring a handle to the post-HAL_SPI_Init state (master, READY)
+   * @param bit_rate_hz SCK rate; defaults to 1 MHz when 0
+   */
+  void FEB_Host_SPI_InitHandle(SPI_HandleTypeDef *hspi, SPI_TypeDef *instance, uint32_t bit_rate_hz);
+
+  /** Attach a target to a bus. The target must outlive the handle. */
+  bool FEB_Host_SPI_Attach(SPI_HandleTypeDef *hspi, FEB_Host_SPI_Target_t *target);
+
+  void FEB_Host_SPI_Detach(SPI_HandleTypeDef *hspi, FEB_Host_SPI_Target_t *target);
+
+  /**
+   * @brief Complete an in-flight TransmitReceive_DMA
+   *
+   * Clocks the bytes through the selected targets, advances virtual time by
+   * the bus time and fires HAL_SPI_TxRxCpltCallback (or ErrorCallback)
+   * inside a simulated ISR. A callback may start the next transfer; that one
+   * is left pending for the next call.
+   *
+   * @return true if a transfer was completed
+   */
+  bool FEB_Host_SPI_Service(SPI_HandleTypeDef *hspi);
+
+  /** True while a DMA transfer is in flight. */
+  bool FEB_Host_SPI_Busy(const SPI_HandleTypeDef *hspi);
+
+  /** Make the next N DMA transfers end in HAL_SPI_ErrorCallback (HAL_SPI_ERROR_DMA). */
+  void FEB_Host_SPI_FailNextDma(SPI_HandleTypeDef *hspi, uint32_t count);
+
+  /** Bus time for len bytes at the handle's bit rate. */
+  uint64_t FEB_Host_SPI_TransferNs(const SPI_HandleTypeDef *hspi, uint16_t len);
+
+  void FEB_Host_SPI_GetStats(const SPI_HandleTypeDef *hspi, FEB_Host_SPI_Stats_t *stats);
+
+  /* ============================================================================
+   * isoSPI Daisy-Chain Simulation
+   * ============================================================================ */
+
+  typedef struct
+  {
+    uint32_t commands;     /**< Frames whose command PEC15 checked out */
+    uint32_t bad_cmd_pec;  /**< Frames dropped for a bad command PEC15 */
+    uint32_t reads;        /**< Register-group reads answered */
+    uint32_t writes;       /**< Register-group writes accepted (whole chain) */
+    uint32_t bad_data_pec; /**< Per-IC write payloads rejected for a bad PEC10 */
+    uint32_t actions;      /**< Commands with no data phase */
+    uint32_t corrupted;    /**< Reply frames corrupted by injection */
+  } FEB_Host_IsoSPI_Stats_t;
+
+  /**
+   * @brief Simulated ADBMS68xx daisy chain behind one isoSPI port
+   *
+   * Every frame starts with CMD[2] + PEC15[2]. Register groups are six data
+   * bytes per IC. A registered read opcode answers N x (6 data + CC/PEC10)
+   * with IC 0 first; a registered write opcode takes N x (6 data + PEC10)
+   * with the first payload landing on the last IC, as write_68 sends it.
+   * Every other command is an action. Each IC keeps its own 6-bit command
+   * counter, advanced by actions and accepted writes.
+   *
+   * Fields below `target` are simulator state; use the functions.
+   */
+  typedef struct
+  {
+    FEB_Host_SPI_Target_t target; /**< Attach with FEB_Host_SPI_Attach */
+    uint8_t num_ics;
+
+    uint16_t rd_cmd[FEB_HOST_ISOSPI_MAX_GROUPS];
+    uint16_t wr_cmd[FEB_HOST_ISOSPI_MAX_GROUPS];
+    uint8_t num_groups;
+    uint8_t regs[FEB_HOST_ISOSPI_MAX_ICS][FEB_HOST_ISOSPI_MAX_GROUPS][6];
+    uint8_t cc[FEB_HOST_ISOSPI_MAX_ICS];
+
+    uint32_t corrupt_next[FEB_HOST_ISOSPI_MAX_ICS];
+    uint32_t error_ppm;
+    uint32_t rng;
+
+    /* Frame in progress */
+    uint8_t frame[4U + 8U * FEB_HOST_ISOSPI_MAX_ICS];
+    uint16_t pos;
+    int8_t group;
+    bool is_write;
+    bool cmd_ok;
+    bool selected;
+
+    FEB_Host_IsoSPI_Stats_t stats;
+  } FEB_Host_IsoSPI_Chain_t;
+
+  /**
+   * @brief Reset a chain of num_ics ICs (registers 0, CC 0) selected by cs_port/cs_pin
+   *
+   * Attach chain->target to the SPI handle afterwards.
+   */
+  void FEB_Host_IsoSPI_Init(FEB_Host_IsoSPI_Chain_t *chain, uint8_t num_ics, GPIO_TypeDef *cs_port, uint16_t cs_pin);
+
+  /**
+   * @brief Register a register group
+   * @param rd_cmd Read opcode (e.g. RDCVA)
+   * @param wr_cmd Write opcode, or 0 for a read-only group
+   * @return false if the group table is full
+   */
+  bool FEB_Host_IsoSPI_AddGroup(FEB_Host_IsoSPI_Chain_t *chain, uint16_t rd_cmd, uint16_t wr_cmd);
+
+  /** Load / read back one IC's six bytes of the group read by rd_cmd. */
+  bool FEB_Host_IsoSPI_SetGroup(FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint16_t rd_cmd, const uint8_t data[6]);
+  bool FEB_Host_IsoSPI_GetGroup(const FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint16_t rd_cmd, uint8_t data[6]);
+
+  uint8_t FEB_Host_IsoSPI_GetCC(const FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic);
+
+  /** Flip one bit in each of IC ic's next count reply frames. */
+  void FEB_Host_IsoSPI_CorruptNext(FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint32_t count);
+
+  /**
+   * @brief Random reply corruption
+   * @param ppm  Probability per IC reply frame, parts per million (0 = off)
+   * @param seed Seed for the deterministic generator
+   */
+  void FEB_Host_IsoSPI_SetErrorRate(FEB_Host_IsoSPI_Chain_t *chain, uint32_t ppm, uint32_t seed);
+
+  void FEB_Host_IsoSPI_GetStats(const FEB_Host_IsoSPI_Chain_t *chain, FEB_Host_IsoSPI_Stats_t *stats);
+
+  /* ============================================================================
+   * GPIO Simulation
+   * ============================================================================ */
+
+  /** Drive an input pin as seen by HAL_GPIO_ReadPin. */
+  void FEB_Host_GPIO_SetInput(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+
+  /** Read back an output pin as driven by HAL_GPIO_WritePin. */
+  GPIO_PinState FEB_Host_GPIO_GetOutput(const GPIO_TypeDef *port, uint16_t pin);
+
+  typedef void (*FEB_Host_GPIO_WriteHook_t)(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state, void *user);
+
+  /**
+   * @brief Observe output edges
+   *
+   * The hook runs from HAL_GPIO_WritePin / TogglePin, on the writing thread,
+   * once per pin whose output level changed. The SPI simulation uses one
+   * to track chip selects.
+   *
+   * @return false if the hook table is full
+   */
+  bool FEB_Host_GPIO_AddWriteHook(FEB_Host_GPIO_WriteHook_t hook, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEB_HOST_H */
@@ -0,0 +1,31 @@
+/**
+ ******************************************************************************
+ * @file           : main.h
+ * @brief          : FEB Host Shim - stand-in for a board's CubeMX main.h
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * The common libraries reach the HAL through "main.h", exactly like board
+ * code does. On the host this resolves here and pulls in the simulated HAL.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_MAIN_H
+#define FEB_HOST_MAIN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "stm32f4xx_hal.h"
+
+  void Error_Handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEB_HOST_MAIN_H */
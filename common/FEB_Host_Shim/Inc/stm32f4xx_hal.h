@@ -0,0 +1,746 @@
+/**
+ ******************************************************************************
+ * @file           : stm32f4xx_hal.h
+ * @brief          : FEB Host Shim - simulated STM32F4 HAL / CMSIS-Core surface
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Host-native stand-in for the subset of the STM32F4 HAL and CMSIS-Core that
+ * the common libraries touch. Type names, field names, constant values and
+ * return codes mirror the real headers so feb_can / feb_uart / feb_log /
+ * feb_console / feb_tps compile unmodified. Peripheral behaviour is modelled
+ * in Src/feb_host_*.c and driven from a harness through feb_host.h.
+ *
+ * Only what the libraries use is declared here. If a library starts calling a
+ * new HAL function, add it here with the real prototype and model it in the
+ * matching feb_host_*.c file.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_STM32F4XX_HAL_H
+#define FEB_HOST_STM32F4XX_HAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+  /* ============================================================================
+   * Common HAL Definitions
+   * ============================================================================ */
+
+#define __IO volatile
+#define __I volatile const
+#define __O volatile
+#define __weak __attribute__((weak))
+#define UNUSED(X) (void)(X)
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+  typedef enum
+  {
+    HAL_OK = 0x00U,
+    HAL_ERROR = 0x01U,
+    HAL_BUSY = 0x02U,
+    HAL_TIMEOUT = 0x03U
+  } HAL_StatusTypeDef;
+
+  typedef enum
+  {
+    RESET = 0U,
+    SET = !RESET
+  } FlagStatus,
+      ITStatus;
+
+  typedef enum
+  {
+    DISABLE = 0U,
+    ENABLE = !DISABLE
+  } FunctionalState;
+
+  /* ============================================================================
+   * CMSIS-Core (Cortex-M4)
+   *
+   * PRIMASK and IPSR are per-thread on the host. __disable_irq() takes the
+   * global simulated-interrupt lock, so a critical section excludes every
+   * simulated ISR (see FEB_Host_ISR_Enter in feb_host.h) exactly as it would
+   * on target. Threads that are not in a critical section keep running while
+   * an ISR executes - the host has more than one core.
+   * ============================================================================ */
+
+#define __CORTEX_M (4U)
+
+  void __disable_irq(void);
+  void __enable_irq(void);
+  uint32_t __get_PRIMASK(void);
+  void __set_PRIMASK(uint32_t priMask);
+  uint32_t __get_IPSR(void);
+
+  /* No interrupt to wait for on the host: yields the thread instead. */
+  void __WFI(void);
+
+  static inline void __DSB(void)
+  {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+
+  static inline void __DMB(void)
+  {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+
+  static inline void __ISB(void)
+  {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  }
+
+  static inline void __NOP(void)
+  {
+  }
+
+  typedef struct
+  {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+  } DWT_Type;
+
+  typedef struct
+  {
+    __IO uint32_t DHCSR;
+    __IO uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+  } CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+  /* CYCCNT advances with the host time base (FEB_Host_Time_Ns) scaled by
+   * SystemCoreClock; every DWT-> access refreshes it first. */
+  DWT_Type *feb_host_dwt(void);
+  extern CoreDebug_Type feb_host_core_debug;
+
+#define DWT (feb_host_dwt())
+#define CoreDebug (&feb_host_core_debug)
+
+  extern uint32_t SystemCoreClock;
+
+  void NVIC_SystemReset(void);
+
+  /* ============================================================================
+   * HAL Core
+   * ============================================================================ */
+
+  uint32_t HAL_GetTick(void);
+  void HAL_Delay(uint32_t Delay);
+  void HAL_SuspendTick(void);
+  void HAL_ResumeTick(void);
+
+  /* ============================================================================
+   * GPIO
+   * ============================================================================ */
+
+  typedef struct
+  {
+    __IO uint32_t MODER;
+    __IO uint32_t OTYPER;
+    __IO uint32_t OSPEEDR;
+    __IO uint32_t PUPDR;
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+    __IO uint32_t BSRR;
+    __IO uint32_t LCKR;
+    __IO uint32_t AFR[2];
+  } GPIO_TypeDef;
+
+  typedef enum
+  {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+  } GPIO_PinState;
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+  GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+  void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+  void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+  /* ============================================================================
+   * DMA
+   * ============================================================================ */
+
+  typedef struct
+  {
+    __IO uint32_t CR;
+    __IO uint32_t NDTR;
+    __IO uint32_t PAR;
+    __IO uint32_t M0AR;
+    __IO uint32_t M1AR;
+    __IO uint32_t FCR;
+  } DMA_Stream_TypeDef;
+
+#define DMA_NORMAL 0x00000000U
+#define DMA_CIRCULAR 0x00000100U
+
+#define DMA_IT_TC 0x00000010U
+#define DMA_IT_HT 0x00000008U
+#define DMA_IT_TE 0x00000004U
+#define DMA_IT_DME 0x00000002U
+
+  typedef struct
+  {
+    uint32_t Channel;
+    uint32_t Direction;
+    uint32_t PeriphInc;
+    uint32_t MemInc;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+    uint32_t FIFOMode;
+  } DMA_InitTypeDef;
+
+  typedef enum
+  {
+    HAL_DMA_STATE_RESET = 0x00U,
+    HAL_DMA_STATE_READY = 0x01U,
+    HAL_DMA_STATE_BUSY = 0x02U,
+    HAL_DMA_STATE_TIMEOUT = 0x03U,
+    HAL_DMA_STATE_ERROR = 0x04U,
+    HAL_DMA_STATE_ABORT = 0x05U
+  } HAL_DMA_StateTypeDef;
+
+  typedef struct __DMA_HandleTypeDef
+  {
+    DMA_Stream_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+    __IO HAL_DMA_StateTypeDef State;
+    void *Parent;
+    __IO uint32_t ErrorCode;
+  } DMA_HandleTypeDef;
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__) ((__HANDLE__)->Instance->NDTR)
+#define __HAL_DMA_ENABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->CR |= (__INTERRUPT__))
+#define __HAL_DMA_DISABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->CR &= ~(__INTERRUPT__))
+
+  /* ============================================================================
+   * ADC
+   * ============================================================================
+   *
+   * Handle type only, so board headers that pass ADC handles around compile.
+   * There is no conversion model; harnesses stub the board's ADC getters. */
+
+  typedef struct
+  {
+    __IO uint32_t SR;
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t DR;
+  } ADC_TypeDef;
+
+  typedef struct __ADC_HandleTypeDef
+  {
+    ADC_TypeDef *Instance;
+    DMA_HandleTypeDef *DMA_Handle;
+    __IO uint32_t State;
+    __IO uint32_t ErrorCode;
+  } ADC_HandleTypeDef;
+
+  /* ============================================================================
+   * UART
+   * ============================================================================ */
+
+  typedef struct
+  {
+    __IO uint32_t SR;
+    __IO uint32_t DR;
+    __IO uint32_t BRR;
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t CR3;
+    __IO uint32_t GTPR;
+  } USART_TypeDef;
+
+#define USART_SR_PE 0x00000001U
+#define USART_SR_FE 0x00000002U
+#define USART_SR_NE 0x00000004U
+#define USART_SR_ORE 0x00000008U
+#define USART_SR_IDLE 0x00000010U
+#define USART_SR_RXNE 0x00000020U
+#define USART_SR_TC 0x00000040U
+#define USART_SR_TXE 0x00000080U
+
+#define USART_CR1_IDLEIE 0x00000010U
+
+#define UART_FLAG_IDLE USART_SR_IDLE
+#define UART_FLAG_RXNE USART_SR_RXNE
+#define UART_FLAG_TC USART_SR_TC
+#define UART_FLAG_TXE USART_SR_TXE
+#define UART_FLAG_ORE USART_SR_ORE
+
+#define UART_IT_IDLE USART_CR1_IDLEIE
+
+  typedef struct
+  {
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+  } UART_InitTypeDef;
+
+  typedef enum
+  {
+    HAL_UART_STATE_RESET = 0x00U,
+    HAL_UART_STATE_READY = 0x20U,
+    HAL_UART_STATE_BUSY = 0x24U,
+    HAL_UART_STATE_BUSY_TX = 0x21U,
+    HAL_UART_STATE_BUSY_RX = 0x22U,
+    HAL_UART_STATE_BUSY_TX_RX = 0x23U,
+    HAL_UART_STATE_TIMEOUT = 0xA0U,
+    HAL_UART_STATE_ERROR = 0xE0U
+  } HAL_UART_StateTypeDef;
+
+#define HAL_UART_RECEPTION_STANDARD (0x00000000U)
+#define HAL_UART_RECEPTION_TOIDLE (0x00000001U)
+
+#define HAL_UART_ERROR_NONE 0x00000000U
+#define HAL_UART_ERROR_ORE 0x00000008U
+#define HAL_UART_ERROR_DMA 0x00000010U
+
+  typedef struct __UART_HandleTypeDef
+  {
+    USART_TypeDef *Instance;
+    UART_InitTypeDef Init;
+    const uint8_t *pTxBuffPtr;
+    uint16_t TxXferSize;
+    __IO uint16_t TxXferCount;
+    uint8_t *pRxBuffPtr;
+    uint16_t RxXferSize;
+    __IO uint16_t RxXferCount;
+    __IO uint32_t ReceptionType;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    __IO HAL_UART_StateTypeDef gState;
+    __IO HAL_UART_StateTypeDef RxState;
+    __IO uint32_t ErrorCode;
+  } UART_HandleTypeDef;
+
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__) (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+#define __HAL_UART_CLEAR_FLAG(__HANDLE__, __FLAG__) ((__HANDLE__)->Instance->SR = ~(__FLAG__))
+#define __HAL_UART_CLEAR_IDLEFLAG(__HANDLE__) ((__HANDLE__)->Instance->SR &= ~USART_SR_IDLE)
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->CR1 |= (__INTERRUPT__))
+#define __HAL_UART_DISABLE_IT(__HANDLE__, __INTERRUPT__) ((__HANDLE__)->Instance->CR1 &= ~(__INTERRUPT__))
+
+  HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size,
+                                      uint32_t Timeout);
+  HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+  HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+  HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart);
+  HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart);
+  void HAL_UART_IRQHandler(UART_HandleTypeDef *huart);
+
+  void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+  void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size);
+
+  /* ============================================================================
+   * I2C
+   * ============================================================================ */
+
+  typedef struct
+  {
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t OAR1;
+    __IO uint32_t OAR2;
+    __IO uint32_t DR;
+    __IO uint32_t SR1;
+    __IO uint32_t SR2;
+    __IO uint32_t CCR;
+    __IO uint32_t TRISE;
+    __IO uint32_t FLTR;
+  } I2C_TypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT 0x00000001U
+#define I2C_MEMADD_SIZE_16BIT 0x00000010U
+
+#define HAL_I2C_ERROR_NONE 0x00000000U
+#define HAL_I2C_ERROR_AF 0x00000004U
+#define HAL_I2C_ERROR_TIMEOUT 0x00000020U
+
+  typedef struct
+  {
+    uint32_t ClockSpeed;
+    uint32_t DutyCycle;
+    uint32_t OwnAddress1;
+    uint32_t AddressingMode;
+    uint32_t DualAddressMode;
+    uint32_t OwnAddress2;
+    uint32_t GeneralCallMode;
+    uint32_t NoStretchMode;
+  } I2C_InitTypeDef;
+
+  typedef enum
+  {
+    HAL_I2C_STATE_RESET = 0x00U,
+    HAL_I2C_STATE_READY = 0x20U,
+    HAL_I2C_STATE_BUSY = 0x24U,
+    HAL_I2C_STATE_BUSY_TX = 0x21U,
+    HAL_I2C_STATE_BUSY_RX = 0x22U,
+    HAL_I2C_STATE_ERROR = 0xE0U
+  } HAL_I2C_StateTypeDef;
+
+  typedef struct __I2C_HandleTypeDef
+  {
+    I2C_TypeDef *Instance;
+    I2C_InitTypeDef Init;
+    uint8_t *pBuffPtr;
+    uint16_t XferSize;
+    __IO uint16_t XferCount;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    __IO HAL_I2C_StateTypeDef State;
+    __IO uint32_t ErrorCode;
+    __IO uint32_t Devaddress;
+    __IO uint32_t Memaddress;
+  } I2C_HandleTypeDef;
+
+  HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+  HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                     uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+  HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                         uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+  HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+  HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                          uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+  HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                         uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+  HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials,
+                                          uint32_t Timeout);
+  HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c);
+
+  void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+  void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+  void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+  /* ============================================================================
+   * SPI
+   * ============================================================================ */
+
+  typedef struct
+  {
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t SR;
+    __IO uint32_t DR;
+  } SPI_TypeDef;
+
+#define SPI_MODE_SLAVE 0x00000000U
+#define SPI_MODE_MASTER 0x00000104U
+
+#define HAL_SPI_ERROR_NONE 0x00000000U
+#define HAL_SPI_ERROR_OVR 0x00000004U
+#define HAL_SPI_ERROR_DMA 0x00000010U
+#define HAL_SPI_ERROR_FLAG 0x00000020U
+#define HAL_SPI_ERROR_ABORT 0x00000040U
+
+  typedef struct
+  {
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+    uint32_t TIMode;
+    uint32_t CRCCalculation;
+    uint32_t CRCPolynomial;
+  } SPI_InitTypeDef;
+
+  typedef enum
+  {
+    HAL_SPI_STATE_RESET = 0x00U,
+    HAL_SPI_STATE_READY = 0x01U,
+    HAL_SPI_STATE_BUSY = 0x02U,
+    HAL_SPI_STATE_BUSY_TX = 0x03U,
+    HAL_SPI_STATE_BUSY_RX = 0x04U,
+    HAL_SPI_STATE_BUSY_TX_RX = 0x05U,
+    HAL_SPI_STATE_ERROR = 0x06U,
+    HAL_SPI_STATE_ABORT = 0x07U
+  } HAL_SPI_StateTypeDef;
+
+  typedef struct __SPI_HandleTypeDef
+  {
+    SPI_TypeDef *Instance;
+    SPI_InitTypeDef Init;
+    const uint8_t *pTxBuffPtr;
+    uint16_t TxXferSize;
+    __IO uint16_t TxXferCount;
+    uint8_t *pRxBuffPtr;
+    uint16_t RxXferSize;
+    __IO uint16_t RxXferCount;
+    DMA_HandleTypeDef *hdmatx;
+    DMA_HandleTypeDef *hdmarx;
+    __IO HAL_SPI_StateTypeDef State;
+    __IO uint32_t ErrorCode;
+  } SPI_HandleTypeDef;
+
+  HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size, uint32_t Timeout);
+  HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+  HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+                                            uint16_t Size, uint32_t Timeout);
+  HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+                                                uint16_t Size);
+  HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi);
+  HAL_SPI_StateTypeDef HAL_SPI_GetState(const SPI_HandleTypeDef *hspi);
+  uint32_t HAL_SPI_GetError(const SPI_HandleTypeDef *hspi);
+
+  void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+  void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+
+  extern SPI_TypeDef feb_host_spi1;
+  extern SPI_TypeDef feb_host_spi2;
+#define SPI1 (&feb_host_spi1)
+#define SPI2 (&feb_host_spi2)
+
+  /* ============================================================================
+   * CAN (bxCAN)
+   * ============================================================================ */
+
+  typedef struct
+  {
+    __IO uint32_t TIR;
+    __IO uint32_t TDTR;
+    __IO uint32_t TDLR;
+    __IO uint32_t TDHR;
+  } CAN_TxMailBox_TypeDef;
+
+  typedef struct
+  {
+    __IO uint32_t RIR;
+    __IO uint32_t RDTR;
+    __IO uint32_t RDLR;
+    __IO uint32_t RDHR;
+  } CAN_FIFOMailBox_TypeDef;
+
+  typedef struct
+  {
+    __IO uint32_t FR1;
+    __IO uint32_t FR2;
+  } CAN_FilterRegister_TypeDef;
+
+  typedef struct
+  {
+    __IO uint32_t MCR;
+    __IO uint32_t MSR;
+    __IO uint32_t TSR;
+    __IO uint32_t RF0R;
+    __IO uint32_t RF1R;
+    __IO uint32_t IER;
+    __IO uint32_t ESR;
+    __IO uint32_t BTR;
+    CAN_TxMailBox_TypeDef sTxMailBox[3];
+    CAN_FIFOMailBox_TypeDef sFIFOMailBox[2];
+    __IO uint32_t FMR;
+    __IO uint32_t FM1R;
+    __IO uint32_t FS1R;
+    __IO uint32_t FFA1R;
+    __IO uint32_t FA1R;
+    CAN_FilterRegister_TypeDef sFilterRegister[28];
+  } CAN_TypeDef;
+
+  /* Simulated register blocks. CAN1 owns the shared filter banks, as on F4. */
+  extern CAN_TypeDef feb_host_can1;
+  extern CAN_TypeDef feb_host_can2;
+#define CAN1 (&feb_host_can1)
+#define CAN2 (&feb_host_can2)
+
+#define CAN_FMR_CAN2SB_Pos (8U)
+#define CAN_FMR_CAN2SB_Msk (0x3FUL << CAN_FMR_CAN2SB_Pos)
+
+#define CAN_ID_STD (0x00000000U)
+#define CAN_ID_EXT (0x00000004U)
+#define CAN_RTR_DATA (0x00000000U)
+#define CAN_RTR_REMOTE (0x00000002U)
+
+#define CAN_RX_FIFO0 (0x00000000U)
+#define CAN_RX_FIFO1 (0x00000001U)
+#define CAN_FILTER_FIFO0 (0x00000000U)
+#define CAN_FILTER_FIFO1 (0x00000001U)
+
+#define CAN_TX_MAILBOX0 (0x00000001U)
+#define CAN_TX_MAILBOX1 (0x00000002U)
+#define CAN_TX_MAILBOX2 (0x00000004U)
+
+#define CAN_FILTERMODE_IDMASK (0x00000000U)
+#define CAN_FILTERMODE_IDLIST (0x00000001U)
+#define CAN_FILTERSCALE_16BIT (0x00000000U)
+#define CAN_FILTERSCALE_32BIT (0x00000001U)
+#define CAN_FILTER_DISABLE (0x00000000U)
+#define CAN_FILTER_ENABLE (0x00000001U)
+
+#define CAN_IT_TX_MAILBOX_EMPTY (0x00000001U)
+#define CAN_IT_RX_FIFO0_MSG_PENDING (0x00000002U)
+#define CAN_IT_RX_FIFO0_FULL (0x00000004U)
+#define CAN_IT_RX_FIFO0_OVERRUN (0x00000008U)
+#define CAN_IT_RX_FIFO1_MSG_PENDING (0x00000010U)
+#define CAN_IT_RX_FIFO1_FULL (0x00000020U)
+#define CAN_IT_RX_FIFO1_OVERRUN (0x00000040U)
+#define CAN_IT_ERROR_WARNING (0x00000100U)
+#define CAN_IT_ERROR_PASSIVE (0x00000200U)
+#define CAN_IT_BUSOFF (0x00000400U)
+#define CAN_IT_LAST_ERROR_CODE (0x00000800U)
+#define CAN_IT_ERROR (0x00008000U)
+#define CAN_IT_WAKEUP (0x00010000U)
+#define CAN_IT_SLEEP_ACK (0x00020000U)
+
+#define HAL_CAN_ERROR_NONE (0x00000000U)
+#define HAL_CAN_ERROR_EWG (0x00000001U)
+#define HAL_CAN_ERROR_EPV (0x00000002U)
+#define HAL_CAN_ERROR_BOF (0x00000004U)
+#define HAL_CAN_ERROR_STF (0x00000008U)
+#define HAL_CAN_ERROR_FOR (0x00000010U)
+#define HAL_CAN_ERROR_ACK (0x00000020U)
+#define HAL_CAN_ERROR_BR (0x00000040U)
+#define HAL_CAN_ERROR_BD (0x00000080U)
+#define HAL_CAN_ERROR_CRC (0x00000100U)
+#define HAL_CAN_ERROR_RX_FOV0 (0x00000200U)
+#define HAL_CAN_ERROR_RX_FOV1 (0x00000400U)
+#define HAL_CAN_ERROR_TX_ALST0 (0x00000800U)
+#define HAL_CAN_ERROR_TX_TERR0 (0x00001000U)
+#define HAL_CAN_ERROR_TX_ALST1 (0x00002000U)
+#define HAL_CAN_ERROR_TX_TERR1 (0x00004000U)
+#define HAL_CAN_ERROR_TX_ALST2 (0x00008000U)
+#define HAL_CAN_ERROR_TX_TERR2 (0x00010000U)
+#define HAL_CAN_ERROR_TIMEOUT (0x00020000U)
+#define HAL_CAN_ERROR_NOT_INITIALIZED (0x00040000U)
+#define HAL_CAN_ERROR_NOT_READY (0x00080000U)
+#define HAL_CAN_ERROR_NOT_STARTED (0x00100000U)
+#define HAL_CAN_ERROR_PARAM (0x00200000U)
+
+  typedef enum
+  {
+    HAL_CAN_STATE_RESET = 0x00U,
+    HAL_CAN_STATE_READY = 0x01U,
+    HAL_CAN_STATE_LISTENING = 0x02U,
+    HAL_CAN_STATE_SLEEP_PENDING = 0x03U,
+    HAL_CAN_STATE_SLEEP_ACTIVE = 0x04U,
+    HAL_CAN_STATE_ERROR = 0x05U
+  } HAL_CAN_StateTypeDef;
+
+  typedef struct
+  {
+    uint32_t Prescaler;
+    uint32_t Mode;
+    uint32_t SyncJumpWidth;
+    uint32_t TimeSeg1;
+    uint32_t TimeSeg2;
+    FunctionalState TimeTriggeredMode;
+    FunctionalState AutoBusOff;
+    FunctionalState AutoWakeUp;
+    FunctionalState AutoRetransmission;
+    FunctionalState ReceiveFifoLocked;
+    FunctionalState TransmitFifoPriority;
+  } CAN_InitTypeDef;
+
+  typedef struct
+  {
+    uint32_t FilterIdHigh;
+    uint32_t FilterIdLow;
+    uint32_t FilterMaskIdHigh;
+    uint32_t FilterMaskIdLow;
+    uint32_t FilterFIFOAssignment;
+    uint32_t FilterBank;
+    uint32_t FilterMode;
+    uint32_t FilterScale;
+    uint32_t FilterActivation;
+    uint32_t SlaveStartFilterBank;
+  } CAN_FilterTypeDef;
+
+  typedef struct
+  {
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    FunctionalState TransmitGlobalTime;
+  } CAN_TxHeaderTypeDef;
+
+  typedef struct
+  {
+    uint32_t StdId;
+    uint32_t ExtId;
+    uint32_t IDE;
+    uint32_t RTR;
+    uint32_t DLC;
+    uint32_t Timestamp;
+    uint32_t FilterMatchIndex;
+  } CAN_RxHeaderTypeDef;
+
+  typedef struct __CAN_HandleTypeDef
+  {
+    CAN_TypeDef *Instance;
+    CAN_InitTypeDef Init;
+    __IO HAL_CAN_StateTypeDef State;
+    __IO uint32_t ErrorCode;
+  } CAN_HandleTypeDef;
+
+  HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef *hcan, const CAN_FilterTypeDef *sFilterConfig);
+  HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef *hcan);
+  HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef *hcan);
+  HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs);
+  HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef *hcan, uint32_t InactiveITs);
+  HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan, const CAN_TxHeaderTypeDef *pHeader,
+                                         const uint8_t aData[], uint32_t *pTxMailbox);
+  HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes);
+  uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef *hcan);
+  uint32_t HAL_CAN_IsTxMessagePending(const CAN_HandleTypeDef *hcan, uint32_t TxMailboxes);
+  HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan, uint32_t RxFifo, CAN_RxHeaderTypeDef *pHeader,
+                                         uint8_t aData[]);
+  uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef *hcan, uint32_t RxFifo);
+  HAL_CAN_StateTypeDef HAL_CAN_GetState(const CAN_HandleTypeDef *hcan);
+  uint32_t HAL_CAN_GetError(const CAN_HandleTypeDef *hcan);
+
+  void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan);
+  void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEB_HOST_STM32F4XX_HAL_H */
@@ -0,0 +1,52 @@
+/**
+ ******************************************************************************
+ * @file           : task.h
+ * @brief          : FEB Host Shim - FreeRTOS direct-to-task notifications
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Board tasks are woken with the FreeRTOS notification API rather than
+ * CMSIS thread flags. A TaskHandle_t is an osThreadId_t, exactly as the
+ * FreeRTOS CMSIS-RTOS2 wrapper hands them out, and each thread carries one
+ * notification count. ulTaskNotifyTake timeouts are in ticks against the
+ * wall clock, like the other shim waits.
+ *
+ ******************************************************************************
+ */
+
+#ifndef FEB_HOST_TASK_H
+#define FEB_HOST_TASK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "FreeRTOS.h"
+
+  typedef void *TaskHandle_t;
+
+/** No scheduler to yield to: the woken thread runs when the host schedules it. */
+#define portYIELD_FROM_ISR(xSwitchRequired) ((void)(xSwitchRequired))
+
+  /** Increment the task's notification count and wake it. Always pdPASS. */
+  BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+
+  /** ISR variant. *pxHigherPriorityTaskWoken (may be NULL) is left unchanged. */
+  void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken);
+
+  /**
+   * @brief Wait for the calling task's notification count to go non-zero
+   * @param xClearCountOnExit pdTRUE = zero the count, pdFALSE = decrement it
+   * @return The count before it was cleared / decremented, 0 on timeout
+   */
+  uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+  TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FEB_HOST_TASK_H */
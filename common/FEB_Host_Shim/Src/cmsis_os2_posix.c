@@ -0,0 +1,904 @@
+/**
+ ******************************************************************************
+ * @file           : cmsis_os2_posix.c
+ * @brief          : FEB Host Shim - CMSIS-RTOS2 subset on POSIX threads
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Every object is a heap block guarded by its own pthread mutex, with
+ * condition variables on CLOCK_MONOTONIC for timed waits. Return codes follow
+ * the FreeRTOS CMSIS-RTOS2 wrapper that the boards link against, including
+ * the ISR restrictions, so misuse that would fail on target fails here too.
+ *
+ * Threads that were not created through osThreadNew (the harness main thread,
+ * a benchmark's worker) are adopted on first use so osThreadGetId, mutex
+ * ownership and thread flags work from any thread.
+ *
+ ******************************************************************************
+ */
+
+#include "FreeRTOS.h"
+#include "cmsis_os2.h"
+#include "feb_host.h"
+#include "main.h"
+#include "task.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static bool host_in_isr(void)
+{
+  return xPortIsInsideInterrupt() != pdFALSE;
+}
+
+static void host_cond_init(pthread_cond_t *cond)
+{
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+static void host_deadline(uint32_t timeout_ms, struct timespec *ts)
+{
+  clock_gettime(CLOCK_MONOTONIC, ts);
+  ts->tv_sec += (time_t)(timeout_ms / 1000U);
+  ts->tv_nsec += (long)(timeout_ms % 1000U) * 1000000L;
+  if (ts->tv_nsec >= 1000000000L)
+  {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+/**
+ * Wait on cond until signalled or the deadline passes.
+ * @return false on timeout
+ */
+static bool host_wait(pthread_cond_t *cond, pthread_mutex_t *lock, uint32_t timeout, const struct timespec *deadline)
+{
+  if (timeout == osWaitForever)
+  {
+    pthread_cond_wait(cond, lock);
+    return true;
+  }
+  return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+/* ============================================================================
+ * Kernel
+ * ============================================================================ */
+
+static osKernelState_t host_kernel_state = osKernelInactive;
+
+osStatus_t osKernelInitialize(void)
+{
+  if (host_kernel_state != osKernelInactive)
+  {
+    return osError;
+  }
+  host_kernel_state = osKernelReady;
+  return osOK;
+}
+
+osStatus_t osKernelStart(void)
+{
+  /* Threads created with osThreadNew are already running; the harness keeps
+   * its own thread, so unlike FreeRTOS this returns. */
+  if (host_kernel_state != osKernelReady)
+  {
+    return osError;
+  }
+  host_kernel_state = osKernelRunning;
+  return osOK;
+}
+
+osKernelState_t osKernelGetState(void)
+{
+  return host_kernel_state;
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+  return HAL_GetTick();
+}
+
+uint32_t osKernelGetTickFreq(void)
+{
+  return configTICK_RATE_HZ;
+}
+
+uint32_t osKernelGetSysTimerCount(void)
+{
+  return (uint32_t)((FEB_Host_Time_Ns() * (uint64_t)SystemCoreClock) / 1000000000ULL);
+}
+
+uint32_t osKernelGetSysTimerFreq(void)
+{
+  return SystemCoreClock;
+}
+
+/* ============================================================================
+ * Threads
+ * ============================================================================ */
+
+typedef struct
+{
+  pthread_t tid;
+  const char *name;
+  osPriority_t priority;
+  osThreadFunc_t func;
+  void *argument;
+  bool joinable;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  uint32_t flags;
+  uint32_t notify_count;
+} host_thread_t;
+
+static __thread host_thread_t *tls_self;
+
+static host_thread_t *host_thread_alloc(const char *name, osPriority_t priority)
+{
+  host_thread_t *t = calloc(1, sizeof(*t));
+  if (t == NULL)
+  {
+    return NULL;
+  }
+  t->name = name;
+  t->priority = priority;
+  pthread_mutex_init(&t->lock, NULL);
+  host_cond_init(&t->cond);
+  return t;
+}
+
+static host_thread_t *host_thread_self(void)
+{
+  if (tls_self == NULL)
+  {
+    tls_self = host_thread_alloc("host", osPriorityNormal);
+    if (tls_self != NULL)
+    {
+      tls_self->tid = pthread_self();
+    }
+  }
+  return tls_self;
+}
+
+static void *host_thread_entry(void *arg)
+{
+  host_thread_t *t = arg;
+  tls_self = t;
+  t->func(t->argument);
+  return NULL;
+}
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+  if (func == NULL || host_in_isr())
+  {
+    return NULL;
+  }
+
+  osPriority_t prio = (attr != NULL && attr->priority != osPriorityNone) ? attr->priority : osPriorityNormal;
+  host_thread_t *t = host_thread_alloc((attr != NULL) ? attr->name : NULL, prio);
+  if (t == NULL)
+  {
+    return NULL;
+  }
+  t->func = func;
+  t->argument = argument;
+  t->joinable = (attr != NULL) && ((attr->attr_bits & osThreadJoinable) != 0U);
+
+  pthread_attr_t pattr;
+  pthread_attr_init(&pattr);
+  pthread_attr_setdetachstate(&pattr, t->joinable ? PTHREAD_CREATE_JOINABLE : PTHREAD_CREATE_DETACHED);
+  int rc = pthread_create(&t->tid, &pattr, host_thread_entry, t);
+  pthread_attr_destroy(&pattr);
+
+  if (rc != 0)
+  {
+    free(t);
+    return NULL;
+  }
+  return t;
+}
+
+const char *osThreadGetName(osThreadId_t thread_id)
+{
+  return (thread_id != NULL) ? ((host_thread_t *)thread_id)->name : NULL;
+}
+
+osThreadId_t osThreadGetId(void)
+{
+  return host_thread_self();
+}
+
+osPriority_t osThreadGetPriority(osThreadId_t thread_id)
+{
+  return (thread_id != NULL) ? ((host_thread_t *)thread_id)->priority : osPriorityError;
+}
+
+osStatus_t osThreadSetPriority(osThreadId_t thread_id, osPriority_t priority)
+{
+  if (thread_id == NULL || priority < osPriorityIdle || priority > osPriorityISR)
+  {
+    return osErrorParameter;
+  }
+  ((host_thread_t *)thread_id)->priority = priority;
+  return osOK;
+}
+
+osStatus_t osThreadYield(void)
+{
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  sched_yield();
+  return osOK;
+}
+
+osStatus_t osThreadJoin(osThreadId_t thread_id)
+{
+  host_thread_t *t = thread_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (t == NULL || !t->joinable)
+  {
+    return osErrorParameter;
+  }
+  if (pthread_join(t->tid, NULL) != 0)
+  {
+    return osErrorResource;
+  }
+  pthread_cond_destroy(&t->cond);
+  pthread_mutex_destroy(&t->lock);
+  free(t);
+  return osOK;
+}
+
+void osThreadExit(void)
+{
+  pthread_exit(NULL);
+}
+
+/* ============================================================================
+ * Thread Flags
+ * ============================================================================ */
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+  host_thread_t *t = thread_id;
+  if (t == NULL || (flags & osFlagsError) != 0U)
+  {
+    return osFlagsErrorParameter;
+  }
+
+  pthread_mutex_lock(&t->lock);
+  t->flags |= flags;
+  uint32_t result = t->flags;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+  return result;
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags)
+{
+  if (host_in_isr())
+  {
+    return osFlagsErrorISR;
+  }
+  if ((flags & osFlagsError) != 0U)
+  {
+    return osFlagsErrorParameter;
+  }
+
+  host_thread_t *t = host_thread_self();
+  pthread_mutex_lock(&t->lock);
+  uint32_t prev = t->flags;
+  t->flags &= ~flags;
+  pthread_mutex_unlock(&t->lock);
+  return prev;
+}
+
+uint32_t osThreadFlagsGet(void)
+{
+  if (host_in_isr())
+  {
+    return 0U;
+  }
+  host_thread_t *t = host_thread_self();
+  pthread_mutex_lock(&t->lock);
+  uint32_t flags = t->flags;
+  pthread_mutex_unlock(&t->lock);
+  return flags;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+  if (host_in_isr())
+  {
+    return osFlagsErrorISR;
+  }
+  if ((flags & osFlagsError) != 0U)
+  {
+    return osFlagsErrorParameter;
+  }
+
+  host_thread_t *t = host_thread_self();
+  struct timespec deadline;
+  host_deadline(timeout, &deadline);
+
+  pthread_mutex_lock(&t->lock);
+  for (;;)
+  {
+    uint32_t hit = t->flags & flags;
+    bool done = ((options & osFlagsWaitAll) != 0U) ? (hit == flags) : (hit != 0U);
+    if (done)
+    {
+      uint32_t result = t->flags;
+      if ((options & osFlagsNoClear) == 0U)
+      {
+        t->flags &= ~flags;
+      }
+      pthread_mutex_unlock(&t->lock);
+      return result;
+    }
+    if (timeout == 0U)
+    {
+      pthread_mutex_unlock(&t->lock);
+      return osFlagsErrorResource;
+    }
+    if (!host_wait(&t->cond, &t->lock, timeout, &deadline))
+    {
+      pthread_mutex_unlock(&t->lock);
+      return osFlagsErrorTimeout;
+    }
+  }
+}
+
+/* ============================================================================
+ * Task Notifications (FreeRTOS task.h)
+ * ============================================================================ */
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+  host_thread_t *t = xTaskToNotify;
+  if (t == NULL)
+  {
+    return pdFAIL;
+  }
+
+  pthread_mutex_lock(&t->lock);
+  t->notify_count++;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+  (void)pxHigherPriorityTaskWoken;
+  (void)xTaskNotifyGive(xTaskToNotify);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+  host_thread_t *t = host_thread_self();
+  struct timespec deadline;
+  host_deadline(xTicksToWait, &deadline);
+
+  pthread_mutex_lock(&t->lock);
+  while (t->notify_count == 0U)
+  {
+    if (xTicksToWait == 0U || !host_wait(&t->cond, &t->lock, xTicksToWait, &deadline))
+    {
+      pthread_mutex_unlock(&t->lock);
+      return 0U;
+    }
+  }
+  uint32_t count = t->notify_count;
+  t->notify_count = (xClearCountOnExit != pdFALSE) ? 0U : count - 1U;
+  pthread_mutex_unlock(&t->lock);
+  return count;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+  return host_thread_self();
+}
+
+/* ============================================================================
+ * Delay
+ * ============================================================================ */
+
+osStatus_t osDelay(uint32_t ticks)
+{
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (ticks == 0U)
+  {
+    return osErrorParameter;
+  }
+
+  /* Virtual time: the delay is the caller's own time passing. */
+  HAL_Delay(ticks);
+  sched_yield();
+  return osOK;
+}
+
+osStatus_t osDelayUntil(uint32_t ticks)
+{
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+
+  uint32_t delta = ticks - osKernelGetTickCount();
+  if (delta == 0U || delta > 0x7FFFFFFFU)
+  {
+    return osErrorParameter;
+  }
+  return osDelay(delta);
+}
+
+/* ============================================================================
+ * Mutex
+ * ============================================================================ */
+
+typedef struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  host_thread_t *owner;
+  uint32_t depth;
+  bool recursive;
+} host_mutex_t;
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+  if (host_in_isr())
+  {
+    return NULL;
+  }
+
+  host_mutex_t *m = calloc(1, sizeof(*m));
+  if (m == NULL)
+  {
+    return NULL;
+  }
+  pthread_mutex_init(&m->lock, NULL);
+  host_cond_init(&m->cond);
+  m->recursive = (attr != NULL) && ((attr->attr_bits & osMutexRecursive) != 0U);
+  return m;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+  host_mutex_t *m = mutex_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (m == NULL)
+  {
+    return osErrorParameter;
+  }
+
+  host_thread_t *self = host_thread_self();
+  struct timespec deadline;
+  host_deadline(timeout, &deadline);
+
+  pthread_mutex_lock(&m->lock);
+  if (m->owner == self)
+  {
+    osStatus_t st = osErrorResource;
+    if (m->recursive)
+    {
+      m->depth++;
+      st = osOK;
+    }
+    pthread_mutex_unlock(&m->lock);
+    return st;
+  }
+
+  while (m->owner != NULL)
+  {
+    if (timeout == 0U)
+    {
+      pthread_mutex_unlock(&m->lock);
+      return osErrorResource;
+    }
+    if (!host_wait(&m->cond, &m->lock, timeout, &deadline) && m->owner != NULL)
+    {
+      pthread_mutex_unlock(&m->lock);
+      return osErrorTimeout;
+    }
+  }
+
+  m->owner = self;
+  m->depth = 1;
+  pthread_mutex_unlock(&m->lock);
+  return osOK;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+  host_mutex_t *m = mutex_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (m == NULL)
+  {
+    return osErrorParameter;
+  }
+
+  osStatus_t st = osOK;
+  pthread_mutex_lock(&m->lock);
+  if (m->owner != host_thread_self())
+  {
+    st = osErrorResource;
+  }
+  else if (--m->depth == 0U)
+  {
+    m->owner = NULL;
+    pthread_cond_signal(&m->cond);
+  }
+  pthread_mutex_unlock(&m->lock);
+  return st;
+}
+
+osThreadId_t osMutexGetOwner(osMutexId_t mutex_id)
+{
+  host_mutex_t *m = mutex_id;
+  if (m == NULL || host_in_isr())
+  {
+    return NULL;
+  }
+  pthread_mutex_lock(&m->lock);
+  host_thread_t *owner = m->owner;
+  pthread_mutex_unlock(&m->lock);
+  return owner;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id)
+{
+  host_mutex_t *m = mutex_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (m == NULL)
+  {
+    return osErrorParameter;
+  }
+  pthread_cond_destroy(&m->cond);
+  pthread_mutex_destroy(&m->lock);
+  free(m);
+  return osOK;
+}
+
+/* ============================================================================
+ * Semaphore
+ * ============================================================================ */
+
+typedef struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  uint32_t count;
+  uint32_t max;
+} host_sem_t;
+
+osSemaphoreId_t osSemaphoreNew(uint32_t max_count, uint32_t initial_count, const osSemaphoreAttr_t *attr)
+{
+  (void)attr;
+  if (host_in_isr() || max_count == 0U || initial_count > max_count)
+  {
+    return NULL;
+  }
+
+  host_sem_t *s = calloc(1, sizeof(*s));
+  if (s == NULL)
+  {
+    return NULL;
+  }
+  pthread_mutex_init(&s->lock, NULL);
+  host_cond_init(&s->cond);
+  s->count = initial_count;
+  s->max = max_count;
+  return s;
+}
+
+osStatus_t osSemaphoreAcquire(osSemaphoreId_t semaphore_id, uint32_t timeout)
+{
+  host_sem_t *s = semaphore_id;
+  if (s == NULL || (host_in_isr() && timeout != 0U))
+  {
+    return osErrorParameter;
+  }
+
+  struct timespec deadline;
+  host_deadline(timeout, &deadline);
+
+  pthread_mutex_lock(&s->lock);
+  while (s->count == 0U)
+  {
+    if (timeout == 0U)
+    {
+      pthread_mutex_unlock(&s->lock);
+      return osErrorResource;
+    }
+    if (!host_wait(&s->cond, &s->lock, timeout, &deadline) && s->count == 0U)
+    {
+      pthread_mutex_unlock(&s->lock);
+      return osErrorTimeout;
+    }
+  }
+  s->count--;
+  pthread_mutex_unlock(&s->lock);
+  return osOK;
+}
+
+osStatus_t osSemaphoreRelease(osSemaphoreId_t semaphore_id)
+{
+  host_sem_t *s = semaphore_id;
+  if (s == NULL)
+  {
+    return osErrorParameter;
+  }
+
+  osStatus_t st = osOK;
+  pthread_mutex_lock(&s->lock);
+  if (s->count >= s->max)
+  {
+    st = osErrorResource;
+  }
+  else
+  {
+    s->count++;
+    pthread_cond_signal(&s->cond);
+  }
+  pthread_mutex_unlock(&s->lock);
+  return st;
+}
+
+uint32_t osSemaphoreGetCount(osSemaphoreId_t semaphore_id)
+{
+  host_sem_t *s = semaphore_id;
+  if (s == NULL)
+  {
+    return 0U;
+  }
+  pthread_mutex_lock(&s->lock);
+  uint32_t count = s->count;
+  pthread_mutex_unlock(&s->lock);
+  return count;
+}
+
+osStatus_t osSemaphoreDelete(osSemaphoreId_t semaphore_id)
+{
+  host_sem_t *s = semaphore_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (s == NULL)
+  {
+    return osErrorParameter;
+  }
+  pthread_cond_destroy(&s->cond);
+  pthread_mutex_destroy(&s->lock);
+  free(s);
+  return osOK;
+}
+
+/* ============================================================================
+ * Message Queue
+ * ============================================================================ */
+
+typedef struct
+{
+  pthread_mutex_t lock;
+  pthread_cond_t not_empty;
+  pthread_cond_t not_full;
+  uint32_t msg_count;
+  uint32_t msg_size;
+  uint32_t head;
+  uint32_t used;
+  uint8_t *buf;
+} host_mq_t;
+
+osMessageQueueId_t osMessageQueueNew(uint32_t msg_count, uint32_t msg_size, const osMessageQueueAttr_t *attr)
+{
+  (void)attr;
+  if (host_in_isr() || msg_count == 0U || msg_size == 0U)
+  {
+    return NULL;
+  }
+
+  host_mq_t *q = calloc(1, sizeof(*q));
+  if (q == NULL)
+  {
+    return NULL;
+  }
+  q->buf = malloc((size_t)msg_count * msg_size);
+  if (q->buf == NULL)
+  {
+    free(q);
+    return NULL;
+  }
+  pthread_mutex_init(&q->lock, NULL);
+  host_cond_init(&q->not_empty);
+  host_cond_init(&q->not_full);
+  q->msg_count = msg_count;
+  q->msg_size = msg_size;
+  return q;
+}
+
+osStatus_t osMessageQueuePut(osMessageQueueId_t mq_id, const void *msg_ptr, uint8_t msg_prio, uint32_t timeout)
+{
+  (void)msg_prio; /* FreeRTOS wrapper ignores priority too */
+  host_mq_t *q = mq_id;
+  if (q == NULL || msg_ptr == NULL || (host_in_isr() && timeout != 0U))
+  {
+    return osErrorParameter;
+  }
+
+  struct timespec deadline;
+  host_deadline(timeout, &deadline);
+
+  pthread_mutex_lock(&q->lock);
+  while (q->used == q->msg_count)
+  {
+    if (timeout == 0U)
+    {
+      pthread_mutex_unlock(&q->lock);
+      return osErrorResource;
+    }
+    if (!host_wait(&q->not_full, &q->lock, timeout, &deadline) && q->used == q->msg_count)
+    {
+      pthread_mutex_unlock(&q->lock);
+      return osErrorTimeout;
+    }
+  }
+
+  uint32_t tail = (q->head + q->used) % q->msg_count;
+  memcpy(&q->buf[(size_t)tail * q->msg_size], msg_ptr, q->msg_size);
+  q->used++;
+  pthread_cond_signal(&q->not_empty);
+  pthread_mutex_unlock(&q->lock);
+  return osOK;
+}
+
+osStatus_t osMessageQueueGet(osMessageQueueId_t mq_id, void *msg_ptr, uint8_t *msg_prio, uint32_t timeout)
+{
+  host_mq_t *q = mq_id;
+  if (q == NULL || msg_ptr == NULL || (host_in_isr() && timeout != 0U))
+  {
+    return osErrorParameter;
+  }
+
+  struct timespec deadline;
+  host_deadline(timeout, &deadline);
+
+  pthread_mutex_lock(&q->lock);
+  while (q->used == 0U)
+  {
+    if (timeout == 0U)
+    {
+      pthread_mutex_unlock(&q->lock);
+      return osErrorResource;
+    }
+    if (!host_wait(&q->not_empty, &q->lock, timeout, &deadline) && q->used == 0U)
+    {
+      pthread_mutex_unlock(&q->lock);
+      return osErrorTimeout;
+    }
+  }
+
+  memcpy(msg_ptr, &q->buf[(size_t)q->head * q->msg_size], q->msg_size);
+  q->head = (q->head + 1U) % q->msg_count;
+  q->used--;
+  pthread_cond_signal(&q->not_full);
+  pthread_mutex_unlock(&q->lock);
+
+  if (msg_prio != NULL)
+  {
+    *msg_prio = 0U;
+  }
+  return osOK;
+}
+
+uint32_t osMessageQueueGetCapacity(osMessageQueueId_t mq_id)
+{
+  host_mq_t *q = mq_id;
+  return (q != NULL) ? q->msg_count : 0U;
+}
+
+uint32_t osMessageQueueGetMsgSize(osMessageQueueId_t mq_id)
+{
+  host_mq_t *q = mq_id;
+  return (q != NULL) ? q->msg_size : 0U;
+}
+
+uint32_t osMessageQueueGetCount(osMessageQueueId_t mq_id)
+{
+  host_mq_t *q = mq_id;
+  if (q == NULL)
+  {
+    return 0U;
+  }
+  pthread_mutex_lock(&q->lock);
+  uint32_t used = q->used;
+  pthread_mutex_unlock(&q->lock);
+  return used;
+}
+
+uint32_t osMessageQueueGetSpace(osMessageQueueId_t mq_id)
+{
+  host_mq_t *q = mq_id;
+  if (q == NULL)
+  {
+    return 0U;
+  }
+  pthread_mutex_lock(&q->lock);
+  uint32_t space = q->msg_count - q->used;
+  pthread_mutex_unlock(&q->lock);
+  return space;
+}
+
+osStatus_t osMessageQueueReset(osMessageQueueId_t mq_id)
+{
+  host_mq_t *q = mq_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (q == NULL)
+  {
+    return osErrorParameter;
+  }
+  pthread_mutex_lock(&q->lock);
+  q->head = 0U;
+  q->used = 0U;
+  pthread_cond_broadcast(&q->not_full);
+  pthread_mutex_unlock(&q->lock);
+  return osOK;
+}
+
+osStatus_t osMessageQueueDelete(osMessageQueueId_t mq_id)
+{
+  host_mq_t *q = mq_id;
+  if (host_in_isr())
+  {
+    return osErrorISR;
+  }
+  if (q == NULL)
+  {
+    return osErrorParameter;
+  }
+  pthread_cond_destroy(&q->not_full);
+  pthread_cond_destroy(&q->not_empty);
+  pthread_mutex_destroy(&q->lock);
+  free(q->buf);
+  free(q);
+  return osOK;
+}
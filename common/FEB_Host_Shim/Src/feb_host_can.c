@@ -0,0 +1,933 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host_can.c
+ * @brief          : FEB Host Shim - simulated bxCAN controllers
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Models what the CAN library depends on from the STM32F4 bxCAN + HAL:
+ *   - HAL state machine (READY / LISTENING / ERROR) and ErrorCode bits
+ *   - 3 TX mailboxes, arbitration by identifier when the bus is clocked
+ *   - 2 RX FIFOs of depth 3 with overrun (lock or overwrite-newest)
+ *   - 28 shared filter banks in the CAN1 block, CAN2SB split, 16/32-bit
+ *     scale, mask/list mode, FIFO assignment and filter match index
+ *   - Interrupt enables in IER gate every callback, as on target
+ *
+ * Bus timing is not modelled; a harness advances time itself if needed.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_host.h"
+#include "main.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/* ============================================================================
+ * Simulated State
+ * ============================================================================ */
+
+/* FMR reset value: FINIT set, CAN2SB = 14. Reception is off until the first
+ * HAL_CAN_ConfigFilter() leaves filter init mode. */
+#define HOST_CAN_FMR_RESET 0x2A1C0E01U
+#define HOST_CAN_FMR_FINIT 0x00000001U
+#define HOST_CAN_MCR_INRQ 0x00000001U
+#define HOST_CAN_TSR_TME_POS 26U
+
+CAN_TypeDef feb_host_can1 = {.FMR = HOST_CAN_FMR_RESET};
+CAN_TypeDef feb_host_can2;
+
+typedef struct
+{
+  FEB_Host_CAN_Frame_t frame;
+  uint32_t fmi;
+} host_can_rx_slot_t;
+
+typedef struct
+{
+  CAN_HandleTypeDef *hcan;
+  bool mbox_used[3];
+  uint32_t mbox_seq[3];
+  FEB_Host_CAN_Frame_t mbox[3];
+  uint32_t abort_pending;
+  uint32_t next_seq;
+  bool tx_locked;         /* FEB_Host_CAN_BusBegin picked the frame on the wire */
+  uint8_t tx_locked_box;  /* ... in this mailbox */
+  uint32_t tx_locked_seq; /* ... loaded with this sequence number */
+
+  host_can_rx_slot_t fifo[2][FEB_HOST_CAN_FIFO_DEPTH];
+  uint8_t fifo_head[2];
+  uint8_t fifo_count[2];
+
+  uint32_t fail_count;
+  uint32_t fail_bits;
+
+  FEB_Host_CAN_TxHook_t tx_hook;
+  void *tx_hook_user;
+  FEB_Host_CAN_Stats_t stats;
+} host_can_t;
+
+static host_can_t host_can[2];
+static pthread_mutex_t host_can_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static host_can_t *host_can_get(const CAN_HandleTypeDef *hcan)
+{
+  return &host_can[(hcan->Instance == CAN2) ? 1 : 0];
+}
+
+static bool host_can_is_active(const CAN_HandleTypeDef *hcan)
+{
+  return (hcan->State == HAL_CAN_STATE_READY) || (hcan->State == HAL_CAN_STATE_LISTENING);
+}
+
+static void host_can_sync_regs(CAN_HandleTypeDef *hcan, const host_can_t *sim)
+{
+  uint32_t tsr = 0;
+  for (uint32_t i = 0; i < 3U; i++)
+  {
+    if (!sim->mbox_used[i])
+    {
+      tsr |= 1UL << (HOST_CAN_TSR_TME_POS + i);
+    }
+  }
+  hcan->Instance->TSR = tsr;
+  hcan->Instance->RF0R = sim->fifo_count[0];
+  hcan->Instance->RF1R = sim->fifo_count[1];
+}
+
+/* ============================================================================
+ * Acceptance Filter Decode
+ * ============================================================================ */
+
+static uint32_t host_can_word32(const FEB_Host_CAN_Frame_t *f)
+{
+  if (f->ide == CAN_ID_STD)
+  {
+    return (f->id << 21) | f->rtr;
+  }
+  return (f->id << 3) | CAN_ID_EXT | f->rtr;
+}
+
+static uint32_t host_can_word16(const FEB_Host_CAN_Frame_t *f)
+{
+  uint32_t rtr = (f->rtr != CAN_RTR_DATA) ? 0x10U : 0U;
+  if (f->ide == CAN_ID_STD)
+  {
+    return ((f->id & 0x7FFU) << 5) | rtr;
+  }
+  return (((f->id >> 18) & 0x7FFU) << 5) | rtr | 0x08U | ((f->id >> 15) & 0x7U);
+}
+
+/**
+ * Walk the banks owned by this controller and pick the winning filter.
+ * Hardware priority: 32-bit before 16-bit, list before mask, then lowest
+ * filter number. The match index counts every element assigned to the FIFO,
+ * active or not, in bank order (RM0390 "Filter match index").
+ */
+static bool host_can_filter(const CAN_HandleTypeDef *hcan, const FEB_Host_CAN_Frame_t *f, uint32_t *fifo_out,
+                            uint32_t *fmi_out)
+{
+  const CAN_TypeDef *flt = CAN1;
+  if ((flt->FMR & HOST_CAN_FMR_FINIT) != 0U)
+  {
+    return false;
+  }
+
+  uint32_t can2sb = (flt->FMR & CAN_FMR_CAN2SB_Msk) >> CAN_FMR_CAN2SB_Pos;
+  uint32_t first = (hcan->Instance == CAN2) ? can2sb : 0U;
+  uint32_t last = (hcan->Instance == CAN2) ? FEB_HOST_CAN_FILTER_BANKS : can2sb;
+
+  uint32_t w32 = host_can_word32(f);
+  uint32_t w16 = host_can_word16(f);
+  uint32_t fmi_base[2] = {0U, 0U};
+  int best_rank = -1;
+
+  for (uint32_t bank = first; bank < last; bank++)
+  {
+    uint32_t bit = 1UL << bank;
+    bool scale32 = (flt->FS1R & bit) != 0U;
+    bool list = (flt->FM1R & bit) != 0U;
+    uint32_t fifo = ((flt->FFA1R & bit) != 0U) ? 1U : 0U;
+    uint32_t elems = scale32 ? (list ? 2U : 1U) : (list ? 4U : 2U);
+    uint32_t fr1 = flt->sFilterRegister[bank].FR1;
+    uint32_t fr2 = flt->sFilterRegister[bank].FR2;
+
+    if ((flt->FA1R & bit) != 0U)
+    {
+      int rank = (scale32 ? 2 : 0) + (list ? 1 : 0);
+      int hit = -1;
+
+      if (scale32 && !list)
+      {
+        hit = (((w32 ^ fr1) & fr2 & ~1U) == 0U) ? 0 : -1;
+      }
+      else if (scale32)
+      {
+        hit = (((w32 ^ fr1) & ~1U) == 0U) ? 0 : ((((w32 ^ fr2) & ~1U) == 0U) ? 1 : -1);
+      }
+      else if (!list)
+      {
+        if (((w16 ^ fr1) & (fr1 >> 16) & 0xFFFFU) == 0U)
+        {
+          hit = 0;
+        }
+        else if (((w16 ^ fr2) & (fr2 >> 16) & 0xFFFFU) == 0U)
+        {
+          hit = 1;
+        }
+      }
+      else
+      {
+        const uint32_t ids[4] = {fr1 & 0xFFFFU, fr1 >> 16, fr2 & 0xFFFFU, fr2 >> 16};
+        for (int i = 0; i < 4 && hit < 0; i++)
+        {
+          if (ids[i] == w16)
+          {
+            hit = i;
+          }
+        }
+      }
+
+      if (hit >= 0 && rank > best_rank)
+      {
+        best_rank = rank;
+        *fifo_out = fifo;
+        *fmi_out = fmi_base[fifo] + (uint32_t)hit;
+      }
+    }
+
+    fmi_base[fifo] += elems;
+  }
+
+  return best_rank >= 0;
+}
+
+/* ============================================================================
+ * HAL API
+ * ============================================================================ */
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef *hcan, const CAN_FilterTypeDef *sFilterConfig)
+{
+  if (!host_can_is_active(hcan))
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_INITIALIZED;
+    return HAL_ERROR;
+  }
+
+  /* Every bank lives in the CAN1 block, whichever handle is passed. */
+  CAN_TypeDef *can_ip = CAN1;
+  uint32_t bit = 1UL << (sFilterConfig->FilterBank & 0x1FU);
+
+  pthread_mutex_lock(&host_can_lock);
+  can_ip->FMR |= HOST_CAN_FMR_FINIT;
+  can_ip->FMR &= ~CAN_FMR_CAN2SB_Msk;
+  can_ip->FMR |= (sFilterConfig->SlaveStartFilterBank << CAN_FMR_CAN2SB_Pos) & CAN_FMR_CAN2SB_Msk;
+
+  can_ip->FA1R &= ~bit;
+
+  if (sFilterConfig->FilterScale == CAN_FILTERSCALE_16BIT)
+  {
+    can_ip->FS1R &= ~bit;
+    can_ip->sFilterRegister[sFilterConfig->FilterBank].FR1 =
+        ((0x0000FFFFU & sFilterConfig->FilterMaskIdLow) << 16U) | (0x0000FFFFU & sFilterConfig->FilterIdLow);
+    can_ip->sFilterRegister[sFilterConfig->FilterBank].FR2 =
+        ((0x0000FFFFU & sFilterConfig->FilterMaskIdHigh) << 16U) | (0x0000FFFFU & sFilterConfig->FilterIdHigh);
+  }
+  else
+  {
+    can_ip->FS1R |= bit;
+    can_ip->sFilterRegister[sFilterConfig->FilterBank].FR1 =
+        ((0x0000FFFFU & sFilterConfig->FilterIdHigh) << 16U) | (0x0000FFFFU & sFilterConfig->FilterIdLow);
+    can_ip->sFilterRegister[sFilterConfig->FilterBank].FR2 =
+        ((0x0000FFFFU & sFilterConfig->FilterMaskIdHigh) << 16U) | (0x0000FFFFU & sFilterConfig->FilterMaskIdLow);
+  }
+
+  if (sFilterConfig->FilterMode == CAN_FILTERMODE_IDMASK)
+  {
+    can_ip->FM1R &= ~bit;
+  }
+  else
+  {
+    can_ip->FM1R |= bit;
+  }
+
+  if (sFilterConfig->FilterFIFOAssignment == CAN_FILTER_FIFO0)
+  {
+    can_ip->FFA1R &= ~bit;
+  }
+  else
+  {
+    can_ip->FFA1R |= bit;
+  }
+
+  if (sFilterConfig->FilterActivation == CAN_FILTER_ENABLE)
+  {
+    can_ip->FA1R |= bit;
+  }
+
+  can_ip->FMR &= ~HOST_CAN_FMR_FINIT;
+  pthread_mutex_unlock(&host_can_lock);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef *hcan)
+{
+  if (hcan->State != HAL_CAN_STATE_READY)
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_READY;
+    return HAL_ERROR;
+  }
+
+  hcan->State = HAL_CAN_STATE_LISTENING;
+  hcan->Instance->MCR &= ~HOST_CAN_MCR_INRQ;
+  hcan->ErrorCode = HAL_CAN_ERROR_NONE;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef *hcan)
+{
+  if (hcan->State != HAL_CAN_STATE_LISTENING)
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_STARTED;
+    return HAL_ERROR;
+  }
+
+  /* Entering INIT mode drops whatever was still waiting in the mailboxes. */
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  memset(sim->mbox_used, 0, sizeof(sim->mbox_used));
+  sim->abort_pending = 0;
+  host_can_sync_regs(hcan, sim);
+  pthread_mutex_unlock(&host_can_lock);
+
+  hcan->Instance->MCR |= HOST_CAN_MCR_INRQ;
+  hcan->State = HAL_CAN_STATE_READY;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef *hcan, uint32_t ActiveITs)
+{
+  if (!host_can_is_active(hcan))
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_INITIALIZED;
+    return HAL_ERROR;
+  }
+  hcan->Instance->IER |= ActiveITs;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_DeactivateNotification(CAN_HandleTypeDef *hcan, uint32_t InactiveITs)
+{
+  if (!host_can_is_active(hcan))
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_INITIALIZED;
+    return HAL_ERROR;
+  }
+  hcan->Instance->IER &= ~InactiveITs;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef *hcan, const CAN_TxHeaderTypeDef *pHeader,
+                                       const uint8_t aData[], uint32_t *pTxMailbox)
+{
+  if (!host_can_is_active(hcan))
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_INITIALIZED;
+    return HAL_ERROR;
+  }
+
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+
+  /* TSR.CODE: lowest-numbered empty mailbox */
+  int box = -1;
+  for (int i = 0; i < 3; i++)
+  {
+    if (!sim->mbox_used[i])
+    {
+      box = i;
+      break;
+    }
+  }
+
+  if (box < 0)
+  {
+    pthread_mutex_unlock(&host_can_lock);
+    hcan->ErrorCode |= HAL_CAN_ERROR_PARAM;
+    return HAL_ERROR;
+  }
+
+  FEB_Host_CAN_Frame_t *f = &sim->mbox[box];
+  f->ide = pHeader->IDE;
+  f->id = (pHeader->IDE == CAN_ID_STD) ? (pHeader->StdId & 0x7FFU) : (pHeader->ExtId & 0x1FFFFFFFU);
+  f->rtr = pHeader->RTR;
+  f->dlc = (uint8_t)((pHeader->DLC > 8U) ? 8U : pHeader->DLC);
+  memset(f->data, 0, sizeof(f->data));
+  memcpy(f->data, aData, f->dlc);
+
+  sim->mbox_used[box] = true;
+  sim->mbox_seq[box] = sim->next_seq++;
+  host_can_sync_regs(hcan, sim);
+  pthread_mutex_unlock(&host_can_lock);
+
+  *pTxMailbox = 1UL << box;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef *hcan, uint32_t TxMailboxes)
+{
+  if (!host_can_is_active(hcan))
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_INITIALIZED;
+    return HAL_ERROR;
+  }
+
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  for (uint32_t i = 0; i < 3U; i++)
+  {
+    if ((TxMailboxes & (1UL << i)) != 0U && sim->mbox_used[i])
+    {
+      sim->mbox_used[i] = false;
+      sim->abort_pending |= 1UL << i;
+      sim->stats.tx_aborted++;
+    }
+  }
+  host_can_sync_regs(hcan, sim);
+  pthread_mutex_unlock(&host_can_lock);
+  return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(const CAN_HandleTypeDef *hcan)
+{
+  if (!host_can_is_active(hcan))
+  {
+    return 0;
+  }
+  return 3U - FEB_Host_CAN_PendingMailboxes(hcan);
+}
+
+uint32_t HAL_CAN_IsTxMessagePending(const CAN_HandleTypeDef *hcan, uint32_t TxMailboxes)
+{
+  host_can_t *sim = host_can_get(hcan);
+  uint32_t pending = 0;
+  pthread_mutex_lock(&host_can_lock);
+  for (uint32_t i = 0; i < 3U; i++)
+  {
+    if ((TxMailboxes & (1UL << i)) != 0U && sim->mbox_used[i])
+    {
+      pending = 1;
+    }
+  }
+  pthread_mutex_unlock(&host_can_lock);
+  return pending;
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef *hcan, uint32_t RxFifo, CAN_RxHeaderTypeDef *pHeader,
+                                       uint8_t aData[])
+{
+  if (!host_can_is_active(hcan))
+  {
+    hcan->ErrorCode |= HAL_CAN_ERROR_NOT_INITIALIZED;
+    return HAL_ERROR;
+  }
+
+  host_can_t *sim = host_can_get(hcan);
+  uint32_t q = (RxFifo == CAN_RX_FIFO1) ? 1U : 0U;
+
+  pthread_mutex_lock(&host_can_lock);
+  if (sim->fifo_count[q] == 0U)
+  {
+    pthread_mutex_unlock(&host_can_lock);
+    hcan->ErrorCode |= HAL_CAN_ERROR_PARAM;
+    return HAL_ERROR;
+  }
+
+  const host_can_rx_slot_t *slot = &sim->fifo[q][sim->fifo_head[q]];
+  pHeader->IDE = slot->frame.ide;
+  pHeader->StdId = (slot->frame.ide == CAN_ID_STD) ? slot->frame.id : 0U;
+  pHeader->ExtId = (slot->frame.ide == CAN_ID_EXT) ? slot->frame.id : 0U;
+  pHeader->RTR = slot->frame.rtr;
+  pHeader->DLC = slot->frame.dlc;
+  pHeader->Timestamp = 0;
+  pHeader->FilterMatchIndex = slot->fmi;
+  memcpy(aData, slot->frame.data, 8);
+
+  sim->fifo_head[q] = (uint8_t)((sim->fifo_head[q] + 1U) % FEB_HOST_CAN_FIFO_DEPTH);
+  sim->fifo_count[q]--;
+  host_can_sync_regs(hcan, sim);
+  pthread_mutex_unlock(&host_can_lock);
+  return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetRxFifoFillLevel(const CAN_HandleTypeDef *hcan, uint32_t RxFifo)
+{
+  if (!host_can_is_active(hcan))
+  {
+    return 0;
+  }
+  const host_can_t *sim = host_can_get(hcan);
+  return __atomic_load_n(&sim->fifo_count[(RxFifo == CAN_RX_FIFO1) ? 1 : 0], __ATOMIC_ACQUIRE);
+}
+
+HAL_CAN_StateTypeDef HAL_CAN_GetState(const CAN_HandleTypeDef *hcan)
+{
+  return hcan->State;
+}
+
+uint32_t HAL_CAN_GetError(const CAN_HandleTypeDef *hcan)
+{
+  return hcan->ErrorCode;
+}
+
+/* ============================================================================
+ * Weak HAL Callbacks (the CAN library overrides these)
+ * ============================================================================ */
+
+__weak void HAL_CAN_TxMailbox0CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox1CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox2CompleteCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox0AbortCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox1AbortCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_TxMailbox2AbortCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_RxFifo0MsgPendingCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_RxFifo1MsgPendingCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+__weak void HAL_CAN_ErrorCallback(CAN_HandleTypeDef *hcan)
+{
+  UNUSED(hcan);
+}
+
+static void host_can_tx_complete_isr(CAN_HandleTypeDef *hcan, uint32_t box)
+{
+  if (box == 0U)
+  {
+    HAL_CAN_TxMailbox0CompleteCallback(hcan);
+  }
+  else if (box == 1U)
+  {
+    HAL_CAN_TxMailbox1CompleteCallback(hcan);
+  }
+  else
+  {
+    HAL_CAN_TxMailbox2CompleteCallback(hcan);
+  }
+}
+
+static void host_can_tx_abort_isr(CAN_HandleTypeDef *hcan, uint32_t box)
+{
+  if (box == 0U)
+  {
+    HAL_CAN_TxMailbox0AbortCallback(hcan);
+  }
+  else if (box == 1U)
+  {
+    HAL_CAN_TxMailbox1AbortCallback(hcan);
+  }
+  else
+  {
+    HAL_CAN_TxMailbox2AbortCallback(hcan);
+  }
+}
+
+/* ============================================================================
+ * Harness API
+ * ============================================================================ */
+
+void FEB_Host_CAN_InitHandle(CAN_HandleTypeDef *hcan, CAN_TypeDef *instance)
+{
+  hcan->Instance = instance;
+  hcan->State = HAL_CAN_STATE_READY;
+  hcan->ErrorCode = HAL_CAN_ERROR_NONE;
+  instance->MCR |= HOST_CAN_MCR_INRQ;
+  instance->IER = 0;
+  instance->ESR = 0;
+
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  memset(sim, 0, sizeof(*sim));
+  sim->hcan = hcan;
+  host_can_sync_regs(hcan, sim);
+  pthread_mutex_unlock(&host_can_lock);
+}
+
+void FEB_Host_CAN_SetTxHook(CAN_HandleTypeDef *hcan, FEB_Host_CAN_TxHook_t hook, void *user)
+{
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  sim->tx_hook = hook;
+  sim->tx_hook_user = user;
+  pthread_mutex_unlock(&host_can_lock);
+}
+
+bool FEB_Host_CAN_Receive(CAN_HandleTypeDef *hcan, uint32_t id, uint32_t ide, const uint8_t *data, uint8_t dlc)
+{
+  if (hcan->State != HAL_CAN_STATE_LISTENING)
+  {
+    return false;
+  }
+
+  FEB_Host_CAN_Frame_t f;
+  memset(&f, 0, sizeof(f));
+  f.ide = ide;
+  f.id = (ide == CAN_ID_STD) ? (id & 0x7FFU) : (id & 0x1FFFFFFFU);
+  f.rtr = CAN_RTR_DATA;
+  f.dlc = (dlc > 8U) ? 8U : dlc;
+  if (data != NULL)
+  {
+    memcpy(f.data, data, f.dlc);
+  }
+
+  host_can_t *sim = host_can_get(hcan);
+  uint32_t fifo = 0;
+  uint32_t fmi = 0;
+  bool overrun = false;
+
+  pthread_mutex_lock(&host_can_lock);
+  if (!host_can_filter(hcan, &f, &fifo, &fmi))
+  {
+    sim->stats.rx_filtered++;
+    pthread_mutex_unlock(&host_can_lock);
+    return false;
+  }
+
+  if (sim->fifo_count[fifo] >= FEB_HOST_CAN_FIFO_DEPTH)
+  {
+    overrun = true;
+    sim->stats.rx_overruns++;
+    if (hcan->Init.ReceiveFifoLocked != ENABLE)
+    {
+      /* Unlocked FIFO: the newest frame overwrites the last slot. */
+      uint32_t tail = (sim->fifo_head[fifo] + FEB_HOST_CAN_FIFO_DEPTH - 1U) % FEB_HOST_CAN_FIFO_DEPTH;
+      sim->fifo[fifo][tail].frame = f;
+      sim->fifo[fifo][tail].fmi = fmi;
+    }
+  }
+  else
+  {
+    uint32_t tail = (sim->fifo_head[fifo] + sim->fifo_count[fifo]) % FEB_HOST_CAN_FIFO_DEPTH;
+    sim->fifo[fifo][tail].frame = f;
+    sim->fifo[fifo][tail].fmi = fmi;
+    __atomic_add_fetch(&sim->fifo_count[fifo], 1, __ATOMIC_RELEASE);
+    sim->stats.rx_frames++;
+    if (sim->fifo_count[fifo] > sim->stats.rx_fifo_peak[fifo])
+    {
+      sim->stats.rx_fifo_peak[fifo] = sim->fifo_count[fifo];
+    }
+  }
+  host_can_sync_regs(hcan, sim);
+  pthread_mutex_unlock(&host_can_lock);
+
+  uint32_t ier = hcan->Instance->IER;
+  uint32_t pending_it = (fifo == 0U) ? CAN_IT_RX_FIFO0_MSG_PENDING : CAN_IT_RX_FIFO1_MSG_PENDING;
+  uint32_t overrun_it = (fifo == 0U) ? CAN_IT_RX_FIFO0_OVERRUN : CAN_IT_RX_FIFO1_OVERRUN;
+
+  FEB_Host_ISR_Enter();
+  if (overrun && (ier & overrun_it) != 0U)
+  {
+    hcan->ErrorCode |= (fifo == 0U) ? HAL_CAN_ERROR_RX_FOV0 : HAL_CAN_ERROR_RX_FOV1;
+    HAL_CAN_ErrorCallback(hcan);
+  }
+  if ((ier & pending_it) != 0U && HAL_CAN_GetRxFifoFillLevel(hcan, fifo) > 0U)
+  {
+    if (fifo == 0U)
+    {
+      HAL_CAN_RxFifo0MsgPendingCallback(hcan);
+    }
+    else
+    {
+      HAL_CAN_RxFifo1MsgPendingCallback(hcan);
+    }
+  }
+  FEB_Host_ISR_Exit();
+
+  return !overrun;
+}
+
+/* Arbitration key: lower wins. Base ID first, then SRR/RTR, then IDE, then
+ * the 18 extension bits - so a standard data frame beats an extended frame
+ * with the same base identifier, as on the wire. */
+static uint64_t host_can_arb_key(const FEB_Host_CAN_Frame_t *f)
+{
+  uint64_t rtr = (f->rtr != CAN_RTR_DATA) ? 1U : 0U;
+  if (f->ide == CAN_ID_STD)
+  {
+    return ((uint64_t)f->id << 22) | (rtr << 21);
+  }
+  return ((uint64_t)(f->id >> 18) << 22) | (1ULL << 21) | (1ULL << 20) | ((uint64_t)(f->id & 0x3FFFFU) << 1) | rtr;
+}
+
+/* Mailbox that wins internal arbitration, -1 if none is pending. Caller
+ * holds host_can_lock. */
+static int host_can_pick_box(const CAN_HandleTypeDef *hcan, const host_can_t *sim)
+{
+  int box = -1;
+  for (int i = 0; i < 3; i++)
+  {
+    if (!sim->mbox_used[i])
+    {
+      continue;
+    }
+    if (box < 0)
+    {
+      box = i;
+    }
+    else if (hcan->Init.TransmitFifoPriority == ENABLE)
+    {
+      if ((int32_t)(sim->mbox_seq[i] - sim->mbox_seq[box]) < 0)
+      {
+        box = i;
+      }
+    }
+    else if (host_can_arb_key(&sim->mbox[i]) < host_can_arb_key(&sim->mbox[box]))
+    {
+      box = i;
+    }
+  }
+  return box;
+}
+
+bool FEB_Host_CAN_BusBegin(CAN_HandleTypeDef *hcan, FEB_Host_CAN_Frame_t *frame)
+{
+  host_can_t *sim = host_can_get(hcan);
+
+  pthread_mutex_lock(&host_can_lock);
+  int box = -1;
+  if (hcan->State == HAL_CAN_STATE_LISTENING || hcan->State == HAL_CAN_STATE_ERROR)
+  {
+    box = host_can_pick_box(hcan, sim);
+  }
+  if (box >= 0)
+  {
+    sim->tx_locked = true;
+    sim->tx_locked_box = (uint8_t)box;
+    sim->tx_locked_seq = sim->mbox_seq[box];
+    if (frame != NULL)
+    {
+      *frame = sim->mbox[box];
+    }
+  }
+  pthread_mutex_unlock(&host_can_lock);
+  return box >= 0;
+}
+
+bool FEB_Host_CAN_BusStep(CAN_HandleTypeDef *hcan)
+{
+  host_can_t *sim = host_can_get(hcan);
+
+  pthread_mutex_lock(&host_can_lock);
+
+  if (sim->abort_pending != 0U)
+  {
+    uint32_t box = (uint32_t)__builtin_ctz(sim->abort_pending);
+    sim->abort_pending &= ~(1UL << box);
+    pthread_mutex_unlock(&host_can_lock);
+
+    FEB_Host_ISR_Enter();
+    if ((hcan->Instance->IER & CAN_IT_TX_MAILBOX_EMPTY) != 0U)
+    {
+      host_can_tx_abort_isr(hcan, box);
+    }
+    FEB_Host_ISR_Exit();
+    return true;
+  }
+
+  if (hcan->State != HAL_CAN_STATE_LISTENING && hcan->State != HAL_CAN_STATE_ERROR)
+  {
+    pthread_mutex_unlock(&host_can_lock);
+    return false;
+  }
+
+  /* A frame started by FEB_Host_CAN_BusBegin finishes even if a
+   * higher-priority one was loaded meanwhile, unless it was aborted. */
+  int box;
+  if (sim->tx_locked && sim->mbox_used[sim->tx_locked_box] && sim->mbox_seq[sim->tx_locked_box] == sim->tx_locked_seq)
+  {
+    box = sim->tx_locked_box;
+  }
+  else
+  {
+    box = host_can_pick_box(hcan, sim);
+  }
+  sim->tx_locked = false;
+  if (box < 0)
+  {
+    pthread_mutex_unlock(&host_can_lock);
+    return false;
+  }
+
+  FEB_Host_CAN_Frame_t frame = sim->mbox[box];
+  bool fail = false;
+  uint32_t fail_bits = 0;
+  if (sim->fail_count > 0U)
+  {
+    sim->fail_count--;
+    fail = true;
+    fail_bits = sim->fail_bits << (2U * (uint32_t)box);
+    sim->stats.tx_failed++;
+  }
+  else
+  {
+    sim->stats.tx_frames++;
+  }
+  sim->mbox_used[box] = false;
+  host_can_sync_regs(hcan, sim);
+  FEB_Host_CAN_TxHook_t hook = sim->tx_hook;
+  void *user = sim->tx_hook_user;
+  pthread_mutex_unlock(&host_can_lock);
+
+  if (!fail && hook != NULL)
+  {
+    hook(hcan, &frame, user);
+  }
+
+  FEB_Host_ISR_Enter();
+  if ((hcan->Instance->IER & CAN_IT_TX_MAILBOX_EMPTY) != 0U)
+  {
+    if (fail)
+    {
+      hcan->ErrorCode |= fail_bits;
+      HAL_CAN_ErrorCallback(hcan);
+    }
+    else
+    {
+      host_can_tx_complete_isr(hcan, (uint32_t)box);
+    }
+  }
+  FEB_Host_ISR_Exit();
+  return true;
+}
+
+uint32_t FEB_Host_CAN_BusFlush(CAN_HandleTypeDef *hcan)
+{
+  uint32_t sent = 0;
+  while (FEB_Host_CAN_BusStep(hcan))
+  {
+    sent++;
+  }
+  return sent;
+}
+
+uint32_t FEB_Host_CAN_PendingMailboxes(const CAN_HandleTypeDef *hcan)
+{
+  const host_can_t *sim = host_can_get(hcan);
+  uint32_t used = 0;
+  pthread_mutex_lock(&host_can_lock);
+  for (uint32_t i = 0; i < 3U; i++)
+  {
+    used += sim->mbox_used[i] ? 1U : 0U;
+  }
+  pthread_mutex_unlock(&host_can_lock);
+  return used;
+}
+
+void FEB_Host_CAN_FailNextTx(CAN_HandleTypeDef *hcan, uint32_t count, uint32_t error_bits)
+{
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  sim->fail_count = count;
+  sim->fail_bits = error_bits;
+  pthread_mutex_unlock(&host_can_lock);
+}
+
+void FEB_Host_CAN_InjectError(CAN_HandleTypeDef *hcan, uint32_t error_code, uint32_t esr)
+{
+  uint32_t ier = hcan->Instance->IER;
+  uint32_t err = 0;
+
+  hcan->Instance->ESR = esr;
+
+  if ((ier & CAN_IT_ERROR) != 0U)
+  {
+    if ((ier & CAN_IT_ERROR_WARNING) != 0U)
+    {
+      err |= error_code & HAL_CAN_ERROR_EWG;
+    }
+    if ((ier & CAN_IT_ERROR_PASSIVE) != 0U)
+    {
+      err |= error_code & HAL_CAN_ERROR_EPV;
+    }
+    if ((ier & CAN_IT_BUSOFF) != 0U)
+    {
+      err |= error_code & HAL_CAN_ERROR_BOF;
+    }
+    if ((ier & CAN_IT_LAST_ERROR_CODE) != 0U)
+    {
+      err |= error_code & (HAL_CAN_ERROR_STF | HAL_CAN_ERROR_FOR | HAL_CAN_ERROR_ACK | HAL_CAN_ERROR_BR |
+                           HAL_CAN_ERROR_BD | HAL_CAN_ERROR_CRC);
+    }
+  }
+
+  if ((error_code & HAL_CAN_ERROR_BOF) != 0U)
+  {
+    /* Bus-off: the controller stops transmitting and the mailboxes empty. */
+    host_can_t *sim = host_can_get(hcan);
+    pthread_mutex_lock(&host_can_lock);
+    memset(sim->mbox_used, 0, sizeof(sim->mbox_used));
+    host_can_sync_regs(hcan, sim);
+    pthread_mutex_unlock(&host_can_lock);
+  }
+
+  if (err == 0U)
+  {
+    return;
+  }
+
+  FEB_Host_ISR_Enter();
+  hcan->ErrorCode |= err;
+  if ((err & (HAL_CAN_ERROR_EWG | HAL_CAN_ERROR_EPV | HAL_CAN_ERROR_BOF)) != 0U)
+  {
+    hcan->State = HAL_CAN_STATE_ERROR;
+  }
+  HAL_CAN_ErrorCallback(hcan);
+  FEB_Host_ISR_Exit();
+}
+
+void FEB_Host_CAN_GetStats(const CAN_HandleTypeDef *hcan, FEB_Host_CAN_Stats_t *stats)
+{
+  const host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  *stats = sim->stats;
+  pthread_mutex_unlock(&host_can_lock);
+}
+
+void FEB_Host_CAN_ResetStats(CAN_HandleTypeDef *hcan)
+{
+  host_can_t *sim = host_can_get(hcan);
+  pthread_mutex_lock(&host_can_lock);
+  memset(&sim->stats, 0, sizeof(sim->stats));
+  pthread_mutex_unlock(&host_can_lock);
+}
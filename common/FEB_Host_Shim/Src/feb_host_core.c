@@ -0,0 +1,374 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host_core.c
+ * @brief          : FEB Host Shim - time base, simulated interrupts, core HAL
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ */
+
+#include "FreeRTOS.h"
+#include "feb_host.h"
+#include "main.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ============================================================================
+ * Time Base
+ * ============================================================================ */
+
+static uint64_t host_epoch_ns;
+static pthread_once_t host_epoch_once = PTHREAD_ONCE_INIT;
+static bool host_virtual;
+static uint64_t host_virtual_ns;
+static uint32_t host_dwt_read_ns;
+
+static uint64_t host_wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void host_epoch_init(void)
+{
+  host_epoch_ns = host_wall_ns();
+}
+
+void FEB_Host_Time_UseVirtual(bool enable)
+{
+  pthread_once(&host_epoch_once, host_epoch_init);
+  if (enable && !__atomic_load_n(&host_virtual, __ATOMIC_ACQUIRE))
+  {
+    __atomic_store_n(&host_virtual_ns, host_wall_ns() - host_epoch_ns, __ATOMIC_RELEASE);
+  }
+  __atomic_store_n(&host_virtual, enable, __ATOMIC_RELEASE);
+}
+
+bool FEB_Host_Time_IsVirtual(void)
+{
+  return __atomic_load_n(&host_virtual, __ATOMIC_ACQUIRE);
+}
+
+uint64_t FEB_Host_Time_Ns(void)
+{
+  pthread_once(&host_epoch_once, host_epoch_init);
+  if (__atomic_load_n(&host_virtual, __ATOMIC_ACQUIRE))
+  {
+    return __atomic_load_n(&host_virtual_ns, __ATOMIC_ACQUIRE);
+  }
+  return host_wall_ns() - host_epoch_ns;
+}
+
+uint64_t FEB_Host_Time_Us(void)
+{
+  return FEB_Host_Time_Ns() / 1000ULL;
+}
+
+void FEB_Host_Time_AdvanceNs(uint64_t ns)
+{
+  if (__atomic_load_n(&host_virtual, __ATOMIC_ACQUIRE))
+  {
+    __atomic_add_fetch(&host_virtual_ns, ns, __ATOMIC_ACQ_REL);
+  }
+}
+
+void FEB_Host_Time_AdvanceUs(uint64_t us)
+{
+  FEB_Host_Time_AdvanceNs(us * 1000ULL);
+}
+
+void FEB_Host_Time_SetDwtReadCostNs(uint32_t ns)
+{
+  __atomic_store_n(&host_dwt_read_ns, ns, __ATOMIC_RELEASE);
+}
+
+/* ============================================================================
+ * Simulated Interrupts
+ *
+ * One recursive lock stands in for the CPU's interrupt mask. A thread holds it
+ * while it is inside a simulated ISR or has PRIMASK set; the per-thread state
+ * below lets __set_PRIMASK() restore whatever the caller saved.
+ * ============================================================================ */
+
+static pthread_mutex_t irq_lock;
+static pthread_once_t irq_lock_once = PTHREAD_ONCE_INIT;
+static __thread uint32_t tls_primask;
+static __thread uint32_t tls_isr_depth;
+
+static void irq_lock_init(void)
+{
+  pthread_mutexattr_t attr;
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&irq_lock, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+static void irq_lock_take(void)
+{
+  pthread_once(&irq_lock_once, irq_lock_init);
+  pthread_mutex_lock(&irq_lock);
+}
+
+static void irq_lock_give(void)
+{
+  pthread_mutex_unlock(&irq_lock);
+}
+
+void FEB_Host_ISR_Enter(void)
+{
+  irq_lock_take();
+  tls_isr_depth++;
+}
+
+void FEB_Host_ISR_Exit(void)
+{
+  if (tls_isr_depth > 0U)
+  {
+    tls_isr_depth--;
+    irq_lock_give();
+  }
+}
+
+void __disable_irq(void)
+{
+  if (tls_primask == 0U)
+  {
+    irq_lock_take();
+    tls_primask = 1U;
+  }
+}
+
+void __enable_irq(void)
+{
+  if (tls_primask != 0U)
+  {
+    tls_primask = 0U;
+    irq_lock_give();
+  }
+}
+
+uint32_t __get_PRIMASK(void)
+{
+  return tls_primask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+  if ((priMask & 1U) != 0U)
+  {
+    __disable_irq();
+  }
+  else
+  {
+    __enable_irq();
+  }
+}
+
+uint32_t __get_IPSR(void)
+{
+  /* Any non-zero exception number reads as handler mode; 16 = first IRQ. */
+  return (tls_isr_depth > 0U) ? 16U : 0U;
+}
+
+void __WFI(void)
+{
+  sched_yield();
+}
+
+BaseType_t xPortIsInsideInterrupt(void)
+{
+  return (tls_isr_depth > 0U) ? pdTRUE : pdFALSE;
+}
+
+/* ============================================================================
+ * Core Peripherals
+ * ============================================================================ */
+
+uint32_t SystemCoreClock = FEB_HOST_SYSCLK_HZ;
+
+CoreDebug_Type feb_host_core_debug;
+
+static DWT_Type host_dwt;
+static uint64_t host_dwt_last_cycles;
+static pthread_mutex_t host_dwt_lock = PTHREAD_MUTEX_INITIALIZER;
+
+DWT_Type *feb_host_dwt(void)
+{
+  /* CYCCNT accumulates the cycle delta since the previous access, so a
+   * direct write (DWT->CYCCNT = 0) rebases the counter the way it would
+   * on silicon. */
+  pthread_mutex_lock(&host_dwt_lock);
+  FEB_Host_Time_AdvanceNs(__atomic_load_n(&host_dwt_read_ns, __ATOMIC_ACQUIRE));
+  uint64_t cycles = (FEB_Host_Time_Ns() * (uint64_t)SystemCoreClock) / 1000000000ULL;
+  if ((host_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0U)
+  {
+    host_dwt.CYCCNT += (uint32_t)(cycles - host_dwt_last_cycles);
+  }
+  host_dwt_last_cycles = cycles;
+  pthread_mutex_unlock(&host_dwt_lock);
+  return &host_dwt;
+}
+
+static FEB_Host_Reset_Hook_t host_reset_hook;
+
+void FEB_Host_SetResetHook(FEB_Host_Reset_Hook_t hook)
+{
+  host_reset_hook = hook;
+}
+
+void NVIC_SystemReset(void)
+{
+  if (host_reset_hook != NULL)
+  {
+    host_reset_hook();
+    return;
+  }
+  fprintf(stderr, "[host] NVIC_SystemReset\n");
+  fflush(NULL);
+  exit(EXIT_SUCCESS);
+}
+
+__attribute__((weak)) void Error_Handler(void)
+{
+  fprintf(stderr, "[host] Error_Handler\n");
+  fflush(NULL);
+  abort();
+}
+
+/* ============================================================================
+ * HAL Core
+ * ============================================================================ */
+
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(FEB_Host_Time_Ns() / 1000000ULL);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  if (FEB_Host_Time_IsVirtual())
+  {
+    FEB_Host_Time_AdvanceNs((uint64_t)Delay * 1000000ULL);
+    return;
+  }
+
+  struct timespec ts = {
+      .tv_sec = (time_t)(Delay / 1000U),
+      .tv_nsec = (long)(Delay % 1000U) * 1000000L,
+  };
+  while (nanosleep(&ts, &ts) != 0)
+  {
+  }
+}
+
+void HAL_SuspendTick(void)
+{
+}
+
+void HAL_ResumeTick(void)
+{
+}
+
+/* ============================================================================
+ * GPIO
+ * ============================================================================ */
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  return ((GPIOx->IDR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+#define HOST_GPIO_MAX_WRITE_HOOKS 4
+
+static struct
+{
+  FEB_Host_GPIO_WriteHook_t hook;
+  void *user;
+} host_gpio_hooks[HOST_GPIO_MAX_WRITE_HOOKS];
+static pthread_mutex_t host_gpio_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void host_gpio_notify(GPIO_TypeDef *port, uint32_t before)
+{
+  uint32_t changed = (before ^ port->ODR) & 0xFFFFU;
+  if (changed == 0U)
+  {
+    return;
+  }
+
+  pthread_mutex_lock(&host_gpio_lock);
+  for (int h = 0; h < HOST_GPIO_MAX_WRITE_HOOKS; h++)
+  {
+    if (host_gpio_hooks[h].hook == NULL)
+    {
+      continue;
+    }
+    for (uint32_t bits = changed; bits != 0U; bits &= bits - 1U)
+    {
+      uint16_t pin = (uint16_t)(bits & (~bits + 1U));
+      host_gpio_hooks[h].hook(port, pin, ((port->ODR & pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET,
+                              host_gpio_hooks[h].user);
+    }
+  }
+  pthread_mutex_unlock(&host_gpio_lock);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+  uint32_t before = GPIOx->ODR;
+  if (PinState != GPIO_PIN_RESET)
+  {
+    GPIOx->ODR |= GPIO_Pin;
+  }
+  else
+  {
+    GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+  }
+  host_gpio_notify(GPIOx, before);
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  uint32_t before = GPIOx->ODR;
+  GPIOx->ODR ^= GPIO_Pin;
+  host_gpio_notify(GPIOx, before);
+}
+
+bool FEB_Host_GPIO_AddWriteHook(FEB_Host_GPIO_WriteHook_t hook, void *user)
+{
+  bool ok = false;
+  pthread_mutex_lock(&host_gpio_lock);
+  for (int h = 0; h < HOST_GPIO_MAX_WRITE_HOOKS; h++)
+  {
+    if (host_gpio_hooks[h].hook == NULL)
+    {
+      host_gpio_hooks[h].hook = hook;
+      host_gpio_hooks[h].user = user;
+      ok = true;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&host_gpio_lock);
+  return ok;
+}
+
+void FEB_Host_GPIO_SetInput(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+  if (state != GPIO_PIN_RESET)
+  {
+    port->IDR |= pin;
+  }
+  else
+  {
+    port->IDR &= ~(uint32_t)pin;
+  }
+}
+
+GPIO_PinState FEB_Host_GPIO_GetOutput(const GPIO_TypeDef *port, uint16_t pin)
+{
+  return ((port->ODR & pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
@@ -0,0 +1,409 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host_i2c.c
+ * @brief          : FEB Host Shim - simulated I2C bus with register-map targets
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Each handle owns a small table of attached FEB_Host_I2C_Device_t targets.
+ * Memory transfers address a register, then stream reg_bytes per register
+ * (big-endian) with the pointer advancing after each register.
+ *
+ * Bus time is the SCL bit count of the transaction (start, address,
+ * register, optional repeated start + address, payload, each 9 clocks)
+ * at Init.ClockSpeed. Blocking calls advance virtual time by that amount;
+ * _IT / _DMA calls return immediately and charge it on FEB_Host_I2C_Service.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_host.h"
+#include "main.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/* ============================================================================
+ * Simulated State
+ * ============================================================================ */
+
+#define HOST_I2C_MAX_BUSES 4
+
+typedef enum
+{
+  HOST_I2C_XFER_NONE = 0,
+  HOST_I2C_XFER_READ,
+  HOST_I2C_XFER_WRITE,
+} host_i2c_xfer_t;
+
+typedef struct
+{
+  I2C_HandleTypeDef *hi2c;
+  FEB_Host_I2C_Device_t *devs[FEB_HOST_I2C_MAX_DEVICES];
+  FEB_Host_I2C_Stats_t stats;
+
+  /* In-flight _IT / _DMA transfer */
+  host_i2c_xfer_t pending;
+  uint16_t pend_addr;
+  uint16_t pend_reg;
+  uint8_t *pend_buf;
+  uint16_t pend_len;
+} host_i2c_bus_t;
+
+static host_i2c_bus_t host_i2c[HOST_I2C_MAX_BUSES];
+static pthread_mutex_t host_i2c_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static host_i2c_bus_t *host_i2c_get(const I2C_HandleTypeDef *hi2c)
+{
+  host_i2c_bus_t *free_slot = NULL;
+  for (int i = 0; i < HOST_I2C_MAX_BUSES; i++)
+  {
+    if (host_i2c[i].hi2c == hi2c)
+    {
+      return &host_i2c[i];
+    }
+    if (free_slot == NULL && host_i2c[i].hi2c == NULL)
+    {
+      free_slot = &host_i2c[i];
+    }
+  }
+  if (free_slot != NULL)
+  {
+    free_slot->hi2c = (I2C_HandleTypeDef *)hi2c;
+  }
+  return free_slot;
+}
+
+static FEB_Host_I2C_Device_t *host_i2c_find(host_i2c_bus_t *bus, uint16_t dev_address)
+{
+  uint8_t addr7 = (uint8_t)((dev_address >> 1) & 0x7FU);
+  for (int i = 0; i < FEB_HOST_I2C_MAX_DEVICES; i++)
+  {
+    FEB_Host_I2C_Device_t *dev = bus->devs[i];
+    if (dev != NULL && dev->present && dev->addr7 == addr7)
+    {
+      return dev;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Execute a memory transfer against the device. Caller holds host_i2c_lock.
+ * @return false on NACK (absent device or hook veto)
+ */
+static bool host_i2c_execute(host_i2c_bus_t *bus, host_i2c_xfer_t dir, uint16_t dev_address, uint16_t reg,
+                             uint8_t *buf, uint16_t len)
+{
+  FEB_Host_I2C_Device_t *dev = host_i2c_find(bus, dev_address);
+  bus->stats.bus_ns += FEB_Host_I2C_TransferNs(bus->hi2c, dir == HOST_I2C_XFER_READ, len);
+
+  if (dev == NULL)
+  {
+    bus->stats.nacks++;
+    return false;
+  }
+
+  uint8_t width = (dev->reg_bytes == 1U) ? 1U : 2U;
+  uint8_t r = (uint8_t)reg;
+
+  for (uint16_t i = 0; i < len; i += width, r++)
+  {
+    uint16_t chunk = (uint16_t)((len - i < width) ? (len - i) : width);
+
+    if (dir == HOST_I2C_XFER_READ)
+    {
+      if (dev->on_read != NULL && !dev->on_read(dev, r))
+      {
+        bus->stats.nacks++;
+        return false;
+      }
+      uint16_t v = dev->regs[r];
+      if (width == 2U)
+      {
+        buf[i] = (uint8_t)(v >> 8);
+        if (chunk > 1U)
+        {
+          buf[i + 1U] = (uint8_t)v;
+        }
+      }
+      else
+      {
+        buf[i] = (uint8_t)v;
+      }
+    }
+    else
+    {
+      uint16_t v = (width == 2U) ? (uint16_t)(((uint16_t)buf[i] << 8) | ((chunk > 1U) ? buf[i + 1U] : 0U))
+                                 : (uint16_t)buf[i];
+      if (dev->on_write != NULL && !dev->on_write(dev, r, v))
+      {
+        bus->stats.nacks++;
+        return false;
+      }
+      dev->regs[r] = (uint16_t)((dev->regs[r] & dev->read_only_mask[r]) | (v & (uint16_t)~dev->read_only_mask[r]));
+    }
+  }
+
+  if (dir == HOST_I2C_XFER_READ)
+  {
+    dev->reads++;
+  }
+  else
+  {
+    dev->writes++;
+  }
+  bus->stats.transactions++;
+  bus->stats.bytes += len;
+  return true;
+}
+
+static HAL_StatusTypeDef host_i2c_blocking(I2C_HandleTypeDef *hi2c, host_i2c_xfer_t dir, uint16_t dev_address,
+                                           uint16_t reg, uint8_t *buf, uint16_t len)
+{
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  bool ok = (bus != NULL) && host_i2c_execute(bus, dir, dev_address, reg, buf, len);
+  pthread_mutex_unlock(&host_i2c_lock);
+
+  FEB_Host_Time_AdvanceNs(FEB_Host_I2C_TransferNs(hi2c, dir == HOST_I2C_XFER_READ, len));
+
+  hi2c->ErrorCode = ok ? HAL_I2C_ERROR_NONE : HAL_I2C_ERROR_AF;
+  return ok ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef host_i2c_start_async(I2C_HandleTypeDef *hi2c, host_i2c_xfer_t dir, uint16_t dev_address,
+                                              uint16_t reg, uint8_t *buf, uint16_t len)
+{
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  if (bus == NULL)
+  {
+    pthread_mutex_unlock(&host_i2c_lock);
+    return HAL_ERROR;
+  }
+  bus->pending = dir;
+  bus->pend_addr = dev_address;
+  bus->pend_reg = reg;
+  bus->pend_buf = buf;
+  bus->pend_len = len;
+  pthread_mutex_unlock(&host_i2c_lock);
+
+  hi2c->Devaddress = dev_address;
+  hi2c->Memaddress = reg;
+  hi2c->pBuffPtr = buf;
+  hi2c->XferSize = len;
+  hi2c->XferCount = len;
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+  hi2c->State = (dir == HOST_I2C_XFER_READ) ? HAL_I2C_STATE_BUSY_RX : HAL_I2C_STATE_BUSY_TX;
+  return HAL_OK;
+}
+
+/* ============================================================================
+ * HAL API
+ * ============================================================================ */
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                    uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  (void)MemAddSize;
+  (void)Timeout;
+  return host_i2c_blocking(hi2c, HOST_I2C_XFER_WRITE, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  (void)MemAddSize;
+  (void)Timeout;
+  return host_i2c_blocking(hi2c, HOST_I2C_XFER_READ, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+  (void)MemAddSize;
+  return host_i2c_start_async(hi2c, HOST_I2C_XFER_WRITE, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                      uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+  (void)MemAddSize;
+  return host_i2c_start_async(hi2c, HOST_I2C_XFER_READ, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                        uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+  (void)MemAddSize;
+  return host_i2c_start_async(hi2c, HOST_I2C_XFER_WRITE, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+                                       uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+  (void)MemAddSize;
+  return host_i2c_start_async(hi2c, HOST_I2C_XFER_READ, DevAddress, MemAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials,
+                                        uint32_t Timeout)
+{
+  (void)Trials;
+  (void)Timeout;
+  if (hi2c->State != HAL_I2C_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  bool ok = (bus != NULL) && (host_i2c_find(bus, DevAddress) != NULL);
+  pthread_mutex_unlock(&host_i2c_lock);
+  return ok ? HAL_OK : HAL_ERROR;
+}
+
+HAL_I2C_StateTypeDef HAL_I2C_GetState(I2C_HandleTypeDef *hi2c)
+{
+  return hi2c->State;
+}
+
+__weak void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  UNUSED(hi2c);
+}
+
+__weak void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  UNUSED(hi2c);
+}
+
+/* ============================================================================
+ * Harness API
+ * ============================================================================ */
+
+void FEB_Host_I2C_InitHandle(I2C_HandleTypeDef *hi2c, uint32_t clock_hz)
+{
+  hi2c->Init.ClockSpeed = (clock_hz != 0U) ? clock_hz : 400000U;
+  hi2c->State = HAL_I2C_STATE_READY;
+  hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  if (bus != NULL)
+  {
+    memset(&bus->stats, 0, sizeof(bus->stats));
+    bus->pending = HOST_I2C_XFER_NONE;
+  }
+  pthread_mutex_unlock(&host_i2c_lock);
+}
+
+bool FEB_Host_I2C_Attach(I2C_HandleTypeDef *hi2c, FEB_Host_I2C_Device_t *dev)
+{
+  bool ok = false;
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  for (int i = 0; bus != NULL && i < FEB_HOST_I2C_MAX_DEVICES; i++)
+  {
+    if (bus->devs[i] == NULL)
+    {
+      bus->devs[i] = dev;
+      ok = true;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&host_i2c_lock);
+  return ok;
+}
+
+void FEB_Host_I2C_Detach(I2C_HandleTypeDef *hi2c, FEB_Host_I2C_Device_t *dev)
+{
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  for (int i = 0; bus != NULL && i < FEB_HOST_I2C_MAX_DEVICES; i++)
+  {
+    if (bus->devs[i] == dev)
+    {
+      bus->devs[i] = NULL;
+    }
+  }
+  pthread_mutex_unlock(&host_i2c_lock);
+}
+
+bool FEB_Host_I2C_Service(I2C_HandleTypeDef *hi2c)
+{
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  if (bus == NULL || bus->pending == HOST_I2C_XFER_NONE)
+  {
+    pthread_mutex_unlock(&host_i2c_lock);
+    return false;
+  }
+
+  host_i2c_xfer_t dir = bus->pending;
+  bool ok = host_i2c_execute(bus, dir, bus->pend_addr, bus->pend_reg, bus->pend_buf, bus->pend_len);
+  uint16_t len = bus->pend_len;
+  bus->pending = HOST_I2C_XFER_NONE;
+  pthread_mutex_unlock(&host_i2c_lock);
+
+  FEB_Host_Time_AdvanceNs(FEB_Host_I2C_TransferNs(hi2c, dir == HOST_I2C_XFER_READ, len));
+
+  FEB_Host_ISR_Enter();
+  hi2c->XferCount = 0;
+  hi2c->State = HAL_I2C_STATE_READY;
+  if (!ok)
+  {
+    hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+    HAL_I2C_ErrorCallback(hi2c);
+  }
+  else if (dir == HOST_I2C_XFER_READ)
+  {
+    HAL_I2C_MemRxCpltCallback(hi2c);
+  }
+  else
+  {
+    HAL_I2C_MemTxCpltCallback(hi2c);
+  }
+  FEB_Host_ISR_Exit();
+  return true;
+}
+
+uint64_t FEB_Host_I2C_TransferNs(const I2C_HandleTypeDef *hi2c, bool read, uint16_t len)
+{
+  uint32_t hz = (hi2c->Init.ClockSpeed != 0U) ? hi2c->Init.ClockSpeed : 400000U;
+  /* S + addr(9) + reg(9) [+ Sr + addr(9)] + len*9 + P */
+  uint64_t clocks = 1U + 9U + 9U + (read ? 10U : 0U) + 9ULL * len + 1U;
+  return (clocks * 1000000000ULL) / hz;
+}
+
+void FEB_Host_I2C_GetStats(const I2C_HandleTypeDef *hi2c, FEB_Host_I2C_Stats_t *stats)
+{
+  pthread_mutex_lock(&host_i2c_lock);
+  host_i2c_bus_t *bus = host_i2c_get(hi2c);
+  if (bus != NULL)
+  {
+    *stats = bus->stats;
+  }
+  else
+  {
+    memset(stats, 0, sizeof(*stats));
+  }
+  pthread_mutex_unlock(&host_i2c_lock);
+}
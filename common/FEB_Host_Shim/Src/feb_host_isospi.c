@@ -0,0 +1,323 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host_isospi.c
+ * @brief          : FEB Host Shim - simulated ADBMS68xx isoSPI daisy chain
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * The chain is one FEB_Host_SPI_Target_t. A frame runs from the CS falling
+ * edge to the rising edge:
+ *
+ *   CMD[2] PEC15[2]                          action (executed on the 4th byte)
+ *   CMD[2] PEC15[2] -> N x (D[6] CC|PEC10)   read, IC 0 first
+ *   CMD[2] PEC15[2] <- N x (D[6] PEC10)      write, first payload -> IC N-1
+ *
+ * A command with a bad PEC15 is ignored for the rest of the frame (MISO
+ * stays high), as the silicon does. Reply PEC10 folds in the 6-bit command
+ * counter; write PEC10 does not. Both CRCs are computed bit-serially here
+ * rather than sharing the firmware's table code, so a table or fold error
+ * in the firmware shows up as a mismatch instead of cancelling out.
+ *
+ * Wake-up pulses (CS low/high with no clocks) are accepted and ignored;
+ * the simulated chain never sleeps.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_host.h"
+
+#include <string.h>
+
+/* ============================================================================
+ * CRCs
+ * ============================================================================ */
+
+/* x^15 + x^14 + x^10 + x^8 + x^7 + x^4 + x^3 + 1, seed 0x0010, LSB 0. */
+static uint16_t isospi_pec15(const uint8_t *data, uint8_t len)
+{
+  uint16_t rem = 0x0010U;
+  for (uint8_t i = 0; i < len; i++)
+  {
+    for (int bit = 7; bit >= 0; bit--)
+    {
+      uint16_t in = (uint16_t)(((data[i] >> bit) & 1U) ^ ((rem >> 14) & 1U));
+      rem = (uint16_t)((rem << 1) & 0x7FFFU);
+      if (in != 0U)
+      {
+        rem ^= 0x4599U;
+      }
+    }
+  }
+  return (uint16_t)(rem << 1);
+}
+
+static uint16_t isospi_crc10_bits(uint16_t rem, uint32_t bits, int count)
+{
+  for (int bit = count - 1; bit >= 0; bit--)
+  {
+    uint16_t in = (uint16_t)(((bits >> bit) & 1U) ^ ((rem >> 9) & 1U));
+    rem = (uint16_t)((rem << 1) & 0x3FFU);
+    if (in != 0U)
+    {
+      rem ^= 0x08FU;
+    }
+  }
+  return rem;
+}
+
+/* x^10 + x^7 + x^3 + x^2 + x + 1, seed 0x0010, over D[6] then the 6-bit CC field. */
+static uint16_t isospi_pec10(const uint8_t data[6], uint8_t cc)
+{
+  uint16_t rem = 0x0010U;
+  for (int i = 0; i < 6; i++)
+  {
+    rem = isospi_crc10_bits(rem, data[i], 8);
+  }
+  return isospi_crc10_bits(rem, cc & 0x3FU, 6);
+}
+
+/* ============================================================================
+ * Chain Model
+ * ============================================================================ */
+
+static uint32_t isospi_rand(FEB_Host_IsoSPI_Chain_t *chain)
+{
+  chain->rng = chain->rng * 1664525U + 1013904223U;
+  return chain->rng >> 8;
+}
+
+static int isospi_find_group(const FEB_Host_IsoSPI_Chain_t *chain, uint16_t cmd, bool write)
+{
+  for (int g = 0; g < chain->num_groups; g++)
+  {
+    if ((write ? chain->wr_cmd[g] : chain->rd_cmd[g]) == cmd)
+    {
+      return g;
+    }
+  }
+  return -1;
+}
+
+static uint16_t isospi_frame_len(const FEB_Host_IsoSPI_Chain_t *chain)
+{
+  return (uint16_t)(4U + 8U * chain->num_ics);
+}
+
+static void isospi_maybe_corrupt(FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint8_t *reply)
+{
+  bool hit = false;
+  if (chain->corrupt_next[ic] > 0U)
+  {
+    chain->corrupt_next[ic]--;
+    hit = true;
+  }
+  else if (chain->error_ppm != 0U && (isospi_rand(chain) % 1000000U) < chain->error_ppm)
+  {
+    hit = true;
+  }
+
+  if (hit)
+  {
+    uint32_t bit = isospi_rand(chain) % 64U;
+    reply[bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+    chain->stats.corrupted++;
+  }
+}
+
+/** Fourth byte in: check the command and stage the reply or payload. */
+static void isospi_command(FEB_Host_IsoSPI_Chain_t *chain)
+{
+  uint16_t pec = isospi_pec15(chain->frame, 2);
+  if (chain->frame[2] != (uint8_t)(pec >> 8) || chain->frame[3] != (uint8_t)pec)
+  {
+    chain->stats.bad_cmd_pec++;
+    return;
+  }
+
+  chain->cmd_ok = true;
+  chain->stats.commands++;
+  uint16_t cmd = (uint16_t)((((uint16_t)chain->frame[0] << 8) | chain->frame[1]) & 0x07FFU);
+
+  int g = isospi_find_group(chain, cmd, false);
+  if (g >= 0)
+  {
+    uint8_t *out = &chain->frame[4];
+    for (uint8_t ic = 0; ic < chain->num_ics; ic++, out += 8)
+    {
+      memcpy(out, chain->regs[ic][g], 6);
+      uint16_t p10 = isospi_pec10(out, chain->cc[ic]);
+      out[6] = (uint8_t)((chain->cc[ic] << 2) | ((p10 >> 8) & 0x03U));
+      out[7] = (uint8_t)p10;
+      isospi_maybe_corrupt(chain, ic, out);
+    }
+    chain->stats.reads++;
+    chain->group = (int8_t)g;
+    return;
+  }
+
+  g = isospi_find_group(chain, cmd, true);
+  if (g >= 0)
+  {
+    chain->is_write = true;
+    chain->group = (int8_t)g;
+    return;
+  }
+
+  /* Action (conversion, clear, mute, ...). */
+  chain->stats.actions++;
+  for (uint8_t ic = 0; ic < chain->num_ics; ic++)
+  {
+    chain->cc[ic] = (uint8_t)((chain->cc[ic] + 1U) & 0x3FU);
+  }
+}
+
+/** CS rising edge: commit a complete write frame. */
+static void isospi_end_frame(FEB_Host_IsoSPI_Chain_t *chain)
+{
+  if (!chain->cmd_ok || !chain->is_write || chain->pos < isospi_frame_len(chain))
+  {
+    return;
+  }
+
+  const uint8_t *in = &chain->frame[4];
+  for (uint8_t k = 0; k < chain->num_ics; k++, in += 8)
+  {
+    uint8_t ic = (uint8_t)(chain->num_ics - 1U - k);
+    uint16_t p10 = isospi_pec10(in, 0);
+    uint16_t rx = (uint16_t)(((uint16_t)(in[6] & 0x03U) << 8) | in[7]);
+    if (p10 != rx)
+    {
+      chain->stats.bad_data_pec++;
+      continue;
+    }
+    memcpy(chain->regs[ic][chain->group], in, 6);
+    chain->cc[ic] = (uint8_t)((chain->cc[ic] + 1U) & 0x3FU);
+  }
+  chain->stats.writes++;
+}
+
+static void isospi_select(FEB_Host_SPI_Target_t *target, bool selected)
+{
+  FEB_Host_IsoSPI_Chain_t *chain = (FEB_Host_IsoSPI_Chain_t *)target->user;
+  if (selected)
+  {
+    chain->pos = 0;
+    chain->group = -1;
+    chain->is_write = false;
+    chain->cmd_ok = false;
+  }
+  else if (chain->selected)
+  {
+    isospi_end_frame(chain);
+  }
+  chain->selected = selected;
+}
+
+static uint8_t isospi_exchange(FEB_Host_SPI_Target_t *target, uint8_t mosi)
+{
+  FEB_Host_IsoSPI_Chain_t *chain = (FEB_Host_IsoSPI_Chain_t *)target->user;
+  uint16_t pos = chain->pos;
+  uint8_t miso = 0xFFU;
+
+  if (pos < 4U)
+  {
+    chain->frame[pos] = mosi;
+    if (pos == 3U)
+    {
+      isospi_command(chain);
+    }
+  }
+  else if (pos < isospi_frame_len(chain) && chain->group >= 0)
+  {
+    if (chain->is_write)
+    {
+      chain->frame[pos] = mosi;
+    }
+    else
+    {
+      miso = chain->frame[pos];
+    }
+  }
+
+  if (pos < 0xFFFFU)
+  {
+    chain->pos = (uint16_t)(pos + 1U);
+  }
+  return miso;
+}
+
+/* ============================================================================
+ * Harness API
+ * ============================================================================ */
+
+void FEB_Host_IsoSPI_Init(FEB_Host_IsoSPI_Chain_t *chain, uint8_t num_ics, GPIO_TypeDef *cs_port, uint16_t cs_pin)
+{
+  memset(chain, 0, sizeof(*chain));
+  chain->num_ics = (num_ics > FEB_HOST_ISOSPI_MAX_ICS) ? FEB_HOST_ISOSPI_MAX_ICS : num_ics;
+  chain->group = -1;
+  chain->rng = 1U;
+  chain->target.cs_port = cs_port;
+  chain->target.cs_pin = cs_pin;
+  chain->target.select = isospi_select;
+  chain->target.exchange = isospi_exchange;
+  chain->target.user = chain;
+}
+
+bool FEB_Host_IsoSPI_AddGroup(FEB_Host_IsoSPI_Chain_t *chain, uint16_t rd_cmd, uint16_t wr_cmd)
+{
+  if (chain->num_groups >= FEB_HOST_ISOSPI_MAX_GROUPS)
+  {
+    return false;
+  }
+  chain->rd_cmd[chain->num_groups] = rd_cmd;
+  chain->wr_cmd[chain->num_groups] = wr_cmd;
+  chain->num_groups++;
+  return true;
+}
+
+bool FEB_Host_IsoSPI_SetGroup(FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint16_t rd_cmd, const uint8_t data[6])
+{
+  int g = isospi_find_group(chain, rd_cmd, false);
+  if (g < 0 || ic >= chain->num_ics)
+  {
+    return false;
+  }
+  memcpy(chain->regs[ic][g], data, 6);
+  return true;
+}
+
+bool FEB_Host_IsoSPI_GetGroup(const FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint16_t rd_cmd, uint8_t data[6])
+{
+  int g = isospi_find_group(chain, rd_cmd, false);
+  if (g < 0 || ic >= chain->num_ics)
+  {
+    return false;
+  }
+  memcpy(data, chain->regs[ic][g], 6);
+  return true;
+}
+
+uint8_t FEB_Host_IsoSPI_GetCC(const FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic)
+{
+  return (ic < chain->num_ics) ? chain->cc[ic] : 0U;
+}
+
+void FEB_Host_IsoSPI_CorruptNext(FEB_Host_IsoSPI_Chain_t *chain, uint8_t ic, uint32_t count)
+{
+  if (ic < chain->num_ics)
+  {
+    chain->corrupt_next[ic] = count;
+  }
+}
+
+void FEB_Host_IsoSPI_SetErrorRate(FEB_Host_IsoSPI_Chain_t *chain, uint32_t ppm, uint32_t seed)
+{
+  chain->error_ppm = ppm;
+  chain->rng = (seed != 0U) ? seed : 1U;
+}
+
+void FEB_Host_IsoSPI_GetStats(const FEB_Host_IsoSPI_Chain_t *chain, FEB_Host_IsoSPI_Stats_t *stats)
+{
+  *stats = chain->stats;
+}
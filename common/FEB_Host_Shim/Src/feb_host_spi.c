@@ -0,0 +1,402 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host_spi.c
+ * @brief          : FEB Host Shim - simulated SPI master with CS-selected targets
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Each handle owns a small table of attached FEB_Host_SPI_Target_t targets.
+ * A GPIO write hook watches every target's CS pin and forwards the edges,
+ * so framing follows whatever the driver does with HAL_GPIO_WritePin, exactly
+ * as it would on the wire.
+ *
+ * Bus time is 8 SCK periods per byte at the rate given to InitHandle.
+ * Blocking calls advance virtual time by that amount; TransmitReceive_DMA
+ * returns immediately and charges it on FEB_Host_SPI_Service.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_host.h"
+#include "main.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/* ============================================================================
+ * Simulated State
+ * ============================================================================ */
+
+#define HOST_SPI_MAX_BUSES 4
+
+SPI_TypeDef feb_host_spi1;
+SPI_TypeDef feb_host_spi2;
+
+typedef struct
+{
+  SPI_HandleTypeDef *hspi;
+  uint32_t bit_rate_hz;
+  FEB_Host_SPI_Target_t *targets[FEB_HOST_SPI_MAX_TARGETS];
+  FEB_Host_SPI_Stats_t stats;
+  uint32_t fail_next_dma;
+
+  /* In-flight DMA transfer */
+  bool pending;
+  const uint8_t *pend_tx;
+  uint8_t *pend_rx;
+  uint16_t pend_len;
+} host_spi_bus_t;
+
+static host_spi_bus_t host_spi[HOST_SPI_MAX_BUSES];
+static pthread_mutex_t host_spi_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t host_spi_hook_once = PTHREAD_ONCE_INIT;
+
+static host_spi_bus_t *host_spi_get(const SPI_HandleTypeDef *hspi)
+{
+  host_spi_bus_t *free_slot = NULL;
+  for (int i = 0; i < HOST_SPI_MAX_BUSES; i++)
+  {
+    if (host_spi[i].hspi == hspi)
+    {
+      return &host_spi[i];
+    }
+    if (free_slot == NULL && host_spi[i].hspi == NULL)
+    {
+      free_slot = &host_spi[i];
+    }
+  }
+  if (free_slot != NULL)
+  {
+    free_slot->hspi = (SPI_HandleTypeDef *)hspi;
+  }
+  return free_slot;
+}
+
+static bool host_spi_selected(const FEB_Host_SPI_Target_t *t)
+{
+  return (t->cs_port != NULL) && ((t->cs_port->ODR & t->cs_pin) == 0U);
+}
+
+/** GPIO write hook: forward CS edges to the targets that own the pin. */
+static void host_spi_cs_hook(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state, void *user)
+{
+  (void)user;
+  pthread_mutex_lock(&host_spi_lock);
+  for (int b = 0; b < HOST_SPI_MAX_BUSES; b++)
+  {
+    for (int i = 0; i < FEB_HOST_SPI_MAX_TARGETS; i++)
+    {
+      FEB_Host_SPI_Target_t *t = host_spi[b].targets[i];
+      if (t != NULL && t->cs_port == port && t->cs_pin == pin && t->select != NULL)
+      {
+        t->select(t, state == GPIO_PIN_RESET);
+      }
+    }
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+}
+
+static void host_spi_install_hook(void)
+{
+  (void)FEB_Host_GPIO_AddWriteHook(host_spi_cs_hook, NULL);
+}
+
+/**
+ * Clock len bytes through every selected target. Caller holds host_spi_lock.
+ * tx may be NULL (send 0xFF), rx may be NULL (discard).
+ */
+static void host_spi_execute(host_spi_bus_t *bus, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  for (uint16_t n = 0; n < len; n++)
+  {
+    uint8_t mosi = (tx != NULL) ? tx[n] : 0xFFU;
+    uint8_t miso = 0xFFU;
+    for (int i = 0; i < FEB_HOST_SPI_MAX_TARGETS; i++)
+    {
+      FEB_Host_SPI_Target_t *t = bus->targets[i];
+      if (t != NULL && host_spi_selected(t))
+      {
+        miso &= t->exchange(t, mosi);
+      }
+    }
+    if (rx != NULL)
+    {
+      rx[n] = miso;
+    }
+  }
+  bus->stats.transfers++;
+  bus->stats.bytes += len;
+  bus->stats.bus_ns += FEB_Host_SPI_TransferNs(bus->hspi, len);
+}
+
+static HAL_StatusTypeDef host_spi_blocking(SPI_HandleTypeDef *hspi, const uint8_t *tx, uint8_t *rx, uint16_t len)
+{
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+  if (len == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus != NULL)
+  {
+    host_spi_execute(bus, tx, rx, len);
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+
+  FEB_Host_Time_AdvanceNs(FEB_Host_SPI_TransferNs(hspi, len));
+
+  hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+  return (bus != NULL) ? HAL_OK : HAL_ERROR;
+}
+
+/* ============================================================================
+ * HAL API
+ * ============================================================================ */
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, const uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  (void)Timeout;
+  return host_spi_blocking(hspi, pData, NULL, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  (void)Timeout;
+  return host_spi_blocking(hspi, NULL, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+                                          uint16_t Size, uint32_t Timeout)
+{
+  (void)Timeout;
+  return host_spi_blocking(hspi, pTxData, pRxData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pTxData, uint8_t *pRxData,
+                                              uint16_t Size)
+{
+  if (hspi->State != HAL_SPI_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+  if (pTxData == NULL || pRxData == NULL || Size == 0U)
+  {
+    return HAL_ERROR;
+  }
+
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus == NULL)
+  {
+    pthread_mutex_unlock(&host_spi_lock);
+    return HAL_ERROR;
+  }
+  bus->pending = true;
+  bus->pend_tx = pTxData;
+  bus->pend_rx = pRxData;
+  bus->pend_len = Size;
+  pthread_mutex_unlock(&host_spi_lock);
+
+  hspi->pTxBuffPtr = pTxData;
+  hspi->TxXferSize = Size;
+  hspi->TxXferCount = Size;
+  hspi->pRxBuffPtr = pRxData;
+  hspi->RxXferSize = Size;
+  hspi->RxXferCount = Size;
+  hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+  hspi->State = HAL_SPI_STATE_BUSY_TX_RX;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef *hspi)
+{
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus != NULL && bus->pending)
+  {
+    bus->pending = false;
+    bus->stats.aborts++;
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+
+  hspi->TxXferCount = 0;
+  hspi->RxXferCount = 0;
+  hspi->State = HAL_SPI_STATE_READY;
+  return HAL_OK;
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(const SPI_HandleTypeDef *hspi)
+{
+  return hspi->State;
+}
+
+uint32_t HAL_SPI_GetError(const SPI_HandleTypeDef *hspi)
+{
+  return hspi->ErrorCode;
+}
+
+__weak void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+  UNUSED(hspi);
+}
+
+__weak void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+  UNUSED(hspi);
+}
+
+/* ============================================================================
+ * Harness API
+ * ============================================================================ */
+
+void FEB_Host_SPI_InitHandle(SPI_HandleTypeDef *hspi, SPI_TypeDef *instance, uint32_t bit_rate_hz)
+{
+  pthread_once(&host_spi_hook_once, host_spi_install_hook);
+
+  hspi->Instance = instance;
+  hspi->Init.Mode = SPI_MODE_MASTER;
+  hspi->State = HAL_SPI_STATE_READY;
+  hspi->ErrorCode = HAL_SPI_ERROR_NONE;
+
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus != NULL)
+  {
+    bus->bit_rate_hz = (bit_rate_hz != 0U) ? bit_rate_hz : 1000000U;
+    memset(&bus->stats, 0, sizeof(bus->stats));
+    bus->fail_next_dma = 0;
+    bus->pending = false;
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+}
+
+bool FEB_Host_SPI_Attach(SPI_HandleTypeDef *hspi, FEB_Host_SPI_Target_t *target)
+{
+  bool ok = false;
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  for (int i = 0; bus != NULL && i < FEB_HOST_SPI_MAX_TARGETS; i++)
+  {
+    if (bus->targets[i] == NULL)
+    {
+      bus->targets[i] = target;
+      ok = true;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+  return ok;
+}
+
+void FEB_Host_SPI_Detach(SPI_HandleTypeDef *hspi, FEB_Host_SPI_Target_t *target)
+{
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  for (int i = 0; bus != NULL && i < FEB_HOST_SPI_MAX_TARGETS; i++)
+  {
+    if (bus->targets[i] == target)
+    {
+      bus->targets[i] = NULL;
+    }
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+}
+
+bool FEB_Host_SPI_Service(SPI_HandleTypeDef *hspi)
+{
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus == NULL || !bus->pending)
+  {
+    pthread_mutex_unlock(&host_spi_lock);
+    return false;
+  }
+
+  uint16_t len = bus->pend_len;
+  bool fail = (bus->fail_next_dma > 0U);
+  if (fail)
+  {
+    bus->fail_next_dma--;
+    bus->stats.dma_failed++;
+  }
+  else
+  {
+    host_spi_execute(bus, bus->pend_tx, bus->pend_rx, len);
+    bus->stats.dma_transfers++;
+  }
+  bus->pending = false;
+  pthread_mutex_unlock(&host_spi_lock);
+
+  FEB_Host_Time_AdvanceNs(FEB_Host_SPI_TransferNs(hspi, len));
+
+  FEB_Host_ISR_Enter();
+  hspi->TxXferCount = 0;
+  hspi->RxXferCount = 0;
+  hspi->State = HAL_SPI_STATE_READY;
+  if (fail)
+  {
+    hspi->ErrorCode = HAL_SPI_ERROR_DMA;
+    HAL_SPI_ErrorCallback(hspi);
+  }
+  else
+  {
+    HAL_SPI_TxRxCpltCallback(hspi);
+  }
+  FEB_Host_ISR_Exit();
+  return true;
+}
+
+bool FEB_Host_SPI_Busy(const SPI_HandleTypeDef *hspi)
+{
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  bool busy = (bus != NULL) && bus->pending;
+  pthread_mutex_unlock(&host_spi_lock);
+  return busy;
+}
+
+void FEB_Host_SPI_FailNextDma(SPI_HandleTypeDef *hspi, uint32_t count)
+{
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus != NULL)
+  {
+    bus->fail_next_dma = count;
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+}
+
+uint64_t FEB_Host_SPI_TransferNs(const SPI_HandleTypeDef *hspi, uint16_t len)
+{
+  uint32_t hz = 1000000U;
+  for (int i = 0; i < HOST_SPI_MAX_BUSES; i++)
+  {
+    if (host_spi[i].hspi == hspi && host_spi[i].bit_rate_hz != 0U)
+    {
+      hz = host_spi[i].bit_rate_hz;
+      break;
+    }
+  }
+  return (8ULL * len * 1000000000ULL) / hz;
+}
+
+void FEB_Host_SPI_GetStats(const SPI_HandleTypeDef *hspi, FEB_Host_SPI_Stats_t *stats)
+{
+  pthread_mutex_lock(&host_spi_lock);
+  host_spi_bus_t *bus = host_spi_get(hspi);
+  if (bus != NULL)
+  {
+    *stats = bus->stats;
+  }
+  else
+  {
+    memset(stats, 0, sizeof(*stats));
+  }
+  pthread_mutex_unlock(&host_spi_lock);
+}
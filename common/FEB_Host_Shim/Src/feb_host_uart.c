@@ -0,0 +1,443 @@
+/**
+ ******************************************************************************
+ * @file           : feb_host_uart.c
+ * @brief          : FEB Host Shim - simulated USART + DMA streams
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * TX: HAL_UART_Transmit hands bytes straight to the sink. HAL_UART_Transmit_DMA
+ * latches the buffer and completes on FEB_Host_UART_Service, so a harness can
+ * observe the window in which the driver's ring keeps filling behind an
+ * in-flight DMA.
+ *
+ * RX: ReceiveToIdle DMA. FEB_Host_UART_Receive writes at the DMA position
+ * (RxXferSize - NDTR) and counts NDTR down; FEB_Host_UART_Idle raises SR.IDLE
+ * and runs the USART IRQ the way the boards wire it in stm32f4xx_it.c.
+ *
+ * In virtual time, TX bytes advance the clock by 10 bit times at the
+ * configured baud rate.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_host.h"
+#include "main.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/* ============================================================================
+ * Board Glue (weak references - resolved when feb_uart is linked)
+ * ============================================================================ */
+
+extern void FEB_UART_TxCpltCallback(UART_HandleTypeDef *huart) __attribute__((weak));
+extern void FEB_UART_RxEventCallback(UART_HandleTypeDef *huart, uint16_t size) __attribute__((weak));
+extern void FEB_UART_IDLE_Callback(UART_HandleTypeDef *huart) __attribute__((weak));
+
+/* ============================================================================
+ * Simulated State
+ * ============================================================================ */
+
+typedef struct
+{
+  UART_HandleTypeDef *huart;
+  FEB_Host_UART_Sink_t sink;
+  void *sink_user;
+  FEB_Host_UART_Stats_t stats;
+} host_uart_t;
+
+static host_uart_t host_uart[FEB_HOST_UART_MAX_HANDLES];
+static pthread_mutex_t host_uart_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static host_uart_t *host_uart_get(const UART_HandleTypeDef *huart)
+{
+  host_uart_t *free_slot = NULL;
+  pthread_mutex_lock(&host_uart_lock);
+  for (int i = 0; i < FEB_HOST_UART_MAX_HANDLES; i++)
+  {
+    if (host_uart[i].huart == huart)
+    {
+      pthread_mutex_unlock(&host_uart_lock);
+      return &host_uart[i];
+    }
+    if (free_slot == NULL && host_uart[i].huart == NULL)
+    {
+      free_slot = &host_uart[i];
+    }
+  }
+  if (free_slot != NULL)
+  {
+    free_slot->huart = (UART_HandleTypeDef *)huart;
+  }
+  pthread_mutex_unlock(&host_uart_lock);
+  return free_slot;
+}
+
+static void host_uart_emit(UART_HandleTypeDef *huart, const uint8_t *data, size_t len)
+{
+  host_uart_t *sim = host_uart_get(huart);
+  if (sim != NULL)
+  {
+    sim->stats.tx_bytes += (uint32_t)len;
+    if (sim->sink != NULL)
+    {
+      sim->sink(huart, data, len, sim->sink_user);
+    }
+  }
+
+  if (huart->Init.BaudRate != 0U)
+  {
+    FEB_Host_Time_AdvanceNs(((uint64_t)len * 10ULL * 1000000000ULL) / huart->Init.BaudRate);
+  }
+}
+
+static void host_uart_rx_event_isr(UART_HandleTypeDef *huart, uint16_t size)
+{
+  host_uart_t *sim = host_uart_get(huart);
+  if (sim != NULL)
+  {
+    sim->stats.rx_events++;
+  }
+  HAL_UARTEx_RxEventCallback(huart, size);
+}
+
+/* ============================================================================
+ * HAL API
+ * ============================================================================ */
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size,
+                                    uint32_t Timeout)
+{
+  (void)Timeout;
+
+  if (pData == NULL || Size == 0U)
+  {
+    return HAL_ERROR;
+  }
+  if (huart->gState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  huart->gState = HAL_UART_STATE_BUSY_TX;
+  host_uart_emit(huart, pData, Size);
+  host_uart_t *sim = host_uart_get(huart);
+  if (sim != NULL)
+  {
+    sim->stats.tx_blocking++;
+  }
+  huart->gState = HAL_UART_STATE_READY;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+  if (pData == NULL || Size == 0U || huart->hdmatx == NULL)
+  {
+    return HAL_ERROR;
+  }
+  if (huart->gState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  huart->pTxBuffPtr = pData;
+  huart->TxXferSize = Size;
+  huart->TxXferCount = Size;
+  huart->hdmatx->Instance->NDTR = Size;
+  huart->gState = HAL_UART_STATE_BUSY_TX;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UARTEx_ReceiveToIdle_DMA(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  if (pData == NULL || Size == 0U || huart->hdmarx == NULL)
+  {
+    return HAL_ERROR;
+  }
+  if (huart->RxState != HAL_UART_STATE_READY)
+  {
+    return HAL_BUSY;
+  }
+
+  huart->ReceptionType = HAL_UART_RECEPTION_TOIDLE;
+  huart->pRxBuffPtr = pData;
+  huart->RxXferSize = Size;
+  huart->hdmarx->Instance->NDTR = Size;
+  huart->hdmarx->Instance->CR |= DMA_IT_TC | DMA_IT_HT;
+  huart->hdmarx->State = HAL_DMA_STATE_BUSY;
+  huart->RxState = HAL_UART_STATE_BUSY_RX;
+
+  /* HAL clears a stale IDLE and enables IDLEIE for to-idle reception */
+  __HAL_UART_CLEAR_IDLEFLAG(huart);
+  __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef *huart)
+{
+  __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
+  if (huart->hdmatx != NULL)
+  {
+    huart->hdmatx->Instance->NDTR = 0;
+    huart->hdmatx->State = HAL_DMA_STATE_READY;
+  }
+  if (huart->hdmarx != NULL)
+  {
+    huart->hdmarx->Instance->NDTR = 0;
+    huart->hdmarx->State = HAL_DMA_STATE_READY;
+  }
+  huart->TxXferCount = 0;
+  huart->RxXferCount = 0;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+  huart->gState = HAL_UART_STATE_READY;
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_DMAStop(UART_HandleTypeDef *huart)
+{
+  if (huart->gState == HAL_UART_STATE_BUSY_TX && huart->hdmatx != NULL)
+  {
+    huart->hdmatx->Instance->NDTR = 0;
+    huart->hdmatx->State = HAL_DMA_STATE_READY;
+    huart->gState = HAL_UART_STATE_READY;
+  }
+  if (huart->RxState == HAL_UART_STATE_BUSY_RX && huart->hdmarx != NULL)
+  {
+    huart->hdmarx->Instance->NDTR = 0;
+    huart->hdmarx->State = HAL_DMA_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+  }
+  return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+  /* Only the to-idle path is modelled: anything else the real handler does
+   * (RXNE/TXE byte-by-byte transfers, PE/FE/NE errors) is unused by feb_uart. */
+  if (huart->ReceptionType != HAL_UART_RECEPTION_TOIDLE || huart->RxState != HAL_UART_STATE_BUSY_RX)
+  {
+    return;
+  }
+  if ((huart->Instance->SR & USART_SR_IDLE) == 0U || (huart->Instance->CR1 & USART_CR1_IDLEIE) == 0U)
+  {
+    return;
+  }
+
+  __HAL_UART_CLEAR_IDLEFLAG(huart);
+
+  uint16_t nb_remaining = (uint16_t)__HAL_DMA_GET_COUNTER(huart->hdmarx);
+  if (nb_remaining == 0U || nb_remaining >= huart->RxXferSize)
+  {
+    return;
+  }
+
+  if (huart->hdmarx->Init.Mode != DMA_CIRCULAR)
+  {
+    huart->RxState = HAL_UART_STATE_READY;
+    huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+    __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
+    huart->hdmarx->State = HAL_DMA_STATE_READY;
+  }
+
+  host_uart_rx_event_isr(huart, (uint16_t)(huart->RxXferSize - nb_remaining));
+}
+
+/* ============================================================================
+ * Weak HAL Callbacks - default to the board wiring
+ * ============================================================================ */
+
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (FEB_UART_TxCpltCallback != NULL)
+  {
+    FEB_UART_TxCpltCallback(huart);
+  }
+}
+
+__weak void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+  if (FEB_UART_RxEventCallback != NULL)
+  {
+    FEB_UART_RxEventCallback(huart, Size);
+  }
+}
+
+__weak void FEB_Host_UART_IRQHandler(UART_HandleTypeDef *huart)
+{
+  if (FEB_UART_IDLE_Callback != NULL)
+  {
+    FEB_UART_IDLE_Callback(huart);
+  }
+  HAL_UART_IRQHandler(huart);
+}
+
+/* ============================================================================
+ * Harness API
+ * ============================================================================ */
+
+void FEB_Host_UART_InitHandle(UART_HandleTypeDef *huart, USART_TypeDef *instance, DMA_HandleTypeDef *hdma_tx,
+                              DMA_Stream_TypeDef *tx_stream, DMA_HandleTypeDef *hdma_rx,
+                              DMA_Stream_TypeDef *rx_stream, uint32_t hdma_rx_mode, uint32_t baud)
+{
+  memset(instance, 0, sizeof(*instance));
+  instance->SR = USART_SR_TXE | USART_SR_TC;
+
+  huart->Instance = instance;
+  huart->Init.BaudRate = baud;
+  huart->gState = HAL_UART_STATE_READY;
+  huart->RxState = HAL_UART_STATE_READY;
+  huart->ErrorCode = HAL_UART_ERROR_NONE;
+  huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+  huart->hdmatx = hdma_tx;
+  huart->hdmarx = hdma_rx;
+
+  if (hdma_tx != NULL)
+  {
+    memset(tx_stream, 0, sizeof(*tx_stream));
+    hdma_tx->Instance = tx_stream;
+    hdma_tx->Init.Mode = DMA_NORMAL;
+    hdma_tx->State = HAL_DMA_STATE_READY;
+    hdma_tx->Parent = huart;
+  }
+  if (hdma_rx != NULL)
+  {
+    memset(rx_stream, 0, sizeof(*rx_stream));
+    hdma_rx->Instance = rx_stream;
+    hdma_rx->Init.Mode = hdma_rx_mode;
+    hdma_rx->State = HAL_DMA_STATE_READY;
+    hdma_rx->Parent = huart;
+  }
+
+  host_uart_t *sim = host_uart_get(huart);
+  if (sim != NULL)
+  {
+    memset(&sim->stats, 0, sizeof(sim->stats));
+  }
+}
+
+void FEB_Host_UART_SetSink(UART_HandleTypeDef *huart, FEB_Host_UART_Sink_t sink, void *user)
+{
+  host_uart_t *sim = host_uart_get(huart);
+  if (sim != NULL)
+  {
+    sim->sink = sink;
+    sim->sink_user = user;
+  }
+}
+
+bool FEB_Host_UART_TxBusy(const UART_HandleTypeDef *huart)
+{
+  return huart->gState == HAL_UART_STATE_BUSY_TX;
+}
+
+uint32_t FEB_Host_UART_Service(UART_HandleTypeDef *huart, uint32_t max_transfers)
+{
+  uint32_t done = 0;
+
+  while (huart->gState == HAL_UART_STATE_BUSY_TX && (max_transfers == 0U || done < max_transfers))
+  {
+    host_uart_emit(huart, huart->pTxBuffPtr, huart->TxXferSize);
+    huart->TxXferCount = 0;
+    huart->hdmatx->Instance->NDTR = 0;
+    huart->gState = HAL_UART_STATE_READY;
+
+    host_uart_t *sim = host_uart_get(huart);
+    if (sim != NULL)
+    {
+      sim->stats.tx_dma_transfers++;
+    }
+    done++;
+
+    FEB_Host_ISR_Enter();
+    HAL_UART_TxCpltCallback(huart);
+    FEB_Host_ISR_Exit();
+  }
+
+  return done;
+}
+
+size_t FEB_Host_UART_Receive(UART_HandleTypeDef *huart, const uint8_t *data, size_t len)
+{
+  host_uart_t *sim = host_uart_get(huart);
+  size_t accepted = 0;
+
+  FEB_Host_ISR_Enter();
+  while (accepted < len)
+  {
+    if (huart->RxState != HAL_UART_STATE_BUSY_RX || huart->hdmarx == NULL)
+    {
+      if (sim != NULL)
+      {
+        sim->stats.rx_dropped += (uint32_t)(len - accepted);
+      }
+      break;
+    }
+
+    DMA_Stream_TypeDef *s = huart->hdmarx->Instance;
+    uint16_t pos = (uint16_t)(huart->RxXferSize - s->NDTR);
+    huart->pRxBuffPtr[pos] = data[accepted++];
+    s->NDTR--;
+    if (sim != NULL)
+    {
+      sim->stats.rx_bytes++;
+    }
+
+    /* Half-transfer: only reported if the driver left HT enabled */
+    if ((s->CR & DMA_IT_HT) != 0U && s->NDTR == (uint32_t)(huart->RxXferSize / 2U))
+    {
+      host_uart_rx_event_isr(huart, (uint16_t)(huart->RxXferSize / 2U));
+    }
+
+    if (s->NDTR == 0U)
+    {
+      if (huart->hdmarx->Init.Mode == DMA_CIRCULAR)
+      {
+        s->NDTR = huart->RxXferSize;
+      }
+      else
+      {
+        huart->RxState = HAL_UART_STATE_READY;
+        huart->ReceptionType = HAL_UART_RECEPTION_STANDARD;
+        __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
+        huart->hdmarx->State = HAL_DMA_STATE_READY;
+      }
+      host_uart_rx_event_isr(huart, huart->RxXferSize);
+    }
+  }
+  FEB_Host_ISR_Exit();
+
+  return accepted;
+}
+
+void FEB_Host_UART_Idle(UART_HandleTypeDef *huart)
+{
+  FEB_Host_ISR_Enter();
+  huart->Instance->SR |= USART_SR_IDLE;
+  FEB_Host_UART_IRQHandler(huart);
+  FEB_Host_ISR_Exit();
+}
+
+size_t FEB_Host_UART_ReceiveLine(UART_HandleTypeDef *huart, const char *text)
+{
+  size_t n = FEB_Host_UART_Receive(huart, (const uint8_t *)text, strlen(text));
+  FEB_Host_UART_Idle(huart);
+  return n;
+}
+
+void FEB_Host_UART_GetStats(const UART_HandleTypeDef *huart, FEB_Host_UART_Stats_t *stats)
+{
+  host_uart_t *sim = host_uart_get(huart);
+  if (sim != NULL)
+  {
+    *stats = sim->stats;
+  }
+  else
+  {
+    memset(stats, 0, sizeof(*stats));
+  }
+}
@@ -14,6 +14,8 @@
  *   - Module tagging for easy identification
  *   - File/line information for errors and warnings
  *   - Configurable output backend (UART, USB, RTT, etc.)
+ *   - Optional deferred mode (FEB_LOG_DEFERRED): call sites only record raw
+ *     arguments into a lock-free ring; FEB_Log_Process() formats them later
  *
  * Usage:
  *   // Initialize with output function
@@ -130,8 +132,23 @@ typedef void *FEB_Log_MutexHandle_t;
     /** @brief Mutex handle - REQUIRED in FreeRTOS mode. Create in CubeMX .ioc. */
     FEB_Log_MutexHandle_t mutex;
 #endif
+
+#if FEB_LOG_DEFERRED
+    bool deferred; /**< Start in deferred mode (drain with FEB_Log_Process) */
+#endif
   } FEB_Log_Config_t;
 
+  /**
+   * @brief Deferred-mode counters
+   */
+  typedef struct
+  {
+    uint32_t records;         /**< Messages recorded into the ring */
+    uint32_t dropped;         /**< Messages lost because the ring was full */
+    uint32_t high_water;      /**< Peak ring occupancy in bytes */
+    uint32_t ring_size;       /**< FEB_LOG_DEFERRED_RING_SIZE (0 if not built) */
+  } FEB_Log_DeferredStats_t;
+
   /* ============================================================================
    * Initialization API
    * ============================================================================ */
@@ -212,6 +229,45 @@ typedef void *FEB_Log_MutexHandle_t;
    */
   bool FEB_Log_GetTimestamps(void);
 
+  /* ============================================================================
+   * Deferred Mode API
+   * ============================================================================
+   *
+   * In deferred mode LOG_E..LOG_T (FEB_Log_Output) do no formatting and take
+   * no lock: they copy the tick, level, tag/format/file pointers and the raw
+   * arguments into a lock-free ring, which is safe from tasks and ISRs alike.
+   * FEB_Log_Process() later expands each record into exactly the text the
+   * immediate path would have produced, with the tick taken at the call site.
+   *
+   * Tag, format and file must be string literals (or otherwise outlive the
+   * record); %s arguments are copied, up to FEB_LOG_DEFERRED_STR_MAX bytes.
+   * FEB_Log_Raw / FEB_Log_Hexdump always write immediately.
+   */
+
+  /**
+   * @brief Switch deferred mode on or off at runtime
+   *
+   * Turning it off drains pending records first (when called from a task).
+   * No-op unless built with FEB_LOG_DEFERRED.
+   */
+  void FEB_Log_SetDeferred(bool enable);
+
+  /** @brief True if messages are currently being deferred */
+  bool FEB_Log_GetDeferred(void);
+
+  /**
+   * @brief Format and output every pending deferred record
+   *
+   * Call from one low-priority task or the main loop, never from an ISR.
+   * Reports ring overflows as a single "[LOG] N messages dropped" warning.
+   *
+   * @return Number of messages written (0 if not built with FEB_LOG_DEFERRED)
+   */
+  size_t FEB_Log_Process(void);
+
+  /** @brief Copy deferred-mode counters (all zero if not built) */
+  void FEB_Log_GetDeferredStats(FEB_Log_DeferredStats_t *stats);
+
   /* ============================================================================
    * Module Tags
    * ============================================================================
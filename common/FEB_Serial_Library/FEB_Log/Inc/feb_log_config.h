@@ -26,6 +26,37 @@ extern "C"
 
 #ifndef FEB_LOG_STAGING_BUFFER_SIZE
 #define FEB_LOG_STAGING_BUFFER_SIZE 512
+#endif
+
+  /* ============================================================================
+   * Deferred Logging
+   * ============================================================================
+   *
+   * FEB_LOG_DEFERRED = 1 builds the deferred backend: LOG_x calls record the
+   * format pointer, tag, level, tick and raw arguments into a lock-free ring
+   * and FEB_Log_Process() formats them later from a low-priority context.
+   * Needs LDREX/STREX (Cortex-M3 and up); leave at 0 on Cortex-M0 boards.
+   *
+   * RING_SIZE must be a power of two no larger than 32768.
+   * RECORD_ARGS_MAX caps the encoded argument bytes of one message; anything
+   * past it is dropped from the output with a "..." marker.
+   * STR_MAX caps the bytes copied per %s argument.
+   */
+
+#ifndef FEB_LOG_DEFERRED
+#define FEB_LOG_DEFERRED 0
+#endif
+
+#ifndef FEB_LOG_DEFERRED_RING_SIZE
+#define FEB_LOG_DEFERRED_RING_SIZE 4096
+#endif
+
+#ifndef FEB_LOG_DEFERRED_RECORD_ARGS_MAX
+#define FEB_LOG_DEFERRED_RECORD_ARGS_MAX 96
+#endif
+
+#ifndef FEB_LOG_DEFERRED_STR_MAX
+#define FEB_LOG_DEFERRED_STR_MAX 48
 #endif
 
   /* ============================================================================
@@ -11,6 +11,7 @@
  *   - Multiple severity levels with compile-time and runtime filtering
  *   - ANSI color codes and timestamps
  *   - Thread-safe output (via FreeRTOS mutex or critical sections)
+ *   - Deferred mode: lock-free record ring expanded by FEB_Log_Process()
  *
  ******************************************************************************
  */
@@ -18,8 +19,10 @@
 #include "feb_log.h"
 #include "feb_log_config.h"
 
-#include <stdio.h>
+#include <ctype.h>
 #include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
 #include <string.h>
 
 /* ============================================================================
@@ -119,6 +122,9 @@ static struct
   bool timestamps_enabled;
   bool initialized;
   FEB_Log_Mutex_t mutex;
+#if FEB_LOG_DEFERRED
+  bool deferred;
+#endif
 } log_ctx = {0};
 
 /* ============================================================================
@@ -172,6 +178,10 @@ int FEB_Log_Init(const FEB_Log_Config_t *config)
   log_ctx.mutex = 0;
 #endif
 
+#if FEB_LOG_DEFERRED
+  log_ctx.deferred = config->deferred;
+#endif
+
   log_ctx.initialized = true;
 
   return 0;
@@ -217,137 +227,110 @@ bool FEB_Log_GetTimestamps(void)
 }
 
 /* ============================================================================
- * Logging Functions
+ * Message Composition
  * ============================================================================ */
 
-void FEB_Log_Output(FEB_Log_Level_t level, const char *tag, const char *file, int line, const char *format, ...)
+/*
+ * Add snprintf result to offset and clamp to prevent overflow.
+ * snprintf returns the number of bytes that WOULD be written (excluding null),
+ * which can exceed remaining space. We must clamp after each call.
+ */
+static inline void log_offset_add(int *offset, int ret, size_t buf_size)
 {
-  if (!log_ctx.initialized || log_ctx.output == NULL)
+  if (ret > 0)
   {
-    return;
+    *offset += ret;
   }
-
-  /* Runtime level filter */
-  if (level > log_ctx.level || level == FEB_LOG_NONE)
+  if ((size_t)*offset >= buf_size)
   {
-    return;
+    *offset = (int)(buf_size - 1);
   }
+}
 
-  bool in_isr = FEB_LOG_IN_ISR();
-
-  /*
-   * Buffer selection: Use stack-local buffer for ISR context to avoid
-   * race conditions with staging_buffer. ISR buffer is smaller due to
-   * stack constraints.
-   */
-  char isr_buffer[128];
-  char *buf;
-  size_t buf_size;
-
-  if (in_isr)
+static const char *log_level_color(FEB_Log_Level_t level)
+{
+  switch (level)
   {
-    buf = isr_buffer;
-    buf_size = sizeof(isr_buffer);
+  case FEB_LOG_ERROR:
+    return FEB_LOG_COLOR_ERROR;
+  case FEB_LOG_WARN:
+    return FEB_LOG_COLOR_WARN;
+  case FEB_LOG_INFO:
+    return FEB_LOG_COLOR_INFO;
+  case FEB_LOG_DEBUG:
+    return FEB_LOG_COLOR_DEBUG;
+  case FEB_LOG_TRACE:
+    return FEB_LOG_COLOR_TRACE;
+  default:
+    return "";
   }
-  else
+}
+
+static const char *log_level_str(FEB_Log_Level_t level)
+{
+  switch (level)
   {
-    /* Acquire lock BEFORE formatting to protect staging_buffer */
-    FEB_LOG_MUTEX_LOCK(log_ctx.mutex);
-    buf = staging_buffer;
-    buf_size = sizeof(staging_buffer);
+  case FEB_LOG_ERROR:
+    return "E";
+  case FEB_LOG_WARN:
+    return "W";
+  case FEB_LOG_INFO:
+    return "I";
+  case FEB_LOG_DEBUG:
+    return "D";
+  case FEB_LOG_TRACE:
+    return "T";
+  default:
+    return "";
   }
+}
 
+/**
+ * @brief Write color, timestamp, level and tag; returns the new offset
+ */
+static int log_compose_prefix(char *buf, size_t buf_size, FEB_Log_Level_t level, const char *tag, bool has_tick,
+                              uint32_t tick)
+{
   int offset = 0;
   int ret;
 
-  /*
-   * Helper macro: Add snprintf result to offset and clamp to prevent overflow.
-   * snprintf returns the number of bytes that WOULD be written (excluding null),
-   * which can exceed remaining space. We must clamp after each call.
-   */
-#define SAFE_OFFSET_ADD(r)                                                                                             \
-  do                                                                                                                   \
-  {                                                                                                                    \
-    if ((r) > 0)                                                                                                       \
-      offset += (r);                                                                                                   \
-    if ((size_t)offset >= buf_size)                                                                                    \
-      offset = (int)(buf_size - 1);                                                                                    \
-  } while (0)
+  buf[0] = '\0';
 
   /* Add color prefix if enabled */
   if (log_ctx.colors_enabled)
   {
-    const char *color = "";
-    switch (level)
-    {
-    case FEB_LOG_ERROR:
-      color = FEB_LOG_COLOR_ERROR;
-      break;
-    case FEB_LOG_WARN:
-      color = FEB_LOG_COLOR_WARN;
-      break;
-    case FEB_LOG_INFO:
-      color = FEB_LOG_COLOR_INFO;
-      break;
-    case FEB_LOG_DEBUG:
-      color = FEB_LOG_COLOR_DEBUG;
-      break;
-    case FEB_LOG_TRACE:
-      color = FEB_LOG_COLOR_TRACE;
-      break;
-    default:
-      break;
-    }
-    ret = snprintf(buf + offset, buf_size - (size_t)offset, "%s", color);
-    SAFE_OFFSET_ADD(ret);
+    ret = snprintf(buf + offset, buf_size - (size_t)offset, "%s", log_level_color(level));
+    log_offset_add(&offset, ret, buf_size);
   }
 
   /* Add timestamp if enabled */
-  if (log_ctx.timestamps_enabled && log_ctx.get_tick_ms != NULL)
+  if (has_tick)
   {
-    uint32_t tick = log_ctx.get_tick_ms();
     ret = snprintf(buf + offset, buf_size - (size_t)offset, "[%lu] ", (unsigned long)tick);
-    SAFE_OFFSET_ADD(ret);
+    log_offset_add(&offset, ret, buf_size);
   }
 
   /* Add level prefix */
-  const char *level_str = "";
-  switch (level)
-  {
-  case FEB_LOG_ERROR:
-    level_str = "E";
-    break;
-  case FEB_LOG_WARN:
-    level_str = "W";
-    break;
-  case FEB_LOG_INFO:
-    level_str = "I";
-    break;
-  case FEB_LOG_DEBUG:
-    level_str = "D";
-    break;
-  case FEB_LOG_TRACE:
-    level_str = "T";
-    break;
-  default:
-    break;
-  }
-  ret = snprintf(buf + offset, buf_size - (size_t)offset, "%s ", level_str);
-  SAFE_OFFSET_ADD(ret);
+  ret = snprintf(buf + offset, buf_size - (size_t)offset, "%s ", log_level_str(level));
+  log_offset_add(&offset, ret, buf_size);
 
   /* Add tag */
   if (tag != NULL)
   {
     ret = snprintf(buf + offset, buf_size - (size_t)offset, "%s ", tag);
-    SAFE_OFFSET_ADD(ret);
+    log_offset_add(&offset, ret, buf_size);
   }
 
-  /* Add user message */
-  va_list args;
-  va_start(args, format);
-  ret = vsnprintf(buf + offset, buf_size - (size_t)offset, format, args);
-  va_end(args);
-  SAFE_OFFSET_ADD(ret);
+  return offset;
+}
+
+/**
+ * @brief Append file/line (ERROR and WARN), color reset and newline
+ */
+static int log_compose_suffix(char *buf, size_t buf_size, int offset, FEB_Log_Level_t level, const char *file,
+                              int line)
+{
+  int ret;
 
   /* Add file/line for ERROR and WARN */
   if (file != NULL && (level == FEB_LOG_ERROR || level == FEB_LOG_WARN))
@@ -362,22 +345,648 @@ void FEB_Log_Output(FEB_Log_Level_t level, const char *tag, const char *file, in
       }
     }
     ret = snprintf(buf + offset, buf_size - (size_t)offset, " (%s:%d)", filename, line);
-    SAFE_OFFSET_ADD(ret);
+    log_offset_add(&offset, ret, buf_size);
   }
 
   /* Add color reset and newline */
   if (log_ctx.colors_enabled)
   {
     ret = snprintf(buf + offset, buf_size - (size_t)offset, "%s\r\n", FEB_LOG_ANSI_RESET);
-    SAFE_OFFSET_ADD(ret);
+    log_offset_add(&offset, ret, buf_size);
   }
   else
   {
     ret = snprintf(buf + offset, buf_size - (size_t)offset, "\r\n");
-    SAFE_OFFSET_ADD(ret);
+    log_offset_add(&offset, ret, buf_size);
   }
 
-#undef SAFE_OFFSET_ADD
+  return offset;
+}
+
+#if FEB_LOG_DEFERRED
+
+/* ============================================================================
+ * Deferred Backend
+ * ============================================================================
+ *
+ * Multi-producer / single-consumer byte ring. A producer (any task or ISR)
+ * reserves space by CAS on the free-running head, fills the record, then
+ * publishes it with a release store of the header word. FEB_Log_Process walks
+ * from the tail, stops at the first record whose word is still 0 (reserved
+ * but not yet committed), and zeroes each span it consumes so a later
+ * reservation always starts with an uncommitted word.
+ *
+ * A record that would straddle the end of the ring is preceded by a PAD
+ * record covering the rest of the buffer. All lengths are multiples of 8, so
+ * every record header stays aligned and a pad always has room for its word.
+ *
+ * Arguments are stored in their promoted native types, in format order, so
+ * the consumer can hand each one back to snprintf with its own conversion
+ * spec. %s strings are copied as a length byte plus up to
+ * FEB_LOG_DEFERRED_STR_MAX bytes (0xFF = NULL pointer).
+ */
+
+#if defined(__ARM_ARCH_6M__)
+#error "FEB_LOG_DEFERRED needs LDREX/STREX (Cortex-M3 or later)"
+#endif
+
+#if (FEB_LOG_DEFERRED_RING_SIZE & (FEB_LOG_DEFERRED_RING_SIZE - 1)) != 0 || FEB_LOG_DEFERRED_RING_SIZE > 32768
+#error "FEB_LOG_DEFERRED_RING_SIZE must be a power of two <= 32768"
+#endif
+
+#if FEB_LOG_DEFERRED_STR_MAX > 254
+#error "FEB_LOG_DEFERRED_STR_MAX must fit in a length byte"
+#endif
+
+#define LOG_RING_MASK (FEB_LOG_DEFERRED_RING_SIZE - 1U)
+#define LOG_ALIGN_UP(n) (((n) + 7U) & ~7U)
+
+#define LOG_REC_FLAG_PAD 0x01U
+#define LOG_REC_FLAG_TICK 0x02U
+#define LOG_REC_STR_NULL 0xFFU
+
+typedef struct
+{
+  uint32_t word; /* Commit word: [15:0] record bytes, [23:16] level, [31:24] flags. 0 = not committed */
+  uint32_t tick;
+  const char *tag;
+  const char *format;
+  const char *file;
+  int32_t line;
+  uint32_t args_len;
+} log_rec_t;
+
+#define LOG_REC_HDR_BYTES LOG_ALIGN_UP((uint32_t)sizeof(log_rec_t))
+
+typedef enum
+{
+  LOG_ARG_END,     /* End of format string */
+  LOG_ARG_BAD,     /* Unknown conversion: stop consuming arguments */
+  LOG_ARG_PERCENT, /* "%%" */
+  LOG_ARG_INT,
+  LOG_ARG_LONG,
+  LOG_ARG_LLONG,
+  LOG_ARG_SIZE,
+  LOG_ARG_INTMAX,
+  LOG_ARG_PTRDIFF,
+  LOG_ARG_DOUBLE,
+  LOG_ARG_LDOUBLE, /* Stored as double */
+  LOG_ARG_STR,
+  LOG_ARG_PTR,
+  LOG_ARG_COUNT, /* %n - argument consumed, nothing stored or printed */
+} log_arg_kind_t;
+
+typedef struct
+{
+  const char *start; /* '%' of this conversion (or the terminating NUL) */
+  size_t len;        /* Length of the conversion spec */
+  log_arg_kind_t kind;
+  uint8_t stars; /* '*' width/precision arguments preceding the value */
+} log_spec_t;
+
+static uint8_t log_ring[FEB_LOG_DEFERRED_RING_SIZE] __attribute__((aligned(8)));
+static uint32_t log_ring_head;   /* Reservation cursor, advanced by producers (CAS) */
+static uint32_t log_ring_tail;   /* Release cursor, advanced by FEB_Log_Process only */
+static bool log_ring_draining;   /* Single-consumer guard */
+static uint32_t log_ring_records;
+static uint32_t log_ring_dropped;
+static uint32_t log_ring_high_water;
+static uint32_t log_dropped_reported;
+
+/**
+ * @brief Find the next conversion in a format string
+ *
+ * Literal text runs from @p p to spec->start. Returns the character after the
+ * conversion, which is where the next search starts.
+ */
+static const char *log_next_spec(const char *p, log_spec_t *spec)
+{
+  while (*p != '\0' && *p != '%')
+  {
+    p++;
+  }
+  spec->start = p;
+  spec->stars = 0;
+  spec->len = 0;
+  if (*p == '\0')
+  {
+    spec->kind = LOG_ARG_END;
+    return p;
+  }
+
+  const char *s = p + 1;
+  while (*s == '-' || *s == '+' || *s == ' ' || *s == '#' || *s == '0')
+  {
+    s++;
+  }
+  if (*s == '*')
+  {
+    spec->stars++;
+    s++;
+  }
+  while (isdigit((unsigned char)*s))
+  {
+    s++;
+  }
+  if (*s == '.')
+  {
+    s++;
+    if (*s == '*')
+    {
+      spec->stars++;
+      s++;
+    }
+    while (isdigit((unsigned char)*s))
+    {
+      s++;
+    }
+  }
+
+  uint8_t longs = 0;
+  char mod = 0;
+  switch (*s)
+  {
+  case 'h':
+    s += (s[1] == 'h') ? 2 : 1;
+    break;
+  case 'l':
+    longs = (s[1] == 'l') ? 2 : 1;
+    s += longs;
+    break;
+  case 'z':
+  case 'j':
+  case 't':
+  case 'L':
+    mod = *s++;
+    break;
+  default:
+    break;
+  }
+
+  switch (*s)
+  {
+  case 'd':
+  case 'i':
+  case 'u':
+  case 'o':
+  case 'x':
+  case 'X':
+    spec->kind = (longs == 2)     ? LOG_ARG_LLONG
+                 : (longs == 1)   ? LOG_ARG_LONG
+                 : (mod == 'z')   ? LOG_ARG_SIZE
+                 : (mod == 'j')   ? LOG_ARG_INTMAX
+                 : (mod == 't')   ? LOG_ARG_PTRDIFF
+                                  : LOG_ARG_INT;
+    break;
+  case 'c':
+    spec->kind = LOG_ARG_INT;
+    break;
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  case 'a':
+  case 'A':
+    spec->kind = (mod == 'L') ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+    break;
+  case 's':
+    spec->kind = (longs == 0) ? LOG_ARG_STR : LOG_ARG_BAD;
+    break;
+  case 'p':
+    spec->kind = LOG_ARG_PTR;
+    break;
+  case 'n':
+    spec->kind = LOG_ARG_COUNT;
+    break;
+  case '%':
+    spec->kind = (s == p + 1) ? LOG_ARG_PERCENT : LOG_ARG_BAD;
+    break;
+  default:
+    spec->kind = LOG_ARG_BAD;
+    return s;
+  }
+
+  s++;
+  spec->len = (size_t)(s - p);
+  return s;
+}
+
+/**
+ * @brief Pull the arguments of @p format off @p args into @p out
+ *
+ * Stops early (dropping the remaining arguments) when @p cap is reached; the
+ * decoder notices the short buffer and marks the line with "...".
+ *
+ * @return Bytes written
+ */
+static uint32_t log_encode_args(uint8_t *out, uint32_t cap, const char *format, va_list args)
+{
+  uint32_t n = 0;
+  log_spec_t spec;
+  const char *p = format;
+
+#define LOG_PUT(type, value)                                                                                           \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    type v_ = (type)(value);                                                                                           \
+    if (n + sizeof(type) > cap)                                                                                        \
+    {                                                                                                                  \
+      return n;                                                                                                        \
+    }                                                                                                                  \
+    memcpy(&out[n], &v_, sizeof(type));                                                                                \
+    n += (uint32_t)sizeof(type);                                                                                       \
+  } while (0)
+
+  for (;;)
+  {
+    p = log_next_spec(p, &spec);
+    if (spec.kind == LOG_ARG_END || spec.kind == LOG_ARG_BAD)
+    {
+      return n;
+    }
+
+    for (uint8_t i = 0; i < spec.stars; i++)
+    {
+      LOG_PUT(int, va_arg(args, int));
+    }
+
+    switch (spec.kind)
+    {
+    case LOG_ARG_INT:
+      LOG_PUT(int, va_arg(args, int));
+      break;
+    case LOG_ARG_LONG:
+      LOG_PUT(long, va_arg(args, long));
+      break;
+    case LOG_ARG_LLONG:
+      LOG_PUT(long long, va_arg(args, long long));
+      break;
+    case LOG_ARG_SIZE:
+      LOG_PUT(size_t, va_arg(args, size_t));
+      break;
+    case LOG_ARG_INTMAX:
+      LOG_PUT(intmax_t, va_arg(args, intmax_t));
+      break;
+    case LOG_ARG_PTRDIFF:
+      LOG_PUT(ptrdiff_t, va_arg(args, ptrdiff_t));
+      break;
+    case LOG_ARG_DOUBLE:
+      LOG_PUT(double, va_arg(args, double));
+      break;
+    case LOG_ARG_LDOUBLE:
+      LOG_PUT(double, va_arg(args, long double));
+      break;
+    case LOG_ARG_PTR:
+      LOG_PUT(void *, va_arg(args, void *));
+      break;
+    case LOG_ARG_COUNT:
+      (void)va_arg(args, void *);
+      break;
+    case LOG_ARG_STR:
+    {
+      const char *str = va_arg(args, const char *);
+      size_t len = 0;
+      if (str != NULL)
+      {
+        while (len < FEB_LOG_DEFERRED_STR_MAX && str[len] != '\0')
+        {
+          len++;
+        }
+      }
+      if (n + 1U + len > cap)
+      {
+        return n;
+      }
+      if (str == NULL)
+      {
+        out[n++] = LOG_REC_STR_NULL;
+        break;
+      }
+      out[n++] = (uint8_t)len;
+      memcpy(&out[n], str, len);
+      n += (uint32_t)len;
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+#undef LOG_PUT
+}
+
+/**
+ * @brief Append @p len bytes of literal text, clamped to the buffer
+ */
+static void log_append(char *buf, size_t buf_size, int *offset, const char *text, size_t len)
+{
+  size_t room = buf_size - 1U - (size_t)*offset;
+  if (len > room)
+  {
+    len = room;
+  }
+  memcpy(buf + *offset, text, len);
+  *offset += (int)len;
+  buf[*offset] = '\0';
+}
+
+/**
+ * @brief Re-run @p format against the encoded arguments in [ap, end)
+ */
+static int log_expand_args(char *buf, size_t buf_size, int offset, const char *format, const uint8_t *ap,
+                           const uint8_t *end)
+{
+  char spec_buf[24];
+  char str_buf[FEB_LOG_DEFERRED_STR_MAX + 1];
+  log_spec_t spec;
+  const char *p = format;
+  int ret = 0;
+
+#define LOG_EXPAND(type)                                                                                               \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    type v_;                                                                                                           \
+    if (ap + sizeof(type) > end)                                                                                       \
+    {                                                                                                                  \
+      goto out_of_args;                                                                                                \
+    }                                                                                                                  \
+    memcpy(&v_, ap, sizeof(type));                                                                                     \
+    ap += sizeof(type);                                                                                                \
+    if (spec.stars == 0)                                                                                               \
+      ret = snprintf(buf + offset, buf_size - (size_t)offset, spec_buf, v_);                                           \
+    else if (spec.stars == 1)                                                                                          \
+      ret = snprintf(buf + offset, buf_size - (size_t)offset, spec_buf, star[0], v_);                                  \
+    else                                                                                                               \
+      ret = snprintf(buf + offset, buf_size - (size_t)offset, spec_buf, star[0], star[1], v_);                         \
+  } while (0)
+
+  for (;;)
+  {
+    const char *next = log_next_spec(p, &spec);
+    log_append(buf, buf_size, &offset, p, (size_t)(spec.start - p));
+
+    if (spec.kind == LOG_ARG_END)
+    {
+      break;
+    }
+    if (spec.kind == LOG_ARG_BAD || spec.len >= sizeof(spec_buf))
+    {
+      /* Arguments stopped here at record time too; print the rest verbatim */
+      log_append(buf, buf_size, &offset, spec.start, strlen(spec.start));
+      break;
+    }
+    if (spec.kind == LOG_ARG_PERCENT)
+    {
+      log_append(buf, buf_size, &offset, "%", 1U);
+      p = next;
+      continue;
+    }
+
+    memcpy(spec_buf, spec.start, spec.len);
+    spec_buf[spec.len] = '\0';
+
+    int star[2] = {0, 0};
+    for (uint8_t i = 0; i < spec.stars; i++)
+    {
+      if (ap + sizeof(int) > end)
+      {
+        goto out_of_args;
+      }
+      memcpy(&star[i], ap, sizeof(int));
+      ap += sizeof(int);
+    }
+
+    ret = 0;
+    switch (spec.kind)
+    {
+    case LOG_ARG_INT:
+      LOG_EXPAND(int);
+      break;
+    case LOG_ARG_LONG:
+      LOG_EXPAND(long);
+      break;
+    case LOG_ARG_LLONG:
+      LOG_EXPAND(long long);
+      break;
+    case LOG_ARG_SIZE:
+      LOG_EXPAND(size_t);
+      break;
+    case LOG_ARG_INTMAX:
+      LOG_EXPAND(intmax_t);
+      break;
+    case LOG_ARG_PTRDIFF:
+      LOG_EXPAND(ptrdiff_t);
+      break;
+    case LOG_ARG_LDOUBLE:
+    {
+      /* Stored as double: drop the 'L' so the spec matches */
+      char *l = strchr(spec_buf, 'L');
+      memmove(l, l + 1, strlen(l));
+      LOG_EXPAND(double);
+      break;
+    }
+    case LOG_ARG_DOUBLE:
+      LOG_EXPAND(double);
+      break;
+    case LOG_ARG_PTR:
+      LOG_EXPAND(void *);
+      break;
+    case LOG_ARG_STR:
+    {
+      if (ap >= end)
+      {
+        goto out_of_args;
+      }
+      uint8_t len = *ap++;
+      const char *str = NULL;
+      if (len != LOG_REC_STR_NULL)
+      {
+        memcpy(str_buf, ap, len);
+        str_buf[len] = '\0';
+        ap += len;
+        str = str_buf;
+      }
+      if (spec.stars == 0)
+        ret = snprintf(buf + offset, buf_size - (size_t)offset, spec_buf, str);
+      else if (spec.stars == 1)
+        ret = snprintf(buf + offset, buf_size - (size_t)offset, spec_buf, star[0], str);
+      else
+        ret = snprintf(buf + offset, buf_size - (size_t)offset, spec_buf, star[0], star[1], str);
+      break;
+    }
+    default:
+      break;
+    }
+    log_offset_add(&offset, ret, buf_size);
+    p = next;
+  }
+
+#undef LOG_EXPAND
+  return offset;
+
+out_of_args:
+  /* Record was cut at FEB_LOG_DEFERRED_RECORD_ARGS_MAX */
+  log_append(buf, buf_size, &offset, "...", 3U);
+  return offset;
+}
+
+/**
+ * @brief Reserve @p len bytes (multiple of 8) in the ring
+ * @return Record to fill, or NULL if the ring is full (message dropped)
+ */
+static log_rec_t *log_ring_reserve(uint32_t len)
+{
+  uint32_t head = __atomic_load_n(&log_ring_head, __ATOMIC_RELAXED);
+  uint32_t pad;
+  uint32_t next;
+
+  do
+  {
+    uint32_t to_end = FEB_LOG_DEFERRED_RING_SIZE - (head & LOG_RING_MASK);
+    pad = (to_end < len) ? to_end : 0U;
+    next = head + pad + len;
+    if (next - __atomic_load_n(&log_ring_tail, __ATOMIC_ACQUIRE) > FEB_LOG_DEFERRED_RING_SIZE)
+    {
+      __atomic_fetch_add(&log_ring_dropped, 1U, __ATOMIC_RELAXED);
+      return NULL;
+    }
+  } while (!__atomic_compare_exchange_n(&log_ring_head, &head, next, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+  if (pad != 0U)
+  {
+    log_rec_t *filler = (log_rec_t *)&log_ring[head & LOG_RING_MASK];
+    __atomic_store_n(&filler->word, pad | (LOG_REC_FLAG_PAD << 24), __ATOMIC_RELEASE);
+  }
+
+  /* Statistics only - a lost update under contention is harmless */
+  uint32_t used = next - __atomic_load_n(&log_ring_tail, __ATOMIC_RELAXED);
+  if (used > log_ring_high_water)
+  {
+    log_ring_high_water = used;
+  }
+
+  return (log_rec_t *)&log_ring[(head + pad) & LOG_RING_MASK];
+}
+
+/**
+ * @brief Record one message instead of formatting it (FEB_Log_Output hot path)
+ */
+static void log_deferred_record(FEB_Log_Level_t level, const char *tag, const char *file, int line, bool has_tick,
+                                uint32_t tick, const char *format, va_list args)
+{
+  uint8_t arg_buf[FEB_LOG_DEFERRED_RECORD_ARGS_MAX];
+  uint32_t args_len = log_encode_args(arg_buf, sizeof(arg_buf), format, args);
+  uint32_t len = LOG_ALIGN_UP(LOG_REC_HDR_BYTES + args_len);
+
+  log_rec_t *rec = log_ring_reserve(len);
+  if (rec == NULL)
+  {
+    return;
+  }
+
+  rec->tick = tick;
+  rec->tag = tag;
+  rec->format = format;
+  rec->file = file;
+  rec->line = (int32_t)line;
+  rec->args_len = args_len;
+  memcpy((uint8_t *)rec + LOG_REC_HDR_BYTES, arg_buf, args_len);
+
+  uint32_t flags = has_tick ? LOG_REC_FLAG_TICK : 0U;
+  __atomic_fetch_add(&log_ring_records, 1U, __ATOMIC_RELAXED);
+  __atomic_store_n(&rec->word, len | ((uint32_t)level << 16) | (flags << 24), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Format one committed record and send it to the output
+ */
+static void log_deferred_emit(const log_rec_t *rec, uint32_t word)
+{
+  FEB_Log_Level_t level = (FEB_Log_Level_t)((word >> 16) & 0xFFU);
+  bool has_tick = (((word >> 24) & LOG_REC_FLAG_TICK) != 0U);
+  const uint8_t *args = (const uint8_t *)rec + LOG_REC_HDR_BYTES;
+
+  FEB_LOG_MUTEX_LOCK(log_ctx.mutex);
+  char *buf = staging_buffer;
+  size_t buf_size = sizeof(staging_buffer);
+
+  int offset = log_compose_prefix(buf, buf_size, level, rec->tag, has_tick, rec->tick);
+  offset = log_expand_args(buf, buf_size, offset, rec->format, args, args + rec->args_len);
+  offset = log_compose_suffix(buf, buf_size, offset, level, rec->file, (int)rec->line);
+  log_ctx.output(buf, (size_t)offset);
+
+  FEB_LOG_MUTEX_UNLOCK(log_ctx.mutex);
+}
+
+#endif /* FEB_LOG_DEFERRED */
+
+/* ============================================================================
+ * Logging Functions
+ * ============================================================================ */
+
+void FEB_Log_Output(FEB_Log_Level_t level, const char *tag, const char *file, int line, const char *format, ...)
+{
+  if (!log_ctx.initialized || log_ctx.output == NULL)
+  {
+    return;
+  }
+
+  /* Runtime level filter */
+  if (level > log_ctx.level || level == FEB_LOG_NONE)
+  {
+    return;
+  }
+
+  bool has_tick = log_ctx.timestamps_enabled && log_ctx.get_tick_ms != NULL;
+  uint32_t tick = has_tick ? log_ctx.get_tick_ms() : 0U;
+
+#if FEB_LOG_DEFERRED
+  if (log_ctx.deferred)
+  {
+    va_list args;
+    va_start(args, format);
+    log_deferred_record(level, tag, file, line, has_tick, tick, format, args);
+    va_end(args);
+    return;
+  }
+#endif
+
+  bool in_isr = FEB_LOG_IN_ISR();
+
+  /*
+   * Buffer selection: Use stack-local buffer for ISR context to avoid
+   * race conditions with staging_buffer. ISR buffer is smaller due to
+   * stack constraints.
+   */
+  char isr_buffer[128];
+  char *buf;
+  size_t buf_size;
+
+  if (in_isr)
+  {
+    buf = isr_buffer;
+    buf_size = sizeof(isr_buffer);
+  }
+  else
+  {
+    /* Acquire lock BEFORE formatting to protect staging_buffer */
+    FEB_LOG_MUTEX_LOCK(log_ctx.mutex);
+    buf = staging_buffer;
+    buf_size = sizeof(staging_buffer);
+  }
+
+  int offset = log_compose_prefix(buf, buf_size, level, tag, has_tick, tick);
+
+  /* Add user message */
+  va_list args;
+  va_start(args, format);
+  int ret = vsnprintf(buf + offset, buf_size - (size_t)offset, format, args);
+  va_end(args);
+  log_offset_add(&offset, ret, buf_size);
+
+  offset = log_compose_suffix(buf, buf_size, offset, level, file, line);
 
   /* Output the formatted message */
   log_ctx.output(buf, (size_t)offset);
@@ -459,3 +1068,107 @@ void FEB_Log_Hexdump(const char *tag, const uint8_t *data, size_t len)
 
   FEB_Log_Raw("\r\n");
 }
+
+/* ============================================================================
+ * Deferred Mode
+ * ============================================================================ */
+
+void FEB_Log_SetDeferred(bool enable)
+{
+#if FEB_LOG_DEFERRED
+  log_ctx.deferred = enable;
+  if (!enable)
+  {
+    /* Keep ordering: flush what was recorded before going immediate */
+    (void)FEB_Log_Process();
+  }
+#else
+  (void)enable;
+#endif
+}
+
+bool FEB_Log_GetDeferred(void)
+{
+#if FEB_LOG_DEFERRED
+  return log_ctx.deferred;
+#else
+  return false;
+#endif
+}
+
+size_t FEB_Log_Process(void)
+{
+#if FEB_LOG_DEFERRED
+  if (!log_ctx.initialized || log_ctx.output == NULL || FEB_LOG_IN_ISR())
+  {
+    return 0;
+  }
+  if (__atomic_exchange_n(&log_ring_draining, true, __ATOMIC_ACQUIRE))
+  {
+    return 0; /* Another task is already draining */
+  }
+
+  size_t emitted = 0;
+  uint32_t tail = log_ring_tail;
+
+  for (;;)
+  {
+    log_rec_t *rec = (log_rec_t *)&log_ring[tail & LOG_RING_MASK];
+    uint32_t word = __atomic_load_n(&rec->word, __ATOMIC_ACQUIRE);
+    if (word == 0U)
+    {
+      break; /* Empty, or the oldest reservation is still being written */
+    }
+
+    uint32_t len = word & 0xFFFFU;
+    if (((word >> 24) & LOG_REC_FLAG_PAD) == 0U)
+    {
+      log_deferred_emit(rec, word);
+      emitted++;
+    }
+
+    memset(rec, 0, len);
+    tail += len;
+    __atomic_store_n(&log_ring_tail, tail, __ATOMIC_RELEASE);
+  }
+
+  uint32_t dropped = __atomic_load_n(&log_ring_dropped, __ATOMIC_RELAXED);
+  if (dropped != log_dropped_reported)
+  {
+    uint32_t lost = dropped - log_dropped_reported;
+    log_dropped_reported = dropped;
+
+    FEB_LOG_MUTEX_LOCK(log_ctx.mutex);
+    bool has_tick = log_ctx.timestamps_enabled && log_ctx.get_tick_ms != NULL;
+    int offset = log_compose_prefix(staging_buffer, sizeof(staging_buffer), FEB_LOG_WARN, "[LOG]", has_tick,
+                                    has_tick ? log_ctx.get_tick_ms() : 0U);
+    int ret = snprintf(staging_buffer + offset, sizeof(staging_buffer) - (size_t)offset, "%lu messages dropped",
+                       (unsigned long)lost);
+    log_offset_add(&offset, ret, sizeof(staging_buffer));
+    offset = log_compose_suffix(staging_buffer, sizeof(staging_buffer), offset, FEB_LOG_WARN, NULL, 0);
+    log_ctx.output(staging_buffer, (size_t)offset);
+    FEB_LOG_MUTEX_UNLOCK(log_ctx.mutex);
+    emitted++;
+  }
+
+  __atomic_store_n(&log_ring_draining, false, __ATOMIC_RELEASE);
+  return emitted;
+#else
+  return 0;
+#endif
+}
+
+void FEB_Log_GetDeferredStats(FEB_Log_DeferredStats_t *stats)
+{
+  if (stats == NULL)
+  {
+    return;
+  }
+  memset(stats, 0, sizeof(*stats));
+#if FEB_LOG_DEFERRED
+  stats->records = __atomic_load_n(&log_ring_records, __ATOMIC_RELAXED);
+  stats->dropped = __atomic_load_n(&log_ring_dropped, __ATOMIC_RELAXED);
+  stats->high_water = log_ring_high_water;
+  stats->ring_size = FEB_LOG_DEFERRED_RING_SIZE;
+#endif
+}
@@ -13,7 +13,9 @@
  * Usage:
  *   1. FEB_TPS_Init()
  *   2. FEB_TPS_DeviceRegister() per chip
- *   3. FEB_TPS_Poll() / FEB_TPS_PollScaled() / FEB_TPS_PollRaw() in your loop
+ *   3. FEB_TPS_Poll() / FEB_TPS_PollScaled() / FEB_TPS_PollRaw() in your loop,
+ *      or FEB_TPS_BatchStart() + FEB_TPS_BatchProcess() to read every
+ *      registered device in the background off the I2C interrupt
  *
  ******************************************************************************
  */
@@ -56,6 +58,7 @@ typedef enum {
     FEB_TPS_ERR_NOT_INIT,           /**< Library or device not initialized */
     FEB_TPS_ERR_CONFIG_MISMATCH,    /**< CONFIG/CAL readback differed from write */
     FEB_TPS_ERR_MAX_DEVICES,        /**< Too many devices already registered */
+    FEB_TPS_ERR_BUSY,               /**< A batch poll owns the bus */
 } FEB_TPS_Status_t;
 
 /* ============================================================================
@@ -235,6 +238,71 @@ FEB_TPS_Status_t FEB_TPS_PollRaw(FEB_TPS_Handle_t handle,
                                  int16_t *current_raw,
                                  int16_t *shunt_v_raw);
 
+/* ============================================================================
+ * Batch Poll (FEB_TPS_ENABLE_BATCH)
+ * ============================================================================ */
+
+#if FEB_TPS_ENABLE_BATCH
+
+/**
+ * Per-device result of a batch, delivered from FEB_TPS_BatchProcess() in the
+ * caller's context. On error the measurement is zeroed.
+ */
+typedef void (*FEB_TPS_BatchCallback_t)(FEB_TPS_Handle_t handle,
+                                        FEB_TPS_Status_t status,
+                                        const FEB_TPS_Measurement_t *measurement,
+                                        void *ctx);
+
+typedef struct {
+    uint32_t batches;           /**< Batches completed */
+    uint32_t device_errors;     /**< Devices that failed a read in a batch */
+    uint32_t busy_rejects;      /**< BatchStart calls refused with ERR_BUSY */
+    uint32_t last_duration_ms;  /**< Start to last read complete, most recent batch */
+    uint32_t max_duration_ms;   /**< Worst batch since Init */
+} FEB_TPS_BatchStats_t;
+
+/**
+ * Queue BUS_VOLT, CURRENT, SHUNT_VOLT and POWER reads for every registered
+ * device and return immediately. Each read is issued from the completion
+ * interrupt of the previous one (HAL_I2C_Mem_Read_IT, or _DMA with
+ * FEB_TPS_BATCH_USE_DMA), so the bus stays busy back-to-back without the CPU
+ * waiting on it. A device that NACKs is skipped for the rest of the batch.
+ *
+ * In FreeRTOS builds the i2c_mutex is taken without blocking and held until
+ * FEB_TPS_BatchProcess() finishes the batch, so call both from the same task.
+ *
+ * @param callback Invoked once per device by FEB_TPS_BatchProcess(); may be NULL.
+ * @param ctx      Passed through to @p callback.
+ * @return FEB_TPS_OK if the batch started;
+ *         FEB_TPS_ERR_BUSY if a batch is unfinished or another task holds the bus.
+ */
+FEB_TPS_Status_t FEB_TPS_BatchStart(FEB_TPS_BatchCallback_t callback, void *ctx);
+
+/**
+ * Deliver a finished batch: convert the raw registers, run the callback for
+ * each device and release the bus. Cheap when nothing finished; call it from
+ * the main loop / polling task.
+ *
+ * @return true if a batch was delivered by this call.
+ */
+bool FEB_TPS_BatchProcess(void);
+
+/** True while batch reads are in flight on the bus. */
+bool FEB_TPS_BatchIsBusy(void);
+
+/** Copy the batch counters. */
+void FEB_TPS_BatchGetStats(FEB_TPS_BatchStats_t *stats);
+
+/**
+ * Forward from HAL_I2C_MemRxCpltCallback / HAL_I2C_ErrorCallback. Both ignore
+ * handles that the current batch is not using, so they can be called for
+ * every I2C peripheral on the board.
+ */
+void FEB_TPS_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void FEB_TPS_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+#endif /* FEB_TPS_ENABLE_BATCH */
+
 /* ============================================================================
  * GPIO Control
  * ============================================================================ */
@@ -56,6 +56,28 @@ extern "C" {
 #define FEB_TPS_I2C_TIMEOUT_MS 100
 #endif
 
+/* ============================================================================
+ * Batch poll engine
+ * ============================================================================ */
+
+/**
+ * Build FEB_TPS_BatchStart() / FEB_TPS_BatchProcess(). The engine chains
+ * interrupt-driven register reads from the HAL I2C completion callbacks, so
+ * the board must forward HAL_I2C_MemRxCpltCallback / HAL_I2C_ErrorCallback
+ * and have the I2C event + error IRQs enabled. Unused unless started.
+ */
+#ifndef FEB_TPS_ENABLE_BATCH
+#define FEB_TPS_ENABLE_BATCH 1
+#endif
+
+/**
+ * 1 = HAL_I2C_Mem_Read_DMA, 0 = HAL_I2C_Mem_Read_IT. Reads are two bytes, so
+ * IT costs only a few interrupts per register and needs no DMA stream.
+ */
+#ifndef FEB_TPS_BATCH_USE_DMA
+#define FEB_TPS_BATCH_USE_DMA 0
+#endif
+
 /* ============================================================================
  * Default CONFIG register
  * ============================================================================ */
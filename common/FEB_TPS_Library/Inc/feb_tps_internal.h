@@ -33,11 +33,13 @@ extern "C" {
 #include "cmsis_os2.h"
 
 #define FEB_TPS_MUTEX_LOCK(m)    do { if ((m) != NULL) { osMutexAcquire((m), osWaitForever); } } while (0)
+#define FEB_TPS_MUTEX_TRYLOCK(m) (((m) == NULL) || (osMutexAcquire((m), 0) == osOK))
 #define FEB_TPS_MUTEX_UNLOCK(m)  do { if ((m) != NULL) { osMutexRelease((m)); } } while (0)
 
 #else /* Bare-metal: mutex ops are no-ops */
 
 #define FEB_TPS_MUTEX_LOCK(m)    ((void)0)
+#define FEB_TPS_MUTEX_TRYLOCK(m) (true)
 #define FEB_TPS_MUTEX_UNLOCK(m)  ((void)0)
 
 #endif /* FEB_TPS_USE_FREERTOS */
@@ -71,6 +73,41 @@ typedef struct FEB_TPS_Device_s {
     bool initialized;
 } FEB_TPS_Device_t;
 
+/* ============================================================================
+ * Batch poll state
+ * ============================================================================ */
+
+#if FEB_TPS_ENABLE_BATCH
+
+/** Registers read per device, in bus order (see feb_tps_batch_regs[]). */
+#define FEB_TPS_BATCH_REG_COUNT 4U
+
+typedef enum {
+    FEB_TPS_BATCH_IDLE = 0,     /**< No batch; bus and mutex free */
+    FEB_TPS_BATCH_RUNNING,      /**< Reads in flight, advanced from the I2C ISR */
+    FEB_TPS_BATCH_DONE,         /**< All reads finished; waiting for BatchProcess */
+} FEB_TPS_BatchState_t;
+
+/*
+ * Written by the I2C completion ISR while RUNNING and by the owning task
+ * otherwise; the state field is the hand-off.
+ */
+typedef struct {
+    volatile uint8_t state;                     /**< FEB_TPS_BatchState_t */
+    uint8_t dev_idx;                            /**< Device being read */
+    uint8_t reg_idx;                            /**< Index into feb_tps_batch_regs[] */
+    uint8_t rx_buf[2];                          /**< HAL destination for the current read */
+    uint16_t raw[FEB_TPS_MAX_DEVICES][FEB_TPS_BATCH_REG_COUNT];
+    uint8_t dev_status[FEB_TPS_MAX_DEVICES];    /**< FEB_TPS_Status_t per device */
+    FEB_TPS_BatchCallback_t callback;
+    void *callback_ctx;
+    uint32_t start_ms;
+    uint32_t done_ms;
+    FEB_TPS_BatchStats_t stats;
+} FEB_TPS_Batch_t;
+
+#endif /* FEB_TPS_ENABLE_BATCH */
+
 /* ============================================================================
  * Library context
  * ============================================================================ */
@@ -85,6 +122,10 @@ typedef struct {
 #if FEB_TPS_USE_FREERTOS
     FEB_TPS_MutexHandle_t i2c_mutex;
 #endif
+
+#if FEB_TPS_ENABLE_BATCH
+    FEB_TPS_Batch_t batch;
+#endif
 } FEB_TPS_Context_t;
 
 /* ============================================================================
@@ -31,6 +31,13 @@
 
 static FEB_TPS_Context_t feb_tps_ctx = {0};
 
+/* Blocking calls refuse the bus until BatchProcess() has delivered the batch */
+#if FEB_TPS_ENABLE_BATCH
+#define FEB_TPS_BATCH_ACTIVE() (feb_tps_ctx.batch.state != FEB_TPS_BATCH_IDLE)
+#else
+#define FEB_TPS_BATCH_ACTIVE() (false)
+#endif
+
 /* ============================================================================
  * Internal logging
  * ============================================================================ */
@@ -145,6 +152,9 @@ FEB_TPS_Status_t FEB_TPS_DeviceRegister(const FEB_TPS_DeviceConfig_t *config,
     if (feb_tps_ctx.device_count >= FEB_TPS_MAX_DEVICES) {
         return FEB_TPS_ERR_MAX_DEVICES;
     }
+    if (FEB_TPS_BATCH_ACTIVE()) {
+        return FEB_TPS_ERR_BUSY;
+    }
 
     FEB_TPS_Device_t *dev = &feb_tps_ctx.devices[feb_tps_ctx.device_count];
     memset(dev, 0, sizeof(*dev));
@@ -265,6 +275,9 @@ FEB_TPS_Status_t FEB_TPS_Poll(FEB_TPS_Handle_t handle,
     if (!dev->initialized) {
         return FEB_TPS_ERR_NOT_INIT;
     }
+    if (FEB_TPS_BATCH_ACTIVE()) {
+        return FEB_TPS_ERR_BUSY;
+    }
 
     FEB_TPS_MUTEX_LOCK(feb_tps_ctx.i2c_mutex);
 
@@ -332,6 +345,9 @@ FEB_TPS_Status_t FEB_TPS_PollRaw(FEB_TPS_Handle_t handle,
     if (!dev->initialized) {
         return FEB_TPS_ERR_NOT_INIT;
     }
+    if (FEB_TPS_BATCH_ACTIVE()) {
+        return FEB_TPS_ERR_BUSY;
+    }
 
     FEB_TPS_MUTEX_LOCK(feb_tps_ctx.i2c_mutex);
 
@@ -363,6 +379,168 @@ cleanup:
     return status;
 }
 
+/* ============================================================================
+ * Batch poll — reads chained from the I2C completion interrupt
+ * ============================================================================ */
+
+#if FEB_TPS_ENABLE_BATCH
+
+/*
+ * The TPS2482 register pointer does not auto-increment on reads, so the four
+ * measurement registers cannot come back in one burst; instead each read is
+ * issued from the previous read's completion interrupt and the bus never
+ * idles while the batch runs. Ordered by address, which is also the order
+ * the raw[] slots are indexed in.
+ */
+static const uint8_t feb_tps_batch_regs[FEB_TPS_BATCH_REG_COUNT] = {
+    FEB_TPS_REG_SHUNT_VOLT,
+    FEB_TPS_REG_BUS_VOLT,
+    FEB_TPS_REG_POWER,
+    FEB_TPS_REG_CURRENT,
+};
+
+#define TPS_BATCH_SHUNT 0
+#define TPS_BATCH_BUS   1
+#define TPS_BATCH_POWER 2
+#define TPS_BATCH_CUR   3
+
+#if FEB_TPS_BATCH_USE_DMA
+#define FEB_TPS_BATCH_MEM_READ HAL_I2C_Mem_Read_DMA
+#else
+#define FEB_TPS_BATCH_MEM_READ HAL_I2C_Mem_Read_IT
+#endif
+
+/**
+ * Issue the read for (dev_idx, reg_idx), skipping devices whose read cannot
+ * be started. Marks the batch DONE once every device has been visited.
+ * Runs in the starting task for the first read and in the I2C ISR after.
+ */
+static void feb_tps_batch_issue(void) {
+    FEB_TPS_Batch_t *b = &feb_tps_ctx.batch;
+
+    while (b->dev_idx < feb_tps_ctx.device_count) {
+        FEB_TPS_Device_t *dev = &feb_tps_ctx.devices[b->dev_idx];
+        HAL_StatusTypeDef hal_status = FEB_TPS_BATCH_MEM_READ(dev->hi2c, (uint16_t)(dev->i2c_addr << 1),
+                                                              feb_tps_batch_regs[b->reg_idx],
+                                                              I2C_MEMADD_SIZE_8BIT, b->rx_buf, 2);
+        if (hal_status == HAL_OK) {
+            return;
+        }
+        b->dev_status[b->dev_idx] = FEB_TPS_ERR_I2C;
+        b->dev_idx++;
+        b->reg_idx = 0;
+    }
+
+    b->done_ms = HAL_GetTick();
+    b->state = FEB_TPS_BATCH_DONE;
+}
+
+FEB_TPS_Status_t FEB_TPS_BatchStart(FEB_TPS_BatchCallback_t callback, void *ctx) {
+    if (!feb_tps_ctx.initialized) {
+        return FEB_TPS_ERR_NOT_INIT;
+    }
+    FEB_TPS_Batch_t *b = &feb_tps_ctx.batch;
+    if (b->state != FEB_TPS_BATCH_IDLE || !FEB_TPS_MUTEX_TRYLOCK(feb_tps_ctx.i2c_mutex)) {
+        b->stats.busy_rejects++;
+        return FEB_TPS_ERR_BUSY;
+    }
+
+    b->callback = callback;
+    b->callback_ctx = ctx;
+    b->dev_idx = 0;
+    b->reg_idx = 0;
+    for (uint8_t i = 0; i < feb_tps_ctx.device_count; i++) {
+        b->dev_status[i] = FEB_TPS_ERR_I2C;
+    }
+    b->start_ms = HAL_GetTick();
+    b->state = FEB_TPS_BATCH_RUNNING;
+
+    feb_tps_batch_issue();
+    return FEB_TPS_OK;
+}
+
+void FEB_TPS_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    FEB_TPS_Batch_t *b = &feb_tps_ctx.batch;
+    if (b->state != FEB_TPS_BATCH_RUNNING || feb_tps_ctx.devices[b->dev_idx].hi2c != hi2c) {
+        return;
+    }
+
+    /* TPS2482 returns MSB first */
+    b->raw[b->dev_idx][b->reg_idx] = ((uint16_t)b->rx_buf[0] << 8) | b->rx_buf[1];
+    if (++b->reg_idx >= FEB_TPS_BATCH_REG_COUNT) {
+        b->dev_status[b->dev_idx] = FEB_TPS_OK;
+        b->dev_idx++;
+        b->reg_idx = 0;
+    }
+    feb_tps_batch_issue();
+}
+
+void FEB_TPS_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    FEB_TPS_Batch_t *b = &feb_tps_ctx.batch;
+    if (b->state != FEB_TPS_BATCH_RUNNING || feb_tps_ctx.devices[b->dev_idx].hi2c != hi2c) {
+        return;
+    }
+
+    b->dev_status[b->dev_idx] = FEB_TPS_ERR_I2C;
+    b->dev_idx++;
+    b->reg_idx = 0;
+    feb_tps_batch_issue();
+}
+
+bool FEB_TPS_BatchProcess(void) {
+    FEB_TPS_Batch_t *b = &feb_tps_ctx.batch;
+    if (b->state != FEB_TPS_BATCH_DONE) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < feb_tps_ctx.device_count; i++) {
+        FEB_TPS_Device_t *dev = &feb_tps_ctx.devices[i];
+        FEB_TPS_Status_t status = (FEB_TPS_Status_t)b->dev_status[i];
+        FEB_TPS_Measurement_t m = {0};
+
+        if (status == FEB_TPS_OK) {
+            const uint16_t *raw = b->raw[i];
+            m.bus_voltage_raw = raw[TPS_BATCH_BUS];
+            m.bus_voltage_v = (float)m.bus_voltage_raw * FEB_TPS_CONV_VBUS_V_PER_LSB;
+            m.current_raw = FEB_TPS_SignMagnitude(raw[TPS_BATCH_CUR]);
+            m.current_a = (float)m.current_raw * dev->current_lsb;
+            m.shunt_voltage_raw = FEB_TPS_SignMagnitude(raw[TPS_BATCH_SHUNT]);
+            m.shunt_voltage_mv = (float)m.shunt_voltage_raw * FEB_TPS_CONV_VSHUNT_MV_PER_LSB;
+            m.power_raw = raw[TPS_BATCH_POWER];
+            m.power_w = (float)m.power_raw * dev->power_lsb;
+        } else {
+            b->stats.device_errors++;
+        }
+
+        if (b->callback != NULL) {
+            b->callback(dev, status, &m, b->callback_ctx);
+        }
+    }
+
+    const uint32_t duration = b->done_ms - b->start_ms;
+    b->stats.batches++;
+    b->stats.last_duration_ms = duration;
+    if (duration > b->stats.max_duration_ms) {
+        b->stats.max_duration_ms = duration;
+    }
+
+    b->state = FEB_TPS_BATCH_IDLE;
+    FEB_TPS_MUTEX_UNLOCK(feb_tps_ctx.i2c_mutex);
+    return true;
+}
+
+bool FEB_TPS_BatchIsBusy(void) {
+    return feb_tps_ctx.batch.state == FEB_TPS_BATCH_RUNNING;
+}
+
+void FEB_TPS_BatchGetStats(FEB_TPS_BatchStats_t *stats) {
+    if (stats != NULL) {
+        *stats = feb_tps_ctx.batch.stats;
+    }
+}
+
+#endif /* FEB_TPS_ENABLE_BATCH */
+
 /* ============================================================================
  * GPIO control
  * ============================================================================ */
@@ -423,6 +601,9 @@ FEB_TPS_Status_t FEB_TPS_ReadID(FEB_TPS_Handle_t handle, uint16_t *id) {
     if (!dev->initialized) {
         return FEB_TPS_ERR_NOT_INIT;
     }
+    if (FEB_TPS_BATCH_ACTIVE()) {
+        return FEB_TPS_ERR_BUSY;
+    }
 
     FEB_TPS_MUTEX_LOCK(feb_tps_ctx.i2c_mutex);
     HAL_StatusTypeDef hal_status = feb_tps_read_reg(dev->hi2c, dev->i2c_addr,
@@ -456,6 +637,7 @@ const char *FEB_TPS_StatusToString(FEB_TPS_Status_t status) {
         case FEB_TPS_ERR_NOT_INIT:         return "Not initialized";
         case FEB_TPS_ERR_CONFIG_MISMATCH:  return "Config mismatch";
         case FEB_TPS_ERR_MAX_DEVICES:      return "Max devices exceeded";
+        case FEB_TPS_ERR_BUSY:             return "Batch poll in progress";
         default:                           return "Unknown";
     }
 }
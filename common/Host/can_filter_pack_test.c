@@ -0,0 +1,639 @@
+/**
+ ******************************************************************************
+ * @file           : can_filter_pack_test.c
+ * @brief          : feb_can filter compiler: conformance and false-admit report
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Checks FEB_CAN_Filter_Compile (feb_can_filter_pack.c) and reports how much
+ * unwanted traffic a plan lets through.
+ *
+ *   plan     - random term sets (standard / extended, exact / mask, both
+ *              FIFOs, clustered so merges have something to find), 1..64
+ *              terms against every budget from 1 to 14 banks. For each plan:
+ *              every standard ID is classified exhaustively and every
+ *              extended term is sampled. No wanted ID may be rejected or
+ *              land only in the other FIFO. The plan must fit the budget
+ *              unless it is accept-all, which only happens when there are
+ *              more FIFO / ID-type groups than banks. The unwanted standard
+ *              IDs admitted may not exceed plan.extra_ids, and a set of
+ *              standard exact IDs that fits as 4-per-bank lists may not merge.
+ *   hardware - registers random sets as RX handles so the library programs
+ *              the host bxCAN model through FEB_CAN_Filter_UpdateFromRegistry,
+ *              then offers it every standard ID and sampled extended IDs. The
+ *              acceptance and FIFO each frame lands in must match the plan
+ *              compiled from the same terms.
+ *   report   - false-admit fraction of the compiled plan on a bus trace,
+ *              against the former one-bank-per-term scheme (terms past the
+ *              budget got no bank and were never received). Without a trace,
+ *              a synthetic one: 24 wanted IDs in clusters plus 2 ranges, and
+ *              80 other nodes' IDs carrying 70 % of the frames, at budgets
+ *              14 down to 2.
+ *
+ * usage: can_filter_pack_test [--banks N] [--trace candump.log] [term ...]
+ *        term = 123 | 520/7F0 | x18FF50E5 | x18FF0000/1FFF0000, optional @1
+ *        for FIFO1. The trace is `candump -L` output.
+ *
+ * stdout: `case,terms,budget,banks,merges,frames,wanted,admitted,false_admits,
+ *          false_admit_pct,missed,legacy_false_admit_pct,legacy_missed`
+ * stderr: conformance summary. Exit status 1 on any conformance failure or
+ *         missed frame, 2 on bad arguments or an unreadable trace.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_can_lib.h"
+#include "feb_host.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define TEST_PLAN_CASES 3000U
+#define TEST_HW_CASES 200U
+#define TEST_EXT_SAMPLES 8U
+#define TEST_MAX_BUDGET (FEB_CAN_CAN2_FILTER_BANK_START - FEB_CAN_CAN1_FILTER_BANK_START)
+#define TEST_SEED 0x9E3779B9u
+
+#define REPORT_FRAMES 200000U
+#define REPORT_OTHER_IDS 80U
+#define REPORT_WANTED_SHARE 0.30
+#define TRACE_MAX_FRAMES 2000000U
+
+#define STD_MASK 0x7FFU
+#define EXT_MASK 0x1FFFFFFFU
+
+static const uint8_t report_budgets[] = {14U, 8U, 6U, 4U, 2U};
+
+CAN_HandleTypeDef hcan1;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint32_t rng_state = TEST_SEED;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static uint32_t width_mask(uint8_t id_type)
+{
+  return (id_type == FEB_CAN_ID_STD) ? STD_MASK : EXT_MASK;
+}
+
+static bool term_matches(const FEB_CAN_Filter_Term_t *t, uint32_t id, uint8_t id_type)
+{
+  return t->id_type == id_type && ((id ^ t->id) & t->mask & width_mask(id_type)) == 0U;
+}
+
+/* Bit f set if a term on FIFO f wants this ID */
+static uint8_t wanted_fifos(const FEB_CAN_Filter_Term_t *terms, uint32_t n, uint32_t id, uint8_t id_type)
+{
+  uint8_t fifos = 0;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    if (term_matches(&terms[i], id, id_type))
+    {
+      fifos |= (uint8_t)(1U << terms[i].fifo);
+    }
+  }
+  return fifos;
+}
+
+/* Bit f set if a bank on FIFO f admits this ID */
+static uint8_t admitting_fifos(const FEB_CAN_Filter_Plan_t *plan, uint32_t id, uint8_t id_type)
+{
+  static FEB_CAN_Filter_Plan_t one;
+  uint8_t fifos = 0;
+  one.bank_count = 1;
+  for (uint8_t b = 0; b < plan->bank_count; b++)
+  {
+    one.banks[0] = plan->banks[b];
+    if (FEB_CAN_Filter_PlanAdmits(&one, id, (FEB_CAN_ID_Type_t)id_type))
+    {
+      fifos |= (uint8_t)(1U << plan->banks[b].fifo);
+    }
+  }
+  return fifos;
+}
+
+/* A random ID the term admits */
+static uint32_t term_sample(const FEB_CAN_Filter_Term_t *t)
+{
+  uint32_t w = width_mask(t->id_type);
+  return ((t->id & t->mask) | (rng_next() & ~t->mask)) & w;
+}
+
+/*
+ * Random term set. IDs come from a few clusters so that nearby IDs exist to
+ * merge; masks free 1..5 low bits (a range of 2..32 IDs).
+ */
+static void gen_terms(FEB_CAN_Filter_Term_t *terms, uint32_t n, bool allow_ext, bool allow_mask)
+{
+  uint32_t bases[4];
+  for (uint32_t c = 0; c < 4U; c++)
+  {
+    bases[c] = rng_next();
+  }
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    FEB_CAN_Filter_Term_t *t = &terms[i];
+    t->id_type = (allow_ext && (rng_next() % 4U) == 0U) ? FEB_CAN_ID_EXT : FEB_CAN_ID_STD;
+    t->fifo = (uint8_t)((rng_next() % 3U) == 0U ? FEB_CAN_FIFO_1 : FEB_CAN_FIFO_0);
+
+    uint32_t w = width_mask(t->id_type);
+    uint32_t spread = (t->id_type == FEB_CAN_ID_STD) ? 0x3FU : 0xFFFU;
+    t->id = (bases[rng_next() % 4U] + (rng_next() & spread)) & w;
+    t->mask = w;
+    if (allow_mask && (rng_next() % 5U) == 0U)
+    {
+      t->mask = w & ~((1U << (1U + rng_next() % 5U)) - 1U);
+      t->id &= t->mask;
+    }
+  }
+}
+
+static uint32_t group_count(const FEB_CAN_Filter_Term_t *terms, uint32_t n)
+{
+  uint8_t seen = 0;
+  for (uint32_t i = 0; i < n; i++)
+  {
+    seen |= (uint8_t)(1U << (terms[i].fifo * 2U + (terms[i].id_type == FEB_CAN_ID_STD ? 0U : 1U)));
+  }
+  return (uint32_t)__builtin_popcount(seen);
+}
+
+/* ============================================================================
+ * Plan Conformance
+ * ============================================================================ */
+
+typedef struct
+{
+  uint32_t plans;
+  uint32_t merged;
+  uint32_t accept_all;
+  uint32_t missed;      /* wanted ID not admitted on a FIFO that wants it */
+  uint32_t over_budget; /* bank_count > budget without accept_all */
+  uint32_t bad_accept;  /* accept_all although the groups fit, or not although they don't */
+  uint32_t bad_extra;   /* unwanted standard IDs admitted > extra_ids */
+  uint32_t bad_merge;   /* standard exact IDs that fit as lists were merged */
+  uint32_t hw_cases;
+  uint32_t hw_mismatch; /* bxCAN model disagrees with the plan */
+} test_stats_t;
+
+static test_stats_t stats;
+
+static void check_plan(const FEB_CAN_Filter_Term_t *terms, uint32_t n, uint8_t budget,
+                       const FEB_CAN_Filter_Plan_t *plan)
+{
+  stats.plans++;
+  stats.merged += (plan->merges > 0U) ? 1U : 0U;
+  stats.accept_all += plan->accept_all ? 1U : 0U;
+
+  bool groups_fit = group_count(terms, n) <= budget;
+  if (plan->accept_all == groups_fit)
+  {
+    stats.bad_accept++;
+  }
+  if (!plan->accept_all && plan->bank_count > budget)
+  {
+    stats.over_budget++;
+  }
+
+  /* The accept-all bank is on FIFO0; anything it admits is fine */
+  const uint8_t any_fifo = (uint8_t)((1U << FEB_CAN_FIFO_0) | (1U << FEB_CAN_FIFO_1));
+  uint32_t unwanted = 0;
+  for (uint32_t id = 0; id <= STD_MASK; id++)
+  {
+    uint8_t want = wanted_fifos(terms, n, id, FEB_CAN_ID_STD);
+    uint8_t admit = admitting_fifos(plan, id, FEB_CAN_ID_STD);
+    if (plan->accept_all && admit != 0U)
+    {
+      admit = any_fifo;
+    }
+    if (want != 0U && (want & admit) == 0U)
+    {
+      stats.missed++;
+    }
+    if (want == 0U && admit != 0U)
+    {
+      unwanted++;
+    }
+  }
+  if (!plan->accept_all && unwanted > plan->extra_ids)
+  {
+    stats.bad_extra++;
+  }
+
+  for (uint32_t i = 0; i < n; i++)
+  {
+    if (terms[i].id_type != FEB_CAN_ID_EXT)
+    {
+      continue;
+    }
+    for (uint32_t s = 0; s < TEST_EXT_SAMPLES; s++)
+    {
+      uint32_t id = (s == 0U) ? terms[i].id : term_sample(&terms[i]);
+      uint8_t want = wanted_fifos(terms, n, id, FEB_CAN_ID_EXT);
+      uint8_t admit = admitting_fifos(plan, id, FEB_CAN_ID_EXT);
+      if (plan->accept_all && admit != 0U)
+      {
+        admit = any_fifo;
+      }
+      if ((want & admit) == 0U)
+      {
+        stats.missed++;
+      }
+    }
+  }
+}
+
+/* Distinct standard exact IDs: lists cost ceil(E / 4) per FIFO, no merge needed */
+static void check_list_only(uint32_t n, uint8_t budget)
+{
+  FEB_CAN_Filter_Term_t terms[FEB_CAN_MAX_RX_HANDLES];
+  uint32_t per_fifo[2] = {0, 0};
+  for (uint32_t i = 0; i < n; i++)
+  {
+    bool dup;
+    do
+    {
+      terms[i].id = rng_next() & STD_MASK;
+      dup = false;
+      for (uint32_t j = 0; j < i; j++)
+      {
+        dup |= terms[j].id == terms[i].id;
+      }
+    } while (dup);
+    terms[i].mask = STD_MASK;
+    terms[i].id_type = FEB_CAN_ID_STD;
+    terms[i].fifo = (uint8_t)(rng_next() & 1U);
+    per_fifo[terms[i].fifo]++;
+  }
+
+  FEB_CAN_Filter_Plan_t plan;
+  FEB_CAN_Filter_Compile(terms, n, budget, &plan);
+  check_plan(terms, n, budget, &plan);
+
+  bool fits = (per_fifo[0] + 3U) / 4U + (per_fifo[1] + 3U) / 4U <= budget;
+  if (fits && (plan.merges != 0U || plan.extra_ids != 0U))
+  {
+    stats.bad_merge++;
+  }
+}
+
+static void run_plan_cases(void)
+{
+  for (uint32_t c = 0; c < TEST_PLAN_CASES; c++)
+  {
+    FEB_CAN_Filter_Term_t terms[FEB_CAN_MAX_RX_HANDLES];
+    uint32_t n = 1U + rng_next() % FEB_CAN_MAX_RX_HANDLES;
+    uint8_t budget = (uint8_t)(1U + c % TEST_MAX_BUDGET);
+
+    if ((c % 4U) == 3U)
+    {
+      check_list_only(n, budget);
+      continue;
+    }
+
+    gen_terms(terms, n, (c % 4U) != 0U, true);
+    FEB_CAN_Filter_Plan_t plan;
+    if (FEB_CAN_Filter_Compile(terms, n, budget, &plan) != FEB_CAN_OK)
+    {
+      stats.bad_accept++;
+      continue;
+    }
+    check_plan(terms, n, budget, &plan);
+  }
+}
+
+/* ============================================================================
+ * Hardware Conformance (host bxCAN model)
+ * ============================================================================ */
+
+static void hw_rx_callback(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                           const uint8_t *data, uint8_t length, void *user_data)
+{
+  (void)instance;
+  (void)can_id;
+  (void)id_type;
+  (void)data;
+  (void)length;
+  (void)user_data;
+}
+
+/* Offer one frame; returns the FIFO it landed in, or -1 if filtered */
+static int hw_offer(uint32_t id, uint8_t id_type)
+{
+  uint32_t before0 = HAL_CAN_GetRxFifoFillLevel(&hcan1, CAN_RX_FIFO0);
+  uint32_t before1 = HAL_CAN_GetRxFifoFillLevel(&hcan1, CAN_RX_FIFO1);
+  if (!FEB_Host_CAN_Receive(&hcan1, id, (id_type == FEB_CAN_ID_STD) ? CAN_ID_STD : CAN_ID_EXT, NULL, 0))
+  {
+    return -1;
+  }
+
+  int fifo = (HAL_CAN_GetRxFifoFillLevel(&hcan1, CAN_RX_FIFO1) > before1) ? 1 : 0;
+  (void)before0;
+  CAN_RxHeaderTypeDef header;
+  uint8_t data[8];
+  HAL_CAN_GetRxMessage(&hcan1, (fifo == 1) ? CAN_RX_FIFO1 : CAN_RX_FIFO0, &header, data);
+  return fifo;
+}
+
+static bool hw_agrees(const FEB_CAN_Filter_Plan_t *plan, uint32_t id, uint8_t id_type)
+{
+  int landed = hw_offer(id, id_type);
+  uint8_t admit = admitting_fifos(plan, id, id_type);
+  return (landed < 0) ? (admit == 0U) : ((admit >> landed) & 1U) != 0U;
+}
+
+static void run_hw_cases(void)
+{
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+
+  for (uint32_t c = 0; c < TEST_HW_CASES; c++)
+  {
+    FEB_CAN_Config_t cfg = {.hcan1 = &hcan1, .get_tick_ms = HAL_GetTick};
+    if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+    {
+      fprintf(stderr, "FEB_CAN_Init failed\n");
+      exit(2);
+    }
+    /* Leave received frames in the FIFOs so the test can see where they landed */
+    HAL_CAN_DeactivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING | CAN_IT_RX_FIFO1_MSG_PENDING);
+
+    FEB_CAN_Filter_Term_t terms[FEB_CAN_MAX_RX_HANDLES];
+    uint32_t n = 1U + rng_next() % FEB_CAN_MAX_RX_HANDLES;
+    gen_terms(terms, n, true, true);
+
+    /* The registry refuses a second handle on the same ID; compile what it kept */
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+      bool exact = terms[i].mask == width_mask(terms[i].id_type);
+      FEB_CAN_RX_Params_t params = {
+          .instance = FEB_CAN_INSTANCE_1,
+          .can_id = terms[i].id,
+          .id_type = (FEB_CAN_ID_Type_t)terms[i].id_type,
+          .filter_type = exact ? FEB_CAN_FILTER_EXACT : FEB_CAN_FILTER_MASK,
+          .mask = terms[i].mask,
+          .fifo = (FEB_CAN_FIFO_t)terms[i].fifo,
+          .callback = hw_rx_callback,
+      };
+      int32_t handle = FEB_CAN_RX_Register(&params);
+      if (handle >= 0)
+      {
+        terms[kept++] = terms[i];
+      }
+      else if (handle != -FEB_CAN_ERROR_ALREADY_EXISTS)
+      {
+        fprintf(stderr, "FEB_CAN_RX_Register failed: %s\n", FEB_CAN_StatusToString((FEB_CAN_Status_t)-handle));
+        exit(2);
+      }
+    }
+    n = kept;
+
+    FEB_CAN_Filter_Plan_t plan;
+    FEB_CAN_Filter_Compile(terms, n, TEST_MAX_BUDGET, &plan);
+
+    bool ok = true;
+    for (uint32_t id = 0; id <= STD_MASK; id++)
+    {
+      ok &= hw_agrees(&plan, id, FEB_CAN_ID_STD);
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+      for (uint32_t s = 0; s < TEST_EXT_SAMPLES; s++)
+      {
+        /* Extended IDs near every term, wanted or not */
+        uint32_t id = (s == 0U) ? terms[i].id : ((terms[i].id ^ (rng_next() & 0xFFU)) & EXT_MASK);
+        ok &= hw_agrees(&plan, id, FEB_CAN_ID_EXT);
+      }
+    }
+
+    stats.hw_cases++;
+    stats.hw_mismatch += ok ? 0U : 1U;
+    FEB_CAN_DeInit();
+  }
+}
+
+/* ============================================================================
+ * False-Admit Report
+ * ============================================================================ */
+
+static FEB_CAN_Message_t trace[TRACE_MAX_FRAMES];
+static uint32_t trace_len;
+
+/* The former scheme: one 32-bit mask bank per term in registration order */
+static void legacy_plan(const FEB_CAN_Filter_Term_t *terms, uint32_t n, uint8_t budget, FEB_CAN_Filter_Plan_t *plan)
+{
+  memset(plan, 0, sizeof(*plan));
+  for (uint32_t i = 0; i < n && plan->bank_count < budget; i++)
+  {
+    FEB_CAN_Filter_Bank_t *b = &plan->banks[plan->bank_count++];
+    b->kind = FEB_CAN_BANK_MASK32;
+    b->id_type = terms[i].id_type;
+    b->fifo = terms[i].fifo;
+    b->v[0] = terms[i].id;
+    b->v[1] = terms[i].mask & width_mask(terms[i].id_type);
+    b->v[2] = b->v[0];
+    b->v[3] = b->v[1];
+  }
+}
+
+static bool report(const char *name, const FEB_CAN_Filter_Term_t *terms, uint32_t n, uint8_t budget)
+{
+  FEB_CAN_Filter_Plan_t plan, legacy;
+  FEB_CAN_Filter_TraceStats_t s, ls;
+
+  FEB_CAN_Filter_Compile(terms, n, budget, &plan);
+  legacy_plan(terms, n, budget, &legacy);
+  FEB_CAN_Filter_EvaluateTrace(&plan, terms, n, trace, trace_len, &s);
+  FEB_CAN_Filter_EvaluateTrace(&legacy, terms, n, trace, trace_len, &ls);
+
+  double pct = s.admitted ? 100.0 * s.false_admits / s.admitted : 0.0;
+  double lpct = ls.admitted ? 100.0 * ls.false_admits / ls.admitted : 0.0;
+  printf("%s,%u,%u,%u,%u,%u,%u,%u,%u,%.2f,%u,%.2f,%u\n", name, n, budget, plan.bank_count, plan.merges, s.frames,
+         s.wanted, s.admitted, s.false_admits, pct, s.missed, lpct, ls.missed);
+  return s.missed == 0U;
+}
+
+/* 24 wanted IDs in clusters plus two ranges; other nodes own 80 more IDs */
+static bool report_synthetic(void)
+{
+  FEB_CAN_Filter_Term_t terms[26];
+  static const uint32_t clusters[] = {0x0A0U, 0x0D0U, 0x1E0U, 0x520U, 0x6F0U, 0x730U};
+  for (uint32_t i = 0; i < 24U; i++)
+  {
+    terms[i] = (FEB_CAN_Filter_Term_t){clusters[i % 6U] + (i / 6U) * 3U, STD_MASK, FEB_CAN_ID_STD, FEB_CAN_FIFO_0};
+  }
+  terms[24] = (FEB_CAN_Filter_Term_t){0x620U, 0x7F8U, FEB_CAN_ID_STD, FEB_CAN_FIFO_0};
+  terms[25] = (FEB_CAN_Filter_Term_t){0x18FF5000U, 0x1FFFFF00U, FEB_CAN_ID_EXT, FEB_CAN_FIFO_1};
+  const uint32_t n = 26U;
+
+  uint32_t other[REPORT_OTHER_IDS];
+  for (uint32_t i = 0; i < REPORT_OTHER_IDS; i++)
+  {
+    do
+    {
+      other[i] = rng_next() & STD_MASK;
+    } while (wanted_fifos(terms, n, other[i], FEB_CAN_ID_STD) != 0U);
+  }
+
+  trace_len = REPORT_FRAMES;
+  for (uint32_t f = 0; f < trace_len; f++)
+  {
+    memset(&trace[f], 0, sizeof(trace[f]));
+    trace[f].id_type = FEB_CAN_ID_STD;
+    if ((double)rng_next() / 4294967296.0 < REPORT_WANTED_SHARE)
+    {
+      const FEB_CAN_Filter_Term_t *t = &terms[rng_next() % n];
+      trace[f].can_id = term_sample(t);
+      trace[f].id_type = t->id_type;
+    }
+    else
+    {
+      trace[f].can_id = other[rng_next() % REPORT_OTHER_IDS];
+    }
+  }
+
+  bool ok = true;
+  for (uint32_t b = 0; b < sizeof(report_budgets); b++)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "synthetic_%ubanks", report_budgets[b]);
+    ok &= report(name, terms, n, report_budgets[b]);
+  }
+  return ok;
+}
+
+/* candump -L: "(1697040000.123456) can0 123#DEADBEEF" */
+static bool load_trace(const char *path)
+{
+  FILE *fp = fopen(path, "r");
+  if (fp == NULL)
+  {
+    return false;
+  }
+  char line[256];
+  trace_len = 0;
+  while (fgets(line, sizeof(line), fp) != NULL && trace_len < TRACE_MAX_FRAMES)
+  {
+    char *frame = strrchr(line, ' ');
+    char *hash = (frame != NULL) ? strchr(frame, '#') : NULL;
+    if (hash == NULL)
+    {
+      continue;
+    }
+    frame++;
+    memset(&trace[trace_len], 0, sizeof(trace[0]));
+    trace[trace_len].can_id = (uint32_t)strtoul(frame, NULL, 16);
+    trace[trace_len].id_type = (hash - frame > 3) ? FEB_CAN_ID_EXT : FEB_CAN_ID_STD;
+    trace_len++;
+  }
+  fclose(fp);
+  return true;
+}
+
+/* 123 | 520/7F0 | x18FF50E5 | x18FF0000/1FFF0000, optional @1 */
+static bool parse_term(const char *arg, FEB_CAN_Filter_Term_t *t)
+{
+  bool ext = (arg[0] == 'x' || arg[0] == 'X');
+  char *end;
+  t->id_type = ext ? FEB_CAN_ID_EXT : FEB_CAN_ID_STD;
+  t->id = (uint32_t)strtoul(ext ? arg + 1 : arg, &end, 16);
+  t->mask = width_mask(t->id_type);
+  t->fifo = FEB_CAN_FIFO_0;
+  if (*end == '/')
+  {
+    t->mask = (uint32_t)strtoul(end + 1, &end, 16) & width_mask(t->id_type);
+  }
+  if (*end == '@')
+  {
+    t->fifo = (uint8_t)((strtoul(end + 1, &end, 10) != 0U) ? FEB_CAN_FIFO_1 : FEB_CAN_FIFO_0);
+  }
+  return *end == '\0' && end != arg;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(int argc, char **argv)
+{
+  const char *trace_path = NULL;
+  unsigned budget = TEST_MAX_BUDGET;
+  FEB_CAN_Filter_Term_t user_terms[FEB_CAN_MAX_RX_HANDLES];
+  uint32_t user_n = 0;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+    {
+      trace_path = argv[++i];
+    }
+    else if (strcmp(argv[i], "--banks") == 0 && i + 1 < argc)
+    {
+      budget = (unsigned)strtoul(argv[++i], NULL, 0);
+    }
+    else if (user_n < FEB_CAN_MAX_RX_HANDLES && parse_term(argv[i], &user_terms[user_n]))
+    {
+      user_n++;
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [--banks N] [--trace candump.log] [term ...]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (budget == 0U || budget > FEB_CAN_FILTER_PLAN_MAX_BANKS || (trace_path != NULL && user_n == 0U))
+  {
+    fprintf(stderr, "need 1..%u banks, and terms with --trace\n", (unsigned)FEB_CAN_FILTER_PLAN_MAX_BANKS);
+    return 2;
+  }
+
+  FEB_Host_Time_UseVirtual(true);
+
+  run_plan_cases();
+  run_hw_cases();
+
+  printf("case,terms,budget,banks,merges,frames,wanted,admitted,false_admits,false_admit_pct,missed,"
+         "legacy_false_admit_pct,legacy_missed\n");
+  bool report_ok;
+  if (trace_path != NULL)
+  {
+    if (!load_trace(trace_path))
+    {
+      fprintf(stderr, "cannot read %s\n", trace_path);
+      return 2;
+    }
+    report_ok = report("trace", user_terms, user_n, (uint8_t)budget);
+  }
+  else
+  {
+    report_ok = report_synthetic();
+  }
+
+  uint32_t failures = stats.missed + stats.over_budget + stats.bad_accept + stats.bad_extra + stats.bad_merge +
+                      stats.hw_mismatch;
+  fprintf(stderr,
+          "%u plans (%u merged, %u accept-all): missed %u, over budget %u, bad accept-all %u, extra_ids low %u, "
+          "needless merge %u; bxCAN model %u/%u sets disagree\n",
+          stats.plans, stats.merged, stats.accept_all, stats.missed, stats.over_budget, stats.bad_accept,
+          stats.bad_extra, stats.bad_merge, stats.hw_mismatch, stats.hw_cases);
+
+  return (failures == 0U && report_ok) ? 0 : 1;
+}
@@ -0,0 +1,349 @@
+/**
+ ******************************************************************************
+ * @file           : can_rx_batch_bench.c
+ * @brief          : CAN RX bursts: per-frame osMessageQueue vs batch ring
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real FreeRTOS-mode feb_can RX path (FIFO ISR, queue or batch ring,
+ * dispatch) against the host bxCAN model in virtual time. Bursts of 1, 8 and
+ * 32 eight-byte frames arrive back to back at 500 kbit/s (270 us per frame,
+ * worst-case stuffing) every 10 ms, the way the RMS and BMS broadcast.
+ *
+ * The FIFO interrupt is taken either on every frame (isr_frames = 1, nothing
+ * masks it) or once the hardware FIFO holds 3 frames or the burst ends
+ * (isr_frames = 3, interrupts held off for two frame times). The RX task is
+ * the highest-priority ready task: it runs right after the interrupt that
+ * readied it.
+ *
+ * The build selects the library mode, so this file is built twice:
+ *
+ *   can_rx_batch_bench_queue (FEB_CAN_RX_BATCH=0)
+ *     queue_poll - ISR puts each frame on rx_queue; the RX task runs
+ *                  FEB_CAN_RX_Process + osDelay(1)
+ *     queue_wait - same ISR; the RX task blocks in FEB_CAN_RX_Wait
+ *   can_rx_batch_bench (FEB_CAN_RX_BATCH=1)
+ *     ring_wait  - ISR drains the FIFO into the ring, stamps each frame and
+ *                  sets one thread flag; the RX task blocks in FEB_CAN_RX_Wait
+ *
+ * isr_ns is host wall-clock time inside the FIFO callback (HAL read included),
+ * so compare modes rather than reading it as target cycles. stamp_err is how
+ * far FEB_CAN_RX_GetFrameTimeUs() lies from the frame's end of reception.
+ *
+ * usage: can_rx_batch_bench[_queue] [bursts]
+ *
+ * stdout: `mode,burst,isr_frames,frames,isr_calls,isr_ns_per_frame,isr_ns_p99,
+ *          wakeups_per_burst,wakeups_per_s,latency_max_us,stamp_err_max_us,dropped`
+ * stderr: summary. Exit status 1 if a frame was lost, duplicated or
+ *         reordered, or the ring overflowed; 2 on setup failure.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_can_lib.h"
+#include "feb_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_FRAME_US 270U     /* 8 data bytes, worst-case stuffing, 500 kbit/s */
+#define BENCH_PERIOD_US 10000U  /* one burst every 10 ms */
+#define BENCH_BURSTS 1000U      /* per row, default */
+#define BENCH_MAX_BURST 32U
+#define BENCH_HW_FIFO_DEPTH 3U
+#define BENCH_ID_BASE 0x0A0U    /* RMS-style broadcast block */
+#define BENCH_QUEUE_DEPTH 32U   /* canRxQueue depth in the board .ioc files */
+
+static const uint32_t burst_sizes[] = {1U, 8U, 32U};
+static const uint32_t isr_frames_opts[] = {1U, BENCH_HW_FIFO_DEPTH};
+
+typedef enum
+{
+  MODE_QUEUE_POLL,
+  MODE_QUEUE_WAIT,
+  MODE_RING_WAIT,
+} bench_mode_t;
+
+static const char *const mode_names[] = {"queue_poll", "queue_wait", "ring_wait"};
+
+#if FEB_CAN_RX_BATCH
+static const bench_mode_t modes[] = {MODE_RING_WAIT};
+#else
+static const bench_mode_t modes[] = {MODE_QUEUE_POLL, MODE_QUEUE_WAIT};
+#endif
+
+CAN_HandleTypeDef hcan1;
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint64_t wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t virtual_us(void)
+{
+  return FEB_Host_Time_Ns() / 1000U;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* ============================================================================
+ * Run
+ * ============================================================================ */
+
+typedef struct
+{
+  uint32_t frames;
+  uint32_t isr_calls;
+  double isr_ns_per_frame;
+  uint32_t isr_ns_p99;
+  double wakeups_per_burst;
+  double wakeups_per_s;
+  uint32_t latency_max_us;
+  uint32_t stamp_err_max_us;
+  uint32_t dropped;
+  uint32_t bad_order; /* lost, duplicated or reordered */
+} bench_result_t;
+
+static uint64_t arrival_us[BENCH_BURSTS * 4U * BENCH_MAX_BURST];
+static uint32_t isr_ns[BENCH_BURSTS * 4U * BENCH_MAX_BURST];
+static uint32_t next_seq;
+static bench_result_t *cur;
+
+static void rx_callback(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                        const uint8_t *data, uint8_t length, void *user_data)
+{
+  (void)instance;
+  (void)can_id;
+  (void)id_type;
+  (void)length;
+  (void)user_data;
+
+  uint32_t seq;
+  memcpy(&seq, data, sizeof(seq));
+  if (seq != next_seq)
+  {
+    cur->bad_order++;
+  }
+  next_seq = seq + 1U;
+
+  uint64_t now = virtual_us();
+  uint64_t stamp = FEB_CAN_RX_GetFrameTimeUs();
+  uint32_t latency = (uint32_t)(now - arrival_us[seq]);
+  uint32_t err = (uint32_t)((stamp > arrival_us[seq]) ? stamp - arrival_us[seq] : arrival_us[seq] - stamp);
+  cur->latency_max_us = (latency > cur->latency_max_us) ? latency : cur->latency_max_us;
+  cur->stamp_err_max_us = (err > cur->stamp_err_max_us) ? err : cur->stamp_err_max_us;
+  cur->frames++;
+}
+
+static void fifo_isr(void)
+{
+  FEB_Host_ISR_Enter();
+  uint64_t t0 = wall_ns();
+  HAL_CAN_RxFifo0MsgPendingCallback(&hcan1);
+  uint64_t t1 = wall_ns();
+  FEB_Host_ISR_Exit();
+  isr_ns[cur->isr_calls++] = (uint32_t)(t1 - t0);
+}
+
+static void advance_to(uint64_t t_us)
+{
+  uint64_t now = virtual_us();
+  if (t_us > now)
+  {
+    FEB_Host_Time_AdvanceUs((uint32_t)(t_us - now));
+  }
+}
+
+static bench_result_t run(bench_mode_t mode, uint32_t burst, uint32_t isr_frames, uint32_t bursts)
+{
+  bench_result_t r = {0};
+  cur = &r;
+  next_seq = 0;
+
+  osMessageQueueId_t tx_queue = osMessageQueueNew(16, sizeof(FEB_CAN_Message_t), NULL);
+  osMessageQueueId_t rx_queue = osMessageQueueNew(BENCH_QUEUE_DEPTH, sizeof(FEB_CAN_Message_t), NULL);
+  osMutexId_t tx_mutex = osMutexNew(NULL);
+  osMutexId_t rx_mutex = osMutexNew(NULL);
+  osSemaphoreId_t tx_sem = osSemaphoreNew(3, 3, NULL);
+
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+  FEB_CAN_Config_t cfg = {
+      .hcan1 = &hcan1,
+      .get_tick_ms = HAL_GetTick,
+      .get_time_us = virtual_us,
+      .tx_queue = tx_queue,
+      .rx_queue = FEB_CAN_RX_BATCH ? NULL : rx_queue,
+      .tx_mutex = tx_mutex,
+      .rx_mutex = rx_mutex,
+      .tx_mailbox_sem = tx_sem,
+  };
+  if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+  {
+    fprintf(stderr, "FEB_CAN_Init failed\n");
+    exit(2);
+  }
+  /* The bench takes the FIFO interrupt itself, so it can hold it off */
+  HAL_CAN_DeactivateNotification(&hcan1, CAN_IT_RX_FIFO0_MSG_PENDING | CAN_IT_RX_FIFO1_MSG_PENDING);
+
+  for (uint32_t k = 0; k < burst; k++)
+  {
+    FEB_CAN_RX_Params_t params = {
+        .instance = FEB_CAN_INSTANCE_1,
+        .can_id = BENCH_ID_BASE + k,
+        .id_type = FEB_CAN_ID_STD,
+        .filter_type = FEB_CAN_FILTER_EXACT,
+        .fifo = FEB_CAN_FIFO_0,
+        .callback = rx_callback,
+    };
+    if (FEB_CAN_RX_Register(&params) < 0)
+    {
+      fprintf(stderr, "FEB_CAN_RX_Register failed\n");
+      exit(2);
+    }
+  }
+
+  /* Idle the first tick so every mode starts on a tick boundary */
+  uint64_t t0 = virtual_us() + 1000U;
+  uint64_t poll_us = t0;
+  uint32_t polls = 0;
+  uint32_t seq = 0;
+
+  for (uint32_t b = 0; b < bursts; b++)
+  {
+    uint64_t burst_start = t0 + (uint64_t)b * BENCH_PERIOD_US;
+    for (uint32_t k = 0; k < burst; k++)
+    {
+      uint64_t t = burst_start + (uint64_t)(k + 1U) * BENCH_FRAME_US;
+
+      /* The former RX task polled every tick, frames or not */
+      while (mode == MODE_QUEUE_POLL && poll_us <= t)
+      {
+        advance_to(poll_us);
+        FEB_CAN_RX_Process();
+        polls++;
+        poll_us += 1000U;
+      }
+
+      advance_to(t);
+      uint8_t data[8] = {0};
+      memcpy(data, &seq, sizeof(seq));
+      arrival_us[seq++] = t;
+      FEB_Host_CAN_Receive(&hcan1, BENCH_ID_BASE + k, CAN_ID_STD, data, 8);
+
+      bool last = (k + 1U == burst);
+      if (HAL_CAN_GetRxFifoFillLevel(&hcan1, CAN_RX_FIFO0) < isr_frames && !last)
+      {
+        continue;
+      }
+      fifo_isr();
+      if (mode != MODE_QUEUE_POLL)
+      {
+        FEB_CAN_RX_Wait(0);
+      }
+    }
+  }
+
+  /* Let the poller collect the last burst */
+  uint64_t end = t0 + (uint64_t)bursts * BENCH_PERIOD_US;
+  while (mode == MODE_QUEUE_POLL && poll_us <= end)
+  {
+    advance_to(poll_us);
+    FEB_CAN_RX_Process();
+    polls++;
+    poll_us += 1000U;
+  }
+  advance_to(end);
+
+  FEB_CAN_RX_BatchStats_t stats;
+  FEB_CAN_GetRxBatchStats(&stats);
+  uint32_t wakeups = (mode == MODE_QUEUE_POLL) ? polls : stats.wakeups;
+
+  uint64_t isr_total = 0;
+  for (uint32_t i = 0; i < r.isr_calls; i++)
+  {
+    isr_total += isr_ns[i];
+  }
+  qsort(isr_ns, r.isr_calls, sizeof(isr_ns[0]), cmp_u32);
+
+  r.isr_ns_per_frame = (seq > 0U) ? (double)isr_total / seq : 0.0;
+  r.isr_ns_p99 = (r.isr_calls > 0U) ? isr_ns[(r.isr_calls - 1U) * 99U / 100U] : 0U;
+  r.wakeups_per_burst = (double)wakeups / bursts;
+  r.wakeups_per_s = (double)wakeups * 1e6 / (double)(end - t0);
+  r.dropped = FEB_CAN_GetRxQueueOverflowCount();
+  if (r.frames + r.dropped != seq)
+  {
+    r.bad_order++;
+  }
+
+  FEB_CAN_DeInit();
+  osMessageQueueDelete(tx_queue);
+  osMessageQueueDelete(rx_queue);
+  osMutexDelete(tx_mutex);
+  osMutexDelete(rx_mutex);
+  osSemaphoreDelete(tx_sem);
+  return r;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(int argc, char **argv)
+{
+  uint32_t bursts = BENCH_BURSTS;
+  if (argc > 1)
+  {
+    bursts = (uint32_t)strtoul(argv[1], NULL, 0);
+  }
+  if (bursts == 0U || bursts > BENCH_BURSTS * 4U)
+  {
+    fprintf(stderr, "usage: %s [bursts (1..%u)]\n", argv[0], BENCH_BURSTS * 4U);
+    return 2;
+  }
+
+  FEB_Host_Time_UseVirtual(true);
+
+  printf("mode,burst,isr_frames,frames,isr_calls,isr_ns_per_frame,isr_ns_p99,wakeups_per_burst,wakeups_per_s,"
+         "latency_max_us,stamp_err_max_us,dropped\n");
+
+  int status = 0;
+  for (uint32_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+  {
+    for (uint32_t f = 0; f < sizeof(isr_frames_opts) / sizeof(isr_frames_opts[0]); f++)
+    {
+      for (uint32_t s = 0; s < sizeof(burst_sizes) / sizeof(burst_sizes[0]); s++)
+      {
+        bench_result_t r = run(modes[m], burst_sizes[s], isr_frames_opts[f], bursts);
+        printf("%s,%u,%u,%u,%u,%.1f,%u,%.2f,%.0f,%u,%u,%u\n", mode_names[modes[m]], burst_sizes[s],
+               isr_frames_opts[f], r.frames, r.isr_calls, r.isr_ns_per_frame, r.isr_ns_p99, r.wakeups_per_burst,
+               r.wakeups_per_s, r.latency_max_us, r.stamp_err_max_us, r.dropped);
+        fprintf(stderr, "%-10s burst %2u, %u/ISR: %6.1f ns/frame in ISR, %5.2f wakeups/burst, latency max %u us\n",
+                mode_names[modes[m]], burst_sizes[s], isr_frames_opts[f], r.isr_ns_per_frame, r.wakeups_per_burst,
+                r.latency_max_us);
+        if (r.bad_order != 0U || (FEB_CAN_RX_BATCH && r.dropped != 0U))
+        {
+          status = 1;
+        }
+      }
+    }
+  }
+  return status;
+}
@@ -0,0 +1,416 @@
+/**
+ ******************************************************************************
+ * @file           : can_rx_dispatch_bench.c
+ * @brief          : feb_can RX dispatch: former handle scan vs hashed index
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real feb_can_rx_dispatch() (bare-metal build, as the PCU and the
+ * LVPDB compile it) against a copy of the linear scan it replaced:
+ *
+ *   timing - 8, 32 and 128 exact handles on random standard IDs, dispatched
+ *            a shuffled stream of frames for those IDs. Both paths invoke the
+ *            same counting callback, and every frame must reach exactly one
+ *            handle on both. The library is built with
+ *            FEB_CAN_MAX_RX_HANDLES = 128 so all three counts fit; the former
+ *            scan walked every slot, so its cost tracks that maximum rather
+ *            than the registered count.
+ *   stress - the main thread toggles one extra handle and rebuilds the
+ *            index as fast as it can while a timer signal, standing in for
+ *            the RX interrupt, dispatches frames for 32 handles that never change.
+ *            Once with a copy of the former in-place rebuild (memset, then
+ *            refill the live index) and once with the real double-buffered
+ *            rebuild. `missed` counts frames that reached no handler.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted;
+ * compare the columns with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `handles,frames,mismatches,scan_ns,index_ns`, then
+ *         `stress,rebuild,dispatches,rebuilds,missed`
+ * stderr: summary. Exit status 1 on any mismatch or any frame missed with the
+ *         double-buffered rebuild.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_can_internal.h"
+#include "feb_can_lib.h"
+#include "feb_host.h"
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+static const uint32_t bench_counts[] = {8U, 32U, 128U};
+#define BENCH_COUNTS (sizeof(bench_counts) / sizeof(bench_counts[0]))
+
+#define BENCH_TIMING_FRAMES 4096U
+#define BENCH_TIMING_REPS 500U
+#define BENCH_STRESS_HANDLES 32U
+#define BENCH_STRESS_DISPATCHES 20000U
+#define BENCH_STRESS_FRAME_US 20L
+
+#if FEB_CAN_MAX_RX_HANDLES < 128
+#error "can_rx_dispatch_bench needs FEB_CAN_MAX_RX_HANDLES >= 128"
+#endif
+
+CAN_HandleTypeDef hcan1;
+
+static uint32_t bench_ids[FEB_CAN_MAX_RX_HANDLES];
+static uint32_t timing_frames[BENCH_TIMING_FRAMES];
+
+/* Per-frame hit count, reset before each dispatch */
+static volatile uint32_t hits;
+
+static void bench_rx_callback(FEB_CAN_Instance_t instance, uint32_t can_id, FEB_CAN_ID_Type_t id_type,
+                              const uint8_t *data, uint8_t length, void *user_data)
+{
+  (void)instance;
+  (void)can_id;
+  (void)id_type;
+  (void)data;
+  (void)length;
+  (void)user_data;
+  hits++;
+}
+
+/* The filter packer tracks at most 64 terms, so it is left out of this build.
+ * Registration still reprograms the filter banks; with no plan it gives up and
+ * leaves them as they were, which the dispatch path never looks at. */
+FEB_CAN_Status_t FEB_CAN_Filter_Compile(const FEB_CAN_Filter_Term_t *terms, uint32_t count, uint8_t max_banks,
+                                        FEB_CAN_Filter_Plan_t *plan)
+{
+  (void)terms;
+  (void)count;
+  (void)max_banks;
+  (void)plan;
+  return FEB_CAN_ERROR;
+}
+
+/* ============================================================================
+ * Reference: the former linear scan and in-place rebuild
+ * ============================================================================ */
+
+static void scan_dispatch(FEB_CAN_Instance_t instance, uint32_t can_id, uint8_t id_type, const uint8_t *data,
+                          uint8_t length, uint32_t timestamp)
+{
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+  (void)timestamp;
+
+  for (uint32_t i = 0; i < FEB_CAN_MAX_RX_HANDLES; i++)
+  {
+    FEB_CAN_RX_Handle_Internal_t *handle = &ctx->rx_handles[i];
+
+    if (!handle->is_active || handle->instance != instance || handle->id_type != id_type)
+      continue;
+
+    bool match = false;
+    switch (handle->filter_type)
+    {
+    case FEB_CAN_FILTER_EXACT:
+      match = (can_id == handle->can_id);
+      break;
+    case FEB_CAN_FILTER_MASK:
+      match = ((can_id & handle->mask) == (handle->can_id & handle->mask));
+      break;
+    case FEB_CAN_FILTER_WILDCARD:
+      match = true;
+      break;
+    default:
+      break;
+    }
+
+    if (!match)
+      continue;
+
+    FEB_CAN_RX_Callback_t cb = (FEB_CAN_RX_Callback_t)handle->callback;
+    if (cb != NULL)
+      cb(instance, can_id, (FEB_CAN_ID_Type_t)id_type, data, length, handle->user_data);
+  }
+}
+
+static inline uint32_t inplace_hash(uint8_t instance, uint8_t id_type, uint32_t can_id)
+{
+  uint32_t key = can_id ^ ((uint32_t)id_type << 29) ^ ((uint32_t)instance << 30);
+  return (key * 2654435761u) >> (32u - FEB_CAN_RX_HASH_BITS);
+}
+
+/* The rebuild before double buffering: clears and refills the index dispatch
+ * is reading. Exact handles only, which is all the stress registers. */
+static void inplace_rebuild(void)
+{
+  FEB_CAN_Context_t *ctx = feb_can_get_context();
+  FEB_CAN_RX_Index_t *idx = ctx->rx_index_live;
+
+  memset(idx->hash, FEB_CAN_RX_INDEX_EMPTY, sizeof(idx->hash));
+  memset(idx->chain, FEB_CAN_RX_INDEX_EMPTY, sizeof(idx->chain));
+  idx->slow_count = 0;
+
+  for (uint32_t i = 0; i < FEB_CAN_MAX_RX_HANDLES; i++)
+  {
+    const FEB_CAN_RX_Handle_Internal_t *h = &ctx->rx_handles[i];
+    if (!h->is_active)
+      continue;
+
+    uint32_t bucket = inplace_hash(h->instance, h->id_type, h->can_id);
+    while (idx->hash[bucket] != FEB_CAN_RX_INDEX_EMPTY)
+      bucket = (bucket + 1u) & (FEB_CAN_RX_HASH_SIZE - 1u);
+    idx->hash[bucket] = (uint8_t)i;
+  }
+}
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint32_t rng_state = 0x2545F491u;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+/* Distinct random standard IDs, so the hash sees no convenient pattern */
+static void pick_ids(void)
+{
+  for (uint32_t i = 0; i < FEB_CAN_MAX_RX_HANDLES; i++)
+  {
+    uint32_t id;
+    bool dup;
+    do
+    {
+      id = rng_next() & 0x7FFu;
+      dup = false;
+      for (uint32_t j = 0; j < i; j++)
+        dup = dup || (bench_ids[j] == id);
+    } while (dup);
+    bench_ids[i] = id;
+  }
+}
+
+static int32_t register_id(uint32_t id)
+{
+  FEB_CAN_RX_Params_t params = {
+      .instance = FEB_CAN_INSTANCE_1,
+      .can_id = id,
+      .id_type = FEB_CAN_ID_STD,
+      .filter_type = FEB_CAN_FILTER_EXACT,
+      .callback = bench_rx_callback,
+  };
+  return FEB_CAN_RX_Register(&params);
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+typedef void (*dispatch_fn_t)(FEB_CAN_Instance_t, uint32_t, uint8_t, const uint8_t *, uint8_t, uint32_t);
+
+static uint64_t count_mismatches(dispatch_fn_t fn)
+{
+  static const uint8_t data[8] = {0};
+  uint64_t mismatches = 0;
+  for (uint32_t i = 0; i < BENCH_TIMING_FRAMES; i++)
+  {
+    hits = 0;
+    fn(FEB_CAN_INSTANCE_1, timing_frames[i], FEB_CAN_ID_STD, data, 8u, 0u);
+    if (hits != 1u)
+      mismatches++;
+  }
+  return mismatches;
+}
+
+static double time_dispatch(dispatch_fn_t fn)
+{
+  static const uint8_t data[8] = {0};
+  uint64_t best = UINT64_MAX;
+  for (uint32_t r = 0; r < BENCH_TIMING_REPS; r++)
+  {
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_TIMING_FRAMES; i++)
+      fn(FEB_CAN_INSTANCE_1, timing_frames[i], FEB_CAN_ID_STD, data, 8u, 0u);
+    uint64_t dt = now_ns() - t0 - clock_overhead_ns;
+    if (dt < best)
+      best = dt;
+  }
+  return (double)best / BENCH_TIMING_FRAMES;
+}
+
+/* ============================================================================
+ * Stress
+ * ============================================================================
+ *
+ * On the target the RX interrupt preempts whatever task is rebuilding and runs
+ * to completion before the rebuild resumes. A host thread would instead run
+ * beside the rebuild, so the interrupt is modelled as a timer signal on the
+ * rebuilding thread: the handler dispatches one frame wherever the rebuild
+ * happens to be. */
+
+static volatile uint32_t stress_dispatches;
+static volatile uint32_t stress_missed;
+
+static void stress_rx_isr(int sig)
+{
+  static const uint8_t data[8] = {0};
+  (void)sig;
+
+  if (stress_dispatches >= BENCH_STRESS_DISPATCHES)
+    return;
+
+  hits = 0;
+  feb_can_rx_dispatch(FEB_CAN_INSTANCE_1, bench_ids[rng_next() % BENCH_STRESS_HANDLES], FEB_CAN_ID_STD, data,
+                      8u, 0u);
+  if (hits == 0u)
+    stress_missed++;
+  stress_dispatches++;
+}
+
+/* Toggles one handle and rebuilds, as Register/Unregister would, until the
+ * bus has delivered BENCH_STRESS_DISPATCHES frames */
+static uint64_t run_stress(void (*rebuild)(void), int32_t churn_slot, uint64_t *rebuilds)
+{
+  FEB_CAN_RX_Handle_Internal_t *churn = &feb_can_get_context()->rx_handles[churn_slot];
+
+  stress_dispatches = 0;
+  stress_missed = 0;
+  signal(SIGALRM, stress_rx_isr);
+
+  /* The bus: a frame every BENCH_STRESS_FRAME_US */
+  timer_t bus;
+  struct sigevent sev = {.sigev_notify = SIGEV_SIGNAL, .sigev_signo = SIGALRM};
+  struct itimerspec its = {.it_interval = {.tv_nsec = BENCH_STRESS_FRAME_US * 1000L},
+                           .it_value = {.tv_nsec = BENCH_STRESS_FRAME_US * 1000L}};
+  timer_create(CLOCK_MONOTONIC, &sev, &bus);
+  timer_settime(bus, 0, &its, NULL);
+
+  *rebuilds = 0;
+  while (stress_dispatches < BENCH_STRESS_DISPATCHES)
+  {
+    churn->is_active = !churn->is_active;
+    rebuild();
+    (*rebuilds)++;
+  }
+
+  timer_delete(bus);
+  signal(SIGALRM, SIG_IGN);
+
+  churn->is_active = true;
+  rebuild();
+  return stress_missed;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  FEB_Host_CAN_InitHandle(&hcan1, CAN1);
+  FEB_CAN_Config_t cfg = {.hcan1 = &hcan1, .get_tick_ms = HAL_GetTick};
+  if (FEB_CAN_Init(&cfg) != FEB_CAN_OK)
+  {
+    fprintf(stderr, "FEB_CAN_Init failed\n");
+    return 2;
+  }
+
+  pick_ids();
+  calibrate_clock();
+
+  uint64_t total_mismatches = 0;
+  uint32_t registered = 0;
+
+  printf("handles,frames,mismatches,scan_ns,index_ns\n");
+  for (uint32_t c = 0; c < BENCH_COUNTS; c++)
+  {
+    for (; registered < bench_counts[c]; registered++)
+    {
+      if (register_id(bench_ids[registered]) < 0)
+      {
+        fprintf(stderr, "FEB_CAN_RX_Register failed at handle %u\n", (unsigned)registered);
+        return 2;
+      }
+    }
+
+    for (uint32_t i = 0; i < BENCH_TIMING_FRAMES; i++)
+      timing_frames[i] = bench_ids[rng_next() % registered];
+
+    uint64_t mismatches = count_mismatches(scan_dispatch) + count_mismatches(feb_can_rx_dispatch);
+    double scan_ns = time_dispatch(scan_dispatch);
+    double index_ns = time_dispatch(feb_can_rx_dispatch);
+    total_mismatches += mismatches;
+
+    printf("%u,%u,%llu,%.1f,%.1f\n", (unsigned)registered, (unsigned)BENCH_TIMING_FRAMES,
+           (unsigned long long)mismatches, scan_ns, index_ns);
+    fprintf(stderr, "%3u handles  scan %6.1f ns/frame  index %5.1f ns/frame  (%.1fx)\n", (unsigned)registered,
+            scan_ns, index_ns, scan_ns / index_ns);
+  }
+
+  /* Stress: only the first BENCH_STRESS_HANDLES stay registered, plus churn */
+  for (uint32_t i = BENCH_STRESS_HANDLES; i < registered; i++)
+  {
+    int32_t slot = -1;
+    FEB_CAN_Context_t *ctx = feb_can_get_context();
+    for (uint32_t s = 0; s < FEB_CAN_MAX_RX_HANDLES; s++)
+    {
+      if (ctx->rx_handles[s].is_active && ctx->rx_handles[s].can_id == bench_ids[i])
+        slot = (int32_t)s;
+    }
+    FEB_CAN_RX_Unregister(slot);
+  }
+  int32_t churn_slot = register_id(bench_ids[BENCH_STRESS_HANDLES]);
+
+  uint64_t inplace_rebuilds;
+  uint64_t swap_rebuilds;
+  uint64_t inplace_missed = run_stress(inplace_rebuild, churn_slot, &inplace_rebuilds);
+  uint64_t swap_missed = run_stress(feb_can_rx_index_rebuild, churn_slot, &swap_rebuilds);
+
+  printf("stress,rebuild,dispatches,rebuilds,missed\n");
+  printf("stress,inplace,%u,%llu,%llu\n", (unsigned)BENCH_STRESS_DISPATCHES, (unsigned long long)inplace_rebuilds,
+         (unsigned long long)inplace_missed);
+  printf("stress,swap,%u,%llu,%llu\n", (unsigned)BENCH_STRESS_DISPATCHES, (unsigned long long)swap_rebuilds,
+         (unsigned long long)swap_missed);
+  fprintf(stderr, "rebuild during dispatch: in-place %llu missed / %llu rebuilds, swap %llu missed / %llu rebuilds\n",
+          (unsigned long long)inplace_missed, (unsigned long long)inplace_rebuilds, (unsigned long long)swap_missed,
+          (unsigned long long)swap_rebuilds);
+
+  if (total_mismatches != 0 || swap_missed != 0)
+  {
+    fprintf(stderr, "FAIL: %llu mismatches, %llu frames missed with the double-buffered index\n",
+            (unsigned long long)total_mismatches, (unsigned long long)swap_missed);
+    return 1;
+  }
+  return 0;
+}
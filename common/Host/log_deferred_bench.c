@@ -0,0 +1,457 @@
+/**
+ ******************************************************************************
+ * @file           : log_deferred_bench.c
+ * @brief          : feb_log immediate vs deferred: output, per-call cost, ring
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Runs the real feb_log.c built with FEB_LOG_DEFERRED=1 in FreeRTOS mode, as
+ * the BMS builds it, with a capturing output callback in place of the UART:
+ *
+ *   decode - every format case below is logged once immediately and once
+ *            deferred. The deferred record is expanded by FEB_Log_Process()
+ *            (the decoder) and must match the immediate line byte for byte.
+ *   timing - ns per call for a few call shapes. `immediate_ns` is the full
+ *            LOG_x cost minus the UART (the callback only counts bytes).
+ *            `deferred_ns` is the call-site cost of recording into the ring,
+ *            and `drain_ns` the per-message cost FEB_Log_Process() pays
+ *            later in the low-priority task.
+ *   stress - BENCH_PRODUCERS threads, one bracketed as an ISR, log numbered
+ *            messages into a ring small enough to overflow while the main
+ *            thread drains. Every message must come out once, in order per
+ *            producer, or be counted in a "messages dropped" line.
+ *
+ * Times are host wall-clock with the cost of reading the clock subtracted;
+ * compare the columns with each other, not with Cortex-M4 cycles.
+ *
+ * stdout: `call,immediate_ns,deferred_ns,drain_ns`, then
+ *         `decode,cases,mismatches`, then
+ *         `stress,producers,sent,printed,dropped,lost,out_of_order`
+ * stderr: summary. Exit status 1 on any decode mismatch or any stress
+ *         message lost, duplicated or reordered.
+ *
+ ******************************************************************************
+ */
+
+#include "cmsis_os2.h"
+#include "feb_host.h"
+#include "feb_log.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if !FEB_LOG_DEFERRED
+#error "log_deferred_bench needs FEB_LOG_DEFERRED=1"
+#endif
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_TIMING_CALLS 2000U /* Fits the ring, so no call is dropped */
+#define BENCH_TIMING_REPS 50U
+#define BENCH_PRODUCERS 4U
+#define BENCH_STRESS_MESSAGES 200000U /* Per producer */
+#define BENCH_CAPTURE_BYTES 512U
+
+static uint32_t bench_tick = 123456U;
+
+static uint32_t bench_get_tick(void)
+{
+  return bench_tick;
+}
+
+/* ============================================================================
+ * Output Capture
+ * ============================================================================ */
+
+typedef enum
+{
+  CAPTURE_DISCARD,
+  CAPTURE_LINE,
+  CAPTURE_STRESS,
+} capture_mode_t;
+
+static capture_mode_t capture_mode;
+static char capture[BENCH_CAPTURE_BYTES];
+static size_t capture_len;
+static volatile uint64_t capture_bytes;
+
+/* Stress bookkeeping, updated only from the draining thread */
+static uint32_t stress_next[BENCH_PRODUCERS];
+static uint64_t stress_printed;
+static uint64_t stress_dropped;
+static uint64_t stress_out_of_order;
+
+static void stress_parse(const char *data, size_t len)
+{
+  char line[BENCH_CAPTURE_BYTES];
+  size_t n = (len < sizeof(line) - 1u) ? len : sizeof(line) - 1u;
+  memcpy(line, data, n);
+  line[n] = '\0';
+
+  unsigned producer;
+  unsigned seq;
+  unsigned long lost;
+  const char *msg = strstr(line, "stress p");
+  const char *drop = strstr(line, " messages dropped");
+  if (msg != NULL && sscanf(msg, "stress p%u n%u", &producer, &seq) == 2 && producer < BENCH_PRODUCERS)
+  {
+    /* A gap is fine (dropped); going backwards or repeating is not */
+    if (seq < stress_next[producer])
+      stress_out_of_order++;
+    else
+      stress_next[producer] = seq + 1u;
+    stress_printed++;
+  }
+  else if (drop != NULL)
+  {
+    const char *p = drop;
+    while (p > line && p[-1] >= '0' && p[-1] <= '9')
+      p--;
+    if (sscanf(p, "%lu", &lost) == 1)
+      stress_dropped += lost;
+  }
+}
+
+static int bench_output(const char *data, size_t len)
+{
+  capture_bytes += len;
+  switch (capture_mode)
+  {
+  case CAPTURE_LINE:
+    if (capture_len + len <= sizeof(capture))
+    {
+      memcpy(capture + capture_len, data, len);
+      capture_len += len;
+    }
+    break;
+  case CAPTURE_STRESS:
+    stress_parse(data, len);
+    break;
+  default:
+    break;
+  }
+  return (int)len;
+}
+
+/* ============================================================================
+ * Decode Cases
+ * ============================================================================ */
+
+#define BENCH_CASE(name, level, ...)                                                                                   \
+  static void name(void)                                                                                               \
+  {                                                                                                                    \
+    FEB_Log_Output(level, "[BENCH]", ((level) <= FEB_LOG_WARN) ? "bench.c" : NULL,                                     \
+                   ((level) <= FEB_LOG_WARN) ? __LINE__ : 0, __VA_ARGS__);                                             \
+  }
+
+BENCH_CASE(case_literal, FEB_LOG_INFO, "literal text, no conversions")
+BENCH_CASE(case_int, FEB_LOG_INFO, "%d %i %u %x %X %o %c", -42, 7, 4000000000u, 0xBEEFu, 0xABCu, 8u, 'q')
+BENCH_CASE(case_long, FEB_LOG_INFO, "%ld %lu %lx", -123456789L, 123456789UL, 0xDEADBEEFUL)
+BENCH_CASE(case_llong, FEB_LOG_INFO, "%lld %llu %llx", -1234567890123LL, 9876543210ULL, 0xFEEDFACECAFEULL)
+BENCH_CASE(case_sized, FEB_LOG_INFO, "%zu %jd %ju %td", (size_t)123, (intmax_t)-77, (uintmax_t)77, (ptrdiff_t)-9)
+BENCH_CASE(case_short, FEB_LOG_INFO, "%hhd %hhu %hd %hu", -3, 250, -300, 60000)
+BENCH_CASE(case_double, FEB_LOG_INFO, "%f %.3f %e %g %10.2f %a", 3.14159, 2.5, 12345.678, 0.0001, -1.5, 0.75)
+BENCH_CASE(case_ldouble, FEB_LOG_INFO, "%Lf %.2Le", (long double)1.25L, (long double)-6.5e10L)
+BENCH_CASE(case_star, FEB_LOG_INFO, "%*d|%-*d|%.*f|%*.*s|", 6, 42, 4, 7, 2, 3.14159, 8, 3, "abcdef")
+BENCH_CASE(case_percent, FEB_LOG_INFO, "100%% done, %d%% left", 0)
+BENCH_CASE(case_ptr, FEB_LOG_INFO, "%p %p", (void *)0x1234, (void *)NULL)
+BENCH_CASE(case_string, FEB_LOG_INFO, "%s|%10s|%-6s|%.3s|%s", "abc", "right", "left", "truncate", "")
+/* Through a volatile so the compiler cannot see the NULL and warn about it */
+static const char *volatile bench_null_str = NULL;
+BENCH_CASE(case_null_string, FEB_LOG_INFO, "[%s]", bench_null_str)
+BENCH_CASE(case_error, FEB_LOG_ERROR, "cell %u over %u mV", 17u, 4250u)
+BENCH_CASE(case_warn, FEB_LOG_WARN, "%s: %ld retries", "isoSPI", 3L)
+BENCH_CASE(case_adbms, FEB_LOG_INFO, "bank %u cell %u %ld uV %.1f C", 3u, 11u, 3712345L, 31.5)
+
+typedef struct
+{
+  const char *name;
+  void (*fn)(void);
+} bench_case_t;
+
+static const bench_case_t bench_cases[] = {
+    {"literal", case_literal}, {"int", case_int},         {"long", case_long},
+    {"llong", case_llong},     {"sized", case_sized},     {"short", case_short},
+    {"double", case_double},   {"ldouble", case_ldouble}, {"star", case_star},
+    {"percent", case_percent}, {"ptr", case_ptr},         {"string", case_string},
+    {"null_string", case_null_string}, {"error", case_error}, {"warn", case_warn},
+    {"adbms", case_adbms},
+};
+#define BENCH_CASES (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+static uint32_t check_decode(void)
+{
+  char immediate[BENCH_CAPTURE_BYTES];
+  size_t immediate_len;
+  uint32_t mismatches = 0;
+
+  capture_mode = CAPTURE_LINE;
+  for (uint32_t c = 0; c < BENCH_CASES; c++)
+  {
+    FEB_Log_SetDeferred(false);
+    capture_len = 0;
+    bench_cases[c].fn();
+    memcpy(immediate, capture, capture_len);
+    immediate_len = capture_len;
+
+    FEB_Log_SetDeferred(true);
+    capture_len = 0;
+    bench_cases[c].fn();
+    FEB_Log_Process();
+
+    if (capture_len != immediate_len || memcmp(capture, immediate, immediate_len) != 0)
+    {
+      fprintf(stderr, "decode mismatch in '%s':\n  immediate: %.*s  deferred:  %.*s", bench_cases[c].name,
+              (int)immediate_len, immediate, (int)capture_len, capture);
+      mismatches++;
+    }
+  }
+  capture_mode = CAPTURE_DISCARD;
+  return mismatches;
+}
+
+/* ============================================================================
+ * Timing
+ * ============================================================================ */
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Cost of one now_ns() pair, subtracted from every timed section. */
+static uint64_t clock_overhead_ns;
+
+static void calibrate_clock(void)
+{
+  uint64_t total = 0;
+  for (uint32_t i = 0; i < 100000U; i++)
+  {
+    uint64_t t0 = now_ns();
+    total += now_ns() - t0;
+  }
+  clock_overhead_ns = total / 100000U;
+}
+
+static void call_no_args(uint32_t i)
+{
+  (void)i;
+  FEB_Log_Output(FEB_LOG_INFO, TAG_MAIN, NULL, 0, "state machine entered DRIVE");
+}
+
+static void call_four_ints(uint32_t i)
+{
+  FEB_Log_Output(FEB_LOG_INFO, TAG_BMS, NULL, 0, "bank %u cell %u %lu uV %d", (unsigned)(i & 7u), (unsigned)(i & 15u),
+                 (unsigned long)(3600000u + i), (int)i);
+}
+
+static void call_float_string(uint32_t i)
+{
+  FEB_Log_Output(FEB_LOG_INFO, TAG_RMS, NULL, 0, "%s torque %.2f Nm", "drive", (double)i * 0.01);
+}
+
+static void call_warn_file(uint32_t i)
+{
+  FEB_Log_Output(FEB_LOG_WARN, TAG_CAN, "feb_can_rx.c", 171, "no handler matched id=0x%lX type=%d",
+                 (unsigned long)(0x100u + (i & 0xFFu)), 0);
+}
+
+typedef struct
+{
+  const char *name;
+  void (*fn)(uint32_t);
+} bench_call_t;
+
+static const bench_call_t bench_calls[] = {
+    {"no_args", call_no_args},
+    {"four_ints", call_four_ints},
+    {"float_string", call_float_string},
+    {"warn_file_line", call_warn_file},
+};
+#define BENCH_CALLS (sizeof(bench_calls) / sizeof(bench_calls[0]))
+
+static double time_calls(void (*fn)(uint32_t))
+{
+  uint64_t best = UINT64_MAX;
+  for (uint32_t r = 0; r < BENCH_TIMING_REPS; r++)
+  {
+    uint64_t t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_TIMING_CALLS; i++)
+      fn(i);
+    uint64_t dt = now_ns() - t0 - clock_overhead_ns;
+    if (dt < best)
+      best = dt;
+  }
+  return (double)best / BENCH_TIMING_CALLS;
+}
+
+/* Deferred record cost and drain cost, best of BENCH_TIMING_REPS */
+static void time_deferred(void (*fn)(uint32_t), double *record_ns, double *drain_ns)
+{
+  uint64_t best_record = UINT64_MAX;
+  uint64_t best_drain = UINT64_MAX;
+  for (uint32_t r = 0; r < BENCH_TIMING_REPS; r++)
+  {
+    uint32_t calls = 0;
+    uint64_t record = 0;
+    uint64_t drain = 0;
+    while (calls < BENCH_TIMING_CALLS)
+    {
+      /* Batches small enough that the 4 KiB ring never fills */
+      uint64_t t0 = now_ns();
+      for (uint32_t i = 0; i < 16u; i++)
+        fn(calls + i);
+      record += now_ns() - t0 - clock_overhead_ns;
+
+      t0 = now_ns();
+      FEB_Log_Process();
+      drain += now_ns() - t0 - clock_overhead_ns;
+      calls += 16u;
+    }
+    if (record < best_record)
+      best_record = record;
+    if (drain < best_drain)
+      best_drain = drain;
+  }
+  *record_ns = (double)best_record / BENCH_TIMING_CALLS;
+  *drain_ns = (double)best_drain / BENCH_TIMING_CALLS;
+}
+
+/* ============================================================================
+ * Stress
+ * ============================================================================ */
+
+static volatile uint32_t stress_running;
+
+static void *stress_producer(void *arg)
+{
+  uint32_t p = (uint32_t)(uintptr_t)arg;
+  bool isr = (p == BENCH_PRODUCERS - 1u);
+
+  for (uint32_t n = 0; n < BENCH_STRESS_MESSAGES; n++)
+  {
+    if (isr)
+      FEB_Host_ISR_Enter();
+    FEB_Log_Output(FEB_LOG_INFO, "[STRESS]", NULL, 0, "stress p%u n%u", (unsigned)p, (unsigned)n);
+    if (isr)
+      FEB_Host_ISR_Exit();
+
+    /* Let the drain run now and then, as the log task would between bursts */
+    if ((n & 63u) == 63u)
+      sched_yield();
+  }
+  __atomic_sub_fetch(&stress_running, 1u, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+static void run_stress(uint64_t *lost)
+{
+  pthread_t producers[BENCH_PRODUCERS];
+
+  FEB_Log_SetDeferred(true);
+  FEB_Log_Process();
+  memset(stress_next, 0, sizeof(stress_next));
+  stress_printed = 0;
+  stress_dropped = 0;
+  stress_out_of_order = 0;
+  capture_mode = CAPTURE_STRESS;
+
+  stress_running = BENCH_PRODUCERS;
+  for (uint32_t p = 0; p < BENCH_PRODUCERS; p++)
+    pthread_create(&producers[p], NULL, stress_producer, (void *)(uintptr_t)p);
+
+  while (__atomic_load_n(&stress_running, __ATOMIC_ACQUIRE) != 0u)
+    FEB_Log_Process();
+  for (uint32_t p = 0; p < BENCH_PRODUCERS; p++)
+    pthread_join(producers[p], NULL);
+  FEB_Log_Process();
+
+  capture_mode = CAPTURE_DISCARD;
+
+  uint64_t sent = (uint64_t)BENCH_PRODUCERS * BENCH_STRESS_MESSAGES;
+  uint64_t accounted = stress_printed + stress_dropped;
+  *lost = (accounted > sent) ? accounted - sent : sent - accounted;
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  FEB_Log_Config_t cfg = {
+      .level = FEB_LOG_TRACE,
+      .colors = false,
+      .timestamps = true,
+      .get_tick_ms = bench_get_tick,
+      .custom_output = bench_output,
+      .mutex = osMutexNew(NULL),
+      .deferred = false,
+  };
+  if (FEB_Log_Init(&cfg) != 0)
+  {
+    fprintf(stderr, "FEB_Log_Init failed\n");
+    return 2;
+  }
+
+  uint32_t decode_mismatches = check_decode();
+  /* Same checks with colour codes on */
+  FEB_Log_SetColors(true);
+  decode_mismatches += check_decode();
+  FEB_Log_SetColors(false);
+
+  calibrate_clock();
+  printf("call,immediate_ns,deferred_ns,drain_ns\n");
+  for (uint32_t c = 0; c < BENCH_CALLS; c++)
+  {
+    FEB_Log_SetDeferred(false);
+    double immediate_ns = time_calls(bench_calls[c].fn);
+
+    FEB_Log_SetDeferred(true);
+    double deferred_ns;
+    double drain_ns;
+    time_deferred(bench_calls[c].fn, &deferred_ns, &drain_ns);
+
+    printf("%s,%.1f,%.1f,%.1f\n", bench_calls[c].name, immediate_ns, deferred_ns, drain_ns);
+    fprintf(stderr, "%-15s immediate %6.1f ns  deferred %5.1f ns (%.1fx)  drain %6.1f ns/msg\n",
+            bench_calls[c].name, immediate_ns, deferred_ns, immediate_ns / deferred_ns, drain_ns);
+  }
+
+  printf("decode,cases,mismatches\n");
+  printf("decode,%u,%u\n", (unsigned)(2u * BENCH_CASES), (unsigned)decode_mismatches);
+  fprintf(stderr, "decode: %u cases, %u mismatches\n", (unsigned)(2u * BENCH_CASES), (unsigned)decode_mismatches);
+
+  uint64_t lost;
+  run_stress(&lost);
+  FEB_Log_DeferredStats_t stats;
+  FEB_Log_GetDeferredStats(&stats);
+
+  uint64_t sent = (uint64_t)BENCH_PRODUCERS * BENCH_STRESS_MESSAGES;
+  printf("stress,producers,sent,printed,dropped,lost,out_of_order\n");
+  printf("stress,%u,%llu,%llu,%llu,%llu,%llu\n", (unsigned)BENCH_PRODUCERS, (unsigned long long)sent,
+         (unsigned long long)stress_printed, (unsigned long long)stress_dropped, (unsigned long long)lost,
+         (unsigned long long)stress_out_of_order);
+  fprintf(stderr, "stress: %llu sent, %llu printed, %llu dropped (ring high water %u of %u bytes)\n",
+          (unsigned long long)sent, (unsigned long long)stress_printed, (unsigned long long)stress_dropped,
+          (unsigned)stats.high_water, (unsigned)stats.ring_size);
+
+  if (decode_mismatches != 0 || lost != 0 || stress_out_of_order != 0)
+  {
+    fprintf(stderr, "FAIL: %u decode mismatches, %llu lost, %llu out of order\n", (unsigned)decode_mismatches,
+            (unsigned long long)lost, (unsigned long long)stress_out_of_order);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,323 @@
+/**
+ ******************************************************************************
+ * @file           : tps_batch_bench.c
+ * @brief          : TPS2482 polling on the LVPDB bus: blocking Poll vs batch
+ * @author         : Formula Electric @ Berkeley
+ ******************************************************************************
+ * @details
+ *
+ * Seven simulated TPS2482s at the LVPDB addresses on one 100 kHz bus (hi2c1
+ * in LVPDB/Core/Src/i2c.c), polled every 50 ms as FEB_Main_Loop() does, for
+ * BENCH_POLLS polls in virtual time:
+ *
+ *   blocking - FEB_TPS_Poll() per device, the former main-loop read: four
+ *              blocking register reads each, the loop stalled throughout.
+ *   batch    - FEB_TPS_BatchStart(), then the loop only calls
+ *              FEB_TPS_BatchProcess() while the reads chain from the I2C
+ *              completion interrupt (FEB_Host_I2C_Service here).
+ *
+ * Each mode runs with all devices present, then with one device NACKing
+ * after registration. Every delivered measurement is checked against the
+ * register file the device was given; `mismatches` counts disagreements.
+ *
+ * `bus_us` and `latency_us` are simulated bus time per poll (start of the
+ * poll to the last result in hand). `stall_us` is how long the main loop
+ * could not run anything else: the whole bus time when blocking, only the
+ * host CPU time inside BatchStart/BatchProcess for the batch (wall clock,
+ * so compare its order of magnitude, not the digits).
+ *
+ * stdout: `mode,devices,nack,polls,bus_us,bus_pct,latency_us,stall_us,mismatches`
+ * stderr: summary. Exit status 1 on any mismatch.
+ *
+ ******************************************************************************
+ */
+
+#include "feb_host.h"
+#include "feb_tps.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* ============================================================================
+ * Configuration
+ * ============================================================================ */
+
+#define BENCH_DEVICES 7U
+#define BENCH_POLLS 200U
+#define BENCH_POLL_PERIOD_MS 50U /* MAIN_LOOP_POLL_INTERVAL_MS */
+#define BENCH_I2C_HZ 100000U     /* hi2c1.Init.ClockSpeed */
+#define BENCH_NACK_DEVICE 3U     /* BM_L, the rail FEB_Main leaves disabled */
+
+/* LVPDB/Core/User/Inc/FEB_Main.h: LV, SH, LT, BM_L, SM, AF1_AF2, CP_RF */
+static const uint8_t bench_addrs[BENCH_DEVICES] = {
+    FEB_TPS_ADDR(FEB_TPS_PIN_SDA, FEB_TPS_PIN_SCL), FEB_TPS_ADDR(FEB_TPS_PIN_SDA, FEB_TPS_PIN_SDA),
+    FEB_TPS_ADDR(FEB_TPS_PIN_GND, FEB_TPS_PIN_GND), FEB_TPS_ADDR(FEB_TPS_PIN_SCL, FEB_TPS_PIN_SCL),
+    FEB_TPS_ADDR(FEB_TPS_PIN_GND, FEB_TPS_PIN_SDA), FEB_TPS_ADDR(FEB_TPS_PIN_GND, FEB_TPS_PIN_VS),
+    FEB_TPS_ADDR(FEB_TPS_PIN_VS, FEB_TPS_PIN_SCL),
+};
+static const float bench_fuse_a[BENCH_DEVICES] = {5.0f, 5.0f, 6.3f, 16.0f, 12.0f, 20.0f, 10.0f};
+
+I2C_HandleTypeDef hi2c1;
+
+static FEB_Host_I2C_Device_t devices[BENCH_DEVICES];
+static FEB_TPS_Handle_t handles[BENCH_DEVICES];
+
+/* Results of the poll in progress */
+static FEB_TPS_Measurement_t results[BENCH_DEVICES];
+static FEB_TPS_Status_t result_status[BENCH_DEVICES];
+
+/* ============================================================================
+ * HAL Callbacks (LVPDB/Core/Src/stm32f4xx_it.c)
+ * ============================================================================ */
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  FEB_TPS_I2C_MemRxCpltCallback(hi2c);
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  FEB_TPS_I2C_ErrorCallback(hi2c);
+}
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================ */
+
+static uint32_t rng_state = 0x6C8E9CF5u;
+
+static uint32_t rng_next(void)
+{
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static uint64_t now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_device_index(FEB_TPS_Handle_t handle)
+{
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+  {
+    if (handles[i] == handle)
+      return (int)i;
+  }
+  return -1;
+}
+
+/* New readings for the next poll. Current and shunt are sign-magnitude. */
+static void refresh_registers(void)
+{
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+  {
+    uint16_t *regs = devices[i].regs;
+    regs[FEB_TPS_REG_BUS_VOLT] = (uint16_t)(0x2000u + (rng_next() & 0x0FFFu));
+    regs[FEB_TPS_REG_CURRENT] = (uint16_t)(rng_next() & 0x87FFu);
+    regs[FEB_TPS_REG_SHUNT_VOLT] = (uint16_t)(rng_next() & 0x83FFu);
+    regs[FEB_TPS_REG_POWER] = (uint16_t)(rng_next() & 0x3FFFu);
+  }
+}
+
+static int16_t sign_magnitude(uint16_t raw)
+{
+  return (raw & 0x8000u) ? (int16_t)(-(int16_t)(raw & 0x7FFFu)) : (int16_t)raw;
+}
+
+/* Compare delivered results with the register file; absent devices must fail */
+static uint32_t check_results(void)
+{
+  uint32_t mismatches = 0;
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+  {
+    const uint16_t *regs = devices[i].regs;
+    if (!devices[i].present)
+    {
+      mismatches += (result_status[i] == FEB_TPS_OK) ? 1u : 0u;
+      continue;
+    }
+    if (result_status[i] != FEB_TPS_OK || results[i].bus_voltage_raw != regs[FEB_TPS_REG_BUS_VOLT] ||
+        results[i].current_raw != sign_magnitude(regs[FEB_TPS_REG_CURRENT]) ||
+        results[i].shunt_voltage_raw != sign_magnitude(regs[FEB_TPS_REG_SHUNT_VOLT]) ||
+        results[i].power_raw != regs[FEB_TPS_REG_POWER])
+    {
+      mismatches++;
+    }
+  }
+  return mismatches;
+}
+
+/* ============================================================================
+ * Poll Modes
+ * ============================================================================ */
+
+typedef struct
+{
+  uint64_t bus_ns;
+  uint64_t latency_ns;
+  uint64_t stall_ns;
+  uint32_t mismatches;
+} poll_result_t;
+
+static void poll_blocking(poll_result_t *r)
+{
+  uint64_t t0 = FEB_Host_Time_Ns();
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+  {
+    memset(&results[i], 0, sizeof(results[i]));
+    result_status[i] = FEB_TPS_Poll(handles[i], &results[i]);
+  }
+  uint64_t dt = FEB_Host_Time_Ns() - t0;
+  r->latency_ns += dt;
+  r->stall_ns += dt;
+}
+
+static void batch_callback(FEB_TPS_Handle_t handle, FEB_TPS_Status_t status, const FEB_TPS_Measurement_t *m,
+                           void *ctx)
+{
+  (void)ctx;
+  int i = bench_device_index(handle);
+  if (i >= 0)
+  {
+    results[i] = *m;
+    result_status[i] = status;
+  }
+}
+
+static void poll_batch(poll_result_t *r)
+{
+  uint64_t t0 = FEB_Host_Time_Ns();
+
+  uint64_t c0 = now_ns();
+  FEB_TPS_Status_t status = FEB_TPS_BatchStart(batch_callback, NULL);
+  r->stall_ns += now_ns() - c0;
+  if (status != FEB_TPS_OK)
+  {
+    r->mismatches += BENCH_DEVICES;
+    return;
+  }
+
+  /* Main loop passes, with the I2C interrupt landing between them */
+  for (;;)
+  {
+    c0 = now_ns();
+    bool done = FEB_TPS_BatchProcess();
+    r->stall_ns += now_ns() - c0;
+    if (done)
+      break;
+    if (!FEB_Host_I2C_Service(&hi2c1))
+    {
+      r->mismatches += BENCH_DEVICES;
+      return;
+    }
+  }
+
+  r->latency_ns += FEB_Host_Time_Ns() - t0;
+}
+
+static poll_result_t run(void (*poll)(poll_result_t *), bool nack)
+{
+  poll_result_t r = {0};
+  FEB_Host_I2C_Stats_t s0;
+  FEB_Host_I2C_Stats_t s1;
+
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+    devices[i].present = !(nack && i == BENCH_NACK_DEVICE);
+
+  FEB_Host_I2C_GetStats(&hi2c1, &s0);
+  for (uint32_t p = 0; p < BENCH_POLLS; p++)
+  {
+    refresh_registers();
+    for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+      result_status[i] = FEB_TPS_ERR_NOT_INIT;
+
+    uint64_t start = FEB_Host_Time_Ns();
+    poll(&r);
+    r.mismatches += check_results();
+
+    /* Idle until the next poll is due */
+    uint64_t elapsed = FEB_Host_Time_Ns() - start;
+    if (elapsed < BENCH_POLL_PERIOD_MS * 1000000ULL)
+      FEB_Host_Time_AdvanceNs(BENCH_POLL_PERIOD_MS * 1000000ULL - elapsed);
+  }
+  FEB_Host_I2C_GetStats(&hi2c1, &s1);
+  r.bus_ns = s1.bus_ns - s0.bus_ns;
+  return r;
+}
+
+static void report(const char *mode, bool nack, const poll_result_t *r)
+{
+  double bus_us = (double)r->bus_ns / BENCH_POLLS / 1000.0;
+  double bus_pct = 100.0 * bus_us / (BENCH_POLL_PERIOD_MS * 1000.0);
+  double latency_us = (double)r->latency_ns / BENCH_POLLS / 1000.0;
+  double stall_us = (double)r->stall_ns / BENCH_POLLS / 1000.0;
+
+  printf("%s,%u,%u,%u,%.1f,%.2f,%.1f,%.2f,%u\n", mode, (unsigned)BENCH_DEVICES, nack ? 1u : 0u,
+         (unsigned)BENCH_POLLS, bus_us, bus_pct, latency_us, stall_us, (unsigned)r->mismatches);
+  fprintf(stderr, "%-8s %s  bus %6.1f us/poll (%4.2f %%)  latency %6.1f us  loop stalled %8.2f us\n", mode,
+          nack ? "1 NACK" : "all ok", bus_us, bus_pct, latency_us, stall_us);
+}
+
+/* ============================================================================
+ * Main
+ * ============================================================================ */
+
+int main(void)
+{
+  FEB_Host_Time_UseVirtual(true);
+  FEB_Host_I2C_InitHandle(&hi2c1, BENCH_I2C_HZ);
+
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+  {
+    devices[i].addr7 = bench_addrs[i];
+    devices[i].reg_bytes = 2;
+    devices[i].present = true;
+    FEB_Host_I2C_Attach(&hi2c1, &devices[i]);
+  }
+
+  if (FEB_TPS_Init(NULL) != FEB_TPS_OK)
+  {
+    fprintf(stderr, "FEB_TPS_Init failed\n");
+    return 2;
+  }
+  for (uint32_t i = 0; i < BENCH_DEVICES; i++)
+  {
+    FEB_TPS_DeviceConfig_t cfg = {
+        .hi2c = &hi2c1,
+        .i2c_addr = bench_addrs[i],
+        .r_shunt_ohms = 0.002f,
+        .i_max_amps = bench_fuse_a[i],
+    };
+    if (FEB_TPS_DeviceRegister(&cfg, &handles[i]) != FEB_TPS_OK)
+    {
+      fprintf(stderr, "FEB_TPS_DeviceRegister failed for 0x%02X\n", (unsigned)bench_addrs[i]);
+      return 2;
+    }
+  }
+
+  uint32_t mismatches = 0;
+  printf("mode,devices,nack,polls,bus_us,bus_pct,latency_us,stall_us,mismatches\n");
+  for (uint32_t nack = 0; nack < 2u; nack++)
+  {
+    poll_result_t blocking = run(poll_blocking, nack != 0u);
+    report("blocking", nack != 0u, &blocking);
+    poll_result_t batch = run(poll_batch, nack != 0u);
+    report("batch", nack != 0u, &batch);
+    mismatches += blocking.mismatches + batch.mismatches;
+  }
+
+  if (mismatches != 0)
+  {
+    fprintf(stderr, "FAIL: %u mismatched measurements\n", (unsigned)mismatches);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+canlog-to-csv.py - Convert a DCU binary CAN log (log_NNNN.fcl) to CSV.
+
+Produces exactly the rows the DCU writes in CSV mode:
+
+    timestamp_ms,bus,can_id,dlc,d0,d1,d2,d3,d4,d5,d6,d7
+    123456,1,0x1A0,8,00,11,22,33,44,55,66,77
+
+so existing tooling can consume binary logs unchanged.
+
+Blocks that fail their magic / length / CRC-32 check are skipped with a
+warning on stderr; the remaining blocks still convert because each block
+carries its own base timestamp. A trailing partial block (power lost
+mid-write) is ignored.
+
+Exit codes:
+   0 - success (possibly with skipped blocks)
+   1 - CLI / argument error
+   2 - not a binary CAN log, or unsupported format version
+
+Keep this file in sync with DCU/Core/User/Inc/DCU_CAN_Log_Format.h - the
+layout is duplicated here because we can't #include C from Python.
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+import zlib
+from pathlib import Path
+from typing import BinaryIO, Iterator, TextIO
+
+# Must match DCU_CAN_Log_Format.h.
+FILE_MAGIC = b"FEBCANLG"
+FORMAT_VERSION = 1
+BLOCK_MAGIC = 0x424C4346  # "FCLB"
+BLOCK_HEADER_FMT = "<IIIHHI"
+BLOCK_HEADER_BYTES = struct.calcsize(BLOCK_HEADER_FMT)
+assert BLOCK_HEADER_BYTES == 20, f"block header size drifted: {BLOCK_HEADER_BYTES}"
+FILE_HEADER_FMT = "<8sHHHHII"
+FILE_HEADER_BYTES = struct.calcsize(FILE_HEADER_FMT)
+
+REC_DLC_MASK = 0x0F
+REC_BUS2 = 0x10
+REC_EXT = 0x20
+REC_TS_SHIFT = 6
+TS_WIDTH = (0, 1, 2, 4)
+
+CSV_HEADER = "timestamp_ms,bus,can_id,dlc,d0,d1,d2,d3,d4,d5,d6,d7\r\n"
+
+
+class FormatError(Exception):
+    pass
+
+
+def read_file_header(f: BinaryIO) -> tuple[int, int, int]:
+    """Return (block_bytes, session, start_ms)."""
+    raw = f.read(FILE_HEADER_BYTES)
+    if len(raw) < FILE_HEADER_BYTES:
+        raise FormatError("file too short for header")
+    magic, version, block_bytes, session, _reserved, start_ms, crc = struct.unpack(FILE_HEADER_FMT, raw)
+    if magic != FILE_MAGIC:
+        raise FormatError("bad file magic (not a binary CAN log?)")
+    if zlib.crc32(raw[:20]) != crc:
+        raise FormatError("file header CRC mismatch")
+    if version != FORMAT_VERSION:
+        raise FormatError(f"unsupported format version {version} (this tool reads {FORMAT_VERSION})")
+    if block_bytes <= BLOCK_HEADER_BYTES:
+        raise FormatError(f"implausible block size {block_bytes}")
+    f.seek(block_bytes)
+    return block_bytes, session, start_ms
+
+
+def decode_block(block: bytes) -> Iterator[tuple[int, int, int, bytes]]:
+    """Yield (ts_ms, bus, can_id, data) for each record in a verified block."""
+    _magic, _seq, base_ts, used, count, _crc = struct.unpack_from(BLOCK_HEADER_FMT, block)
+    pos = BLOCK_HEADER_BYTES
+    end = BLOCK_HEADER_BYTES + used
+    ts = base_ts
+    for _ in range(count):
+        if pos >= end:
+            raise FormatError("record count exceeds payload")
+        flags = block[pos]
+        pos += 1
+        dlc = flags & REC_DLC_MASK
+        width = TS_WIDTH[flags >> REC_TS_SHIFT]
+        if width:
+            ts = (ts + int.from_bytes(block[pos : pos + width], "little")) & 0xFFFFFFFF
+            pos += width
+        id_bytes = 4 if flags & REC_EXT else 2
+        can_id = int.from_bytes(block[pos : pos + id_bytes], "little")
+        pos += id_bytes
+        data = block[pos : pos + dlc]
+        pos += dlc
+        if pos > end or dlc > 8:
+            raise FormatError("record overruns payload")
+        yield ts, (2 if flags & REC_BUS2 else 1), can_id, data
+
+
+def check_block(block: bytes, block_bytes: int) -> str | None:
+    """Return None if the block is valid, else a reason string."""
+    magic, _seq, _base, used, _count, crc = struct.unpack_from(BLOCK_HEADER_FMT, block)
+    if magic != BLOCK_MAGIC:
+        return "bad block magic"
+    if BLOCK_HEADER_BYTES + used > block_bytes:
+        return f"payload length {used} too large"
+    calc = zlib.crc32(block[BLOCK_HEADER_BYTES : BLOCK_HEADER_BYTES + used], zlib.crc32(block[:16]))
+    if calc != crc:
+        return "CRC mismatch"
+    return None
+
+
+def format_row(ts: int, bus: int, can_id: int, data: bytes) -> str:
+    # Mirrors format_row() in DCU_CAN_Log.c: empty fields past dlc.
+    fields = [f"{b:02X}" for b in data] + [""] * (8 - len(data))
+    return f"{ts},{bus},0x{can_id:X},{len(data)}," + ",".join(fields) + "\r\n"
+
+
+def convert(src: BinaryIO, dst: TextIO, quiet: bool) -> tuple[int, int]:
+    """Return (rows_written, blocks_skipped)."""
+    block_bytes, session, _start_ms = read_file_header(src)
+    dst.write(CSV_HEADER)
+    rows = 0
+    skipped = 0
+    index = 1
+    while True:
+        block = src.read(block_bytes)
+        if len(block) < block_bytes:
+            if block and not quiet:
+                print(f"warning: ignoring {len(block)}-byte partial block at end", file=sys.stderr)
+            break
+        reason = check_block(block, block_bytes)
+        if reason is None:
+            try:
+                for ts, bus, can_id, data in decode_block(block):
+                    dst.write(format_row(ts, bus, can_id, data))
+                    rows += 1
+            except FormatError as e:
+                reason = str(e)
+        if reason is not None:
+            skipped += 1
+            if not quiet:
+                print(f"warning: session {session} block {index}: {reason}, skipped", file=sys.stderr)
+        index += 1
+    return rows, skipped
+
+
+def main(argv: list[str]) -> int:
+    ap = argparse.ArgumentParser(description="Convert a DCU binary CAN log (.fcl) to CSV")
+    ap.add_argument("input", type=Path, help="binary log (e.g. log_0042.fcl)")
+    ap.add_argument("-o", "--output", type=Path, help="CSV output (default: input with .csv suffix, '-' for stdout)")
+    ap.add_argument("-q", "--quiet", action="store_true", help="suppress per-block warnings")
+    args = ap.parse_args(argv)
+
+    if not args.input.is_file():
+        print(f"error: {args.input} not found", file=sys.stderr)
+        return 1
+
+    out_path = args.output if args.output is not None else args.input.with_suffix(".csv")
+
+    try:
+        with args.input.open("rb") as src:
+            if str(out_path) == "-":
+                rows, skipped = convert(src, sys.stdout, args.quiet)
+            else:
+                with out_path.open("w", newline="") as dst:
+                    rows, skipped = convert(src, dst, args.quiet)
+    except FormatError as e:
+        print(f"error: {args.input}: {e}", file=sys.stderr)
+        return 2
+
+    if str(out_path) != "-":
+        print(f"{args.input} -> {out_path}: {rows} frames, {skipped} bad blocks skipped", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))